@@ -1,10 +1,15 @@
 ######################################################################
 # Automatically generated by qmake (3.1) Mon May 19 10:02:11 2025
 ######################################################################
-QT += core gui axcontainer svg printsupport core5compat concurrent
+QT += core gui axcontainer svg printsupport core5compat concurrent network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
+# 图表可选 OpenGL 绘制 (系统设置 -> 绘图设置)，上下文创建失败时运行期退回软件绘制
+DEFINES += QCUSTOMPLOT_USE_OPENGL
+greaterThan(QT_MAJOR_VERSION, 5): QT += opengl
+win32: LIBS += -lopengl32
+
 TEMPLATE = app
 TARGET = WellTest
 INCLUDEPATH += .
@@ -21,30 +26,50 @@ QMAKE_CXXFLAGS_RELEASE += -O3
 # 警告：如果 Resource/PWT.ico 文件不存在，编译将报错 Error 1
 win32: RC_ICONS = Resource/PWT.ico
 
+# 求解器、拟合算法等无界面代码在 welltestcore 静态库中 (见 WellTestAll.pro)
+include(welltestcore.pri)
+
 # 数学库链接
 unix: LIBS += -lm
 win32: LIBS += -lm
 
 # Input
 HEADERS += dataeditorwidget.h \
+           batchfitqueue.h \
            chartsetting1.h \
            chartsetting2.h \
            chartwidget.h \
            chartwindow.h \
+           csvexportdialog.h \
+           curvetablemodel.h \
+           dataeditcommands.h \
            datacalculate.h \
            datacolumndialog.h \
            dataimportdialog.h \
            fittingdatadialog.h \
            fittingpage.h \
+           fittingreport.h \
            fittingparameterchart.h \
+           fitworkerclient.h \
+           fitworkerprotocol.h \
+           fitworkerserver.h \
+           gaugestreamdialog.h \
+           gaugestreamreader.h \
+           graphdecimator.h \
+           sharedgraphdata.h \
            modelmanager.h \
            modelparameter.h \
            modelselect.h \
-           modelsolver01-06.h \
            mousezoom.h \
            newprojectdialog.h \
+           jointfitdialog.h \
            paramselectdialog.h \
+           performancelogdialog.h \
+           profilerpanel.h \
            mainwindow.h \
+           measurementtablemodel.h \
+           rowfilterproxymodel.h \
+           tablesearchindex.h \
            monitorbtn.h \
            monitostatew.h \
            navbtn.h \
@@ -55,6 +80,10 @@ HEADERS += dataeditorwidget.h \
            pressurederivativecalculator.h \
            pressurederivativecalculator1.h \
            settingswidget.h \
+           textdatareader.h \
+           xlsxreader.h \
+           projectdatafile.h \
+           autosaveservice.h \
            qcustomplot.h \
            wt_fittingwidget.h \
            wt_modelwidget.h \
@@ -89,26 +118,43 @@ FORMS += dataeditorwidget.ui \
          wt_projectwidget.ui
 
 SOURCES += \
+           batchfitqueue.cpp \
            chartsetting1.cpp \
            chartsetting2.cpp \
            chartwidget.cpp \
            chartwindow.cpp \
+           csvexportdialog.cpp \
+           curvetablemodel.cpp \
            datacalculate.cpp \
            datacolumndialog.cpp \
+           dataeditcommands.cpp \
            dataeditorwidget.cpp \
            dataimportdialog.cpp \
            fittingdatadialog.cpp \
            fittingpage.cpp \
+           fittingreport.cpp \
            fittingparameterchart.cpp \
+           fitworkerclient.cpp \
+           fitworkerprotocol.cpp \
+           fitworkerserver.cpp \
+           gaugestreamdialog.cpp \
+           gaugestreamreader.cpp \
+           graphdecimator.cpp \
+           sharedgraphdata.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
            modelselect.cpp \
-           modelsolver01-06.cpp \
            mousezoom.cpp \
            newprojectdialog.cpp \
+           jointfitdialog.cpp \
            paramselectdialog.cpp \
+           performancelogdialog.cpp \
+           profilerpanel.cpp \
            main.cpp \
            mainwindow.cpp \
+           measurementtablemodel.cpp \
+           rowfilterproxymodel.cpp \
+           tablesearchindex.cpp \
            monitorbtn.cpp \
            monitostatew.cpp \
            navbtn.cpp \
@@ -119,6 +165,10 @@ SOURCES += \
            pressurederivativecalculator.cpp \
            pressurederivativecalculator1.cpp \
            settingswidget.cpp \
+           textdatareader.cpp \
+           xlsxreader.cpp \
+           projectdatafile.cpp \
+           autosaveservice.cpp \
            qcustomplot.cpp \
            wt_fittingwidget.cpp \
            wt_modelwidget.cpp \
@@ -0,0 +1,23 @@
+######################################################################
+# 全部构建目标：计算核心静态库、界面程序、命令行拟合程序、求解器基准
+# 构建: qmake WellTestAll.pro && make
+# 各目标的 .pro 位于同一目录，分别生成 Makefile.<目标名>
+######################################################################
+TEMPLATE = subdirs
+
+SUBDIRS = core gui cli benchmark
+
+core.file = welltestcore.pro
+core.makefile = Makefile.welltestcore
+
+gui.file = WellTest.pro
+gui.makefile = Makefile.WellTest
+gui.depends = core
+
+cli.file = welltest-cli.pro
+cli.makefile = Makefile.welltest-cli
+cli.depends = core
+
+benchmark.file = solverbenchmark.pro
+benchmark.makefile = Makefile.solverbenchmark
+benchmark.depends = core
@@ -0,0 +1,144 @@
+/*
+ * 文件名: adaptivetimegrid.cpp
+ * 文件作用: 理论曲线的自适应对数时间网格实现
+ * 功能描述:
+ * 1. 待细分区间按父区间的中点偏差从大到小排序，点数余量不足时优先细分偏差大的区间。
+ * 2. 中点偏差：过区间两端与中点的 ln p 二次式给出三处的双对数斜率，比较中点处 ln p 与 ln(dp/dln t)
+ *    各自相对两端连线 (双对数图上的直线段) 的偏差；幂律段斜率不变，偏差为 0。
+ * 3. ln p 几乎不变的平台段 (定压边界) 只比较压力，导数的符号由反演误差决定时不再细分。
+ * 4. 网格点以 log10 t 保存，首末点取输入的 tMin、tMax 本身。
+ */
+
+#include "adaptivetimegrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <QMap>
+#include "solverjob.h"
+
+namespace {
+struct Segment {
+    double xa, xb;  // log10 t
+    double pa, pb;
+    double priority; // 父区间的中点偏差
+};
+const double LN10 = 2.302585092994046;
+// ln p 的变化低于该值的区间视为平台
+const double NOISE_FLOOR = 1e-4;
+}
+
+double AdaptiveTimeGrid::midpointError(double pa, double pm, double pb, double halfWidth)
+{
+    if (!(pa > 0.0) || !(pm > 0.0) || !(pb > 0.0) || !(halfWidth > 0.0)) return 0.0;
+    double ya = std::log(pa), ym = std::log(pm), yb = std::log(pb);
+    // 全区间 ln p 的变化低于噪声下限 (平台段) 时不再细分，导数的符号此时由反演误差决定
+    if (std::abs(yb - ya) < NOISE_FLOOR) return std::abs(ym - 0.5 * (ya + yb));
+
+    // 过三点的 ln p 二次式在两端与中点的双对数斜率 σ = dln p / dln t，导数 d = p σ
+    double sa = (-3.0 * ya + 4.0 * ym - yb) / (2.0 * halfWidth);
+    double sm = (yb - ya) / (2.0 * halfWidth);
+    double sb = (ya - 4.0 * ym + 3.0 * yb) / (2.0 * halfWidth);
+    double pressure = ym - 0.5 * (ya + yb);
+    if (!(sa > 0.0) || !(sm > 0.0) || !(sb > 0.0)) return std::numeric_limits<double>::infinity();
+    double derivative = pressure + std::log(sm) - 0.5 * (std::log(sa) + std::log(sb));
+    return qMax(std::abs(pressure), std::abs(derivative));
+}
+
+bool AdaptiveTimeGrid::build(double tMin, double tMax, const Options& options, const Evaluator& evaluate,
+                             QVector<double>& t, QVector<double>& p)
+{
+    t.clear();
+    p.clear();
+    if (!(tMin > 0.0) || !(tMax > tMin) || !evaluate) return false;
+
+    const double x0 = std::log10(tMin), x1 = std::log10(tMax);
+    const double minWidth = 1.0 / qMax(1, options.maxPointsPerCycle);
+    const int maxPoints = qMax(2, options.maxPoints);
+
+    // 初始粗网格
+    int count = qBound(2, (int)std::ceil((x1 - x0) * qMax(1, options.initialPointsPerCycle)) + 1, maxPoints);
+    QVector<double> xs(count), ts(count);
+    for (int i = 0; i < count; ++i) {
+        xs[i] = x0 + (x1 - x0) * i / (count - 1);
+        ts[i] = i == 0 ? tMin : (i == count - 1 ? tMax : std::pow(10.0, xs[i]));
+    }
+    QVector<double> ps = evaluate(ts);
+    if (ps.size() != count) return false;
+
+    QVector<Segment> pending;
+    for (int i = 0; i + 1 < count; ++i) {
+        pending.append({xs[i], xs[i + 1], ps[i], ps[i + 1], std::numeric_limits<double>::infinity()});
+    }
+
+    QVector<double> midX, midT;
+    while (!pending.isEmpty() && xs.size() < maxPoints) {
+        // 只细分宽度在下限以上的区间，余量不足时先细分偏差大的
+        QVector<Segment> candidates;
+        for (const Segment& s : pending) {
+            if (s.xb - s.xa >= 2.0 * minWidth * (1.0 - 1e-9)) candidates.append(s);
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const Segment& a, const Segment& b) { return a.priority > b.priority; });
+        int budget = maxPoints - xs.size();
+        if (candidates.size() > budget) candidates.resize(budget);
+        if (candidates.isEmpty()) break;
+
+        midX.resize(candidates.size());
+        midT.resize(candidates.size());
+        for (int i = 0; i < candidates.size(); ++i) {
+            midX[i] = 0.5 * (candidates[i].xa + candidates[i].xb);
+            midT[i] = std::pow(10.0, midX[i]);
+        }
+        QVector<double> midP = evaluate(midT);
+        if (midP.size() != candidates.size()) return false;
+
+        pending.clear();
+        for (int i = 0; i < candidates.size(); ++i) {
+            const Segment& s = candidates[i];
+            xs.append(midX[i]);
+            ts.append(midT[i]);
+            ps.append(midP[i]);
+            double error = midpointError(s.pa, midP[i], s.pb, 0.5 * (s.xb - s.xa) * LN10);
+            if (error > options.tolerance) {
+                pending.append({s.xa, midX[i], s.pa, midP[i], error});
+                pending.append({midX[i], s.xb, midP[i], s.pb, error});
+            }
+        }
+    }
+
+    // 按时间排序输出
+    QVector<int> order(xs.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&xs](int a, int b) { return xs[a] < xs[b]; });
+    t.resize(order.size());
+    p.resize(order.size());
+    for (int i = 0; i < order.size(); ++i) {
+        t[i] = ts[order[i]];
+        p[i] = ps[order[i]];
+    }
+    return true;
+}
+
+ModelCurveData AdaptiveTimeGrid::sample(ModelSolver01_06& solver, const ModelSolver01_06::ParamSet& params,
+                                        double tMin, double tMax, const ModelSolver01_06::CalcOptions& calcOptions,
+                                        const Options& options)
+{
+    SolverControl* control = calcOptions.control;
+    // 求解器的导数逐点解析给出，随压差一起按时间记下，网格完成后直接取用
+    QMap<double, double> derivativeAt;
+    auto evaluate = [&](const QVector<double>& t) -> QVector<double> {
+        ModelCurveData curve = solver.calculateTheoreticalCurve(params, t, calcOptions);
+        if (control && control->shouldStop()) return QVector<double>();
+        const QVector<double>& d = std::get<2>(curve);
+        for (int i = 0; i < t.size() && i < d.size(); ++i) derivativeAt.insert(t[i], d[i]);
+        return std::get<1>(curve);
+    };
+
+    QVector<double> t, p;
+    if (!build(tMin, tMax, options, evaluate, t, p)) return ModelCurveData();
+
+    QVector<double> d(t.size());
+    for (int i = 0; i < t.size(); ++i) d[i] = derivativeAt.value(t[i], 0.0);
+    return std::make_tuple(t, p, d);
+}
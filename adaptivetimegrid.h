@@ -0,0 +1,55 @@
+/*
+ * 文件名: adaptivetimegrid.h
+ * 文件作用: 理论曲线的自适应对数时间网格头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 从粗的对数等距网格开始，逐次在区间的对数中点补点，只在曲线有结构的区间 (井储驼峰、
+ *    裂缝线性流、边界过渡等) 加密，径向流等平直段保持稀疏。
+ * 2. 区间是否继续细分由中点判断：实际的压差与导数偏离双对数图上两端连线的程度 (对数单位) 超过容差即细分，
+ *    幂律流动段 (井储、线性流、双线性流) 与径向流平直段在双对数图上接近直线，保持稀疏。
+ * 3. 每一轮新增的中点一次性交给求值函数 (批量反演，点间并行)，总点数与最小间距有上限。
+ * 4. 导数取求解器逐点给出的解析导数 (tD·dpD/dtD)，与网格疏密无关，与固定网格的理论曲线一致。
+ */
+
+#ifndef ADAPTIVETIMEGRID_H
+#define ADAPTIVETIMEGRID_H
+
+#include <QVector>
+#include <functional>
+#include "modelsolver01-06.h"
+
+class AdaptiveTimeGrid
+{
+public:
+    struct Options {
+        int initialPointsPerCycle = 2;  // 初始粗网格每个对数周期的点数 (每个区间至少补一个中点)
+        int maxPointsPerCycle = 32;     // 细分后区间宽度不小于 1/maxPointsPerCycle 个对数周期
+        double tolerance = 0.01;        // 中点处 ln p 与 ln(dp/dln t) 偏离两端连线的上限 (约为相对误差)
+        int maxPoints = 400;            // 网格总点数上限
+    };
+
+    // 求值函数：返回各时间点的压差 (与输入等长)，返回空数组表示计算已停止
+    using Evaluator = std::function<QVector<double>(const QVector<double>& t)>;
+
+    /**
+     * @brief 在 [tMin, tMax] 上生成自适应网格
+     * @param t, p 输出递增的时间及对应压差
+     * @return 求值函数中途停止或区间无效 (tMin<=0 或 tMax<=tMin) 时返回 false
+     */
+    static bool build(double tMin, double tMax, const Options& options, const Evaluator& evaluate,
+                      QVector<double>& t, QVector<double>& p);
+
+    /**
+     * @brief 在自适应网格上计算理论曲线 (压差与导数)
+     * calcOptions 原样传给求解器 (控制块停止后返回空曲线)；型曲线库路径按固定网格补齐，
+     * 自适应网格不会减少反演次数，应关闭 typeCurveLookup。
+     */
+    static ModelCurveData sample(ModelSolver01_06& solver, const ModelSolver01_06::ParamSet& params,
+                                 double tMin, double tMax, const ModelSolver01_06::CalcOptions& calcOptions,
+                                 const Options& options);
+
+private:
+    // 区间中点处压差与导数偏离两端连线的程度 (对数单位)，halfWidth 为半区间的 ln t 宽度
+    static double midpointError(double pa, double pm, double pb, double halfWidth);
+};
+
+#endif // ADAPTIVETIMEGRID_H
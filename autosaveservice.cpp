@@ -0,0 +1,69 @@
+/*
+ * 文件名: autosaveservice.cpp
+ * 文件作用: 项目自动保存与备份服务实现文件
+ * 功能描述:
+ * 1. 定时器到期时在 UI 线程收集快照：表格列数据整列复制，曲线和拟合状态为隐式共享的 JSON。
+ * 2. 内容未变化的部分由 ModelParameter 比较后跳过，不产生磁盘写入。
+ * 3. 备份任务排在同一写入队列中，保证复制的是本次保存完成后的文件。
+ */
+
+#include "autosaveservice.h"
+#include "dataeditorwidget.h"
+#include "wt_plottingwidget.h"
+#include "fittingpage.h"
+#include "modelparameter.h"
+#include <QDebug>
+
+AutoSaveService::AutoSaveService(DataEditorWidget* editor, WT_PlottingWidget* plotting, FittingPage* fitting, QObject* parent)
+    : QObject(parent), m_editor(editor), m_plotting(plotting), m_fitting(fitting),
+      m_tableModified(true), m_backupEnabled(false), m_maxBackups(0)
+{
+    connect(&m_timer, &QTimer::timeout, this, &AutoSaveService::autoSave);
+
+    // 表格的任何结构或内容修改都标记为需要重新快照
+    if (m_editor && m_editor->getDataModel()) {
+        MeasurementTableModel* model = m_editor->getDataModel();
+        connect(model, &MeasurementTableModel::dataChanged, this, &AutoSaveService::onTableModified);
+        connect(model, &MeasurementTableModel::headerDataChanged, this, &AutoSaveService::onTableModified);
+        connect(model, &MeasurementTableModel::rowsInserted, this, &AutoSaveService::onTableModified);
+        connect(model, &MeasurementTableModel::rowsRemoved, this, &AutoSaveService::onTableModified);
+        connect(model, &MeasurementTableModel::columnsInserted, this, &AutoSaveService::onTableModified);
+        connect(model, &MeasurementTableModel::columnsRemoved, this, &AutoSaveService::onTableModified);
+        connect(model, &MeasurementTableModel::modelReset, this, &AutoSaveService::onTableModified);
+    }
+}
+
+void AutoSaveService::setInterval(int minutes)
+{
+    if (minutes <= 0) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start(minutes * 60 * 1000);
+}
+
+void AutoSaveService::setBackup(bool enabled, const QString& backupDir, int maxBackups)
+{
+    m_backupEnabled = enabled && !backupDir.isEmpty() && maxBackups > 0;
+    m_backupDir = backupDir;
+    m_maxBackups = maxBackups;
+}
+
+void AutoSaveService::autoSave()
+{
+    ModelParameter* mp = ModelParameter::instance();
+    if (!mp->hasLoadedProject()) return;
+
+    // 1. 收集快照 (各页面在数据尚未从项目加载完成时不提交，避免用空数据覆盖文件)
+    if (m_editor && m_tableModified && m_editor->commitToProject()) {
+        m_tableModified = false;
+    }
+    if (m_plotting) m_plotting->commitProjectData();
+    if (m_fitting) m_fitting->saveAllFittingStates();
+    mp->saveProject();
+
+    // 2. 备份排在写入队列末尾
+    if (m_backupEnabled) mp->backupProject(m_backupDir, m_maxBackups);
+
+    qDebug() << "自动保存已提交:" << mp->getProjectFilePath();
+}
@@ -0,0 +1,55 @@
+/*
+ * 文件名: autosaveservice.h
+ * 文件作用: 项目自动保存与备份服务头文件
+ * 功能描述:
+ * 1. 按系统设置中的保存间隔定时收集各页面的当前数据 (表格、绘图曲线、拟合分析页) 并提交保存。
+ * 2. 只在 UI 线程做快照，序列化和写盘交给 ModelParameter 的后台写入队列，不阻塞界面和正在进行的拟合。
+ * 3. 启用备份时，每次自动保存后把项目文件复制到备份目录，只保留最近的若干份。
+ */
+
+#ifndef AUTOSAVESERVICE_H
+#define AUTOSAVESERVICE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+
+class DataEditorWidget;
+class WT_PlottingWidget;
+class FittingPage;
+
+class AutoSaveService : public QObject
+{
+    Q_OBJECT
+
+public:
+    AutoSaveService(DataEditorWidget* editor, WT_PlottingWidget* plotting, FittingPage* fitting, QObject* parent = nullptr);
+
+    // 绘图页面按需创建，创建后再登记；未创建时项目中的曲线保持加载时的内容
+    void setPlottingWidget(WT_PlottingWidget* plotting) { m_plotting = plotting; }
+
+    // 设置保存间隔 (分钟)，小于等于 0 时停用自动保存
+    void setInterval(int minutes);
+    // 设置备份：目录为空或 maxBackups 小于 1 时不备份
+    void setBackup(bool enabled, const QString& backupDir, int maxBackups);
+
+public slots:
+    // 立即执行一次自动保存 (定时器到期时调用)
+    void autoSave();
+
+private slots:
+    void onTableModified() { m_tableModified = true; }
+
+private:
+    DataEditorWidget* m_editor;
+    WT_PlottingWidget* m_plotting;
+    FittingPage* m_fitting;
+
+    QTimer m_timer;
+    bool m_tableModified;   // 上次快照后表格是否被修改，未修改时不再复制列数据
+    bool m_backupEnabled;
+    QString m_backupDir;
+    int m_maxBackups;
+};
+
+#endif // AUTOSAVESERVICE_H
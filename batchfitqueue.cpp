@@ -0,0 +1,443 @@
+/*
+ * 文件名: batchfitqueue.cpp
+ * 文件作用: 批量拟合队列实现
+ * 功能描述:
+ * 1. 解析分析页状态，按重采样设置抽稀观测数据后用 FittingCore 拟合 (计入时间窗口)，可选在全部数据上高精度精修。
+ * 2. 任务提交到队列自有的线程池 (按优先级排序)，与拟合内部使用的全局线程池分开，避免互相占满。
+ * 3. 工作线程只写结果表，开始/结束通知经排队调用回到队列所在线程再发出信号。
+ * 4. 设置远程节点后线程池线程数为本机任务数与远程并发数之和：工作线程先交给 FitWorkerClient 同步等待远程结果，
+ *    没有空闲节点或全部尝试失败时取得本机名额 (信号量) 再拟合，本机同时拟合的任务数不超过设置值。
+ */
+
+#include "batchfitqueue.h"
+#include "fitworkerclient.h"
+#include "modelparameter.h"
+
+#include <QEventLoop>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QMetaObject>
+#include <algorithm>
+#include <cmath>
+
+BatchFitQueue::BatchFitQueue(QObject* parent)
+    : QObject(parent),
+    m_localJobs(qMax(1, QThread::idealThreadCount() / 2)),
+    m_localSlots(m_localJobs),
+    m_nextId(0),
+    m_running(0),
+    m_cancelled(0)
+{
+    m_fitOptions = defaultFitOptions();
+    updatePoolSize();
+}
+
+BatchFitQueue::~BatchFitQueue()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void BatchFitQueue::setMaxConcurrentJobs(int count)
+{
+    count = qMax(1, count);
+    if (count > m_localJobs) m_localSlots.release(count - m_localJobs);
+    else if (count < m_localJobs) m_localSlots.acquire(m_localJobs - count);
+    m_localJobs = count;
+    updatePoolSize();
+}
+
+QString BatchFitQueue::setRemoteWorkers(const QStringList& workers, const QString& token, int jobsPerWorker)
+{
+    FitWorkerClient::Settings settings;
+    settings.token = token;
+    settings.jobsPerWorker = qMax(1, jobsPerWorker);
+    for (const QString& text : workers) {
+        if (text.trimmed().isEmpty()) continue;
+        FitWorkerClient::Endpoint endpoint;
+        if (!FitWorkerClient::parseEndpoint(text, endpoint)) return QString("拟合节点格式应为 主机:端口 : %1").arg(text.trimmed());
+        settings.workers.append(endpoint);
+    }
+    if (!settings.workers.isEmpty() && token.isEmpty()) return QString("使用远程拟合节点需要填写节点的访问令牌");
+    if (settings.workers.isEmpty()) m_remote.reset();
+    else m_remote = QSharedPointer<FitWorkerClient>::create(settings);
+    updatePoolSize();
+    return QString();
+}
+
+void BatchFitQueue::updatePoolSize()
+{
+    m_pool.setMaxThreadCount(m_localJobs + (m_remote ? m_remote->capacity() : 0));
+}
+
+FittingCore::Options BatchFitQueue::defaultFitOptions()
+{
+    FittingCore::Options options;
+    options.jacobianRefreshInterval = 4;
+    return options;
+}
+
+BatchFitQueue::Job BatchFitQueue::makeJob(const QString& name, ModelSolver01_06::ModelType modelType, const QList<FitParameter>& params,
+                                          const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv,
+                                          double weight, int priority)
+{
+    Job job;
+    job.name = name;
+    job.priority = priority;
+
+    QJsonObject& root = job.state;
+    root["modelType"] = (int)modelType;
+    root["modelName"] = ModelSolver01_06::getModelName(modelType);
+    root["fitWeightVal"] = qRound(weight * 100.0);
+
+    QJsonArray paramsArray;
+    for (const auto& p : params) {
+        QJsonObject pObj;
+        pObj["name"] = p.name;
+        pObj["value"] = p.value;
+        pObj["isFit"] = p.isFit;
+        pObj["min"] = p.min;
+        pObj["max"] = p.max;
+        pObj["isVisible"] = p.isVisible;
+        paramsArray.append(pObj);
+    }
+    root["parameters"] = paramsArray;
+
+    QJsonArray timeArr, pressArr, derivArr;
+    for (double v : t) timeArr.append(v);
+    for (double v : deltaP) pressArr.append(v);
+    for (double v : deriv) derivArr.append(v);
+    QJsonObject obsData;
+    obsData["time"] = timeArr;
+    obsData["pressure"] = pressArr;
+    obsData["derivative"] = derivArr;
+    root["observedData"] = obsData;
+    return job;
+}
+
+int BatchFitQueue::enqueue(const Job& job)
+{
+    int id = m_nextId++;
+    m_pending.append(qMakePair(id, job));
+    return id;
+}
+
+void BatchFitQueue::start()
+{
+    m_cancelled = 0;
+    // 优先级相同时按加入顺序；线程池空闲时最先提交的任务立即开始，所以先排好序再提交
+    std::stable_sort(m_pending.begin(), m_pending.end(), [](const QPair<int, Job>& a, const QPair<int, Job>& b) {
+        return a.second.priority > b.second.priority;
+    });
+    QList<QPair<int, Job>> pending = m_pending;
+    m_pending.clear();
+    if (pending.isEmpty() && m_running == 0) {
+        QMetaObject::invokeMethod(this, [this]() { emit allFinished(); }, Qt::QueuedConnection);
+        return;
+    }
+
+    for (const auto& item : pending) {
+        ++m_running;
+        int id = item.first;
+        Job job = item.second;
+        m_pool.start([this, id, job]() {
+            QMetaObject::invokeMethod(this, [this, id, name = job.name]() { emit jobStarted(id, name); }, Qt::QueuedConnection);
+            JobResult result = runJob(id, job);
+            {
+                QMutexLocker locker(&m_mutex);
+                m_results.insert(id, result);
+            }
+            QMetaObject::invokeMethod(this, [this, result]() { onJobDone(result); }, Qt::QueuedConnection);
+        }, job.priority);
+    }
+}
+
+void BatchFitQueue::cancel()
+{
+    // 未开始的任务仍会依次出队并立即记为已取消，保证每个任务都有结束通知
+    m_cancelled = 1;
+}
+
+BatchFitQueue::JobResult BatchFitQueue::result(int id) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_results.value(id);
+}
+
+QList<BatchFitQueue::JobResult> BatchFitQueue::results() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_results.values();
+}
+
+void BatchFitQueue::onJobDone(const JobResult& result)
+{
+    --m_running;
+    emit jobFinished(result.id, result.ok);
+    if (m_running == 0) emit allFinished();
+}
+
+BatchFitQueue::JobResult BatchFitQueue::runJob(int id, const Job& job)
+{
+    auto stopped = [this]() { return m_cancelled.loadRelaxed() != 0; };
+    JobResult result;
+    // 远程拟合失败 (含取消) 时退回本机；已取消的任务在本机立即结束
+    QSharedPointer<FitWorkerClient> remote = m_remote;
+    if (!remote || stopped() || !remote->execute(job, stopped, result)) {
+        m_localSlots.acquire();
+        result = executeJob(job, m_fitOptions, stopped);
+        m_localSlots.release();
+    }
+    result.id = id;
+    return result;
+}
+
+BatchFitQueue::JobResult BatchFitQueue::executeJob(const Job& job, const FittingCore::Options& fitOptions, const std::function<bool()>& stopped)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    JobResult result;
+    result.name = job.name;
+    result.state = job.state;
+
+    auto finish = [&](const QString& error) {
+        result.ok = error.isEmpty();
+        result.error = error;
+        result.elapsedMs = timer.elapsed();
+        QJsonObject info;
+        info["status"] = result.ok ? "ok" : "failed";
+        info["error"] = error;
+        info["mse"] = result.mse;
+        info["iterations"] = result.iterations;
+        info["elapsedMs"] = (double)result.elapsedMs;
+        info["finishedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        result.state["batchResult"] = info;
+        return result;
+    };
+
+    if (stopped()) return finish("已取消");
+
+    FitSetup setup;
+    QString error = parseJob(job, setup);
+    if (!error.isEmpty()) return finish(error);
+    const ModelSolver01_06::ModelType modelType = setup.modelType;
+    QList<FitParameter>& params = setup.params;
+    const double weight = setup.weight;
+    const QVector<double>& t = setup.t;
+    const QVector<double>& fitT = setup.fitT;
+    const LogTimeResampler::Options& resample = setup.resample;
+
+    FittingCore::Options options = fitOptions;
+    options.weight = weight;
+
+    QSharedPointer<ModelSolver01_06> solver = QSharedPointer<ModelSolver01_06>::create(modelType);
+    FittingCore core(solver);
+    core.setObservedData(setup.fitT, setup.fitP, setup.fitD);
+    core.setFitWindows(setup.windows);
+    core.setStopPredicate(stopped);
+    FittingCore::Result fit = core.run(params, options);
+    result.iterations = fit.iterations;
+    result.performance = FitPerformanceLog::makeRecord(fit, options, modelType, fitT.size(), t.size());
+    result.performance.analysis = job.name;
+    result.performance.source = "batch";
+    result.performance.pointsPerCycle = resample.enabled ? resample.pointsPerCycle : 0;
+
+    if (setup.refineOnFullData && fitT.size() < t.size() && !stopped()) {
+        for (auto& fp : params) fp.value = fit.params.value(fp.name, fp.value);
+        FittingCore refine(solver);
+        refine.setObservedData(setup.t, setup.p, setup.d);
+        refine.setFitWindows(setup.windows);
+        refine.setStopPredicate(stopped);
+        FittingCore::Options refineOptions;
+        refineOptions.weight = weight;
+        refineOptions.maxIterations = 5;
+        refineOptions.highPrecision = true;
+        FittingCore::Result refined = refine.run(params, refineOptions);
+        fit.params = refined.params;
+        fit.mse = refined.mse;
+        result.iterations += refined.iterations;
+        FitPerformanceLog::accumulate(result.performance, refined);
+    }
+    result.mse = fit.mse;
+
+    if (stopped()) return finish("已取消");
+    if (!std::isfinite(fit.mse)) return finish("误差无法计算，请检查参数范围");
+
+    writeParameters(result.state, fit.params);
+    return finish(QString());
+}
+
+QString BatchFitQueue::parseState(const QJsonObject& root, FitSetup& setup)
+{
+    Job job;
+    job.state = root;
+    return parseJob(job, setup);
+}
+
+QString BatchFitQueue::parseJob(const Job& job, FitSetup& setup)
+{
+    const QJsonObject& root = job.state;
+    // 模型与参数
+    int type = root["modelType"].toInt(-1);
+    if (type < ModelSolver01_06::Model_1 || type > ModelSolver01_06::Model_6) return "模型类型无效";
+    setup.modelType = (ModelSolver01_06::ModelType)type;
+
+    setup.params.clear();
+    QJsonArray arr = root["parameters"].toArray();
+    for (int i = 0; i < arr.size(); ++i) {
+        QJsonObject pObj = arr[i].toObject();
+        FitParameter p;
+        p.name = pObj["name"].toString();
+        p.displayName = p.name;
+        p.value = pObj["value"].toDouble();
+        p.isFit = pObj["isFit"].toBool();
+        p.min = pObj["min"].toDouble();
+        p.max = pObj["max"].toDouble();
+        p.isVisible = pObj["isVisible"].toBool(true);
+        setup.params.append(p);
+    }
+    bool anyFit = std::any_of(setup.params.begin(), setup.params.end(), [](const FitParameter& p) { return p.isFit; });
+    if (!anyFit) return "没有选择拟合参数";
+
+    setup.weight = 0.5;
+    if (root.contains("fitWeightVal")) setup.weight = root["fitWeightVal"].toInt() / 100.0;
+    else if (root.contains("fitWeight")) setup.weight = root["fitWeight"].toDouble();
+
+    // 观测数据 (远程任务直接使用请求中的二进制列)
+    if (!job.time.isEmpty()) {
+        setup.t = job.time;
+        setup.p = job.pressure;
+        setup.d = job.derivative;
+    } else {
+        QJsonObject obs = root["observedData"].toObject();
+        setup.t.clear();
+        setup.p.clear();
+        setup.d.clear();
+        for (auto v : obs["time"].toArray()) setup.t.append(v.toDouble());
+        for (auto v : obs["pressure"].toArray()) setup.p.append(v.toDouble());
+        for (auto v : obs["derivative"].toArray()) setup.d.append(v.toDouble());
+    }
+    if (setup.t.isEmpty() || setup.p.size() != setup.t.size()) return "没有观测数据或数据长度不一致";
+
+    setup.windows = root.contains("fitWindows") ? FitWindows::fromJson(root["fitWindows"].toObject()) : FitWindows();
+
+    // 与拟合界面相同的重采样与精修设置
+    setup.resample = LogTimeResampler::Options();
+    setup.refineOnFullData = false;
+    if (root.contains("resample")) {
+        QJsonObject rs = root["resample"].toObject();
+        setup.resample.enabled = rs["enabled"].toBool(false);
+        setup.resample.pointsPerCycle = rs["pointsPerCycle"].toInt(setup.resample.pointsPerCycle);
+        setup.resample.aggregation = LogTimeResampler::Aggregation(rs["aggregation"].toInt(LogTimeResampler::Median));
+        setup.resample.rejectOutliers = rs["rejectOutliers"].toBool(setup.resample.rejectOutliers);
+        setup.resample.outlierThreshold = rs["outlierThreshold"].toDouble(setup.resample.outlierThreshold);
+        setup.refineOnFullData = rs["refineOnFullData"].toBool(false);
+    }
+    setup.fitT = setup.t;
+    setup.fitP = setup.p;
+    setup.fitD = setup.d;
+    if (setup.resample.enabled) {
+        // 屏蔽点不参与重采样分箱 (与拟合界面相同)
+        QVector<double> t, p, d;
+        for (int i = 0; i < setup.t.size(); ++i) {
+            if (setup.windows.isMasked(setup.t[i])) continue;
+            t.append(setup.t[i]);
+            p.append(setup.p[i]);
+            d.append(i < setup.d.size() ? setup.d[i] : 0.0);
+        }
+        LogTimeResampler::Result r = LogTimeResampler::resample(t, p, d, setup.resample);
+        setup.fitT = r.time;
+        setup.fitP = r.deltaP;
+        setup.fitD = r.derivative;
+    }
+    if (setup.fitT.isEmpty()) return "重采样后没有有效数据点";
+    return QString();
+}
+
+void BatchFitQueue::writeParameters(QJsonObject& state, const QMap<QString, double>& values)
+{
+    QJsonArray arr = state["parameters"].toArray();
+    for (int i = 0; i < arr.size(); ++i) {
+        QJsonObject pObj = arr[i].toObject();
+        QString name = pObj["name"].toString();
+        if (values.contains(name)) pObj["value"] = values.value(name);
+        arr[i] = pObj;
+    }
+    state["parameters"] = arr;
+}
+
+int BatchFitQueue::runProject(const QString& projectFile, int maxConcurrentJobs, QTextStream& log,
+                              const QStringList& workers, const QString& token)
+{
+    BatchFitQueue queue;
+    queue.setMaxConcurrentJobs(maxConcurrentJobs);
+    QString workerError = queue.setRemoteWorkers(workers, token);
+    if (!workerError.isEmpty()) {
+        log << workerError << Qt::endl;
+        return -1;
+    }
+
+    ModelParameter* mp = ModelParameter::instance();
+    if (!mp->loadProject(projectFile)) {
+        log << "无法打开项目: " << projectFile << Qt::endl;
+        return -1;
+    }
+
+    QJsonObject root = mp->getFittingResult();
+    QJsonArray analyses = root["analyses"].toArray();
+    if (analyses.isEmpty() && !root.isEmpty() && !root.contains("analyses")) {
+        // 旧版单一状态
+        analyses.append(root);
+    }
+    if (analyses.isEmpty()) {
+        log << "项目中没有拟合分析页" << Qt::endl;
+        return 0;
+    }
+
+    if (!workers.isEmpty()) log << QString("远程拟合节点 %1 个").arg(workers.size()) << Qt::endl;
+    QMap<int, int> indexOfJob;
+    for (int i = 0; i < analyses.size(); ++i) {
+        Job job;
+        job.state = analyses[i].toObject();
+        job.name = job.state.value("_tabName").toString(QString("Analysis %1").arg(i + 1));
+        job.priority = job.state.value("batchPriority").toInt(0);
+        indexOfJob.insert(queue.enqueue(job), i);
+    }
+
+    int failed = 0;
+    const QString perfLog = FitPerformanceLog::logPath(projectFile);
+    QObject::connect(&queue, &BatchFitQueue::jobStarted, [&log](int, const QString& name) {
+        log << "开始: " << name << Qt::endl;
+    });
+    QObject::connect(&queue, &BatchFitQueue::jobFinished, [&](int id, bool ok) {
+        JobResult r = queue.result(id);
+        if (ok) {
+            log << "完成: " << r.name << QString("  MSE=%1  迭代 %2 次  %3 ms").arg(r.mse, 0, 'e', 3).arg(r.iterations).arg(r.elapsedMs) << Qt::endl;
+            FitPerformanceLog::append(perfLog, r.performance);
+        } else {
+            ++failed;
+            log << "失败: " << r.name << "  " << r.error << Qt::endl;
+        }
+        analyses[indexOfJob.value(id)] = r.state;
+    });
+
+    // 通知经排队调用送达，需要事件循环
+    QEventLoop loop;
+    QObject::connect(&queue, &BatchFitQueue::allFinished, &loop, &QEventLoop::quit);
+    queue.start();
+    loop.exec();
+
+    QJsonObject out;
+    out["version"] = "2.0";
+    out["analyses"] = analyses;
+    mp->saveFittingResult(out);
+    mp->saveProject();
+    mp->waitForPendingWrites();
+
+    log << QString("共 %1 个任务，失败 %2 个").arg(analyses.size()).arg(failed) << Qt::endl;
+    return failed;
+}
@@ -0,0 +1,140 @@
+/*
+ * 文件名: batchfitqueue.h
+ * 文件作用: 批量拟合队列头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 每个任务以一个拟合分析页状态 (FittingWidget::getJsonState 的格式：模型、参数、权重、观测数据、重采样、时间窗口) 描述。
+ * 2. 任务在有上限的独立线程池中按优先级执行，单个任务失败 (数据不全、无拟合参数、误差无法计算) 不影响其余任务。
+ * 3. 结果写回任务状态：参数表替换为拟合值，并附加 batchResult (状态、误差、迭代次数、耗时、错误信息)。
+ * 4. runProject 供命令行无界面运行：打开项目，拟合其中全部分析页并写回项目文件，成功的任务追加到项目性能日志。
+ * 5. 开始/结束信号在队列所在线程发出，需要该线程运行事件循环。
+ * 6. 可设置远程拟合节点 (FitWorkerClient)：任务优先发往空闲节点，节点失败时换节点重试，都失败或没有空闲节点时在本机拟合；
+ *    远程结果与本机结果一样写回任务状态。
+ */
+
+#ifndef BATCHFITQUEUE_H
+#define BATCHFITQUEUE_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QTextStream>
+#include <functional>
+#include "fittingcore.h"
+#include "fitperformancelog.h"
+#include "logtimeresampler.h"
+#include "fitwindows.h"
+
+class FitWorkerClient;
+
+class BatchFitQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 批量拟合任务
+    struct Job {
+        QString name;           // 任务名称 (通常为分析页名称)
+        int priority = 0;       // 数值大的先执行
+        QJsonObject state;      // 拟合分析页状态
+        // 观测数据的二进制列 (远程节点从请求中解出)；time 非空时代替 state 中的 observedData
+        QVector<double> time, pressure, derivative;
+    };
+
+    // 任务结果
+    struct JobResult {
+        int id = -1;
+        QString name;
+        bool ok = false;
+        QString error;          // 失败原因
+        double mse = 0.0;
+        int iterations = 0;
+        qint64 elapsedMs = 0;
+        QJsonObject state;      // 写回拟合结果后的状态 (失败时为原状态加 batchResult)
+        FitPerformanceLog::Record performance; // 性能记录 (ok 时有效，来源为 "batch"，远程节点拟合时为 "remote")
+    };
+
+    explicit BatchFitQueue(QObject* parent = nullptr);
+    ~BatchFitQueue();
+
+    // 本机同时执行的任务数上限 (每个任务内部的雅可比计算仍会使用全局线程池)；在 start 之前调用
+    void setMaxConcurrentJobs(int count);
+    // 远程拟合节点 ("主机:端口")，token 为节点的共享访问令牌，每个节点同时执行 jobsPerWorker 个任务；空列表表示只在本机拟合。
+    // 在 start 之前调用；节点格式有误或缺少令牌时不修改设置并返回原因，成功时返回空字符串
+    QString setRemoteWorkers(const QStringList& workers, const QString& token = QString(), int jobsPerWorker = 1);
+    // 各任务共用的拟合选项 (weight 以任务状态中的权重为准)
+    void setFitOptions(const FittingCore::Options& options) { m_fitOptions = options; }
+
+    // 分析页状态中与拟合有关的内容 (批量拟合与联合拟合共用)
+    struct FitSetup {
+        ModelSolver01_06::ModelType modelType = ModelSolver01_06::Model_1;
+        QList<FitParameter> params;
+        double weight = 0.5;
+        QVector<double> t, p, d;            // 完整观测数据
+        QVector<double> fitT, fitP, fitD;   // 迭代用数据 (按重采样设置抽稀，屏蔽点不参与分箱)
+        LogTimeResampler::Options resample;
+        bool refineOnFullData = false;
+        FitWindows windows;                 // 时间窗口与屏蔽点
+    };
+    // 解析分析页状态；状态无效 (模型、参数或观测数据不全) 时返回原因，成功时返回空字符串
+    static QString parseState(const QJsonObject& state, FitSetup& setup);
+    // 把拟合值写回状态中的参数表 (只替换 values 中有的参数)
+    static void writeParameters(QJsonObject& state, const QMap<QString, double>& values);
+
+    // 在调用线程中拟合一个任务 (队列工作线程与远程节点共用)；stopped 返回 true 时尽快结束并记为已取消
+    static JobResult executeJob(const Job& job, const FittingCore::Options& options, const std::function<bool()>& stopped);
+    // 队列的默认拟合选项 (远程节点按同一设置拟合)
+    static FittingCore::Options defaultFitOptions();
+
+    // 由观测数据、模型类型和初始参数组装任务
+    static Job makeJob(const QString& name, ModelSolver01_06::ModelType modelType, const QList<FitParameter>& params,
+                       const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv,
+                       double weight, int priority = 0);
+
+    // 加入待执行任务，返回任务编号；调用 start 后才开始执行
+    int enqueue(const Job& job);
+    // 按优先级提交全部待执行任务
+    void start();
+    // 取消：未开始的任务不再拟合，正在执行的任务在下一次迭代时停止，都记为失败 (已取消)
+    void cancel();
+    bool isRunning() const { return m_running > 0; }
+    JobResult result(int id) const;
+    QList<JobResult> results() const;
+
+    // 无界面批量拟合整个项目，进度写入 log；workers 与 token 为远程拟合节点及其访问令牌 (见 setRemoteWorkers)。
+    // 返回失败任务数，项目无法打开或节点设置有误时返回 -1
+    static int runProject(const QString& projectFile, int maxConcurrentJobs, QTextStream& log,
+                          const QStringList& workers = QStringList(), const QString& token = QString());
+
+signals:
+    // 以下信号都在队列对象所在线程发出
+    void jobStarted(int id, const QString& name);
+    void jobFinished(int id, bool ok);
+    void allFinished();
+
+private:
+    JobResult runJob(int id, const Job& job);
+    void onJobDone(const JobResult& result);
+    static QString parseJob(const Job& job, FitSetup& setup);
+    void updatePoolSize();
+
+    QThreadPool m_pool;
+    int m_localJobs;
+    QSemaphore m_localSlots;    // 本机拟合的并发上限 (线程池还包含等待远程结果的线程)
+    QSharedPointer<FitWorkerClient> m_remote;
+    FittingCore::Options m_fitOptions;
+    QList<QPair<int, Job>> m_pending;
+    QMap<int, JobResult> m_results;
+    mutable QMutex m_mutex;
+    int m_nextId;
+    int m_running;              // 已提交尚未结束的任务数 (只在队列线程中修改)
+    QAtomicInt m_cancelled;
+};
+
+#endif // BATCHFITQUEUE_H
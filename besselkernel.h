@@ -0,0 +1,44 @@
+/*
+ * 文件名: besselkernel.h
+ * 文件作用: 0/1 阶修正贝塞尔函数快速计算内核头文件
+ * 功能描述:
+ * 1. 提供求解器实际用到的 I0、I1、K0、K1 四个函数，含指数缩放版本，避免大参数溢出。
+ * 2. 采用分段 Chebyshev 展开 (小参数区) 与渐近展开 (大参数区)，不依赖 boost。
+ * 3. 提供数组批量计算接口，供积分节点一次性求值。
+ * 4. 与 boost::math 对比，全定义域相对误差不超过 3e-15 (K0/K1 在 x>2 区间按缩放值计)。
+ * 5. 提供复参数 (Re z >= 0) 版本，供复平面 Laplace 反演 (Talbot、de Hoog、Euler) 使用。
+ */
+
+#ifndef BESSELKERNEL_H
+#define BESSELKERNEL_H
+
+#include <complex>
+
+class BesselKernel
+{
+public:
+    // 指数缩放的 I 函数: I0(x)*exp(-|x|)、I1(x)*exp(-|x|)
+    static double i0e(double x);
+    static double i1e(double x);
+
+    // K 函数 (x <= 0 时返回正无穷)
+    static double k0(double x);
+    static double k1(double x);
+
+    // 指数缩放的 K 函数: K0(x)*exp(x)、K1(x)*exp(x)
+    static double k0e(double x);
+    static double k1e(double x);
+
+    // 批量计算：out[i] = f(x[i])，x 与 out 可以是同一数组
+    static void i0eBatch(const double* x, double* out, int n);
+    static void i1eBatch(const double* x, double* out, int n);
+    static void k0Batch(const double* x, double* out, int n);
+    static void k1Batch(const double* x, double* out, int n);
+
+    // 复参数版本 (Re z >= 0)：一次求出 K0(z)、K1(z) 与缩放的 I0(z)*exp(-z)、I1(z)*exp(-z)
+    // |z|<=2 用级数，2<|z|<17 用 Steed 连分式求 K、再由 I1/I0 连分式与 Wronski 关系求 I，|z|>=17 用 Hankel 渐近式
+    static void evaluateComplex(const std::complex<double>& z, std::complex<double>& k0, std::complex<double>& k1,
+                                std::complex<double>& i0e, std::complex<double>& i1e);
+};
+
+#endif // BESSELKERNEL_H
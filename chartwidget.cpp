@@ -5,6 +5,8 @@
  * 1. 修复了重复连接导致的双重弹窗问题。
  * 2. 移除了不存在的右键菜单槽函数连接。
  * 3. 包含完整的交互逻辑（拖拽、标注、斜率线）。
+ * 4. 标识线与标注放在单独的缓冲层 (lmBuffered) 上，拖动时只重绘该层，曲线、网格与坐标轴沿用缓存。
+ * 5. 区域选择的框选矩形同样在交互图层上，拖动时只重绘该层。
  */
 
 #include "chartwidget.h"
@@ -17,6 +19,11 @@
 #include <QInputDialog>
 #include <cmath>
 
+namespace {
+// 可拖动的标识线、标注所在图层
+const QString INTERACTION_LAYER = QStringLiteral("interaction");
+}
+
 ChartWidget::ChartWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::ChartWidget),
@@ -27,7 +34,10 @@ ChartWidget::ChartWidget(QWidget *parent) :
     m_interMode(Mode_None),
     m_activeLine(nullptr),
     m_activeText(nullptr),
-    m_activeArrow(nullptr)
+    m_activeArrow(nullptr),
+    m_regionPending(false),
+    m_regionFullHeight(false),
+    m_regionRect(nullptr)
 {
     ui->setupUi(this);
     m_plot = ui->chart; // ui->chart 是 MouseZoom 类型
@@ -56,6 +66,12 @@ void ChartWidget::initUi()
     QAction* actHorizontal = m_lineMenu->addAction("水平线 (径向流)");
     connect(actHorizontal, &QAction::triggered, this, [=](){ addCharacteristicLine(0.0); });
 
+    // 交互图层位于曲线之上；单独缓冲后其上下的图层各自合并缓存，拖动时不再重绘
+    if (!m_plot->layer(INTERACTION_LAYER)) {
+        m_plot->addLayer(INTERACTION_LAYER, m_plot->layer(QStringLiteral("main")), QCustomPlot::limAbove);
+        m_plot->layer(INTERACTION_LAYER)->setMode(QCPLayer::lmBuffered);
+    }
+
     // 基础交互设置
     m_plot->axisRect()->setRangeDrag(Qt::Horizontal | Qt::Vertical);
     m_plot->axisRect()->setRangeZoom(Qt::Horizontal | Qt::Vertical);
@@ -92,7 +108,7 @@ void ChartWidget::initConnections()
 
 void ChartWidget::setTitle(const QString &title) { ui->labelTitle->setText(title); }
 MouseZoom *ChartWidget::getPlot() { return m_plot; }
-void ChartWidget::setDataModel(QStandardItemModel *model) { m_dataModel = model; }
+void ChartWidget::setDataModel(MeasurementTableModel* model) { m_dataModel = model; }
 
 void ChartWidget::setChartMode(ChartMode mode) {
     if (m_chartMode == mode) return;
@@ -120,6 +136,42 @@ void ChartWidget::setChartMode(ChartMode mode) {
 ChartWidget::ChartMode ChartWidget::getChartMode() const { return m_chartMode; }
 QCPAxisRect* ChartWidget::getTopRect() { if (m_chartMode == Mode_Single) return m_plot->axisRect(); return m_topRect; }
 QCPAxisRect* ChartWidget::getBottomRect() { if (m_chartMode == Mode_Single) return nullptr; return m_bottomRect; }
+MouseZoom::RenderMode ChartWidget::setRenderMode(MouseZoom::RenderMode mode) { return m_plot->setRenderMode(mode); }
+void ChartWidget::setFrameTimeVisible(bool visible) { m_plot->setFrameTimeVisible(visible); }
+
+void ChartWidget::beginRegionSelection(bool fullHeight)
+{
+    m_regionPending = true;
+    m_regionFullHeight = fullHeight;
+    m_plot->setCursor(Qt::CrossCursor);
+}
+
+void ChartWidget::cancelRegionSelection()
+{
+    m_regionPending = false;
+    if (m_regionRect) {
+        m_plot->removeItem(m_regionRect);
+        m_regionRect = nullptr;
+    }
+    if (m_interMode == Mode_Selecting_Region) m_interMode = Mode_None;
+    m_plot->unsetCursor();
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectItems);
+    m_plot->replot();
+}
+
+void ChartWidget::updateRegionRect(const QPointF& pixelPos)
+{
+    if (!m_regionRect) return;
+    double x = m_plot->xAxis->pixelToCoord(pixelPos.x());
+    double y = m_plot->yAxis->pixelToCoord(pixelPos.y());
+    if (m_regionFullHeight) {
+        m_regionRect->topLeft->setCoords(m_regionStart.x(), 0.0);
+        m_regionRect->bottomRight->setCoords(x, 1.0);
+    } else {
+        m_regionRect->topLeft->setCoords(m_regionStart.x(), m_regionStart.y());
+        m_regionRect->bottomRight->setCoords(x, y);
+    }
+}
 
 // 这些槽函数会被 Qt 的 MetaObject 自动调用
 void ChartWidget::on_btnSavePic_clicked()
@@ -163,6 +215,7 @@ void ChartWidget::addCharacteristicLine(double slope)
     calculateLinePoints(slope, centerX, centerY, x1, y1, x2, y2, isLogX, isLogY);
 
     QCPItemLine* line = new QCPItemLine(m_plot);
+    line->setLayer(INTERACTION_LAYER);
     line->setClipAxisRect(rect);
     line->start->setCoords(x1, y1);
     line->end->setCoords(x2, y2);
@@ -235,6 +288,25 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event)
 {
     if (event->button() != Qt::LeftButton) return;
 
+    // 0. 区域选择：按下处为一角，松开处为对角
+    if (m_regionPending) {
+        m_interMode = Mode_Selecting_Region;
+        m_plot->setInteractions(QCP::Interaction(0));
+        m_regionStart = QPointF(m_plot->xAxis->pixelToCoord(event->pos().x()), m_plot->yAxis->pixelToCoord(event->pos().y()));
+        m_regionRect = new QCPItemRect(m_plot);
+        m_regionRect->setLayer(INTERACTION_LAYER);
+        m_regionRect->setSelectable(false);
+        m_regionRect->setPen(QPen(QColor(74, 144, 226), 1, Qt::DashLine));
+        m_regionRect->setBrush(QColor(74, 144, 226, 40));
+        if (m_regionFullHeight) {
+            m_regionRect->topLeft->setTypeY(QCPItemPosition::ptAxisRectRatio);
+            m_regionRect->bottomRight->setTypeY(QCPItemPosition::ptAxisRectRatio);
+        }
+        updateRegionRect(event->pos());
+        m_plot->layer(INTERACTION_LAYER)->replot();
+        return;
+    }
+
     m_interMode = Mode_None;
     m_activeLine = nullptr;
     m_activeText = nullptr;
@@ -327,6 +399,11 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event)
 
 void ChartWidget::onPlotMouseMove(QMouseEvent* event)
 {
+    if (m_interMode == Mode_Selecting_Region) {
+        updateRegionRect(event->pos());
+        m_plot->layer(INTERACTION_LAYER)->replot();
+        return;
+    }
     if (m_interMode != Mode_None && (event->buttons() & Qt::LeftButton)) {
         QPointF currentPos = event->pos();
         QPointF delta = currentPos - m_lastMousePos;
@@ -388,13 +465,22 @@ void ChartWidget::onPlotMouseMove(QMouseEvent* event)
         }
 
         m_lastMousePos = currentPos;
-        m_plot->replot();
+        // 只有交互图层上的对象移动，其余图层的缓存不变
+        m_plot->layer(INTERACTION_LAYER)->replot();
     }
 }
 
 void ChartWidget::onPlotMouseRelease(QMouseEvent* event)
 {
-    Q_UNUSED(event);
+    if (m_interMode == Mode_Selecting_Region) {
+        double x1 = m_regionStart.x();
+        double x2 = m_plot->xAxis->pixelToCoord(event->pos().x());
+        double y1 = m_regionFullHeight ? m_plot->yAxis->range().lower : m_regionStart.y();
+        double y2 = m_regionFullHeight ? m_plot->yAxis->range().upper : m_plot->yAxis->pixelToCoord(event->pos().y());
+        cancelRegionSelection();
+        emit regionSelected(qMin(x1, x2), qMax(x1, x2), qMin(y1, y2), qMax(y1, y2));
+        return;
+    }
     m_interMode = Mode_None;
     if (!m_activeLine && !m_activeText && !m_activeArrow)
         m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectItems);
@@ -499,12 +585,14 @@ void ChartWidget::addAnnotationToLine(QCPItemLine* line)
     if (!ok || text.isEmpty()) return;
 
     QCPItemText* txt = new QCPItemText(m_plot);
+    txt->setLayer(INTERACTION_LAYER);
     txt->setText(text);
     txt->position->setType(QCPItemPosition::ptPlotCoords);
     txt->setFont(QFont("Microsoft YaHei", 9));
     txt->setSelectable(true);
 
     QCPItemLine* arr = new QCPItemLine(m_plot);
+    arr->setLayer(INTERACTION_LAYER);
     arr->setHead(QCPLineEnding::esSpikeArrow);
     arr->setSelectable(true); // 允许拖动
 
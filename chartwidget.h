@@ -5,17 +5,19 @@
  * 1. 封装 MouseZoom，提供统一的图表展示界面。
  * 2. 接收 MouseZoom 的菜单信号，执行具体业务逻辑。
  * 3. 实现了复杂的鼠标交互（移动、拉伸、标注）。
+ * 4. 绘制方式 (软件光栅 / OpenGL) 与帧耗时显示转交 MouseZoom，默认值跟随系统设置。
+ * 5. 区域选择：由使用方开启后，下一次左键拖动框选一个区域 (可纵向铺满坐标区)，松开时发出区域的坐标范围。
  */
 
 #ifndef CHARTWIDGET_H
 #define CHARTWIDGET_H
 
 #include <QWidget>
-#include <QStandardItemModel>
 #include <QMenu>
 #include <QMap>
 #include <QMouseEvent>
 #include "mousezoom.h"
+#include "measurementtablemodel.h"
 
 namespace Ui {
 class ChartWidget;
@@ -41,15 +43,26 @@ public:
 
     void setTitle(const QString& title);
     MouseZoom* getPlot();
-    void setDataModel(QStandardItemModel* model);
+    void setDataModel(MeasurementTableModel* model);
 
     void setChartMode(ChartMode mode);
     ChartMode getChartMode() const;
     QCPAxisRect* getTopRect();
     QCPAxisRect* getBottomRect();
 
+    // 单独设置本图的绘制方式 (返回实际生效的方式) 与帧耗时显示
+    MouseZoom::RenderMode setRenderMode(MouseZoom::RenderMode mode);
+    void setFrameTimeVisible(bool visible);
+
+    // 下一次左键拖动框选区域 (fullHeight 为真时只选横轴范围)，完成后发出 regionSelected；期间不拖动视图
+    void beginRegionSelection(bool fullHeight);
+    void cancelRegionSelection();
+    bool isSelectingRegion() const { return m_regionPending; }
+
 signals:
     void exportDataTriggered();
+    // 框选区域的坐标范围 (lower <= upper)，fullHeight 时纵轴为当前显示范围
+    void regionSelected(double xLower, double xUpper, double yLower, double yUpper);
 
 private slots:
     // --- UI按钮槽函数 (Qt会自动连接这些 slots，不要手动 connect) ---
@@ -86,11 +99,12 @@ private:
     double distToSegment(const QPointF& p, const QPointF& s, const QPointF& e);
     void constrainLinePoint(QCPItemLine* line, bool isMovingStart, double mouseX, double mouseY);
     void updateAnnotationArrow(QCPItemLine* line);
+    void updateRegionRect(const QPointF& pixelPos);
 
 private:
     Ui::ChartWidget *ui;
     MouseZoom* m_plot;
-    QStandardItemModel* m_dataModel;
+    MeasurementTableModel* m_dataModel;
     QMenu* m_lineMenu;
 
     ChartMode m_chartMode;
@@ -106,7 +120,8 @@ private:
         Mode_Dragging_End,
         Mode_Dragging_Text,
         Mode_Dragging_ArrowStart,
-        Mode_Dragging_ArrowEnd
+        Mode_Dragging_ArrowEnd,
+        Mode_Selecting_Region
     };
 
     InteractionMode m_interMode;
@@ -114,6 +129,12 @@ private:
     QCPItemText* m_activeText;
     QCPItemLine* m_activeArrow;
     QPointF m_lastMousePos;
+
+    // 区域选择
+    bool m_regionPending;
+    bool m_regionFullHeight;
+    QCPItemRect* m_regionRect;
+    QPointF m_regionStart;          // 按下处的坐标 (图坐标)
 };
 
 #endif // CHARTWIDGET_H
@@ -31,3 +31,8 @@ ChartWidget* ChartWindow::getChartWidget()
 {
     return ui->chartWidget;
 }
+
+MouseZoom::RenderMode ChartWindow::setRenderMode(MouseZoom::RenderMode mode)
+{
+    return ui->chartWidget->setRenderMode(mode);
+}
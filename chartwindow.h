@@ -5,6 +5,7 @@
  * 1. 作为一个通用的独立窗口容器，内部包含一个 ChartWidget。
  * 2. 替代原有的 PlottingSingleWidget 和 PlottingStackWidget。
  * 3. 对外提供访问内部 ChartWidget 的接口，以便外部配置数据和模式。
+ * 4. 独立窗口中的大数据量曲线可单独切换 OpenGL 绘制 (默认跟随系统设置)。
  */
 
 #ifndef CHARTWINDOW_H
@@ -30,6 +31,9 @@ public:
     // 获取内部的 ChartWidget 指针
     ChartWidget* getChartWidget();
 
+    // 设置内部图表的绘制方式，返回实际生效的方式 (OpenGL 不可用时为软件光栅)
+    MouseZoom::RenderMode setRenderMode(MouseZoom::RenderMode mode);
+
     // 转发信号：当内部 ChartWidget 请求导出数据时
     // 注意：如果需要在独立窗口中实现“部分导出选点”，需要在 ChartWindow 或其调用者中处理逻辑
     // 这里我们简单暴露 ChartWidget，由调用者统一连接信号
@@ -0,0 +1,343 @@
+/*
+ * 文件名: columnexpression.cpp
+ * 文件作用: 列表达式计算引擎实现
+ * 功能描述:
+ * 1. 递归下降解析公式，直接生成后缀指令序列；两个操作数都是常数的运算在编译时折叠。
+ * 2. 求值栈的每个槽是一块行缓冲区，指令逐块执行简单循环，便于编译器向量化。
+ */
+
+#include "columnexpression.h"
+
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+// ============================================================================
+// 解析与代码生成
+// ============================================================================
+
+class ColumnExpressionParser
+{
+public:
+    using Instruction = ColumnExpression::Instruction;
+
+    ColumnExpressionParser(const QString& formula, const QStringList& variables, const QMap<QString, double>& constants)
+        : m_text(formula.toStdU32String()), m_variables(variables), m_constants(constants) {}
+
+    bool parse(std::vector<Instruction>& program, QString& error)
+    {
+        parseExpression();
+        skipSpaces();
+        if (m_error.isEmpty() && m_pos < m_text.size()) fail("无法识别的内容");
+        if (!m_error.isEmpty()) {
+            error = m_error;
+            return false;
+        }
+        program.swap(m_program);
+        return true;
+    }
+
+private:
+    void fail(const QString& message)
+    {
+        if (m_error.isEmpty()) m_error = QString("%1 (位置 %2)").arg(message).arg(int(m_pos) + 1);
+    }
+
+    void skipSpaces()
+    {
+        while (m_pos < m_text.size() && (m_text[m_pos] == U' ' || m_text[m_pos] == U'\t')) ++m_pos;
+    }
+
+    bool accept(char32_t c)
+    {
+        skipSpaces();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    static bool isIdentifierStart(char32_t c) { return c == U'_' || QChar::isLetter(c); }
+    static bool isIdentifierPart(char32_t c) { return isIdentifierStart(c) || QChar::isDigit(c); }
+
+    void append(ColumnExpression::OpCode op, int variable = -1, double constant = 0.0)
+    {
+        m_program.push_back({op, variable, constant});
+    }
+
+    bool lastIsConstant(int n) const
+    {
+        if (int(m_program.size()) < n) return false;
+        for (int i = 1; i <= n; ++i) {
+            if (m_program[m_program.size() - i].op != ColumnExpression::PushConstant) return false;
+        }
+        return true;
+    }
+
+    // 单目运算 (负号与函数)：操作数为常数时直接替换为结果
+    void appendUnary(ColumnExpression::OpCode op)
+    {
+        if (!lastIsConstant(1)) {
+            append(op);
+            return;
+        }
+        double& a = m_program.back().constant;
+        switch (op) {
+        case ColumnExpression::Negate: a = -a; break;
+        case ColumnExpression::Sqrt: a = std::sqrt(a); break;
+        case ColumnExpression::Ln: a = std::log(a); break;
+        case ColumnExpression::Log10: a = std::log10(a); break;
+        case ColumnExpression::Exp: a = std::exp(a); break;
+        case ColumnExpression::Abs: a = std::fabs(a); break;
+        default: break;
+        }
+    }
+
+    void appendBinary(ColumnExpression::OpCode op)
+    {
+        if (!lastIsConstant(2)) {
+            append(op);
+            return;
+        }
+        double b = m_program.back().constant;
+        m_program.pop_back();
+        double& a = m_program.back().constant;
+        switch (op) {
+        case ColumnExpression::Add: a += b; break;
+        case ColumnExpression::Sub: a -= b; break;
+        case ColumnExpression::Mul: a *= b; break;
+        case ColumnExpression::Div: a /= b; break;
+        case ColumnExpression::Pow: a = std::pow(a, b); break;
+        default: break;
+        }
+    }
+
+    // expression := term (('+' | '-') term)*
+    void parseExpression()
+    {
+        parseTerm();
+        while (m_error.isEmpty()) {
+            if (accept(U'+')) { parseTerm(); appendBinary(ColumnExpression::Add); }
+            else if (accept(U'-')) { parseTerm(); appendBinary(ColumnExpression::Sub); }
+            else break;
+        }
+    }
+
+    // term := unary (('*' | '/') unary)*
+    void parseTerm()
+    {
+        parseUnary();
+        while (m_error.isEmpty()) {
+            if (accept(U'*')) { parseUnary(); appendBinary(ColumnExpression::Mul); }
+            else if (accept(U'/')) { parseUnary(); appendBinary(ColumnExpression::Div); }
+            else break;
+        }
+    }
+
+    // unary := ('-' | '+') unary | power
+    void parseUnary()
+    {
+        if (accept(U'-')) { parseUnary(); appendUnary(ColumnExpression::Negate); }
+        else if (accept(U'+')) parseUnary();
+        else parsePower();
+    }
+
+    // power := primary ('^' unary)?   (右结合，-a^b 按 -(a^b) 计算)
+    void parsePower()
+    {
+        parsePrimary();
+        if (m_error.isEmpty() && accept(U'^')) {
+            parseUnary();
+            appendBinary(ColumnExpression::Pow);
+        }
+    }
+
+    void parsePrimary()
+    {
+        skipSpaces();
+        if (m_pos >= m_text.size()) {
+            fail("公式不完整");
+            return;
+        }
+        char32_t c = m_text[m_pos];
+        if (accept(U'(')) {
+            parseExpression();
+            if (m_error.isEmpty() && !accept(U')')) fail("缺少右括号");
+        } else if (QChar::isDigit(c) || c == U'.') {
+            parseNumber();
+        } else if (isIdentifierStart(c)) {
+            size_t start = m_pos;
+            while (m_pos < m_text.size() && isIdentifierPart(m_text[m_pos])) ++m_pos;
+            QString name = QString::fromStdU32String(m_text.substr(start, m_pos - start));
+            if (accept(U'(')) parseFunction(name);
+            else parseName(name);
+        } else {
+            fail("无法识别的内容");
+        }
+    }
+
+    void parseNumber()
+    {
+        size_t start = m_pos;
+        while (m_pos < m_text.size() && (QChar::isDigit(m_text[m_pos]) || m_text[m_pos] == U'.')) ++m_pos;
+        if (m_pos < m_text.size() && (m_text[m_pos] == U'e' || m_text[m_pos] == U'E')) {
+            size_t mark = m_pos++;
+            if (m_pos < m_text.size() && (m_text[m_pos] == U'+' || m_text[m_pos] == U'-')) ++m_pos;
+            if (m_pos < m_text.size() && QChar::isDigit(m_text[m_pos])) {
+                while (m_pos < m_text.size() && QChar::isDigit(m_text[m_pos])) ++m_pos;
+            } else {
+                m_pos = mark; // "2e" 之类按数字 2 后跟名称处理，由后续解析报错
+            }
+        }
+        bool ok = false;
+        double v = QString::fromStdU32String(m_text.substr(start, m_pos - start)).toDouble(&ok);
+        if (!ok) {
+            m_pos = start;
+            fail("数字格式错误");
+            return;
+        }
+        append(ColumnExpression::PushConstant, -1, v);
+    }
+
+    void parseName(const QString& name)
+    {
+        int variable = m_variables.indexOf(name);
+        if (variable >= 0) append(ColumnExpression::PushVariable, variable);
+        else if (m_constants.contains(name)) append(ColumnExpression::PushConstant, -1, m_constants.value(name));
+        else fail("未知名称 " + name);
+    }
+
+    void parseFunction(const QString& name)
+    {
+        static const QMap<QString, ColumnExpression::OpCode> unaryFunctions = {
+            {"sqrt", ColumnExpression::Sqrt}, {"ln", ColumnExpression::Ln}, {"log10", ColumnExpression::Log10},
+            {"exp", ColumnExpression::Exp}, {"abs", ColumnExpression::Abs}};
+
+        parseExpression();
+        if (!m_error.isEmpty()) return;
+        if (name == "round") {
+            // 位数必须是常数，指令中直接保存缩放系数
+            if (!accept(U',')) { fail("round 需要两个参数"); return; }
+            parseExpression();
+            if (!m_error.isEmpty()) return;
+            if (!lastIsConstant(1)) { fail("round 的位数必须为常数"); return; }
+            double digits = m_program.back().constant;
+            m_program.pop_back();
+            append(ColumnExpression::Round, -1, std::pow(10.0, std::round(digits)));
+        } else if (unaryFunctions.contains(name)) {
+            appendUnary(unaryFunctions.value(name));
+        } else {
+            fail("未知函数 " + name);
+            return;
+        }
+        if (!accept(U')')) fail("缺少右括号");
+    }
+
+    std::u32string m_text;
+    size_t m_pos = 0;
+    const QStringList& m_variables;
+    const QMap<QString, double>& m_constants;
+    std::vector<Instruction> m_program;
+    QString m_error;
+};
+
+ColumnExpression ColumnExpression::compile(const QString& formula, const QStringList& variables,
+                                           const QMap<QString, double>& constants, QString* errorMessage)
+{
+    ColumnExpression expression;
+    QString error;
+    ColumnExpressionParser parser(formula, variables, constants);
+    if (!parser.parse(expression.m_program, error)) {
+        if (errorMessage) *errorMessage = "公式错误: " + error;
+        return ColumnExpression();
+    }
+
+    // 求值栈所需的槽数
+    int depth = 0;
+    for (const Instruction& ins : expression.m_program) {
+        if (ins.op == PushVariable || ins.op == PushConstant) ++depth;
+        else if (ins.op == Add || ins.op == Sub || ins.op == Mul || ins.op == Div || ins.op == Pow) --depth;
+        expression.m_stackDepth = std::max(expression.m_stackDepth, depth);
+    }
+    return expression;
+}
+
+// ============================================================================
+// 求值
+// ============================================================================
+
+void ColumnExpression::evaluate(const std::vector<const double*>& inputs, int rows, double* out, QThreadPool* pool) const
+{
+    if (!isValid()) return;
+    forEachChunk(rows, [&](int begin, int count) { evaluateChunk(inputs, begin, count, out); }, pool);
+}
+
+void ColumnExpression::forEachChunk(int rows, const std::function<void(int, int)>& body, QThreadPool* pool)
+{
+    if (rows <= 0) return;
+    const int chunks = (rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    if (chunks == 1) {
+        body(0, rows);
+        return;
+    }
+    std::vector<int> ids(static_cast<size_t>(chunks));
+    std::iota(ids.begin(), ids.end(), 0);
+    QtConcurrent::blockingMap(pool, ids, [&](int chunk) {
+        const int begin = chunk * CHUNK_ROWS;
+        body(begin, std::min(CHUNK_ROWS, rows - begin));
+    });
+}
+
+void ColumnExpression::evaluateChunk(const std::vector<const double*>& inputs, int begin, int count, double* out) const
+{
+    // 栈槽 0 直接使用输出区间，其余槽在本块内分配
+    std::vector<double> storage(size_t(std::max(m_stackDepth - 1, 0)) * size_t(count));
+    auto slot = [&](int i) { return i == 0 ? out + begin : storage.data() + size_t(i - 1) * size_t(count); };
+
+    int top = 0;
+    for (const Instruction& ins : m_program) {
+        switch (ins.op) {
+        case PushVariable:
+            std::memcpy(slot(top), inputs[size_t(ins.variable)] + begin, sizeof(double) * size_t(count));
+            ++top;
+            break;
+        case PushConstant:
+            std::fill_n(slot(top), count, ins.constant);
+            ++top;
+            break;
+        case Add: case Sub: case Mul: case Div: case Pow: {
+            double* a = slot(top - 2);
+            const double* b = slot(top - 1);
+            switch (ins.op) {
+            case Add: for (int i = 0; i < count; ++i) a[i] += b[i]; break;
+            case Sub: for (int i = 0; i < count; ++i) a[i] -= b[i]; break;
+            case Mul: for (int i = 0; i < count; ++i) a[i] *= b[i]; break;
+            case Div: for (int i = 0; i < count; ++i) a[i] /= b[i]; break;
+            default: for (int i = 0; i < count; ++i) a[i] = std::pow(a[i], b[i]); break;
+            }
+            --top;
+            break;
+        }
+        default: {
+            double* a = slot(top - 1);
+            switch (ins.op) {
+            case Negate: for (int i = 0; i < count; ++i) a[i] = -a[i]; break;
+            case Sqrt: for (int i = 0; i < count; ++i) a[i] = std::sqrt(a[i]); break;
+            case Ln: for (int i = 0; i < count; ++i) a[i] = std::log(a[i]); break;
+            case Log10: for (int i = 0; i < count; ++i) a[i] = std::log10(a[i]); break;
+            case Exp: for (int i = 0; i < count; ++i) a[i] = std::exp(a[i]); break;
+            case Abs: for (int i = 0; i < count; ++i) a[i] = std::fabs(a[i]); break;
+            default: {
+                const double scale = ins.constant;
+                for (int i = 0; i < count; ++i) a[i] = std::round(a[i] * scale) / scale;
+                break;
+            }
+            }
+            break;
+        }
+        }
+    }
+}
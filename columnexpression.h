@@ -0,0 +1,69 @@
+/*
+ * 文件名: columnexpression.h
+ * 文件作用: 列表达式计算引擎头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 把 "Pc + (Hres - Lwf) * gmix / 100"、"p0 - p" 等公式编译为按列执行的指令序列，
+ *    变量对应输入列，命名常量在编译时代入。
+ * 2. 求值时每条指令对一整块行 (CHUNK_ROWS 行) 执行一个紧凑循环，输入为列式 double 缓冲区；
+ *    空值 (NaN) 自然传播，任一输入为空的行结果为空。
+ * 3. 行数较多时各块在线程池中并行计算，每块只写输出缓冲区中自己的区间。
+ * 4. 支持 + - * / ^、一元负号、括号，以及函数 sqrt、ln、log10、exp、abs、round(x, n)。
+ */
+
+#ifndef COLUMNEXPRESSION_H
+#define COLUMNEXPRESSION_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+#include <vector>
+
+class ColumnExpression
+{
+public:
+    static const int CHUNK_ROWS = 16384;
+
+    ColumnExpression() = default;
+
+    /**
+     * @brief 编译公式
+     * @param variables 公式中可用的列变量名，下标即 evaluate() 中输入列的下标
+     * @param constants 命名常量，编译时代入为数值
+     * 语法错误或出现未知名称时返回无效表达式，errorMessage 给出原因。
+     */
+    static ColumnExpression compile(const QString& formula, const QStringList& variables,
+                                    const QMap<QString, double>& constants = QMap<QString, double>(),
+                                    QString* errorMessage = nullptr);
+
+    bool isValid() const { return !m_program.empty(); }
+
+    /**
+     * @brief 对 rows 行求值，结果写入 out (长度至少 rows)
+     * @param inputs 各变量的列缓冲区，长度至少 rows；空值为 NaN
+     */
+    void evaluate(const std::vector<const double*>& inputs, int rows, double* out,
+                  QThreadPool* pool = QThreadPool::globalInstance()) const;
+
+    // 把 [0, rows) 按 CHUNK_ROWS 分块，各块在 pool 中并行调用 body(begin, count)，全部完成后返回
+    static void forEachChunk(int rows, const std::function<void(int, int)>& body,
+                             QThreadPool* pool = QThreadPool::globalInstance());
+
+private:
+    enum OpCode { PushVariable, PushConstant, Add, Sub, Mul, Div, Pow, Negate,
+                  Sqrt, Ln, Log10, Exp, Abs, Round };
+    struct Instruction {
+        OpCode op;
+        int variable;
+        double constant;
+    };
+    friend class ColumnExpressionParser;
+
+    void evaluateChunk(const std::vector<const double*>& inputs, int begin, int count, double* out) const;
+
+    std::vector<Instruction> m_program;
+    int m_stackDepth = 0;
+};
+
+#endif // COLUMNEXPRESSION_H
@@ -0,0 +1,39 @@
+/*
+ * 文件名: csvexportdialog.cpp
+ * 文件作用: 后台 CSV 导出进度对话框实现
+ * 功能描述:
+ * 1. 对话框为窗口模态，导出期间不能修改正在导出的曲线；超过 300 ms 才显示。
+ */
+
+#include "csvexportdialog.h"
+
+void CsvExportDialog::start(QWidget* parent, const QString& filePath, const QVector<CsvExporter::Column>& columns,
+                            char separator, int precision, const FinishedCallback& onFinished)
+{
+    CsvExportDialog* dialog = new CsvExportDialog(parent, onFinished);
+    dialog->m_watcher.setFuture(CsvExporter::start(filePath, columns, separator, precision));
+}
+
+CsvExportDialog::CsvExportDialog(QWidget* parent, const FinishedCallback& onFinished)
+    : QProgressDialog("正在导出数据...", "取消", 0, CsvExporter::PROGRESS_RANGE, parent),
+    m_onFinished(onFinished)
+{
+    setWindowTitle("导出数据");
+    setWindowModality(Qt::WindowModal);
+    setMinimumDuration(300);
+    setAutoClose(false);
+    setAutoReset(false);
+
+    connect(&m_watcher, &QFutureWatcher<QString>::progressValueChanged, this, &QProgressDialog::setValue);
+    connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &CsvExportDialog::onExportFinished);
+    connect(this, &QProgressDialog::canceled, &m_watcher, &QFutureWatcher<QString>::cancel);
+}
+
+void CsvExportDialog::onExportFinished()
+{
+    hide();
+    if (!m_watcher.isCanceled() && m_watcher.future().resultCount() > 0 && m_onFinished) {
+        m_onFinished(m_watcher.result());
+    }
+    deleteLater();
+}
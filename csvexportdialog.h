@@ -0,0 +1,37 @@
+/*
+ * 文件名: csvexportdialog.h
+ * 文件作用: 后台 CSV 导出进度对话框头文件
+ * 功能描述:
+ * 1. 用 CsvExporter 在后台线程写文件，对话框显示进度 (导出很快结束时不弹出)，“取消”即取消写入。
+ * 2. 列数据由调用方在界面线程准备好后交给导出任务，导出期间界面可以正常重绘。
+ * 3. 导出结束 (未取消) 时回调调用方显示结果，对话框随后自行删除。
+ */
+
+#ifndef CSVEXPORTDIALOG_H
+#define CSVEXPORTDIALOG_H
+
+#include <QFutureWatcher>
+#include <QProgressDialog>
+#include <functional>
+#include "csvexporter.h"
+
+class CsvExportDialog : public QProgressDialog
+{
+    Q_OBJECT
+
+public:
+    // errorMessage 为空表示写入成功
+    using FinishedCallback = std::function<void(const QString& errorMessage)>;
+
+    static void start(QWidget* parent, const QString& filePath, const QVector<CsvExporter::Column>& columns,
+                      char separator, int precision, const FinishedCallback& onFinished);
+
+private:
+    CsvExportDialog(QWidget* parent, const FinishedCallback& onFinished);
+    void onExportFinished();
+
+    QFutureWatcher<QString> m_watcher;
+    FinishedCallback m_onFinished;
+};
+
+#endif // CSVEXPORTDIALOG_H
@@ -0,0 +1,82 @@
+/*
+ * 文件名: csvexporter.cpp
+ * 文件作用: 数值列 CSV 导出实现
+ * 功能描述:
+ * 1. 缓冲区满时整块写出，同时报告进度并检查取消；行尾按文本模式写出 (Windows 下为 \r\n)。
+ * 2. %g 位数与 QString::number(v, 'g', precision) 一致，不超过 17 位。
+ */
+
+#include "csvexporter.h"
+
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <charconv>
+
+namespace {
+const qsizetype BUFFER_SIZE = 1 << 20;
+
+inline void appendNumber(QByteArray& out, double v, int precision)
+{
+    char buf[32];
+    std::to_chars_result r = precision > 0
+            ? std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, qMin(precision, 17))
+            : std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, r.ptr - buf);
+}
+}
+
+QFuture<QString> CsvExporter::start(const QString& filePath, const QVector<Column>& columns, char separator,
+                                    int precision, QThreadPool* pool)
+{
+    return QtConcurrent::run(pool, [=](QPromise<QString>& promise) {
+        write(promise, filePath, columns, separator, precision);
+    });
+}
+
+void CsvExporter::write(QPromise<QString>& promise, const QString& filePath, const QVector<Column>& columns,
+                        char separator, int precision)
+{
+    promise.setProgressRange(0, PROGRESS_RANGE);
+    int rows = 0;
+    for (const Column& c : columns) rows = qMax(rows, c.values.size());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        promise.addResult("无法写入文件: " + filePath);
+        return;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(BUFFER_SIZE + 4096);
+    for (int c = 0; c < columns.size(); ++c) {
+        if (c > 0) buffer.append(separator);
+        buffer.append(columns[c].header.toUtf8());
+    }
+    buffer.append('\n');
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns.size(); ++c) {
+            if (c > 0) buffer.append(separator);
+            if (r < columns[c].values.size()) appendNumber(buffer, columns[c].values[r], precision);
+        }
+        buffer.append('\n');
+
+        if (buffer.size() >= BUFFER_SIZE) {
+            if (file.write(buffer) != buffer.size()) {
+                promise.addResult("写入文件失败: " + filePath);
+                return;
+            }
+            buffer.resize(0); // 保留容量
+            // 取消时不提交，QSaveFile 丢弃临时文件
+            if (promise.isCanceled()) return;
+            promise.setProgressValue(int(qint64(r + 1) * PROGRESS_RANGE / rows));
+        }
+    }
+
+    if (file.write(buffer) != buffer.size() || !file.commit()) {
+        promise.addResult("保存文件失败: " + filePath);
+        return;
+    }
+    promise.setProgressValue(PROGRESS_RANGE);
+    promise.addResult(QString());
+}
@@ -0,0 +1,42 @@
+/*
+ * 文件名: csvexporter.h
+ * 文件作用: 数值列 CSV 导出头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 把若干数值列 (长度可以不同，较短的列其后各行留空) 写成带表头的分隔文本文件。
+ * 2. 数值用 std::to_chars 格式化，不经过 QString 与区域设置；按行追加到约 1 MB 的缓冲区后整块写出。
+ * 3. 写入在线程池中进行，返回可取消、可报告进度的 QFuture；经 QSaveFile 写入，取消或失败时原文件不变。
+ */
+
+#ifndef CSVEXPORTER_H
+#define CSVEXPORTER_H
+
+#include <QFuture>
+#include <QPromise>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+class CsvExporter
+{
+public:
+    static const int PROGRESS_RANGE = 1000;
+
+    struct Column {
+        QString header;
+        QVector<double> values;
+    };
+
+    /**
+     * @brief 在 pool 中写入 filePath，future 的结果为错误信息 (成功时为空字符串)
+     * @param precision 有效数字位数 (同 printf 的 %g)；<= 0 时输出可精确还原的最短表示
+     * future.cancel() 后尽快停止，且不产生结果。
+     */
+    static QFuture<QString> start(const QString& filePath, const QVector<Column>& columns, char separator = ',',
+                                  int precision = 6, QThreadPool* pool = QThreadPool::globalInstance());
+
+    // 在调用线程中写入 (start 的任务体)
+    static void write(QPromise<QString>& promise, const QString& filePath, const QVector<Column>& columns,
+                      char separator, int precision);
+};
+
+#endif // CSVEXPORTER_H
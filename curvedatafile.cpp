@@ -0,0 +1,160 @@
+/*
+ * 文件名: curvedatafile.cpp
+ * 文件作用: 绘图曲线数据二进制文件 (_chart.wtd) 读写实现
+ * 功能描述:
+ * 1. 文件结构：文件头 (标识、版本、数组个数)、数组目录 (名称、数据位置、元素个数)、各数组数据。
+ * 2. little-endian 平台上写入直接输出数组缓冲区，读取直接从映射内存拷贝，不做逐元素转换。
+ */
+
+#include "curvedatafile.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// 文件头：标识 (8) + 版本 (4) + 数组个数 (4)，共 16 字节
+// 数组目录 (每项)：名称字节数 (4) + 保留 (4) + 名称 UTF-8 (补齐到 8 字节) + 数据偏移 (8) + 元素个数 (8)
+// 数据区：各数组依次排列，起点 8 字节对齐
+const char kMagic[8] = {'W', 'T', 'C', 'U', 'R', 'V', '\r', '\n'};
+const quint32 kVersion = 1;
+const qint64 kHeaderSize = 16;
+
+inline qint64 align8(qint64 v) { return (v + 7) & ~qint64(7); }
+
+template <typename T>
+void appendLE(QByteArray& out, T v)
+{
+    T le = qToLittleEndian(v);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+}
+
+void padTo8(QByteArray& out)
+{
+    while (out.size() % 8) out.append('\0');
+}
+
+} // namespace
+
+bool CurveDataFile::write(const QString& filePath, const QMap<QString, QVector<double>>& arrays, QString* errorMessage)
+{
+    QVector<QByteArray> keys;
+    keys.reserve(arrays.size());
+    qint64 directorySize = 0;
+    for (auto it = arrays.constBegin(); it != arrays.constEnd(); ++it) {
+        keys.append(it.key().toUtf8());
+        directorySize += 8 + align8(keys.last().size()) + 16;
+    }
+
+    QByteArray head;
+    head.append(kMagic, 8);
+    appendLE(head, kVersion);
+    appendLE(head, quint32(arrays.size()));
+    qint64 offset = align8(kHeaderSize + directorySize);
+    int k = 0;
+    for (auto it = arrays.constBegin(); it != arrays.constEnd(); ++it, ++k) {
+        appendLE(head, quint32(keys[k].size()));
+        appendLE(head, quint32(0));
+        head.append(keys[k]);
+        padTo8(head);
+        appendLE(head, offset);
+        appendLE(head, qint64(it.value().size()));
+        offset += qint64(it.value().size()) * 8;
+    }
+    padTo8(head);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = "无法写入文件: " + filePath;
+        return false;
+    }
+    file.write(head);
+    for (const QVector<double>& values : arrays) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        file.write(reinterpret_cast<const char*>(values.constData()), qint64(values.size()) * 8);
+#else
+        QByteArray raw(qsizetype(values.size()) * 8, Qt::Uninitialized);
+        for (int i = 0; i < values.size(); ++i) {
+            quint64 bits;
+            std::memcpy(&bits, &values[i], 8);
+            qToLittleEndian(bits, raw.data() + qsizetype(i) * 8);
+        }
+        file.write(raw);
+#endif
+    }
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = "保存文件失败: " + filePath;
+        return false;
+    }
+    return true;
+}
+
+bool CurveDataFile::open(const QString& filePath, QString* errorMessage)
+{
+    close();
+    auto fail = [&](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        close();
+        return false;
+    };
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) return fail("无法打开文件: " + filePath);
+
+    qint64 size = m_file.size();
+    m_data = size > 0 ? m_file.map(0, size) : nullptr;
+    if (!m_data) {
+        m_fallback = m_file.readAll();
+        m_file.close();
+        m_data = reinterpret_cast<const uchar*>(m_fallback.constData());
+        size = m_fallback.size();
+    }
+
+    if (size < kHeaderSize || std::memcmp(m_data, kMagic, 8) != 0) return fail("不是有效的曲线数据文件。");
+    if (qFromLittleEndian<quint32>(m_data + 8) > kVersion) return fail("曲线数据文件版本过高，请升级软件。");
+    quint32 count = qFromLittleEndian<quint32>(m_data + 12);
+
+    qint64 pos = kHeaderSize;
+    for (quint32 i = 0; i < count; ++i) {
+        if (pos + 8 > size) return fail("曲线数据文件已损坏。");
+        qint64 keyBytes = qFromLittleEndian<quint32>(m_data + pos);
+        qint64 fixedEnd = pos + 8 + align8(keyBytes);
+        if (fixedEnd + 16 > size) return fail("曲线数据文件已损坏。");
+        QString key = QString::fromUtf8(reinterpret_cast<const char*>(m_data + pos + 8), int(keyBytes));
+        Entry entry;
+        entry.offset = qFromLittleEndian<qint64>(m_data + fixedEnd);
+        entry.count = qFromLittleEndian<qint64>(m_data + fixedEnd + 8);
+        pos = fixedEnd + 16;
+        if (entry.offset < 0 || entry.count < 0 || entry.count > (size - entry.offset) / 8) {
+            return fail("曲线数据文件已损坏。");
+        }
+        m_entries.insert(key, entry);
+    }
+    return true;
+}
+
+void CurveDataFile::close()
+{
+    m_entries.clear();
+    m_data = nullptr;
+    m_fallback.clear();
+    m_file.close(); // 同时解除映射
+}
+
+QVector<double> CurveDataFile::array(const QString& key) const
+{
+    auto it = m_entries.constFind(key);
+    if (!m_data || it == m_entries.constEnd()) return QVector<double>();
+
+    const uchar* payload = m_data + it->offset;
+    QVector<double> values(int(it->count));
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    std::memcpy(values.data(), payload, size_t(it->count) * 8);
+#else
+    for (qint64 i = 0; i < it->count; ++i) {
+        quint64 bits = qFromLittleEndian<quint64>(payload + i * 8);
+        std::memcpy(&values[int(i)], &bits, 8);
+    }
+#endif
+    return values;
+}
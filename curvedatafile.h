@@ -0,0 +1,53 @@
+/*
+ * 文件名: curvedatafile.h
+ * 文件作用: 绘图曲线数据二进制文件 (_chart.wtd) 读写头文件
+ * 功能描述:
+ * 1. 按名称存放若干长度不同的 double 数组 (各曲线的 xData、yData、derivData 等)，
+ *    数据为 8 字节对齐的 little-endian double，不做压缩。
+ * 2. 写入经 QSaveFile 原子替换；读取时内存映射文件，只解析目录，数组在取用时才从映射内存整段拷贝。
+ * 3. 映射期间文件保持打开，同一文件重新写入前必须先 close()。
+ */
+
+#ifndef CURVEDATAFILE_H
+#define CURVEDATAFILE_H
+
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+class CurveDataFile
+{
+public:
+    CurveDataFile() = default;
+    ~CurveDataFile() { close(); }
+
+    // 写入全部数组 (先写临时文件，成功后替换原文件)
+    static bool write(const QString& filePath, const QMap<QString, QVector<double>>& arrays, QString* errorMessage = nullptr);
+
+    // 映射文件并读取目录；文件不存在、格式不符或目录损坏时返回 false
+    bool open(const QString& filePath, QString* errorMessage = nullptr);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString filePath() const { return m_file.fileName(); }
+
+    bool contains(const QString& key) const { return m_entries.contains(key); }
+    // 取出一个数组的副本，不存在时返回空数组
+    QVector<double> array(const QString& key) const;
+
+private:
+    Q_DISABLE_COPY(CurveDataFile)
+
+    struct Entry {
+        qint64 offset;
+        qint64 count;
+    };
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    QByteArray m_fallback;            // 无法映射时整体读入
+    QHash<QString, Entry> m_entries;
+};
+
+#endif // CURVEDATAFILE_H
@@ -0,0 +1,70 @@
+/*
+ * 文件名: curvetablemodel.cpp
+ * 文件作用: 曲线数值表格模型实现
+ * 功能描述:
+ * 1. 显示格式与原结果文本一致：科学计数法、4 位小数。
+ */
+
+#include "curvetablemodel.h"
+
+CurveTableModel::CurveTableModel(QObject* parent)
+    : QAbstractTableModel(parent),
+    m_rows(0)
+{
+}
+
+void CurveTableModel::setColumns(const QStringList& headers, const QVector<QVector<double>>& columns)
+{
+    beginResetModel();
+    m_headers = headers;
+    m_columns = columns;
+    m_rows = 0;
+    for (const QVector<double>& c : m_columns) m_rows = qMax(m_rows, int(c.size()));
+    endResetModel();
+}
+
+void CurveTableModel::clear()
+{
+    setColumns(QStringList(), QVector<QVector<double>>());
+}
+
+int CurveTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int CurveTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(m_columns.size());
+}
+
+QVariant CurveTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+    if (role == Qt::TextAlignmentRole) return int(Qt::AlignRight | Qt::AlignVCenter);
+    if (role != Qt::DisplayRole) return QVariant();
+
+    const QVector<double>& column = m_columns[index.column()];
+    if (index.row() >= column.size()) return QVariant();
+    return QString::number(column[index.row()], 'e', 4);
+}
+
+QString CurveTableModel::rowsText(int firstRow, int lastRow) const
+{
+    QString text;
+    for (int r = qMax(0, firstRow); r <= qMin(lastRow, m_rows - 1); ++r) {
+        for (int c = 0; c < m_columns.size(); ++c) {
+            if (c > 0) text += '\t';
+            if (r < m_columns[c].size()) text += QString::number(m_columns[c][r], 'e', 4);
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+QVariant CurveTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Vertical) return section + 1;
+    return section < m_headers.size() ? m_headers[section] : QVariant();
+}
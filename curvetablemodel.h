@@ -0,0 +1,43 @@
+/*
+ * 文件名: curvetablemodel.h
+ * 文件作用: 曲线数值表格模型头文件
+ * 功能描述:
+ * 1. 以 QTableView 显示若干数值列 (如理论曲线的 t、Dp、dDp)，只保存数组，显示到哪一行才格式化哪一行，
+ *    点数很多时也不会生成整表文本。
+ * 2. 数值按科学计数法显示，列长度不同时较短列其后各行留空。
+ * 3. 选中行可按显示格式复制为制表符分隔文本 (代替原文本框的复制)。
+ */
+
+#ifndef CURVETABLEMODEL_H
+#define CURVETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+
+class CurveTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit CurveTableModel(QObject* parent = nullptr);
+
+    // 替换全部列 (数组隐式共享，不复制)
+    void setColumns(const QStringList& headers, const QVector<QVector<double>>& columns);
+    void clear();
+    // [firstRow, lastRow] 各行的制表符分隔文本，每行以换行结尾
+    QString rowsText(int firstRow, int lastRow) const;
+    QString headerText() const { return m_headers.join('\t') + '\n'; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QStringList m_headers;
+    QVector<QVector<double>> m_columns;
+    int m_rows;
+};
+
+#endif // CURVETABLEMODEL_H
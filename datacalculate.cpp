@@ -6,6 +6,7 @@
  * 2. 实现核心的时间数据解析和转换算法。
  * 3. 实现基于压力列的压降计算算法。
  * 4. 实现井底流压计算弹窗及核心算法 (基于 MATLAB 逻辑)。
+ * 5. 计算公式由 ColumnExpression 在列缓冲区上分块并行求值，结果整列一次追加到模型。
  */
 
 #include "datacalculate.h"
@@ -16,7 +17,11 @@
 #include <QPushButton>
 #include <QDebug>
 #include <QDateTime>
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include "columnexpression.h"
+#include "timestampparser.h"
 
 // ============================================================================
 // TimeConversionDialog 实现
@@ -280,7 +285,7 @@ PwfCalculationConfig PwfCalculationDialog::getConfig() const
 
 DataCalculate::DataCalculate(QObject* parent) : QObject(parent) {}
 
-TimeConversionResult DataCalculate::convertTimeColumn(QStandardItemModel* model,
+TimeConversionResult DataCalculate::convertTimeColumn(MeasurementTableModel* model,
                                                       QList<ColumnDefinition>& definitions,
                                                       const TimeConversionConfig& config)
 {
@@ -299,69 +304,65 @@ TimeConversionResult DataCalculate::convertTimeColumn(QStandardItemModel* model,
         return result;
     }
 
-    // 在末尾插入新列
-    int newColIdx = model->columnCount();
-    model->insertColumn(newColIdx);
+    const int columns = model->columnCount();
+    auto validColumn = [columns](int c) { return c >= 0 && c < columns; };
+    if (config.useDateAndTime ? !validColumn(config.dateColumnIndex) || !validColumn(config.timeColumnIndex)
+                              : !validColumn(config.sourceTimeColumnIndex)) {
+        result.errorMessage = "选择的列索引无效。";
+        return result;
+    }
+
+    // 1. 各行按墙钟时间计的秒数 (列的解析结果缓存在模型中，换单位重新转换时不再解析)
+    const qint64 kInvalid = TimestampParser::INVALID;
+    std::vector<qint64> stamps(static_cast<size_t>(rowCount), kInvalid);
+    if (config.useDateAndTime) {
+        // 日期+时刻模式 (日期与时刻可能是同一列，日期结果先拷贝出来)
+        const std::vector<qint64> days = parsedTimeColumn(model, config.dateColumnIndex, DateCache);
+        const std::vector<qint64>& secs = parsedTimeColumn(model, config.timeColumnIndex, TimeCache);
+        for (size_t i = 0; i < stamps.size(); ++i) {
+            if (days[i] != kInvalid && secs[i] != kInvalid) stamps[i] = days[i] * TimestampParser::SECONDS_PER_DAY + secs[i];
+        }
+    } else {
+        // 仅时间模式：时刻比上一有效行小时视为进入下一天，多日数据逐日累加
+        const std::vector<qint64>& secs = parsedTimeColumn(model, config.sourceTimeColumnIndex, TimeCache);
+        qint64 dayOffset = 0;
+        qint64 previous = kInvalid;
+        for (size_t i = 0; i < stamps.size(); ++i) {
+            if (secs[i] == kInvalid) continue;
+            if (previous != kInvalid && secs[i] < previous) dayOffset += TimestampParser::SECONDS_PER_DAY;
+            previous = secs[i];
+            stamps[i] = secs[i] + dayOffset;
+        }
+    }
+
+    // 2. 相对第一个有效行 (基准时间) 的秒数
+    const auto first = std::find_if(stamps.begin(), stamps.end(), [kInvalid](qint64 v) { return v != kInvalid; });
+    const qint64 baseStamp = first != stamps.end() ? *first : 0;
+    std::vector<double> seconds(stamps.size());
+    for (size_t i = 0; i < stamps.size(); ++i) {
+        seconds[i] = stamps[i] != kInvalid ? double(stamps[i] - baseStamp) : std::numeric_limits<double>::quiet_NaN();
+    }
 
-    // 更新列定义
+    // 3. 换算为输出单位并保留 3 位小数
+    QString error;
+    ColumnExpression expr = ColumnExpression::compile("round(t / k, 3)", {"t"},
+                                                      {{"k", secondsPerUnit(config.outputUnit)}}, &error);
+    if (!expr.isValid()) {
+        result.errorMessage = error;
+        return result;
+    }
+    std::vector<double> values(static_cast<size_t>(rowCount));
+    expr.evaluate({seconds.data()}, rowCount, values.data());
+    result.processedRows = int(std::count_if(values.begin(), values.end(), [](double v) { return !std::isnan(v); }));
+
+    // 4. 整列追加并更新列定义
     ColumnDefinition newDef;
     newDef.name = config.newColumnName + "\\" + config.outputUnit;
     newDef.type = WellTestColumnType::Time;
     newDef.unit = config.outputUnit;
     newDef.decimalPlaces = 3;
     definitions.append(newDef);
-
-    // 设置表头
-    model->setHorizontalHeaderItem(newColIdx, new QStandardItem(newDef.name));
-
-    // 计算逻辑
-    QDateTime baseTime;
-    bool baseSet = false;
-
-    for (int i = 0; i < rowCount; ++i) {
-        double val = 0.0;
-        bool valid = false;
-
-        if (config.useDateAndTime) {
-            // 日期+时刻模式
-            QString dStr = model->item(i, config.dateColumnIndex)->text();
-            QString tStr = model->item(i, config.timeColumnIndex)->text();
-            QDate d = parseDateString(dStr);
-            QTime t = parseTimeString(tStr);
-            if (d.isValid() && t.isValid()) {
-                QDateTime dt = combineDateAndTime(d, t);
-                if (!baseSet) { baseTime = dt; baseSet = true; }
-                double seconds = baseTime.secsTo(dt);
-                val = convertTimeToUnit(seconds, config.outputUnit);
-                valid = true;
-            }
-        } else {
-            // 仅时间模式
-            QString tStr = model->item(i, config.sourceTimeColumnIndex)->text();
-            QTime t = parseTimeString(tStr);
-            if (t.isValid()) {
-                // 如果没有日期，取当前日期与该时间组合
-                if (!baseSet) {
-                    baseTime = QDateTime(QDate::currentDate(), t);
-                    baseSet = true;
-                }
-                QDateTime dt(QDate::currentDate(), t);
-                // 处理跨天情况(简单处理: 如果时间比基准小很多，假设是第二天)
-                if (dt < baseTime) dt = dt.addDays(1);
-
-                double seconds = baseTime.secsTo(dt);
-                val = convertTimeToUnit(seconds, config.outputUnit);
-                valid = true;
-            }
-        }
-
-        if (valid) {
-            model->setItem(i, newColIdx, new QStandardItem(QString::number(val, 'f', 3)));
-            result.processedRows++;
-        } else {
-            model->setItem(i, newColIdx, new QStandardItem(""));
-        }
-    }
+    int newColIdx = model->appendNumericColumn(newDef.name, std::move(values));
 
     result.success = true;
     result.addedColumnIndex = newColIdx;
@@ -369,7 +370,7 @@ TimeConversionResult DataCalculate::convertTimeColumn(QStandardItemModel* model,
     return result;
 }
 
-PressureDropResult DataCalculate::calculatePressureDrop(QStandardItemModel* model,
+PressureDropResult DataCalculate::calculatePressureDrop(MeasurementTableModel* model,
                                                         QList<ColumnDefinition>& definitions)
 {
     PressureDropResult result;
@@ -381,36 +382,29 @@ PressureDropResult DataCalculate::calculatePressureDrop(QStandardItemModel* mode
         return result;
     }
 
-    QString unit = definitions[pIdx].unit;
-    int newColIdx = model->columnCount();
-    model->insertColumn(newColIdx);
+    // 以第一个有效压力为初始压力：压降 = p0 - p
+    std::vector<double> pressure = numericColumn(model, pIdx);
+    const auto first = std::find_if(pressure.begin(), pressure.end(), [](double v) { return !std::isnan(v); });
+    const double initialPressure = first != pressure.end() ? *first : 0.0;
+
+    QString error;
+    ColumnExpression expr = ColumnExpression::compile("round(p0 - p, 3)", {"p"}, {{"p0", initialPressure}}, &error);
+    if (!expr.isValid()) {
+        result.errorMessage = error;
+        return result;
+    }
+    std::vector<double> drop(pressure.size());
+    expr.evaluate({pressure.data()}, int(pressure.size()), drop.data());
+    result.processedRows = int(std::count_if(drop.begin(), drop.end(), [](double v) { return !std::isnan(v); }));
 
+    QString unit = definitions[pIdx].unit;
     ColumnDefinition newDef;
     newDef.name = "压降\\" + unit;
     newDef.type = WellTestColumnType::PressureDrop;
     newDef.unit = unit;
     newDef.decimalPlaces = 3;
     definitions.append(newDef);
-
-    model->setHorizontalHeaderItem(newColIdx, new QStandardItem(newDef.name));
-
-    double initialPressure = 0.0;
-    bool initSet = false;
-
-    for (int i = 0; i < model->rowCount(); ++i) {
-        QString pText = model->item(i, pIdx)->text();
-        bool ok;
-        double p = pText.toDouble(&ok);
-
-        if (ok) {
-            if (!initSet) { initialPressure = p; initSet = true; }
-            double drop = initialPressure - p;
-            model->setItem(i, newColIdx, new QStandardItem(QString::number(drop, 'f', 3)));
-            result.processedRows++;
-        } else {
-            model->setItem(i, newColIdx, new QStandardItem(""));
-        }
-    }
+    int newColIdx = model->appendNumericColumn(newDef.name, std::move(drop));
 
     result.success = true;
     result.addedColumnIndex = newColIdx;
@@ -419,7 +413,7 @@ PressureDropResult DataCalculate::calculatePressureDrop(QStandardItemModel* mode
 }
 
 // 井底流压计算逻辑实现
-PwfCalculationResult DataCalculate::calculateBottomHolePressure(QStandardItemModel* model,
+PwfCalculationResult DataCalculate::calculateBottomHolePressure(MeasurementTableModel* model,
                                                                 QList<ColumnDefinition>& definitions,
                                                                 const PwfCalculationConfig& config)
 {
@@ -454,9 +448,27 @@ PwfCalculationResult DataCalculate::calculateBottomHolePressure(QStandardItemMod
     // 公式：gamma_mix = 1 / [(1 - f_w)/gamma_o + f_w/gamma_w]
     double gamma_mix = 1.0 / ((1.0 - f_w_decimal) / config.gamma_o + f_w_decimal / config.gamma_w);
 
-    // 3. 准备新列
-    int newColIdx = model->columnCount();
-    model->insertColumn(newColIdx);
+    // 3. 整列计算
+    // 公式：Pwf = Pc + (Hres - Lwf) * gamma_mix / 100
+    // 注：除以100是将 g/cm³ * m 转换为 MPa (近似工程单位换算)
+    std::vector<double> pc = numericColumn(model, config.pcColumnIndex);
+    std::vector<double> lwf = numericColumn(model, config.lwfColumnIndex);
+    QString error;
+    ColumnExpression expr = ColumnExpression::compile(
+        QString("round(Pc + (Hres - Lwf) * gmix / 100, %1)").arg(config.decimalPlaces), {"Pc", "Lwf"},
+        {{"Hres", config.Hres}, {"gmix", gamma_mix}}, &error);
+    if (!expr.isValid()) {
+        result.errorMessage = error;
+        return result;
+    }
+    std::vector<double> pwf(pc.size());
+    expr.evaluate({pc.data(), lwf.data()}, int(pc.size()), pwf.data());
+
+    // 物理约束检查：动液面深度大于等于油层深度，物理上不合理，无法计算有效液柱
+    QVector<int> errorRows;
+    for (int i = 0; i < int(pwf.size()); ++i) {
+        if (!std::isnan(pwf[size_t(i)]) && lwf[size_t(i)] >= config.Hres) errorRows.append(i);
+    }
 
     // 获取套压的单位作为流压单位，默认为 MPa
     QString unit = "MPa";
@@ -470,39 +482,13 @@ PwfCalculationResult DataCalculate::calculateBottomHolePressure(QStandardItemMod
     newDef.unit = unit;
     newDef.decimalPlaces = config.decimalPlaces; // 使用用户选择的小数位数
     definitions.append(newDef);
+    int newColIdx = model->appendNumericColumn(newDef.name, std::move(pwf));
 
-    model->setHorizontalHeaderItem(newColIdx, new QStandardItem(newDef.name));
-
-    // 4. 逐行计算
-    int errorCount = 0;
-    for (int i = 0; i < model->rowCount(); ++i) {
-        QString pcStr = model->item(i, config.pcColumnIndex)->text();
-        QString lwfStr = model->item(i, config.lwfColumnIndex)->text();
-
-        bool pcOk, lwfOk;
-        double Pc = pcStr.toDouble(&pcOk);
-        double Lwf = lwfStr.toDouble(&lwfOk);
-
-        if (pcOk && lwfOk) {
-            // 物理约束检查
-            if (Lwf >= config.Hres) {
-                // 动液面深度大于等于油层深度，物理上不合理，无法计算有效液柱
-                model->setItem(i, newColIdx, new QStandardItem("Error: Lwf >= Hres"));
-                errorCount++;
-            } else {
-                // 公式：Pwf = Pc + (Hres - Lwf) * gamma_mix / 100
-                // 注：除以100是将 g/cm³ * m 转换为 MPa (近似工程单位换算)
-                double Pwf = Pc + (config.Hres - Lwf) * gamma_mix / 100.0;
-                // 使用用户指定的小数位数进行格式化
-                model->setItem(i, newColIdx, new QStandardItem(QString::number(Pwf, 'f', config.decimalPlaces)));
-            }
-        } else {
-            model->setItem(i, newColIdx, new QStandardItem(""));
-        }
-    }
+    // 无法计算的行写入提示文字 (该列随之转为文本列)
+    for (int row : errorRows) model->setText(row, newColIdx, "Error: Lwf >= Hres");
 
-    if (errorCount > 0) {
-        result.errorMessage = QString("计算完成，但有 %1 行数据因动液面深度大于油层深度而无法计算。").arg(errorCount);
+    if (!errorRows.isEmpty()) {
+        result.errorMessage = QString("计算完成，但有 %1 行数据因动液面深度大于油层深度而无法计算。").arg(errorRows.size());
     }
 
     result.success = true; // 即使部分行计算失败，整体流程算成功
@@ -511,35 +497,52 @@ PwfCalculationResult DataCalculate::calculateBottomHolePressure(QStandardItemMod
 }
 
 // 辅助函数实现
-QTime DataCalculate::parseTimeString(const QString& timeStr) const {
-    QStringList fmts = {"hh:mm:ss", "h:mm:ss", "hh:mm"};
-    for(const auto& f : fmts) {
-        QTime t = QTime::fromString(timeStr, f);
-        if(t.isValid()) return t;
+const std::vector<qint64>& DataCalculate::parsedTimeColumn(MeasurementTableModel* model, int column, int kind) const {
+    if (const std::vector<qint64>* cached = model->cachedTimeValues(column, kind)) return *cached;
+
+    // 从前若干个非空单元格识别一次格式
+    const int rows = model->rowCount();
+    QStringList samples;
+    for (int i = 0; i < rows && samples.size() < 64; ++i) {
+        QString s = model->text(i, column);
+        if (!s.isEmpty()) samples << s;
     }
-    return QTime();
-}
-
-QDate DataCalculate::parseDateString(const QString& dateStr) const {
-    QStringList fmts = {"yyyy-MM-dd", "yyyy/MM/dd"};
-    for(const auto& f : fmts) {
-        QDate d = QDate::fromString(dateStr, f);
-        if(d.isValid()) return d;
-    }
-    return QDate();
+    const bool isDate = kind == DateCache;
+    const TimestampParser::Format format = isDate ? TimestampParser::detectDateFormat(samples)
+                                                  : TimestampParser::detectTimeFormat(samples);
+
+    // 分块并行解析
+    std::vector<qint64> values(static_cast<size_t>(rows));
+    ColumnExpression::forEachChunk(rows, [&](int begin, int count) {
+        for (int i = begin; i < begin + count; ++i) {
+            const QString s = model->text(i, column);
+            values[size_t(i)] = isDate ? TimestampParser::parseDate(s, format) : TimestampParser::parseTime(s, format);
+        }
+    });
+    model->setCachedTimeValues(column, kind, std::move(values));
+    return *model->cachedTimeValues(column, kind);
 }
 
-QDateTime DataCalculate::combineDateAndTime(const QDate& date, const QTime& time) const {
-    return QDateTime(date, time);
+double DataCalculate::secondsPerUnit(const QString& unit) const {
+    if (unit == "h") return 3600.0;
+    if (unit == "min") return 60.0;
+    return 1.0;
 }
 
-double DataCalculate::convertTimeToUnit(double seconds, const QString& unit) const {
-    if (unit == "h") return seconds / 3600.0;
-    if (unit == "min") return seconds / 60.0;
-    return seconds;
+std::vector<double> DataCalculate::numericColumn(MeasurementTableModel* model, int column) const {
+    const int rows = model->rowCount();
+    if (const double* data = model->columnData(column)) return std::vector<double>(data, data + rows);
+    // 文本列逐格解析，无法解析的单元格按空值处理
+    std::vector<double> values(static_cast<size_t>(rows));
+    for (int i = 0; i < rows; ++i) {
+        bool ok = false;
+        double v = model->value(i, column, &ok);
+        values[size_t(i)] = ok ? v : std::numeric_limits<double>::quiet_NaN();
+    }
+    return values;
 }
 
-int DataCalculate::findPressureColumn(QStandardItemModel* model, const QList<ColumnDefinition>& definitions) const {
+int DataCalculate::findPressureColumn(MeasurementTableModel* model, const QList<ColumnDefinition>& definitions) const {
     for(int i=0; i<definitions.size(); ++i) {
         if(definitions[i].type == WellTestColumnType::Pressure) return i;
     }
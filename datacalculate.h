@@ -5,7 +5,7 @@
  * 1. 包含时间转换的配置对话框类 TimeConversionDialog。
  * 2. 包含井底流压计算配置对话框类 PwfCalculationDialog (新增)。
  * 3. 提供 DataCalculate 类，用于执行时间格式转换、压降计算和井底流压计算逻辑。
- * 4. 所有的计算操作都直接修改传入的 QStandardItemModel。
+ * 4. 所有的计算操作都直接修改传入的 MeasurementTableModel。
  */
 
 #ifndef DATACALCULATE_H
@@ -13,7 +13,6 @@
 
 #include <QObject>
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QRadioButton>
 #include <QComboBox>
 #include <QLineEdit>
@@ -21,6 +20,7 @@
 #include <QDoubleSpinBox>
 #include <QSpinBox>
 #include "dataeditorwidget.h" // 获取相关结构体定义
+#include "measurementtablemodel.h"
 
 // 时间转换配置结构体
 struct TimeConversionConfig {
@@ -130,28 +130,32 @@ public:
     explicit DataCalculate(QObject* parent = nullptr);
 
     // 执行时间转换逻辑
-    TimeConversionResult convertTimeColumn(QStandardItemModel* model,
+    TimeConversionResult convertTimeColumn(MeasurementTableModel* model,
                                            QList<ColumnDefinition>& definitions,
                                            const TimeConversionConfig& config);
 
     // 执行压降计算逻辑
-    PressureDropResult calculatePressureDrop(QStandardItemModel* model,
+    PressureDropResult calculatePressureDrop(MeasurementTableModel* model,
                                              QList<ColumnDefinition>& definitions);
 
     // 执行井底流压计算逻辑
-    PwfCalculationResult calculateBottomHolePressure(QStandardItemModel* model,
+    PwfCalculationResult calculateBottomHolePressure(MeasurementTableModel* model,
                                                      QList<ColumnDefinition>& definitions,
                                                      const PwfCalculationConfig& config);
 
 private:
-    // 辅助函数：时间解析
-    QTime parseTimeString(const QString& timeStr) const;
-    QDate parseDateString(const QString& dateStr) const;
-    QDateTime combineDateAndTime(const QDate& date, const QTime& time) const;
-    double convertTimeToUnit(double seconds, const QString& unit) const;
+    // 时间解析结果在模型中的缓存类别
+    enum TimeCacheKind { DateCache = 1, TimeCache = 2 };
+
+    // 辅助函数：整列解析为日期天数或当天秒数 (失败为 TimestampParser::INVALID)，结果缓存在模型中
+    const std::vector<qint64>& parsedTimeColumn(MeasurementTableModel* model, int column, int kind) const;
+    // 输出时间单位对应的秒数
+    double secondsPerUnit(const QString& unit) const;
+    // 整列数值 (空值及无法解析的单元格为 NaN)
+    std::vector<double> numericColumn(MeasurementTableModel* model, int column) const;
 
     // 辅助函数：查找压力列
-    int findPressureColumn(QStandardItemModel* model, const QList<ColumnDefinition>& definitions) const;
+    int findPressureColumn(MeasurementTableModel* model, const QList<ColumnDefinition>& definitions) const;
 };
 
 #endif // DATACALCULATE_H
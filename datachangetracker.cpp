@@ -0,0 +1,163 @@
+/*
+ * 文件名: datachangetracker.cpp
+ * 文件作用: 数据表修改的版本记录与合并通知实现
+ * 功能描述:
+ * 1. 单元格修改按行范围累积 (有序合并)，列号记入集合；插入/删除行、列和模型重置只置标志。
+ * 2. 合并窗口用单次定时器实现：每次修改重新计时，距第一条未通知修改超过最长等待时不再推迟。
+ */
+
+#include "datachangetracker.h"
+#include <algorithm>
+
+// ============================================================================
+// DataChangeSet
+// ============================================================================
+
+bool DataChangeSet::isEmpty() const
+{
+    return !reset && !rowsMoved && firstShiftedColumn == INT_MAX && rowRanges.isEmpty();
+}
+
+bool DataChangeSet::touches(int column) const
+{
+    return rowsMoved || columns.contains(column);
+}
+
+void DataChangeSet::addRows(int first, int last)
+{
+    if (first > last) return;
+
+    // 插入到有序位置后与相邻 (相交或紧邻) 的范围合并
+    auto it = std::lower_bound(rowRanges.begin(), rowRanges.end(), first,
+                               [](const QPair<int, int>& range, int row) { return range.second + 1 < row; });
+    auto end = it;
+    while (end != rowRanges.end() && end->first <= last + 1) {
+        first = qMin(first, end->first);
+        last = qMax(last, end->second);
+        ++end;
+    }
+    const int at = int(it - rowRanges.begin());
+    rowRanges.erase(it, end);
+    rowRanges.insert(at, qMakePair(first, last));
+
+    if (rowRanges.size() > kMaxRowRanges) {
+        const QPair<int, int> hull(rowRanges.first().first, rowRanges.last().second);
+        rowRanges = { hull };
+    }
+}
+
+void DataChangeSet::merge(const DataChangeSet& other)
+{
+    revision = qMax(revision, other.revision);
+    reset = reset || other.reset;
+    rowsMoved = rowsMoved || other.rowsMoved;
+    firstShiftedColumn = qMin(firstShiftedColumn, other.firstShiftedColumn);
+    for (const QPair<int, int>& range : other.rowRanges) addRows(range.first, range.second);
+    columns.unite(other.columns);
+}
+
+// ============================================================================
+// DataChangeTracker
+// ============================================================================
+
+DataChangeTracker::DataChangeTracker(QObject* parent)
+    : QObject(parent),
+    m_delay(300),
+    m_maxDelay(1000),
+    m_revision(0)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &DataChangeTracker::flush);
+}
+
+void DataChangeTracker::setModel(QAbstractItemModel* model)
+{
+    if (m_model) disconnect(m_model, nullptr, this, nullptr);
+    m_model = model;
+    m_headers = currentHeaders();
+    if (!model) return;
+
+    connect(model, &QAbstractItemModel::dataChanged, this, &DataChangeTracker::onDataChanged);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &DataChangeTracker::onRowsMoved);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &DataChangeTracker::onRowsMoved);
+    connect(model, &QAbstractItemModel::rowsMoved, this, &DataChangeTracker::onRowsMoved);
+    connect(model, &QAbstractItemModel::layoutChanged, this, &DataChangeTracker::onRowsMoved);
+    connect(model, &QAbstractItemModel::columnsInserted, this,
+            [this](const QModelIndex&, int first, int) { onColumnsMoved(first); });
+    connect(model, &QAbstractItemModel::columnsRemoved, this,
+            [this](const QModelIndex&, int first, int) { onColumnsMoved(first); });
+    connect(model, &QAbstractItemModel::headerDataChanged, this, [this](Qt::Orientation orientation) {
+        if (orientation == Qt::Horizontal) m_headers = currentHeaders();
+    });
+    connect(model, &QAbstractItemModel::modelReset, this, &DataChangeTracker::onModelReset);
+}
+
+void DataChangeTracker::setDelay(int delayMs, int maxDelayMs)
+{
+    m_delay = qMax(0, delayMs);
+    m_maxDelay = qMax(m_delay, maxDelayMs);
+}
+
+void DataChangeTracker::flush()
+{
+    m_timer.stop();
+    if (m_pending.isEmpty()) return;
+    DataChangeSet changes = m_pending;
+    changes.revision = m_revision;
+    m_pending = DataChangeSet();
+    emit changesReady(changes);
+}
+
+void DataChangeTracker::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid()) return;
+    m_pending.addRows(topLeft.row(), bottomRight.row());
+    for (int c = topLeft.column(); c <= bottomRight.column(); ++c) m_pending.columns.insert(c);
+    touch();
+}
+
+void DataChangeTracker::onRowsMoved()
+{
+    m_pending.rowsMoved = true;
+    touch();
+}
+
+void DataChangeTracker::onColumnsMoved(int first)
+{
+    m_pending.firstShiftedColumn = qMin(m_pending.firstShiftedColumn, first);
+    m_headers = currentHeaders();
+    touch();
+}
+
+void DataChangeTracker::onModelReset()
+{
+    // 表头不变：同一张表的行被整体重排或删除
+    const QStringList headers = currentHeaders();
+    if (headers == m_headers) m_pending.rowsMoved = true;
+    else m_pending.reset = true;
+    m_headers = headers;
+    touch();
+}
+
+void DataChangeTracker::touch()
+{
+    ++m_revision;
+    if (!m_timer.isActive()) {
+        m_pendingSince.start();
+        m_timer.start(m_delay);
+        return;
+    }
+    // 持续修改时不再推迟超过最长等待时间
+    const qint64 remaining = m_maxDelay - m_pendingSince.elapsed();
+    if (remaining > m_delay) m_timer.start(m_delay);
+}
+
+QStringList DataChangeTracker::currentHeaders() const
+{
+    QStringList headers;
+    if (!m_model) return headers;
+    for (int c = 0; c < m_model->columnCount(); ++c) {
+        headers.append(m_model->headerData(c, Qt::Horizontal).toString());
+    }
+    return headers;
+}
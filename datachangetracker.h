@@ -0,0 +1,89 @@
+/*
+ * 文件名: datachangetracker.h
+ * 文件作用: 数据表修改的版本记录与合并通知头文件 (不依赖界面)
+ * 功能描述:
+ * 1. DataChangeTracker 监听表格模型的信号，每次修改使版本号加一，并把修改过的行范围、列号累积到待发送的变更集中。
+ * 2. 连续的修改在合并窗口 (默认 300 ms) 内合并为一次 changesReady 通知；持续编辑时最迟每 1 s 发送一次。
+ * 3. 变更集区分三种情况：只改了单元格 (给出行范围与列号，下游只需重算受影响的窗口)、
+ *    插入/删除了行 (行号移动，下游整段重算)、列号移动或表格换成另一张表 (下游按列号建立的关联失效)。
+ * 4. 模型重置后表头与重置前相同时 (如大量分散行的删除) 视为行号移动，而不是换表。
+ */
+
+#ifndef DATACHANGETRACKER_H
+#define DATACHANGETRACKER_H
+
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <climits>
+
+// 一次通知中合并的全部修改
+struct DataChangeSet
+{
+    quint64 revision = 0;                 // 合并后的数据版本号
+    bool reset = false;                   // 换成了另一张表：所有按列号建立的关联失效
+    bool rowsMoved = false;               // 插入或删除过行：行号已移动，rowRanges 不再可靠
+    int firstShiftedColumn = INT_MAX;     // 插入或删除列时，不小于该列号的列已移动
+    QVector<QPair<int, int>> rowRanges;   // 被修改单元格所在的行 (闭区间，升序且互不相交)
+    QSet<int> columns;                    // 被修改单元格所在的列
+
+    // 行范围超过该数目时合并为一个包络范围
+    static constexpr int kMaxRowRanges = 64;
+
+    bool isEmpty() const;
+    // 列 column 的单元格被修改过 (行号移动时视为所有列都被修改)
+    bool touches(int column) const;
+    // 按列号建立的关联是否仍然有效
+    bool keepsColumn(int column) const { return !reset && column < firstShiftedColumn; }
+
+    void addRows(int first, int last);
+    void merge(const DataChangeSet& other);
+};
+
+class DataChangeTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataChangeTracker(QObject* parent = nullptr);
+
+    void setModel(QAbstractItemModel* model);
+    // 合并窗口：最后一次修改后等待 delayMs 再通知；持续修改时最迟 maxDelayMs 通知一次
+    void setDelay(int delayMs, int maxDelayMs);
+
+    // 当前数据版本号 (每次修改加一，包括尚未通知的修改)
+    quint64 revision() const { return m_revision; }
+    bool hasPendingChanges() const { return !m_pending.isEmpty(); }
+
+public slots:
+    // 立即发送尚未通知的修改
+    void flush();
+
+signals:
+    void changesReady(const DataChangeSet& changes);
+
+private:
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void onRowsMoved();
+    void onColumnsMoved(int first);
+    void onModelReset();
+    void touch();
+    QStringList currentHeaders() const;
+
+    QPointer<QAbstractItemModel> m_model;
+    QTimer m_timer;
+    QElapsedTimer m_pendingSince;   // 第一条未通知修改的时间
+    int m_delay;
+    int m_maxDelay;
+    quint64 m_revision;
+    DataChangeSet m_pending;
+    QStringList m_headers;          // 用于区分重置是换表还是行号移动
+};
+
+#endif // DATACHANGETRACKER_H
@@ -0,0 +1,154 @@
+/*
+ * 文件名: dataeditcommands.cpp
+ * 文件作用: 数据编辑器撤销命令实现
+ * 功能描述:
+ * 1. 删除类命令在 redo 时从模型取出内容保存，undo 时原样放回；插入类命令 undo 时直接删除。
+ * 2. 写入命令 undo 时写回原文字，并删除写入时扩展出的行列。
+ */
+
+#include "dataeditcommands.h"
+
+// ============================================================================
+// 行
+// ============================================================================
+
+InsertRowsCommand::InsertRowsCommand(MeasurementTableModel* model, int row, int count, QUndoCommand* parent)
+    : QUndoCommand(parent), m_model(model), m_row(row), m_count(count)
+{
+    setText(count == 1 ? "插入行" : QString("插入 %1 行").arg(count));
+}
+
+void InsertRowsCommand::redo()
+{
+    m_model->insertRows(m_row, m_count);
+}
+
+void InsertRowsCommand::undo()
+{
+    m_model->removeRows(m_row, m_count);
+}
+
+RemoveRowsCommand::RemoveRowsCommand(MeasurementTableModel* model, const QVector<int>& rows, QUndoCommand* parent)
+    : QUndoCommand(parent), m_model(model), m_rows(rows)
+{
+    setText(QString("删除 %1 行").arg(rows.size()));
+}
+
+void RemoveRowsCommand::redo()
+{
+    m_removed = m_model->takeRows(m_rows);
+}
+
+void RemoveRowsCommand::undo()
+{
+    m_model->restoreRows(m_rows, m_removed);
+    m_removed = TextDataTable();
+}
+
+// ============================================================================
+// 列
+// ============================================================================
+
+InsertColumnCommand::InsertColumnCommand(MeasurementTableModel* model, QList<ColumnDefinition>* definitions,
+                                         int column, const ColumnDefinition& definition, QUndoCommand* parent)
+    : QUndoCommand(parent), m_model(model), m_definitions(definitions), m_column(column), m_definition(definition)
+{
+    setText("插入列");
+}
+
+void InsertColumnCommand::redo()
+{
+    m_model->insertColumn(m_column);
+    m_model->setHeaderData(m_column, Qt::Horizontal, m_definition.name);
+    if (m_column < m_definitions->size()) m_definitions->insert(m_column, m_definition);
+    else m_definitions->append(m_definition);
+}
+
+void InsertColumnCommand::undo()
+{
+    m_model->removeColumn(m_column);
+    if (m_column < m_definitions->size()) m_definitions->removeAt(m_column);
+}
+
+RemoveColumnsCommand::RemoveColumnsCommand(MeasurementTableModel* model, QList<ColumnDefinition>* definitions,
+                                           const QVector<int>& columns, QUndoCommand* parent)
+    : QUndoCommand(parent), m_model(model), m_definitions(definitions), m_columns(columns)
+{
+    setText(columns.size() == 1 ? "删除列" : QString("删除 %1 列").arg(columns.size()));
+}
+
+void RemoveColumnsCommand::redo()
+{
+    // 从后往前删除，前面的列号不受影响
+    m_removed.resize(m_columns.size());
+    for (int i = int(m_columns.size()) - 1; i >= 0; --i) {
+        RemovedColumn& removed = m_removed[i];
+        removed.column = m_columns[i];
+        removed.hasDefinition = removed.column < m_definitions->size();
+        if (removed.hasDefinition) removed.definition = m_definitions->takeAt(removed.column);
+        removed.snapshot = m_model->takeColumn(removed.column);
+    }
+}
+
+void RemoveColumnsCommand::undo()
+{
+    for (const RemovedColumn& removed : m_removed) {
+        m_model->restoreColumn(removed.column, removed.snapshot);
+        if (removed.hasDefinition) m_definitions->insert(qMin(removed.column, int(m_definitions->size())), removed.definition);
+    }
+    m_removed.clear();
+}
+
+AppendedColumnCommand::AppendedColumnCommand(MeasurementTableModel* model, QList<ColumnDefinition>* definitions,
+                                             int column, const QString& text, QUndoCommand* parent)
+    : QUndoCommand(text, parent), m_model(model), m_definitions(definitions), m_column(column),
+    m_definitionIndex(int(definitions->size()) - 1), m_done(true)
+{
+}
+
+void AppendedColumnCommand::redo()
+{
+    // 首次 push 时计算已完成
+    if (m_done) return;
+    m_model->restoreColumn(m_column, m_snapshot);
+    if (m_definitionIndex >= 0) m_definitions->insert(qMin(m_definitionIndex, int(m_definitions->size())), m_definition);
+    m_snapshot = MeasurementTableModel::ColumnSnapshot();
+    m_done = true;
+}
+
+void AppendedColumnCommand::undo()
+{
+    m_snapshot = m_model->takeColumn(m_column);
+    if (m_definitionIndex >= 0 && m_definitionIndex < m_definitions->size()) {
+        m_definition = m_definitions->takeAt(m_definitionIndex);
+    }
+    m_done = false;
+}
+
+// ============================================================================
+// 单元格
+// ============================================================================
+
+SetCellsCommand::SetCellsCommand(MeasurementTableModel* model, int row, int column, const QVector<QStringList>& cells,
+                                 const QString& text, QUndoCommand* parent)
+    : QUndoCommand(text, parent), m_model(model), m_row(row), m_column(column), m_cells(cells),
+    m_previousRows(0), m_previousColumns(0)
+{
+}
+
+void SetCellsCommand::redo()
+{
+    m_previousRows = m_model->rowCount();
+    m_previousColumns = m_model->columnCount();
+    m_previous = m_model->setTextBlock(m_row, m_column, m_cells);
+}
+
+void SetCellsCommand::undo()
+{
+    m_model->setTextBlock(m_row, m_column, m_previous);
+    m_previous.clear();
+    if (m_model->rowCount() > m_previousRows) m_model->removeRows(m_previousRows, m_model->rowCount() - m_previousRows);
+    if (m_model->columnCount() > m_previousColumns) {
+        m_model->removeColumns(m_previousColumns, m_model->columnCount() - m_previousColumns);
+    }
+}
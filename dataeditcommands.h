@@ -0,0 +1,124 @@
+/*
+ * 文件名: dataeditcommands.h
+ * 文件作用: 数据编辑器撤销命令头文件
+ * 功能描述:
+ * 1. 定义插入/删除行、插入/删除列、粘贴单元格区域、计算追加列等编辑操作的 QUndoCommand。
+ * 2. 命令只保存差异：删除操作保存被删除的行列内容，写入操作保存被覆盖的原文字，不保存整表快照。
+ * 3. 每个命令通过 MeasurementTableModel 的批量接口一次完成，只产生少量范围信号或一次重置。
+ * 4. 列命令同时维护数据编辑器的列定义列表，使撤销后列属性与表格列一致。
+ */
+
+#ifndef DATAEDITCOMMANDS_H
+#define DATAEDITCOMMANDS_H
+
+#include <QUndoCommand>
+#include "dataeditorwidget.h"
+#include "measurementtablemodel.h"
+
+// 在 row 处插入 count 个空行
+class InsertRowsCommand : public QUndoCommand
+{
+public:
+    InsertRowsCommand(MeasurementTableModel* model, int row, int count, QUndoCommand* parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    MeasurementTableModel* m_model;
+    int m_row;
+    int m_count;
+};
+
+// 删除若干行 (任意行集合)
+class RemoveRowsCommand : public QUndoCommand
+{
+public:
+    RemoveRowsCommand(MeasurementTableModel* model, const QVector<int>& rows, QUndoCommand* parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    MeasurementTableModel* m_model;
+    QVector<int> m_rows;          // 升序、无重复
+    TextDataTable m_removed;      // 被删除行的内容
+};
+
+// 在 column 处插入一个空列
+class InsertColumnCommand : public QUndoCommand
+{
+public:
+    InsertColumnCommand(MeasurementTableModel* model, QList<ColumnDefinition>* definitions, int column,
+                        const ColumnDefinition& definition, QUndoCommand* parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    MeasurementTableModel* m_model;
+    QList<ColumnDefinition>* m_definitions;
+    int m_column;
+    ColumnDefinition m_definition;
+};
+
+// 删除若干列
+class RemoveColumnsCommand : public QUndoCommand
+{
+public:
+    RemoveColumnsCommand(MeasurementTableModel* model, QList<ColumnDefinition>* definitions,
+                         const QVector<int>& columns, QUndoCommand* parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    struct RemovedColumn {
+        int column;
+        MeasurementTableModel::ColumnSnapshot snapshot;
+        bool hasDefinition;
+        ColumnDefinition definition;
+    };
+
+    MeasurementTableModel* m_model;
+    QList<ColumnDefinition>* m_definitions;
+    QVector<int> m_columns;                  // 升序、无重复
+    QVector<RemovedColumn> m_removed;        // 按 m_columns 顺序
+};
+
+// 计算功能已在末尾追加的列 (压降、井底流压、时间转换)：首次 redo 不做任何事；
+// 对应的列定义是计算时追加到定义列表末尾的一项
+class AppendedColumnCommand : public QUndoCommand
+{
+public:
+    AppendedColumnCommand(MeasurementTableModel* model, QList<ColumnDefinition>* definitions, int column,
+                          const QString& text, QUndoCommand* parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    MeasurementTableModel* m_model;
+    QList<ColumnDefinition>* m_definitions;
+    int m_column;
+    int m_definitionIndex;
+    bool m_done;
+    MeasurementTableModel::ColumnSnapshot m_snapshot;
+    ColumnDefinition m_definition;
+};
+
+// 从 (row, column) 起写入文字矩形 (粘贴、单元格编辑)
+class SetCellsCommand : public QUndoCommand
+{
+public:
+    SetCellsCommand(MeasurementTableModel* model, int row, int column, const QVector<QStringList>& cells,
+                    const QString& text, QUndoCommand* parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    MeasurementTableModel* m_model;
+    int m_row;
+    int m_column;
+    QVector<QStringList> m_cells;
+    QVector<QStringList> m_previous;   // 被覆盖的原文字
+    int m_previousRows;                // 写入前的行数、列数 (写入时可能扩展)
+    int m_previousColumns;
+};
+
+#endif // DATAEDITCOMMANDS_H
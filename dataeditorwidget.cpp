@@ -3,8 +3,8 @@
  * 文件作用: 数据编辑器主窗口实现文件
  * 功能描述:
  * 1. 实现了表格数据的增删改查、排序和过滤功能。
- * 2. 集成了 DataImportDialog，支持配置化导入 CSV/TXT 文件。
- * 3. 集成了 QAxObject，支持直接读取 Excel (.xls/.xlsx) 文件内容到表格。
+ * 2. 集成了 DataImportDialog，支持配置化导入 CSV/TXT 文件 (TextDataReader 内存映射流式读取)。
+ * 3. 集成了 XlsxReader，内置解析 .xlsx 工作簿；旧版 .xls 文件仍通过 QAxObject 读取。
  * 4. 实现了数据与项目文件的同步保存与恢复。
  */
 
@@ -14,6 +14,10 @@
 #include "datacalculate.h"
 #include "modelparameter.h"
 #include "dataimportdialog.h"
+#include "textdatareader.h"
+#include "xlsxreader.h"
+#include "projectdatafile.h"
+#include "dataeditcommands.h"
 
 #include <QFileDialog>
 #include <QMessageBox>
@@ -25,8 +29,13 @@
 #include <QTextCodec>
 #include <QLineEdit>
 #include <QEvent>
-#include <QAxObject> // 用于 Excel 操作
+#include <QAxObject> // 用于旧版 .xls 文件
 #include <QDir>      // 用于路径转换
+#include <QProgressDialog>
+#include <QAbstractProxyModel>
+#include <QApplication>
+#include <QClipboard>
+#include <QMetaProperty>
 
 // ============================================================================
 // 内部类：NoContextMenuDelegate 实现
@@ -53,6 +62,20 @@ QWidget *NoContextMenuDelegate::createEditor(QWidget *parent, const QStyleOption
     return editor;
 }
 
+void NoContextMenuDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    QAbstractProxyModel* proxy = qobject_cast<QAbstractProxyModel*>(model);
+    MeasurementTableModel* table = qobject_cast<MeasurementTableModel*>(proxy ? proxy->sourceModel() : model);
+    if (!m_undoStack || !table) {
+        QStyledItemDelegate::setModelData(editor, model, index);
+        return;
+    }
+    QModelIndex source = proxy ? proxy->mapToSource(index) : index;
+    QString text = editor->metaObject()->userProperty().read(editor).toString();
+    if (text == table->text(source.row(), source.column())) return;
+    m_undoStack->push(new SetCellsCommand(table, source.row(), source.column(), {QStringList{text}}, "编辑单元格"));
+}
+
 // ============================================================================
 // DataEditorWidget 实现
 // ============================================================================
@@ -60,9 +83,12 @@ QWidget *NoContextMenuDelegate::createEditor(QWidget *parent, const QStyleOption
 DataEditorWidget::DataEditorWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::DataEditorWidget),
-    m_dataModel(new QStandardItemModel(this)),
-    m_proxyModel(new QSortFilterProxyModel(this)),
-    m_undoStack(new QUndoStack(this))
+    m_dataModel(new MeasurementTableModel(this)),
+    m_proxyModel(new RowFilterProxyModel(this)),
+    m_undoStack(new QUndoStack(this)),
+    m_waitingForProjectData(false),
+    m_dataRevision(0),
+    m_searchRevision(0)
 {
     ui->setupUi(this);
     initUI();
@@ -73,9 +99,7 @@ DataEditorWidget::DataEditorWidget(QWidget *parent) :
     m_searchTimer = new QTimer(this);
     m_searchTimer->setSingleShot(true);
     m_searchTimer->setInterval(300);
-    connect(m_searchTimer, &QTimer::timeout, this, [this](){
-        m_proxyModel->setFilterWildcard(ui->searchLineEdit->text());
-    });
+    connect(m_searchTimer, &QTimer::timeout, this, &DataEditorWidget::startSearch);
 }
 
 DataEditorWidget::~DataEditorWidget()
@@ -86,14 +110,27 @@ DataEditorWidget::~DataEditorWidget()
 void DataEditorWidget::initUI()
 {
     ui->dataTableView->setContextMenuPolicy(Qt::CustomContextMenu);
-    ui->dataTableView->setItemDelegate(new NoContextMenuDelegate(this));
+    ui->dataTableView->setItemDelegate(new NoContextMenuDelegate(m_undoStack, this));
+
+    // 撤销/重做/粘贴快捷键在表格获得焦点时生效
+    m_undoStack->setUndoLimit(100);
+    m_undoAction = m_undoStack->createUndoAction(this, "撤销");
+    m_undoAction->setShortcut(QKeySequence::Undo);
+    m_redoAction = m_undoStack->createRedoAction(this, "重做");
+    m_redoAction->setShortcut(QKeySequence::Redo);
+    QAction* pasteAction = new QAction("粘贴", this);
+    pasteAction->setShortcut(QKeySequence::Paste);
+    connect(pasteAction, &QAction::triggered, this, &DataEditorWidget::onPasteCells);
+    for (QAction* action : {m_undoAction, m_redoAction, pasteAction}) {
+        action->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+        ui->dataTableView->addAction(action);
+    }
     updateButtonsState();
 }
 
 void DataEditorWidget::setupModel()
 {
     m_proxyModel->setSourceModel(m_dataModel);
-    m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
     ui->dataTableView->setModel(m_proxyModel);
     ui->dataTableView->setSelectionBehavior(QAbstractItemView::SelectItems);
     ui->dataTableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
@@ -110,7 +147,22 @@ void DataEditorWidget::setupConnections()
     connect(ui->btnCalcPwf, &QPushButton::clicked, this, &DataEditorWidget::onCalcPwf);
     connect(ui->searchLineEdit, &QLineEdit::textChanged, this, &DataEditorWidget::onSearchTextChanged);
     connect(ui->dataTableView, &QTableView::customContextMenuRequested, this, &DataEditorWidget::onCustomContextMenu);
-    connect(m_dataModel, &QStandardItemModel::itemChanged, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::dataChanged, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::headerDataChanged, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::rowsInserted, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::rowsRemoved, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::columnsInserted, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::columnsRemoved, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &MeasurementTableModel::modelReset, this, &DataEditorWidget::onModelDataChanged);
+    // 增删行或重新装载后原筛选结果失效，按搜索框文字重新搜索
+    connect(m_proxyModel, &RowFilterProxyModel::rowFilterInvalidated, this, &DataEditorWidget::onSearchTextChanged);
+    connect(&m_searchWatcher, &QFutureWatcher<TableSearchIndex::Result>::finished, this, &DataEditorWidget::onSearchFinished);
+    // 每次编辑 (含撤销、重做) 只通知一次数据变化
+    connect(m_undoStack, &QUndoStack::indexChanged, this, [this]() {
+        updateButtonsState();
+        emit dataChanged();
+    });
+    connect(ModelParameter::instance(), &ModelParameter::tableDataReady, this, &DataEditorWidget::onProjectTableDataReady);
 }
 
 void DataEditorWidget::updateButtonsState()
@@ -127,7 +179,7 @@ void DataEditorWidget::updateButtonsState()
 // 公共接口
 // ============================================================================
 
-QStandardItemModel* DataEditorWidget::getDataModel() const { return m_dataModel; }
+MeasurementTableModel* DataEditorWidget::getDataModel() const { return m_dataModel; }
 QString DataEditorWidget::getCurrentFileName() const { return m_currentFilePath; }
 bool DataEditorWidget::hasData() const { return m_dataModel->rowCount() > 0; }
 
@@ -206,11 +258,14 @@ bool DataEditorWidget::loadFileInternal(const QString& path)
 
 bool DataEditorWidget::loadFileWithConfig(const DataImportSettings& settings)
 {
+    m_waitingForProjectData = false;
     m_dataModel->clear();
+    m_undoStack->clear();
     m_columnDefinitions.clear();
 
-    // ================= Excel 加载逻辑 =================
-    if (settings.isExcel) {
+    // ================= 旧版 Excel (.xls) 加载逻辑 =================
+    // .xlsx 由内置读取器解析 (见下文)，只有二进制 .xls 才需要启动 Excel 做 COM 自动化
+    if (settings.isExcel && !XlsxReader::isXlsxFile(settings.filePath)) {
         bool headerProcessed = false;
 
         QAxObject excel("Excel.Application");
@@ -275,9 +330,7 @@ bool DataEditorWidget::loadFileWithConfig(const DataImportSettings& settings)
                     }
                     // 数据行处理
                     else if (i >= startIdx) {
-                        QList<QStandardItem*> items;
-                        for(const QString& field : fields) items.append(new QStandardItem(field));
-                        m_dataModel->appendRow(items);
+                        m_dataModel->appendRow(fields);
                     }
                 }
                 delete usedRange;
@@ -305,81 +358,52 @@ bool DataEditorWidget::loadFileWithConfig(const DataImportSettings& settings)
         return true;
     }
 
-    // ================= 文本文件加载逻辑 =================
-    QFile file(settings.filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "错误", "无法打开文件: " + settings.filePath);
-        return false;
+    // ================= 文本文件 / XLSX 加载逻辑 =================
+    // 两种读取器都直接生成列式数据，数值列为 double，只有文本列保留字符串
+    QProgressDialog progress("正在读取数据文件...", QString(), 0, 100, this);
+    progress.setWindowTitle("数据导入");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    auto updateProgress = [&progress](int value, const QString& message) {
+        progress.setLabelText(message);
+        progress.setValue(value);
+    };
+
+    TextDataTable table;
+    if (settings.isExcel) {
+        XlsxReader reader;
+        connect(&reader, &XlsxReader::progressUpdated, &progress, updateProgress);
+        table = reader.read(settings);
+    } else {
+        // 内存映射流式读取，分块并发解析
+        TextDataReader reader;
+        connect(&reader, &TextDataReader::progressUpdated, &progress, updateProgress);
+        table = reader.read(settings);
     }
-
-    // 选择解码器
-    QTextCodec* codec = nullptr;
-    if (settings.encoding.startsWith("GBK")) codec = QTextCodec::codecForName("GBK");
-    else if (settings.encoding.startsWith("UTF-8")) codec = QTextCodec::codecForName("UTF-8");
-    else if (settings.encoding.startsWith("ISO")) codec = QTextCodec::codecForName("ISO-8859-1");
-    else codec = QTextCodec::codecForLocale();
-    if (!codec) codec = QTextCodec::codecForName("UTF-8");
-
-    // 读取全部内容并解码
-    QByteArray fileData = file.readAll();
-    file.close();
-
-    QString fileContent = codec->toUnicode(fileData);
-    QTextStream in(&fileContent);
-
-    QList<QString> allLines;
-    while (!in.atEnd()) {
-        allLines.append(in.readLine());
+    if (!table.success) {
+        progress.close();
+        QMessageBox::critical(this, "错误", table.errorMessage);
+        return false;
     }
 
-    // 确定分隔符
-    QChar separator = ',';
-    if (!allLines.isEmpty()) {
-        QString firstLine = allLines.first();
-        if (settings.separator.contains("Tab")) separator = '\t';
-        else if (settings.separator.contains("Space")) separator = ' ';
-        else if (settings.separator.contains("Semicolon")) separator = ';';
-        else if (settings.separator.contains("Auto")) {
-            if (firstLine.count('\t') > firstLine.count(',')) separator = '\t';
-        }
-    }
+    populateModel(table);
+    return true;
+}
 
-    bool headerProcessed = false;
-    int startIdx = settings.startRow - 1;
-    int headerIdx = settings.headerRow - 1;
-
-    // 解析文本行
-    for (int i = 0; i < allLines.size(); ++i) {
-        if (i < startIdx && !(settings.useHeader && i == headerIdx)) continue;
-        QString line = allLines[i].trimmed();
-        if (line.isEmpty()) continue;
-
-        QStringList fields = line.split(separator);
-        // 去除引号
-        for(int k=0; k<fields.size(); ++k) {
-            QString f = fields[k].trimmed();
-            if (f.startsWith('"') && f.endsWith('"')) f = f.mid(1, f.length()-2);
-            fields[k] = f;
-        }
+void DataEditorWidget::populateModel(TextDataTable& table)
+{
+    // 列缓冲区直接移交给表格模型 (表头随之设置)，不逐格复制
+    m_dataModel->setTable(table);
+    int cols = m_dataModel->columnCount();
 
-        if (settings.useHeader && i == headerIdx) {
-            m_dataModel->setHorizontalHeaderLabels(fields);
-            for(const QString& h : fields) {
-                ColumnDefinition def; def.name = h;
-                m_columnDefinitions.append(def);
-            }
-            headerProcessed = true;
-        } else if (i >= startIdx) {
-            QList<QStandardItem*> items;
-            for(const QString& field : fields) items.append(new QStandardItem(field));
-            m_dataModel->appendRow(items);
+    if (table.headerProcessed && !table.headers.isEmpty()) {
+        for (const QString& h : table.headers) {
+            ColumnDefinition def; def.name = h;
+            m_columnDefinitions.append(def);
         }
-    }
-
-    if (!headerProcessed || m_columnDefinitions.isEmpty()) {
-        int cols = m_dataModel->columnCount();
+    } else {
         QStringList defHeaders;
-        for(int i=0; i<cols; i++) {
+        for (int i = 0; i < cols; i++) {
             QString name = QString("Col %1").arg(i+1);
             defHeaders << name;
             ColumnDefinition def; def.name = name;
@@ -387,92 +411,75 @@ bool DataEditorWidget::loadFileWithConfig(const DataImportSettings& settings)
         }
         m_dataModel->setHorizontalHeaderLabels(defHeaders);
     }
-
-    return true;
 }
 
 // ============================================================================
 // 数据保存与恢复
 // ============================================================================
 
+bool DataEditorWidget::commitToProject()
+{
+    // 表格还没从项目文件填充完成，此时的空表不能写回
+    if (m_waitingForProjectData) return false;
+    // 列式数据直接写入二进制表格文件，不再逐格转为 JSON 字符串
+    ModelParameter::instance()->saveTableData(m_dataModel->toTable());
+    return true;
+}
+
 void DataEditorWidget::onSave()
 {
-    QJsonArray data = serializeModelToJson();
-    ModelParameter::instance()->saveTableData(data);
+    commitToProject();
     ModelParameter::instance()->saveProject();
     QMessageBox::information(this, "保存", "数据已成功保存至项目文件(.pwt)。");
 }
 
 void DataEditorWidget::loadFromProjectData()
 {
-    QJsonArray data = ModelParameter::instance()->getTableData();
-    if (!data.isEmpty()) {
-        deserializeJsonToModel(data);
+    // 表格文件在后台读取，界面先显示加载状态，读取完成后由 onProjectTableDataReady 填入模型
+    m_dataModel->clear();
+    m_undoStack->clear();
+    m_columnDefinitions.clear();
+    ui->statusLabel->setText("正在加载项目数据...");
+    updateButtonsState();
+
+    m_waitingForProjectData = true;
+    ModelParameter::instance()->requestTableData();
+}
+
+void DataEditorWidget::onProjectTableDataReady()
+{
+    // 加载期间用户已导入其他文件或关闭项目时不再覆盖当前表格
+    if (!m_waitingForProjectData) return;
+    m_waitingForProjectData = false;
+
+    TextDataTable data = ModelParameter::instance()->getTableData();
+    if (data.rowCount > 0 || !data.headers.isEmpty()) {
+        m_dataModel->clear();
+        m_undoStack->clear();
+        m_columnDefinitions.clear();
+        populateModel(data);
         ui->statusLabel->setText("已恢复项目数据");
         updateButtonsState();
         emit dataChanged();
     } else {
         m_dataModel->clear();
+        m_undoStack->clear();
         m_columnDefinitions.clear();
         ui->statusLabel->setText("无数据");
         updateButtonsState();
     }
 }
 
-QJsonArray DataEditorWidget::serializeModelToJson() const
-{
-    QJsonArray array;
-    QJsonObject headerObj;
-    QJsonArray headers;
-    for(int i=0; i<m_dataModel->columnCount(); ++i) {
-        headers.append(m_dataModel->headerData(i, Qt::Horizontal).toString());
-    }
-    headerObj["headers"] = headers;
-    array.append(headerObj);
-
-    for(int i=0; i<m_dataModel->rowCount(); ++i) {
-        QJsonArray rowArr;
-        for(int j=0; j<m_dataModel->columnCount(); ++j) {
-            rowArr.append(m_dataModel->item(i, j)->text());
-        }
-        QJsonObject rowObj;
-        rowObj["row_data"] = rowArr;
-        array.append(rowObj);
-    }
-    return array;
-}
-
 void DataEditorWidget::deserializeJsonToModel(const QJsonArray& array)
 {
     m_dataModel->clear();
+    m_undoStack->clear();
     m_columnDefinitions.clear();
     if (array.isEmpty()) return;
 
-    QJsonObject headerObj = array.first().toObject();
-    if (headerObj.contains("headers")) {
-        QJsonArray headers = headerObj["headers"].toArray();
-        QStringList headerLabels;
-        for(const auto& h : headers) headerLabels << h.toString();
-        m_dataModel->setHorizontalHeaderLabels(headerLabels);
-
-        for(const QString& h : headerLabels) {
-            ColumnDefinition def;
-            def.name = h;
-            m_columnDefinitions.append(def);
-        }
-    }
-
-    for(int i=1; i<array.size(); ++i) {
-        QJsonObject rowObj = array[i].toObject();
-        if (rowObj.contains("row_data")) {
-            QJsonArray rowArr = rowObj["row_data"].toArray();
-            QList<QStandardItem*> items;
-            for(const auto& val : rowArr) {
-                items.append(new QStandardItem(val.toString()));
-            }
-            m_dataModel->appendRow(items);
-        }
-    }
+    // 旧版行数组格式 (首项 headers，其余 row_data) 先转为列式数据再整体交给模型
+    TextDataTable table = ProjectDataFile::fromJsonArray(array);
+    populateModel(table);
 }
 
 // ============================================================================
@@ -511,8 +518,12 @@ void DataEditorWidget::onTimeConvert()
         TimeConversionConfig config = dlg.getConversionConfig();
         TimeConversionResult res = calculator.convertTimeColumn(m_dataModel, m_columnDefinitions, config);
 
-        if (res.success) QMessageBox::information(this, "成功", "时间转换完成");
-        else QMessageBox::warning(this, "失败", res.errorMessage);
+        if (res.success) {
+            m_undoStack->push(new AppendedColumnCommand(m_dataModel, &m_columnDefinitions, res.addedColumnIndex, "时间转换"));
+            QMessageBox::information(this, "成功", "时间转换完成");
+        } else {
+            QMessageBox::warning(this, "失败", res.errorMessage);
+        }
     }
 }
 
@@ -521,8 +532,12 @@ void DataEditorWidget::onPressureDropCalc()
     DataCalculate calculator;
     PressureDropResult res = calculator.calculatePressureDrop(m_dataModel, m_columnDefinitions);
 
-    if (res.success) QMessageBox::information(this, "成功", "压降计算完成");
-    else QMessageBox::warning(this, "失败", res.errorMessage);
+    if (res.success) {
+        m_undoStack->push(new AppendedColumnCommand(m_dataModel, &m_columnDefinitions, res.addedColumnIndex, "压降计算"));
+        QMessageBox::information(this, "成功", "压降计算完成");
+    } else {
+        QMessageBox::warning(this, "失败", res.errorMessage);
+    }
 }
 
 // 井底流压计算功能入口
@@ -541,8 +556,8 @@ void DataEditorWidget::onCalcPwf()
         PwfCalculationResult res = calculator.calculateBottomHolePressure(m_dataModel, m_columnDefinitions, config);
 
         if (res.success) {
+            m_undoStack->push(new AppendedColumnCommand(m_dataModel, &m_columnDefinitions, res.addedColumnIndex, "井底流压计算"));
             QMessageBox::information(this, "成功", "井底流压计算完成，已添加新列。");
-            emit dataChanged();
         } else {
             QMessageBox::warning(this, "计算失败", res.errorMessage);
         }
@@ -558,6 +573,41 @@ void DataEditorWidget::onSearchTextChanged()
     m_searchTimer->start();
 }
 
+void DataEditorWidget::startSearch()
+{
+    const QString query = ui->searchLineEdit->text().trimmed();
+    if (query.isEmpty()) {
+        ui->searchLineEdit->setToolTip(QString());
+        m_proxyModel->clearRowFilter();
+        return;
+    }
+    if (m_searchWatcher.isRunning()) {
+        // 上一次搜索完成后再按最新文字搜索
+        m_searchTimer->start();
+        return;
+    }
+    // 没有索引时把表格快照交给后台建立索引，界面线程只做一次整列拷贝
+    TextDataTable snapshot;
+    if (!m_searchIndex) snapshot = m_dataModel->toTable();
+    m_searchRevision = m_dataRevision;
+    m_searchWatcher.setFuture(TableSearchIndex::start(m_searchIndex, std::move(snapshot), query));
+}
+
+void DataEditorWidget::onSearchFinished()
+{
+    TableSearchIndex::Result result = m_searchWatcher.result();
+    if (m_searchRevision != m_dataRevision) {
+        // 搜索期间数据已修改，结果与索引都作废
+        m_searchTimer->start();
+        return;
+    }
+    m_searchIndex = result.index;
+    // 搜索期间文字已改变时以新文字为准 (定时器会再次触发)
+    if (result.query != ui->searchLineEdit->text().trimmed()) return;
+    ui->searchLineEdit->setToolTip(result.errorMessage);
+    m_proxyModel->setRowFilter(result.rows);
+}
+
 void DataEditorWidget::onCustomContextMenu(const QPoint& pos)
 {
     QMenu menu(this);
@@ -565,6 +615,12 @@ void DataEditorWidget::onCustomContextMenu(const QPoint& pos)
                        "QMenu::item { padding: 5px 20px; }"
                        "QMenu::item:selected { background-color: #e0e0e0; color: black; }");
 
+    menu.addAction(m_undoAction);
+    menu.addAction(m_redoAction);
+    menu.addAction("粘贴", this, &DataEditorWidget::onPasteCells);
+
+    menu.addSeparator();
+
     menu.addAction("在下方插入行", [=](){ onAddRow(2); });
     menu.addAction("在上方插入行", [=](){ onAddRow(1); });
     menu.addAction("删除选中行", this, &DataEditorWidget::onDeleteRow);
@@ -594,41 +650,29 @@ void DataEditorWidget::onAddRow(int insertMode)
         }
     }
 
-    int colCount = m_dataModel->columnCount() > 0 ? m_dataModel->columnCount() : 1;
-    QList<QStandardItem*> items;
-    for(int i=0; i<colCount; ++i) items << new QStandardItem("");
-
-    m_dataModel->insertRow(row, items);
-    updateButtonsState();
+    // 空表时与原来一致，插入行的同时建立一列
+    if (m_dataModel->columnCount() == 0) m_dataModel->insertColumn(0);
+    m_undoStack->push(new InsertRowsCommand(m_dataModel, row, 1));
 }
 
 void DataEditorWidget::onDeleteRow()
 {
-    QModelIndexList idxs = ui->dataTableView->selectionModel()->selectedRows();
-    if (idxs.isEmpty()) {
-        QModelIndexList cellIdxs = ui->dataTableView->selectionModel()->selectedIndexes();
-        QSet<int> rowSet;
-        for(auto idx : cellIdxs) rowSet.insert(idx.row());
-        for(int r : rowSet) idxs.append(m_proxyModel->index(r, 0));
-    }
-
-    if (idxs.isEmpty()) return;
-
-    QList<int> sourceRows;
-    for(auto proxyIdx : idxs) {
-        sourceRows << m_proxyModel->mapToSource(proxyIdx).row();
+    // 按选择区域逐行取行号，不展开为逐个单元格的索引
+    QVector<int> sourceRows;
+    const QItemSelection selection = ui->dataTableView->selectionModel()->selection();
+    for (const QItemSelectionRange& range : selection) {
+        for (int r = range.top(); r <= range.bottom(); ++r) {
+            sourceRows << m_proxyModel->mapToSource(m_proxyModel->index(r, 0)).row();
+        }
     }
+    if (sourceRows.isEmpty()) return;
 
     std::sort(sourceRows.begin(), sourceRows.end());
     auto last = std::unique(sourceRows.begin(), sourceRows.end());
     sourceRows.erase(last, sourceRows.end());
 
-    std::sort(sourceRows.begin(), sourceRows.end(), std::greater<int>());
-
-    for(int r : sourceRows) {
-        m_dataModel->removeRow(r);
-    }
-    updateButtonsState();
+    // 整个行集合一次删除，可撤销
+    m_undoStack->push(new RemoveRowsCommand(m_dataModel, sourceRows));
 }
 
 void DataEditorWidget::onAddCol(int insertMode)
@@ -643,17 +687,9 @@ void DataEditorWidget::onAddCol(int insertMode)
         }
     }
 
-    m_dataModel->insertColumn(col);
-
     ColumnDefinition def;
     def.name = "新列";
-    if (col < m_columnDefinitions.size()) {
-        m_columnDefinitions.insert(col, def);
-    } else {
-        m_columnDefinitions.append(def);
-    }
-
-    m_dataModel->setHeaderData(col, Qt::Horizontal, "新列");
+    m_undoStack->push(new InsertColumnCommand(m_dataModel, &m_columnDefinitions, col, def));
 }
 
 void DataEditorWidget::onDeleteCol()
@@ -668,7 +704,7 @@ void DataEditorWidget::onDeleteCol()
 
     if (idxs.isEmpty()) return;
 
-    QList<int> sourceCols;
+    QVector<int> sourceCols;
     for(auto proxyIdx : idxs) {
         sourceCols << m_proxyModel->mapToSource(proxyIdx).column();
     }
@@ -677,28 +713,52 @@ void DataEditorWidget::onDeleteCol()
     auto last = std::unique(sourceCols.begin(), sourceCols.end());
     sourceCols.erase(last, sourceCols.end());
 
-    std::sort(sourceCols.begin(), sourceCols.end(), std::greater<int>());
+    m_undoStack->push(new RemoveColumnsCommand(m_dataModel, &m_columnDefinitions, sourceCols));
+}
 
-    for(int c : sourceCols) {
-        m_dataModel->removeColumn(c);
-        if(c < m_columnDefinitions.size()) {
-            m_columnDefinitions.removeAt(c);
-        }
+void DataEditorWidget::onPasteCells()
+{
+    QString text = QApplication::clipboard()->text();
+    if (text.isEmpty()) return;
+
+    // 制表符分列、换行分行 (与 Excel 复制的格式一致)，忽略末尾的空行
+    QStringList lines = text.split('\n');
+    if (!lines.isEmpty() && lines.last().isEmpty()) lines.removeLast();
+    QVector<QStringList> cells;
+    cells.reserve(lines.size());
+    for (QString& line : lines) {
+        if (line.endsWith('\r')) line.chop(1);
+        cells.append(line.split('\t'));
     }
-    updateButtonsState();
+    if (cells.isEmpty()) return;
+
+    int row = 0, col = 0;
+    QModelIndex currIdx = ui->dataTableView->currentIndex();
+    if (currIdx.isValid()) {
+        QModelIndex sourceIdx = m_proxyModel->mapToSource(currIdx);
+        row = sourceIdx.row();
+        col = sourceIdx.column();
+    }
+    m_undoStack->push(new SetCellsCommand(m_dataModel, row, col, cells, QString("粘贴 %1 行").arg(cells.size())));
 }
 
 void DataEditorWidget::onModelDataChanged()
 {
+    // 数据修改后搜索索引作废，下次搜索时重新建立
+    ++m_dataRevision;
+    m_searchIndex.reset();
 }
 
 
 // 清空所有数据
 void DataEditorWidget::clearAllData()
 {
+    m_waitingForProjectData = false;
+
     // 清空数据模型
     if (m_dataModel) {
         m_dataModel->clear();
+        m_undoStack->clear();
     }
     m_columnDefinitions.clear();
 
@@ -12,14 +12,17 @@
 #define DATAEDITORWIDGET_H
 
 #include <QWidget>
-#include <QStandardItemModel>
-#include <QSortFilterProxyModel>
+#include <QFutureWatcher>
 #include <QUndoStack>
 #include <QMenu>
 #include <QJsonArray>
 #include <QStyledItemDelegate>
 #include <QTimer>
 #include "dataimportdialog.h" // 引用导入配置对话框头文件
+#include "textdatareader.h"
+#include "measurementtablemodel.h"
+#include "rowfilterproxymodel.h"
+#include "tablesearchindex.h"
 
 // 定义列的枚举类型，表示每一列数据的物理含义
 // 新增了 CasingPressure (套压) 和 BottomHolePressure (流压)
@@ -52,11 +55,17 @@ class NoContextMenuDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
 public:
-    explicit NoContextMenuDelegate(QObject *parent = nullptr) : QStyledItemDelegate(parent) {}
+    explicit NoContextMenuDelegate(QUndoStack* undoStack, QObject *parent = nullptr)
+        : QStyledItemDelegate(parent), m_undoStack(undoStack) {}
 
     // 重写创建编辑器的方法
     QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
                           const QModelIndex &index) const override;
+    // 编辑结果作为可撤销命令写入源模型
+    void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+
+private:
+    QUndoStack* m_undoStack;
 };
 
 // ----------------------------------------------------------------------------
@@ -75,10 +84,14 @@ public:
     void clearAllData();
 
     // 从项目参数中加载保存的数据（用于打开项目时恢复状态）
+    // 表格文件在后台读取，完成后自动填入表格并发出 dataChanged
     void loadFromProjectData();
 
+    // 把当前表格提交给项目保存 (后台写入)；项目数据尚在加载时不提交并返回 false
+    bool commitToProject();
+
     // 获取当前的数据模型指针
-    QStandardItemModel* getDataModel() const;
+    MeasurementTableModel* getDataModel() const;
 
     // 加载指定路径的数据文件，支持自动识别类型
     void loadData(const QString& filePath, const QString& fileType = "auto");
@@ -114,6 +127,8 @@ private slots:
 
     // 搜索框文本变化时的槽函数（带防抖）
     void onSearchTextChanged();
+    // 后台搜索完成，按结果筛选表格行
+    void onSearchFinished();
 
     // 表格右键菜单请求槽函数
     void onCustomContextMenu(const QPoint& pos);
@@ -126,21 +141,33 @@ private slots:
     void onAddCol(int insertMode = 0);
     // 删除选中列
     void onDeleteCol();
+    // 从剪贴板粘贴单元格区域 (制表符分列、换行分行) 到当前单元格起的位置
+    void onPasteCells();
 
     // 模型数据变化时的通用处理槽
     void onModelDataChanged();
 
+    // 项目表格数据后台加载完成
+    void onProjectTableDataReady();
+
 private:
     Ui::DataEditorWidget *ui;
 
-    QStandardItemModel* m_dataModel;       // 标准数据模型，存储实际数据
-    QSortFilterProxyModel* m_proxyModel;   // 代理模型，用于排序和过滤
-    QUndoStack* m_undoStack;               // 撤销栈（预留）
+    MeasurementTableModel* m_dataModel;    // 列式数据模型，存储实际数据
+    RowFilterProxyModel* m_proxyModel;     // 代理模型，按搜索结果的行号筛选
+    QUndoStack* m_undoStack;               // 撤销栈，保存行列增删、粘贴、单元格编辑与计算追加列
+    QAction* m_undoAction;
+    QAction* m_redoAction;
 
     QList<ColumnDefinition> m_columnDefinitions; // 列属性定义列表
     QString m_currentFilePath;             // 当前文件路径
     QMenu* m_contextMenu;                  // 右键菜单
     QTimer* m_searchTimer;                 // 搜索防抖定时器
+    QSharedPointer<const TableSearchIndex> m_searchIndex; // 当前数据的搜索索引，数据修改后作废
+    QFutureWatcher<TableSearchIndex::Result> m_searchWatcher;
+    quint64 m_dataRevision;                // 表格数据修改计数
+    quint64 m_searchRevision;              // 正在进行的搜索所用数据的修改计数
+    bool m_waitingForProjectData;          // 是否正在等待项目表格数据加载完成
 
     // 初始化界面控件
     void initUI();
@@ -150,15 +177,17 @@ private:
     void setupModel();
     // 根据是否有数据更新按钮的启用状态
     void updateButtonsState();
+    // 按搜索框文字开始后台搜索 (无搜索索引时先建立)
+    void startSearch();
 
     // 内部文件加载流程
     bool loadFileInternal(const QString& path);
     // 根据配置项读取文件（支持文本和Excel）
     bool loadFileWithConfig(const DataImportSettings& settings);
+    // 将文本读取器得到的列式数据填入表格模型
+    void populateModel(TextDataTable& table);
 
-    // 将当前表格数据序列化为 JSON 数组
-    QJsonArray serializeModelToJson() const;
-    // 将 JSON 数组反序列化回表格模型
+    // 将旧版 JSON 行数组反序列化回表格模型
     void deserializeJsonToModel(const QJsonArray& array);
 };
 
@@ -3,12 +3,13 @@
  * 文件作用：数据导入配置对话框实现文件
  * 功能描述:
  * 1. 实现了基于 QTextCodec 的文本文件预览。
- * 2. 实现了基于 QAxObject 的 Excel 文件预览。
+ * 2. 实现了 Excel 文件预览：.xlsx 由 XlsxReader 只解析开头若干行，旧版 .xls 使用 QAxObject。
  * 3. 实现了 SpinBox 交互优化（防抖 + 样式修复）。
  */
 
 #include "dataimportdialog.h"
 #include "ui_dataimportdialog.h"
+#include "xlsxreader.h"
 #include <QFile>
 #include <QDebug>
 #include <QMessageBox>
@@ -113,6 +114,18 @@ void DataImportDialog::readExcelForPreview()
 {
     m_excelPreviewData.clear();
 
+    // XLSX：内置读取器只解压、解析工作表开头部分，不启动 Excel
+    if (XlsxReader::isXlsxFile(m_filePath)) {
+        QString error;
+        XlsxReader reader;
+        m_excelPreviewData = reader.readPreview(m_filePath, 50, 20, &error);
+        if (m_excelPreviewData.isEmpty() && !error.isEmpty()) {
+            QMessageBox::warning(this, "警告", "无法预览 Excel 文件：" + error);
+        }
+        return;
+    }
+
+    // 旧版二进制 .xls：通过 Excel COM 自动化读取
     QAxObject excel("Excel.Application");
     if (excel.isNull()) {
         QMessageBox::warning(this, "警告", "未检测到 Excel 程序，无法预览 Excel 文件。\n请安装 Microsoft Excel 或 WPS。");
@@ -206,9 +219,9 @@ void DataImportDialog::doUpdatePreview()
             else if (i >= startRow) dataRows.append(m_excelPreviewData[i]);
         }
 
-        int colCount = 0;
-        if (!headers.isEmpty()) colCount = headers.size();
-        else if (!dataRows.isEmpty()) colCount = dataRows.first().size();
+        // 工作表中的空行为空列表，列数取各行最大值
+        int colCount = headers.size();
+        for (const QStringList& row : dataRows) colCount = qMax(colCount, int(row.size()));
 
         ui->tablePreview->setColumnCount(colCount);
         if (!headers.isEmpty()) ui->tablePreview->setHorizontalHeaderLabels(headers);
@@ -3,7 +3,7 @@
  * 文件作用：数据导入配置对话框头文件
  * 功能描述:
  * 1. 定义数据导入弹窗类，用于预览文件并配置导入参数。
- * 2. 声明 Excel 预览读取功能（依赖 QAxObject）。
+ * 2. 声明 Excel 预览读取功能（.xlsx 内置解析，旧版 .xls 依赖 QAxObject）。
  * 3. 声明防止 UI 卡顿的定时器机制。
  */
 
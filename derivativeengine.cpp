@@ -0,0 +1,322 @@
+/*
+ * 文件名: derivativeengine.cpp
+ * 文件作用: 统一的试井压力导数计算引擎实现
+ * 功能描述:
+ * 1. 实现 Bourdet、相邻三点、Clark-van Golf-Racht、Savitzky-Golay 四种导数算法。
+ * 2. L-Spacing 窗口端点一次性求出：时间单调递增时双指针 O(n)，乱序时线段树 O(n log n)。
+ * 3. 各算法的主循环只做连续数组上的算术，便于编译器向量化。
+ */
+
+#include "derivativeengine.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// 乱序时间数据的窗口查询：ln(t) 的区间最小/最大值线段树
+// 无效点 (t<=0 或非数) 在最小值树中记为 +inf、最大值树中记为 -inf，永远不会被选中
+class LogTimeSegmentTree
+{
+public:
+    explicit LogTimeSegmentTree(const QVector<double>& lnT, const QVector<bool>& valid)
+        : m_n(lnT.size())
+    {
+        m_size = 1;
+        while (m_size < m_n) m_size <<= 1;
+        const double inf = std::numeric_limits<double>::infinity();
+        m_min.fill(inf, 2 * m_size);
+        m_max.fill(-inf, 2 * m_size);
+        for (int i = 0; i < m_n; ++i) {
+            if (!valid[i]) continue;
+            m_min[m_size + i] = lnT[i];
+            m_max[m_size + i] = lnT[i];
+        }
+        for (int node = m_size - 1; node >= 1; --node) {
+            m_min[node] = std::min(m_min[2 * node], m_min[2 * node + 1]);
+            m_max[node] = std::max(m_max[2 * node], m_max[2 * node + 1]);
+        }
+    }
+
+    // [0, i-1] 中满足 lnTi - ln(tj) >= L 的最大下标 j，不存在返回 -1
+    int lastLeft(int i, double lnTi, double lSpacing) const
+    {
+        return findLast(1, 0, m_size - 1, i - 1, lnTi, lSpacing);
+    }
+
+    // [i+1, n-1] 中满足 ln(tk) - lnTi >= L 的最小下标 k，不存在返回 -1
+    int firstRight(int i, double lnTi, double lSpacing) const
+    {
+        return findFirst(1, 0, m_size - 1, i + 1, lnTi, lSpacing);
+    }
+
+private:
+    int findLast(int node, int nl, int nr, int qr, double lnTi, double lSpacing) const
+    {
+        if (nl > qr || !((lnTi - m_min[node]) >= lSpacing)) return -1;
+        if (nl == nr) return nl;
+        int mid = (nl + nr) / 2;
+        int r = findLast(2 * node + 1, mid + 1, nr, qr, lnTi, lSpacing);
+        if (r >= 0) return r;
+        return findLast(2 * node, nl, mid, qr, lnTi, lSpacing);
+    }
+
+    int findFirst(int node, int nl, int nr, int ql, double lnTi, double lSpacing) const
+    {
+        if (nr < ql || nl >= m_n || !((m_max[node] - lnTi) >= lSpacing)) return -1;
+        if (nl == nr) return nl;
+        int mid = (nl + nr) / 2;
+        int r = findFirst(2 * node, nl, mid, ql, lnTi, lSpacing);
+        if (r >= 0) return r;
+        return findFirst(2 * node + 1, mid + 1, nr, ql, lnTi, lSpacing);
+    }
+
+    int m_n;
+    int m_size;
+    QVector<double> m_min;
+    QVector<double> m_max;
+};
+
+} // namespace
+
+QVector<double> DerivativeEngine::compute(const QVector<double>& t, const QVector<double>& p, const Options& options)
+{
+    int n = qMin(t.size(), p.size());
+    QVector<double> out(n, 0.0);
+    if (n == 0) return out;
+
+    // 输入长度不一致时按较短者截断，保证各算法内部下标安全
+    const QVector<double> tt = (t.size() == n) ? t : t.mid(0, n);
+    const QVector<double> pp = (p.size() == n) ? p : p.mid(0, n);
+
+    switch (options.algorithm) {
+    case ThreePoint:
+        computeThreePoint(tt, pp, out);
+        break;
+    case ClarkVanGolfRacht:
+        computeClarkVanGolfRacht(tt, pp, options.lSpacing, out);
+        break;
+    case SavitzkyGolay:
+        computeSavitzkyGolay(tt, pp, options.lSpacing, out);
+        break;
+    case Bourdet:
+    default:
+        computeBourdet(tt, pp, options.lSpacing, out);
+        break;
+    }
+
+    if (options.absoluteValue) {
+        double* d = out.data();
+        for (int i = 0; i < n; ++i) d[i] = std::abs(d[i]);
+    }
+    return out;
+}
+
+QVector<double> DerivativeEngine::bourdet(const QVector<double>& t, const QVector<double>& p, double lSpacing)
+{
+    Options options;
+    options.algorithm = Bourdet;
+    options.lSpacing = lSpacing;
+    return compute(t, p, options);
+}
+
+void DerivativeEngine::buildWindows(const QVector<double>& t, double lSpacing,
+                                    QVector<double>& lnT, QVector<int>& left, QVector<int>& right)
+{
+    int n = t.size();
+    lnT.resize(n);
+    left.fill(-1, n);
+    right.fill(-1, n);
+
+    // t<=0 的点不参与窗口选择 (与逐点扫描时跳过的行为一致)
+    QVector<bool> valid(n);
+    bool sorted = true;
+    for (int i = 0; i < n; ++i) {
+        double ti = t[i];
+        valid[i] = !(ti <= 0);
+        lnT[i] = valid[i] ? std::log(ti) : 0.0;
+        if (!(ti > 0) || (i > 0 && !(t[i] >= t[i - 1]))) sorted = false;
+    }
+
+    if (sorted) {
+        // 单调递增：两侧窗口端点随 i 单调右移
+        int l = -1;
+        int r = 0;
+        for (int i = 0; i < n; ++i) {
+            while (l + 1 < i && (lnT[i] - lnT[l + 1]) >= lSpacing) ++l;
+            if (l >= 0 && (lnT[i] - lnT[l]) >= lSpacing) left[i] = l;
+
+            if (r < i + 1) r = i + 1;
+            while (r < n && !((lnT[r] - lnT[i]) >= lSpacing)) ++r;
+            if (r < n) right[i] = r;
+        }
+        return;
+    }
+
+    LogTimeSegmentTree tree(lnT, valid);
+    for (int i = 0; i < n; ++i) {
+        if (!(t[i] > 0)) continue;
+        if (i > 0) left[i] = tree.lastLeft(i, lnT[i], lSpacing);
+        if (i < n - 1) right[i] = tree.firstRight(i, lnT[i], lSpacing);
+    }
+}
+
+// Bourdet 导数：左右两侧距离 >= L 的最近点斜率按对数距离加权
+void DerivativeEngine::computeBourdet(const QVector<double>& t, const QVector<double>& p, double lSpacing, QVector<double>& out)
+{
+    int n = t.size();
+    QVector<double> lnT;
+    QVector<int> leftIndex, rightIndex;
+    buildWindows(t, lSpacing, lnT, leftIndex, rightIndex);
+
+    for (int i = 0; i < n; ++i) {
+        out[i] = bourdetPoint(i, t, p, lnT, leftIndex, rightIndex);
+    }
+}
+
+double DerivativeEngine::bourdetPoint(int i, const QVector<double>& t, const QVector<double>& p, const QVector<double>& lnT,
+                                      const QVector<int>& left, const QVector<int>& right)
+{
+    const int n = t.size();
+    double derivative = 0.0;
+    double ti = t[i];
+    double pi = p[i];
+    int j = left[i];
+    int k = right[i];
+
+    // 1. 如果找到左右两个点，使用加权平均法 (Bourdet Standard)
+    if (j >= 0 && k >= 0) {
+        double deltaXL = lnT[i] - lnT[j];
+        double deltaXR = lnT[k] - lnT[i];
+
+        double mL = logSlope(ti, t[j], lnT[i], lnT[j], pi, p[j]);
+        double mR = logSlope(t[k], ti, lnT[k], lnT[i], p[k], pi);
+
+        if (deltaXL + deltaXR > 1e-12) {
+            derivative = (mL * deltaXR + mR * deltaXL) / (deltaXL + deltaXR);
+        }
+    }
+    // 2. 边界情况：只找到左侧点 (曲线末端)
+    else if (j >= 0) {
+        derivative = logSlope(ti, t[j], lnT[i], lnT[j], pi, p[j]);
+    }
+    // 3. 边界情况：只找到右侧点 (曲线开端)
+    else if (k >= 0) {
+        derivative = logSlope(t[k], ti, lnT[k], lnT[i], p[k], pi);
+    }
+    // 4. L-Spacing 范围内点不足，使用相邻点差分作为保底
+    else if (i > 0) {
+        derivative = logSlope(ti, t[i-1], lnT[i], lnT[i-1], pi, p[i-1]);
+    } else if (i < n - 1) {
+        derivative = logSlope(t[i+1], ti, lnT[i+1], lnT[i], p[i+1], pi);
+    }
+    return derivative;
+}
+
+// 相邻三点加权：中间点的左右斜率按对侧对数距离加权，首末点置 0
+void DerivativeEngine::computeThreePoint(const QVector<double>& t, const QVector<double>& p, QVector<double>& out)
+{
+    int n = t.size();
+    if (n < 3) return;
+
+    QVector<double> lnT(n);
+    for (int i = 0; i < n; ++i) lnT[i] = (t[i] > 0) ? std::log(t[i]) : 0.0;
+
+    const double* x = lnT.constData();
+    const double* y = p.constData();
+    double* d = out.data();
+    for (int i = 1; i < n - 1; ++i) {
+        double h1 = x[i] - x[i-1];
+        double h2 = x[i+1] - x[i];
+        if (std::abs(h1) < 1e-9 || std::abs(h2) < 1e-9) { d[i] = 0.0; continue; }
+        double d1 = (y[i] - y[i-1]) / h1;
+        double d2 = (y[i+1] - y[i]) / h2;
+        d[i] = (d1 * h2 + d2 * h1) / (h1 + h2);
+    }
+    d[0] = 0.0;
+    d[n-1] = 0.0;
+}
+
+// Clark-van Golf-Racht：取 ln(t)-L 与 ln(t)+L 之外最近的两点做一次中心差分，窗口不足时退到首末点
+void DerivativeEngine::computeClarkVanGolfRacht(const QVector<double>& t, const QVector<double>& p, double lSpacing, QVector<double>& out)
+{
+    int n = t.size();
+    QVector<double> lnT;
+    QVector<int> leftIndex, rightIndex;
+    buildWindows(t, lSpacing, lnT, leftIndex, rightIndex);
+
+    for (int i = 0; i < n; ++i) {
+        int j = leftIndex[i] >= 0 ? leftIndex[i] : 0;
+        int k = rightIndex[i] >= 0 ? rightIndex[i] : n - 1;
+        out[i] = logSlope(t[k], t[j], lnT[k], lnT[j], p[k], p[j]);
+    }
+}
+
+// Savitzky-Golay：|ln ti - ln tj| <= L 的窗口内以 ln(t)-ln(ti) 为自变量做二次最小二乘，一阶系数即导数
+// 窗口点数不足 3 个时扩展到相邻点；按 ln(t) 排序后用双指针维护窗口
+void DerivativeEngine::computeSavitzkyGolay(const QVector<double>& t, const QVector<double>& p, double lSpacing, QVector<double>& out)
+{
+    int n = t.size();
+
+    QVector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (t[i] > 0) order.append(i);
+    }
+    int m = order.size();
+    if (m < 2) return;
+
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return t[a] < t[b]; });
+    QVector<double> x(m), y(m);
+    for (int s = 0; s < m; ++s) {
+        x[s] = std::log(t[order[s]]);
+        y[s] = p[order[s]];
+    }
+
+    int lo = 0, hi = 0;
+    for (int s = 0; s < m; ++s) {
+        while (x[s] - x[lo] > lSpacing) ++lo;
+        if (hi < s) hi = s;
+        while (hi + 1 < m && x[hi + 1] - x[s] <= lSpacing) ++hi;
+
+        int a = lo, b = hi;
+        if (b - a < 2) {
+            a = qMax(0, qMin(a, s - 1));
+            b = qMin(m - 1, qMax(b, s + 1));
+            if (b - a < 2) { if (a > 0) --a; else if (b < m - 1) ++b; }
+        }
+
+        // 正规方程的矩 S0..S4 与 Σy·u^k
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, r0 = 0, r1 = 0, r2 = 0;
+        for (int q = a; q <= b; ++q) {
+            double u = x[q] - x[s];
+            double u2 = u * u;
+            s0 += 1.0; s1 += u; s2 += u2; s3 += u2 * u; s4 += u2 * u2;
+            r0 += y[q]; r1 += y[q] * u; r2 += y[q] * u2;
+        }
+
+        double derivative = 0.0;
+        double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+        double scale = s0 * s2 * s4;
+        if (b - a >= 2 && std::abs(det) > 1e-12 * (std::abs(scale) + 1e-300)) {
+            // Cramer 法则求一阶系数
+            double detB = s0 * (r1 * s4 - s3 * r2) - r0 * (s1 * s4 - s3 * s2) + s2 * (s1 * r2 - r1 * s2);
+            derivative = detB / det;
+        } else {
+            // 退化为直线拟合
+            double den = s0 * s2 - s1 * s1;
+            if (std::abs(den) > 1e-20) derivative = (s0 * r1 - s1 * r0) / den;
+        }
+        out[order[s]] = derivative;
+    }
+}
+
+double DerivativeEngine::logSlope(double t1, double t2, double lnT1, double lnT2, double p1, double p2)
+{
+    if (t1 <= 0 || t2 <= 0) return 0.0;
+    double deltaLnT = lnT1 - lnT2;
+
+    if (std::abs(deltaLnT) < 1e-10) return 0.0;
+    return (p1 - p2) / deltaLnT;
+}
@@ -0,0 +1,59 @@
+/*
+ * 文件名: derivativeengine.h
+ * 文件作用: 统一的试井压力导数计算引擎头文件
+ * 功能描述:
+ * 1. 提供可选择的导数算法：Bourdet 加权 L-Spacing、相邻三点加权、Clark-van Golf-Racht 中心差分、Savitzky-Golay 局部多项式。
+ * 2. 所有算法均对 ln(t) 求导，ln(t) 只计算一次，窗口端点一次性求出。
+ * 3. 数据处理、绘图、拟合、模型求解各处统一调用本模块，保证同一组数据得到相同的导数。
+ */
+
+#ifndef DERIVATIVEENGINE_H
+#define DERIVATIVEENGINE_H
+
+#include <QVector>
+
+class DerivativeEngine
+{
+public:
+    // 导数算法
+    enum Algorithm {
+        Bourdet = 0,        // 左右两侧距离 >= L 的最近点，按对数距离加权 (默认)
+        ThreePoint,         // 相邻三点加权 (首末点为 0)
+        ClarkVanGolfRacht,  // 取 ln(t)±L 处的点做一次中心差分
+        SavitzkyGolay       // |ln(t)-ln(ti)| <= L 窗口内最小二乘二次多项式的一阶系数
+    };
+
+    // 计算选项
+    struct Options {
+        Algorithm algorithm = Bourdet;
+        double lSpacing = 0.1;      // 对数窗口宽度 (ThreePoint 不使用)
+        bool absoluteValue = true;  // 是否取绝对值 (双对数图要求正值)
+    };
+
+    // 计算 dp/dln(t)，返回与输入等长的导数序列
+    static QVector<double> compute(const QVector<double>& t, const QVector<double>& p, const Options& options);
+
+    // 便捷接口：Bourdet 导数
+    static QVector<double> bourdet(const QVector<double>& t, const QVector<double>& p, double lSpacing);
+
+    // 每个点的 L-Spacing 左右窗口端点 (左: ln ti - ln tj >= L 的最近 j；右: ln tk - ln ti >= L 的最近 k；无对应点为 -1)
+    // 时间单调递增时双指针 O(n)，乱序或含非正值时线段树 O(n log n)；t<=0 的点不参与窗口选择
+    static void buildWindows(const QVector<double>& t, double lSpacing,
+                             QVector<double>& lnT, QVector<int>& left, QVector<int>& right);
+
+    // 由 buildWindows 的结果计算第 i 点的 Bourdet 导数 (未取绝对值)；只依赖 i、i±1 与左右窗口端点，
+    // 供局部数据修改后只重算受影响的点
+    static double bourdetPoint(int i, const QVector<double>& t, const QVector<double>& p, const QVector<double>& lnT,
+                               const QVector<int>& left, const QVector<int>& right);
+
+private:
+    static void computeBourdet(const QVector<double>& t, const QVector<double>& p, double lSpacing, QVector<double>& out);
+    static void computeThreePoint(const QVector<double>& t, const QVector<double>& p, QVector<double>& out);
+    static void computeClarkVanGolfRacht(const QVector<double>& t, const QVector<double>& p, double lSpacing, QVector<double>& out);
+    static void computeSavitzkyGolay(const QVector<double>& t, const QVector<double>& p, double lSpacing, QVector<double>& out);
+
+    // 对数时间斜率 (p1-p2)/(ln t1 - ln t2)，对数值已预先计算
+    static double logSlope(double t1, double t2, double lnT1, double lnT2, double p1, double p2);
+};
+
+#endif // DERIVATIVEENGINE_H
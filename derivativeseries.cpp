@@ -0,0 +1,127 @@
+/*
+ * 文件名: derivativeseries.cpp
+ * 文件作用: 由表格时间列、压力列生成的压差与 Bourdet 导数序列实现
+ * 功能描述:
+ * 1. 重建时一次求出 ln(t) 与 L-Spacing 窗口端点，导数逐点由 DerivativeEngine::bourdetPoint 计算。
+ * 2. 就地更新时第 i 点的导数只依赖 i、i±1 与左右窗口端点：这些点的压差都未改变时保留原值，
+ *    判断只是整数比较，只有受影响的点才重新计算斜率。
+ */
+
+#include "derivativeseries.h"
+#include "derivativeengine.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+bool samePressure(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+} // namespace
+
+double DerivativeSeries::deltaPressure(double p) const
+{
+    return m_settings.drawdown ? std::abs(m_settings.initialPressure - p) : std::abs(p - m_referencePressure);
+}
+
+bool DerivativeSeries::isValid(int row, double p) const
+{
+    if (row < 0 || row >= m_timeValid.size() || !m_timeValid[row] || std::isnan(p)) return false;
+    return !m_settings.requirePositiveDeltaP || deltaPressure(p) > 0;
+}
+
+int DerivativeSeries::indexOfRow(int row) const
+{
+    auto it = std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), row);
+    return (it != m_rows.constEnd() && *it == row) ? int(it - m_rows.constBegin()) : -1;
+}
+
+void DerivativeSeries::rebuild(const QVector<double>& time, const QVector<double>& pressure)
+{
+    const int n = qMin(time.size(), pressure.size());
+    const int firstRow = qMax(0, m_settings.firstRow);
+
+    m_timeValid.fill(false, n);
+    for (int r = firstRow; r < n; ++r) m_timeValid[r] = time[r] > 0;
+
+    // 参考压力：指定行，或第一个时间为正、压力非空的行
+    m_referenceRow = -1;
+    m_referencePressure = std::numeric_limits<double>::quiet_NaN();
+    if (!m_settings.drawdown) {
+        if (m_settings.referenceRow >= 0) {
+            m_referenceRow = m_settings.referenceRow;
+            m_referencePressure = pressure.value(m_referenceRow, std::numeric_limits<double>::quiet_NaN());
+        } else {
+            for (int r = firstRow; r < n; ++r) {
+                if (m_timeValid[r] && !std::isnan(pressure[r])) {
+                    m_referenceRow = r;
+                    m_referencePressure = pressure[r];
+                    break;
+                }
+            }
+        }
+    }
+
+    m_time.clear();
+    m_deltaP.clear();
+    m_rows.clear();
+    for (int r = firstRow; r < n; ++r) {
+        if (!isValid(r, pressure[r])) continue;
+        m_time.append(time[r]);
+        m_deltaP.append(deltaPressure(pressure[r]));
+        m_rows.append(r);
+    }
+
+    // 与 DerivativeEngine::bourdet 相同的计算，保留窗口供就地更新
+    DerivativeEngine::buildWindows(m_time, m_settings.lSpacing, m_lnT, m_left, m_right);
+    m_derivative.resize(m_time.size());
+    for (int i = 0; i < m_time.size(); ++i) {
+        m_derivative[i] = std::abs(DerivativeEngine::bourdetPoint(i, m_time, m_deltaP, m_lnT, m_left, m_right));
+    }
+    m_built = true;
+}
+
+bool DerivativeSeries::canUpdatePressure(const QVector<QPair<int, double>>& cells) const
+{
+    if (!m_built) return false;
+    for (const QPair<int, double>& cell : cells) {
+        const int row = cell.first;
+        // 参考压力改变时所有点的压差都会改变
+        if (!m_settings.drawdown && row == m_referenceRow && !samePressure(cell.second, m_referencePressure)) return false;
+        if (row < qMax(0, m_settings.firstRow)) continue;
+        if (row >= m_timeValid.size()) return false;
+        // 有效行集合改变时点的下标与窗口都会改变
+        if ((indexOfRow(row) >= 0) != isValid(row, cell.second)) return false;
+    }
+    return true;
+}
+
+int DerivativeSeries::updatePressure(const QVector<QPair<int, double>>& cells)
+{
+    const int m = m_time.size();
+    std::vector<char> changed(static_cast<size_t>(m), 0);
+    bool any = false;
+    for (const QPair<int, double>& cell : cells) {
+        const int index = indexOfRow(cell.first);
+        if (index < 0) continue;
+        const double dp = deltaPressure(cell.second);
+        if (dp == m_deltaP[index]) continue;
+        m_deltaP[index] = dp;
+        changed[size_t(index)] = 1;
+        any = true;
+    }
+    if (!any) return 0;
+
+    auto touched = [&](int j) { return j >= 0 && j < m && changed[size_t(j)]; };
+    int recomputed = 0;
+    for (int i = 0; i < m; ++i) {
+        if (!touched(i) && !touched(i - 1) && !touched(i + 1) && !touched(m_left[i]) && !touched(m_right[i])) continue;
+        m_derivative[i] = std::abs(DerivativeEngine::bourdetPoint(i, m_time, m_deltaP, m_lnT, m_left, m_right));
+        ++recomputed;
+    }
+    return recomputed;
+}
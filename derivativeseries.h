@@ -0,0 +1,74 @@
+/*
+ * 文件名: derivativeseries.h
+ * 文件作用: 由表格时间列、压力列生成的压差与 Bourdet 导数序列头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 按选项筛选有效行 (时间为正、压力非空，可要求压差为正)，计算压差与导数，并记录每个点对应的源行号。
+ * 2. 绘图页面的导数曲线与拟合页面的观测数据共用本类，两处对同一组数据得到相同的结果。
+ * 3. 只有压力单元格被修改、且有效行集合与参考压力不变时，可以就地更新：只重算这些点的压差，
+ *    导数只重算 L-Spacing 窗口中包含被修改点的那些点 (窗口端点与 ln(t) 保留不变)。
+ * 4. 其他修改 (时间列改变、行插入删除、参考压力改变等) 需要由整列数据重建。
+ */
+
+#ifndef DERIVATIVESERIES_H
+#define DERIVATIVESERIES_H
+
+#include <QPair>
+#include <QVector>
+
+class DerivativeSeries
+{
+public:
+    struct Settings {
+        int timeColumn = 0;
+        int pressureColumn = 1;
+        int firstRow = 0;                     // 之前的行 (表头说明等) 不参与
+        bool drawdown = true;                 // true: 压差为 |Pi - p|；false: |p - 参考压力|
+        double initialPressure = 0.0;         // 降落试井的地层初始压力 Pi
+        int referenceRow = -1;                // 恢复试井参考压力所在行；-1 为第一个有效行
+        bool requirePositiveDeltaP = false;   // 压差不为正的行不参与
+        double lSpacing = 0.15;
+    };
+
+    DerivativeSeries() = default;
+    explicit DerivativeSeries(const Settings& settings) : m_settings(settings) {}
+
+    const Settings& settings() const { return m_settings; }
+    // 是否已由列数据生成过 (未生成时只能重建)
+    bool isBuilt() const { return m_built; }
+
+    // 由整列数据重建
+    void rebuild(const QVector<double>& time, const QVector<double>& pressure);
+
+    // 压力列单元格 (源行号, 新值) 的修改能否就地更新 (时间列未改变时)
+    bool canUpdatePressure(const QVector<QPair<int, double>>& cells) const;
+    // 就地更新，调用前须 canUpdatePressure 为 true；返回重新计算了导数的点数
+    int updatePressure(const QVector<QPair<int, double>>& cells);
+
+    const QVector<double>& time() const { return m_time; }
+    const QVector<double>& deltaP() const { return m_deltaP; }
+    const QVector<double>& derivative() const { return m_derivative; }   // 已取绝对值
+    const QVector<int>& sourceRows() const { return m_rows; }           // 各点的源行号 (升序)
+
+private:
+    double deltaPressure(double p) const;
+    bool isValid(int row, double p) const;
+    int indexOfRow(int row) const;
+
+    Settings m_settings;
+    bool m_built = false;
+
+    QVector<double> m_time;
+    QVector<double> m_deltaP;
+    QVector<double> m_derivative;
+    QVector<int> m_rows;
+
+    // 就地更新所需：L-Spacing 窗口与源表各行的时间是否为正
+    QVector<double> m_lnT;
+    QVector<int> m_left;
+    QVector<int> m_right;
+    QVector<bool> m_timeValid;
+    int m_referenceRow = -1;
+    double m_referencePressure = 0.0;
+};
+
+#endif // DERIVATIVESERIES_H
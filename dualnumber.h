@@ -0,0 +1,111 @@
+/*
+ * 文件名: dualnumber.h
+ * 文件作用: 前向模式自动微分用的对偶数模板
+ * 功能描述:
+ * 1. Dual<N> 同时携带函数值和对 N 个自变量的偏导数，四则运算和初等函数按链式法则传播导数。
+ * 2. 求解器的 Laplace 空间模型以标量类型为模板参数：double 只求值，Dual<N> 一次求出值和全部参数灵敏度。
+ * 3. 导数存放在定长数组中，不分配堆内存；分支判断只使用函数值 (valueOf)。
+ * 4. 标量类型可为 std::complex<double>，供复平面反演 (Talbot、de Hoog、Euler) 对参数求导。
+ */
+
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include <cmath>
+#include <complex>
+
+// S 为函数值与导数的标量类型：double 用于实轴求值，std::complex<double> 用于复平面反演的灵敏度
+template <int N, typename S = double>
+struct Dual {
+    typedef S Scalar;
+
+    S v;       // 函数值
+    S d[N];    // 对各自变量的偏导数
+
+    Dual() : v(0.0) { for (int i = 0; i < N; ++i) d[i] = 0.0; }
+    Dual(const S& value) : v(value) { for (int i = 0; i < N; ++i) d[i] = 0.0; }
+
+    // 第 k 个自变量：导数为 seed (通常为 1)
+    static Dual variable(const S& value, int k, const S& seed = S(1.0))
+    {
+        Dual r(value);
+        if (k >= 0 && k < N) r.d[k] = seed;
+        return r;
+    }
+
+    // 链式法则：f(x) 的值为 fx、导数为 dfdx
+    static Dual chain(const Dual& x, const S& fx, const S& dfdx)
+    {
+        Dual r(fx);
+        for (int i = 0; i < N; ++i) r.d[i] = dfdx * x.d[i];
+        return r;
+    }
+
+    S value() const { return v; }
+
+    Dual& operator+=(const Dual& o) { v += o.v; for (int i = 0; i < N; ++i) d[i] += o.d[i]; return *this; }
+    Dual& operator-=(const Dual& o) { v -= o.v; for (int i = 0; i < N; ++i) d[i] -= o.d[i]; return *this; }
+    Dual& operator*=(const Dual& o)
+    {
+        for (int i = 0; i < N; ++i) d[i] = d[i] * o.v + v * o.d[i];
+        v *= o.v;
+        return *this;
+    }
+    Dual& operator/=(const Dual& o)
+    {
+        S inv = S(1.0) / o.v;
+        S q = v * inv;
+        for (int i = 0; i < N; ++i) d[i] = (d[i] - q * o.d[i]) * inv;
+        v = q;
+        return *this;
+    }
+    Dual& operator+=(const S& s) { v += s; return *this; }
+    Dual& operator-=(const S& s) { v -= s; return *this; }
+    Dual& operator*=(const S& s) { v *= s; for (int i = 0; i < N; ++i) d[i] *= s; return *this; }
+    Dual& operator/=(const S& s) { return *this *= (S(1.0) / s); }
+};
+
+// 与标量的运算：标量参数不参与模板推导，复数对偶数也可直接与 double 常数运算
+template <int N, typename S> inline Dual<N, S> operator-(const Dual<N, S>& a) { Dual<N, S> r(a); r *= S(-1.0); return r; }
+
+template <int N, typename S> inline Dual<N, S> operator+(Dual<N, S> a, const Dual<N, S>& b) { return a += b; }
+template <int N, typename S> inline Dual<N, S> operator-(Dual<N, S> a, const Dual<N, S>& b) { return a -= b; }
+template <int N, typename S> inline Dual<N, S> operator*(Dual<N, S> a, const Dual<N, S>& b) { return a *= b; }
+template <int N, typename S> inline Dual<N, S> operator/(Dual<N, S> a, const Dual<N, S>& b) { return a /= b; }
+
+template <int N, typename S> inline Dual<N, S> operator+(Dual<N, S> a, const typename Dual<N, S>::Scalar& s) { return a += s; }
+template <int N, typename S> inline Dual<N, S> operator-(Dual<N, S> a, const typename Dual<N, S>::Scalar& s) { return a -= s; }
+template <int N, typename S> inline Dual<N, S> operator*(Dual<N, S> a, const typename Dual<N, S>::Scalar& s) { return a *= s; }
+template <int N, typename S> inline Dual<N, S> operator/(Dual<N, S> a, const typename Dual<N, S>::Scalar& s) { return a /= s; }
+
+template <int N, typename S> inline Dual<N, S> operator+(const typename Dual<N, S>::Scalar& s, Dual<N, S> a) { return a += s; }
+template <int N, typename S> inline Dual<N, S> operator-(const typename Dual<N, S>::Scalar& s, const Dual<N, S>& a) { Dual<N, S> r = -a; return r += s; }
+template <int N, typename S> inline Dual<N, S> operator*(const typename Dual<N, S>::Scalar& s, Dual<N, S> a) { return a *= s; }
+template <int N, typename S> inline Dual<N, S> operator/(const typename Dual<N, S>::Scalar& s, const Dual<N, S>& a) { return Dual<N, S>(s) /= a; }
+
+// 初等函数 (通过实参依赖查找与 std:: 版本同名调用)
+template <int N, typename S> inline Dual<N, S> sqrt(const Dual<N, S>& x)
+{
+    S s = std::sqrt(x.v);
+    return Dual<N, S>::chain(x, s, S(0.5) / s);
+}
+template <int N, typename S> inline Dual<N, S> exp(const Dual<N, S>& x)
+{
+    S e = std::exp(x.v);
+    return Dual<N, S>::chain(x, e, e);
+}
+template <int N, typename S> inline Dual<N, S> log(const Dual<N, S>& x)
+{
+    return Dual<N, S>::chain(x, std::log(x.v), S(1.0) / x.v);
+}
+template <int N> inline Dual<N> abs(const Dual<N>& x)
+{
+    return x.v < 0 ? -x : x;
+}
+
+// 取函数值：泛型代码中的分支判断统一使用 (复数取实部)
+inline double valueOf(double x) { return x; }
+template <int N> inline double valueOf(const Dual<N>& x) { return x.v; }
+template <int N> inline double valueOf(const Dual<N, std::complex<double>>& x) { return x.v.real(); }
+
+#endif // DUALNUMBER_H
@@ -0,0 +1,262 @@
+/*
+ * 文件名: fitperformancelog.cpp
+ * 文件作用: 拟合性能日志实现
+ * 功能描述:
+ * 1. 每条记录一行紧凑 JSON，以追加方式写入；读取时只保留最近的记录。
+ * 2. 偏慢判断以每次正演每点的耗时为准，消除迭代次数与数据量差异的影响。
+ */
+
+#include "fitperformancelog.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+// 同一进程内的写入串行化 (拟合页、实时数据与批量任务可能同时完成)
+QMutex& logMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+double median(QVector<double> values)
+{
+    if (values.isEmpty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    const int n = values.size();
+    return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+} // namespace
+
+double FitPerformanceLog::Record::usPerSolvePoint() const
+{
+    if (forwardSolves <= 0 || fitPoints <= 0 || wallMs <= 0) return -1.0;
+    return wallMs * 1000.0 / (double(forwardSolves) * fitPoints);
+}
+
+QJsonObject FitPerformanceLog::Record::toJson() const
+{
+    QJsonObject obj;
+    obj["timestamp"] = timestamp;
+    obj["analysis"] = analysis;
+    obj["source"] = source;
+    obj["modelType"] = modelType;
+    obj["nf"] = nf;
+    obj["fitPoints"] = fitPoints;
+    obj["observedPoints"] = observedPoints;
+    obj["pointsPerCycle"] = pointsPerCycle;
+    obj["stehfest"] = stehfest;
+    obj["inversion"] = inversion;
+    obj["algorithm"] = algorithm;
+    obj["iterations"] = iterations;
+    obj["jacobianEvaluations"] = jacobianEvaluations;
+    obj["forwardSolves"] = forwardSolves;
+    obj["wallMs"] = (double)wallMs;
+    obj["sse"] = sse;
+    obj["mse"] = mse;
+    obj["hardwareThreads"] = hardwareThreads;
+    obj["warmStarted"] = warmStarted;
+    return obj;
+}
+
+FitPerformanceLog::Record FitPerformanceLog::Record::fromJson(const QJsonObject& obj)
+{
+    Record r;
+    r.timestamp = obj["timestamp"].toString();
+    r.analysis = obj["analysis"].toString();
+    r.source = obj["source"].toString();
+    r.modelType = obj["modelType"].toInt();
+    r.nf = obj["nf"].toInt();
+    r.fitPoints = obj["fitPoints"].toInt();
+    r.observedPoints = obj["observedPoints"].toInt();
+    r.pointsPerCycle = obj["pointsPerCycle"].toInt();
+    r.stehfest = obj["stehfest"].toString();
+    r.inversion = obj["inversion"].toString();
+    r.algorithm = obj["algorithm"].toString();
+    r.iterations = obj["iterations"].toInt();
+    r.jacobianEvaluations = obj["jacobianEvaluations"].toInt();
+    r.forwardSolves = obj["forwardSolves"].toInt();
+    r.wallMs = (qint64)obj["wallMs"].toDouble();
+    r.sse = obj["sse"].toDouble();
+    r.mse = obj["mse"].toDouble();
+    r.hardwareThreads = obj["hardwareThreads"].toInt();
+    r.warmStarted = obj["warmStarted"].toBool();
+    return r;
+}
+
+FitPerformanceLog::Record FitPerformanceLog::makeRecord(const FittingCore::Result& result, const FittingCore::Options& options,
+                                                        ModelSolver01_06::ModelType modelType, int fitPoints, int observedPoints)
+{
+    Record r;
+    r.timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+    r.modelType = modelType;
+    r.nf = qRound(result.params.value("nf", 0.0));
+    r.fitPoints = fitPoints;
+    r.observedPoints = observedPoints;
+
+    // 阶数：分级拟合记录各级，单级时与 FittingCore 的取法一致 (非高精度固定 4 阶)
+    if (!options.stehfestSchedule.isEmpty()) {
+        QStringList levels;
+        for (int n : options.stehfestSchedule) levels << QString::number(n);
+        r.stehfest = levels.join(",");
+    } else {
+        r.stehfest = options.highPrecision ? QString::number(qRound(result.params.value("N", 8.0))) : QString("4");
+    }
+    r.inversion = ModelSolver01_06::inversionName(ModelSolver01_06::defaultInversion(modelType));
+    r.algorithm = LeastSquaresOptimizer::algorithmName(options.algorithm);
+
+    r.iterations = result.iterations;
+    r.jacobianEvaluations = result.jacobianEvaluations;
+    r.forwardSolves = result.forwardSolves;
+    r.wallMs = result.elapsedMs;
+    r.sse = result.sse;
+    r.mse = result.mse;
+    r.hardwareThreads = QThread::idealThreadCount();
+    r.warmStarted = result.warmStarted;
+    return r;
+}
+
+void FitPerformanceLog::accumulate(Record& record, const FittingCore::Result& result)
+{
+    record.iterations += result.iterations;
+    record.jacobianEvaluations += result.jacobianEvaluations;
+    record.forwardSolves += result.forwardSolves;
+    record.wallMs += result.elapsedMs;
+    record.sse = result.sse;
+    record.mse = result.mse;
+}
+
+QString FitPerformanceLog::logPath(const QString& projectFilePath)
+{
+    if (projectFilePath.isEmpty()) return QString();
+    QFileInfo info(projectFilePath);
+    return info.dir().filePath(info.completeBaseName() + "_perf.jsonl");
+}
+
+bool FitPerformanceLog::append(const QString& path, const Record& record, QString* errorMessage)
+{
+    if (path.isEmpty()) {
+        if (errorMessage) *errorMessage = "项目尚未保存";
+        return false;
+    }
+    QByteArray line = QJsonDocument(record.toJson()).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    QMutexLocker locker(&logMutex());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    if (file.write(line) != line.size()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QVector<FitPerformanceLog::Record> FitPerformanceLog::load(const QString& path, int maxRecords)
+{
+    QVector<Record> records;
+    if (path.isEmpty()) return records;
+
+    QMutexLocker locker(&logMutex());
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return records;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) continue;
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) continue;
+        records.append(Record::fromJson(doc.object()));
+    }
+    if (maxRecords > 0 && records.size() > maxRecords) records.remove(0, records.size() - maxRecords);
+    return records;
+}
+
+bool FitPerformanceLog::clear(const QString& path)
+{
+    QMutexLocker locker(&logMutex());
+    return path.isEmpty() || !QFile::exists(path) || QFile::remove(path);
+}
+
+QVector<bool> FitPerformanceLog::flagSlow(const QVector<Record>& records, double factor, int minGroup)
+{
+    QMap<QPair<int, int>, QVector<double>> groups;
+    for (const Record& r : records) {
+        double cost = r.usPerSolvePoint();
+        if (cost > 0) groups[qMakePair(r.modelType, r.nf)].append(cost);
+    }
+    QMap<QPair<int, int>, double> medians;
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        if (it.value().size() >= minGroup) medians.insert(it.key(), median(it.value()));
+    }
+
+    QVector<bool> slow(records.size(), false);
+    for (int i = 0; i < records.size(); ++i) {
+        auto it = medians.constFind(qMakePair(records[i].modelType, records[i].nf));
+        double cost = records[i].usPerSolvePoint();
+        slow[i] = it != medians.constEnd() && cost > 0 && cost > factor * it.value();
+    }
+    return slow;
+}
+
+QString FitPerformanceLog::groupKey(const Record& record, GroupBy groupBy)
+{
+    switch (groupBy) {
+    case ByModel:
+        return QString("%1 (nf=%2)").arg(ModelSolver01_06::getModelName((ModelSolver01_06::ModelType)record.modelType)).arg(record.nf);
+    case ByStehfest:
+        return QString("N = %1").arg(record.stehfest);
+    case ByInversion:
+        return record.inversion;
+    case ByDecimation:
+        return record.pointsPerCycle > 0 ? QString("%1 点/周期").arg(record.pointsPerCycle) : QString("未重采样");
+    case ByAlgorithm:
+        return record.algorithm;
+    }
+    return QString();
+}
+
+QVector<FitPerformanceLog::Summary> FitPerformanceLog::summarize(const QVector<Record>& records, GroupBy groupBy)
+{
+    const QVector<bool> slow = flagSlow(records);
+    QMap<QString, QVector<int>> groups;
+    for (int i = 0; i < records.size(); ++i) groups[groupKey(records[i], groupBy)].append(i);
+
+    QVector<Summary> summaries;
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        Summary s;
+        s.key = it.key();
+        s.count = it.value().size();
+        QVector<double> wall, iterations, solves, cost, mse;
+        for (int i : it.value()) {
+            const Record& r = records[i];
+            if (slow[i]) ++s.slowCount;
+            wall.append(r.wallMs);
+            iterations.append(r.iterations);
+            solves.append(r.forwardSolves);
+            mse.append(r.mse);
+            double c = r.usPerSolvePoint();
+            if (c > 0) cost.append(c);
+        }
+        s.medianWallMs = median(wall);
+        s.medianIterations = median(iterations);
+        s.medianForwardSolves = median(solves);
+        s.medianUsPerSolvePoint = cost.isEmpty() ? -1.0 : median(cost);
+        s.medianMse = median(mse);
+        summaries.append(s);
+    }
+    return summaries;
+}
@@ -0,0 +1,100 @@
+/*
+ * 文件名: fitperformancelog.h
+ * 文件作用: 拟合性能日志头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 每次完成的拟合追加一条记录：模型、裂缝条数、点数、迭代次数、墙钟时间、正演次数、最终 SSE 与硬件线程数。
+ * 2. 记录按项目保存为 JSON Lines 文件 (与 .pwt 同目录的 <项目名>_perf.jsonl)，追加写入，单条损坏不影响其余记录。
+ * 3. 按模型、Stehfest 阶数、反演方法、抽稀密度或算法分组汇总中位数，用于比较不同配置的耗时。
+ * 4. 与同模型同裂缝条数记录的中位数相比，单位计算量耗时明显偏高的记录标记为偏慢。
+ */
+
+#ifndef FITPERFORMANCELOG_H
+#define FITPERFORMANCELOG_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include "fittingcore.h"
+
+class FitPerformanceLog
+{
+public:
+    // 一次拟合的性能记录
+    struct Record {
+        QString timestamp;          // 完成时刻 (ISO 8601)
+        QString analysis;           // 分析页名称
+        QString source;             // "fit" 手动拟合、"rolling" 实时数据滚动拟合、"batch" 批量拟合
+        int modelType = 0;
+        int nf = 0;                 // 裂缝条数
+        int fitPoints = 0;          // 迭代所用数据点数 (重采样后)
+        int observedPoints = 0;     // 观测数据点数
+        int pointsPerCycle = 0;     // 重采样密度 (每个对数周期点数)，0 表示未重采样
+        QString stehfest;           // Stehfest 阶数或分级 (例如 "4,8,12")
+        QString inversion;          // 反演方法
+        QString algorithm;          // 优化算法
+        int iterations = 0;
+        int jacobianEvaluations = 0;
+        int forwardSolves = 0;      // 正演次数 (曲线与灵敏度)
+        qint64 wallMs = 0;
+        double sse = 0.0;
+        double mse = 0.0;
+        int hardwareThreads = 0;
+        bool warmStarted = false;
+
+        // 单位计算量耗时：每次正演、每个数据点的微秒数，无法计算时返回 -1
+        double usPerSolvePoint() const;
+
+        QJsonObject toJson() const;
+        static Record fromJson(const QJsonObject& obj);
+    };
+
+    // 分组方式
+    enum GroupBy {
+        ByModel = 0,
+        ByStehfest,
+        ByInversion,
+        ByDecimation,
+        ByAlgorithm
+    };
+
+    // 一组记录的汇总 (中位数)
+    struct Summary {
+        QString key;
+        int count = 0;
+        int slowCount = 0;
+        double medianWallMs = 0.0;
+        double medianIterations = 0.0;
+        double medianForwardSolves = 0.0;
+        double medianUsPerSolvePoint = -1.0;
+        double medianMse = 0.0;
+    };
+
+    /**
+     * @brief 由拟合结果填写记录的公共部分 (时刻、模型、阶数、反演方法、算法、计数、耗时与硬件线程数)
+     * 分析页名称、来源与重采样密度由调用方填写。
+     */
+    static Record makeRecord(const FittingCore::Result& result, const FittingCore::Options& options,
+                             ModelSolver01_06::ModelType modelType, int fitPoints, int observedPoints);
+    // 在 record 上累加一次后续拟合 (例如全数据精修) 的迭代、正演与耗时，最终误差取后者
+    static void accumulate(Record& record, const FittingCore::Result& result);
+
+    // 项目文件对应的日志路径；项目未保存 (路径为空) 时返回空字符串
+    static QString logPath(const QString& projectFilePath);
+
+    // 追加一条记录，可在任意线程调用 (同一进程内串行写入)；失败时返回 false 并写入 errorMessage
+    static bool append(const QString& path, const Record& record, QString* errorMessage = nullptr);
+    // 读取最近 maxRecords 条记录 (按写入顺序)，无法解析的行跳过
+    static QVector<Record> load(const QString& path, int maxRecords = MAX_LOADED_RECORDS);
+    // 删除日志文件
+    static bool clear(const QString& path);
+
+    // 偏慢标记：与同模型、同裂缝条数的记录 (至少 minGroup 条) 相比，usPerSolvePoint 超过中位数 factor 倍
+    static QVector<bool> flagSlow(const QVector<Record>& records, double factor = 3.0, int minGroup = 3);
+    // 按 groupBy 分组汇总，组按键排序
+    static QVector<Summary> summarize(const QVector<Record>& records, GroupBy groupBy);
+    static QString groupKey(const Record& record, GroupBy groupBy);
+
+    static const int MAX_LOADED_RECORDS = 5000;
+};
+
+#endif // FITPERFORMANCELOG_H
@@ -0,0 +1,811 @@
+/*
+ * 文件名: fittingcore.cpp
+ * 文件作用: 试井拟合核心算法实现文件 (不依赖界面)
+ * 功能描述:
+ * 1. 把拟合参数换算为优化变量 (对数/线性)，提供对数残差与雅可比，迭代交给 LeastSquaresOptimizer。
+ *    雅可比由求解器的前向自动微分一次正演给出；裂缝条数、Stehfest 阶数等整数参数的列为 0。
+ * 2. 迭代期间使用低精度 Stehfest 阶数 (或按分级精度逐级提高阶数与数据密度)，结束后以高精度计算最终曲线。
+ * 3. 由 FittingWidget 在后台线程调用，也可脱离界面单独使用。
+ * 4. 设置产量历史后，残差与雅可比均基于叠加后的变产量曲线 (单位产量响应每次求值只解一次)。
+ * 5. 接受步的迭代回调沿用该点残差求值时得到的理论曲线，每个迭代少一次完整正演。
+ * 6. 残差为 w*(ln 观测 - ln 理论)，雅可比行只依赖理论曲线在该时间的对数灵敏度，续算时按 ln(t) 线性插值到新的观测时间。
+ * 7. 时间窗口下残差按行号表取观测点与求值点，求值时间缩减为参与拟合的点 (理论导数逐点解析给出，与相邻点无关)；
+ *    有产量历史时叠加需要全部时间，不缩减。
+ * 8. 残差与雅可比计入 HotPathProfiler 的计时与计数，每个接受步记一次迭代 (WELLTEST_PROFILING 下)。
+ */
+
+#include "fittingcore.h"
+#include "logtimeresampler.h"
+#include "hotpathprofiler.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+QJsonArray doublesToJson(const QVector<double>& values)
+{
+    QJsonArray arr;
+    for (double v : values) arr.append(v);
+    return arr;
+}
+
+QVector<double> doublesFromJson(const QJsonValue& value)
+{
+    QVector<double> values;
+    for (const QJsonValue& v : value.toArray()) values.append(v.toDouble());
+    return values;
+}
+
+// 按行展开
+QJsonArray matrixToJson(const Eigen::MatrixXd& m)
+{
+    QJsonArray arr;
+    for (Eigen::Index i = 0; i < m.rows(); ++i) {
+        for (Eigen::Index j = 0; j < m.cols(); ++j) arr.append(m(i, j));
+    }
+    return arr;
+}
+
+bool matrixFromJson(const QJsonValue& value, int rows, int cols, Eigen::MatrixXd& m)
+{
+    const QJsonArray arr = value.toArray();
+    if (arr.size() != rows * cols) return false;
+    m.resize(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) m(i, j) = arr[i * cols + j].toDouble();
+    }
+    return m.allFinite();
+}
+
+// 对数灵敏度在 t 处的值：ln(t) 线性插值，超出保存范围时取端点
+bool interpolateSensitivity(const QVector<double>& time, const Eigen::MatrixXd& sens, double t, Eigen::RowVectorXd& row)
+{
+    const int m = time.size();
+    if (m == 0 || !(t > 0)) return false;
+    const int k = int(std::lower_bound(time.constBegin(), time.constEnd(), t) - time.constBegin());
+    if (k == 0) {
+        row = sens.row(0);
+    } else if (k == m) {
+        row = sens.row(m - 1);
+    } else {
+        const double a = (std::log(t) - std::log(time[k - 1])) / (std::log(time[k]) - std::log(time[k - 1]));
+        row = (1.0 - a) * sens.row(k - 1) + a * sens.row(k);
+    }
+    return true;
+}
+
+} // namespace
+
+QJsonObject FittingCore::WarmStart::toJson() const
+{
+    QJsonObject obj;
+    obj["names"] = QJsonArray::fromStringList(names);
+    QJsonArray logs;
+    for (bool b : logScale) logs.append(b);
+    obj["logScale"] = logs;
+    obj["x"] = doublesToJson(x);
+    obj["algorithm"] = int(algorithm);
+    obj["damping"] = damping;
+    obj["stage"] = stage;
+    obj["pressureTime"] = doublesToJson(pressureTime);
+    obj["pressureSens"] = matrixToJson(pressureSens);
+    obj["derivativeTime"] = doublesToJson(derivativeTime);
+    obj["derivativeSens"] = matrixToJson(derivativeSens);
+    return obj;
+}
+
+FittingCore::WarmStart FittingCore::WarmStart::fromJson(const QJsonObject& obj)
+{
+    WarmStart warm;
+    for (const QJsonValue& v : obj["names"].toArray()) warm.names.append(v.toString());
+    for (const QJsonValue& v : obj["logScale"].toArray()) warm.logScale.append(v.toBool());
+    warm.x = doublesFromJson(obj["x"]);
+    warm.algorithm = LeastSquaresOptimizer::Algorithm(obj["algorithm"].toInt());
+    warm.damping = obj["damping"].toDouble();
+    warm.stage = obj["stage"].toInt();
+    warm.pressureTime = doublesFromJson(obj["pressureTime"]);
+    warm.derivativeTime = doublesFromJson(obj["derivativeTime"]);
+
+    const int n = warm.names.size();
+    if (n == 0 || warm.logScale.size() != n || warm.x.size() != n
+        || !matrixFromJson(obj["pressureSens"], warm.pressureTime.size(), n, warm.pressureSens)
+        || !matrixFromJson(obj["derivativeSens"], warm.derivativeTime.size(), n, warm.derivativeSens)) {
+        return WarmStart();
+    }
+    return warm;
+}
+
+FittingCore::FittingCore(QSharedPointer<ModelSolver01_06> solver)
+    : m_solver(solver)
+{
+}
+
+void FittingCore::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv)
+{
+    m_obsTime = t;
+    m_obsDeltaP = deltaP;
+    m_obsDerivative = deriv;
+    rebuildSuperposition();
+    rebuildResidualRows();
+}
+
+void FittingCore::setObservedData(const SeriesData& data)
+{
+    setObservedData(data.time(), data.pressure(), data.derivative());
+}
+
+void FittingCore::setRateSchedule(const RateSuperposition::Schedule& schedule)
+{
+    m_rateSchedule = schedule;
+    rebuildSuperposition();
+    rebuildResidualRows();
+}
+
+void FittingCore::setFitWindows(const FitWindows& windows)
+{
+    m_windows = windows;
+    rebuildResidualRows();
+}
+
+void FittingCore::rebuildSuperposition()
+{
+    if(m_rateSchedule.isEmpty()) m_superposition = RateSuperposition();
+    else m_superposition = RateSuperposition(m_rateSchedule, m_obsTime, RateSuperposition::Options());
+}
+
+void FittingCore::rebuildResidualRows()
+{
+    m_rowIndex.clear();
+    m_rowEval.clear();
+    m_rowWeight.clear();
+    m_evalTime.clear();
+    m_derivativeRows = 0;
+    const QVector<double> w = m_windows.weights(m_obsTime);
+    m_weighted = !w.isEmpty();
+    if(!m_weighted) return;
+
+    const int count = qMin(m_obsDeltaP.size(), m_obsTime.size());
+    for(int i=0; i<count; ++i) {
+        if(!(w[i] > 0)) continue;
+        m_rowIndex.append(i);
+        m_rowWeight.append(w[i]);
+        if(i < m_obsDerivative.size()) ++m_derivativeRows;
+    }
+    m_rowEval = m_rowIndex;
+
+    // 理论导数逐点独立，只需在参与拟合的点上求值；全部点都参与时不缩减
+    const int n = m_obsTime.size();
+    if(m_superposition.isValid() || m_rowIndex.size() == n) return;
+    m_evalTime.reserve(m_rowIndex.size());
+    for(int k=0; k<m_rowIndex.size(); ++k) {
+        m_rowEval[k] = k;
+        m_evalTime.append(m_obsTime[m_rowIndex[k]]);
+    }
+}
+
+int FittingCore::pressureRowCount() const {
+    return m_weighted ? m_rowIndex.size() : qMin(m_obsDeltaP.size(), m_obsTime.size());
+}
+
+int FittingCore::derivativeRowCount() const {
+    return m_weighted ? m_derivativeRows : qMin(m_obsDerivative.size(), pressureRowCount());
+}
+
+ModelCurveData FittingCore::modelCurve(const ModelSolver01_06::ParamSet& params, const ModelSolver01_06::CalcOptions& options) const
+{
+    ++m_forwardSolves;
+    if(m_superposition.isValid()) return m_superposition.evaluate(*m_solver, params, options);
+    return m_solver->calculateTheoreticalCurve(params, evaluationTime(), options);
+}
+
+bool FittingCore::optimizesInLogSpace(const FitParameter& p)
+{
+    return p.value > 1e-12 && p.name != "S" && p.name != "nf";
+}
+
+void FittingCore::updateDependentParameters(QMap<QString, double>& params)
+{
+    if(params.contains("L") && params.contains("Lf") && params["L"] > 1e-9)
+        params["LfD"] = params["Lf"] / params["L"];
+}
+
+FittingCore::Result FittingCore::run(const QList<FitParameter>& params, const Options& options) {
+    Result result;
+    for(const auto& p : params) result.params.insert(p.name, p.value);
+    if(!m_solver || m_obsTime.isEmpty()) return result;
+    QElapsedTimer clock;
+    clock.start();
+    m_forwardSolves = 0;
+
+    // 迭代过程默认使用低精度选项，只作用于本实例的计算调用
+    m_calcOptions = ModelSolver01_06::CalcOptions();
+    m_calcOptions.highPrecision = options.highPrecision;
+    // 停止请求在求解器的每个求值点检查，不必等到当前迭代结束
+    m_control = QSharedPointer<SolverControl>::create();
+    if(m_stopRequested) m_control->setStopPredicate(m_stopRequested);
+    m_calcOptions.control = m_control.data();
+    double weight = options.weight;
+
+    QVector<int> fitIndices;
+    for(int i=0; i<params.size(); ++i) {
+        if(params[i].isFit) fitIndices.append(i);
+    }
+    int nParams = fitIndices.size();
+
+    if(nParams == 0) return result;
+
+    // 优化变量：正值参数 (S、nf 除外) 取 log10，其余取原值；上下限同样换算
+    QVector<bool> logScale(nParams);
+    Eigen::VectorXd x0(nParams), lower(nParams), upper(nParams);
+    for(int i=0; i<nParams; ++i) {
+        const FitParameter& p = params[fitIndices[i]];
+        bool isLog = optimizesInLogSpace(p);
+        logScale[i] = isLog;
+        if(isLog) {
+            x0[i] = log10(p.value);
+            lower[i] = p.min > 0 ? log10(p.min) : -std::numeric_limits<double>::infinity();
+            upper[i] = p.max > 0 ? log10(p.max) : x0[i];
+        } else {
+            x0[i] = p.value;
+            lower[i] = p.min;
+            upper[i] = p.max;
+        }
+    }
+
+    // 续算：拟合参数与保存时相同且起点相近时沿用雅可比、阻尼与精度级
+    const WarmStart& warm = options.warmStart;
+    bool useWarm = warm.isValid() && warm.x.size() == nParams && warm.logScale == logScale;
+    for(int i=0; useWarm && i<nParams; ++i) {
+        useWarm = warm.names[i] == params[fitIndices[i]].name && std::abs(x0[i] - warm.x[i]) <= options.warmStartMaxShift;
+    }
+    result.warmStarted = useWarm;
+    if(useWarm) result.warmStart = warm;
+
+    QMap<QString, double> baseMap;
+    for(const auto& p : params) baseMap.insert(p.name, p.value);
+    auto toParamMap = [&](const Eigen::VectorXd& x) {
+        QMap<QString, double> map = baseMap;
+        for(int i=0; i<nParams; ++i) {
+            map[params[fitIndices[i]].name] = logScale[i] ? pow(10.0, x[i]) : x[i];
+        }
+        updateDependentParameters(map);
+        return map;
+    };
+
+    // 最近一次残差求值的参数与理论曲线：接受步总是刚求过残差的点，迭代显示直接沿用这条曲线，不再另算
+    Eigen::VectorXd lastResidualX;
+    ModelCurveData lastResidualCurve;
+
+    LeastSquaresOptimizer::Problem problem;
+    problem.lower = lower;
+    problem.upper = upper;
+    problem.residuals = [&](const Eigen::VectorXd& x, Eigen::VectorXd& r) {
+        if(!m_solver || m_obsTime.isEmpty()) return false;
+        WT_PROFILE_SCOPE(ResidualScope);
+        WT_PROFILE_COUNT(ResidualEvaluations, 1);
+        ModelCurveData curve = modelCurve(ModelSolver01_06::ParamSet::fromMap(toParamMap(x)), m_calcOptions);
+        QVector<double> res = residualsFromCurve(curve, weight);
+        if(res.size() != r.size()) return false;
+        std::copy(res.begin(), res.end(), r.data());
+        if(m_onIteration) {
+            lastResidualX = x;
+            lastResidualCurve = curve;
+        }
+        return true;
+    };
+    problem.jacobian = [&](const Eigen::VectorXd& x, const Eigen::VectorXd&, Eigen::MatrixXd& J) {
+        computeJacobian(toParamMap(x), fitIndices, logScale, params, weight, J);
+        // 计算中途被停止时雅可比不完整，结束迭代
+        return !m_control->shouldStop();
+    };
+
+    LeastSquaresOptimizer::Options optimizerOptions;
+    optimizerOptions.algorithm = options.algorithm;
+    optimizerOptions.stop.targetMse = options.targetMse;
+    optimizerOptions.initialLambda = options.initialLambda;
+    optimizerOptions.jacobianRefreshInterval = options.jacobianRefreshInterval;
+    if(useWarm && warm.algorithm == options.algorithm && warm.damping > 0) {
+        if(options.algorithm == LeastSquaresOptimizer::LevenbergMarquardt) optimizerOptions.initialLambda = qBound(1e-6, warm.damping, 1.0);
+        else if(options.algorithm == LeastSquaresOptimizer::DoglegTrustRegion) optimizerOptions.initialRadius = qBound(1e-2, warm.damping, 1.0);
+    }
+
+    // 分级精度：每一级设置 Stehfest 阶数与数据密度，前几级 SSE 改进停滞时升级到下一级
+    // 未设置分级时只有一级，精度由 highPrecision 决定，使用全部数据
+    const int stageCount = qMax(1, options.stehfestSchedule.size());
+    // 续算从上次结束时的精度级开始
+    const int firstStage = useWarm ? qBound(0, warm.stage, stageCount - 1) : 0;
+    const QVector<double> fullTime = m_obsTime, fullDeltaP = m_obsDeltaP, fullDerivative = m_obsDerivative;
+    // 屏蔽点不参与重采样分箱 (分箱后的时间与屏蔽点不再对应)
+    QVector<double> binTime = fullTime, binDeltaP = fullDeltaP, binDerivative = fullDerivative;
+    if(!m_windows.maskedTimes().isEmpty()) {
+        binTime.clear();
+        binDeltaP.clear();
+        binDerivative.clear();
+        for(int i=0; i<fullTime.size() && i<fullDeltaP.size(); ++i) {
+            if(m_windows.isMasked(fullTime[i])) continue;
+            binTime.append(fullTime[i]);
+            binDeltaP.append(fullDeltaP[i]);
+            binDerivative.append(i < fullDerivative.size() ? fullDerivative[i] : 0.0);
+        }
+    }
+    auto setupStage = [&](int stage) {
+        int ppc = stage < options.pointsPerCycleSchedule.size() ? options.pointsPerCycleSchedule[stage] : 0;
+        if(ppc > 0) {
+            LogTimeResampler::Options resample;
+            resample.enabled = true;
+            resample.pointsPerCycle = ppc;
+            LogTimeResampler::Result r = LogTimeResampler::resample(binTime, binDeltaP, binDerivative, resample);
+            m_obsTime = r.time;
+            m_obsDeltaP = r.deltaP;
+            m_obsDerivative = r.derivative;
+        } else {
+            m_obsTime = fullTime;
+            m_obsDeltaP = fullDeltaP;
+            m_obsDerivative = fullDerivative;
+        }
+        rebuildSuperposition();
+        rebuildResidualRows();
+        if(!options.stehfestSchedule.isEmpty()) {
+            // 指定阶数只在高精度模式下生效 (低精度模式固定 N=4)
+            m_calcOptions.highPrecision = true;
+            m_calcOptions.stehfestN = options.stehfestSchedule[stage];
+        }
+        problem.residualCount = residualCount();
+    };
+    auto stageMse = [&](const Eigen::VectorXd& x) {
+        QVector<double> r = calculateResiduals(toParamMap(x), weight);
+        double sse = 0.0;
+        for(double v : r) sse += v * v;
+        return r.isEmpty() ? std::numeric_limits<double>::infinity() : sse / r.size();
+    };
+
+    Eigen::VectorXd x = x0;
+    double sse = 0.0;
+    int usedIterations = 0;
+    double lastSse = -1.0;
+    bool stalled = false;
+    bool lastStage = true;
+
+    // 优化引擎只负责迭代，界面回调在这里换算回参数表和曲线
+    WT_PROFILE_BEGIN_ITERATIONS();
+    LeastSquaresOptimizer optimizer;
+    optimizer.setAcceptCallback([&](const Eigen::VectorXd& xs, double s) {
+        WT_PROFILE_MARK_ITERATION();
+        if(!lastStage) {
+            if(lastSse > 0 && (lastSse - s) < options.escalationTolerance * lastSse) stalled = true;
+            lastSse = s;
+        }
+        if(!m_onIteration && !m_onStep) return;
+        QMap<QString, double> map = toParamMap(xs);
+        double mse = s / problem.residualCount;
+        if(m_onStep) m_onStep(mse, map);
+        // 曲线取自该点的残差求值 (观测时间上)；点不一致时 (个别线搜索路径) 跳过本次显示，最终曲线总会给出
+        // 停止后的曲线为空，不再刷新
+        if(m_onIteration && lastResidualX.size() == xs.size() && lastResidualX == xs
+           && !std::get<0>(lastResidualCurve).isEmpty()) {
+            m_onIteration(mse, map, lastResidualCurve);
+        }
+    });
+    optimizer.setStopPredicate([&]() {
+        if(m_stopRequested && m_stopRequested()) return true;
+        return !lastStage && stalled;
+    });
+
+    for(int stage = firstStage; stage < stageCount; ++stage) {
+        if(stage > firstStage) {
+            bool userStop = m_stopRequested && m_stopRequested();
+            if(userStop || usedIterations >= options.maxIterations) break;
+        }
+        setupStage(stage);
+        lastStage = (stage == stageCount - 1);
+
+        if(stage > firstStage) {
+            // 上一级已停滞且两级在当前参数下的误差一致：更高精度不会改变结果，结束
+            if(stalled) {
+                double mseHere = stageMse(x);
+                int levelN = m_calcOptions.stehfestN;
+                m_calcOptions.stehfestN = options.stehfestSchedule[stage - 1];
+                double msePrev = stageMse(x);
+                m_calcOptions.stehfestN = levelN;
+                if(std::isfinite(mseHere) && std::abs(mseHere - msePrev) <= options.agreementTolerance * qMax(mseHere, 1e-300)) {
+                    sse = mseHere * problem.residualCount;
+                    result.precisionAgreed = true;
+                    break;
+                }
+            }
+        }
+        stalled = false;
+        lastSse = -1.0;
+
+        int remaining = options.maxIterations - usedIterations;
+        optimizerOptions.stop.maxIterations = remaining;
+        if(m_onProgress) {
+            optimizer.setProgressCallback([&, remaining](int percent) {
+                m_onProgress((usedIterations + percent * remaining / 100) * 100 / qMax(1, options.maxIterations));
+            });
+        }
+
+        optimizerOptions.initialJacobian = Eigen::MatrixXd();
+        if(useWarm && stage == firstStage) warmJacobian(warm, weight, optimizerOptions.initialJacobian);
+
+        LeastSquaresOptimizer::Result fit = optimizer.minimize(problem, x, optimizerOptions);
+        // 本级计算过雅可比时保存续算状态 (对应本级的观测数据)
+        if(options.algorithm != LeastSquaresOptimizer::BoundedLBFGS && fit.jacobian.rows() == problem.residualCount
+           && !fit.jacobian.isZero(0.0)) {
+            WarmStart& next = result.warmStart;
+            next.names.clear();
+            for(int i=0; i<nParams; ++i) next.names.append(params[fitIndices[i]].name);
+            next.logScale = logScale;
+            next.x = QVector<double>(fit.x.data(), fit.x.data() + nParams);
+            next.algorithm = options.algorithm;
+            next.damping = fit.damping;
+            next.stage = stage;
+            captureWarmStart(fit.jacobian, weight, next);
+        }
+        x = fit.x;
+        sse = fit.sse;
+        usedIterations += fit.iterations;
+        result.jacobianEvaluations += fit.jacobianEvaluations;
+        result.precisionStages = stage + 1;
+        if(fit.converged) break;
+    }
+
+    QMap<QString, double> finalMap = toParamMap(x);
+    result.params = finalMap;
+    result.mse = problem.residualCount > 0 ? sse / problem.residualCount : 0.0;
+    result.sse = sse;
+    result.iterations = usedIterations;
+
+    // 恢复完整观测数据，最终曲线以高精度计算
+    m_obsTime = fullTime;
+    m_obsDeltaP = fullDeltaP;
+    m_obsDerivative = fullDerivative;
+    rebuildSuperposition();
+    rebuildResidualRows();
+    m_calcOptions.stehfestN = 0;
+    m_calcOptions.highPrecision = true;
+    // 最终曲线在停止后也要给出
+    m_calcOptions.control = nullptr;
+
+    if(m_onIteration) {
+        if(!m_superposition.isValid()) ++m_forwardSolves;
+        ModelCurveData finalCurve = m_superposition.isValid() ? modelCurve(ModelSolver01_06::ParamSet::fromMap(finalMap), m_calcOptions)
+                                                              : m_solver->calculateTheoreticalCurve(finalMap, QVector<double>(), m_calcOptions);
+        m_onIteration(result.mse, finalMap, finalCurve);
+    }
+    result.forwardSolves = m_forwardSolves;
+    result.elapsedMs = clock.elapsed();
+    return result;
+}
+
+double FittingCore::evaluateMse(const QMap<QString, double>& params, double weight, bool highPrecision) const {
+    int count = residualCount();
+    if(!m_solver || count == 0) return std::numeric_limits<double>::infinity();
+
+    QMap<QString, double> map = params;
+    updateDependentParameters(map);
+    ModelSolver01_06::CalcOptions calcOptions;
+    calcOptions.highPrecision = highPrecision;
+    ModelCurveData res = modelCurve(ModelSolver01_06::ParamSet::fromMap(map), calcOptions);
+    QVector<double> r = residualsFromCurve(res, weight);
+    if(r.size() != count) return std::numeric_limits<double>::infinity();
+
+    double sse = 0.0;
+    for(double v : r) sse += v * v;
+    return std::isfinite(sse) ? sse / count : std::numeric_limits<double>::infinity();
+}
+
+ModelCurveData FittingCore::evaluateCurve(const QMap<QString, double>& params, bool highPrecision) const {
+    if(!m_solver || m_obsTime.isEmpty()) return ModelCurveData();
+    QMap<QString, double> map = params;
+    updateDependentParameters(map);
+    ModelSolver01_06::CalcOptions calcOptions;
+    calcOptions.highPrecision = highPrecision;
+    // 时间窗口只缩减拟合用的求值时间，这里给出全部观测时间上的曲线
+    const ModelSolver01_06::ParamSet set = ModelSolver01_06::ParamSet::fromMap(map);
+    if(m_superposition.isValid()) return m_superposition.evaluate(*m_solver, set, calcOptions);
+    return m_solver->calculateTheoreticalCurve(set, m_obsTime, calcOptions);
+}
+
+bool FittingCore::linearize(const QList<FitParameter>& params, double weight, bool highPrecision, Eigen::VectorXd& r, Eigen::MatrixXd& J) {
+    if(!m_solver || m_obsTime.isEmpty()) return false;
+    m_calcOptions = ModelSolver01_06::CalcOptions();
+    m_calcOptions.highPrecision = highPrecision;
+
+    QVector<int> fitIndices;
+    QVector<bool> logScale;
+    QMap<QString, double> map;
+    for(int i=0; i<params.size(); ++i) {
+        map.insert(params[i].name, params[i].value);
+        if(!params[i].isFit) continue;
+        fitIndices.append(i);
+        logScale.append(optimizesInLogSpace(params[i]));
+    }
+    if(fitIndices.isEmpty()) return false;
+    updateDependentParameters(map);
+
+    QVector<double> res = calculateResiduals(map, weight);
+    if(res.size() != residualCount()) return false;
+    r = Eigen::Map<const Eigen::VectorXd>(res.constData(), res.size());
+    J.resize(res.size(), fitIndices.size());
+    computeJacobian(map, fitIndices, logScale, params, weight, J);
+    return r.allFinite() && J.allFinite();
+}
+
+bool FittingCore::evaluateBlock(const QMap<QString, double>& params, const QStringList& fitNames, const QVector<bool>& logScale,
+                                double weight, bool highPrecision, Eigen::VectorXd& r, Eigen::MatrixXd* J) {
+    if(!m_solver || m_obsTime.isEmpty()) return false;
+    m_calcOptions = ModelSolver01_06::CalcOptions();
+    m_calcOptions.highPrecision = highPrecision;
+    m_control = QSharedPointer<SolverControl>::create();
+    if(m_stopRequested) m_control->setStopPredicate(m_stopRequested);
+    m_calcOptions.control = m_control.data();
+
+    QMap<QString, double> map = params;
+    updateDependentParameters(map);
+    QVector<double> res = calculateResiduals(map, weight);
+    if(m_control->shouldStop() || res.size() != residualCount()) return false;
+    r = Eigen::Map<const Eigen::VectorXd>(res.constData(), res.size());
+    if(!J) return r.allFinite();
+
+    // computeJacobian 只用到参数名
+    QList<FitParameter> fitParams;
+    QVector<int> fitIndices;
+    for(int j=0; j<fitNames.size(); ++j) {
+        FitParameter p;
+        p.name = fitNames[j];
+        p.displayName = p.name;
+        p.value = map.value(p.name, 0.0);
+        p.isFit = true;
+        p.min = p.max = p.value;
+        p.isVisible = false;
+        fitParams.append(p);
+        fitIndices.append(j);
+    }
+    J->resize(res.size(), fitNames.size());
+    computeJacobian(map, fitIndices, logScale, fitParams, weight, *J);
+    return !m_control->shouldStop() && r.allFinite() && J->allFinite();
+}
+
+void FittingCore::captureWarmStart(const Eigen::MatrixXd& J, double weight, WarmStart& warm) const {
+    const int n = int(J.cols());
+    const int count = pressureRowCount();
+    const int dCount = derivativeRowCount();
+
+    // 残差 = w*(ln 观测 - ln 理论)，灵敏度 d ln(理论)/dx = -J/w (w 含时间窗口权重)；
+    // 被屏蔽 (整行为 0) 的点不保存，同一时间只保留一行
+    auto extract = [&](int firstRow, int rows, const QVector<double>& obs, double w, QVector<double>& times, Eigen::MatrixXd& sens) {
+        times.clear();
+        sens.resize(0, n);
+        if(w <= 0) return;
+        auto pointOf = [&](int k) { return m_weighted ? m_rowIndex[k] : k; };
+        QVector<int> order;
+        for(int k=0; k<rows; ++k) {
+            const int i = pointOf(k);
+            if(obs[i] > 1e-10 && m_obsTime[i] > 0 && !J.row(firstRow + k).isZero(0.0)) order.append(k);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return m_obsTime[pointOf(a)] < m_obsTime[pointOf(b)]; });
+        sens.resize(order.size(), n);
+        int m = 0;
+        for(int k : order) {
+            const double t = m_obsTime[pointOf(k)];
+            if(m > 0 && times.last() == t) continue;
+            times.append(t);
+            sens.row(m++) = J.row(firstRow + k) / -(w * (m_weighted ? m_rowWeight[k] : 1.0));
+        }
+        sens.conservativeResize(m, n);
+    };
+    extract(0, count, m_obsDeltaP, weight, warm.pressureTime, warm.pressureSens);
+    extract(count, dCount, m_obsDerivative, 1.0 - weight, warm.derivativeTime, warm.derivativeSens);
+}
+
+bool FittingCore::warmJacobian(const WarmStart& warm, double weight, Eigen::MatrixXd& J) const {
+    const int n = warm.x.size();
+    const int count = pressureRowCount();
+    const int dCount = derivativeRowCount();
+    const double wp = weight;
+    const double wd = 1.0 - weight;
+    if((wp > 0 && count > 0 && warm.pressureTime.isEmpty()) || (wd > 0 && dCount > 0 && warm.derivativeTime.isEmpty())) return false;
+
+    // 屏蔽规则与 residualsFromCurve 相同 (理论值在起点处未知，按观测值判断)
+    Eigen::MatrixXd out = Eigen::MatrixXd::Zero(count + dCount, n);
+    Eigen::RowVectorXd row(n);
+    for(int k=0; k<count && wp > 0; ++k) {
+        const int i = m_weighted ? m_rowIndex[k] : k;
+        const double s = wp * (m_weighted ? m_rowWeight[k] : 1.0);
+        if(m_obsDeltaP[i] > 1e-10 && interpolateSensitivity(warm.pressureTime, warm.pressureSens, m_obsTime[i], row)) out.row(k) = -s * row;
+    }
+    for(int k=0; k<dCount && wd > 0; ++k) {
+        const int i = m_weighted ? m_rowIndex[k] : k;
+        const double s = wd * (m_weighted ? m_rowWeight[k] : 1.0);
+        if(m_obsDerivative[i] > 1e-10 && interpolateSensitivity(warm.derivativeTime, warm.derivativeSens, m_obsTime[i], row)) out.row(count + k) = -s * row;
+    }
+    J.swap(out);
+    return true;
+}
+
+// 残差个数：压差与导数各一段，导数段不长于压差段 (与 residualsFromCurve 的排列一致)
+int FittingCore::residualCount() const {
+    return pressureRowCount() + derivativeRowCount();
+}
+
+QVector<double> FittingCore::calculateResiduals(const QMap<QString, double>& params, double weight) {
+    return calculateResiduals(ModelSolver01_06::ParamSet::fromMap(params), weight);
+}
+
+QVector<double> FittingCore::calculateResiduals(const ModelSolver01_06::ParamSet& params, double weight) {
+    if(!m_solver || m_obsTime.isEmpty()) return QVector<double>();
+
+    ModelCurveData res = modelCurve(params, m_calcOptions);
+    return residualsFromCurve(res, weight);
+}
+
+QVector<double> FittingCore::residualsFromCurve(const ModelCurveData& res, double weight) const {
+    const QVector<double>& pCal = std::get<1>(res);
+    const QVector<double>& dpCal = std::get<2>(res);
+
+    // 雅可比计算时会被多个线程同时调用，观测数据只通过常量引用读取，避免隐式共享分离
+    const QVector<double>& obsP = m_obsDeltaP;
+    const QVector<double>& obsD = m_obsDerivative;
+
+    QVector<double> r;
+    double wp = weight;
+    double wd = 1.0 - weight;
+
+    if(m_weighted) {
+        // 曲线在求值时间上：长度不符 (停止后的空曲线) 时返回空数组，由调用方按个数不符处理
+        const int evalCount = evaluationTime().size();
+        if(pCal.size() != evalCount || dpCal.size() != evalCount) return r;
+        const int rows = m_rowIndex.size();
+        r.resize(rows + m_derivativeRows);
+        for(int k=0; k<rows; ++k) {
+            const int i = m_rowIndex[k];
+            const int e = m_rowEval[k];
+            r[k] = (obsP[i] > 1e-10 && pCal[e] > 1e-10) ? (log(obsP[i]) - log(pCal[e])) * wp * m_rowWeight[k] : 0.0;
+        }
+        for(int k=0; k<m_derivativeRows; ++k) {
+            const int i = m_rowIndex[k];
+            const int e = m_rowEval[k];
+            r[rows + k] = (obsD[i] > 1e-10 && dpCal[e] > 1e-10) ? (log(obsD[i]) - log(dpCal[e])) * wd * m_rowWeight[k] : 0.0;
+        }
+        return r;
+    }
+
+    int count = qMin(obsP.size(), pCal.size());
+    for(int i=0; i<count; ++i) {
+        if(obsP[i] > 1e-10 && pCal[i] > 1e-10)
+            r.append( (log(obsP[i]) - log(pCal[i])) * wp );
+        else
+            r.append(0.0);
+    }
+
+    int dCount = qMin(obsD.size(), dpCal.size());
+    dCount = qMin(dCount, count);
+    for(int i=0; i<dCount; ++i) {
+        if(obsD[i] > 1e-10 && dpCal[i] > 1e-10)
+            r.append( (log(obsD[i]) - log(dpCal[i])) * wd );
+        else
+            r.append(0.0);
+    }
+    return r;
+}
+
+// 残差对单个参数的偏导数，排列与屏蔽规则与 residualsFromCurve 一致：d(ln p) = dp / p
+QVector<double> FittingCore::residualSensitivity(const ModelCurveData& res, const QVector<double>& dP, const QVector<double>& dDeriv, double weight) const {
+    const QVector<double>& pCal = std::get<1>(res);
+    const QVector<double>& dpCal = std::get<2>(res);
+    const QVector<double>& obsP = m_obsDeltaP;
+    const QVector<double>& obsD = m_obsDerivative;
+
+    QVector<double> r;
+    double wp = weight;
+    double wd = 1.0 - weight;
+
+    if(m_weighted) {
+        const int evalCount = evaluationTime().size();
+        if(pCal.size() != evalCount || dpCal.size() != evalCount || dP.size() != evalCount || dDeriv.size() != evalCount) return r;
+        const int rows = m_rowIndex.size();
+        r.resize(rows + m_derivativeRows);
+        for(int k=0; k<rows; ++k) {
+            const int i = m_rowIndex[k];
+            const int e = m_rowEval[k];
+            r[k] = (obsP[i] > 1e-10 && pCal[e] > 1e-10) ? -wp * m_rowWeight[k] * dP[e] / pCal[e] : 0.0;
+        }
+        for(int k=0; k<m_derivativeRows; ++k) {
+            const int i = m_rowIndex[k];
+            const int e = m_rowEval[k];
+            r[rows + k] = (obsD[i] > 1e-10 && dpCal[e] > 1e-10) ? -wd * m_rowWeight[k] * dDeriv[e] / dpCal[e] : 0.0;
+        }
+        return r;
+    }
+
+    int count = qMin(obsP.size(), pCal.size());
+    for(int i=0; i<count; ++i) {
+        if(obsP[i] > 1e-10 && pCal[i] > 1e-10)
+            r.append( -wp * dP[i] / pCal[i] );
+        else
+            r.append(0.0);
+    }
+
+    int dCount = qMin(obsD.size(), dpCal.size());
+    dCount = qMin(dCount, count);
+    for(int i=0; i<dCount; ++i) {
+        if(obsD[i] > 1e-10 && dpCal[i] > 1e-10)
+            r.append( -wd * dDeriv[i] / dpCal[i] );
+        else
+            r.append(0.0);
+    }
+    return r;
+}
+
+void FittingCore::computeJacobian(const QMap<QString, double>& params, const QVector<int>& fitIndices, const QVector<bool>& logScale, const QList<FitParameter>& currentFitParams, double weight, Eigen::MatrixXd& J) {
+    WT_PROFILE_SCOPE(JacobianScope);
+    int nRes = J.rows();
+    int nParams = fitIndices.size();
+    WT_PROFILE_COUNT(JacobianColumns, nParams);
+    J.setZero();
+
+    // 参数名只在此处解析一次，求导在定长参数表上进行，不再为每列复制整个 QMap
+    using ParamSet = ModelSolver01_06::ParamSet;
+    const ParamSet base = ParamSet::fromMap(params);
+    bool hasLength = params.contains("L") && params.contains("Lf");
+    bool linkLength = hasLength && base[ParamSet::L] > 1e-9;
+
+    // 可求导参数的列：一次对偶数正演同时给出曲线对全部这些参数的偏导数
+    struct SensitivityColumn {
+        int column;
+        int slot;
+        double scale; // 对数参数按 log10 求导：dθ/d(log10 θ) = θ*ln10
+    };
+    QVector<SensitivityColumn> sensColumns;
+    QVector<int> wrt;
+
+    for(int j = 0; j < nParams; ++j) {
+        int idx = fitIndices[j];
+        QString pName = currentFitParams[idx].name;
+        int slot = ParamSet::indexOf(pName);
+        if(slot < 0) continue; // 求解器不使用的参数，对曲线无影响，该列保持为 0
+        // 裂缝条数 nf、Stehfest 阶数 N 为整数参数 (求解器截断取整)，微小扰动下曲线不变或跳到相邻整数，
+        // 差分得不到有意义的导数；该列保持为 0，这类参数在迭代中保持不变
+        if(!ModelSolver01_06::isDifferentiable(slot)) continue;
+
+        double val = base[slot];
+        bool isLog = logScale[j];
+        sensColumns.append({ j, slot, isLog ? val * std::log(10.0) : 1.0 });
+        if(!wrt.contains(slot)) wrt.append(slot);
+        // L、Lf 通过 LfD = Lf/L 影响曲线
+        if(linkLength && (slot == ParamSet::L || slot == ParamSet::LF) && !wrt.contains(ParamSet::LFD)) wrt.append(ParamSet::LFD);
+    }
+
+    if(!sensColumns.isEmpty()) {
+        ModelSolver01_06::CurveSensitivity sens;
+        ++m_forwardSolves;
+        ModelCurveData res = m_superposition.isValid() ? m_superposition.evaluateSensitivity(*m_solver, base, m_calcOptions, wrt, sens)
+                                                       : m_solver->calculateCurveSensitivity(base, evaluationTime(), m_calcOptions, wrt, sens);
+        auto residualDerivative = [&](int slot) {
+            int k = wrt.indexOf(slot);
+            return residualSensitivity(res, sens.dP[k], sens.dDeriv[k], weight);
+        };
+        QVector<double> drLfD;
+        if(wrt.contains(ParamSet::LFD)) drLfD = residualDerivative(ParamSet::LFD);
+
+        for(const SensitivityColumn& c : sensColumns) {
+            QVector<double> dr = residualDerivative(c.slot);
+            if(dr.size() != nRes) continue;
+            if(linkLength && drLfD.size() == nRes) {
+                double L = base[ParamSet::L];
+                double dLfD = 0.0;
+                if(c.slot == ParamSet::L) dLfD = -base[ParamSet::LF] / (L * L);
+                else if(c.slot == ParamSet::LF) dLfD = 1.0 / L;
+                if(dLfD != 0.0) {
+                    for(int i=0; i<nRes; ++i) dr[i] += dLfD * drLfD[i];
+                }
+            }
+            for(int i=0; i<nRes; ++i) J(i, c.column) = dr[i] * c.scale;
+        }
+    }
+}
@@ -0,0 +1,224 @@
+/*
+ * 文件名: fittingcore.h
+ * 文件作用: 试井拟合核心算法头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 定义拟合参数结构体 FitParameter。
+ * 2. 把试井模型拟合表述为有界最小二乘问题 (残差、雅可比、上下限)，由 LeastSquaresOptimizer 迭代求解。
+ * 3. 通过回调报告迭代进度与中间曲线，供拟合界面、基准测试等复用。
+ * 4. 可选算法：LM (可配合 Broyden 秩一更新)、Dogleg 信赖域、有界 L-BFGS。
+ * 5. 可选分级精度：先在低阶 Stehfest、抽稀数据上迭代，改进停滞后逐级提高阶数与数据密度，相邻两级一致时结束。
+ * 6. 可选变产量拟合：给定产量历史时理论曲线由 RateSuperposition 叠加单位产量响应得到。
+ * 7. 停止请求经 SolverControl 传入求解器，在每个求值点检查，正在进行的正演或雅可比计算中途即可中止。
+ * 8. 可在给定参数处线性化 (残差与雅可比)，供参数不确定性分析使用。
+ * 9. 续算：拟合结束时保存雅可比 (换算为理论曲线的对数灵敏度，与观测数据和权重无关)、阻尼与精度级；
+ *    下次拟合的参数集合相同且起点相近时，按对数时间插值得到新数据上的雅可比，从上次的阻尼与精度级继续。
+ * 10. 可选时间窗口与屏蔽点 (FitWindows)：残差只含权重为正的点并乘以该权重，观测数据本身不复制；
+ *    求解器只在这些点上求值，只拟合部分流动段时正演计算量随之减少。
+ * 11. 分块求值 (evaluateBlock)：给定参数处的残差块与指定参数的雅可比块，供多测试联合拟合 (JointFitter) 拼接。
+ */
+
+#ifndef FITTINGCORE_H
+#define FITTINGCORE_H
+
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <QList>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QJsonObject>
+#include <functional>
+#include <atomic>
+#include "modelsolver01-06.h"
+#include "leastsquaresoptimizer.h"
+#include "ratesuperposition.h"
+#include "fitwindows.h"
+#include "seriesdata.h"
+#include "solverjob.h"
+
+// 定义拟合参数结构体
+struct FitParameter {
+    QString name;           // 参数内部英文名 (例如 "k", "S")
+    QString displayName;    // 参数显示中文名 (例如 "渗透率")
+    double value;           // 当前参数值
+    bool isFit;             // 是否参与拟合 (true: 变量, false: 定值)
+    double min;             // 参数下限
+    double max;             // 参数上限
+    bool isVisible;         // 是否在主界面表格中显示
+};
+
+class FittingCore
+{
+public:
+    // 续算状态：上一次拟合结束时的雅可比、阻尼与精度级
+    // 雅可比保存为理论曲线的对数灵敏度 d ln(p)/dx、d ln(p')/dx (各行按时间升序)，观测数据修改、点数变化后仍可插值使用
+    struct WarmStart {
+        QStringList names;                  // 拟合参数，顺序与优化变量一致
+        QVector<bool> logScale;             // 各优化变量是否为 log10(参数)
+        QVector<double> x;                  // 雅可比所在的优化变量值
+        LeastSquaresOptimizer::Algorithm algorithm = LeastSquaresOptimizer::LevenbergMarquardt;
+        double damping = 0.0;               // LM 阻尼或 Dogleg 信赖域半径
+        int stage = 0;                      // 结束时所在的精度级
+        QVector<double> pressureTime;
+        Eigen::MatrixXd pressureSens;       // pressureTime.size() × 参数个数
+        QVector<double> derivativeTime;
+        Eigen::MatrixXd derivativeSens;
+
+        bool isValid() const { return !names.isEmpty() && x.size() == names.size(); }
+        QJsonObject toJson() const;
+        // 内容不完整或尺寸不一致时返回无效状态
+        static WarmStart fromJson(const QJsonObject& obj);
+    };
+
+    // 拟合控制选项
+    struct Options {
+        LeastSquaresOptimizer::Algorithm algorithm = LeastSquaresOptimizer::LevenbergMarquardt;
+        double weight = 0.5;         // 压差残差权重 (导数权重为 1-weight)
+        int maxIterations = 50;      // 最大迭代次数
+        double initialLambda = 0.01; // LM 阻尼初值
+        double targetMse = 3e-3;     // 均方误差低于该值时提前结束
+        bool highPrecision = false;  // 迭代期间是否使用高精度求解 (全数据精修时使用)
+        // 每隔多少次迭代完整计算一次雅可比，其间用 Broyden 秩一更新 (LM、Dogleg)；
+        // 1 表示每次迭代都完整计算。近似雅可比下步长被拒时立即重新完整计算
+        int jacobianRefreshInterval = 1;
+
+        // 分级精度：各级依次使用的 Stehfest 阶数 (例如 4, 8, 12)；为空时整个拟合只有一级，精度由 highPrecision 决定
+        QVector<int> stehfestSchedule;
+        // 各级对观测数据的对数重采样密度 (每个对数周期点数)，缺省或 <=0 表示使用全部观测数据
+        QVector<int> pointsPerCycleSchedule;
+        double escalationTolerance = 1e-3; // 非最后一级：接受步的相对 SSE 改进低于该值时升级
+        double agreementTolerance = 1e-2;  // 升级时相邻两级在当前参数下的 MSE 相对差不超过该值即结束
+
+        // 续算状态 (无效时从头开始)：拟合参数相同且起点与其相差不超过 warmStartMaxShift (优化变量，log10 参数即数量级) 时使用
+        WarmStart warmStart;
+        double warmStartMaxShift = 0.5;
+    };
+
+    // 拟合结果
+    struct Result {
+        QMap<QString, double> params;
+        double mse = 0.0;
+        int iterations = 0;
+        int jacobianEvaluations = 0; // 完整雅可比计算次数
+        int precisionStages = 0;     // 实际迭代过的精度级数
+        bool precisionAgreed = false; // 是否因相邻两级误差一致而提前结束
+        bool warmStarted = false;     // 是否沿用了续算状态
+        WarmStart warmStart;          // 本次结束时的续算状态 (L-BFGS 不保存)
+        double sse = 0.0;             // 最终残差平方和 (最后一级数据上)
+        int forwardSolves = 0;        // 求解器正演次数 (曲线与灵敏度，含最终曲线)
+        qint64 elapsedMs = 0;         // run 的墙钟时间
+    };
+
+    // 回调：迭代曲线更新 (在拟合线程中调用)、进度百分比、停止请求查询
+    // 迭代中的曲线是残差计算已得到的观测时间上的理论曲线 (不额外正演)；最终曲线为高精度的完整时间范围
+    using IterationCallback = std::function<void(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)>;
+    // 轻量回调：起点与每个接受步的误差和参数，不计算曲线 (多起点拟合的淘汰判定用)
+    using StepCallback = std::function<void(double mse, const QMap<QString, double>& params)>;
+    using ProgressCallback = std::function<void(int percent)>;
+    using StopPredicate = std::function<bool()>;
+
+    // solver 由调用方提供 (通常来自 ModelManager::createSolver)，拟合期间独占使用
+    explicit FittingCore(QSharedPointer<ModelSolver01_06> solver);
+
+    void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv);
+    // 与调用方共享同一份数组 (不复制数据)
+    void setObservedData(const SeriesData& data);
+    // 产量历史 (与观测时间同一时钟，压差以原始地层压力为基准)；为空时按参数 q 定产量计算
+    void setRateSchedule(const RateSuperposition::Schedule& schedule);
+    // 时间窗口权重与屏蔽点 (为空时全部观测点权重为 1)
+    void setFitWindows(const FitWindows& windows);
+
+    void setIterationCallback(IterationCallback cb) { m_onIteration = cb; }
+    void setStepCallback(StepCallback cb) { m_onStep = cb; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    // 执行拟合 (算法由 options.algorithm 选择)，返回最终参数
+    Result run(const QList<FitParameter>& params, const Options& options);
+
+    // 计算一组参数 (需含全部模型参数) 的均方误差，不修改对象状态，可并发调用；无法求值时返回无穷大
+    double evaluateMse(const QMap<QString, double>& params, double weight, bool highPrecision = false) const;
+    // 观测时间上的理论曲线 (有产量历史时为叠加结果)，不修改对象状态
+    ModelCurveData evaluateCurve(const QMap<QString, double>& params, bool highPrecision = false) const;
+
+    /**
+     * @brief 在 params 的当前值处线性化：r 为残差，J 为残差对各拟合参数 (isFit) 的雅可比
+     * 列顺序与 params 中拟合参数的顺序一致，对数参数 (optimizesInLogSpace) 的列对 log10(参数) 求导，与 run 的优化变量相同。
+     * 无法求值或没有拟合参数时返回 false。
+     */
+    bool linearize(const QList<FitParameter>& params, double weight, bool highPrecision, Eigen::VectorXd& r, Eigen::MatrixXd& J);
+
+    /**
+     * @brief 联合拟合的分块求值：在 params (全部模型参数) 处求本测试的残差块 r (长度 residualCount())
+     * J 非空时同时求残差对 fitNames 各参数的雅可比 (logScale 为真的列对 log10(参数) 求导)。
+     * 停止请求 (setStopPredicate) 在求解器的每个求值点检查；停止或无法求值时返回 false。
+     * 同一实例不能并发调用，不同实例 (各自的求解器) 可并发。
+     */
+    bool evaluateBlock(const QMap<QString, double>& params, const QStringList& fitNames, const QVector<bool>& logScale,
+                       double weight, bool highPrecision, Eigen::VectorXd& r, Eigen::MatrixXd* J);
+
+    // 优化变量是否取 log10：正值参数 (S、nf 除外)
+    static bool optimizesInLogSpace(const FitParameter& p);
+
+    // 由 L 与 Lf 更新无因次裂缝半长 LfD
+    static void updateDependentParameters(QMap<QString, double>& params);
+
+    // 残差个数：压差与导数各一段，导数段不长于压差段 (与 residualsFromCurve 的排列一致)；
+    // 设置了时间窗口时只含权重为正的点
+    int residualCount() const;
+
+private:
+    // 观测时间上的理论曲线：有产量历史时为叠加结果，并发调用安全
+    ModelCurveData modelCurve(const ModelSolver01_06::ParamSet& params, const ModelSolver01_06::CalcOptions& options) const;
+    // 观测数据或产量历史变化后重建叠加权重
+    void rebuildSuperposition();
+    // 观测数据、产量历史或时间窗口变化后重建参与拟合的点与求值时间
+    void rebuildResidualRows();
+    // 求解器求值的时间：参与拟合的点 (不缩减时为 m_obsTime)
+    const QVector<double>& evaluationTime() const { return m_evalTime.isEmpty() ? m_obsTime : m_evalTime; }
+    // 压差、导数残差段的行数
+    int pressureRowCount() const;
+    int derivativeRowCount() const;
+    // 由当前观测数据上的雅可比提取对数灵敏度 (被屏蔽的行不保存)
+    void captureWarmStart(const Eigen::MatrixXd& J, double weight, WarmStart& warm) const;
+    // 在当前观测数据上由续算状态插值出雅可比，所需的灵敏度缺失时返回 false
+    bool warmJacobian(const WarmStart& warm, double weight, Eigen::MatrixXd& J) const;
+    QVector<double> calculateResiduals(const QMap<QString, double>& params, double weight);
+    QVector<double> calculateResiduals(const ModelSolver01_06::ParamSet& params, double weight);
+    QVector<double> residualsFromCurve(const ModelCurveData& res, double weight) const;
+    QVector<double> residualSensitivity(const ModelCurveData& res, const QVector<double>& dP, const QVector<double>& dDeriv, double weight) const;
+    // 雅可比写入已按 (残差个数 × 拟合参数个数) 分配的 J；logScale 为真的列对 log10(参数) 求导
+    void computeJacobian(const QMap<QString, double>& params, const QVector<int>& fitIndices, const QVector<bool>& logScale, const QList<FitParameter>& currentFitParams, double weight, Eigen::MatrixXd& J);
+
+private:
+    QSharedPointer<ModelSolver01_06> m_solver;
+    ModelSolver01_06::CalcOptions m_calcOptions; // 迭代期间低精度，最终曲线高精度
+    QSharedPointer<SolverControl> m_control;      // 迭代期间的停止控制 (由 m_stopRequested 驱动)
+
+    QVector<double> m_obsTime;
+    QVector<double> m_obsDeltaP;
+    QVector<double> m_obsDerivative;
+
+    RateSuperposition::Schedule m_rateSchedule;
+    RateSuperposition m_superposition; // 对应当前 m_obsTime
+
+    // 时间窗口：m_weighted 为真时第 k 行残差对应观测点 m_rowIndex[k]、求值曲线的第 m_rowEval[k] 点，乘以 m_rowWeight[k]
+    // 导数段为前 m_derivativeRows 个点 (有观测导数的点)
+    FitWindows m_windows;
+    bool m_weighted = false;
+    QVector<int> m_rowIndex;
+    QVector<int> m_rowEval;
+    QVector<double> m_rowWeight;
+    int m_derivativeRows = 0;
+    QVector<double> m_evalTime;       // 缩减后的求值时间，为空表示在全部观测时间上求值
+
+    // 本次 run 的正演次数 (evaluateMse 可并发调用)
+    mutable std::atomic<int> m_forwardSolves{0};
+
+    IterationCallback m_onIteration;
+    StepCallback m_onStep;
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+};
+
+#endif // FITTINGCORE_H
@@ -6,6 +6,7 @@
  * 2. 实现智能列名识别，自动匹配 Time, Pressure 等列。
  * 3. 实现试井类型切换逻辑：降落试井需输入地层压力，恢复试井自动计算。
  * 4. 提供完整的配置获取接口。
+ * 5. 导数平滑方法可选 (SignalFilter)：按方法启用窗口点数或对数时间窗口宽度。
  */
 
 #include "fittingdatadialog.h"
@@ -20,11 +21,11 @@
 #include <QDir>
 
 // 构造函数
-FittingDataDialog::FittingDataDialog(QStandardItemModel* projectModel, QWidget *parent) :
+FittingDataDialog::FittingDataDialog(MeasurementTableModel* projectModel, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::FittingDataDialog),
     m_projectModel(projectModel),
-    m_fileModel(new QStandardItemModel(this))
+    m_fileModel(new MeasurementTableModel(this))
 {
     ui->setupUi(this);
 
@@ -41,7 +42,19 @@ FittingDataDialog::FittingDataDialog(QStandardItemModel* projectModel, QWidget *
     connect(ui->radioBuildup, &QRadioButton::toggled, this, &FittingDataDialog::onTestTypeChanged);
 
     // 连接平滑复选框
+    for (int m = SignalFilter::MovingAverage; m <= SignalFilter::WaveletDenoise; ++m)
+        ui->comboSmoothMethod->addItem(SignalFilter::methodName(SignalFilter::Method(m)), m);
     connect(ui->checkSmoothing, &QCheckBox::toggled, this, &FittingDataDialog::onSmoothingToggled);
+    connect(ui->comboSmoothMethod, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        onSmoothingToggled(ui->checkSmoothing->isChecked());
+    });
+
+    // 连接重采样设置
+    ui->comboAggregation->addItem("中位数", LogTimeResampler::Median);
+    ui->comboAggregation->addItem("平均值", LogTimeResampler::Mean);
+    connect(ui->checkResample, &QCheckBox::toggled, this, &FittingDataDialog::onResampleToggled);
+    connect(ui->checkOutlier, &QCheckBox::toggled, ui->spinOutlierSigma, &QWidget::setEnabled);
+    onResampleToggled(ui->checkResample->isChecked());
 
     // 重写确定按钮逻辑，先进行校验
     connect(ui->buttonBox->button(QDialogButtonBox::Ok), &QPushButton::clicked, this, &FittingDataDialog::onAccepted);
@@ -95,7 +108,7 @@ void FittingDataDialog::onSourceChanged()
     bool isProject = ui->radioProjectData->isChecked();
     ui->widgetFileSelect->setVisible(!isProject);
 
-    QStandardItemModel* targetModel = isProject ? m_projectModel : m_fileModel;
+    MeasurementTableModel* targetModel = isProject ? m_projectModel : m_fileModel;
 
     // 清空预览表格
     ui->tablePreview->clear();
@@ -114,10 +127,7 @@ void FittingDataDialog::onSourceChanged()
         ui->tablePreview->setRowCount(rows);
         for (int i = 0; i < rows; ++i) {
             for (int j = 0; j < targetModel->columnCount(); ++j) {
-                QStandardItem* item = targetModel->item(i, j);
-                if (item) {
-                    ui->tablePreview->setItem(i, j, new QTableWidgetItem(item->text()));
-                }
+                ui->tablePreview->setItem(i, j, new QTableWidgetItem(targetModel->text(i, j)));
             }
         }
 
@@ -214,7 +224,6 @@ bool FittingDataDialog::parseTextFile(const QString& filePath)
     QTextStream in(&content);
 
     bool headerSet = false;
-    int colCount = 0;
 
     while (!in.atEnd()) {
         QString line = in.readLine().trimmed();
@@ -234,13 +243,10 @@ bool FittingDataDialog::parseTextFile(const QString& filePath)
 
         if (!headerSet) {
             m_fileModel->setHorizontalHeaderLabels(parts);
-            colCount = parts.size();
             headerSet = true;
         } else {
-            QList<QStandardItem*> items;
-            for (const QString& p : parts) items.append(new QStandardItem(p));
-            while(items.size() < colCount) items.append(new QStandardItem(""));
-            m_fileModel->appendRow(items);
+            // 字段数不足表头列数的行，缺少的单元格保持为空
+            m_fileModel->appendRow(parts);
         }
     }
     return true;
@@ -278,9 +284,9 @@ bool FittingDataDialog::parseExcelFile(const QString& filePath)
                 for(const QVariant& v : rowsData.first()) headers << v.toString();
                 m_fileModel->setHorizontalHeaderLabels(headers);
                 for(int i=1; i<rowsData.size(); ++i) {
-                    QList<QStandardItem*> items;
-                    for(const QVariant& v : rowsData[i]) items.append(new QStandardItem(v.toString()));
-                    m_fileModel->appendRow(items);
+                    QStringList fields;
+                    for(const QVariant& v : rowsData[i]) fields << v.toString();
+                    m_fileModel->appendRow(fields);
                 }
             }
             delete usedRange;
@@ -301,7 +307,21 @@ void FittingDataDialog::onDerivColumnChanged(int index)
 // 平滑选项切换
 void FittingDataDialog::onSmoothingToggled(bool checked)
 {
-    ui->spinSmoothSpan->setEnabled(checked);
+    // 窗口点数用于移动平均与 Savitzky-Golay，窗口宽度用于对数时间平均
+    const SignalFilter::Method method = SignalFilter::Method(ui->comboSmoothMethod->currentData().toInt());
+    ui->comboSmoothMethod->setEnabled(checked);
+    ui->spinSmoothSpan->setEnabled(checked && (method == SignalFilter::MovingAverage || method == SignalFilter::SavitzkyGolay));
+    ui->spinSmoothWindow->setEnabled(checked && method == SignalFilter::LogTimeAverage);
+}
+
+// 重采样选项切换
+void FittingDataDialog::onResampleToggled(bool checked)
+{
+    ui->spinPointsPerCycle->setEnabled(checked);
+    ui->comboAggregation->setEnabled(checked);
+    ui->checkOutlier->setEnabled(checked);
+    ui->spinOutlierSigma->setEnabled(checked && ui->checkOutlier->isChecked());
+    ui->checkRefineFull->setEnabled(checked);
 }
 
 // 获取设置结果
@@ -328,13 +348,22 @@ FittingDataSettings FittingDataDialog::getSettings() const
         s.initialPressure = 0.0; // 恢复试井不使用此字段
     }
 
-    s.enableSmoothing = ui->checkSmoothing->isChecked();
-    s.smoothingSpan = ui->spinSmoothSpan->value();
+    s.smoothing.enabled = ui->checkSmoothing->isChecked();
+    s.smoothing.method = SignalFilter::Method(ui->comboSmoothMethod->currentData().toInt());
+    s.smoothing.span = ui->spinSmoothSpan->value();
+    s.smoothing.windowCycles = ui->spinSmoothWindow->value();
+
+    s.resample.enabled = ui->checkResample->isChecked();
+    s.resample.pointsPerCycle = ui->spinPointsPerCycle->value();
+    s.resample.aggregation = LogTimeResampler::Aggregation(ui->comboAggregation->currentData().toInt());
+    s.resample.rejectOutliers = ui->checkOutlier->isChecked();
+    s.resample.outlierThreshold = ui->spinOutlierSigma->value();
+    s.refineOnFullData = s.resample.enabled && ui->checkRefineFull->isChecked();
 
     return s;
 }
 
-QStandardItemModel* FittingDataDialog::getPreviewModel() const
+MeasurementTableModel* FittingDataDialog::getPreviewModel() const
 {
     return ui->radioProjectData->isChecked() ? m_projectModel : m_fileModel;
 }
@@ -2,7 +2,7 @@
  * 文件名: fittingdatadialog.h
  * 文件作用: 拟合数据加载配置窗口头文件
  * 功能描述:
- * 1. 声明 FittingDataSettings 结构体，用于封装用户的选择（列索引、试井类型、初始压力、平滑参数等）。
+ * 1. 声明 FittingDataSettings 结构体，用于封装用户的选择（列索引、试井类型、初始压力、平滑参数、重采样参数等）。
  * 2. 声明 FittingDataDialog 类，提供从项目或文件加载数据、预览数据、配置列映射的界面。
  * 3. 包含了文件解析逻辑（CSV, TXT, Excel）。
  */
@@ -11,7 +11,9 @@
 #define FITTINGDATADIALOG_H
 
 #include <QDialog>
-#include <QStandardItemModel>
+#include "measurementtablemodel.h"
+#include "logtimeresampler.h"
+#include "signalfilter.h"
 
 namespace Ui {
 class FittingDataDialog;
@@ -36,8 +38,10 @@ struct FittingDataSettings {
     WellTestType testType;      // 试井类型 (降落/恢复)
     double initialPressure;     // 地层初始压力 Pi (仅降落试井需要)
 
-    bool enableSmoothing;       // 是否启用平滑
-    int smoothingSpan;          // 平滑窗口大小 (奇数)
+    SignalFilter::Options smoothing; // 导数平滑 (方法、窗口点数、对数时间窗口宽度)
+
+    LogTimeResampler::Options resample; // 拟合前的对数时间重采样
+    bool refineOnFullData;      // 重采样拟合后是否在全部数据上做一次高精度精修
 };
 
 class FittingDataDialog : public QDialog
@@ -46,14 +50,14 @@ class FittingDataDialog : public QDialog
 
 public:
     // 构造函数：需要传入项目数据模型用于预览
-    explicit FittingDataDialog(QStandardItemModel* projectModel, QWidget *parent = nullptr);
+    explicit FittingDataDialog(MeasurementTableModel* projectModel, QWidget *parent = nullptr);
     ~FittingDataDialog();
 
     // 获取用户确认后的配置
     FittingDataSettings getSettings() const;
 
     // 获取当前显示在预览表格中的数据模型
-    QStandardItemModel* getPreviewModel() const;
+    MeasurementTableModel* getPreviewModel() const;
 
 private slots:
     // 数据来源改变时触发
@@ -68,17 +72,20 @@ private slots:
     // 试井类型改变时触发 (控制初始压力输入框的启用状态)
     void onTestTypeChanged();
 
-    // 启用平滑复选框切换时触发
+    // 启用平滑复选框或平滑方法切换时触发 (按方法启用窗口点数或窗口宽度)
     void onSmoothingToggled(bool checked);
 
+    // 启用重采样复选框切换时触发
+    void onResampleToggled(bool checked);
+
     // 点击确定按钮时的校验
     void onAccepted();
 
 private:
     Ui::FittingDataDialog *ui;
 
-    QStandardItemModel* m_projectModel; // 项目数据引用
-    QStandardItemModel* m_fileModel;    // 文件数据临时模型
+    MeasurementTableModel* m_projectModel; // 项目数据引用
+    MeasurementTableModel* m_fileModel;    // 文件数据临时模型
 
     // 更新列选择下拉框的内容
     void updateColumnComboBoxes(const QStringList& headers);
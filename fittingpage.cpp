@@ -5,24 +5,42 @@
  * 1. 实现了多页签管理逻辑（增删改）。
  * 2. 负责将全局的模型管理器和数据模型分发给具体的拟合子控件。
  * 3. 实现了拟合状态的序列化与反序列化，支持项目保存恢复。
+ * 4. 批量拟合：各页状态作为任务提交到 BatchFitQueue (可分发到远程拟合节点)，完成一个写回一个。
+ * 5. 批量报告：界面线程依次取出各页的报告内容 (离屏绘图)，编码与写文件交给 FittingReport。
+ * 6. 联合拟合：未在拟合中的页签交给 JointFitDialog，应用后的状态与批量拟合一样写回各页。
+ * 7. 加载项目时各页签先作为占位页 (只保存状态)，页面显示时只为当前页签创建拟合界面，其余页签切换到时再创建。
  */
 
 #include "fittingpage.h"
 #include "ui_fittingpage.h"
 #include "wt_fittingwidget.h"
 #include "modelparameter.h"
+#include "batchfitqueue.h"
+#include "fittingreport.h"
+#include "performancelogdialog.h"
+#include "jointfitdialog.h"
+#include <QFileDialog>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QJsonArray>
 #include <QDebug>
+#include <QThreadPool>
+#include <QSignalBlocker>
 
 FittingPage::FittingPage(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::FittingPage),
     m_modelManager(nullptr),
-    m_projectModel(nullptr)
+    m_projectModel(nullptr),
+    m_batchQueue(new BatchFitQueue(this)),
+    m_batchDone(0)
 {
     ui->setupUi(this);
+
+    connect(m_batchQueue, &BatchFitQueue::jobFinished, this, &FittingPage::onBatchJobFinished);
+    connect(m_batchQueue, &BatchFitQueue::allFinished, this, &FittingPage::onBatchAllFinished);
+    connect(&m_reportWatcher, &QFutureWatcher<QString>::finished, this, &FittingPage::onBatchReportFinished);
+    connect(ui->tabWidget, &QTabWidget::currentChanged, this, &FittingPage::onCurrentTabChanged);
 }
 
 FittingPage::~FittingPage()
@@ -41,7 +59,7 @@ void FittingPage::setModelManager(ModelManager *m)
 }
 
 // [新增] 设置项目数据模型，并分发给所有现有子页签
-void FittingPage::setProjectDataModel(QStandardItemModel *model)
+void FittingPage::setProjectDataModel(MeasurementTableModel* model)
 {
     m_projectModel = model;
     for(int i = 0; i < ui->tabWidget->count(); ++i) {
@@ -52,10 +70,18 @@ void FittingPage::setProjectDataModel(QStandardItemModel *model)
     }
 }
 
+void FittingPage::applyDataChanges(const DataChangeSet& changes)
+{
+    for(int i = 0; i < ui->tabWidget->count(); ++i) {
+        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
+        if(w) w->applyDataChanges(changes);
+    }
+}
+
 // 将观测数据设置到当前激活页签，若无则自动创建
 void FittingPage::setObservedDataToCurrent(const QVector<double> &t, const QVector<double> &p, const QVector<double> &d)
 {
-    FittingWidget* current = qobject_cast<FittingWidget*>(ui->tabWidget->currentWidget());
+    FittingWidget* current = fittingTab(ui->tabWidget->currentIndex());
     if (current) {
         current->setObservedData(t, p, d);
     } else {
@@ -75,6 +101,14 @@ void FittingPage::updateBasicParameters()
 
 // 创建新页签并初始化
 FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject &initData)
+{
+    FittingWidget* w = createFittingWidget(initData);
+    int index = ui->tabWidget->addTab(w, name);
+    ui->tabWidget->setCurrentIndex(index);
+    return w;
+}
+
+FittingWidget* FittingPage::createFittingWidget(const QJsonObject &initData)
 {
     FittingWidget* w = new FittingWidget(this);
 
@@ -83,17 +117,84 @@ FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject
     if(m_projectModel) w->setProjectDataModel(m_projectModel); // [新增] 注入数据模型
 
     connect(w, &FittingWidget::sigRequestSave, this, &FittingPage::onChildRequestSave);
-
-    int index = ui->tabWidget->addTab(w, name);
-    ui->tabWidget->setCurrentIndex(index);
+    connect(w, &FittingWidget::performanceRecorded, this, [this, w](FitPerformanceLog::Record record) {
+        int idx = ui->tabWidget->indexOf(w);
+        if(idx >= 0) record.analysis = ui->tabWidget->tabText(idx);
+        appendPerformanceRecord(record);
+    });
 
     if(!initData.isEmpty()) {
-        w->loadFittingState(initData);
+        w->setPendingState(initData);
     }
 
     return w;
 }
 
+void FittingPage::addDeferredTab(const QString &name, const QJsonObject &state)
+{
+    QWidget* page = new QWidget(this);
+    m_deferredTabs.insert(page, state);
+    ui->tabWidget->addTab(page, name);
+}
+
+FittingWidget* FittingPage::fittingTab(int index)
+{
+    QWidget* page = ui->tabWidget->widget(index);
+    if(!page) return nullptr;
+    if(!m_deferredTabs.contains(page)) return qobject_cast<FittingWidget*>(page);
+
+    const QJsonObject state = m_deferredTabs.take(page);
+    FittingWidget* w = createFittingWidget(state);
+    const bool current = ui->tabWidget->currentIndex() == index;
+    const QString name = ui->tabWidget->tabText(index);
+    // 先插入再移除，避免移除时当前页签跳到相邻页签
+    {
+        const QSignalBlocker blocker(ui->tabWidget);
+        ui->tabWidget->insertTab(index, w, name);
+        ui->tabWidget->removeTab(index + 1);
+        if(current) ui->tabWidget->setCurrentIndex(index);
+    }
+    for(auto it = m_batchTabs.begin(); it != m_batchTabs.end(); ++it) {
+        if(it.value() == page) it.value() = w;
+    }
+    page->deleteLater();
+    return w;
+}
+
+QJsonObject FittingPage::tabState(int index) const
+{
+    QWidget* page = ui->tabWidget->widget(index);
+    if(m_deferredTabs.contains(page)) return m_deferredTabs.value(page);
+    FittingWidget* w = qobject_cast<FittingWidget*>(page);
+    return w ? w->getJsonState() : QJsonObject();
+}
+
+void FittingPage::setTabState(QWidget *page, const QJsonObject &state)
+{
+    if(!page) return;
+    if(m_deferredTabs.contains(page)) m_deferredTabs[page] = state;
+    else if(FittingWidget* w = qobject_cast<FittingWidget*>(page)) w->setPendingState(state);
+}
+
+void FittingPage::removeTabAt(int index)
+{
+    QWidget* w = ui->tabWidget->widget(index);
+    m_deferredTabs.remove(w);
+    ui->tabWidget->removeTab(index);
+    delete w;
+}
+
+void FittingPage::onCurrentTabChanged(int index)
+{
+    if(index >= 0 && isVisible()) fittingTab(index);
+}
+
+void FittingPage::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if(ui->tabWidget->currentIndex() >= 0) fittingTab(ui->tabWidget->currentIndex());
+}
+
 QString FittingPage::generateUniqueName(const QString &baseName)
 {
     QString name = baseName;
@@ -134,11 +235,8 @@ void FittingPage::on_btnNewAnalysis_clicked()
         createNewTab(newName);
     } else {
         int indexToCopy = items.indexOf(item) - 1;
-        FittingWidget* source = qobject_cast<FittingWidget*>(ui->tabWidget->widget(indexToCopy));
-        if(source) {
-            QJsonObject state = source->getJsonState();
-            createNewTab(newName, state);
-        }
+        QJsonObject state = tabState(indexToCopy);
+        if(!state.isEmpty()) createNewTab(newName, state);
     }
 }
 
@@ -168,9 +266,7 @@ void FittingPage::on_btnDeleteAnalysis_clicked()
     }
 
     if(QMessageBox::question(this, "确认", "确定要删除当前分析页吗？\n此操作不可恢复。") == QMessageBox::Yes) {
-        QWidget* w = ui->tabWidget->widget(idx);
-        ui->tabWidget->removeTab(idx);
-        delete w;
+        removeTabAt(idx);
     }
 }
 
@@ -179,12 +275,10 @@ void FittingPage::saveAllFittingStates()
 {
     QJsonArray analysesArray;
     for(int i=0; i<ui->tabWidget->count(); ++i) {
-        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
-        if(w) {
-            QJsonObject pageObj = w->getJsonState();
-            pageObj["_tabName"] = ui->tabWidget->tabText(i);
-            analysesArray.append(pageObj);
-        }
+        QJsonObject pageObj = tabState(i);
+        if(pageObj.isEmpty() && !qobject_cast<FittingWidget*>(ui->tabWidget->widget(i))) continue;
+        pageObj["_tabName"] = ui->tabWidget->tabText(i);
+        analysesArray.append(pageObj);
     }
 
     QJsonObject root;
@@ -203,21 +297,195 @@ void FittingPage::loadAllFittingStates()
         return;
     }
 
-    ui->tabWidget->clear();
+    // 重建期间不因当前页签变化创建界面
+    const QSignalBlocker blocker(ui->tabWidget);
+    while(ui->tabWidget->count() > 0) removeTabAt(0);
 
+    // 各页签先作为占位页，当前页签在页面显示时创建界面
     if(root.contains("analyses") && root["analyses"].isArray()) {
         QJsonArray arr = root["analyses"].toArray();
         for(int i=0; i<arr.size(); ++i) {
             QJsonObject pageObj = arr[i].toObject();
             QString name = pageObj.contains("_tabName") ? pageObj["_tabName"].toString() : QString("Analysis %1").arg(i+1);
-            createNewTab(name, pageObj);
+            addDeferredTab(name, pageObj);
         }
     } else {
         // 兼容旧版单一状态
-        createNewTab("Analysis 1", root);
+        addDeferredTab("Analysis 1", root);
     }
 
     if(ui->tabWidget->count() == 0) createNewTab("Analysis 1");
+    ui->tabWidget->setCurrentIndex(0);
+    if(isVisible()) fittingTab(0);
+}
+
+// 批量拟合全部页签；运行中再次点击则取消
+void FittingPage::on_btnBatchFit_clicked()
+{
+    if(m_batchQueue->isRunning()) {
+        m_batchQueue->cancel();
+        ui->btnBatchFit->setEnabled(false);
+        return;
+    }
+
+    m_batchTabs.clear();
+    m_batchErrors.clear();
+    m_batchDone = 0;
+    QWidget* current = ui->tabWidget->currentWidget();
+    for(int i=0; i<ui->tabWidget->count(); ++i) {
+        QWidget* page = ui->tabWidget->widget(i);
+        FittingWidget* w = qobject_cast<FittingWidget*>(page);
+        if(!w && !m_deferredTabs.contains(page)) continue;
+        // 正在手动拟合的页签跳过，避免两个结果互相覆盖
+        if(w && w->isFitting()) {
+            m_batchErrors << QString("%1: 正在拟合，已跳过").arg(ui->tabWidget->tabText(i));
+            continue;
+        }
+        BatchFitQueue::Job job;
+        job.name = ui->tabWidget->tabText(i);
+        job.state = tabState(i);
+        job.priority = (page == current) ? 1 : 0;
+        m_batchTabs.insert(m_batchQueue->enqueue(job), page);
+    }
+    if(m_batchTabs.isEmpty()) {
+        QMessageBox::information(this, "批量拟合", "没有可拟合的分析页。");
+        return;
+    }
+    QString workerError = m_batchQueue->setRemoteWorkers(m_remoteWorkers, m_remoteWorkerToken);
+    if(!workerError.isEmpty()) {
+        m_batchQueue->setRemoteWorkers(QStringList());
+        m_batchErrors << QString("远程节点设置无效，本次只在本机拟合: %1").arg(workerError);
+    }
+    m_batchQueue->start();
+    updateBatchButton();
+}
+
+void FittingPage::onBatchJobFinished(int id, bool ok)
+{
+    ++m_batchDone;
+    BatchFitQueue::JobResult r = m_batchQueue->result(id);
+    QPointer<QWidget> page = m_batchTabs.value(id);
+    if(ok) appendPerformanceRecord(r.performance);
+    if(ok && page) {
+        // 当前显示的页签立即刷新，其余页签在下次显示时恢复
+        setTabState(page, r.state);
+    } else if(!ok) {
+        m_batchErrors << QString("%1: %2").arg(r.name, r.error);
+    }
+    updateBatchButton();
+}
+
+void FittingPage::onBatchAllFinished()
+{
+    m_batchTabs.clear();
+    updateBatchButton();
+
+    int total = m_batchDone;
+    m_batchDone = 0;
+    QString msg = QString("批量拟合结束，共 %1 个任务。").arg(total);
+    if(!m_batchErrors.isEmpty()) msg += "\n\n未完成：\n" + m_batchErrors.join("\n");
+    QMessageBox::information(this, "批量拟合", msg);
+}
+
+void FittingPage::appendPerformanceRecord(const FitPerformanceLog::Record& record)
+{
+    QString path = FitPerformanceLog::logPath(ModelParameter::instance()->getProjectFilePath());
+    if(path.isEmpty()) return;
+    QThreadPool::globalInstance()->start([path, record]() {
+        QString error;
+        if(!FitPerformanceLog::append(path, record, &error)) qDebug() << "性能日志写入失败:" << error;
+    });
+}
+
+void FittingPage::on_btnPerfLog_clicked()
+{
+    PerformanceLogDialog dlg(FitPerformanceLog::logPath(ModelParameter::instance()->getProjectFilePath()), this);
+    dlg.exec();
+}
+
+// 联合拟合：正在拟合 (手动或批量) 的页签不参与
+void FittingPage::on_btnJointFit_clicked()
+{
+    QStringList names;
+    QList<QJsonObject> states;
+    QList<QPointer<QWidget>> tabs;
+    QStringList skipped;
+    for(int i=0; i<ui->tabWidget->count(); ++i) {
+        QWidget* page = ui->tabWidget->widget(i);
+        FittingWidget* w = qobject_cast<FittingWidget*>(page);
+        if(!w && !m_deferredTabs.contains(page)) continue;
+        bool inBatch = false;
+        for(const QPointer<QWidget>& b : m_batchTabs) inBatch = inBatch || b == page;
+        if((w && w->isFitting()) || inBatch) {
+            skipped << ui->tabWidget->tabText(i);
+            continue;
+        }
+        names << ui->tabWidget->tabText(i);
+        states << tabState(i);
+        tabs << page;
+    }
+    if(names.size() < 2) {
+        QMessageBox::information(this, "联合拟合", "联合拟合至少需要两个不在拟合中的分析页。");
+        return;
+    }
+    if(!skipped.isEmpty()) {
+        QMessageBox::information(this, "联合拟合", "以下分析页正在拟合，不参与联合拟合：\n" + skipped.join("\n"));
+    }
+
+    JointFitDialog dlg(names, states, this);
+    if(dlg.exec() != QDialog::Accepted) return;
+    const QMap<int, QJsonObject> results = dlg.resultStates();
+    for(auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        // 当前显示的页签立即刷新，其余页签在下次显示时恢复
+        setTabState(tabs.value(it.key()), it.value());
+    }
+}
+
+// 全部页签导出为一份报告，每页一节
+void FittingPage::on_btnBatchReport_clicked()
+{
+    if(m_reportWatcher.isRunning()) return;
+
+    QString defaultDir = ModelParameter::instance()->getProjectPath();
+    if(defaultDir.isEmpty()) defaultDir = ".";
+    QString fileName = QFileDialog::getSaveFileName(this, "导出批量分析报告",
+                                                    defaultDir + "/WellTestBatchReport.doc",
+                                                    "Word 文档 (*.doc);;HTML 文件 (*.html)");
+    if(fileName.isEmpty()) return;
+
+    QList<FittingReport::Section> sections;
+    for(int i=0; i<ui->tabWidget->count(); ++i) {
+        // 报告需要离屏绘图，占位页签在此创建界面
+        FittingWidget* w = fittingTab(i);
+        if(!w) continue;
+        FittingReport::Section s = w->reportSection(FittingReport::IMAGE_SCALE);
+        s.title = ui->tabWidget->tabText(i);
+        sections.append(s);
+    }
+    if(sections.isEmpty()) return;
+
+    m_reportFileName = fileName;
+    ui->btnBatchReport->setEnabled(false);
+    ui->btnBatchReport->setText("生成报告中...");
+    m_reportWatcher.setFuture(FittingReport::start(fileName, FittingReport::currentProjectInfo(), sections));
+}
+
+void FittingPage::onBatchReportFinished()
+{
+    ui->btnBatchReport->setEnabled(true);
+    ui->btnBatchReport->setText("批量报告");
+    QString error = m_reportWatcher.future().resultCount() > 0 ? m_reportWatcher.result() : QString("报告生成已取消。");
+    if(error.isEmpty()) QMessageBox::information(this, "批量报告", "报告已保存至:\n" + m_reportFileName);
+    else QMessageBox::critical(this, "错误", error);
+}
+
+void FittingPage::updateBatchButton()
+{
+    ui->btnBatchFit->setEnabled(true);
+    if(m_batchQueue->isRunning())
+        ui->btnBatchFit->setText(QString("停止批量拟合 (%1/%2)").arg(m_batchDone).arg(m_batchTabs.size()));
+    else
+        ui->btnBatchFit->setText("批量拟合");
 }
 
 void FittingPage::onChildRequestSave()
@@ -231,12 +499,17 @@ void FittingPage::onChildRequestSave()
 // [新增] 实现重置功能
 void FittingPage::resetAnalysis()
 {
+    // 0. 停止进行中的批量拟合，结果不再写回
+    m_batchQueue->cancel();
+    m_batchTabs.clear();
+
     // 1. 循环删除所有页签及其内部的 Widget
     // QTabWidget::clear() 只移除不删除，所以必须手动 delete
-    while (ui->tabWidget->count() > 0) {
-        QWidget* w = ui->tabWidget->widget(0);
-        ui->tabWidget->removeTab(0); // 先从界面移除
-        delete w;                    // 再销毁对象
+    {
+        const QSignalBlocker blocker(ui->tabWidget);
+        while (ui->tabWidget->count() > 0) {
+            removeTabAt(0); // 先从界面移除，再销毁对象 (含占位页)
+        }
     }
 
     // 2. 重新创建一个默认的空白分析页，恢复初始状态
@@ -5,6 +5,12 @@
  * 1. 管理多个拟合分析页签 (FittingWidget)。
  * 2. 负责将项目级数据（如模型管理器、观测数据模型）传递给各个子页签。
  * 3. 实现多页签的创建、重命名、删除及保存恢复功能。
+ * 4. 通过 BatchFitQueue 在后台批量拟合全部页签，结果写回各页。
+ * 5. 批量报告：全部页签各为一节，经 FittingReport 在后台编码曲线图并写出一份报告。
+ * 6. 各页签与批量拟合完成后的性能记录在后台追加到项目性能日志，可在性能日志对话框中分组汇总。
+ * 7. 联合拟合：勾选的页签组成一个最小二乘问题，共用参数在各页取同一个值 (JointFitDialog)，完成后写回各页。
+ * 8. 从项目恢复的页签先是只保存状态的占位页，首次显示时才创建 FittingWidget；保存、批量与联合拟合直接使用占位页的状态。
+ * 9. 批量拟合可分发到远程拟合节点 (系统设置中配置)，远程结果与本机结果一样写回各页。
  */
 
 #ifndef FITTINGPAGE_H
@@ -13,11 +19,16 @@
 #include <QWidget>
 #include <QJsonObject>
 #include <QTabWidget>
-#include <QStandardItemModel> // 新增
+#include <QPointer>
+#include <QFutureWatcher>
 #include "modelmanager.h"
+#include "measurementtablemodel.h"
+#include "datachangetracker.h"
+#include "fitperformancelog.h"
 
 // 前置声明
 class FittingWidget;
+class BatchFitQueue;
 
 namespace Ui {
 class FittingPage;
@@ -37,7 +48,10 @@ public:
     void setModelManager(ModelManager* m);
 
     // 设置项目数据模型（用于传递给子页面的数据加载弹窗）
-    void setProjectDataModel(QStandardItemModel* model);
+    void setProjectDataModel(MeasurementTableModel* model);
+
+    // 项目表格修改 (已合并) 后分发给各页签，跟随表格的观测数据随之更新
+    void applyDataChanges(const DataChangeSet& changes);
 
     // 接收来自外部的数据并设置到当前激活页签
     void setObservedDataToCurrent(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
@@ -45,6 +59,9 @@ public:
     // 初始化/重置基本参数
     void updateBasicParameters();
 
+    // 批量拟合使用的远程拟合节点 ("主机:端口") 与其访问令牌，下一次批量拟合开始时生效；空列表表示只在本机拟合
+    void setRemoteWorkers(const QStringList& workers, const QString& token) { m_remoteWorkers = workers; m_remoteWorkerToken = token; }
+
     // 重置拟合分析
     void resetAnalysis();
 
@@ -59,17 +76,58 @@ private slots:
     void on_btnNewAnalysis_clicked();
     void on_btnRenameAnalysis_clicked();
     void on_btnDeleteAnalysis_clicked();
+    void on_btnBatchFit_clicked();
+    void on_btnBatchReport_clicked();
+    void on_btnPerfLog_clicked();
+    void on_btnJointFit_clicked();
+
+    // 批量拟合任务完成
+    void onBatchJobFinished(int id, bool ok);
+    void onBatchAllFinished();
 
     // 响应子页面的保存请求
     void onChildRequestSave();
 
+    // 切换到占位页签时创建其拟合界面
+    void onCurrentTabChanged(int index);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
 private:
     Ui::FittingPage *ui;
     ModelManager* m_modelManager;
-    QStandardItemModel* m_projectModel; // [新增] 保存模型指针
+    MeasurementTableModel* m_projectModel; // [新增] 保存模型指针
+
+    BatchFitQueue* m_batchQueue;
+    QMap<int, QPointer<QWidget>> m_batchTabs; // 任务编号 -> 对应页签 (拟合界面或占位页)
+    int m_batchDone;
+    QStringList m_batchErrors;
+    QStringList m_remoteWorkers;
+    QString m_remoteWorkerToken;
+    void updateBatchButton();
+
+    QFutureWatcher<QString> m_reportWatcher; // 批量报告的后台写入
+    QString m_reportFileName;
+    void onBatchReportFinished();
+
+    // 性能记录在全局线程池中追加到项目性能日志 (项目未保存时不记录)
+    void appendPerformanceRecord(const FitPerformanceLog::Record& record);
 
     // 内部函数：创建新页签
     FittingWidget* createNewTab(const QString& name, const QJsonObject& initData = QJsonObject());
+    FittingWidget* createFittingWidget(const QJsonObject& initData);
+
+    // 占位页签 (页面 -> 待恢复的状态)：FittingWidget 与图表在首次显示时才创建
+    QMap<QWidget*, QJsonObject> m_deferredTabs;
+    void addDeferredTab(const QString& name, const QJsonObject& state);
+    // 返回第 index 个页签的拟合界面，占位页先创建界面并替换 (批量、联合拟合中的页签指针随之更新)
+    FittingWidget* fittingTab(int index);
+    // 页签状态：占位页直接返回待恢复的状态，不创建界面
+    QJsonObject tabState(int index) const;
+    // 写回页签状态：拟合界面在下次显示时恢复，占位页替换待恢复的状态
+    void setTabState(QWidget* page, const QJsonObject& state);
+    void removeTabAt(int index);
     // 生成唯一的页签名称
     QString generateUniqueName(const QString& baseName);
 };
@@ -11,7 +11,7 @@ FittingParameterChart::FittingParameterChart(QTableWidget *parentTable, QObject
     if(m_table) {
         // [修改] 1. 增加序号列
         QStringList headers;
-        headers << "序号" << "参数名称" << "数值" << "单位";
+        headers << "序号" << "参数名称" << "数值" << "单位" << "P90 / P50 / P10";
         m_table->setColumnCount(headers.size());
         m_table->setHorizontalHeaderLabels(headers);
 
@@ -28,7 +28,8 @@ FittingParameterChart::FittingParameterChart(QTableWidget *parentTable, QObject
         m_table->setColumnWidth(0, 40);  // 序号
         m_table->setColumnWidth(1, 160); // 参数名称 (较宽)
         m_table->setColumnWidth(2, 80);  // 数值
-        // 单位列自动填充剩余
+        m_table->setColumnWidth(3, 60);  // 单位
+        // 不确定性列自动填充剩余
 
         m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
         m_table->setAlternatingRowColors(false); // 关闭自动交替，手动控制颜色
@@ -45,6 +46,7 @@ void FittingParameterChart::resetParams(ModelManager::ModelType type)
 {
     if(!m_modelManager) return;
     m_params.clear();
+    m_uncertainty.clear();
 
     QMap<QString, double> defaultMap = m_modelManager->getDefaultParameters(type);
     QMapIterator<QString, double> it(defaultMap);
@@ -80,6 +82,34 @@ void FittingParameterChart::setParameters(const QList<FitParameter> &params)
     refreshParamTable();
 }
 
+void FittingParameterChart::setUncertainty(const QList<ParameterUncertainty::Interval>& intervals)
+{
+    m_uncertainty.clear();
+    for(const auto& i : intervals) m_uncertainty.insert(i.name, i);
+    refreshParamTable();
+}
+
+void FittingParameterChart::clearUncertainty()
+{
+    if(m_uncertainty.isEmpty()) return;
+    m_uncertainty.clear();
+    if(!m_table) return;
+    // 只清空该列，不重建表格 (可能正处于单元格编辑的信号中)
+    m_table->blockSignals(true);
+    for(int i = 0; i < m_table->rowCount(); ++i) {
+        if(QTableWidgetItem* item = m_table->item(i, 4)) item->setText(QString());
+    }
+    m_table->blockSignals(false);
+}
+
+QString FittingParameterChart::uncertaintyText(const QString& name) const
+{
+    auto it = m_uncertainty.constFind(name);
+    if(it == m_uncertainty.constEnd()) return QString();
+    if(!it->identifiable) return "不可辨识";
+    return QString("%1 / %2 / %3").arg(it->p90, 0, 'g', 4).arg(it->p50, 0, 'g', 4).arg(it->p10, 0, 'g', 4);
+}
+
 void FittingParameterChart::switchModel(ModelManager::ModelType newType)
 {
     QMap<QString, double> oldValues;
@@ -189,6 +219,12 @@ void FittingParameterChart::addRowToTable(const FitParameter& p, int& serialNo,
     unitItem->setFlags(unitItem->flags() & ~Qt::ItemIsEditable);
     unitItem->setBackground(bgColor);
     m_table->setItem(row, 3, unitItem);
+
+    // 4. 不确定性列
+    QTableWidgetItem* rangeItem = new QTableWidgetItem(uncertaintyText(p.name));
+    rangeItem->setFlags(rangeItem->flags() & ~Qt::ItemIsEditable);
+    rangeItem->setBackground(bgColor);
+    m_table->setItem(row, 4, rangeItem);
 }
 
 // [修改] 参数名称映射表：严格对应中文名 (英文名) 格式
@@ -6,17 +6,8 @@
 #include <QList>
 #include <QMap>
 #include "modelmanager.h"
-
-// 定义拟合参数结构体
-struct FitParameter {
-    QString name;           // 参数内部英文名 (例如 "k", "S")
-    QString displayName;    // 参数显示中文名 (例如 "渗透率")
-    double value;           // 当前参数值
-    bool isFit;             // 是否参与拟合 (true: 变量, false: 定值)
-    double min;             // 参数下限
-    double max;             // 参数上限
-    bool isVisible;         // 是否在主界面表格中显示
-};
+#include "fittingcore.h" // FitParameter 定义
+#include "parameteruncertainty.h"
 
 // 拟合参数图表管理类
 class FittingParameterChart : public QObject
@@ -45,6 +36,13 @@ public:
     // 刷新表格显示（核心修改：排序、颜色、格式）
     void refreshParamTable();
 
+    // 不确定性分析结果 (P90 / P50 / P10 列)；参数值变化或重新拟合后应清除
+    void setUncertainty(const QList<ParameterUncertainty::Interval>& intervals);
+    void clearUncertainty();
+    bool hasUncertainty() const { return !m_uncertainty.isEmpty(); }
+    // 参数的区间显示文本，没有结果时为空
+    QString uncertaintyText(const QString& name) const;
+
     // 静态辅助函数：获取规范的参数显示信息
     static void getParamDisplayInfo(const QString& name, QString& chName, QString& symbol, QString& uniSymbol, QString& unit);
 
@@ -52,6 +50,7 @@ private:
     QTableWidget* m_table;
     ModelManager* m_modelManager;
     QList<FitParameter> m_params;
+    QMap<QString, ParameterUncertainty::Interval> m_uncertainty;
 
     // 辅助函数：添加单行数据
     void addRowToTable(const FitParameter& p, int& serialNo, bool highlight);
@@ -0,0 +1,161 @@
+/*
+ * 文件名: fittingreport.cpp
+ * 文件作用: 试井分析报告 (HTML / Word) 生成实现
+ * 功能描述:
+ * 1. 单页报告的版式与原导出一致 (1~5 节)；批量报告在基础信息之后按分析页分节，节内为三个小节。
+ * 2. 先并行编码全部曲线图，再依次写出各节；进度按已编码的图数与已写出的节数计。
+ */
+
+#include "fittingreport.h"
+#include "modelparameter.h"
+
+#include <QBuffer>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtConcurrent>
+
+namespace {
+
+const char* REPORT_STYLE =
+    "body { font-family: 'Times New Roman', 'SimSun', serif; }"
+    "h1 { text-align: center; font-size: 24px; font-weight: bold; margin-bottom: 20px; }"
+    "h2 { font-size: 18px; font-weight: bold; background-color: #f2f2f2; padding: 5px; border-left: 5px solid #2d89ef; margin-top: 20px; }"
+    "h3 { font-size: 16px; font-weight: bold; margin-top: 15px; }"
+    "table { width: 100%; border-collapse: collapse; margin-bottom: 15px; font-size: 14px; }"
+    "td, th { border: 1px solid #888; padding: 6px; text-align: center; }"
+    "th { background-color: #e0e0e0; font-weight: bold; }"
+    ".param-table td { text-align: left; padding-left: 10px; }";
+
+QByteArray encodePng(const QImage& image)
+{
+    QByteArray bytes;
+    if (image.isNull()) return bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return bytes.toBase64();
+}
+
+void writeProjectInfo(QTextStream& out, const FittingReport::ProjectInfo& info)
+{
+    out << "<h1>试井解释分析报告</h1>";
+    out << "<p style='text-align:right;'>生成日期: " << info.generated.toString("yyyy-MM-dd HH:mm") << "</p>";
+
+    out << "<h2>1. 基础信息</h2>";
+    out << "<table class='param-table'>";
+    out << "<tr><td width='30%'>项目路径</td><td>" << info.projectPath << "</td></tr>";
+    out << "<tr><td>测试产量 (q)</td><td>" << QString::number(info.q) << " m³/d</td></tr>";
+    out << "<tr><td>有效厚度 (h)</td><td>" << QString::number(info.h) << " m</td></tr>";
+    out << "<tr><td>孔隙度 (φ)</td><td>" << QString::number(info.phi) << "</td></tr>";
+    out << "<tr><td>井筒半径 (rw)</td><td>" << QString::number(info.rw) << " m</td></tr>";
+    out << "</table>";
+
+    out << "<h2>2. 流体高压物性 (PVT)</h2>";
+    out << "<table class='param-table'>";
+    out << "<tr><td width='30%'>原油粘度 (μ)</td><td>" << QString::number(info.mu) << " mPa·s</td></tr>";
+    out << "<tr><td>体积系数 (B)</td><td>" << QString::number(info.B) << "</td></tr>";
+    out << "<tr><td>综合压缩系数 (Ct)</td><td>" << QString::number(info.Ct) << " MPa⁻¹</td></tr>";
+    out << "</table>";
+}
+
+// tag 为三个小节的标题标签，numbers 为各小节编号：单页报告为 h2 与 3./4./5.，批量报告为 h3 与 3.1/3.2/3.3
+void writeSection(QTextStream& out, const FittingReport::Section& s, const QByteArray& png,
+                  const QString& tag, const QStringList& numbers)
+{
+    auto heading = [&](int i, const QString& text) {
+        out << "<" << tag << ">" << numbers[i] << " " << text << "</" << tag << ">";
+    };
+
+    heading(0, "解释模型选择");
+    out << "<p><strong>当前模型:</strong> " << s.modelName << "</p>";
+
+    heading(1, "拟合结果参数");
+    bool withUncertainty = !s.uncertaintyNote.isEmpty();
+    if (withUncertainty) out << "<p>参数不确定性: " << s.uncertaintyNote << "，P90 为低值、P10 为高值。</p>";
+    out << "<table>";
+    out << "<tr><th>参数名称</th><th>符号</th><th>拟合结果</th><th>单位</th>";
+    if (withUncertainty) out << "<th>P90 / P50 / P10</th>";
+    out << "</tr>";
+    for (const FittingReport::ParamRow& p : s.params) {
+        out << "<tr>";
+        out << "<td>" << p.displayName << "</td>";
+        out << "<td>" << p.symbol << "</td>";
+        if (p.isFit) out << "<td><strong>" << p.value << "</strong></td>";
+        else out << "<td>" << p.value << "</td>";
+        out << "<td>" << p.unit << "</td>";
+        if (withUncertainty) out << "<td>" << p.uncertainty << "</td>";
+        out << "</tr>";
+    }
+    out << "</table>";
+
+    heading(2, "拟合曲线图");
+    if (!png.isEmpty()) {
+        out << "<div style='text-align:center;'><img src='data:image/png;base64,";
+        out << QString::fromLatin1(png);
+        out << "' width='600' /></div>";
+    } else {
+        out << "<p>图像导出失败。</p>";
+    }
+}
+
+} // namespace
+
+FittingReport::ProjectInfo FittingReport::currentProjectInfo()
+{
+    ModelParameter* mp = ModelParameter::instance();
+    ProjectInfo info;
+    info.projectPath = mp->getProjectPath();
+    info.q = mp->getQ();
+    info.h = mp->getH();
+    info.phi = mp->getPhi();
+    info.rw = mp->getRw();
+    info.mu = mp->getMu();
+    info.B = mp->getB();
+    info.Ct = mp->getCt();
+    info.generated = QDateTime::currentDateTime();
+    return info;
+}
+
+QFuture<QString> FittingReport::start(const QString& fileName, const ProjectInfo& info, const QList<Section>& sections)
+{
+    return QtConcurrent::run([=](QPromise<QString>& promise) {
+        const int count = int(sections.size());
+        promise.setProgressRange(0, 2 * count + 1);
+
+        // 各图 PNG 编码相互独立，在线程池中并行 (本线程也参与)
+        QList<QByteArray> pngs = QtConcurrent::blockingMapped(sections, [](const Section& s) { return encodePng(s.chart); });
+        if (promise.isCanceled()) return;
+        promise.setProgressValue(count);
+
+        QSaveFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            promise.addResult("无法写入文件，请检查权限或文件是否被占用。");
+            return;
+        }
+        QTextStream out(&file);
+        out.setEncoding(QStringConverter::Utf8);
+        out << "<html><head><style>" << REPORT_STYLE << "</style></head><body>";
+        writeProjectInfo(out, info);
+
+        if (count == 1 && sections[0].title.isEmpty()) {
+            writeSection(out, sections[0], pngs[0], "h2", {"3.", "4.", "5."});
+        } else {
+            for (int i = 0; i < count; ++i) {
+                const QString n = QString::number(3 + i);
+                out << "<h2>" << n << ". " << sections[i].title << "</h2>";
+                writeSection(out, sections[i], pngs[i], "h3", {n + ".1", n + ".2", n + ".3"});
+                out.flush();
+                promise.setProgressValue(count + i + 1);
+            }
+        }
+        out << "</body></html>";
+        out.flush();
+
+        if (out.status() != QTextStream::Ok || !file.commit()) {
+            promise.addResult("无法写入文件，请检查权限或文件是否被占用。");
+            return;
+        }
+        promise.setProgressValue(2 * count + 1);
+        promise.addResult(QString());
+    });
+}
@@ -0,0 +1,57 @@
+/*
+ * 文件名: fittingreport.h
+ * 文件作用: 试井分析报告 (HTML / Word) 生成头文件
+ * 功能描述:
+ * 1. 报告内容分为项目基础信息与若干分析节 (解释模型、拟合参数、拟合曲线图)，
+ *    单页报告只有一节，批量报告每个分析页一节。
+ * 2. 各节内容 (含离屏绘制的曲线图 QImage) 由界面线程准备，PNG 编码在线程池中各图并行进行，
+ *    文档按节依次写入文件，不在内存中拼出整篇 HTML。
+ * 3. 写入在后台任务中进行，future 的结果为错误信息 (成功时为空)，经 QSaveFile 写入。
+ */
+
+#ifndef FITTINGREPORT_H
+#define FITTINGREPORT_H
+
+#include <QDateTime>
+#include <QFuture>
+#include <QImage>
+#include <QList>
+#include <QString>
+
+class FittingReport
+{
+public:
+    // 报告图的渲染倍率：800x600 的曲线图按 2 倍像素绘制，页面中仍按 600 宽显示
+    static constexpr double IMAGE_SCALE = 2.0;
+
+    struct ProjectInfo {
+        QString projectPath;
+        double q, h, phi, rw;
+        double mu, B, Ct;
+        QDateTime generated;
+    };
+
+    struct ParamRow {
+        QString displayName;
+        QString symbol;
+        QString value;
+        QString unit;
+        QString uncertainty; // 无不确定性结果时不输出该列
+        bool isFit;
+    };
+
+    struct Section {
+        QString title;            // 分析页名称，单页报告为空
+        QString modelName;
+        QString uncertaintyNote;  // 不确定性方法说明，为空表示没有不确定性列
+        QList<ParamRow> params;
+        QImage chart;             // 为空时报告中注明图像导出失败
+    };
+
+    // 从 ModelParameter 取当前项目的基础信息 (界面线程调用)
+    static ProjectInfo currentProjectInfo();
+
+    static QFuture<QString> start(const QString& fileName, const ProjectInfo& info, const QList<Section>& sections);
+};
+
+#endif // FITTINGREPORT_H
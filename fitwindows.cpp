@@ -0,0 +1,142 @@
+/*
+ * 文件名: fitwindows.cpp
+ * 文件作用: 拟合时间窗口与屏蔽点实现
+ * 功能描述:
+ * 1. 屏蔽点升序保存，按时间二分查找；逐点权重的计算量与窗口个数成正比。
+ */
+
+#include "fitwindows.h"
+
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 同一观测时间的相对误差 (JSON 往返与重采样前后的时间一致)
+const double TIME_TOLERANCE = 1e-9;
+
+bool sameTime(double a, double b)
+{
+    return std::abs(a - b) <= TIME_TOLERANCE * std::max(std::abs(a), std::abs(b));
+}
+}
+
+bool FitWindows::isEmpty() const
+{
+    return m_windows.isEmpty() && m_masked.isEmpty() && m_outsideWeight == 1.0;
+}
+
+void FitWindows::clear()
+{
+    m_windows.clear();
+    m_masked.clear();
+    m_outsideWeight = 1.0;
+}
+
+void FitWindows::addWindow(double start, double end, double weight)
+{
+    if (!(start > 0) || !(end > 0) || !std::isfinite(start) || !std::isfinite(end)) return;
+    Window w;
+    w.start = std::min(start, end);
+    w.end = std::max(start, end);
+    w.weight = std::isfinite(weight) ? std::max(0.0, weight) : 1.0;
+    m_windows.append(w);
+}
+
+void FitWindows::removeWindow(int index)
+{
+    if (index >= 0 && index < m_windows.size()) m_windows.remove(index);
+}
+
+void FitWindows::setOutsideWeight(double weight)
+{
+    m_outsideWeight = std::isfinite(weight) ? std::max(0.0, weight) : 1.0;
+}
+
+int FitWindows::maskedPosition(double time) const
+{
+    int pos = int(std::lower_bound(m_masked.constBegin(), m_masked.constEnd(), time) - m_masked.constBegin());
+    if (pos > 0 && sameTime(m_masked[pos - 1], time)) --pos;
+    return pos;
+}
+
+bool FitWindows::isMasked(double time) const
+{
+    int pos = maskedPosition(time);
+    return pos < m_masked.size() && sameTime(m_masked[pos], time);
+}
+
+bool FitWindows::toggleMasked(double time)
+{
+    if (!std::isfinite(time)) return false;
+    int pos = maskedPosition(time);
+    if (pos < m_masked.size() && sameTime(m_masked[pos], time)) {
+        m_masked.remove(pos);
+        return false;
+    }
+    m_masked.insert(pos, time);
+    return true;
+}
+
+void FitWindows::setMasked(const QVector<double>& times, bool masked)
+{
+    for (double t : times) {
+        if (!std::isfinite(t)) continue;
+        int pos = maskedPosition(t);
+        bool present = pos < m_masked.size() && sameTime(m_masked[pos], t);
+        if (masked && !present) m_masked.insert(pos, t);
+        else if (!masked && present) m_masked.remove(pos);
+    }
+}
+
+double FitWindows::weightAt(double t) const
+{
+    if (isMasked(t)) return 0.0;
+    for (int i = m_windows.size() - 1; i >= 0; --i) {
+        const Window& w = m_windows[i];
+        if (t >= w.start && t <= w.end) return w.weight;
+    }
+    return m_outsideWeight;
+}
+
+QVector<double> FitWindows::weights(const QVector<double>& time) const
+{
+    if (isEmpty()) return QVector<double>();
+    QVector<double> w(time.size());
+    for (int i = 0; i < time.size(); ++i) w[i] = weightAt(time[i]);
+    return w;
+}
+
+QJsonObject FitWindows::toJson() const
+{
+    QJsonObject obj;
+    QJsonArray windows;
+    for (const Window& w : m_windows) {
+        QJsonObject o;
+        o["start"] = w.start;
+        o["end"] = w.end;
+        o["weight"] = w.weight;
+        windows.append(o);
+    }
+    obj["windows"] = windows;
+    obj["outsideWeight"] = m_outsideWeight;
+    QJsonArray masked;
+    for (double t : m_masked) masked.append(t);
+    obj["masked"] = masked;
+    return obj;
+}
+
+FitWindows FitWindows::fromJson(const QJsonObject& obj)
+{
+    FitWindows fw;
+    for (const QJsonValue& v : obj["windows"].toArray()) {
+        QJsonObject o = v.toObject();
+        fw.addWindow(o["start"].toDouble(), o["end"].toDouble(), o["weight"].toDouble(1.0));
+    }
+    fw.setOutsideWeight(obj["outsideWeight"].toDouble(1.0));
+    QVector<double> masked;
+    for (const QJsonValue& v : obj["masked"].toArray()) masked.append(v.toDouble());
+    std::sort(masked.begin(), masked.end());
+    fw.setMasked(masked, true);
+    return fw;
+}
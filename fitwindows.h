@@ -0,0 +1,62 @@
+/*
+ * 文件名: fitwindows.h
+ * 文件作用: 拟合时间窗口与屏蔽点头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 时间窗口 [start, end] 给定窗口内各点的残差权重 (0 为不参与拟合)，重叠时后加入的窗口优先；窗口外取 outsideWeight。
+ * 2. 屏蔽点按观测时间记录 (相对误差 1e-9 内视为同一点)，不依赖点的序号，数据重采样或追加后仍然有效。
+ * 3. 权重按时间求值，拟合器对任意时间数组 (包括分级精度的重采样数据) 都由同一组规则得到逐点权重。
+ * 4. 随拟合页面状态以 JSON 保存与恢复。
+ */
+
+#ifndef FITWINDOWS_H
+#define FITWINDOWS_H
+
+#include <QVector>
+#include <QJsonObject>
+
+class FitWindows
+{
+public:
+    struct Window {
+        double start = 0.0;
+        double end = 0.0;
+        double weight = 1.0;
+    };
+
+    // 不含窗口与屏蔽点，且窗口外权重为 1 时，拟合使用全部数据，与未设置时相同
+    bool isEmpty() const;
+    void clear();
+
+    const QVector<Window>& windows() const { return m_windows; }
+    // start 与 end 顺序不限，不是正的有限值时忽略
+    void addWindow(double start, double end, double weight);
+    void removeWindow(int index);
+
+    double outsideWeight() const { return m_outsideWeight; }
+    void setOutsideWeight(double weight);
+
+    // 屏蔽点的时间 (升序)
+    const QVector<double>& maskedTimes() const { return m_masked; }
+    // 已屏蔽的时间再次加入时取消屏蔽，返回该时间最终是否被屏蔽
+    bool toggleMasked(double time);
+    void setMasked(const QVector<double>& times, bool masked);
+    bool isMasked(double time) const;
+
+    // 时间 t 处的权重 (被屏蔽为 0)
+    double weightAt(double t) const;
+    // 各时间点的权重；isEmpty() 时返回空数组 (全部为 1)
+    QVector<double> weights(const QVector<double>& time) const;
+
+    QJsonObject toJson() const;
+    static FitWindows fromJson(const QJsonObject& obj);
+
+private:
+    // 第一个不小于 time (按相对误差) 的屏蔽点位置
+    int maskedPosition(double time) const;
+
+    QVector<Window> m_windows;
+    double m_outsideWeight = 1.0;
+    QVector<double> m_masked;
+};
+
+#endif // FITWINDOWS_H
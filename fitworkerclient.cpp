@@ -0,0 +1,183 @@
+/*
+ * 文件名: fitworkerclient.cpp
+ * 文件作用: 远程拟合节点客户端实现
+ * 功能描述:
+ * 1. 任务负载只在第一次取得节点时编码一次，重试时复用；每次尝试使用新的连接与任务标签。
+ * 2. 结果中的状态不含观测数据，合并时放回任务原有的 observedData；性能记录来源标为 "remote"。
+ * 3. 因停止请求而断开不记为节点失败。
+ */
+
+#include "fitworkerclient.h"
+#include "fitworkerprotocol.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QTcpSocket>
+
+bool FitWorkerClient::parseEndpoint(const QString& text, Endpoint& endpoint)
+{
+    const QString s = text.trimmed();
+    QString host = s;
+    QString portText;
+    if (s.startsWith('[')) {
+        // [IPv6]:端口
+        int close = s.indexOf(']');
+        if (close < 0) return false;
+        host = s.mid(1, close - 1);
+        QString rest = s.mid(close + 1);
+        if (!rest.isEmpty()) {
+            if (!rest.startsWith(':')) return false;
+            portText = rest.mid(1);
+        }
+    } else if (s.count(':') == 1) {
+        int colon = s.indexOf(':');
+        host = s.left(colon);
+        portText = s.mid(colon + 1);
+    }
+    // 多个冒号且没有方括号时视为不带端口的 IPv6 地址
+    if (host.isEmpty()) return false;
+
+    quint16 port = FitWorkerProtocol::DEFAULT_PORT;
+    if (!portText.isEmpty()) {
+        bool ok = false;
+        uint value = portText.toUInt(&ok);
+        if (!ok || value == 0 || value > 65535) return false;
+        port = quint16(value);
+    }
+    endpoint.host = host;
+    endpoint.port = port;
+    return true;
+}
+
+FitWorkerClient::FitWorkerClient(const Settings& settings)
+    : m_settings(settings),
+    m_busy(settings.workers.size(), 0),
+    m_failedUntil(settings.workers.size(), 0),
+    m_nextTag(1)
+{
+    m_settings.jobsPerWorker = qMax(1, m_settings.jobsPerWorker);
+    m_settings.maxAttempts = qMax(1, m_settings.maxAttempts);
+}
+
+bool FitWorkerClient::execute(const BatchFitQueue::Job& job, const std::function<bool()>& stopped, BatchFitQueue::JobResult& result)
+{
+    QByteArray request;
+    QVector<int> tried;
+    for (int attempt = 0; attempt < m_settings.maxAttempts && !stopped(); ++attempt) {
+        int index = acquireWorker(tried);
+        if (index < 0) break;
+        tried.append(index);
+        if (request.isEmpty()) {
+            request = FitWorkerProtocol::encodeJob(job);
+            if (quint32(request.size()) > FitWorkerProtocol::MAX_PAYLOAD) {
+                releaseWorker(index, false);
+                qWarning().noquote() << QString("%1 的任务数据 %2 MB 超过节点单帧上限，在本机拟合")
+                                        .arg(job.name).arg(request.size() >> 20);
+                return false;
+            }
+        }
+
+        const quint32 tag = quint32(m_nextTag.fetchAndAddRelaxed(1));
+        QString error;
+        bool ok = runOn(index, tag, request, stopped, result, error);
+        releaseWorker(index, !ok && !stopped());
+        if (ok) {
+            result.name = job.name;
+            if (job.state.contains("observedData")) result.state["observedData"] = job.state["observedData"];
+            result.performance.source = "remote";
+            return true;
+        }
+        if (!stopped()) {
+            const Endpoint& w = m_settings.workers[index];
+            qWarning().noquote() << QString("拟合节点 %1:%2 执行 %3 失败: %4").arg(w.host).arg(w.port).arg(job.name, error);
+        }
+    }
+    return false;
+}
+
+int FitWorkerClient::acquireWorker(const QVector<int>& tried)
+{
+    QMutexLocker locker(&m_mutex);
+    const int n = m_settings.workers.size();
+    if (n == 0) return -1;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int start = m_nextWorker++ % n;
+    int best = -1;
+    for (int k = 0; k < n; ++k) {
+        int i = (start + k) % n;
+        if (tried.contains(i) || m_busy[i] >= m_settings.jobsPerWorker || m_failedUntil[i] > now) continue;
+        if (best < 0 || m_busy[i] < m_busy[best]) best = i;
+    }
+    if (best >= 0) ++m_busy[best];
+    return best;
+}
+
+void FitWorkerClient::releaseWorker(int index, bool failed)
+{
+    QMutexLocker locker(&m_mutex);
+    --m_busy[index];
+    if (failed) m_failedUntil[index] = QDateTime::currentMSecsSinceEpoch() + m_settings.retryDelayMs;
+}
+
+bool FitWorkerClient::runOn(int index, quint32 tag, const QByteArray& request, const std::function<bool()>& stopped,
+                            BatchFitQueue::JobResult& result, QString& error)
+{
+    const Endpoint& w = m_settings.workers[index];
+    QTcpSocket socket;
+    socket.connectToHost(w.host, w.port);
+    if (!socket.waitForConnected(m_settings.connectTimeoutMs)) {
+        error = socket.errorString();
+        return false;
+    }
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    socket.write(FitWorkerProtocol::frame(FitWorkerProtocol::HelloFrame, tag, m_settings.token.toUtf8()));
+    socket.write(FitWorkerProtocol::frame(FitWorkerProtocol::JobFrame, tag, request));
+
+    // 短间隔等待，以便及时响应停止请求与超时
+    const int pollMs = 200;
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray buffer;
+    for (;;) {
+        if (stopped()) {
+            socket.abort();
+            error = "已取消";
+            return false;
+        }
+        if (m_settings.jobTimeoutMs > 0 && timer.elapsed() > m_settings.jobTimeoutMs) {
+            socket.abort();
+            error = "等待结果超时";
+            return false;
+        }
+        bool progressed = socket.bytesToWrite() > 0 ? socket.waitForBytesWritten(pollMs) : socket.waitForReadyRead(pollMs);
+        if (socket.bytesAvailable() == 0) {
+            if (!progressed && socket.state() != QAbstractSocket::ConnectedState) {
+                error = "连接已断开";
+                return false;
+            }
+            continue;
+        }
+        buffer.append(socket.readAll());
+
+        FitWorkerProtocol::Frame frame;
+        int got = FitWorkerProtocol::takeFrame(buffer, frame, &error);
+        if (got < 0) {
+            socket.abort();
+            return false;
+        }
+        if (got == 0) continue;
+        if (frame.type == FitWorkerProtocol::ErrorFrame) {
+            error = QString::fromUtf8(frame.payload);
+            return false;
+        }
+        if (frame.type != FitWorkerProtocol::ResultFrame || frame.tag != tag) {
+            error = "节点返回的结果与任务不符";
+            return false;
+        }
+        if (!FitWorkerProtocol::decodeResult(frame.payload, result, &error)) return false;
+        socket.disconnectFromHost();
+        return true;
+    }
+}
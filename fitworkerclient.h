@@ -0,0 +1,70 @@
+/*
+ * 文件名: fitworkerclient.h
+ * 文件作用: 远程拟合节点客户端头文件
+ * 功能描述:
+ * 1. 把批量拟合任务发给远程节点 (FitWorkerServer，WellTest --worker 启动) 并同步等待结果，供 BatchFitQueue 的工作线程调用。
+ * 2. 按各节点正在执行的任务数选择最空闲的节点；连接失败、断开、超时或协议错误时换节点重试，
+ *    失败的节点在一段时间内不再分配任务。
+ * 3. 每个连接先发送握手帧 (共享访问令牌)，再发送任务帧；任务负载超过协议帧上限时不发送，由调用方在本机拟合。
+ * 4. 使用阻塞套接字 (waitFor*)，不需要事件循环；等待期间定期检查停止请求，停止时断开连接，节点随之停止该任务。
+ */
+
+#ifndef FITWORKERCLIENT_H
+#define FITWORKERCLIENT_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QAtomicInt>
+#include <functional>
+#include "batchfitqueue.h"
+
+class FitWorkerClient
+{
+public:
+    struct Endpoint {
+        QString host;
+        quint16 port = 0;
+    };
+
+    struct Settings {
+        QList<Endpoint> workers;
+        QString token;                  // 节点的共享访问令牌 (WellTest --worker 启动时给出)
+        int jobsPerWorker = 1;          // 每个节点同时执行的任务数
+        int maxAttempts = 3;            // 一个任务最多尝试的节点数，都失败后由调用方在本机拟合
+        int connectTimeoutMs = 3000;
+        int jobTimeoutMs = 0;           // 单个任务等待结果的上限，0 表示不限 (节点断开时立即换节点)
+        int retryDelayMs = 30000;       // 失败的节点在该时间内不再分配任务
+    };
+
+    // "主机:端口" 或 "主机" (使用默认端口)
+    static bool parseEndpoint(const QString& text, Endpoint& endpoint);
+
+    explicit FitWorkerClient(const Settings& settings);
+
+    // 全部节点可同时执行的任务数
+    int capacity() const { return m_settings.workers.size() * m_settings.jobsPerWorker; }
+
+    /**
+     * @brief 在调用线程中远程执行一个任务 (可在多个线程中同时调用)
+     * @return true 时 result 为节点的拟合结果 (拟合本身可能失败)；没有空闲节点、全部尝试失败或已停止时返回 false
+     */
+    bool execute(const BatchFitQueue::Job& job, const std::function<bool()>& stopped, BatchFitQueue::JobResult& result);
+
+private:
+    // 取得空闲且未处于失败等待期的节点 (跳过已尝试过的)，没有时返回 -1
+    int acquireWorker(const QVector<int>& tried);
+    void releaseWorker(int index, bool failed);
+    // 在一个节点上执行；返回 false 时 error 给出原因
+    bool runOn(int index, quint32 tag, const QByteArray& request, const std::function<bool()>& stopped,
+               BatchFitQueue::JobResult& result, QString& error);
+
+    Settings m_settings;
+    QMutex m_mutex;
+    QVector<int> m_busy;                // 各节点正在执行的任务数
+    QVector<qint64> m_failedUntil;      // 各节点失败等待期的结束时刻 (ms since epoch)
+    int m_nextWorker = 0;               // 空闲程度相同时轮流从不同节点开始选
+    QAtomicInt m_nextTag;
+};
+
+#endif // FITWORKERCLIENT_H
@@ -0,0 +1,173 @@
+/*
+ * 文件名: fitworkerprotocol.cpp
+ * 文件作用: 远程拟合节点通信协议实现
+ * 功能描述:
+ * 1. 帧头逐字段按小端序读写；负载用 QDataStream (小端序、Qt_5_15 格式) 读写。
+ * 2. 分析页状态转为 CBOR 发送，比 JSON 文本小且解析快；观测数据不进入 JSON，按列整块拷贝为小端 double。
+ */
+
+#include "fitworkerprotocol.h"
+
+#include <QCborValue>
+#include <QCborMap>
+#include <QDataStream>
+#include <QJsonArray>
+#include <QtEndian>
+
+namespace {
+
+QByteArray columnBytes(const QVector<double>& column)
+{
+    QByteArray bytes(column.size() * int(sizeof(double)), Qt::Uninitialized);
+    qToLittleEndian<double>(column.constData(), column.size(), bytes.data());
+    return bytes;
+}
+
+bool readColumn(const QByteArray& bytes, QVector<double>& column)
+{
+    if (bytes.size() % int(sizeof(double)) != 0) return false;
+    column.resize(bytes.size() / int(sizeof(double)));
+    qFromLittleEndian<double>(bytes.constData(), column.size(), column.data());
+    return true;
+}
+
+QVector<double> jsonColumn(const QJsonArray& arr)
+{
+    QVector<double> column;
+    column.reserve(arr.size());
+    for (const auto& v : arr) column.append(v.toDouble());
+    return column;
+}
+
+QByteArray toCbor(const QJsonObject& obj)
+{
+    return QCborValue::fromJsonValue(obj).toCbor();
+}
+
+bool fromCbor(const QByteArray& bytes, QJsonObject& obj)
+{
+    QCborParserError parseError;
+    QCborValue value = QCborValue::fromCbor(bytes, &parseError);
+    if (parseError.error != QCborError::NoError || !value.isMap()) return false;
+    obj = value.toMap().toJsonObject();
+    return true;
+}
+
+void setupStream(QDataStream& stream)
+{
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+} // namespace
+
+QByteArray FitWorkerProtocol::frame(FrameType type, quint32 tag, const QByteArray& payload)
+{
+    QByteArray bytes;
+    bytes.reserve(HEADER_SIZE + payload.size());
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    setupStream(out);
+    out << MAGIC << VERSION << quint8(type) << tag << quint32(payload.size());
+    bytes.append(payload);
+    return bytes;
+}
+
+int FitWorkerProtocol::takeFrame(QByteArray& buffer, Frame& frame, QString* error, quint32 maxPayload)
+{
+    if (buffer.size() < HEADER_SIZE) return 0;
+    const uchar* header = reinterpret_cast<const uchar*>(buffer.constData());
+    const quint32 magic = qFromLittleEndian<quint32>(header);
+    const quint16 version = qFromLittleEndian<quint16>(header + 4);
+    const quint8 type = header[6];
+    const quint32 tag = qFromLittleEndian<quint32>(header + 7);
+    const quint32 length = qFromLittleEndian<quint32>(header + 11);
+
+    const quint32 limit = maxPayload < MAX_PAYLOAD ? maxPayload : MAX_PAYLOAD;
+    QString reason;
+    if (magic != MAGIC) reason = "不是拟合节点协议数据";
+    else if (version != VERSION) reason = QString("协议版本不符 (%1，本机为 %2)").arg(version).arg(VERSION);
+    else if (type < JobFrame || type > HelloFrame) reason = QString("未知帧类型 %1").arg(type);
+    else if (length > limit) reason = QString("帧长度 %1 超过上限 %2").arg(length).arg(limit);
+    if (!reason.isEmpty()) {
+        if (error) *error = reason;
+        return -1;
+    }
+    if (quint32(buffer.size() - HEADER_SIZE) < length) return 0;
+
+    frame.type = FrameType(type);
+    frame.tag = tag;
+    frame.payload = buffer.mid(HEADER_SIZE, int(length));
+    buffer.remove(0, HEADER_SIZE + int(length));
+    return 1;
+}
+
+int FitWorkerProtocol::headerType(const QByteArray& buffer)
+{
+    if (buffer.size() < HEADER_SIZE) return 0;
+    return quint8(buffer[6]);
+}
+
+QByteArray FitWorkerProtocol::encodeJob(const BatchFitQueue::Job& job)
+{
+    QJsonObject state = job.state;
+    QVector<double> t = job.time, p = job.pressure, d = job.derivative;
+    if (t.isEmpty()) {
+        QJsonObject obs = state["observedData"].toObject();
+        t = jsonColumn(obs["time"].toArray());
+        p = jsonColumn(obs["pressure"].toArray());
+        d = jsonColumn(obs["derivative"].toArray());
+    }
+    state.remove("observedData");
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    setupStream(out);
+    out << job.name << qint32(job.priority) << toCbor(state)
+        << columnBytes(t) << columnBytes(p) << columnBytes(d);
+    return payload;
+}
+
+bool FitWorkerProtocol::decodeJob(const QByteArray& payload, BatchFitQueue::Job& job, QString* error)
+{
+    QDataStream in(payload);
+    setupStream(in);
+    qint32 priority = 0;
+    QByteArray state, t, p, d;
+    in >> job.name >> priority >> state >> t >> p >> d;
+    job.priority = priority;
+    bool ok = in.status() == QDataStream::Ok && fromCbor(state, job.state)
+              && readColumn(t, job.time) && readColumn(p, job.pressure) && readColumn(d, job.derivative);
+    if (!ok && error) *error = "任务数据无法解析";
+    return ok;
+}
+
+QByteArray FitWorkerProtocol::encodeResult(const BatchFitQueue::JobResult& result)
+{
+    QJsonObject state = result.state;
+    state.remove("observedData");
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    setupStream(out);
+    out << result.ok << result.error << result.mse << qint32(result.iterations) << qint64(result.elapsedMs)
+        << toCbor(state) << toCbor(result.performance.toJson());
+    return payload;
+}
+
+bool FitWorkerProtocol::decodeResult(const QByteArray& payload, BatchFitQueue::JobResult& result, QString* error)
+{
+    QDataStream in(payload);
+    setupStream(in);
+    qint32 iterations = 0;
+    qint64 elapsedMs = 0;
+    QByteArray state, performance;
+    in >> result.ok >> result.error >> result.mse >> iterations >> elapsedMs >> state >> performance;
+    result.iterations = iterations;
+    result.elapsedMs = elapsedMs;
+    QJsonObject perf;
+    bool ok = in.status() == QDataStream::Ok && fromCbor(state, result.state) && fromCbor(performance, perf);
+    if (ok) result.performance = FitPerformanceLog::Record::fromJson(perf);
+    else if (error) *error = "结果数据无法解析";
+    return ok;
+}
@@ -0,0 +1,63 @@
+/*
+ * 文件名: fitworkerprotocol.h
+ * 文件作用: 远程拟合节点通信协议头文件 (不依赖界面与网络模块)
+ * 功能描述:
+ * 1. 帧格式：固定 15 字节帧头 (魔数、协议版本、帧类型、任务标签、负载长度，小端序) 加负载，同一连接上可连续收发多帧。
+ * 2. 任务帧：任务名称、优先级、去掉 observedData 的分析页状态 (CBOR)，观测数据的时间/压差/导数三列为小端 double 原始字节。
+ * 3. 结果帧：状态、误差、迭代次数、耗时、写回拟合值的状态 (CBOR，不含观测数据) 与性能记录 (CBOR)。
+ * 4. 错误帧：负载为 UTF-8 原因 (帧头无效、版本不符、令牌不符、负载无法解析)，收到后发送方关闭连接。
+ * 5. 握手帧：连接后客户端先发送共享访问令牌 (UTF-8)，节点核对通过前只接受不超过 MAX_TOKEN_SIZE 的握手帧。
+ */
+
+#ifndef FITWORKERPROTOCOL_H
+#define FITWORKERPROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+#include "batchfitqueue.h"
+
+class FitWorkerProtocol
+{
+public:
+    enum FrameType : quint8 {
+        JobFrame = 1,       // 客户端 -> 节点：拟合任务
+        ResultFrame = 2,    // 节点 -> 客户端：拟合结果
+        ErrorFrame = 3,     // 双向：协议错误
+        HelloFrame = 4      // 客户端 -> 节点：访问令牌 (连接后的第一帧)
+    };
+
+    struct Frame {
+        FrameType type = ErrorFrame;
+        quint32 tag = 0;    // 任务标签 (客户端分配，结果帧原样带回)
+        QByteArray payload;
+    };
+
+    static const quint32 MAGIC = 0x57465457;            // "WTFW"
+    static const quint16 VERSION = 2;
+    static const int HEADER_SIZE = 15;
+    static const quint32 MAX_PAYLOAD = 64u << 20;       // 单帧负载上限 (64 MB，约 270 万个观测点)
+    static const quint32 MAX_TOKEN_SIZE = 256;          // 握手帧负载上限
+    static const quint16 DEFAULT_PORT = 5710;
+
+    // 组装一帧 (帧头 + 负载)
+    static QByteArray frame(FrameType type, quint32 tag, const QByteArray& payload);
+    /**
+     * @brief 从接收缓冲区取出一帧，取出的字节从 buffer 删除
+     * @param maxPayload 负载长度上限，帧头声明的长度超过时不等待负载，直接判为无效
+     * @return 1 取出一帧；0 数据尚不完整；-1 帧头无效 (error 给出原因，连接应关闭)
+     */
+    static int takeFrame(QByteArray& buffer, Frame& frame, QString* error = nullptr, quint32 maxPayload = MAX_PAYLOAD);
+    // 缓冲区中下一帧的帧类型，帧头尚不完整时返回 0 (不校验魔数与版本，由 takeFrame 校验)
+    static int headerType(const QByteArray& buffer);
+
+    // 任务负载：观测数据优先取 job 的二进制列，为空时取 state 中的 observedData
+    static QByteArray encodeJob(const BatchFitQueue::Job& job);
+    // 解出的任务观测数据在 job.time/pressure/derivative 中，state 不含 observedData
+    static bool decodeJob(const QByteArray& payload, BatchFitQueue::Job& job, QString* error = nullptr);
+
+    // 结果负载：state 中的 observedData 不发送
+    static QByteArray encodeResult(const BatchFitQueue::JobResult& result);
+    static bool decodeResult(const QByteArray& payload, BatchFitQueue::JobResult& result, QString* error = nullptr);
+};
+
+#endif // FITWORKERPROTOCOL_H
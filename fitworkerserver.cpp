@@ -0,0 +1,168 @@
+/*
+ * 文件名: fitworkerserver.cpp
+ * 文件作用: 远程拟合节点服务端实现
+ * 功能描述:
+ * 1. 套接字只在服务对象所在线程读写；拟合在线程池中完成后经排队调用回到该线程发送结果。
+ * 2. 各任务使用队列的默认拟合选项，与本机批量拟合的结果一致。
+ * 3. 未通过令牌核对的连接每次只从套接字读取到一个握手帧为止，令牌按定长比较，比较时间与不符的位置无关。
+ */
+
+#include "fitworkerserver.h"
+#include "fitworkerprotocol.h"
+
+#include <QMetaObject>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+namespace {
+
+bool sameToken(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) return false;
+    uchar diff = 0;
+    for (int i = 0; i < a.size(); ++i) diff |= uchar(a[i]) ^ uchar(b[i]);
+    return diff == 0;
+}
+
+} // namespace
+
+FitWorkerServer::FitWorkerServer(int maxConcurrentJobs, const QString& token, QObject* parent)
+    : QObject(parent),
+    m_server(new QTcpServer(this)),
+    m_token(token.toUtf8()),
+    m_shutdown(0),
+    m_activeJobs(0)
+{
+    m_pool.setMaxThreadCount(qMax(1, maxConcurrentJobs));
+    connect(m_server, &QTcpServer::newConnection, this, &FitWorkerServer::onNewConnection);
+}
+
+FitWorkerServer::~FitWorkerServer()
+{
+    m_shutdown = 1;
+    m_pool.waitForDone();
+}
+
+bool FitWorkerServer::listen(const QHostAddress& address, quint16 port)
+{
+    return m_server->listen(address, port);
+}
+
+quint16 FitWorkerServer::serverPort() const
+{
+    return m_server->serverPort();
+}
+
+QString FitWorkerServer::errorString() const
+{
+    return m_server->errorString();
+}
+
+void FitWorkerServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        Connection connection;
+        connection.stop = QSharedPointer<QAtomicInt>::create(0);
+        m_connections.insert(socket, connection);
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { onDisconnected(socket); });
+    }
+}
+
+void FitWorkerServer::onReadyRead(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) return;
+    // 握手之前只读到握手帧的最大长度，核对通过后再读取其余数据
+    while (!it->authenticated) {
+        const int room = FitWorkerProtocol::HEADER_SIZE + int(FitWorkerProtocol::MAX_TOKEN_SIZE) - it->buffer.size();
+        if (room <= 0 || socket->bytesAvailable() == 0) return;
+        it->buffer.append(socket->read(room));
+        if (!takeFrames(socket, *it)) return;
+    }
+    it->buffer.append(socket->readAll());
+    takeFrames(socket, *it);
+}
+
+bool FitWorkerServer::takeFrames(QTcpSocket* socket, Connection& connection)
+{
+    FitWorkerProtocol::Frame frame;
+    QString error;
+    int got;
+    for (;;) {
+        // 握手之前帧头不是握手帧时不等待负载
+        if (!connection.authenticated && FitWorkerProtocol::headerType(connection.buffer) > 0
+            && FitWorkerProtocol::headerType(connection.buffer) != FitWorkerProtocol::HelloFrame) {
+            sendError(socket, 0, "连接后须先发送访问令牌");
+            return false;
+        }
+        const quint32 limit = connection.authenticated ? FitWorkerProtocol::MAX_PAYLOAD : FitWorkerProtocol::MAX_TOKEN_SIZE;
+        got = FitWorkerProtocol::takeFrame(connection.buffer, frame, &error, limit);
+        if (got <= 0) break;
+        if (!connection.authenticated) {
+            if (m_token.isEmpty() || !sameToken(frame.payload, m_token)) {
+                sendError(socket, frame.tag, "访问令牌无效");
+                return false;
+            }
+            connection.authenticated = true;
+            continue;
+        }
+        if (frame.type != FitWorkerProtocol::JobFrame) {
+            sendError(socket, frame.tag, "节点只接受任务帧");
+            return false;
+        }
+        BatchFitQueue::Job job;
+        if (!FitWorkerProtocol::decodeJob(frame.payload, job, &error)) {
+            sendError(socket, frame.tag, error);
+            return false;
+        }
+        startJob(socket, frame.tag, job);
+    }
+    if (got < 0) {
+        sendError(socket, 0, error);
+        return false;
+    }
+    return true;
+}
+
+void FitWorkerServer::onDisconnected(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it != m_connections.end()) {
+        it->stop->storeRelaxed(1);
+        m_connections.erase(it);
+    }
+    socket->deleteLater();
+}
+
+void FitWorkerServer::startJob(QTcpSocket* socket, quint32 tag, const BatchFitQueue::Job& job)
+{
+    QSharedPointer<QAtomicInt> stop = m_connections.value(socket).stop;
+    QPointer<QTcpSocket> target(socket);
+    const QString peer = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+    ++m_activeJobs;
+    emit message(QString("收到任务: %1  %2 点  来自 %3  (执行中 %4)").arg(job.name).arg(job.time.size()).arg(peer).arg(m_activeJobs));
+
+    m_pool.start([this, target, tag, job, stop]() {
+        auto stopped = [this, stop]() { return stop->loadRelaxed() != 0 || m_shutdown.loadRelaxed() != 0; };
+        BatchFitQueue::JobResult result = BatchFitQueue::executeJob(job, BatchFitQueue::defaultFitOptions(), stopped);
+        QByteArray reply = FitWorkerProtocol::frame(FitWorkerProtocol::ResultFrame, tag, FitWorkerProtocol::encodeResult(result));
+        QString summary = result.ok ? QString("完成: %1  MSE=%2  迭代 %3 次  %4 ms").arg(result.name).arg(result.mse, 0, 'e', 3)
+                                                 .arg(result.iterations).arg(result.elapsedMs)
+                                    : QString("失败: %1  %2").arg(result.name, result.error);
+        QMetaObject::invokeMethod(this, [this, target, reply, summary]() {
+            --m_activeJobs;
+            if (target && target->state() == QAbstractSocket::ConnectedState) target->write(reply);
+            emit message(summary);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void FitWorkerServer::sendError(QTcpSocket* socket, quint32 tag, const QString& reason)
+{
+    emit message(QString("协议错误 (%1): %2").arg(socket->peerAddress().toString(), reason));
+    socket->write(FitWorkerProtocol::frame(FitWorkerProtocol::ErrorFrame, tag, reason.toUtf8()));
+    socket->disconnectFromHost();
+}
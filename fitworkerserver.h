@@ -0,0 +1,65 @@
+/*
+ * 文件名: fitworkerserver.h
+ * 文件作用: 远程拟合节点服务端头文件
+ * 功能描述:
+ * 1. 监听 TCP 端口，接收 FitWorkerProtocol 任务帧，用批量拟合队列相同的流程 (BatchFitQueue::executeJob) 拟合，回送结果帧。
+ * 2. 任务在节点自有的线程池中执行，同时执行的任务数有上限，多出的任务排队；一个连接上可连续提交多个任务。
+ * 3. 连接断开时该连接上未完成的任务停止 (客户端取消或换节点)；帧头无效时回送错误帧并关闭连接。
+ * 4. 连接的第一帧须为携带共享访问令牌的握手帧，令牌核对通过前只读取握手帧大小以内的数据，不接受任务。
+ */
+
+#ifndef FITWORKERSERVER_H
+#define FITWORKERSERVER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include "batchfitqueue.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+class FitWorkerServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // token 为客户端须出示的共享访问令牌 (不能为空)
+    FitWorkerServer(int maxConcurrentJobs, const QString& token, QObject* parent = nullptr);
+    ~FitWorkerServer();
+
+    bool listen(const QHostAddress& address, quint16 port);
+    quint16 serverPort() const;
+    QString errorString() const;
+
+signals:
+    // 连接与任务的运行记录 (在服务对象所在线程发出)
+    void message(const QString& text);
+
+private:
+    struct Connection {
+        QByteArray buffer;
+        bool authenticated = false;
+        QSharedPointer<QAtomicInt> stop;    // 连接断开时置位，该连接上的任务随之停止
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    void onDisconnected(QTcpSocket* socket);
+    bool takeFrames(QTcpSocket* socket, Connection& connection);
+    void startJob(QTcpSocket* socket, quint32 tag, const BatchFitQueue::Job& job);
+    void sendError(QTcpSocket* socket, quint32 tag, const QString& reason);
+
+    QTcpServer* m_server;
+    QThreadPool m_pool;
+    QByteArray m_token;
+    QHash<QTcpSocket*, Connection> m_connections;
+    QAtomicInt m_shutdown;
+    int m_activeJobs;
+};
+
+#endif // FITWORKERSERVER_H
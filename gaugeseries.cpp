@@ -0,0 +1,131 @@
+/*
+ * 文件名: gaugeseries.cpp
+ * 文件作用: 实时压力计数据的滑动窗口序列实现
+ * 功能描述:
+ * 1. 窗口端点与 DerivativeEngine::buildWindows 的单调双指针相同：左指针跨批次保留，
+ *    右端点只对尚无右端点的末端点继续向后查找。
+ * 2. 导数逐点由 DerivativeEngine::bourdetPoint 计算；尚无右端点且有左端点的旧点只依赖左侧，保留原值。
+ */
+
+#include "gaugeseries.h"
+#include "derivativeengine.h"
+#include <cmath>
+
+void GaugeSeries::clear()
+{
+    m_time.clear();
+    m_deltaP.clear();
+    m_derivative.clear();
+    m_lnT.clear();
+    m_left.clear();
+    m_right.clear();
+    m_leftCursor = -1;
+    m_openFrom = 0;
+    m_hasReference = false;
+    m_referencePressure = 0.0;
+    m_lastRecomputed = 0;
+}
+
+double GaugeSeries::deltaPressure(double p) const
+{
+    return m_settings.drawdown ? std::abs(m_settings.initialPressure - p) : std::abs(p - m_referencePressure);
+}
+
+int GaugeSeries::append(const QVector<Sample>& samples)
+{
+    m_lastRecomputed = 0;
+    const int oldSize = m_time.size();
+    for (const Sample& s : samples) {
+        if (!std::isfinite(s.time) || !std::isfinite(s.pressure)) {
+            ++m_rejected;
+            continue;
+        }
+        // 恢复试井：第一个样本为关井时刻 (时间通常为 0)
+        if (!m_settings.drawdown && !m_hasReference) {
+            m_referencePressure = s.pressure;
+            m_hasReference = true;
+        }
+        const double dp = deltaPressure(s.pressure);
+        if (!(s.time > 0) || (!m_time.isEmpty() && !(s.time > m_time.last()))
+            || (m_settings.requirePositiveDeltaP && !(dp > 0))) {
+            ++m_rejected;
+            continue;
+        }
+        m_time.append(s.time);
+        m_deltaP.append(dp);
+        m_derivative.append(0.0);
+        m_lnT.append(std::log(s.time));
+        m_left.append(-1);
+        m_right.append(-1);
+    }
+    const int n = m_time.size();
+    const int added = n - oldSize;
+    m_accepted += added;
+    if (added == 0) return 0;
+
+    const double L = m_settings.lSpacing;
+
+    // 新点的左端点
+    for (int i = oldSize; i < n; ++i) {
+        while (m_leftCursor + 1 < i && (m_lnT[i] - m_lnT[m_leftCursor + 1]) >= L) ++m_leftCursor;
+        if (m_leftCursor >= 0 && (m_lnT[i] - m_lnT[m_leftCursor]) >= L) m_left[i] = m_leftCursor;
+    }
+
+    // 尚无右端点的点：其后到 oldSize 为止的点都在 L 以内，从 oldSize 起继续查找
+    const int openFrom = m_openFrom;
+    int r = oldSize;
+    int i = openFrom;
+    for (; i < n; ++i) {
+        if (r < i + 1) r = i + 1;
+        while (r < n && !((m_lnT[r] - m_lnT[i]) >= L)) ++r;
+        if (r >= n) break;
+        m_right[i] = r;
+    }
+    m_openFrom = i;
+
+    // 新点、本次得到右端点的点，以及没有左端点 (导数用相邻点保底) 的点
+    for (int k = openFrom; k < n; ++k) {
+        if (k >= m_openFrom && k < oldSize && m_left[k] >= 0) continue;
+        m_derivative[k] = std::abs(DerivativeEngine::bourdetPoint(k, m_time, m_deltaP, m_lnT, m_left, m_right));
+        ++m_lastRecomputed;
+    }
+
+    if (m_settings.capacity > 0 && n > m_settings.capacity) {
+        evict(n - (m_settings.capacity - m_settings.capacity / 8));
+    }
+    return added;
+}
+
+void GaugeSeries::evict(int count)
+{
+    count = qMin(count, int(m_time.size()));
+    if (count <= 0) return;
+    m_time.remove(0, count);
+    m_deltaP.remove(0, count);
+    m_derivative.remove(0, count);
+    m_lnT.remove(0, count);
+    m_left.remove(0, count);
+    m_right.remove(0, count);
+
+    const int n = m_time.size();
+    QVector<int> lostLeft;
+    for (int i = 0; i < n; ++i) {
+        if (m_right[i] >= 0) m_right[i] -= count;
+        if (m_left[i] >= 0) {
+            m_left[i] -= count;
+            if (m_left[i] < 0) {
+                m_left[i] = -1;
+                lostLeft.append(i);
+            }
+        }
+    }
+    m_leftCursor = qMax(-1, m_leftCursor - count);
+    m_openFrom = qMax(0, m_openFrom - count);
+
+    // 第一个点没有左侧相邻点，保底差分改用右侧
+    if (n > 0 && (lostLeft.isEmpty() || lostLeft.first() != 0)) lostLeft.prepend(0);
+    for (int i : lostLeft) {
+        m_derivative[i] = std::abs(DerivativeEngine::bourdetPoint(i, m_time, m_deltaP, m_lnT, m_left, m_right));
+    }
+    m_lastRecomputed += lostLeft.size();
+}
@@ -0,0 +1,81 @@
+/*
+ * 文件名: gaugeseries.h
+ * 文件作用: 实时压力计数据的滑动窗口序列头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 按到达顺序追加 (时间, 压力) 样本，时间、压差、导数按列连续存放；时间不递增、非有限值的样本被拒绝。
+ * 2. 点数超过容量时一次丢弃最早的 1/8，均摊到每个点的移动开销为常数，快照始终是连续数组。
+ * 3. Bourdet 导数增量更新：时间递增时已有点的左窗口端点不变，只有末端 L 范围内尚无右端点的点
+ *    可能因新点得到右端点；每次追加只计算新点和这些点的导数，结果与对保留数据整体重算相同。
+ * 4. 恢复试井以第一个样本 (关井时刻) 的压力为参考压力，丢弃旧点后参考压力不变。
+ */
+
+#ifndef GAUGESERIES_H
+#define GAUGESERIES_H
+
+#include <QVector>
+#include "seriesdata.h"
+
+class GaugeSeries
+{
+public:
+    struct Settings {
+        bool drawdown = false;                // true: 压差为 |Pi - p|；false: |p - 第一个样本的压力|
+        double initialPressure = 0.0;         // 降落试井的地层初始压力 Pi
+        bool requirePositiveDeltaP = true;    // 压差不为正的样本不保留 (双对数图无法显示)
+        double lSpacing = 0.15;
+        int capacity = 200000;                // 保留的点数上限，<=0 不限
+    };
+
+    struct Sample {
+        double time = 0.0;
+        double pressure = 0.0;
+    };
+
+    GaugeSeries() = default;
+    explicit GaugeSeries(const Settings& settings) : m_settings(settings) {}
+
+    const Settings& settings() const { return m_settings; }
+    // 清空数据与参考压力 (数据源被截断或重新连接时)
+    void clear();
+
+    // 追加一批样本，返回保留的个数
+    int append(const QVector<Sample>& samples);
+
+    int size() const { return m_time.size(); }
+    bool isEmpty() const { return m_time.isEmpty(); }
+    // 累计保留与拒绝的样本数 (含已丢弃的旧点)
+    qint64 acceptedCount() const { return m_accepted; }
+    qint64 rejectedCount() const { return m_rejected; }
+    // 最近一次追加重新计算了导数的点数
+    int lastRecomputed() const { return m_lastRecomputed; }
+
+    const QVector<double>& time() const { return m_time; }
+    const QVector<double>& deltaP() const { return m_deltaP; }
+    const QVector<double>& derivative() const { return m_derivative; }   // 已取绝对值
+    // 与本对象共享数组的快照 (下一次追加时本对象才复制)
+    SeriesData snapshot() const { return SeriesData(m_time, m_deltaP, m_derivative); }
+
+private:
+    double deltaPressure(double p) const;
+    // 丢弃最早的 count 个点，窗口端点随之平移，左端点被丢弃的点重算导数
+    void evict(int count);
+
+    Settings m_settings;
+
+    QVector<double> m_time;
+    QVector<double> m_deltaP;
+    QVector<double> m_derivative;
+    QVector<double> m_lnT;
+    QVector<int> m_left;
+    QVector<int> m_right;
+
+    int m_leftCursor = -1;        // 最后一个点的左窗口双指针位置
+    int m_openFrom = 0;           // 从该点起尚无右窗口端点
+    bool m_hasReference = false;
+    double m_referencePressure = 0.0;
+    qint64 m_accepted = 0;
+    qint64 m_rejected = 0;
+    int m_lastRecomputed = 0;
+};
+
+#endif // GAUGESERIES_H
@@ -0,0 +1,198 @@
+/*
+ * 文件名: gaugestreamdialog.cpp
+ * 文件作用: 实时压力计数据源设置对话框实现
+ * 功能描述:
+ * 1. 界面由代码构建，样式与其他数据处理对话框一致 (白底黑字)。
+ * 2. 列号在界面上从 1 开始；只与当前数据源类型相关的控件可编辑。
+ */
+
+#include "gaugestreamdialog.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+GaugeStreamDialog::GaugeStreamDialog(const GaugeStreamReader::Settings& settings, int fitEvery, QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("实时压力计数据");
+    resize(480, 520);
+    setStyleSheet("QDialog { background-color: white; color: black; font-family: \"Microsoft YaHei\", Arial; } "
+                  "QLabel { color: black; background: transparent; } "
+                  "QGroupBox { color: black; border: 1px solid #ccc; margin-top: 10px; font-weight: bold; } "
+                  "QGroupBox::title { subcontrol-origin: margin; subcontrol-position: top left; padding: 0 3px; } "
+                  "QCheckBox { color: black; background: transparent; } "
+                  "QComboBox { color: black; background-color: white; border: 1px solid #ccc; padding: 2px; } "
+                  "QComboBox QAbstractItemView { background-color: white; color: black; selection-background-color: #e0e0e0; } "
+                  "QLineEdit, QSpinBox, QDoubleSpinBox { color: black; background-color: white; border: 1px solid #ccc; padding: 2px; } "
+                  "QPushButton { color: white; background-color: #4a90e2; border: none; border-radius: 4px; padding: 6px 12px; } "
+                  "QPushButton:hover { background-color: #357abd; }");
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // 数据源
+    QGroupBox* sourceGroup = new QGroupBox("数据源");
+    QFormLayout* sourceLayout = new QFormLayout(sourceGroup);
+    m_comboSource = new QComboBox;
+    m_comboSource->addItem("跟踪增长的数据文件", GaugeStreamReader::FileTail);
+    m_comboSource->addItem("TCP 数据流 (每行一个样本)", GaugeStreamReader::TcpFeed);
+    m_comboSource->setCurrentIndex(settings.source == GaugeStreamReader::TcpFeed ? 1 : 0);
+
+    QHBoxLayout* fileLayout = new QHBoxLayout;
+    m_editFile = new QLineEdit(settings.filePath);
+    m_btnBrowse = new QPushButton("浏览...");
+    fileLayout->addWidget(m_editFile);
+    fileLayout->addWidget(m_btnBrowse);
+    m_checkReadExisting = new QCheckBox("先读取文件中已有的数据");
+    m_checkReadExisting->setChecked(settings.readExisting);
+
+    m_editHost = new QLineEdit(settings.host);
+    m_spinPort = new QSpinBox;
+    m_spinPort->setRange(1, 65535);
+    m_spinPort->setValue(settings.port);
+
+    sourceLayout->addRow("类型:", m_comboSource);
+    sourceLayout->addRow("文件:", fileLayout);
+    sourceLayout->addRow("", m_checkReadExisting);
+    sourceLayout->addRow("主机:", m_editHost);
+    sourceLayout->addRow("端口:", m_spinPort);
+    mainLayout->addWidget(sourceGroup);
+
+    // 数据列与试井类型
+    QGroupBox* dataGroup = new QGroupBox("数据格式");
+    QFormLayout* dataLayout = new QFormLayout(dataGroup);
+    m_spinTimeColumn = new QSpinBox;
+    m_spinTimeColumn->setRange(1, 100);
+    m_spinTimeColumn->setValue(settings.timeColumn + 1);
+    m_spinTimeColumn->setToolTip("数值 (h) 或日期时刻；按空白分列时日期与时刻占相邻两列，此处填日期所在列");
+    m_spinPressureColumn = new QSpinBox;
+    m_spinPressureColumn->setRange(1, 100);
+    m_spinPressureColumn->setValue(settings.pressureColumn + 1);
+    m_comboTestType = new QComboBox;
+    m_comboTestType->addItem("压力恢复 (以第一个样本为关井压力)");
+    m_comboTestType->addItem("压力降落");
+    m_comboTestType->setCurrentIndex(settings.series.drawdown ? 1 : 0);
+    m_spinInitialPressure = new QDoubleSpinBox;
+    m_spinInitialPressure->setRange(0, 1e6);
+    m_spinInitialPressure->setDecimals(3);
+    m_spinInitialPressure->setValue(settings.series.initialPressure);
+
+    dataLayout->addRow("时间列:", m_spinTimeColumn);
+    dataLayout->addRow("压力列:", m_spinPressureColumn);
+    dataLayout->addRow("试井类型:", m_comboTestType);
+    dataLayout->addRow("地层初始压力:", m_spinInitialPressure);
+    mainLayout->addWidget(dataGroup);
+
+    // 刷新与滚动拟合
+    QGroupBox* updateGroup = new QGroupBox("刷新与拟合");
+    QFormLayout* updateLayout = new QFormLayout(updateGroup);
+    m_spinRefresh = new QSpinBox;
+    m_spinRefresh->setRange(100, 60000);
+    m_spinRefresh->setSingleStep(100);
+    m_spinRefresh->setSuffix(" ms");
+    m_spinRefresh->setValue(settings.refreshIntervalMs);
+    m_spinCapacity = new QSpinBox;
+    m_spinCapacity->setRange(1000, 5000000);
+    m_spinCapacity->setSingleStep(10000);
+    m_spinCapacity->setValue(settings.series.capacity > 0 ? settings.series.capacity : 5000000);
+    m_spinCapacity->setToolTip("超过时丢弃最早的数据");
+    m_checkRollingFit = new QCheckBox("滚动拟合 (以当前参数为初值后台重新拟合)");
+    m_checkRollingFit->setChecked(fitEvery > 0);
+    m_spinFitEvery = new QSpinBox;
+    m_spinFitEvery->setRange(1, 1000000);
+    m_spinFitEvery->setValue(fitEvery > 0 ? fitEvery : 200);
+    m_spinFitEvery->setSuffix(" 点");
+
+    updateLayout->addRow("最小刷新间隔:", m_spinRefresh);
+    updateLayout->addRow("保留点数:", m_spinCapacity);
+    updateLayout->addRow("", m_checkRollingFit);
+    updateLayout->addRow("每增加:", m_spinFitEvery);
+    mainLayout->addWidget(updateGroup);
+
+    // 底部按钮
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    btnLayout->addStretch();
+    QPushButton* btnOk = new QPushButton("开始");
+    QPushButton* btnCancel = new QPushButton("取消");
+    btnOk->setStyleSheet("background-color: #28a745; color: white;");
+    btnCancel->setStyleSheet("background-color: #6c757d; color: white;");
+    connect(btnOk, &QPushButton::clicked, this, &QDialog::accept);
+    connect(btnCancel, &QPushButton::clicked, this, &QDialog::reject);
+    btnLayout->addWidget(btnOk);
+    btnLayout->addWidget(btnCancel);
+    mainLayout->addLayout(btnLayout);
+
+    connect(m_btnBrowse, &QPushButton::clicked, this, &GaugeStreamDialog::onBrowse);
+    connect(m_comboSource, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GaugeStreamDialog::updateEnabledState);
+    connect(m_comboTestType, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GaugeStreamDialog::updateEnabledState);
+    connect(m_checkRollingFit, &QCheckBox::toggled, this, &GaugeStreamDialog::updateEnabledState);
+    updateEnabledState();
+}
+
+GaugeStreamReader::Settings GaugeStreamDialog::settings() const
+{
+    GaugeStreamReader::Settings s;
+    s.source = GaugeStreamReader::SourceType(m_comboSource->currentData().toInt());
+    s.filePath = m_editFile->text().trimmed();
+    s.readExisting = m_checkReadExisting->isChecked();
+    s.host = m_editHost->text().trimmed();
+    s.port = quint16(m_spinPort->value());
+    s.timeColumn = m_spinTimeColumn->value() - 1;
+    s.pressureColumn = m_spinPressureColumn->value() - 1;
+    s.refreshIntervalMs = m_spinRefresh->value();
+    s.series.drawdown = m_comboTestType->currentIndex() == 1;
+    s.series.initialPressure = m_spinInitialPressure->value();
+    s.series.capacity = m_spinCapacity->value();
+    return s;
+}
+
+int GaugeStreamDialog::fitEvery() const
+{
+    return m_checkRollingFit->isChecked() ? m_spinFitEvery->value() : 0;
+}
+
+void GaugeStreamDialog::accept()
+{
+    const bool file = m_comboSource->currentData().toInt() == GaugeStreamReader::FileTail;
+    if (file && m_editFile->text().trimmed().isEmpty()) {
+        QMessageBox::warning(this, "提示", "请选择要跟踪的数据文件。");
+        return;
+    }
+    if (!file && m_editHost->text().trimmed().isEmpty()) {
+        QMessageBox::warning(this, "提示", "请输入数据流的主机地址。");
+        return;
+    }
+    if (m_spinTimeColumn->value() == m_spinPressureColumn->value()) {
+        QMessageBox::warning(this, "提示", "时间列与压力列不能相同。");
+        return;
+    }
+    QDialog::accept();
+}
+
+void GaugeStreamDialog::onBrowse()
+{
+    QString path = QFileDialog::getOpenFileName(this, "选择数据文件", m_editFile->text(),
+                                                "数据文件 (*.csv *.txt *.dat);;所有文件 (*.*)");
+    if (!path.isEmpty()) m_editFile->setText(path);
+}
+
+void GaugeStreamDialog::updateEnabledState()
+{
+    const bool file = m_comboSource->currentData().toInt() == GaugeStreamReader::FileTail;
+    m_editFile->setEnabled(file);
+    m_btnBrowse->setEnabled(file);
+    m_checkReadExisting->setEnabled(file);
+    m_editHost->setEnabled(!file);
+    m_spinPort->setEnabled(!file);
+    m_spinInitialPressure->setEnabled(m_comboTestType->currentIndex() == 1);
+    m_spinFitEvery->setEnabled(m_checkRollingFit->isChecked());
+}
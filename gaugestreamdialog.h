@@ -0,0 +1,56 @@
+/*
+ * 文件名: gaugestreamdialog.h
+ * 文件作用: 实时压力计数据源设置对话框头文件
+ * 功能描述:
+ * 1. 选择数据源 (跟踪增长的数据文件或 TCP 数据流)，设置时间列、压力列与试井类型。
+ * 2. 设置界面刷新的最小间隔、保留点数，以及滚动拟合 (每增加若干点以当前参数为初值重新拟合)。
+ */
+
+#ifndef GAUGESTREAMDIALOG_H
+#define GAUGESTREAMDIALOG_H
+
+#include <QDialog>
+#include "gaugestreamreader.h"
+
+class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+
+class GaugeStreamDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // fitEvery 为滚动拟合的点数间隔，0 表示不拟合
+    GaugeStreamDialog(const GaugeStreamReader::Settings& settings, int fitEvery, QWidget* parent = nullptr);
+
+    GaugeStreamReader::Settings settings() const;
+    int fitEvery() const;
+
+    // 检查必填项后再关闭
+    void accept() override;
+
+private:
+    void onBrowse();
+    void updateEnabledState();
+
+    QComboBox* m_comboSource;
+    QLineEdit* m_editFile;
+    QPushButton* m_btnBrowse;
+    QCheckBox* m_checkReadExisting;
+    QLineEdit* m_editHost;
+    QSpinBox* m_spinPort;
+    QSpinBox* m_spinTimeColumn;
+    QSpinBox* m_spinPressureColumn;
+    QComboBox* m_comboTestType;
+    QDoubleSpinBox* m_spinInitialPressure;
+    QSpinBox* m_spinRefresh;
+    QSpinBox* m_spinCapacity;
+    QCheckBox* m_checkRollingFit;
+    QSpinBox* m_spinFitEvery;
+};
+
+#endif // GAUGESTREAMDIALOG_H
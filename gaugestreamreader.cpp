@@ -0,0 +1,241 @@
+/*
+ * 文件名: gaugestreamreader.cpp
+ * 文件作用: 实时压力计数据读取实现
+ * 功能描述:
+ * 1. 文件按字节位置增量读取，每次最多读 1 MB 一段，整段解析后一次追加，导数按批更新。
+ * 2. 文件监视通知与轮询定时器任一触发都会读取；读取只到当前文件末尾，未写完的末行留到下一次。
+ * 3. 快照定时器为单次定时器：距上次发送不足最小间隔时推迟到间隔结束，期间到达的数据合并到同一快照。
+ */
+
+#include "gaugestreamreader.h"
+#include "timestampparser.h"
+
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTcpSocket>
+#include <QTimer>
+
+namespace {
+// 每次从文件读取的最大字节数
+const qint64 READ_CHUNK_BYTES = 1 << 20;
+// TCP 连接断开后的重连间隔
+const int RECONNECT_INTERVAL_MS = 2000;
+}
+
+GaugeStreamReader::GaugeStreamReader(const Settings& settings, QObject* parent)
+    : QObject(parent),
+    m_settings(settings),
+    m_series(settings.series),
+    m_file(this),
+    m_filePos(0),
+    m_fileWatcher(nullptr),
+    m_pollTimer(nullptr),
+    m_socket(nullptr),
+    m_reconnectTimer(nullptr),
+    m_snapshotTimer(nullptr),
+    m_dirty(false),
+    m_epochSeconds(TimestampParser::INVALID),
+    m_lastClockSeconds(TimestampParser::INVALID),
+    m_dayOffset(0)
+{
+}
+
+void GaugeStreamReader::start()
+{
+    // 定时器与套接字在读取线程中创建，归属本对象
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setSingleShot(true);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &GaugeStreamReader::sendSnapshot);
+
+    if (m_settings.source == TcpFeed) {
+        m_socket = new QTcpSocket(this);
+        m_reconnectTimer = new QTimer(this);
+        m_reconnectTimer->setSingleShot(true);
+        connect(m_reconnectTimer, &QTimer::timeout, this, &GaugeStreamReader::connectSocket);
+        connect(m_socket, &QTcpSocket::readyRead, this, &GaugeStreamReader::onSocketReadyRead);
+        connect(m_socket, &QTcpSocket::connected, this, [this]() {
+            emit statusChanged(QString("已连接 %1:%2").arg(m_settings.host).arg(m_settings.port));
+        });
+        connect(m_socket, &QTcpSocket::disconnected, this, [this]() {
+            emit statusChanged("连接已断开，稍后重连");
+            m_reconnectTimer->start(RECONNECT_INTERVAL_MS);
+        });
+        connect(m_socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+            emit statusChanged("连接错误: " + m_socket->errorString());
+            if (m_socket->state() == QAbstractSocket::UnconnectedState) m_reconnectTimer->start(RECONNECT_INTERVAL_MS);
+        });
+        connectSocket();
+        return;
+    }
+
+    m_fileWatcher = new QFileSystemWatcher(this);
+    connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
+        // 部分系统在文件被替换后不再监视该路径
+        if (!m_fileWatcher->files().contains(path) && QFileInfo::exists(path)) m_fileWatcher->addPath(path);
+        readFile();
+    });
+    m_pollTimer = new QTimer(this);
+    connect(m_pollTimer, &QTimer::timeout, this, &GaugeStreamReader::readFile);
+
+    if (QFileInfo::exists(m_settings.filePath)) m_fileWatcher->addPath(m_settings.filePath);
+    m_file.setFileName(m_settings.filePath);
+    if (m_file.open(QIODevice::ReadOnly)) {
+        m_filePos = m_settings.readExisting ? 0 : m_file.size();
+        emit statusChanged("正在跟踪 " + QFileInfo(m_settings.filePath).fileName());
+    } else {
+        emit statusChanged("无法打开文件，等待创建: " + m_settings.filePath);
+    }
+    m_pollTimer->start(qMax(50, m_settings.pollIntervalMs));
+    readFile();
+}
+
+void GaugeStreamReader::openFile()
+{
+    m_file.close();
+    m_file.setFileName(m_settings.filePath);
+    m_filePos = 0;
+    if (!m_file.open(QIODevice::ReadOnly)) return;
+    if (!m_fileWatcher->files().contains(m_settings.filePath)) m_fileWatcher->addPath(m_settings.filePath);
+    emit statusChanged("正在跟踪 " + QFileInfo(m_settings.filePath).fileName());
+}
+
+void GaugeStreamReader::readFile()
+{
+    // 文件稍后才创建：创建后从头读取
+    if (!m_file.isOpen()) {
+        openFile();
+        if (!m_file.isOpen()) return;
+    }
+
+    // 按路径重新取得大小；变短说明文件被截断或替换
+    const qint64 size = QFileInfo(m_settings.filePath).size();
+    if (size < m_filePos) {
+        emit statusChanged("文件被截断或替换，从头重新读取");
+        resetSeries();
+        openFile();
+        if (!m_file.isOpen()) return;
+    }
+    if (size <= m_filePos || !m_file.seek(m_filePos)) return;
+
+    while (m_filePos < size) {
+        const QByteArray chunk = m_file.read(qMin(size - m_filePos, READ_CHUNK_BYTES));
+        if (chunk.isEmpty()) break;
+        m_filePos += chunk.size();
+        consume(chunk);
+    }
+}
+
+void GaugeStreamReader::connectSocket()
+{
+    m_socket->abort();
+    m_partial.clear();
+    emit statusChanged(QString("正在连接 %1:%2").arg(m_settings.host).arg(m_settings.port));
+    m_socket->connectToHost(m_settings.host, m_settings.port);
+}
+
+void GaugeStreamReader::onSocketReadyRead()
+{
+    consume(m_socket->readAll());
+}
+
+void GaugeStreamReader::consume(const QByteArray& bytes)
+{
+    m_partial.append(bytes);
+    QVector<GaugeSeries::Sample> samples;
+    int from = 0;
+    for (;;) {
+        const int end = m_partial.indexOf('\n', from);
+        if (end < 0) break;
+        GaugeSeries::Sample sample;
+        if (parseLine(m_partial.mid(from, end - from), sample)) samples.append(sample);
+        from = end + 1;
+    }
+    m_partial.remove(0, from);
+
+    if (!samples.isEmpty() && m_series.append(samples) > 0) scheduleSnapshot();
+}
+
+bool GaugeStreamReader::parseLine(const QByteArray& line, GaugeSeries::Sample& sample)
+{
+    const QString text = QString::fromUtf8(line).trimmed();
+    if (text.isEmpty() || text.startsWith('#')) return false;
+
+    static const QRegularExpression delimiters("[,;\\t]");
+    static const QRegularExpression spaces("\\s+");
+    const QStringList fields = text.contains(delimiters) ? text.split(delimiters) : text.split(spaces, Qt::SkipEmptyParts);
+
+    bool ok = false;
+    sample.pressure = fields.value(m_settings.pressureColumn).trimmed().toDouble(&ok);
+    // 表头等无法解析的行直接跳过
+    return ok && parseTime(fields, sample.time);
+}
+
+bool GaugeStreamReader::parseTime(const QStringList& fields, double& hours)
+{
+    const QString text = fields.value(m_settings.timeColumn).trimmed();
+    bool ok = false;
+    hours = text.toDouble(&ok);
+    if (ok) return true;
+
+    // 日期时刻："yyyy-MM-dd hh:mm:ss"、"yyyy-MM-ddThh:mm:ss"，按空白分列时日期与时刻在相邻两列；也可以只有时刻
+    static const QRegularExpression dateTimeSeparator("[ T]");
+    QString datePart, clockPart;
+    const int separator = text.indexOf(dateTimeSeparator);
+    if (separator > 0) {
+        datePart = text.left(separator);
+        clockPart = text.mid(separator + 1).trimmed();
+    } else if (text.contains(':')) {
+        clockPart = text;
+    } else {
+        datePart = text;
+        clockPart = fields.value(m_settings.timeColumn + 1).trimmed();
+    }
+
+    const qint64 clock = TimestampParser::parseTime(clockPart, TimestampParser::UnknownFormat);
+    if (clock == TimestampParser::INVALID) return false;
+    qint64 seconds = 0;
+    if (!datePart.isEmpty()) {
+        const qint64 days = TimestampParser::parseDate(datePart, TimestampParser::UnknownFormat);
+        if (days == TimestampParser::INVALID) return false;
+        seconds = days * TimestampParser::SECONDS_PER_DAY + clock;
+    } else {
+        // 只有时刻：时刻变小时视为跨日
+        if (m_lastClockSeconds != TimestampParser::INVALID && clock < m_lastClockSeconds) {
+            m_dayOffset += TimestampParser::SECONDS_PER_DAY;
+        }
+        m_lastClockSeconds = clock;
+        seconds = m_dayOffset + clock;
+    }
+
+    if (m_epochSeconds == TimestampParser::INVALID) m_epochSeconds = seconds;
+    hours = double(seconds - m_epochSeconds) / 3600.0;
+    return true;
+}
+
+void GaugeStreamReader::resetSeries()
+{
+    m_series.clear();
+    m_partial.clear();
+    m_epochSeconds = TimestampParser::INVALID;
+    m_lastClockSeconds = TimestampParser::INVALID;
+    m_dayOffset = 0;
+    scheduleSnapshot();
+}
+
+void GaugeStreamReader::scheduleSnapshot()
+{
+    m_dirty = true;
+    if (!m_snapshotTimer || m_snapshotTimer->isActive()) return;
+    const qint64 wait = m_lastSnapshot.isValid() ? m_settings.refreshIntervalMs - m_lastSnapshot.elapsed() : 0;
+    m_snapshotTimer->start(int(qMax<qint64>(0, wait)));
+}
+
+void GaugeStreamReader::sendSnapshot()
+{
+    if (!m_dirty) return;
+    m_dirty = false;
+    m_lastSnapshot.start();
+    emit snapshotReady(m_series.snapshot(), m_series.acceptedCount());
+}
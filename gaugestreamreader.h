@@ -0,0 +1,97 @@
+/*
+ * 文件名: gaugestreamreader.h
+ * 文件作用: 实时压力计数据读取头文件
+ * 功能描述:
+ * 1. 数据源可以是持续增长的数据文件 (记录仪写入的 CSV/TXT，只读取新增的完整行)，或 TCP 数据流 (每行一个样本)。
+ * 2. 每行按逗号、分号、制表符 (没有时按空白) 分列，时间列可以是数值 (h) 或日期时刻 (换算为距第一个样本的小时数)。
+ * 3. 读取到的样本追加到 GaugeSeries，导数增量更新；快照按最小间隔发送，数据到达再快也不超过该频率。
+ * 4. 对象须移到独立线程：start 在该线程中创建文件监视、定时器和套接字，读取与计算都不占用界面线程。
+ * 5. 文件变短 (被截断或替换) 时从头重新读取；TCP 连接断开后定时重连。
+ */
+
+#ifndef GAUGESTREAMREADER_H
+#define GAUGESTREAMREADER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include "gaugeseries.h"
+#include "seriesdata.h"
+
+class QFileSystemWatcher;
+class QTcpSocket;
+class QTimer;
+
+class GaugeStreamReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum SourceType {
+        FileTail = 0,   // 跟踪增长的数据文件
+        TcpFeed         // TCP 数据流
+    };
+
+    struct Settings {
+        SourceType source = FileTail;
+        QString filePath;
+        bool readExisting = true;       // 先读取文件中已有的内容 (否则只读取之后追加的行)
+        QString host = "127.0.0.1";
+        quint16 port = 5000;
+        int timeColumn = 0;
+        int pressureColumn = 1;
+        int pollIntervalMs = 500;       // 文件轮询间隔 (文件监视通知之外的保底，网络盘上可能没有通知)
+        int refreshIntervalMs = 500;    // 两次快照的最小间隔
+        GaugeSeries::Settings series;
+    };
+
+    explicit GaugeStreamReader(const Settings& settings, QObject* parent = nullptr);
+
+public slots:
+    // 在读取线程中调用；停止时结束线程即可，对象随线程结束删除
+    void start();
+
+signals:
+    // acceptedCount 为累计保留的样本数 (含因容量丢弃的旧点)
+    void snapshotReady(const SeriesData& data, qint64 acceptedCount);
+    void statusChanged(const QString& message);
+
+private:
+    void readFile();
+    void openFile();
+    void connectSocket();
+    void onSocketReadyRead();
+    // 追加字节并处理其中的完整行，不完整的末行留到下一次
+    void consume(const QByteArray& bytes);
+    bool parseLine(const QByteArray& line, GaugeSeries::Sample& sample);
+    // 时间列文字换算为小时数，无法解析时返回 false
+    bool parseTime(const QStringList& fields, double& hours);
+    void resetSeries();
+    void scheduleSnapshot();
+    void sendSnapshot();
+
+    Settings m_settings;
+    GaugeSeries m_series;
+
+    QFile m_file;
+    qint64 m_filePos;
+    QFileSystemWatcher* m_fileWatcher;
+    QTimer* m_pollTimer;
+
+    QTcpSocket* m_socket;
+    QTimer* m_reconnectTimer;
+
+    QByteArray m_partial;               // 尚未读到换行符的末行
+    QTimer* m_snapshotTimer;
+    QElapsedTimer m_lastSnapshot;
+    bool m_dirty;
+
+    // 日期时刻格式的时间：第一个样本的时刻 (秒)，以及仅有时刻时用于跨日累加的上一个时刻
+    qint64 m_epochSeconds;
+    qint64 m_lastClockSeconds;
+    qint64 m_dayOffset;
+};
+
+#endif // GAUGESTREAMREADER_H
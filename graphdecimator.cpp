@@ -0,0 +1,65 @@
+/*
+ * 文件名: graphdecimator.cpp
+ * 文件作用: 大数据量曲线的分级抽稀显示实现
+ * 功能描述:
+ * 1. 金字塔在全局线程池中建立；抽稀器先于任务结束被删除时结果直接丢弃 (任务只持有数据副本)。
+ * 2. 全部数据通过 SharedGraphData 与其他曲线共用；金字塔建好后曲线换用独立的小容器存放抽稀结果。
+ * 3. 取点挂在 beforeReplot 上，拖动、滚轮缩放、rescaleAxes 后的重绘都会先换成新范围的数据。
+ */
+
+#include "graphdecimator.h"
+
+#include <QtConcurrent>
+#include "sharedgraphdata.h"
+
+void GraphDecimator::setGraphData(QCPGraph* graph, const QVector<double>& x, const QVector<double>& y)
+{
+    if (!graph) return;
+    // 同一曲线再次设置数据时，旧的抽稀器 (及其尚未完成的金字塔) 作废
+    delete graph->findChild<GraphDecimator*>(QString(), Qt::FindDirectChildrenOnly);
+
+    // 先显示全部数据 (与显示同一数据的其他曲线共用容器)，保证 rescaleAxes 与首帧正确
+    SharedGraphData::assign(graph, x, y);
+    if (qMin(x.size(), y.size()) < MIN_POINTS) return;
+    new GraphDecimator(graph, x, y);
+}
+
+GraphDecimator::GraphDecimator(QCPGraph* graph, const QVector<double>& x, const QVector<double>& y)
+    : QObject(graph),
+    m_graph(graph),
+    m_shownWidth(-1),
+    m_shownLog(false)
+{
+    connect(&m_watcher, &QFutureWatcher<QSharedPointer<const MinMaxPyramid>>::finished, this, &GraphDecimator::onPyramidReady);
+    m_watcher.setFuture(QtConcurrent::run([x, y]() {
+        return QSharedPointer<const MinMaxPyramid>(new MinMaxPyramid(x, y));
+    }));
+}
+
+void GraphDecimator::onPyramidReady()
+{
+    m_pyramid = m_watcher.result();
+    // 换成自己的容器，抽稀数据写入时不影响共用全部数据的其他曲线
+    m_graph->setData(QSharedPointer<QCPGraphDataContainer>(new QCPGraphDataContainer));
+    connect(m_graph->parentPlot(), &QCustomPlot::beforeReplot, this, &GraphDecimator::refresh);
+    refresh();
+    m_graph->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+}
+
+void GraphDecimator::refresh()
+{
+    QCPAxis* keyAxis = m_graph->keyAxis();
+    if (!m_pyramid || !keyAxis) return;
+
+    QCPRange range = keyAxis->range();
+    int width = keyAxis->axisRect() ? keyAxis->axisRect()->width() : 0;
+    bool logX = keyAxis->scaleType() == QCPAxis::stLogarithmic;
+    if (range == m_shownRange && width == m_shownWidth && logX == m_shownLog) return;
+    m_shownRange = range;
+    m_shownWidth = width;
+    m_shownLog = logX;
+
+    QVector<double> x, y;
+    m_pyramid->query(range.lower, range.upper, width, logX, x, y);
+    m_graph->setData(x, y, true);
+}
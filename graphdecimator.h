@@ -0,0 +1,45 @@
+/*
+ * 文件名: graphdecimator.h
+ * 文件作用: 大数据量曲线的分级抽稀显示头文件
+ * 功能描述:
+ * 1. 点数较多的曲线在后台线程中建立最值金字塔 (MinMaxPyramid)，建好之前先显示全部数据。
+ * 2. 每次重绘前按横轴可见范围与坐标区像素宽度取出对应层级的点交给 QCPGraph，
+ *    缩放、平移的绘制代价与像素数同量级，与总点数无关。
+ * 3. 作为曲线 (QCPGraph) 的子对象存在，曲线删除时一并释放；同一曲线重新设置数据时替换旧的抽稀器。
+ */
+
+#ifndef GRAPHDECIMATOR_H
+#define GRAPHDECIMATOR_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QSharedPointer>
+#include "minmaxpyramid.h"
+#include "qcustomplot.h"
+
+class GraphDecimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 点数不少于该值的曲线才建立金字塔，较少时直接交给 QCustomPlot
+    static const int MIN_POINTS = 50000;
+
+    // 代替 graph->setData(x, y)：大数据量时附加抽稀器
+    static void setGraphData(QCPGraph* graph, const QVector<double>& x, const QVector<double>& y);
+
+private:
+    GraphDecimator(QCPGraph* graph, const QVector<double>& x, const QVector<double>& y);
+
+    void onPyramidReady();
+    void refresh();
+
+    QCPGraph* m_graph;
+    QSharedPointer<const MinMaxPyramid> m_pyramid;
+    QFutureWatcher<QSharedPointer<const MinMaxPyramid>> m_watcher;
+    QCPRange m_shownRange;  // 当前数据对应的横轴范围与像素宽度，未变化时不重新取点
+    int m_shownWidth;
+    bool m_shownLog;
+};
+
+#endif // GRAPHDECIMATOR_H
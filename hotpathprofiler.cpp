@@ -0,0 +1,374 @@
+/*
+ * 文件名: hotpathprofiler.cpp
+ * 文件作用: 求解器与拟合热路径的计时与计数实现
+ * 功能描述:
+ * 1. 每个线程第一次计数时登记一个计数块 (thread_local)，线程结束时并入已结束线程的累计值。
+ * 2. 计数块中的原子量只由所属线程写入 (relaxed 读改写，无锁前缀)，汇总线程只读取，不会丢失计数。
+ * 3. 清零只记录当前累计值作为基准，不改写各线程的计数块。
+ * 4. 时间线事件按线程保存；导出时迭代记录单独成一行 (tid 0)，参数中附带该次迭代的计数增量。
+ */
+
+#include "hotpathprofiler.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+struct TraceEvent {
+    qint64 startNs;
+    qint64 durationNs;
+    int scope;
+    int tid;
+};
+
+struct ThreadBlock {
+    std::atomic<qint64> counters[HotPathProfiler::CounterCount];
+    std::atomic<qint64> scopeNs[HotPathProfiler::ScopeCount];
+    std::atomic<qint64> scopeCalls[HotPathProfiler::ScopeCount];
+    int tid = 0;
+    QMutex traceMutex;
+    QVector<TraceEvent> trace;
+
+    ThreadBlock()
+    {
+        for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+        for (auto& c : scopeNs) c.store(0, std::memory_order_relaxed);
+        for (auto& c : scopeCalls) c.store(0, std::memory_order_relaxed);
+    }
+
+    void addTo(HotPathProfiler::Totals& t) const
+    {
+        for (int i = 0; i < HotPathProfiler::CounterCount; ++i) t.counters[i] += counters[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < HotPathProfiler::ScopeCount; ++i) {
+            t.scopeNs[i] += scopeNs[i].load(std::memory_order_relaxed);
+            t.scopeCalls[i] += scopeCalls[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// 只由所属线程写入：读改写不需要原子指令
+inline void bump(std::atomic<qint64>& c, qint64 n)
+{
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct Registry {
+    QMutex mutex;
+    QList<ThreadBlock*> blocks;         // 仍在运行的线程
+    HotPathProfiler::Totals retired;    // 已结束线程的累计值
+    HotPathProfiler::Totals baseline;   // 上次清零时的累计值
+    QVector<TraceEvent> retiredTrace;
+    int nextTid = 1;
+
+    qint64 iterationStartNs = -1;
+    HotPathProfiler::Totals iterationBase;
+    int iterationIndex = 0;
+    QVector<HotPathProfiler::IterationRecord> iterations;
+
+    // 调用方持有 mutex
+    HotPathProfiler::Totals rawTotals() const
+    {
+        HotPathProfiler::Totals t = retired;
+        for (const ThreadBlock* b : blocks) b->addTo(t);
+        return t;
+    }
+};
+
+// 不析构：线程池线程可能在静态对象析构之后才结束
+Registry& registry()
+{
+    static Registry* r = new Registry;
+    return *r;
+}
+
+std::atomic<bool> s_traceEnabled(false);
+
+struct ThreadHolder {
+    ThreadBlock* block = nullptr;
+
+    ~ThreadHolder()
+    {
+        if (!block) return;
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        block->addTo(reg.retired);
+        {
+            QMutexLocker traceLocker(&block->traceMutex);
+            int room = HotPathProfiler::MAX_TRACE_EVENTS - reg.retiredTrace.size();
+            for (int i = 0; i < block->trace.size() && i < room; ++i) reg.retiredTrace.append(block->trace[i]);
+        }
+        reg.blocks.removeOne(block);
+        delete block;
+        block = nullptr;
+    }
+};
+
+thread_local ThreadHolder t_holder;
+
+ThreadBlock* currentBlock()
+{
+    if (!t_holder.block) {
+        ThreadBlock* b = new ThreadBlock;
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        b->tid = reg.nextTid++;
+        reg.blocks.append(b);
+        t_holder.block = b;
+    }
+    return t_holder.block;
+}
+
+void appendNumber(QByteArray& out, double v)
+{
+    out += QByteArray::number(v, 'f', 3);
+}
+
+} // namespace
+
+HotPathProfiler::Totals HotPathProfiler::Totals::operator-(const Totals& other) const
+{
+    Totals t;
+    for (int i = 0; i < CounterCount; ++i) t.counters[i] = counters[i] - other.counters[i];
+    for (int i = 0; i < ScopeCount; ++i) {
+        t.scopeNs[i] = scopeNs[i] - other.scopeNs[i];
+        t.scopeCalls[i] = scopeCalls[i] - other.scopeCalls[i];
+    }
+    return t;
+}
+
+double HotPathProfiler::Totals::laplaceHitRate() const
+{
+    qint64 n = counters[LaplaceCacheHits] + counters[LaplaceCacheMisses];
+    return n > 0 ? double(counters[LaplaceCacheHits]) / n : -1.0;
+}
+
+double HotPathProfiler::Totals::typeCurveHitRate() const
+{
+    qint64 n = counters[TypeCurveHits] + counters[TypeCurveMisses];
+    return n > 0 ? double(counters[TypeCurveHits]) / n : -1.0;
+}
+
+bool HotPathProfiler::isCompiledIn()
+{
+#ifdef WELLTEST_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 HotPathProfiler::nowNs()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void HotPathProfiler::add(Counter counter, qint64 n)
+{
+    bump(currentBlock()->counters[counter], n);
+}
+
+HotPathProfiler::ScopedTimer::~ScopedTimer()
+{
+    const qint64 end = nowNs();
+    ThreadBlock* b = currentBlock();
+    bump(b->scopeNs[m_scope], end - m_start);
+    bump(b->scopeCalls[m_scope], 1);
+    if (s_traceEnabled.load(std::memory_order_relaxed)) {
+        QMutexLocker locker(&b->traceMutex);
+        if (b->trace.size() < MAX_TRACE_EVENTS) b->trace.append({ m_start, end - m_start, int(m_scope), b->tid });
+    }
+}
+
+HotPathProfiler::Totals HotPathProfiler::totals()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    return reg.rawTotals() - reg.baseline;
+}
+
+void HotPathProfiler::reset()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    reg.baseline = reg.rawTotals();
+    reg.iterationBase = reg.baseline;
+    reg.iterationStartNs = -1;
+    reg.iterationIndex = 0;
+    reg.iterations.clear();
+}
+
+void HotPathProfiler::beginIterations()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    reg.iterationBase = reg.rawTotals();
+    reg.iterationStartNs = nowNs();
+    reg.iterationIndex = 0;
+    reg.iterations.clear();
+}
+
+void HotPathProfiler::markIteration()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    const qint64 now = nowNs();
+    const Totals raw = reg.rawTotals();
+    if (reg.iterationStartNs >= 0) {
+        IterationRecord rec;
+        rec.index = ++reg.iterationIndex;
+        rec.startNs = reg.iterationStartNs;
+        rec.wallNs = now - reg.iterationStartNs;
+        rec.delta = raw - reg.iterationBase;
+        reg.iterations.append(rec);
+        if (reg.iterations.size() > MAX_ITERATION_RECORDS) reg.iterations.removeFirst();
+    }
+    reg.iterationBase = raw;
+    reg.iterationStartNs = now;
+}
+
+QVector<HotPathProfiler::IterationRecord> HotPathProfiler::recentIterations()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    return reg.iterations;
+}
+
+void HotPathProfiler::setTraceEnabled(bool enabled)
+{
+    s_traceEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool HotPathProfiler::isTraceEnabled()
+{
+    return s_traceEnabled.load(std::memory_order_relaxed);
+}
+
+void HotPathProfiler::clearTrace()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    reg.retiredTrace.clear();
+    for (ThreadBlock* b : reg.blocks) {
+        QMutexLocker traceLocker(&b->traceMutex);
+        b->trace.clear();
+    }
+}
+
+int HotPathProfiler::traceEventCount()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    int n = reg.retiredTrace.size();
+    for (ThreadBlock* b : reg.blocks) {
+        QMutexLocker traceLocker(&b->traceMutex);
+        n += b->trace.size();
+    }
+    return n;
+}
+
+QByteArray HotPathProfiler::chromeTrace()
+{
+    QVector<TraceEvent> events;
+    QVector<IterationRecord> iterations;
+    QVector<int> tids;
+    {
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        events = reg.retiredTrace;
+        for (ThreadBlock* b : reg.blocks) {
+            QMutexLocker traceLocker(&b->traceMutex);
+            events += b->trace;
+        }
+        iterations = reg.iterations;
+    }
+    for (const TraceEvent& e : events) {
+        if (!tids.contains(e.tid)) tids.append(e.tid);
+    }
+
+    QByteArray out;
+    out.reserve(events.size() * 96 + iterations.size() * 320 + 256);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"WellTest\"}}";
+    out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"iterations\"}}";
+    for (int tid : tids) {
+        out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(tid)
+               + ",\"args\":{\"name\":\"thread " + QByteArray::number(tid) + "\"}}";
+    }
+    for (const IterationRecord& rec : iterations) {
+        out += ",\n{\"name\":\"iteration " + QByteArray::number(rec.index) + "\",\"cat\":\"fit\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":";
+        appendNumber(out, rec.startNs / 1000.0);
+        out += ",\"dur\":";
+        appendNumber(out, rec.wallNs / 1000.0);
+        out += ",\"args\":{";
+        for (int i = 0; i < CounterCount; ++i) {
+            if (i > 0) out += ',';
+            out += '"';
+            out += counterName(Counter(i));
+            out += "\":" + QByteArray::number(rec.delta.counters[i]);
+        }
+        out += "}}";
+    }
+    for (const TraceEvent& e : events) {
+        out += ",\n{\"name\":\"";
+        out += scopeName(Scope(e.scope));
+        out += "\",\"cat\":\"solver\",\"ph\":\"X\",\"pid\":1,\"tid\":" + QByteArray::number(e.tid) + ",\"ts\":";
+        appendNumber(out, e.startNs / 1000.0);
+        out += ",\"dur\":";
+        appendNumber(out, e.durationNs / 1000.0);
+        out += '}';
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool HotPathProfiler::writeChromeTrace(const QString& filePath, QString* errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    const QByteArray json = chromeTrace();
+    if (file.write(json) != json.size()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+const char* HotPathProfiler::counterName(Counter counter)
+{
+    switch (counter) {
+    case LaplaceEvaluations: return "laplaceEvaluations";
+    case LaplaceCacheHits: return "laplaceCacheHits";
+    case LaplaceCacheMisses: return "laplaceCacheMisses";
+    case TypeCurveHits: return "typeCurveHits";
+    case TypeCurveMisses: return "typeCurveMisses";
+    case BesselCalls: return "besselCalls";
+    case QuadratureNodes: return "quadratureNodes";
+    case FlowSolves: return "flowSolves";
+    case StepSolves: return "stepSolves";
+    case ResidualEvaluations: return "residualEvaluations";
+    case JacobianColumns: return "jacobianColumns";
+    default: return "unknown";
+    }
+}
+
+const char* HotPathProfiler::scopeName(Scope scope)
+{
+    switch (scope) {
+    case CurveScope: return "curve";
+    case SensitivityScope: return "sensitivity";
+    case ResidualScope: return "residuals";
+    case JacobianScope: return "jacobian";
+    case StepSolveScope: return "stepSolve";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * 文件名: hotpathprofiler.h
+ * 文件作用: 求解器与拟合热路径的计时与计数头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 计数 Laplace 求值、Laplace 缓存与型曲线库命中、Bessel 函数、积分节点、方程组求解、残差求值与雅可比列。
+ * 2. 作用域计时 (理论曲线、灵敏度、残差、雅可比、LM 线性子问题)，计入总耗时与调用次数，可选记录时间线。
+ * 3. 计数按线程分块，只由所属线程写入，不加锁也不争用缓存行；热路径按一次 Laplace 求值汇总后计入。
+ * 4. 拟合每个接受步调用 markIteration，保留最近若干次迭代的耗时与计数增量，供界面面板显示。
+ * 5. 时间线可导出为 Chrome Trace JSON (chrome://tracing 或 Perfetto 打开)。
+ * 6. 未定义 WELLTEST_PROFILING 时 WT_PROFILE_* 宏展开为空，热路径不含任何计数代码。
+ */
+
+#ifndef HOTPATHPROFILER_H
+#define HOTPATHPROFILER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class HotPathProfiler
+{
+public:
+    enum Counter {
+        LaplaceEvaluations = 0, // Laplace 空间解求值 (含对偶数、复平面)
+        LaplaceCacheHits,       // Laplace 值缓存命中
+        LaplaceCacheMisses,
+        TypeCurveHits,          // 型曲线库网格点命中
+        TypeCurveMisses,
+        BesselCalls,            // Bessel 函数求值 (K0、K1、I0e、I1e 各计一次)
+        QuadratureNodes,        // 沿裂缝积分的节点数
+        FlowSolves,             // 裂缝流量方程组求解 (Levinson 递推或 LU)
+        StepSolves,             // LM / Dogleg 线性子问题 (QR 分解) 求解
+        ResidualEvaluations,    // 拟合残差向量求值
+        JacobianColumns,        // 雅可比列
+        CounterCount
+    };
+
+    enum Scope {
+        CurveScope = 0,         // 理论曲线
+        SensitivityScope,       // 曲线灵敏度 (对偶数正演)
+        ResidualScope,          // 残差向量
+        JacobianScope,          // 完整雅可比
+        StepSolveScope,         // 线性子问题
+        ScopeCount
+    };
+
+    // 累计值：作用域耗时为包含子作用域的墙钟时间，多线程时为各线程之和
+    struct Totals {
+        qint64 counters[CounterCount] = {};
+        qint64 scopeNs[ScopeCount] = {};
+        qint64 scopeCalls[ScopeCount] = {};
+
+        Totals operator-(const Totals& other) const;
+        // 命中率 (0~1)，没有查询时返回 -1
+        double laplaceHitRate() const;
+        double typeCurveHitRate() const;
+    };
+
+    // 两次 markIteration 之间的墙钟时间与计数增量
+    struct IterationRecord {
+        int index = 0;          // 自 beginIterations 起的序号 (从 1 开始)
+        qint64 startNs = 0;     // 起始时刻 (nowNs)
+        qint64 wallNs = 0;
+        Totals delta;
+    };
+
+    // 是否以 WELLTEST_PROFILING 编译 (否则计数恒为 0)
+    static bool isCompiledIn();
+
+    // 当前线程计数 (由 WT_PROFILE_COUNT 调用)
+    static void add(Counter counter, qint64 n);
+
+    // 自上次 reset 以来的累计值 (含已结束线程)
+    static Totals totals();
+    // 累计值与迭代记录清零 (时间线保留，另由 clearTrace 清空)
+    static void reset();
+
+    // 一次拟合开始：之后第一个 markIteration 从此刻起算
+    static void beginIterations();
+    static void markIteration();
+    static QVector<IterationRecord> recentIterations();
+
+    // 时间线：开启后记录各作用域的起止时刻 (每线程最多 MAX_TRACE_EVENTS 个，超出丢弃)
+    static void setTraceEnabled(bool enabled);
+    static bool isTraceEnabled();
+    static void clearTrace();
+    static int traceEventCount();
+    // Chrome Trace JSON (traceEvents 数组，时间单位 µs)；写文件失败时返回 false 并写入 errorMessage
+    static QByteArray chromeTrace();
+    static bool writeChromeTrace(const QString& filePath, QString* errorMessage = nullptr);
+
+    static const char* counterName(Counter counter);
+    static const char* scopeName(Scope scope);
+
+    // 相对进程内固定起点的单调时刻 (ns)
+    static qint64 nowNs();
+
+    static const int MAX_TRACE_EVENTS = 200000;
+    static const int MAX_ITERATION_RECORDS = 200;
+
+    // 作用域计时：构造到析构的耗时计入当前线程
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Scope scope) : m_scope(scope), m_start(nowNs()) {}
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Scope m_scope;
+        qint64 m_start;
+    };
+};
+
+#define WT_PROFILE_CONCAT_(a, b) a##b
+#define WT_PROFILE_CONCAT(a, b) WT_PROFILE_CONCAT_(a, b)
+
+#ifdef WELLTEST_PROFILING
+#define WT_PROFILE_COUNT(counter, n) HotPathProfiler::add(HotPathProfiler::counter, (n))
+#define WT_PROFILE_SCOPE(scope) HotPathProfiler::ScopedTimer WT_PROFILE_CONCAT(wtProfileScope_, __LINE__)(HotPathProfiler::scope)
+#define WT_PROFILE_BEGIN_ITERATIONS() HotPathProfiler::beginIterations()
+#define WT_PROFILE_MARK_ITERATION() HotPathProfiler::markIteration()
+#else
+#define WT_PROFILE_COUNT(counter, n) do { (void)sizeof(n); } while (0)
+#define WT_PROFILE_SCOPE(scope) do {} while (0)
+#define WT_PROFILE_BEGIN_ITERATIONS() do {} while (0)
+#define WT_PROFILE_MARK_ITERATION() do {} while (0)
+#endif
+
+#endif // HOTPATHPROFILER_H
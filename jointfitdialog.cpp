@@ -0,0 +1,281 @@
+/*
+ * 文件名: jointfitdialog.cpp
+ * 文件作用: 多测试联合拟合对话框实现
+ * 功能描述:
+ * 1. 界面由代码构建，样式与性能统计面板一致 (白底黑字)。
+ * 2. 各页状态按批量拟合的规则解析 (BatchFitQueue::parseState)：同样的重采样、时间窗口与权重。
+ * 3. 默认共用在两个及以上分析页中拟合的参数，表皮系数与井筒储集系数 (各测试的井况不同) 除外。
+ * 4. 关闭对话框时先停止后台拟合并等待其结束。
+ */
+
+#include "jointfitdialog.h"
+#include "batchfitqueue.h"
+
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+#include <cmath>
+
+namespace {
+
+QTableWidgetItem* readOnlyItem(const QString& text)
+{
+    QTableWidgetItem* item = new QTableWidgetItem(text);
+    item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+    return item;
+}
+
+QString formatMse(double mse)
+{
+    return std::isfinite(mse) ? QString::number(mse, 'g', 4) : QString("-");
+}
+
+} // namespace
+
+JointFitDialog::JointFitDialog(const QStringList& names, const QList<QJsonObject>& states, QWidget* parent)
+    : QDialog(parent), m_names(names), m_states(states), m_stopRequested(0)
+{
+    setWindowTitle("联合拟合");
+    resize(820, 600);
+    setStyleSheet("QDialog { background-color: white; color: black; font-family: \"Microsoft YaHei\", Arial; } "
+                  "QLabel { color: black; background: transparent; } "
+                  "QCheckBox { color: black; background: transparent; } "
+                  "QSpinBox { color: black; background-color: white; } "
+                  "QListWidget { color: black; background-color: white; } "
+                  "QTableWidget { color: black; background-color: white; gridline-color: #ddd; } "
+                  "QHeaderView::section { color: black; background-color: #f0f0f0; border: 1px solid #ddd; padding: 2px; } "
+                  "QPushButton { color: white; background-color: #4a90e2; border: none; border-radius: 4px; padding: 6px 12px; } "
+                  "QPushButton:hover { background-color: #357abd; } "
+                  "QPushButton:disabled { background-color: #a0c4ef; }");
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QLabel* hint = new QLabel("勾选参与拟合的分析页与各页共用的参数 (例如同一储层的渗透率)。共用参数的初值、上下限与是否拟合取自第一个含该参数的分析页；"
+                              "其余拟合参数各页独立。");
+    hint->setWordWrap(true);
+    mainLayout->addWidget(hint);
+
+    // 分析页列表：统计各参数在几个页中参与拟合
+    m_listTests = new QListWidget;
+    QMap<QString, int> fitCount;
+    for (int i = 0; i < m_names.size(); ++i) {
+        QListWidgetItem* item = new QListWidgetItem(m_names[i], m_listTests);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Checked);
+        for (const QJsonValue& v : m_states[i]["parameters"].toArray()) {
+            QJsonObject p = v.toObject();
+            if (p["isFit"].toBool()) ++fitCount[p["name"].toString()];
+        }
+    }
+
+    // 参数表：拟合参数的并集
+    m_paramNames = fitCount.keys();
+    m_tableParams = new QTableWidget(m_paramNames.size(), 4);
+    m_tableParams->setHorizontalHeaderLabels({ "参数", "拟合页数", "共用", "共用值" });
+    m_tableParams->verticalHeader()->setVisible(false);
+    m_tableParams->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_tableParams->horizontalHeader()->setStretchLastSection(true);
+    for (int r = 0; r < m_paramNames.size(); ++r) {
+        const QString& name = m_paramNames[r];
+        m_tableParams->setItem(r, 0, readOnlyItem(name));
+        m_tableParams->setItem(r, 1, readOnlyItem(QString::number(fitCount.value(name))));
+        QTableWidgetItem* linkItem = new QTableWidgetItem;
+        linkItem->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        bool link = fitCount.value(name) >= 2 && name != "S" && name != "cD";
+        linkItem->setCheckState(link ? Qt::Checked : Qt::Unchecked);
+        m_tableParams->setItem(r, 2, linkItem);
+        m_tableParams->setItem(r, 3, readOnlyItem("-"));
+    }
+
+    QHBoxLayout* listLayout = new QHBoxLayout;
+    QVBoxLayout* leftLayout = new QVBoxLayout;
+    leftLayout->addWidget(new QLabel("分析页 (误差):"));
+    leftLayout->addWidget(m_listTests);
+    QVBoxLayout* rightLayout = new QVBoxLayout;
+    rightLayout->addWidget(new QLabel("拟合参数:"));
+    rightLayout->addWidget(m_tableParams);
+    listLayout->addLayout(leftLayout, 1);
+    listLayout->addLayout(rightLayout, 1);
+    mainLayout->addLayout(listLayout, 1);
+
+    QHBoxLayout* optionLayout = new QHBoxLayout;
+    m_spinIterations = new QSpinBox;
+    m_spinIterations->setRange(1, 1000);
+    m_spinIterations->setValue(FittingCore::Options().maxIterations);
+    m_checkEqualWeights = new QCheckBox("按点数均衡各页权重");
+    m_checkEqualWeights->setToolTip("各页残差乘以 sqrt(平均点数 / 本页点数)，点多的测试不会主导共用参数");
+    m_checkEqualWeights->setChecked(true);
+    optionLayout->addWidget(new QLabel("最大迭代次数:"));
+    optionLayout->addWidget(m_spinIterations);
+    optionLayout->addWidget(m_checkEqualWeights);
+    optionLayout->addStretch();
+    mainLayout->addLayout(optionLayout);
+
+    m_progress = new QProgressBar;
+    m_progress->setRange(0, 100);
+    m_progress->setValue(0);
+    m_labelStatus = new QLabel;
+    m_labelStatus->setWordWrap(true);
+    mainLayout->addWidget(m_progress);
+    mainLayout->addWidget(m_labelStatus);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    m_btnStart = new QPushButton("开始拟合");
+    m_btnApply = new QPushButton("应用到各页");
+    m_btnApply->setEnabled(false);
+    QPushButton* btnClose = new QPushButton("关闭");
+    btnClose->setStyleSheet("background-color: #6c757d; color: white;");
+    btnLayout->addStretch();
+    btnLayout->addWidget(m_btnStart);
+    btnLayout->addWidget(m_btnApply);
+    btnLayout->addWidget(btnClose);
+    mainLayout->addLayout(btnLayout);
+
+    connect(m_btnStart, &QPushButton::clicked, this, &JointFitDialog::onStart);
+    connect(m_btnApply, &QPushButton::clicked, this, &QDialog::accept);
+    connect(btnClose, &QPushButton::clicked, this, &JointFitDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<JointFitter::Result>::finished, this, &JointFitDialog::onFinished);
+}
+
+JointFitDialog::~JointFitDialog()
+{
+    m_stopRequested.storeRelaxed(1);
+    m_watcher.waitForFinished();
+}
+
+void JointFitDialog::reject()
+{
+    m_stopRequested.storeRelaxed(1);
+    m_watcher.waitForFinished();
+    QDialog::reject();
+}
+
+void JointFitDialog::setRunning(bool running)
+{
+    m_btnStart->setText(running ? "停止" : "开始拟合");
+    m_listTests->setEnabled(!running);
+    m_tableParams->setEnabled(!running);
+    m_spinIterations->setEnabled(!running);
+    m_checkEqualWeights->setEnabled(!running);
+    if (running) m_btnApply->setEnabled(false);
+}
+
+void JointFitDialog::onStart()
+{
+    if (m_watcher.isRunning()) {
+        m_stopRequested.storeRelaxed(1);
+        m_btnStart->setEnabled(false);
+        return;
+    }
+
+    // 各页按批量拟合的规则解析，每页一个求解器
+    m_runIndices.clear();
+    m_tests.clear();
+    QStringList errors;
+    for (int i = 0; i < m_listTests->count(); ++i) {
+        QListWidgetItem* item = m_listTests->item(i);
+        item->setText(m_names[i]);
+        if (item->checkState() != Qt::Checked) continue;
+        BatchFitQueue::FitSetup setup;
+        QString error = BatchFitQueue::parseState(m_states[i], setup);
+        if (!error.isEmpty()) {
+            errors << QString("%1: %2").arg(m_names[i], error);
+            continue;
+        }
+        JointFitter::Test test;
+        test.name = m_names[i];
+        test.core = QSharedPointer<FittingCore>::create(QSharedPointer<ModelSolver01_06>::create(setup.modelType));
+        test.core->setObservedData(setup.fitT, setup.fitP, setup.fitD);
+        test.core->setFitWindows(setup.windows);
+        test.params = setup.params;
+        test.weight = setup.weight;
+        m_tests.append(test);
+        m_runIndices.append(i);
+    }
+    if (!errors.isEmpty()) {
+        QMessageBox::warning(this, "联合拟合", "以下分析页无法参与拟合：\n" + errors.join("\n"));
+        return;
+    }
+    if (m_tests.size() < 2) {
+        QMessageBox::information(this, "联合拟合", "请至少勾选两个分析页。");
+        return;
+    }
+
+    JointFitter::Options options;
+    options.fit.maxIterations = m_spinIterations->value();
+    options.equalTestWeights = m_checkEqualWeights->isChecked();
+    for (int r = 0; r < m_paramNames.size(); ++r) {
+        if (m_tableParams->item(r, 2)->checkState() == Qt::Checked) options.linkedNames << m_paramNames[r];
+    }
+
+    m_stopRequested.storeRelaxed(0);
+    m_resultStates.clear();
+    m_progress->setValue(0);
+    m_labelStatus->setText(QString("正在拟合 %1 个分析页...").arg(m_tests.size()));
+    setRunning(true);
+
+    const QList<JointFitter::Test> tests = m_tests;
+    m_watcher.setFuture(QtConcurrent::run([this, tests, options]() {
+        JointFitter fitter;
+        fitter.setStopPredicate([this]() { return m_stopRequested.loadRelaxed() != 0; });
+        fitter.setProgressCallback([this](int percent) {
+            QMetaObject::invokeMethod(m_progress, [this, percent]() { m_progress->setValue(percent); }, Qt::QueuedConnection);
+        });
+        fitter.setIterationCallback([this](double mse, const QList<QMap<QString, double>>& params) {
+            QMetaObject::invokeMethod(this, [this, mse, params]() { onIteration(mse, params); }, Qt::QueuedConnection);
+        });
+        return fitter.run(tests, options);
+    }));
+}
+
+void JointFitDialog::onIteration(double mse, const QList<QMap<QString, double>>& params)
+{
+    m_labelStatus->setText(QString("联合拟合中，MSE = %1").arg(formatMse(mse)));
+    // 共用参数在各页取值相同，显示第一个含该参数的页
+    for (int r = 0; r < m_paramNames.size(); ++r) {
+        if (m_tableParams->item(r, 2)->checkState() != Qt::Checked) continue;
+        for (const QMap<QString, double>& map : params) {
+            if (!map.contains(m_paramNames[r])) continue;
+            m_tableParams->item(r, 3)->setText(QString::number(map.value(m_paramNames[r]), 'g', 6));
+            break;
+        }
+    }
+}
+
+void JointFitDialog::onFinished()
+{
+    const JointFitter::Result result = m_watcher.result();
+    m_tests.clear();
+    setRunning(false);
+    m_btnStart->setEnabled(true);
+    onIteration(result.mse, result.params);
+
+    if (result.stopped) {
+        m_labelStatus->setText("已停止，结果未保留。");
+        return;
+    }
+    m_progress->setValue(100);
+    for (int k = 0; k < m_runIndices.size() && k < result.params.size(); ++k) {
+        const int index = m_runIndices[k];
+        QJsonObject state = m_states[index];
+        BatchFitQueue::writeParameters(state, result.params[k]);
+        m_resultStates.insert(index, state);
+        m_listTests->item(index)->setText(QString("%1  (MSE %2)").arg(m_names[index], formatMse(result.testMse.value(k))));
+    }
+    m_labelStatus->setText(QString("完成：%1 次迭代，%2 次雅可比，共用变量 %3 个、独立变量 %4 个，联合 MSE = %5，耗时 %6 ms")
+                               .arg(result.iterations)
+                               .arg(result.jacobianEvaluations)
+                               .arg(result.sharedVariables)
+                               .arg(result.localVariables)
+                               .arg(formatMse(result.mse))
+                               .arg(result.elapsedMs));
+    m_btnApply->setEnabled(!m_resultStates.isEmpty());
+}
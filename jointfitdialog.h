@@ -0,0 +1,69 @@
+/*
+ * 文件名: jointfitdialog.h
+ * 文件作用: 多测试联合拟合对话框头文件
+ * 功能描述:
+ * 1. 列出各分析页，勾选参与联合拟合的页；参数表列出各页拟合参数的并集，勾选“共用”的参数在所有页取同一个值。
+ * 2. 联合拟合 (JointFitter) 在后台线程运行，可随时停止；各页的误差与共用参数的当前值随迭代刷新。
+ * 3. 拟合完成后点“应用”，各页的状态 (参数表已写入拟合值) 经 resultStates 交回拟合页面。
+ */
+
+#ifndef JOINTFITDIALOG_H
+#define JOINTFITDIALOG_H
+
+#include <QDialog>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QMap>
+#include "jointfitter.h"
+
+class QCheckBox;
+class QLabel;
+class QListWidget;
+class QProgressBar;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+class JointFitDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // names 与 states 一一对应 (分析页名称与 FittingWidget::getJsonState 格式的状态)
+    JointFitDialog(const QStringList& names, const QList<QJsonObject>& states, QWidget* parent = nullptr);
+    ~JointFitDialog();
+
+    // 应用后：分析页序号 (names 中的位置) -> 写入拟合值后的状态
+    QMap<int, QJsonObject> resultStates() const { return m_resultStates; }
+
+protected:
+    void reject() override;
+
+private:
+    void onStart();
+    void onFinished();
+    void onIteration(double mse, const QList<QMap<QString, double>>& params);
+    void setRunning(bool running);
+
+    QStringList m_names;
+    QList<QJsonObject> m_states;
+    QStringList m_paramNames;           // 参数表各行的参数名
+
+    QVector<int> m_runIndices;          // 本次参与拟合的分析页序号
+    QList<JointFitter::Test> m_tests;
+    QFutureWatcher<JointFitter::Result> m_watcher;
+    QAtomicInt m_stopRequested;
+    QMap<int, QJsonObject> m_resultStates;
+
+    QListWidget* m_listTests;
+    QTableWidget* m_tableParams;
+    QSpinBox* m_spinIterations;
+    QCheckBox* m_checkEqualWeights;
+    QProgressBar* m_progress;
+    QLabel* m_labelStatus;
+    QPushButton* m_btnStart;
+    QPushButton* m_btnApply;
+};
+
+#endif // JOINTFITDIALOG_H
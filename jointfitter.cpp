@@ -0,0 +1,211 @@
+/*
+ * 文件名: jointfitter.cpp
+ * 文件作用: 多测试联合拟合实现
+ * 功能描述:
+ * 1. 优化变量：共用参数各一个，其余拟合参数每个测试各一个；对数/线性与 FittingCore 的取法一致。
+ * 2. 残差与雅可比按测试分块并发求值 (FittingCore::evaluateBlock)，雅可比列映射到联合变量后拼接。
+ * 3. 迭代由 LeastSquaresOptimizer 完成，结束后在最终参数处单独计算各测试的误差。
+ */
+
+#include "jointfitter.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 一个优化变量：test < 0 为共用参数
+struct Variable {
+    QString name;
+    int test = -1;
+    bool logScale = false;
+};
+
+} // namespace
+
+JointFitter::Result JointFitter::run(const QList<Test>& tests, const Options& options)
+{
+    Result result;
+    for (const Test& test : tests) {
+        QMap<QString, double> map;
+        for (const FitParameter& p : test.params) map.insert(p.name, p.value);
+        result.params.append(map);
+    }
+    result.testMse.fill(std::numeric_limits<double>::infinity(), tests.size());
+    const int testCount = tests.size();
+    for (const Test& test : tests) {
+        if (!test.core) return result;
+    }
+    if (testCount == 0) return result;
+    QElapsedTimer clock;
+    clock.start();
+
+    // 共用参数的初值与拟合状态取自第一个含该参数的测试，先统一写入各测试的初值
+    QMap<QString, FitParameter> linked;
+    for (const QString& name : options.linkedNames) {
+        for (const Test& test : tests) {
+            auto it = std::find_if(test.params.begin(), test.params.end(), [&](const FitParameter& p) { return p.name == name; });
+            if (it != test.params.end()) {
+                linked.insert(name, *it);
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < testCount; ++i) {
+        for (auto it = linked.constBegin(); it != linked.constEnd(); ++it) {
+            if (result.params[i].contains(it.key())) result.params[i][it.key()] = it.value().value;
+        }
+    }
+
+    // 优化变量与上下限
+    QVector<Variable> variables;
+    QVector<double> x0List, lowerList, upperList;
+    auto addVariable = [&](const FitParameter& p, int test) {
+        Variable v;
+        v.name = p.name;
+        v.test = test;
+        v.logScale = FittingCore::optimizesInLogSpace(p);
+        variables.append(v);
+        if (v.logScale) {
+            x0List.append(std::log10(p.value));
+            lowerList.append(p.min > 0 ? std::log10(p.min) : -std::numeric_limits<double>::infinity());
+            upperList.append(p.max > 0 ? std::log10(p.max) : std::log10(p.value));
+        } else {
+            x0List.append(p.value);
+            lowerList.append(p.min);
+            upperList.append(p.max);
+        }
+    };
+    for (auto it = linked.constBegin(); it != linked.constEnd(); ++it) {
+        if (it.value().isFit) addVariable(it.value(), -1);
+    }
+    result.sharedVariables = variables.size();
+    for (int i = 0; i < testCount; ++i) {
+        for (const FitParameter& p : tests[i].params) {
+            if (p.isFit && !linked.contains(p.name)) addVariable(p, i);
+        }
+    }
+    const int nVars = variables.size();
+    result.localVariables = nVars - result.sharedVariables;
+    if (nVars == 0) return result;
+
+    // 各测试的拟合参数名、对应的联合变量列与残差块位置
+    QVector<QStringList> blockNames(testCount);
+    QVector<QVector<bool>> blockLog(testCount);
+    QVector<QVector<int>> blockColumns(testCount);
+    QVector<int> rowOffset(testCount), rowCount(testCount);
+    QVector<double> blockScale(testCount, 1.0);
+    int totalRows = 0;
+    for (int i = 0; i < testCount; ++i) {
+        for (int j = 0; j < nVars; ++j) {
+            const Variable& v = variables[j];
+            if (v.test == i || (v.test < 0 && result.params[i].contains(v.name))) {
+                blockNames[i].append(v.name);
+                blockLog[i].append(v.logScale);
+                blockColumns[i].append(j);
+            }
+        }
+        rowOffset[i] = totalRows;
+        rowCount[i] = tests[i].core->residualCount();
+        totalRows += rowCount[i];
+    }
+    if (totalRows == 0) return result;
+    if (options.equalTestWeights) {
+        const double average = double(totalRows) / testCount;
+        for (int i = 0; i < testCount; ++i) {
+            if (rowCount[i] > 0) blockScale[i] = std::sqrt(average / rowCount[i]);
+        }
+    }
+
+    auto toParamMaps = [&](const Eigen::VectorXd& x) {
+        QList<QMap<QString, double>> maps = result.params;
+        for (int j = 0; j < nVars; ++j) {
+            const Variable& v = variables[j];
+            const double value = v.logScale ? std::pow(10.0, x[j]) : x[j];
+            for (int i = 0; i < testCount; ++i) {
+                if ((v.test == i || v.test < 0) && maps[i].contains(v.name)) maps[i][v.name] = value;
+            }
+        }
+        return maps;
+    };
+
+    for (const Test& test : tests) test.core->setStopPredicate(m_stopRequested);
+    const bool highPrecision = options.fit.highPrecision;
+    QVector<int> indices(testCount);
+    for (int i = 0; i < testCount; ++i) indices[i] = i;
+
+    // 各测试的块并发求值，再按行偏移与列映射拼接 (块之间没有共享状态)
+    QVector<Eigen::VectorXd> blockR(testCount);
+    QVector<Eigen::MatrixXd> blockJ(testCount);
+    QVector<char> blockOk(testCount);
+    auto evaluateBlocks = [&](const Eigen::VectorXd& x, bool withJacobian) {
+        const QList<QMap<QString, double>> maps = toParamMaps(x);
+        QtConcurrent::blockingMap(indices, [&](int i) {
+            blockOk[i] = tests[i].core->evaluateBlock(maps[i], blockNames[i], blockLog[i], tests[i].weight, highPrecision,
+                                                      blockR[i], withJacobian ? &blockJ[i] : nullptr)
+                         && blockR[i].size() == rowCount[i];
+        });
+        for (char ok : blockOk) {
+            if (!ok) return false;
+        }
+        return true;
+    };
+
+    LeastSquaresOptimizer::Problem problem;
+    problem.residualCount = totalRows;
+    problem.lower = Eigen::Map<const Eigen::VectorXd>(lowerList.constData(), nVars);
+    problem.upper = Eigen::Map<const Eigen::VectorXd>(upperList.constData(), nVars);
+    problem.residuals = [&](const Eigen::VectorXd& x, Eigen::VectorXd& r) {
+        if (!evaluateBlocks(x, false)) return false;
+        for (int i = 0; i < testCount; ++i) r.segment(rowOffset[i], rowCount[i]) = blockScale[i] * blockR[i];
+        return true;
+    };
+    problem.jacobian = [&](const Eigen::VectorXd& x, const Eigen::VectorXd&, Eigen::MatrixXd& J) {
+        if (!evaluateBlocks(x, true)) return false;
+        J.setZero();
+        for (int i = 0; i < testCount; ++i) {
+            for (int c = 0; c < blockColumns[i].size(); ++c) {
+                J.block(rowOffset[i], blockColumns[i][c], rowCount[i], 1) = blockScale[i] * blockJ[i].col(c);
+            }
+        }
+        return true;
+    };
+
+    LeastSquaresOptimizer::Options optimizerOptions;
+    optimizerOptions.algorithm = options.fit.algorithm;
+    optimizerOptions.stop.maxIterations = options.fit.maxIterations;
+    optimizerOptions.stop.targetMse = options.fit.targetMse;
+    optimizerOptions.initialLambda = options.fit.initialLambda;
+    optimizerOptions.jacobianRefreshInterval = options.fit.jacobianRefreshInterval;
+
+    LeastSquaresOptimizer optimizer;
+    optimizer.setAcceptCallback([&](const Eigen::VectorXd& x, double sse) {
+        if (m_onIteration) m_onIteration(sse / totalRows, toParamMaps(x));
+    });
+    optimizer.setProgressCallback(m_onProgress);
+    optimizer.setStopPredicate(m_stopRequested);
+
+    Eigen::VectorXd x0 = Eigen::Map<const Eigen::VectorXd>(x0List.constData(), nVars);
+    LeastSquaresOptimizer::Result opt = optimizer.minimize(problem, x0, optimizerOptions);
+
+    result.params = toParamMaps(opt.x);
+    for (QMap<QString, double>& map : result.params) FittingCore::updateDependentParameters(map);
+    result.sse = opt.sse;
+    result.mse = opt.sse / totalRows;
+    result.iterations = opt.iterations;
+    result.jacobianEvaluations = opt.jacobianEvaluations;
+    result.stopped = m_stopRequested && m_stopRequested();
+
+    // 各测试自身的误差 (停止后不再求值)
+    if (!result.stopped && evaluateBlocks(opt.x, false)) {
+        for (int i = 0; i < testCount; ++i) {
+            result.testMse[i] = rowCount[i] > 0 ? blockR[i].squaredNorm() / rowCount[i] : 0.0;
+        }
+    }
+    for (const Test& test : tests) test.core->setStopPredicate(FittingCore::StopPredicate());
+    result.elapsedMs = clock.elapsed();
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+ * 文件名: jointfitter.h
+ * 文件作用: 多测试联合拟合头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 若干个测试 (各自的观测数据、模型、参数表与权重) 组成一个最小二乘问题，各测试的残差块纵向拼接。
+ * 2. 共用参数 (例如同一储层的 kf、km) 在所有测试中取同一个值，作为一个优化变量；其余拟合参数各测试独立。
+ * 3. 每次求值时各测试的残差块与雅可比块在线程池中并发计算，每个测试使用自己的 FittingCore 与求解器。
+ * 4. 可按点数均衡各测试的权重，避免点多的测试主导共用参数。
+ */
+
+#ifndef JOINTFITTER_H
+#define JOINTFITTER_H
+
+#include <QList>
+#include <QMap>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include "fittingcore.h"
+
+class JointFitter
+{
+public:
+    // 参与联合拟合的一个测试：core 已设置好观测数据 (与时间窗口、产量历史)，拟合期间独占使用
+    struct Test {
+        QString name;
+        QSharedPointer<FittingCore> core;
+        QList<FitParameter> params;
+        double weight = 0.5;            // 压差残差权重 (导数权重为 1-weight)
+    };
+
+    struct Options {
+        // 优化选项：使用 algorithm、maxIterations、initialLambda、targetMse、highPrecision 与 jacobianRefreshInterval
+        FittingCore::Options fit;
+        // 共用参数名：初值、上下限与是否拟合取自第一个含该参数的测试，结果写回所有含该参数的测试
+        QStringList linkedNames;
+        // 各测试残差块乘以 sqrt(平均行数 / 本测试行数)，使每个测试对目标函数的贡献与点数无关
+        bool equalTestWeights = true;
+    };
+
+    struct Result {
+        QList<QMap<QString, double>> params; // 各测试的参数 (顺序与输入一致)
+        QVector<double> testMse;             // 各测试自身 (未均衡) 的均方误差
+        double mse = 0.0;                    // 联合目标函数的均方误差 (均衡后)
+        double sse = 0.0;
+        int iterations = 0;
+        int jacobianEvaluations = 0;
+        int sharedVariables = 0;             // 共用优化变量个数
+        int localVariables = 0;              // 各测试独立的优化变量个数之和
+        qint64 elapsedMs = 0;
+        bool stopped = false;
+    };
+
+    // 回调：起点与每个接受步 (在调用 run 的线程中调用)、进度百分比、停止请求查询
+    using IterationCallback = std::function<void(double mse, const QList<QMap<QString, double>>& params)>;
+    using ProgressCallback = std::function<void(int percent)>;
+    using StopPredicate = std::function<bool()>;
+
+    void setIterationCallback(IterationCallback cb) { m_onIteration = cb; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    // 执行联合拟合；没有测试或没有优化变量时返回初值
+    Result run(const QList<Test>& tests, const Options& options);
+
+private:
+    IterationCallback m_onIteration;
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+};
+
+#endif // JOINTFITTER_H
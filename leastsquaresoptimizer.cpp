@@ -0,0 +1,420 @@
+/*
+ * 文件名: leastsquaresoptimizer.cpp
+ * 文件作用: 有界非线性最小二乘优化引擎实现
+ * 功能描述:
+ * 1. LM：增广矩阵 [J; sqrt(lambda*D)] 的列主元 QR 求阻尼步，每次迭代最多尝试 5 个阻尼值。
+ * 2. Dogleg：QR 求 Gauss-Newton 步，按实际/预测下降比调整信赖域半径。
+ * 3. 有界 L-BFGS：两循环递推求方向，沿投影路径做 Armijo 回溯线搜索。
+ * 4. 每一步都投影到上下限内，Broyden 更新使用投影后的实际步长。
+ * 5. LM 与 Dogleg 的 QR 求解计入 HotPathProfiler (线性子问题的耗时与次数)。
+ */
+
+#include "leastsquaresoptimizer.h"
+#include "hotpathprofiler.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+LeastSquaresOptimizer::Result LeastSquaresOptimizer::minimize(const Problem& problem, const Eigen::VectorXd& x0, const Options& options)
+{
+    Result result;
+    result.x = x0;
+    project(problem, result.x);
+
+    const int m = problem.residualCount;
+    const int n = x0.size();
+    if (m <= 0 || n <= 0 || !problem.residuals || !problem.jacobian) return result;
+
+    // 工作数组一次性分配，迭代中只在其中读写
+    m_J.setZero(m, n);
+    m_trialX.resize(n);
+    m_trialR.resize(m);
+    m_step.resize(n);
+    m_gradient.resize(n);
+    m_work.resize(n);
+    m_workM.resize(m);
+    if (options.algorithm == LevenbergMarquardt) {
+        m_augmented.resize(m + n, n);
+        m_rhs.resize(m + n);
+        m_qr = Eigen::ColPivHouseholderQR<Eigen::MatrixXd>(m + n, n);
+    } else if (options.algorithm == DoglegTrustRegion) {
+        m_rhs.resize(m);
+        m_qr = Eigen::ColPivHouseholderQR<Eigen::MatrixXd>(m, n);
+    }
+
+    result.residuals.resize(m);
+    if (!evaluate(problem, result.x, result.residuals, result)) {
+        result.sse = std::numeric_limits<double>::infinity();
+        return result;
+    }
+    result.sse = result.residuals.squaredNorm();
+    if (m_onAccept) m_onAccept(result.x, result.sse);
+
+    switch (options.algorithm) {
+    case DoglegTrustRegion: runDogleg(problem, options, result); break;
+    case BoundedLBFGS: runBoundedLBFGS(problem, options, result); break;
+    case LevenbergMarquardt:
+    default: runLevenbergMarquardt(problem, options, result); break;
+    }
+
+    result.converged = (result.sse / m) < options.stop.targetMse;
+    return result;
+}
+
+const char* LeastSquaresOptimizer::algorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case DoglegTrustRegion: return "dogleg";
+    case BoundedLBFGS: return "lbfgsb";
+    case LevenbergMarquardt:
+    default: return "lm";
+    }
+}
+
+bool LeastSquaresOptimizer::shouldStop(const Problem& problem, const Options& options, int iter, Result& result) const
+{
+    if (m_stopRequested && m_stopRequested()) return true;
+    if ((result.sse / problem.residualCount) < options.stop.targetMse) return true;
+    if (m_onProgress) m_onProgress(iter * 100 / std::max(1, options.stop.maxIterations));
+    result.iterations = iter + 1;
+    return false;
+}
+
+bool LeastSquaresOptimizer::evaluate(const Problem& problem, const Eigen::VectorXd& x, Eigen::VectorXd& r, Result& result) const
+{
+    ++result.residualEvaluations;
+    if (!problem.residuals(x, r)) return false;
+    return r.allFinite();
+}
+
+bool LeastSquaresOptimizer::evaluateJacobian(const Problem& problem, const Eigen::VectorXd& x, const Eigen::VectorXd& r, Result& result)
+{
+    ++result.jacobianEvaluations;
+    if (!problem.jacobian(x, r, m_J)) return false;
+    // 个别元素非数时该元素按 0 处理，避免整列污染线性子问题
+    if (!m_J.allFinite()) m_J = m_J.unaryExpr([](double v) { return std::isfinite(v) ? v : 0.0; });
+    return true;
+}
+
+void LeastSquaresOptimizer::project(const Problem& problem, Eigen::VectorXd& x)
+{
+    if (problem.lower.size() == x.size()) x = x.cwiseMax(problem.lower);
+    if (problem.upper.size() == x.size()) x = x.cwiseMin(problem.upper);
+}
+
+bool LeastSquaresOptimizer::takeInitialJacobian(const Options& options)
+{
+    const Eigen::MatrixXd& J = options.initialJacobian;
+    if (J.rows() != m_J.rows() || J.cols() != m_J.cols() || J.size() == 0 || !J.allFinite()) return false;
+    m_J = J;
+    return true;
+}
+
+void LeastSquaresOptimizer::broydenUpdate(Eigen::VectorXd& dr, const Eigen::VectorXd& s)
+{
+    double ss = s.squaredNorm();
+    if (ss < 1e-300) return;
+    dr.noalias() -= m_J * s;
+    m_J.noalias() += (dr / ss) * s.transpose();
+}
+
+// ---------------------------------------------------------------------------
+// Levenberg-Marquardt
+// (J^T J + lambda*diag(1+|H_ii|)) dx = -J^T r 等价于增广最小二乘 min ||[J; sqrt(lambda*D)] dx + [r; 0]||
+// ---------------------------------------------------------------------------
+void LeastSquaresOptimizer::runLevenbergMarquardt(const Problem& problem, const Options& options, Result& result)
+{
+    const int m = problem.residualCount;
+    const int n = result.x.size();
+    const int refreshInterval = std::max(1, options.jacobianRefreshInterval);
+
+    double lambda = options.initialLambda;
+    // jacobianAge: 当前雅可比自上次完整计算以来接受的步数，达到间隔时重新完整计算
+    int jacobianAge = refreshInterval;
+    // 调用方给出的雅可比：第一步直接使用，步长被拒时与 Broyden 近似一样重新完整计算
+    bool givenJacobian = takeInitialJacobian(options);
+    if (givenJacobian) jacobianAge = 0;
+
+    for (int iter = 0; iter < options.stop.maxIterations; ++iter) {
+        if (shouldStop(problem, options, iter, result)) break;
+
+        if (jacobianAge >= refreshInterval) {
+            if (!evaluateJacobian(problem, result.x, result.residuals, result)) break;
+            jacobianAge = 0;
+            givenJacobian = false;
+        }
+        // 对角阻尼系数 1+|H_ii|，H_ii 为雅可比列范数平方
+        m_work = m_J.colwise().squaredNorm().transpose();
+        m_work.array() += 1.0;
+
+        bool stepAccepted = false;
+        for (int tryIter = 0; tryIter < 5; ++tryIter) {
+            m_augmented.topRows(m) = m_J;
+            m_augmented.bottomRows(n).setZero();
+            m_augmented.bottomRows(n).diagonal() = (lambda * m_work.array()).sqrt().matrix();
+            m_rhs.head(m) = -result.residuals;
+            m_rhs.tail(n).setZero();
+
+            {
+                WT_PROFILE_SCOPE(StepSolveScope);
+                WT_PROFILE_COUNT(StepSolves, 1);
+                m_qr.compute(m_augmented);
+                m_step = m_qr.solve(m_rhs);
+            }
+
+            m_trialX = result.x + m_step;
+            project(problem, m_trialX);
+
+            if (evaluate(problem, m_trialX, m_trialR, result)) {
+                double newSSE = m_trialR.squaredNorm();
+                if (newSSE < result.sse) {
+                    // 未到完整重算的间隔时，用本步的残差变化修正雅可比供下次迭代使用
+                    ++jacobianAge;
+                    if (jacobianAge < refreshInterval) {
+                        m_step = m_trialX - result.x;
+                        m_workM = m_trialR - result.residuals;
+                        broydenUpdate(m_workM, m_step);
+                    }
+                    result.x.swap(m_trialX);
+                    result.residuals.swap(m_trialR);
+                    result.sse = newSSE;
+                    lambda /= 10.0;
+                    stepAccepted = true;
+                    givenJacobian = false;
+                    if (m_onAccept) m_onAccept(result.x, result.sse);
+                    break;
+                }
+            }
+            lambda *= 10.0;
+        }
+        if (!stepAccepted) {
+            // 近似雅可比失效时先重新完整计算，只有完整雅可比也无法下降时才结束
+            if (givenJacobian) {
+                // 被拒是给定的雅可比不准，阻尼恢复初值
+                jacobianAge = refreshInterval;
+                lambda = options.initialLambda;
+            } else if (jacobianAge > 0) {
+                jacobianAge = refreshInterval;
+            } else if (lambda > 1e10) {
+                break;
+            }
+        }
+    }
+    result.jacobian = m_J;
+    result.damping = lambda;
+}
+
+// ---------------------------------------------------------------------------
+// Dogleg 信赖域
+// 模型 m(p) = 0.5*||r + J p||^2，rho = 实际下降 / 模型预测下降
+// ---------------------------------------------------------------------------
+void LeastSquaresOptimizer::runDogleg(const Problem& problem, const Options& options, Result& result)
+{
+    const int refreshInterval = std::max(1, options.jacobianRefreshInterval);
+    const double maxRadius = 1e3 * options.initialRadius;
+
+    double radius = options.initialRadius;
+    int jacobianAge = refreshInterval;
+    bool givenJacobian = takeInitialJacobian(options);
+    if (givenJacobian) jacobianAge = 0;
+
+    for (int iter = 0; iter < options.stop.maxIterations; ++iter) {
+        if (shouldStop(problem, options, iter, result)) break;
+
+        if (jacobianAge >= refreshInterval) {
+            if (!evaluateJacobian(problem, result.x, result.residuals, result)) break;
+            jacobianAge = 0;
+            givenJacobian = false;
+        }
+
+        // 梯度 g = J^T r 与 Cauchy 步 (沿 -g 的模型极小点)
+        m_gradient.noalias() = m_J.transpose() * result.residuals;
+        double gNorm = m_gradient.norm();
+        if (gNorm < 1e-300) break;
+        m_workM.noalias() = m_J * m_gradient;
+        double jgNorm2 = m_workM.squaredNorm();
+        double alpha = jgNorm2 > 1e-300 ? (gNorm * gNorm) / jgNorm2 : radius / gNorm;
+
+        // Gauss-Newton 步：min ||J p + r||
+        m_rhs = -result.residuals;
+        {
+            WT_PROFILE_SCOPE(StepSolveScope);
+            WT_PROFILE_COUNT(StepSolves, 1);
+            m_qr.compute(m_J);
+            m_work = m_qr.solve(m_rhs);
+        }
+        double gnNorm = m_work.norm();
+
+        if (std::isfinite(gnNorm) && gnNorm <= radius) {
+            m_step = m_work;
+        } else if (alpha * gNorm >= radius || !std::isfinite(gnNorm)) {
+            m_step = (-radius / gNorm) * m_gradient;
+        } else {
+            // 从 Cauchy 点沿 (p_gn - p_sd) 走到信赖域边界：||p_sd + tau*d|| = radius
+            m_step = -alpha * m_gradient;
+            m_work -= m_step;
+            double a = m_work.squaredNorm();
+            double b = 2.0 * m_step.dot(m_work);
+            double c = m_step.squaredNorm() - radius * radius;
+            double tau = a > 1e-300 ? (-b + std::sqrt(std::max(0.0, b * b - 4.0 * a * c))) / (2.0 * a) : 0.0;
+            m_step += tau * m_work;
+        }
+
+        m_trialX = result.x + m_step;
+        project(problem, m_trialX);
+        m_step = m_trialX - result.x;
+        double stepNorm = m_step.norm();
+
+        m_workM.noalias() = m_J * m_step;
+        double predicted = -(m_gradient.dot(m_step) + 0.5 * m_workM.squaredNorm());
+
+        double rho = -1.0;
+        double newSSE = result.sse;
+        if (predicted > 0.0 && evaluate(problem, m_trialX, m_trialR, result)) {
+            newSSE = m_trialR.squaredNorm();
+            rho = 0.5 * (result.sse - newSSE) / predicted;
+        }
+
+        if (rho < 0.25) radius = 0.25 * std::max(stepNorm, options.stop.minStepNorm);
+        else if (rho > 0.75 && stepNorm > 0.99 * radius) radius = std::min(2.0 * radius, maxRadius);
+
+        if (rho > 1e-4 && newSSE < result.sse) {
+            ++jacobianAge;
+            if (jacobianAge < refreshInterval) {
+                m_workM = m_trialR - result.residuals;
+                broydenUpdate(m_workM, m_step);
+            }
+            result.x.swap(m_trialX);
+            result.residuals.swap(m_trialR);
+            result.sse = newSSE;
+            givenJacobian = false;
+            if (m_onAccept) m_onAccept(result.x, result.sse);
+        } else if (givenJacobian) {
+            // 给定的雅可比不准：重新完整计算，半径恢复初值
+            jacobianAge = refreshInterval;
+            radius = options.initialRadius;
+        } else if (jacobianAge > 0) {
+            jacobianAge = refreshInterval;
+        }
+
+        if (radius < options.stop.minStepNorm) break;
+    }
+    result.jacobian = m_J;
+    result.damping = radius;
+}
+
+// ---------------------------------------------------------------------------
+// 有界 L-BFGS
+// 目标 f = 0.5*||r||^2，梯度 g = J^T r；活动集：处于下限且 g>0、处于上限且 g<0 的变量本次不动
+// ---------------------------------------------------------------------------
+void LeastSquaresOptimizer::runBoundedLBFGS(const Problem& problem, const Options& options, Result& result)
+{
+    const int n = result.x.size();
+    const int memory = std::max(1, options.lbfgsMemory);
+    const bool hasLower = problem.lower.size() == n;
+    const bool hasUpper = problem.upper.size() == n;
+
+    Eigen::MatrixXd S(n, memory), Y(n, memory);
+    Eigen::VectorXd rhoPair(memory), alphaPair(memory), gradNew(n);
+    Eigen::Array<bool, Eigen::Dynamic, 1> fixedVar(n);
+    int pairCount = 0, pairHead = 0; // 环形缓冲：pairHead 为最旧一对的位置
+
+    if (!evaluateJacobian(problem, result.x, result.residuals, result)) return;
+    m_gradient.noalias() = m_J.transpose() * result.residuals;
+
+    for (int iter = 0; iter < options.stop.maxIterations; ++iter) {
+        if (shouldStop(problem, options, iter, result)) break;
+
+        for (int i = 0; i < n; ++i) {
+            bool atLower = hasLower && result.x[i] <= problem.lower[i] && m_gradient[i] > 0.0;
+            bool atUpper = hasUpper && result.x[i] >= problem.upper[i] && m_gradient[i] < 0.0;
+            fixedVar[i] = atLower || atUpper;
+        }
+
+        // 两循环递推：m_work = -H * g (H 为逆 Hessian 近似)
+        m_work = -m_gradient;
+        for (int i = 0; i < n; ++i) if (fixedVar[i]) m_work[i] = 0.0;
+        for (int k = pairCount - 1; k >= 0; --k) {
+            int idx = (pairHead + k) % memory;
+            alphaPair[idx] = rhoPair[idx] * S.col(idx).dot(m_work);
+            m_work -= alphaPair[idx] * Y.col(idx);
+        }
+        if (pairCount > 0) {
+            int newest = (pairHead + pairCount - 1) % memory;
+            m_work *= S.col(newest).dot(Y.col(newest)) / Y.col(newest).squaredNorm();
+        } else {
+            // 首步：步长不超过 1 (对数参数即一个数量级)
+            double gInf = m_gradient.cwiseAbs().maxCoeff();
+            if (gInf > 1.0) m_work /= gInf;
+        }
+        for (int k = 0; k < pairCount; ++k) {
+            int idx = (pairHead + k) % memory;
+            double beta = rhoPair[idx] * Y.col(idx).dot(m_work);
+            m_work += (alphaPair[idx] - beta) * S.col(idx);
+        }
+        for (int i = 0; i < n; ++i) if (fixedVar[i]) m_work[i] = 0.0;
+
+        // 不是下降方向时退回投影最速下降并清空修正对
+        if (m_work.dot(m_gradient) >= 0.0) {
+            m_work = -m_gradient;
+            for (int i = 0; i < n; ++i) if (fixedVar[i]) m_work[i] = 0.0;
+            pairCount = 0;
+            pairHead = 0;
+        }
+        if (m_work.norm() < options.stop.minStepNorm) break;
+
+        // 沿投影路径的 Armijo 回溯线搜索
+        double f = 0.5 * result.sse;
+        double step = 1.0;
+        bool accepted = false;
+        double newSSE = result.sse;
+        for (int ls = 0; ls < 20; ++ls) {
+            m_trialX = result.x + step * m_work;
+            project(problem, m_trialX);
+            m_step = m_trialX - result.x;
+            if (evaluate(problem, m_trialX, m_trialR, result)) {
+                newSSE = m_trialR.squaredNorm();
+                if (0.5 * newSSE <= f + 1e-4 * m_gradient.dot(m_step) && newSSE < result.sse) {
+                    accepted = true;
+                    break;
+                }
+            }
+            step *= 0.5;
+        }
+        if (!accepted) {
+            if (pairCount == 0) break;
+            pairCount = 0;
+            pairHead = 0;
+            continue;
+        }
+
+        if (!evaluateJacobian(problem, m_trialX, m_trialR, result)) break;
+        gradNew.noalias() = m_J.transpose() * m_trialR;
+
+        // 修正对 (s, y)：曲率条件 s^T y > 0 不满足时丢弃
+        m_work = gradNew - m_gradient;
+        double sy = m_step.dot(m_work);
+        if (sy > 1e-12 * m_step.norm() * m_work.norm()) {
+            int idx;
+            if (pairCount < memory) {
+                idx = (pairHead + pairCount) % memory;
+                ++pairCount;
+            } else {
+                idx = pairHead;
+                pairHead = (pairHead + 1) % memory;
+            }
+            S.col(idx) = m_step;
+            Y.col(idx) = m_work;
+            rhoPair[idx] = 1.0 / sy;
+        }
+
+        double stepNorm = m_step.norm();
+        result.x.swap(m_trialX);
+        result.residuals.swap(m_trialR);
+        result.sse = newSSE;
+        m_gradient.swap(gradNew);
+        if (m_onAccept) m_onAccept(result.x, result.sse);
+
+        if (stepNorm < options.stop.minStepNorm) break;
+    }
+}
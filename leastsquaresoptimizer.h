@@ -0,0 +1,117 @@
+/*
+ * 文件名: leastsquaresoptimizer.h
+ * 文件作用: 有界非线性最小二乘优化引擎头文件 (不依赖界面和求解器)
+ * 功能描述:
+ * 1. 以残差函数、雅可比函数、上下限、停止条件描述问题，最小化 ||r(x)||^2。
+ * 2. 提供三种算法：Levenberg-Marquardt、Dogleg 信赖域、有界 L-BFGS (投影梯度 + 回溯线搜索)。
+ * 3. 雅可比与工作数组使用连续的 Eigen 存储，每次拟合开始时一次性分配，迭代中不再按行分配。
+ * 4. LM 与 Dogleg 的线性子问题用 QR 分解求解，不显式组成 J^T*J；可选用 Broyden 秩一更新代替部分雅可比计算。
+ * 5. LM 与 Dogleg 可从调用方给出的雅可比 (如上一次拟合结束时的雅可比) 开始，结果中返回结束时的雅可比与阻尼，供续算使用。
+ */
+
+#ifndef LEASTSQUARESOPTIMIZER_H
+#define LEASTSQUARESOPTIMIZER_H
+
+#include <Eigen/Dense>
+#include <functional>
+
+class LeastSquaresOptimizer
+{
+public:
+    // 优化算法
+    enum Algorithm {
+        LevenbergMarquardt = 0, // 阻尼 Gauss-Newton，对角阻尼 lambda*(1+|H_ii|)
+        DoglegTrustRegion,      // Powell dogleg：Gauss-Newton 步与最速下降步在信赖域内组合
+        BoundedLBFGS            // 有界 L-BFGS：目标 0.5*||r||^2，到达边界且梯度指向外侧的变量固定
+    };
+
+    // 残差函数：在 x 处计算残差写入 r (r 已按 residualCount 分配好)，无法求值时返回 false
+    using ResidualFunc = std::function<bool(const Eigen::VectorXd& x, Eigen::VectorXd& r)>;
+    // 雅可比函数：J(i, j) = dr_i/dx_j (J 已分配好)，r 为 x 处已求出的残差
+    using JacobianFunc = std::function<bool(const Eigen::VectorXd& x, const Eigen::VectorXd& r, Eigen::MatrixXd& J)>;
+
+    // 待求解问题：上下限为空向量时表示无界
+    struct Problem {
+        int residualCount = 0;
+        ResidualFunc residuals;
+        JacobianFunc jacobian;
+        Eigen::VectorXd lower;
+        Eigen::VectorXd upper;
+    };
+
+    // 停止条件
+    struct StopCriteria {
+        int maxIterations = 50;     // 最大迭代次数
+        double targetMse = 3e-3;    // ||r||^2 / residualCount 低于该值时结束
+        double minStepNorm = 1e-12; // 步长 (或信赖域半径) 低于该值时结束
+    };
+
+    // 算法选项
+    struct Options {
+        Algorithm algorithm = LevenbergMarquardt;
+        StopCriteria stop;
+        double initialLambda = 0.01;     // LM 阻尼初值
+        int jacobianRefreshInterval = 1; // LM / Dogleg：每隔多少个接受步完整计算雅可比，其间 Broyden 更新
+        double initialRadius = 1.0;      // Dogleg 初始信赖域半径
+        int lbfgsMemory = 6;             // L-BFGS 保存的修正对数
+        // LM / Dogleg：尺寸与问题一致时第一次迭代直接使用该雅可比 (视为近似雅可比，步长被拒时重新完整计算)
+        Eigen::MatrixXd initialJacobian;
+    };
+
+    // 优化结果
+    struct Result {
+        Eigen::VectorXd x;
+        Eigen::VectorXd residuals;
+        double sse = 0.0;
+        int iterations = 0;
+        int jacobianEvaluations = 0;
+        int residualEvaluations = 0;
+        bool converged = false; // 是否达到 targetMse
+        // LM / Dogleg：结束时的雅可比 (可能经 Broyden 更新) 与阻尼 (LM 为 lambda，Dogleg 为信赖域半径)
+        Eigen::MatrixXd jacobian;
+        double damping = 0.0;
+    };
+
+    // 回调：起点与每个接受步 (在调用 minimize 的线程中调用)、进度百分比、停止请求查询
+    using AcceptCallback = std::function<void(const Eigen::VectorXd& x, double sse)>;
+    using ProgressCallback = std::function<void(int percent)>;
+    using StopPredicate = std::function<bool()>;
+
+    void setAcceptCallback(AcceptCallback cb) { m_onAccept = cb; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    // 从 x0 出发求解 (x0 先投影到上下限内)
+    Result minimize(const Problem& problem, const Eigen::VectorXd& x0, const Options& options);
+
+    static const char* algorithmName(Algorithm algorithm);
+
+private:
+    void runLevenbergMarquardt(const Problem& problem, const Options& options, Result& result);
+    void runDogleg(const Problem& problem, const Options& options, Result& result);
+    void runBoundedLBFGS(const Problem& problem, const Options& options, Result& result);
+
+    // 公共步骤：停止判断 (含进度报告)、求残差、求雅可比、投影到上下限
+    bool shouldStop(const Problem& problem, const Options& options, int iter, Result& result) const;
+    bool evaluate(const Problem& problem, const Eigen::VectorXd& x, Eigen::VectorXd& r, Result& result) const;
+    bool evaluateJacobian(const Problem& problem, const Eigen::VectorXd& x, const Eigen::VectorXd& r, Result& result);
+    static void project(const Problem& problem, Eigen::VectorXd& x);
+    // 调用方给出的雅可比可用时复制到 m_J
+    bool takeInitialJacobian(const Options& options);
+
+    // Broyden 秩一更新：J += (dr - J*s) * s^T / (s^T*s)，dr 会被改写
+    void broydenUpdate(Eigen::VectorXd& dr, const Eigen::VectorXd& s);
+
+    AcceptCallback m_onAccept;
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+
+    // 工作数组：每次 minimize 开始时按问题规模分配
+    Eigen::MatrixXd m_J;           // 雅可比 (residualCount × n)
+    Eigen::MatrixXd m_augmented;   // LM 增广矩阵 [J; sqrt(lambda*D)]
+    Eigen::VectorXd m_rhs;         // 增广右端 [-r; 0]
+    Eigen::VectorXd m_trialX, m_trialR, m_step, m_gradient, m_work, m_workM;
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> m_qr;
+};
+
+#endif // LEASTSQUARESOPTIMIZER_H
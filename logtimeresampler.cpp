@@ -0,0 +1,127 @@
+/*
+ * 文件名: logtimeresampler.cpp
+ * 文件作用: 拟合观测数据的对数时间重采样 (抽稀) 实现文件
+ * 功能描述:
+ * 1. 先按时间排序 (已排序的数据只做一次检查)，再按对数等宽分箱顺序扫描，整体 O(n log n)。
+ * 2. 异常点只在箱内判断，不同流动阶段的压差水平不会互相影响。
+ * 3. 输出点数约为 对数周期数 × 每周期点数，与原始采样密度无关。
+ */
+
+#include "logtimeresampler.h"
+#include <QtMath>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <cmath>
+
+namespace {
+
+// 中位数 (会重排 values)
+double median(std::vector<double>& values)
+{
+    const size_t n = values.size();
+    const size_t mid = n / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double m = values[mid];
+    if (n % 2 == 0) {
+        m = 0.5 * (m + *std::max_element(values.begin(), values.begin() + mid));
+    }
+    return m;
+}
+
+} // namespace
+
+LogTimeResampler::Result LogTimeResampler::resample(const QVector<double>& t, const QVector<double>& deltaP,
+                                                    const QVector<double>& deriv, const Options& options)
+{
+    Result result;
+    const int n = qMin(t.size(), deltaP.size());
+
+    // 1. 有效点下标 (双对数分析要求 t > 0)，按时间排序
+    std::vector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (t[i] > 0 && std::isfinite(t[i]) && std::isfinite(deltaP[i])) order.push_back(i);
+    }
+    auto byTime = [&t](int a, int b) { return t[a] < t[b]; };
+    if (!std::is_sorted(order.begin(), order.end(), byTime)) {
+        std::stable_sort(order.begin(), order.end(), byTime);
+    }
+
+    auto derivAt = [&deriv](int i) { return i < deriv.size() ? deriv[i] : 0.0; };
+
+    if (!options.enabled || options.pointsPerCycle <= 0) {
+        result.time.reserve(int(order.size()));
+        result.deltaP.reserve(int(order.size()));
+        result.derivative.reserve(int(order.size()));
+        for (int i : order) {
+            result.time.append(t[i]);
+            result.deltaP.append(deltaP[i]);
+            result.derivative.append(derivAt(i));
+        }
+        return result;
+    }
+
+    // 2. 按 floor(log10(t) * 每周期点数) 分箱，排序后同一箱的点连续
+    const double binsPerCycle = options.pointsPerCycle;
+    std::vector<double> bt, bp, bd, dev;
+    std::vector<int> members;
+
+    size_t begin = 0;
+    while (begin < order.size()) {
+        const long long bin = (long long)std::floor(std::log10(t[order[begin]]) * binsPerCycle);
+        size_t end = begin + 1;
+        while (end < order.size() && (long long)std::floor(std::log10(t[order[end]]) * binsPerCycle) == bin) ++end;
+
+        members.assign(order.begin() + begin, order.begin() + end);
+        begin = end;
+
+        if (members.size() == 1) {
+            int i = members.front();
+            result.time.append(t[i]);
+            result.deltaP.append(deltaP[i]);
+            result.derivative.append(derivAt(i));
+            continue;
+        }
+
+        // 3. 箱内异常点剔除：|Δp - 中位数| > k × 1.4826 × MAD
+        if (options.rejectOutliers && members.size() >= 3) {
+            bp.clear();
+            for (int i : members) bp.push_back(deltaP[i]);
+            const double med = median(bp);
+            dev.clear();
+            for (int i : members) dev.push_back(std::abs(deltaP[i] - med));
+            const double mad = median(dev) * 1.4826;
+            if (mad > 0) {
+                const double limit = options.outlierThreshold * mad;
+                members.erase(std::remove_if(members.begin(), members.end(),
+                                             [&](int i) { return std::abs(deltaP[i] - med) > limit; }),
+                              members.end());
+            }
+        }
+        if (members.empty()) continue;
+
+        // 4. 箱内聚合
+        bt.clear(); bp.clear(); bd.clear();
+        for (int i : members) {
+            bt.push_back(std::log(t[i]));
+            bp.push_back(deltaP[i]);
+            bd.push_back(derivAt(i));
+        }
+        double lt, p, d;
+        if (options.aggregation == Mean) {
+            const double k = 1.0 / double(members.size());
+            lt = std::accumulate(bt.begin(), bt.end(), 0.0) * k;
+            p = std::accumulate(bp.begin(), bp.end(), 0.0) * k;
+            d = std::accumulate(bd.begin(), bd.end(), 0.0) * k;
+        } else {
+            lt = median(bt);
+            p = median(bp);
+            d = median(bd);
+        }
+        result.time.append(std::exp(lt));
+        result.deltaP.append(p);
+        result.derivative.append(d);
+    }
+    return result;
+}
@@ -0,0 +1,48 @@
+/*
+ * 文件名: logtimeresampler.h
+ * 文件作用: 拟合观测数据的对数时间重采样 (抽稀) 头文件
+ * 功能描述:
+ * 1. 按 log10(t) 等宽分箱，每个对数周期保留固定个数的代表点，消除仪表数据在晚期的过度采样。
+ * 2. 箱内代表点取中位数或平均值 (时间取几何平均)，箱内只有一个点时原样保留。
+ * 3. 可选按中位数绝对偏差 (MAD) 剔除箱内压差异常点。
+ */
+
+#ifndef LOGTIMERESAMPLER_H
+#define LOGTIMERESAMPLER_H
+
+#include <QVector>
+
+class LogTimeResampler
+{
+public:
+    // 箱内聚合方式
+    enum Aggregation {
+        Median = 0,     // 中位数 (对尖峰不敏感，默认)
+        Mean            // 平均值，时间取几何平均
+    };
+
+    struct Options {
+        bool enabled = false;
+        int pointsPerCycle = 50;        // 每个对数周期的点数
+        Aggregation aggregation = Median;
+        bool rejectOutliers = true;     // 是否剔除箱内异常点
+        double outlierThreshold = 3.0;  // 偏离箱内中位数超过该倍数的 MAD (换算为标准差) 视为异常
+    };
+
+    // 重采样结果，三组数组长度一致，时间递增
+    struct Result {
+        QVector<double> time;
+        QVector<double> deltaP;
+        QVector<double> derivative;
+    };
+
+    /**
+     * @brief 对观测数据做对数时间重采样
+     * @param deriv 导数，长度不足时缺失部分按 0 处理
+     * @return options.enabled 为 false 时原样返回 (仍剔除 t<=0 的点)
+     */
+    static Result resample(const QVector<double>& t, const QVector<double>& deltaP,
+                           const QVector<double>& deriv, const Options& options);
+};
+
+#endif // LOGTIMERESAMPLER_H
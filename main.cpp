@@ -7,17 +7,118 @@
  * 3. 应用全局样式表 (StyleSheet) 以美化界面控件
  * 4. 设置全局调色板以适配不同系统主题的文本颜色
  * 5. 启动主窗口
+ * 6. 命令行参数 --batch <项目.pwt> [--jobs N] [--workers 主机:端口,... --token 令牌] 时不创建界面，批量拟合项目中的全部分析页后退出
+ * 7. 记录启动各阶段耗时 (应用对象、样式表、主窗口构造、首次显示)，输出到调试日志并在状态栏显示
+ * 8. 命令行参数 --worker [--bind 地址] [--port N] [--jobs N] [--token 令牌] 时作为远程拟合节点运行 (不创建界面)，
+ *    执行其他计算机批量拟合发来的任务；默认只监听 127.0.0.1，未给出令牌时随机生成并在启动日志中输出
  */
 
 #include "mainwindow.h"
+#include "modelparameter.h"
+#include "batchfitqueue.h"
+#include "fitworkerprotocol.h"
+#include "fitworkerserver.h"
 #include <QApplication>
+#include <QDateTime>
+#include <QTextStream>
+#include <QThread>
 #include <QStyleFactory>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QIcon>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStatusBar>
+#include <QTimer>
+#include <QRandomGenerator>
+
+// 无界面批量拟合：返回值为失败任务数 (项目无法打开时为 1)
+static int runBatch(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    QString projectFile;
+    QStringList workers;
+    QString token = qEnvironmentVariable("WELLTEST_WORKER_TOKEN");
+    int jobs = qMax(1, QThread::idealThreadCount() / 2);
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--batch" && i + 1 < args.size()) projectFile = args[++i];
+        else if (args[i] == "--jobs" && i + 1 < args.size()) jobs = qMax(1, args[++i].toInt());
+        else if (args[i] == "--workers" && i + 1 < args.size()) workers = args[++i].split(',', Qt::SkipEmptyParts);
+        else if (args[i] == "--token" && i + 1 < args.size()) token = args[++i];
+    }
+
+    QTextStream log(stdout);
+    if (projectFile.isEmpty()) {
+        log << "用法: WellTest --batch <项目.pwt> [--jobs 本机并行任务数] [--workers 主机:端口,主机:端口 --token 节点访问令牌]" << Qt::endl;
+        return 1;
+    }
+    int failed = BatchFitQueue::runProject(projectFile, jobs, log, workers, token);
+    return failed < 0 ? 1 : failed;
+}
+
+// 远程拟合节点：一直运行到进程被结束
+static int runWorker(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    // 默认只接受本机连接；供其他计算机使用时以 --bind 指定网卡地址 (0.0.0.0 为全部)
+    QHostAddress bind(QHostAddress::LocalHost);
+    quint16 port = FitWorkerProtocol::DEFAULT_PORT;
+    int jobs = qMax(1, QThread::idealThreadCount() / 2);
+    QString token = qEnvironmentVariable("WELLTEST_WORKER_TOKEN");
+    const QString usage = "用法: WellTest --worker [--bind 地址] [--port 端口] [--jobs 并行任务数] [--token 访问令牌]";
+    QTextStream log(stdout);
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--port" && i + 1 < args.size()) port = quint16(args[++i].toUInt());
+        else if (args[i] == "--jobs" && i + 1 < args.size()) jobs = qMax(1, args[++i].toInt());
+        else if (args[i] == "--token" && i + 1 < args.size()) token = args[++i];
+        else if (args[i] == "--bind" && i + 1 < args.size()) {
+            if (!bind.setAddress(args[++i])) {
+                log << "无效的监听地址: " << args[i] << Qt::endl << usage << Qt::endl;
+                return 1;
+            }
+        }
+    }
+    bool generatedToken = false;
+    if (token.isEmpty()) {
+        quint32 words[4];
+        QRandomGenerator::system()->fillRange(words);
+        for (quint32 w : words) token += QString("%1").arg(w, 8, 16, QChar('0'));
+        generatedToken = true;
+    }
+    if (token.toUtf8().size() > int(FitWorkerProtocol::MAX_TOKEN_SIZE)) {
+        log << "访问令牌过长 (上限 " << FitWorkerProtocol::MAX_TOKEN_SIZE << " 字节)" << Qt::endl;
+        return 1;
+    }
+
+    FitWorkerServer server(jobs, token);
+    QObject::connect(&server, &FitWorkerServer::message, [&log](const QString& text) {
+        log << QDateTime::currentDateTime().toString("hh:mm:ss") << "  " << text << Qt::endl;
+    });
+    if (!server.listen(bind, port)) {
+        log << "无法监听 " << bind.toString() << ":" << port << ": " << server.errorString() << Qt::endl;
+        log << usage << Qt::endl;
+        return 1;
+    }
+    log << QString("拟合节点已启动，地址 %1:%2，同时执行 %3 个任务").arg(bind.toString()).arg(server.serverPort()).arg(jobs) << Qt::endl;
+    if (generatedToken) log << "访问令牌 (客户端 --token 或设置页填写): " << token << Qt::endl;
+    return app.exec();
+}
 
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; ++i) {
+        if (QString::fromLocal8Bit(argv[i]) == "--batch") return runBatch(argc, argv);
+        if (QString::fromLocal8Bit(argv[i]) == "--worker") return runWorker(argc, argv);
+    }
+
+    // 启动耗时：各阶段结束时刻 (毫秒，自进入 main 起)
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
 // [修复] 解决 HighDpiScaling 在 Qt6 中已废弃的警告
 // 只有在 Qt 6.0 之前的版本才需要手动启用，Qt 6 默认启用
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
@@ -25,6 +126,7 @@ int main(int argc, char *argv[])
 #endif
 
     QApplication app(argc, argv);
+    const qint64 appMs = startupTimer.elapsed();
 
     // 设置软件全局图标
     app.setWindowIcon(QIcon(":/new/prefix1/Resource/PWT.png"));
@@ -96,9 +198,24 @@ int main(int argc, char *argv[])
     darkTextPalette.setColor(QPalette::ButtonText, Qt::black);
 
     QApplication::setPalette(darkTextPalette);
+    const qint64 styleMs = startupTimer.elapsed();
 
     MainWindow w;
+    const qint64 windowMs = startupTimer.elapsed();
     w.show();
 
-    return app.exec();
+    // 事件循环处理完首次显示 (布局与绘制) 后记录总耗时
+    QTimer::singleShot(0, &w, [&w, &startupTimer, appMs, styleMs, windowMs]() {
+        const qint64 totalMs = startupTimer.elapsed();
+        const QString summary = QString("启动耗时 %1 ms (应用 %2 ms, 样式 %3 ms, 主窗口 %4 ms, 首次显示 %5 ms)")
+                                    .arg(totalMs).arg(appMs).arg(styleMs - appMs)
+                                    .arg(windowMs - styleMs).arg(totalMs - windowMs);
+        qInfo().noquote() << summary;
+        w.statusBar()->showMessage(summary, 10000);
+    });
+
+    int ret = app.exec();
+    // 退出前等待后台保存队列写完，避免项目文件只写了一半
+    ModelParameter::instance()->waitForPendingWrites();
+    return ret;
 }
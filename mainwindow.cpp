@@ -4,6 +4,7 @@
  * 功能描述：
  * 1. 实例化 ModelManager，其内部现在初始化了新的 WT_ModelWidget 列表。
  * 2. 协调各个模块的交互逻辑。
+ * 3. 启动时只创建项目、数据、设置页面；模型界面与拟合页签由各自的管理类按需创建，图表页面首次进入时创建。
  */
 
 #include "mainwindow.h"
@@ -16,11 +17,12 @@
 #include "wt_plottingwidget.h"
 #include "fittingpage.h"
 #include "settingswidget.h"
+#include "autosaveservice.h"
+#include "mousezoom.h"
 
 #include <QDateTime>
 #include <QMessageBox>
 #include <QDebug>
-#include <QStandardItemModel>
 #include <QTimer>
 #include <QSpacerItem>
 #include <QStackedWidget>
@@ -119,6 +121,7 @@ void MainWindow::init()
                         item++;
                     }
 
+                    if (name == tr("图表")) ensurePlottingWidget();
                     ui->stackedWidget->setCurrentIndex(targetIndex);
 
                     if (name == tr("图表")) {
@@ -150,7 +153,11 @@ void MainWindow::init()
     m_DataEditorWidget = new DataEditorWidget(ui->pageHand);
     ui->verticalLayoutHandle->addWidget(m_DataEditorWidget);
     connect(m_DataEditorWidget, &DataEditorWidget::fileChanged, this, &MainWindow::onFileLoaded);
-    connect(m_DataEditorWidget, &DataEditorWidget::dataChanged, this, &MainWindow::onDataEditorDataChanged);
+    // 表格修改经版本记录合并 (连续编辑只通知一次)，下游只重算被修改的列与行
+    m_DataChangeTracker = new DataChangeTracker(this);
+    m_DataChangeTracker->setModel(m_DataEditorWidget->getDataModel());
+    connect(m_DataChangeTracker, &DataChangeTracker::changesReady, this, &MainWindow::onDataEditorDataChanged);
+    connect(ModelParameter::instance(), &ModelParameter::saveFailed, this, &MainWindow::onProjectSaveFailed);
 
     // 初始化模型管理器 (内部现在包含新的 Widget 和 Solver)
     m_ModelManager = new ModelManager(this);
@@ -158,8 +165,7 @@ void MainWindow::init()
     connect(m_ModelManager, &ModelManager::calculationCompleted,
             this, &MainWindow::onModelCalculationCompleted);
 
-    m_PlottingWidget = new WT_PlottingWidget(ui->pageData);
-    ui->verticalLayout_2->addWidget(m_PlottingWidget);
+    // 图表页面 (图表控件与曲线列表) 在首次进入时创建，见 ensurePlottingWidget
 
     if (ui->pageFitting && ui->verticalLayoutFitting) {
         m_FittingPage = new FittingPage(ui->pageFitting);
@@ -174,6 +180,16 @@ void MainWindow::init()
     ui->verticalLayout_3->addWidget(m_SettingsWidget);
     connect(m_SettingsWidget, &SettingsWidget::settingsChanged,
             this, &MainWindow::onSystemSettingsChanged);
+    connect(m_SettingsWidget, &SettingsWidget::performanceSettingsChanged,
+            this, &MainWindow::onPerformanceSettingsChanged);
+    onPerformanceSettingsChanged();
+    connect(m_SettingsWidget, &SettingsWidget::plotStyleChanged,
+            this, &MainWindow::onPlotSettingsChanged);
+    onPlotSettingsChanged();
+
+    // 自动保存与备份：按系统设置定时提交，写盘在后台进行
+    m_AutoSave = new AutoSaveService(m_DataEditorWidget, nullptr, m_FittingPage, this);
+    onSystemSettingsChanged();
 
     initProjectForm();
     initDataEditorForm();
@@ -316,11 +332,13 @@ void MainWindow::onTransferDataToPlotting()
     transferDataFromEditorToPlotting();
 }
 
-void MainWindow::onDataEditorDataChanged()
+void MainWindow::onDataEditorDataChanged(const DataChangeSet& changes)
 {
     if (ui->stackedWidget->currentIndex() == 3) {
         transferDataFromEditorToPlotting();
     }
+    if (m_PlottingWidget) m_PlottingWidget->applyDataChanges(changes);
+    if (m_FittingPage) m_FittingPage->applyDataChanges(changes);
     m_hasValidData = hasDataLoaded();
 }
 
@@ -329,60 +347,6 @@ void MainWindow::onModelCalculationCompleted(const QString &analysisType, const
     qDebug() << "模型计算完成：" << analysisType;
 }
 
-void MainWindow::transferDataToFitting()
-{
-    if (!m_FittingPage || !m_DataEditorWidget) return;
-
-    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
-    if (!model || model->rowCount() == 0) {
-        return;
-    }
-
-    QVector<double> tVec, pVec, dVec;
-    double p_initial = 0.0;
-
-    for(int r=0; r<model->rowCount(); ++r) {
-        QModelIndex idx = model->index(r, 1);
-        if(idx.isValid()) {
-            double p = idx.data().toDouble();
-            if (std::abs(p) > 1e-6) {
-                p_initial = p;
-                break;
-            }
-        }
-    }
-
-    for(int r=0; r<model->rowCount(); ++r) {
-        double t = model->index(r, 0).data().toDouble();
-        double p_raw = model->index(r, 1).data().toDouble();
-        if (t > 0) {
-            tVec.append(t);
-            pVec.append(std::abs(p_raw - p_initial));
-        }
-    }
-
-    dVec.resize(tVec.size());
-    if (tVec.size() > 2) {
-        dVec[0] = 0;
-        dVec[tVec.size()-1] = 0;
-        for(int i=1; i<tVec.size()-1; ++i) {
-            double lnt1 = std::log(tVec[i-1]);
-            double lnt2 = std::log(tVec[i]);
-            double lnt3 = std::log(tVec[i+1]);
-            if (std::abs(lnt2 - lnt1) < 1e-9 || std::abs(lnt3 - lnt2) < 1e-9) {
-                dVec[i] = 0; continue;
-            }
-            double d1 = (pVec[i] - pVec[i-1]) / (lnt2 - lnt1);
-            double d2 = (pVec[i+1] - pVec[i]) / (lnt3 - lnt2);
-            double w1 = (lnt3 - lnt2) / (lnt3 - lnt1);
-            double w2 = (lnt2 - lnt1) / (lnt3 - lnt1);
-            dVec[i] = d1 * w1 + d2 * w2;
-        }
-    }
-
-    m_FittingPage->setObservedDataToCurrent(tVec, pVec, dVec);
-}
-
 void MainWindow::onFittingProgressChanged(int progress)
 {
     if (this->statusBar()) {
@@ -391,14 +355,42 @@ void MainWindow::onFittingProgressChanged(int progress)
     }
 }
 
+void MainWindow::onProjectSaveFailed(const QString& filePath, const QString& errorMessage)
+{
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("保存失败");
+    msgBox.setText(QString("项目文件写入失败：\n%1\n\n%2").arg(filePath, errorMessage));
+    msgBox.setIcon(QMessageBox::Warning);
+    msgBox.setStyleSheet(getMessageBoxStyle());
+    msgBox.exec();
+}
+
 void MainWindow::onSystemSettingsChanged()
 {
     qDebug() << "系统设置已变更";
+    if (!m_SettingsWidget || !m_AutoSave) return;
+    m_AutoSave->setInterval(m_SettingsWidget->getAutoSaveInterval());
+    m_AutoSave->setBackup(m_SettingsWidget->isBackupEnabled(), m_SettingsWidget->getBackupPath(),
+                          m_SettingsWidget->getMaxBackups());
 }
 
-void MainWindow::onPerformanceSettingsChanged() {}
+void MainWindow::onPerformanceSettingsChanged()
+{
+    if (!m_SettingsWidget) return;
+    ModelSolver01_06::setMaxThreadCount(m_SettingsWidget->getSolverThreadCount());
+    qDebug() << "求解器线程数:" << ModelSolver01_06::maxThreadCount();
+    if (m_FittingPage) m_FittingPage->setRemoteWorkers(m_SettingsWidget->getFitWorkers(), m_SettingsWidget->getFitWorkerToken());
+}
+
+void MainWindow::onPlotSettingsChanged()
+{
+    if (!m_SettingsWidget) return;
+    // 已打开的图表立即切换，之后新建的图表 (含独立图表窗口) 按同一默认值创建
+    MouseZoom::setDefaultRenderMode(static_cast<MouseZoom::RenderMode>(m_SettingsWidget->getPlotRenderMode()));
+    MouseZoom::setDefaultFrameTimeVisible(m_SettingsWidget->isFrameTimeVisible());
+}
 
-QStandardItemModel* MainWindow::getDataEditorModel() const
+MeasurementTableModel* MainWindow::getDataEditorModel() const
 {
     if (!m_DataEditorWidget) return nullptr;
     return m_DataEditorWidget->getDataModel();
@@ -416,10 +408,24 @@ bool MainWindow::hasDataLoaded()
     return m_DataEditorWidget->hasData();
 }
 
+WT_PlottingWidget* MainWindow::ensurePlottingWidget()
+{
+    if (m_PlottingWidget) return m_PlottingWidget;
+
+    m_PlottingWidget = new WT_PlottingWidget(ui->pageData);
+    ui->verticalLayout_2->addWidget(m_PlottingWidget);
+    if (m_AutoSave) m_AutoSave->setPlottingWidget(m_PlottingWidget);
+
+    // 补做创建前错过的设置：表格数据与项目曲线 (曲线在页面显示时后台读取)
+    transferDataFromEditorToPlotting();
+    if (m_isProjectLoaded) m_PlottingWidget->loadProjectData();
+    return m_PlottingWidget;
+}
+
 void MainWindow::transferDataFromEditorToPlotting()
 {
     if (!m_DataEditorWidget || !m_PlottingWidget) return;
-    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
+    MeasurementTableModel* model = m_DataEditorWidget->getDataModel();
     m_PlottingWidget->setDataModel(model);
     if (model && model->rowCount() > 0) {
         m_hasValidData = true;
@@ -13,8 +13,9 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QTimer>
-#include <QStandardItemModel>
 #include "modelmanager.h"
+#include "measurementtablemodel.h"
+#include "datachangetracker.h"
 
 class NavBtn;
 class WT_ProjectWidget;
@@ -22,6 +23,7 @@ class DataEditorWidget;
 class WT_PlottingWidget;
 class FittingPage;
 class SettingsWidget;
+class AutoSaveService;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -51,12 +53,16 @@ private slots:
     void onPlotAnalysisCompleted(const QString &analysisType, const QMap<QString, double> &results);
     void onDataReadyForPlotting();
     void onTransferDataToPlotting();
-    void onDataEditorDataChanged();
+    // 表格修改经合并后通知：刷新绘图页面的表格，并交给跟随表格的曲线与观测数据
+    void onDataEditorDataChanged(const DataChangeSet& changes);
 
     void onSystemSettingsChanged();
     void onPerformanceSettingsChanged();
+    void onPlotSettingsChanged();
     void onModelCalculationCompleted(const QString &analysisType, const QMap<QString, double> &results);
     void onFittingProgressChanged(int progress);
+    // 后台保存失败时提示
+    void onProjectSaveFailed(const QString& filePath, const QString& errorMessage);
 
 private:
     Ui::MainWindow *ui;
@@ -64,9 +70,11 @@ private:
     WT_ProjectWidget* m_ProjectWidget;
     DataEditorWidget* m_DataEditorWidget;
     ModelManager* m_ModelManager;
-    WT_PlottingWidget* m_PlottingWidget;
+    WT_PlottingWidget* m_PlottingWidget = nullptr;
     FittingPage* m_FittingPage;
     SettingsWidget* m_SettingsWidget;
+    AutoSaveService* m_AutoSave = nullptr;
+    DataChangeTracker* m_DataChangeTracker = nullptr;
 
     QMap<QString, NavBtn*> m_NavBtnMap;
     QTimer m_timer;
@@ -74,10 +82,11 @@ private:
     bool m_isProjectLoaded = false;
 
     void transferDataFromEditorToPlotting();
+    // 图表页面在首次进入时创建，并补做项目打开、数据加载时对它的设置
+    WT_PlottingWidget* ensurePlottingWidget();
     void updateNavigationState();
-    void transferDataToFitting();
 
-    QStandardItemModel* getDataEditorModel() const;
+    MeasurementTableModel* getDataEditorModel() const;
     QString getCurrentFileName() const;
     bool hasDataLoaded();
 
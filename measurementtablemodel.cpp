@@ -0,0 +1,571 @@
+/*
+ * 文件名: measurementtablemodel.cpp
+ * 文件作用: 列式测量数据表格模型实现
+ * 功能描述:
+ * 1. 实现基于列缓冲区的 QAbstractTableModel，支持编辑、插入/删除行列。
+ * 2. 数值列空值以 NaN 表示，显示为空；写入非数值文本时整列转为文本列。
+ * 3. 整表装载直接接管文本读取器的缓冲区，避免逐格复制。
+ */
+
+#include "measurementtablemodel.h"
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+const double kEmpty = std::numeric_limits<double>::quiet_NaN();
+}
+
+MeasurementTableModel::MeasurementTableModel(QObject *parent)
+    : QAbstractTableModel(parent),
+    m_rowCount(0)
+{
+}
+
+// ============================================================================
+// QAbstractTableModel 接口
+// ============================================================================
+
+int MeasurementTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int MeasurementTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_columns.size());
+}
+
+QVariant MeasurementTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return text(index.row(), index.column());
+    }
+    if (role == Qt::ForegroundRole) {
+        const QColor& c = m_columns[index.column()].foreground;
+        if (c.isValid()) return c;
+    }
+    return QVariant();
+}
+
+bool MeasurementTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole) return false;
+    setText(index.row(), index.column(), value.toString());
+    return true;
+}
+
+QVariant MeasurementTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return QVariant();
+    if (orientation == Qt::Vertical) return section + 1;
+    if (section < 0 || section >= int(m_columns.size())) return QVariant();
+    // 未设置表头时与 QStandardItemModel 一致，显示列号
+    const QString& h = m_columns[section].header;
+    return h.isNull() ? QVariant(section + 1) : QVariant(h);
+}
+
+bool MeasurementTableModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role)
+{
+    if (orientation != Qt::Horizontal || role != Qt::EditRole) return false;
+    if (section < 0 || section >= int(m_columns.size())) return false;
+    m_columns[section].header = value.toString();
+    emit headerDataChanged(orientation, section, section);
+    return true;
+}
+
+Qt::ItemFlags MeasurementTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+bool MeasurementTableModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || count <= 0 || row < 0 || row > m_rowCount) return false;
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    for (Column& col : m_columns) {
+        invalidateCache(col);
+        if (col.isNumeric) col.values.insert(col.values.begin() + row, size_t(count), kEmpty);
+        else col.texts.insert(col.texts.begin() + row, size_t(count), QString());
+    }
+    m_rowCount += count;
+    endInsertRows();
+    return true;
+}
+
+bool MeasurementTableModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || count <= 0 || row < 0 || row + count > m_rowCount) return false;
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for (Column& col : m_columns) {
+        invalidateCache(col);
+        if (col.isNumeric) col.values.erase(col.values.begin() + row, col.values.begin() + row + count);
+        else col.texts.erase(col.texts.begin() + row, col.texts.begin() + row + count);
+    }
+    m_rowCount -= count;
+    endRemoveRows();
+    return true;
+}
+
+bool MeasurementTableModel::insertColumns(int column, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || count <= 0 || column < 0 || column > int(m_columns.size())) return false;
+    beginInsertColumns(QModelIndex(), column, column + count - 1);
+    Column empty;
+    empty.values.assign(size_t(m_rowCount), kEmpty);
+    m_columns.insert(m_columns.begin() + column, size_t(count), empty);
+    endInsertColumns();
+    return true;
+}
+
+bool MeasurementTableModel::removeColumns(int column, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || count <= 0 || column < 0 || column + count > int(m_columns.size())) return false;
+    beginRemoveColumns(QModelIndex(), column, column + count - 1);
+    m_columns.erase(m_columns.begin() + column, m_columns.begin() + column + count);
+    endRemoveColumns();
+    return true;
+}
+
+// ============================================================================
+// 整表操作
+// ============================================================================
+
+void MeasurementTableModel::clear()
+{
+    beginResetModel();
+    m_columns.clear();
+    m_rowCount = 0;
+    endResetModel();
+}
+
+void MeasurementTableModel::setTable(TextDataTable& table)
+{
+    beginResetModel();
+    int cols = int(qMax(table.columns.size(), table.headers.size()));
+    m_columns.clear();
+    m_columns.resize(size_t(cols));
+    m_rowCount = table.rowCount;
+
+    for (int c = 0; c < cols; ++c) {
+        Column& col = m_columns[c];
+        if (c < table.headers.size()) col.header = table.headers[c];
+        if (c < table.columns.size()) {
+            TextDataColumn& src = table.columns[c];
+            col.isNumeric = src.isNumeric;
+            col.values = std::move(src.values);
+            col.texts = std::move(src.texts);
+        }
+        if (col.isNumeric) col.values.resize(size_t(m_rowCount), kEmpty);
+        else col.texts.resize(size_t(m_rowCount));
+    }
+    table.columns.clear();
+    endResetModel();
+}
+
+TextDataTable MeasurementTableModel::toTable() const
+{
+    TextDataTable table;
+    table.success = true;
+    table.headerProcessed = true;
+    table.rowCount = m_rowCount;
+    table.columns.resize(int(m_columns.size()));
+    for (int c = 0; c < int(m_columns.size()); ++c) {
+        const Column& col = m_columns[c];
+        table.headers.append(headerData(c, Qt::Horizontal).toString());
+        TextDataColumn& dst = table.columns[c];
+        dst.isNumeric = col.isNumeric;
+        if (col.isNumeric) dst.values = col.values;
+        else dst.texts = col.texts;
+    }
+    return table;
+}
+
+void MeasurementTableModel::appendRow(const QStringList& fields)
+{
+    int row = m_rowCount;
+    if (fields.size() > int(m_columns.size())) {
+        insertColumns(int(m_columns.size()), int(fields.size()) - int(m_columns.size()));
+    }
+    insertRows(row, 1);
+    for (int c = 0; c < fields.size(); ++c) {
+        storeText(m_columns[c], row, fields[c]);
+    }
+}
+
+void MeasurementTableModel::setHorizontalHeaderLabels(const QStringList& labels)
+{
+    if (labels.size() > int(m_columns.size())) {
+        insertColumns(int(m_columns.size()), int(labels.size()) - int(m_columns.size()));
+    }
+    for (int c = 0; c < labels.size(); ++c) m_columns[c].header = labels[c];
+    if (!labels.isEmpty()) emit headerDataChanged(Qt::Horizontal, 0, int(labels.size()) - 1);
+}
+
+QString MeasurementTableModel::headerText(int column) const
+{
+    if (column < 0 || column >= int(m_columns.size())) return QString();
+    return m_columns[column].header;
+}
+
+// ============================================================================
+// 批量编辑
+// ============================================================================
+
+namespace {
+// 行集合拆成的连续区间超过该数目时改用一次模型重置
+const int kMaxRangeSignals = 32;
+
+// 升序行号拆成连续区间 [first, last]
+QVector<QPair<int, int>> contiguousRanges(const QVector<int>& rows)
+{
+    QVector<QPair<int, int>> ranges;
+    for (int r : rows) {
+        if (!ranges.isEmpty() && ranges.last().second + 1 == r) ranges.last().second = r;
+        else ranges.append(qMakePair(r, r));
+    }
+    return ranges;
+}
+}
+
+TextDataTable MeasurementTableModel::takeRows(const QVector<int>& rows)
+{
+    TextDataTable removed;
+    removed.success = true;
+    removed.rowCount = int(rows.size());
+    removed.columns.resize(int(m_columns.size()));
+    if (rows.isEmpty()) return removed;
+
+    // 先保存被删除的内容
+    for (int c = 0; c < int(m_columns.size()); ++c) {
+        const Column& col = m_columns[c];
+        TextDataColumn& dst = removed.columns[c];
+        dst.isNumeric = col.isNumeric;
+        if (col.isNumeric) {
+            dst.values.reserve(size_t(rows.size()));
+            for (int r : rows) dst.values.push_back(col.values[size_t(r)]);
+        } else {
+            dst.texts.reserve(size_t(rows.size()));
+            for (int r : rows) dst.texts.push_back(col.texts[size_t(r)]);
+        }
+    }
+
+    const QVector<QPair<int, int>> ranges = contiguousRanges(rows);
+    if (ranges.size() <= kMaxRangeSignals) {
+        // 从后往前逐段删除，前面的行号不受影响
+        for (int i = int(ranges.size()) - 1; i >= 0; --i) removeRows(ranges[i].first, ranges[i].second - ranges[i].first + 1);
+        return removed;
+    }
+
+    // 分散的大量行：按保留标记一次压缩各列
+    beginResetModel();
+    std::vector<char> remove(size_t(m_rowCount), 0);
+    for (int r : rows) remove[size_t(r)] = 1;
+    for (Column& col : m_columns) {
+        invalidateCache(col);
+        size_t w = 0;
+        for (size_t r = 0; r < remove.size(); ++r) {
+            if (remove[r]) continue;
+            if (col.isNumeric) col.values[w] = col.values[r];
+            else col.texts[w] = std::move(col.texts[r]);
+            ++w;
+        }
+        if (col.isNumeric) col.values.resize(w);
+        else col.texts.resize(w);
+    }
+    m_rowCount -= int(rows.size());
+    endResetModel();
+    return removed;
+}
+
+void MeasurementTableModel::restoreRows(const QVector<int>& rows, const TextDataTable& removed)
+{
+    if (rows.isEmpty()) return;
+    const int total = m_rowCount + int(rows.size());
+    const QVector<QPair<int, int>> ranges = contiguousRanges(rows);
+    const bool reset = ranges.size() > kMaxRangeSignals;
+    if (reset) beginResetModel();
+
+    // 按升序插入，每段插入时其前面的行都已在最终位置
+    int taken = 0;
+    for (const QPair<int, int>& range : ranges) {
+        const int count = range.second - range.first + 1;
+        if (!reset) beginInsertRows(QModelIndex(), range.first, range.second);
+        for (int c = 0; c < int(m_columns.size()); ++c) {
+            Column& col = m_columns[c];
+            invalidateCache(col);
+            const TextDataColumn* src = c < removed.columns.size() ? &removed.columns[c] : nullptr;
+            if (src && !src->isNumeric && col.isNumeric) convertToText(col);
+            if (col.isNumeric) {
+                auto at = col.values.insert(col.values.begin() + range.first, size_t(count), kEmpty);
+                if (src) std::copy_n(src->values.begin() + taken, count, at);
+            } else {
+                auto at = col.texts.insert(col.texts.begin() + range.first, size_t(count), QString());
+                for (int i = 0; src && i < count; ++i) {
+                    at[i] = src->isNumeric ? formatNumber(src->values[size_t(taken + i)]) : src->texts[size_t(taken + i)];
+                }
+            }
+        }
+        taken += count;
+        m_rowCount += count;
+        if (!reset) endInsertRows();
+    }
+    Q_ASSERT(m_rowCount == total);
+    if (reset) endResetModel();
+}
+
+MeasurementTableModel::ColumnSnapshot MeasurementTableModel::takeColumn(int column)
+{
+    ColumnSnapshot snapshot;
+    if (column < 0 || column >= int(m_columns.size())) return snapshot;
+    beginRemoveColumns(QModelIndex(), column, column);
+    Column& col = m_columns[size_t(column)];
+    snapshot.header = col.header;
+    snapshot.foreground = col.foreground;
+    snapshot.data.isNumeric = col.isNumeric;
+    snapshot.data.values = std::move(col.values);
+    snapshot.data.texts = std::move(col.texts);
+    m_columns.erase(m_columns.begin() + column);
+    endRemoveColumns();
+    return snapshot;
+}
+
+void MeasurementTableModel::restoreColumn(int column, const ColumnSnapshot& snapshot)
+{
+    if (column < 0 || column > int(m_columns.size())) return;
+    Column col;
+    col.header = snapshot.header;
+    col.foreground = snapshot.foreground;
+    col.isNumeric = snapshot.data.isNumeric;
+    col.values = snapshot.data.values;
+    col.texts = snapshot.data.texts;
+    if (col.isNumeric) col.values.resize(size_t(m_rowCount), kEmpty);
+    else col.texts.resize(size_t(m_rowCount));
+    beginInsertColumns(QModelIndex(), column, column);
+    m_columns.insert(m_columns.begin() + column, std::move(col));
+    endInsertColumns();
+}
+
+QVector<QStringList> MeasurementTableModel::setTextBlock(int row, int column, const QVector<QStringList>& cells)
+{
+    QVector<QStringList> previous;
+    int width = 0;
+    for (const QStringList& line : cells) width = qMax(width, int(line.size()));
+    if (row < 0 || column < 0 || cells.isEmpty() || width == 0) return previous;
+
+    ensureSize(row + int(cells.size()), column + width);
+    previous.resize(cells.size());
+    for (int i = 0; i < cells.size(); ++i) {
+        for (int j = 0; j < cells[i].size(); ++j) {
+            Column& col = m_columns[size_t(column + j)];
+            previous[i].append(text(row + i, column + j));
+            storeText(col, row + i, cells[i][j]);
+        }
+    }
+    // 撤销时写回的数值文字使曾转为文本的列恢复为数值列
+    for (int j = 0; j < width; ++j) convertToNumericIfPossible(m_columns[size_t(column + j)]);
+    emit dataChanged(index(row, column), index(row + int(cells.size()) - 1, column + width - 1));
+    return previous;
+}
+
+// ============================================================================
+// 单元格访问
+// ============================================================================
+
+QString MeasurementTableModel::text(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= int(m_columns.size())) return QString();
+    const Column& col = m_columns[column];
+    if (!col.isNumeric) return col.texts[row];
+    return formatNumber(col.values[row]);
+}
+
+double MeasurementTableModel::value(int row, int column, bool* ok) const
+{
+    if (ok) *ok = false;
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= int(m_columns.size())) return 0.0;
+    const Column& col = m_columns[column];
+    if (!col.isNumeric) return col.texts[row].toDouble(ok);
+    double v = col.values[row];
+    if (std::isnan(v)) return 0.0;
+    if (ok) *ok = true;
+    return v;
+}
+
+void MeasurementTableModel::setText(int row, int column, const QString& text)
+{
+    if (row < 0 || column < 0) return;
+    ensureSize(row + 1, column + 1);
+    bool wasNumeric = m_columns[column].isNumeric;
+    storeText(m_columns[column], row, text);
+    if (wasNumeric && !m_columns[column].isNumeric) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column));
+    } else {
+        QModelIndex idx = index(row, column);
+        emit dataChanged(idx, idx);
+    }
+}
+
+void MeasurementTableModel::setValue(int row, int column, double value)
+{
+    if (row < 0 || column < 0) return;
+    ensureSize(row + 1, column + 1);
+    Column& col = m_columns[column];
+    invalidateCache(col);
+    if (col.isNumeric) col.values[row] = value;
+    else col.texts[row] = formatNumber(value);
+    QModelIndex idx = index(row, column);
+    emit dataChanged(idx, idx);
+}
+
+// ============================================================================
+// 列访问
+// ============================================================================
+
+bool MeasurementTableModel::isNumericColumn(int column) const
+{
+    return column >= 0 && column < int(m_columns.size()) && m_columns[column].isNumeric;
+}
+
+const double* MeasurementTableModel::columnData(int column) const
+{
+    if (!isNumericColumn(column)) return nullptr;
+    return m_columns[column].values.data();
+}
+
+QVector<double> MeasurementTableModel::columnValues(int column) const
+{
+    QVector<double> out;
+    if (column < 0 || column >= int(m_columns.size())) return out;
+    out.resize(m_rowCount);
+    // 数值列直接读连续缓冲区，空值与 value() 一致按 0 处理
+    if (m_columns[column].isNumeric) {
+        const double* src = m_columns[column].values.data();
+        for (int r = 0; r < m_rowCount; ++r) out[r] = std::isnan(src[r]) ? 0.0 : src[r];
+        return out;
+    }
+    for (int r = 0; r < m_rowCount; ++r) out[r] = value(r, column);
+    return out;
+}
+
+void MeasurementTableModel::setColumnValues(int column, const QVector<double>& values)
+{
+    if (column < 0 || column >= int(m_columns.size())) return;
+    ensureSize(int(values.size()), column + 1);
+    Column& col = m_columns[column];
+    invalidateCache(col);
+    if (!col.isNumeric) {
+        col.isNumeric = true;
+        col.texts = std::vector<QString>();
+        col.values.assign(size_t(m_rowCount), kEmpty);
+    }
+    std::copy(values.constBegin(), values.constEnd(), col.values.begin());
+    if (m_rowCount > 0) emit dataChanged(index(0, column), index(m_rowCount - 1, column));
+}
+
+int MeasurementTableModel::appendNumericColumn(const QString& header, std::vector<double>&& values)
+{
+    const int column = int(m_columns.size());
+    Column col;
+    col.header = header;
+    col.values = std::move(values);
+    col.values.resize(size_t(m_rowCount), kEmpty);
+    beginInsertColumns(QModelIndex(), column, column);
+    m_columns.push_back(std::move(col));
+    endInsertColumns();
+    return column;
+}
+
+void MeasurementTableModel::setColumnForeground(int column, const QColor& color)
+{
+    if (column < 0 || column >= int(m_columns.size())) return;
+    m_columns[column].foreground = color;
+    if (m_rowCount > 0) emit dataChanged(index(0, column), index(m_rowCount - 1, column), {Qt::ForegroundRole});
+}
+
+const std::vector<qint64>* MeasurementTableModel::cachedTimeValues(int column, int kind) const
+{
+    if (column < 0 || column >= int(m_columns.size())) return nullptr;
+    const Column& col = m_columns[column];
+    return kind != 0 && col.timeCacheKind == kind ? &col.timeCache : nullptr;
+}
+
+void MeasurementTableModel::setCachedTimeValues(int column, int kind, std::vector<qint64>&& values) const
+{
+    if (column < 0 || column >= int(m_columns.size()) || values.size() != size_t(m_rowCount)) return;
+    const Column& col = m_columns[column];
+    col.timeCache = std::move(values);
+    col.timeCacheKind = kind;
+}
+
+QString MeasurementTableModel::formatNumber(double value)
+{
+    if (std::isnan(value)) return QString();
+    return QString::number(value, 'g', 15);
+}
+
+// ============================================================================
+// 内部辅助
+// ============================================================================
+
+void MeasurementTableModel::invalidateCache(Column& column)
+{
+    if (column.timeCacheKind == 0) return;
+    column.timeCacheKind = 0;
+    column.timeCache = std::vector<qint64>();
+}
+
+void MeasurementTableModel::convertToNumericIfPossible(Column& column)
+{
+    if (column.isNumeric) return;
+    std::vector<double> values(column.texts.size(), kEmpty);
+    for (size_t r = 0; r < column.texts.size(); ++r) {
+        QString trimmed = column.texts[r].trimmed();
+        if (trimmed.isEmpty()) continue;
+        bool ok = false;
+        values[r] = trimmed.toDouble(&ok);
+        if (!ok) return;
+    }
+    column.values = std::move(values);
+    column.texts = std::vector<QString>();
+    column.isNumeric = true;
+}
+
+void MeasurementTableModel::convertToText(Column& column)
+{
+    if (!column.isNumeric) return;
+    column.texts.resize(column.values.size());
+    for (size_t r = 0; r < column.values.size(); ++r) column.texts[r] = formatNumber(column.values[r]);
+    column.values = std::vector<double>();
+    column.isNumeric = false;
+}
+
+void MeasurementTableModel::ensureSize(int rows, int columns)
+{
+    if (columns > int(m_columns.size())) insertColumns(int(m_columns.size()), columns - int(m_columns.size()));
+    if (rows > m_rowCount) insertRows(m_rowCount, rows - m_rowCount);
+}
+
+void MeasurementTableModel::storeText(Column& column, int row, const QString& text)
+{
+    invalidateCache(column);
+    if (!column.isNumeric) {
+        column.texts[row] = text;
+        return;
+    }
+    QString trimmed = text.trimmed();
+    if (trimmed.isEmpty()) {
+        column.values[row] = kEmpty;
+        return;
+    }
+    bool ok = false;
+    double v = trimmed.toDouble(&ok);
+    if (ok) {
+        column.values[row] = v;
+    } else {
+        convertToText(column);
+        column.texts[row] = text;
+    }
+}
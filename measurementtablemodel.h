@@ -0,0 +1,128 @@
+/*
+ * 文件名: measurementtablemodel.h
+ * 文件作用: 列式测量数据表格模型头文件
+ * 功能描述:
+ * 1. 以连续的 std::vector<double> 按列存储数值数据，非数值列以字符串列存储，不再为每个单元格分配 QStandardItem。
+ * 2. 单元格显示文本在 data() 中按需格式化，编辑时在数值列与文本列之间自动转换。
+ * 3. 提供按列直接访问原始 double 缓冲区的接口，绘图、拟合等热点路径无需逐格字符串转换。
+ * 4. 提供与原 QStandardItemModel 用法对应的便捷接口 (文本读写、表头、整行追加、列前景色)。
+ * 5. 可为列缓存时间解析结果，列内容被修改后缓存自动失效。
+ * 6. 提供批量编辑接口 (删除/恢复任意行集合、取出/放回整列、写入矩形区域)，每次只发出少量范围信号或一次重置，
+ *    并返回被删除或覆盖的数据，供撤销命令只保存差异。
+ */
+
+#ifndef MEASUREMENTTABLEMODEL_H
+#define MEASUREMENTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+#include "textdatareader.h"
+
+class MeasurementTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit MeasurementTableModel(QObject *parent = nullptr);
+
+    // ---------------- QAbstractTableModel 接口 ----------------
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool insertColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    // ---------------- 整表操作 ----------------
+    // 清空全部数据和表头
+    void clear();
+    // 接管文本读取器的列缓冲区 (移动，不复制)
+    void setTable(TextDataTable& table);
+    // 导出整表列数据 (表头取显示文字)，用于保存项目表格数据
+    TextDataTable toTable() const;
+    // 追加一行，字段按文本解析，超出当前列数时自动扩列
+    void appendRow(const QStringList& fields);
+    void setHorizontalHeaderLabels(const QStringList& labels);
+    // 列的表头文字，未设置表头时返回空 (null) 字符串
+    QString headerText(int column) const;
+
+    // ---------------- 单元格访问 ----------------
+    // 单元格显示文本 (数值列按需格式化，空值为空字符串)
+    QString text(int row, int column) const;
+    // 单元格数值；文本列按需解析，无法解析返回 0 (与 QString::toDouble 一致)，ok 给出是否成功
+    double value(int row, int column, bool* ok = nullptr) const;
+    // 写入文本；数值列遇到非数值文本时整列转为文本列；行列越界时自动扩展
+    void setText(int row, int column, const QString& text);
+    // 写入数值；文本列中按格式化文本写入
+    void setValue(int row, int column, double value);
+
+    // ---------------- 列访问 ----------------
+    bool isNumericColumn(int column) const;
+    // 数值列的连续缓冲区 (长度为 rowCount，空值为 NaN)；文本列或越界返回 nullptr
+    const double* columnData(int column) const;
+    // 整列数值的拷贝，文本列逐格解析
+    QVector<double> columnValues(int column) const;
+    // 整列写入数值 (列不存在时忽略)
+    void setColumnValues(int column, const QVector<double>& values);
+    // 在末尾追加一个数值列 (接管 values，长度不足 rowCount 时补空值)，只发出一次列插入通知，返回新列下标
+    int appendNumericColumn(const QString& header, std::vector<double>&& values);
+    // 列文字颜色 (如计算生成的压差列、导数列)
+    void setColumnForeground(int column, const QColor& color);
+
+    // ---------------- 批量编辑 ----------------
+    // 整列数据 (表头、内容、文字颜色)，用于撤销删除列
+    struct ColumnSnapshot {
+        QString header;
+        TextDataColumn data;
+        QColor foreground;
+    };
+    // 删除若干行 (升序、无重复)，返回被删除行的内容 (按列存放，行序与 rows 一致)
+    TextDataTable takeRows(const QVector<int>& rows);
+    // 把 takeRows 取出的内容放回 rows 所列的位置 (删除前的行号)
+    void restoreRows(const QVector<int>& rows, const TextDataTable& removed);
+    // 取出整列 / 在 column 处放回整列
+    ColumnSnapshot takeColumn(int column);
+    void restoreColumn(int column, const ColumnSnapshot& snapshot);
+    // 从 (row, column) 起写入文字矩形 (cells[i][j] 为第 i 行第 j 列)，行列不足时自动扩展；
+    // 只发出一次 dataChanged，返回被覆盖的原文字 (扩展出的单元格为空字符串)
+    QVector<QStringList> setTextBlock(int row, int column, const QVector<QStringList>& cells);
+
+    // ---------------- 解析结果缓存 ----------------
+    // 列的时间解析结果 (kind 由调用方区分，如日期天数/当天秒数)；未缓存、kind 不同或列内容被修改后返回 nullptr
+    const std::vector<qint64>* cachedTimeValues(int column, int kind) const;
+    void setCachedTimeValues(int column, int kind, std::vector<qint64>&& values) const;
+
+    // 数值的统一显示格式
+    static QString formatNumber(double value);
+
+private:
+    struct Column {
+        QString header;
+        bool isNumeric = true;
+        std::vector<double> values;   // 数值列数据，空值为 NaN
+        std::vector<QString> texts;   // 文本列数据
+        QColor foreground;            // 无效颜色表示使用默认颜色
+        mutable int timeCacheKind = 0;           // 0 表示无缓存
+        mutable std::vector<qint64> timeCache;   // 时间解析结果，写入单元格时清除
+    };
+
+    static void invalidateCache(Column& column);
+    void convertToText(Column& column);
+    // 文本列的内容全部是数值或空时转回数值列
+    void convertToNumericIfPossible(Column& column);
+    void ensureSize(int rows, int columns);
+    void storeText(Column& column, int row, const QString& text);
+
+    std::vector<Column> m_columns;
+    int m_rowCount;
+};
+
+#endif // MEASUREMENTTABLEMODEL_H
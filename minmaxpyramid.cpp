@@ -0,0 +1,130 @@
+/*
+ * 文件名: minmaxpyramid.cpp
+ * 文件作用: 大数据量曲线的多分辨率最值金字塔实现
+ * 功能描述:
+ * 1. 第 1 层由原始点每 4 个一桶求得，其余各层由上一层每 4 个桶合并，建到只剩一个桶为止。
+ * 2. 查询时从可见范围第一个点起逐段前进：当前下标对齐的各层中取横向跨度不超过局部像素宽度的最粗一层，
+ *    没有合适的层时输出原始点；输出下标严格递增，不会重复。
+ */
+
+#include "minmaxpyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+MinMaxPyramid::MinMaxPyramid(const QVector<double>& x, const QVector<double>& y)
+{
+    const int n = qMin(x.size(), y.size());
+    bool sorted = true;
+    for (int i = 1; i < n && sorted; ++i) sorted = !(x[i] < x[i - 1]);
+    if (sorted) {
+        m_x = n == x.size() ? x : x.mid(0, n);
+        m_y = n == y.size() ? y : y.mid(0, n);
+    } else {
+        QVector<int> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+        m_x.resize(n);
+        m_y.resize(n);
+        for (int i = 0; i < n; ++i) {
+            m_x[i] = x[order[i]];
+            m_y[i] = y[order[i]];
+        }
+    }
+
+    // 第 1 层：每 4 个原始点一桶
+    if (n < LEVEL_FACTOR) return;
+    Level first;
+    int buckets = (n + LEVEL_FACTOR - 1) / LEVEL_FACTOR;
+    first.minIndex.resize(buckets);
+    first.maxIndex.resize(buckets);
+    for (int b = 0; b < buckets; ++b) {
+        int lo = -1, hi = -1;
+        for (int i = b * LEVEL_FACTOR; i < qMin(n, (b + 1) * LEVEL_FACTOR); ++i) {
+            if (std::isnan(m_y[i])) continue;
+            if (lo < 0 || m_y[i] < m_y[lo]) lo = i;
+            if (hi < 0 || m_y[i] > m_y[hi]) hi = i;
+        }
+        first.minIndex[b] = lo;
+        first.maxIndex[b] = hi;
+    }
+    m_levels.append(first);
+
+    // 其余各层：上一层每 4 个桶合并
+    while (m_levels.last().minIndex.size() > 1) {
+        const Level& prev = m_levels.last();
+        const int prevCount = prev.minIndex.size();
+        Level next;
+        buckets = (prevCount + LEVEL_FACTOR - 1) / LEVEL_FACTOR;
+        next.minIndex.resize(buckets);
+        next.maxIndex.resize(buckets);
+        for (int b = 0; b < buckets; ++b) {
+            int lo = -1, hi = -1;
+            for (int c = b * LEVEL_FACTOR; c < qMin(prevCount, (b + 1) * LEVEL_FACTOR); ++c) {
+                int a = prev.minIndex[c], z = prev.maxIndex[c];
+                if (a >= 0 && (lo < 0 || m_y[a] < m_y[lo])) lo = a;
+                if (z >= 0 && (hi < 0 || m_y[z] > m_y[hi])) hi = z;
+            }
+            next.minIndex[b] = lo;
+            next.maxIndex[b] = hi;
+        }
+        m_levels.append(next);
+    }
+}
+
+void MinMaxPyramid::query(double xLo, double xHi, int pixelWidth, bool logX, QVector<double>& outX, QVector<double>& outY) const
+{
+    outX.clear();
+    outY.clear();
+    const int n = m_x.size();
+    if (n == 0) return;
+    if (xHi < xLo) std::swap(xLo, xHi);
+
+    // 可见范围两侧各多带一个点，曲线能连到边框外
+    int i0 = int(std::lower_bound(m_x.begin(), m_x.end(), xLo) - m_x.begin());
+    int i1 = int(std::upper_bound(m_x.begin(), m_x.end(), xHi) - m_x.begin());
+    i0 = qMax(0, i0 - 1);
+    i1 = qMin(n - 1, i1);
+
+    const int pixels = qMax(1, pixelWidth);
+    const bool useLog = logX && xLo > 0.0 && xHi > xLo;
+    const double linearWidth = (xHi - xLo) / pixels;
+    const double logStep = useLog ? std::pow(xHi / xLo, 1.0 / pixels) - 1.0 : 0.0;
+
+    outX.reserve(qMin(i1 - i0 + 1, 8 * pixels + 4));
+    outY.reserve(outX.capacity());
+    int last = -1;
+    auto append = [&](int index) {
+        if (index <= last) return;
+        outX.append(m_x[index]);
+        outY.append(m_y[index]);
+        last = index;
+    };
+
+    append(i0);
+    int i = i0;
+    while (i <= i1) {
+        // 局部一个像素对应的横坐标宽度
+        double width = useLog ? qMax(m_x[i], xLo) * logStep : linearWidth;
+        bool used = false;
+        int size = 1;
+        for (int k = 1; k <= m_levels.size(); ++k) size *= LEVEL_FACTOR;
+        for (int k = m_levels.size(); k >= 1; --k, size /= LEVEL_FACTOR) {
+            if (i % size != 0) continue;
+            int end = qMin(i + size, n) - 1;
+            if (m_x[end] - m_x[i] > width) continue;
+            const Level& level = m_levels[k - 1];
+            int a = level.minIndex[i / size], b = level.maxIndex[i / size];
+            if (a >= 0) {
+                if (a > b) std::swap(a, b);
+                append(a);
+                append(b);
+            }
+            i = end + 1;
+            used = true;
+            break;
+        }
+        if (!used) append(i++);
+    }
+    append(i1);
+}
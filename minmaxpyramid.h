@@ -0,0 +1,47 @@
+/*
+ * 文件名: minmaxpyramid.h
+ * 文件作用: 大数据量曲线的多分辨率最值金字塔头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 按横坐标排序后建立金字塔：第 k 层每个桶覆盖 4^k 个原始点，保存桶内纵坐标最小、最大点的下标，
+ *    由下一层每 4 个桶合并得到，总建立代价 O(n)，额外内存约为 2n/3 个下标。
+ * 2. 查询给定横坐标范围与像素宽度：逐段选取横向跨度不超过一个像素的最粗一层，每个桶输出最小、最大两点
+ *    (按原始顺序)，输出点数与像素数同量级，曲线包络 (尖峰) 与逐点绘制一致。
+ * 3. 对数横轴按局部像素宽度选层 (早期时间点稀疏处自动使用原始点)；首末可见点总是输出，便于坐标轴自适应。
+ */
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <QVector>
+
+class MinMaxPyramid
+{
+public:
+    // 相邻两层桶大小之比
+    static const int LEVEL_FACTOR = 4;
+
+    MinMaxPyramid() = default;
+    // x 可以无序 (按 x 稳定排序后建立，与 QCPGraph 按键排序一致)；NaN 纵坐标不参与最值
+    MinMaxPyramid(const QVector<double>& x, const QVector<double>& y);
+
+    int size() const { return m_x.size(); }
+    int levelCount() const { return m_levels.size(); }
+
+    /**
+     * @brief 取出 [xLo, xHi] 内适合 pixelWidth 个像素显示的点 (两侧各多带一个原始点，横坐标递增)
+     * @param logX 横轴为对数坐标时为 true (xLo > 0 时按对数像素宽度选层)
+     */
+    void query(double xLo, double xHi, int pixelWidth, bool logX, QVector<double>& outX, QVector<double>& outY) const;
+
+private:
+    // 第 k 层 (k >= 1) 各桶最小、最大点的原始下标，桶内全为 NaN 时为 -1
+    struct Level {
+        QVector<int> minIndex;
+        QVector<int> maxIndex;
+    };
+
+    QVector<double> m_x, m_y;
+    QVector<Level> m_levels; // m_levels[k - 1] 的桶大小为 LEVEL_FACTOR^k
+};
+
+#endif // MINMAXPYRAMID_H
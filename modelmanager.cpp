@@ -2,8 +2,8 @@
  * modelmanager.cpp
  * 文件作用: 模型管理类实现文件
  * 功能描述:
- * 1. 实例化并管理 6 个 WT_ModelWidget (用于界面显示)。
- * 2. 实例化并管理 6 个 ModelSolver01_06 (用于后台计算)。
+ * 1. 管理 6 个 WT_ModelWidget (用于界面显示)，模型页首次显示某个模型时才创建。
+ * 2. 管理 6 个 ModelSolver01_06 (用于后台计算)，首次计算该模型时才创建。
  * 3. 处理模型选择逻辑，分发计算任务。
  */
 
@@ -12,22 +12,35 @@
 #include "modelparameter.h"
 #include "wt_modelwidget.h"
 #include "modelsolver01-06.h"
+#include "typecurvelibrary.h"
+#include "adaptivetimegrid.h"
 
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QGroupBox>
 #include <QDebug>
+#include <QEvent>
+#include <QMutexLocker>
 #include <cmath>
 
 ModelManager::ModelManager(QWidget* parent)
     : QObject(parent), m_mainWidget(nullptr), m_modelStack(nullptr)
     , m_currentModelType(Model_1)
+    , m_highPrecision(true)
 {
+    TypeCurveLibrary::shared().load(typeCurveLibraryPath());
 }
 
 ModelManager::~ModelManager()
 {
+    QString path = typeCurveLibraryPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    if (TypeCurveLibrary::shared().curveCount() > 0) TypeCurveLibrary::shared().save(path);
+
     // 清理求解器内存 (Widget 由 Qt 父子对象机制自动清理)
     qDeleteAll(m_solvers);
     m_solvers.clear();
@@ -40,30 +53,20 @@ void ModelManager::initializeModels(QWidget* parentWidget)
 
     m_modelStack = new QStackedWidget(m_mainWidget);
 
-    m_modelWidgets.clear();
-    m_solvers.clear();
-
-    // 循环创建 6 组界面和求解器
-    // 使用 ModelSolver01_06::Model_x 枚举
-    using MT = ModelSolver01_06::ModelType;
-    QList<MT> types = { MT::Model_1, MT::Model_2, MT::Model_3, MT::Model_4, MT::Model_5, MT::Model_6 };
-
-    for(MT type : types) {
-        // 1. 创建界面对象，用于显示和交互
-        WT_ModelWidget* widget = new WT_ModelWidget(type, m_modelStack);
-        m_modelWidgets.append(widget);
-        m_modelStack->addWidget(widget);
-
-        // 连接子界面的模型选择请求信号
-        connect(widget, &WT_ModelWidget::requestModelSelection, this, &ModelManager::onSelectModelClicked);
-
-        // 2. 创建独立的求解器对象，用于后台/拟合计算
-        ModelSolver01_06* solver = new ModelSolver01_06(type);
-        m_solvers.append(solver);
+    // 6 个模型先放占位页，界面 (各含图表与完整表单) 在首次显示时创建；求解器在首次计算时创建
+    const int modelCount = 6;
+    m_modelWidgets = QVector<WT_ModelWidget*>(modelCount, nullptr);
+    {
+        QMutexLocker locker(&m_solverMutex);
+        qDeleteAll(m_solvers);
+        m_solvers = QVector<ModelSolver01_06*>(modelCount, nullptr);
+    }
+    for(int i = 0; i < modelCount; ++i) {
+        m_modelStack->addWidget(new QWidget(m_modelStack));
     }
 
     m_mainWidget->layout()->addWidget(m_modelStack);
-    connectModelSignals();
+    m_mainWidget->installEventFilter(this);
 
     switchToModel(Model_1);
 
@@ -84,11 +87,42 @@ void ModelManager::createMainWidget()
     m_mainWidget->setLayout(mainLayout);
 }
 
-void ModelManager::connectModelSignals()
+bool ModelManager::eventFilter(QObject* watched, QEvent* event)
 {
-    for(WT_ModelWidget* w : m_modelWidgets) {
-        connect(w, &WT_ModelWidget::calculationCompleted, this, &ModelManager::onWidgetCalculationCompleted);
+    if (watched == m_mainWidget && event->type() == QEvent::Show) {
+        ensureModelWidget((int)m_currentModelType);
     }
+    return QObject::eventFilter(watched, event);
+}
+
+WT_ModelWidget* ModelManager::ensureModelWidget(int index)
+{
+    if (!m_modelStack || index < 0 || index >= m_modelWidgets.size()) return nullptr;
+    if (m_modelWidgets[index]) return m_modelWidgets[index];
+
+    WT_ModelWidget* widget = new WT_ModelWidget(ModelSolver01_06::ModelType(index), m_modelStack);
+    // 界面默认高精度，全局精度已改为低精度时同步
+    if (!m_highPrecision) widget->setHighPrecision(false);
+    connect(widget, &WT_ModelWidget::requestModelSelection, this, &ModelManager::onSelectModelClicked);
+    connect(widget, &WT_ModelWidget::calculationCompleted, this, &ModelManager::onWidgetCalculationCompleted);
+
+    const bool current = m_modelStack->currentIndex() == index;
+    QWidget* placeholder = m_modelStack->widget(index);
+    m_modelStack->insertWidget(index, widget);
+    m_modelStack->removeWidget(placeholder);
+    delete placeholder;
+    if (current) m_modelStack->setCurrentIndex(index);
+
+    m_modelWidgets[index] = widget;
+    return widget;
+}
+
+ModelSolver01_06* ModelManager::solverAt(int index)
+{
+    QMutexLocker locker(&m_solverMutex);
+    if (index < 0 || index >= m_solvers.size()) return nullptr;
+    if (!m_solvers[index]) m_solvers[index] = new ModelSolver01_06(ModelSolver01_06::ModelType(index));
+    return m_solvers[index];
 }
 
 void ModelManager::switchToModel(ModelType modelType)
@@ -99,6 +133,8 @@ void ModelManager::switchToModel(ModelType modelType)
     int index = (int)modelType;
 
     if (index >= 0 && index < m_modelWidgets.size()) {
+        // 模型页已显示时立即创建该模型的界面，否则等到模型页显示
+        if (m_mainWidget && m_mainWidget->isVisible()) ensureModelWidget(index);
         m_modelStack->setCurrentIndex(index);
     }
 
@@ -135,18 +171,17 @@ void ModelManager::onWidgetCalculationCompleted(const QString &t, const QMap<QSt
 void ModelManager::setHighPrecision(bool high) {
     // 1. 设置界面里的求解器精度
     for(WT_ModelWidget* w : m_modelWidgets) {
-        w->setHighPrecision(high);
-    }
-    // 2. 设置后台求解器精度 (关键：拟合时使用的是这里的求解器)
-    for(ModelSolver01_06* s : m_solvers) {
-        s->setHighPrecision(high);
+        if (w) w->setHighPrecision(high);
     }
+    // 2. 后台求解器为共享实例，不再修改其状态，只记录默认精度并在调用时随选项传入
+    m_highPrecision = high;
 }
 
 void ModelManager::updateAllModelsBasicParameters()
 {
+    // 未创建的界面在创建时从全局项目设置读取参数
     for(WT_ModelWidget* w : m_modelWidgets) {
-        QMetaObject::invokeMethod(w, "onResetParameters");
+        if (w) QMetaObject::invokeMethod(w, "onResetParameters");
     }
     qDebug() << "所有模型的参数已从全局项目设置中刷新。";
 }
@@ -193,14 +228,57 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
 // [核心修改] 使用独立的 Solver 进行计算，不再调用 Widget 方法
 ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
-    int index = (int)type;
     // 使用 m_solvers 而不是 m_modelWidgets
-    if (index >= 0 && index < m_solvers.size()) {
-        return m_solvers[index]->calculateTheoreticalCurve(params, providedTime);
+    if (ModelSolver01_06* solver = solverAt((int)type)) {
+        ModelSolver01_06::CalcOptions options;
+        options.highPrecision = m_highPrecision;
+        return solver->calculateTheoreticalCurve(params, providedTime, options);
+    }
+    return ModelCurveData();
+}
+
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime, const ModelSolver01_06::CalcOptions& options)
+{
+    if (ModelSolver01_06* solver = solverAt((int)type)) {
+        return solver->calculateTheoreticalCurve(params, providedTime, options);
     }
     return ModelCurveData();
 }
 
+ModelCurveData ModelManager::calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                  SolverControl* control)
+{
+    ModelSolver01_06::CalcOptions options;
+    options.highPrecision = m_highPrecision;
+    options.typeCurveLookup = true;
+    options.control = control;
+    return calculateTheoreticalCurve(type, params, providedTime, options);
+}
+
+ModelCurveData ModelManager::calculateAdaptiveCurve(ModelType type, const QMap<QString, double>& params, double tMin, double tMax,
+                                                   SolverControl* control)
+{
+    ModelSolver01_06* solver = solverAt((int)type);
+    if (!solver) return ModelCurveData();
+    // 型曲线库按固定网格补齐，自适应网格只在直接反演时减少求值次数
+    ModelSolver01_06::CalcOptions options;
+    options.highPrecision = m_highPrecision;
+    options.control = control;
+    return AdaptiveTimeGrid::sample(*solver, ModelSolver01_06::ParamSet::fromMap(params), tMin, tMax, options,
+                                    AdaptiveTimeGrid::Options());
+}
+
+QString ModelManager::typeCurveLibraryPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/typecurves.dat";
+}
+
+QSharedPointer<ModelSolver01_06> ModelManager::createSolver(ModelType type) const
+{
+    // 求解器本身无界面依赖，创建代价很低；独立实例可避免多个拟合任务互相挤占缓存
+    return QSharedPointer<ModelSolver01_06>::create(type);
+}
+
 QVector<double> ModelManager::generateLogTimeSteps(int count, double startExp, double endExp) {
     // 委托给 Solver 的静态方法
     return ModelSolver01_06::generateLogTimeSteps(count, startExp, endExp);
@@ -5,6 +5,8 @@
  * 1. 管理所有试井模型界面 (WT_ModelWidget) 的显示与切换。
  * 2. 管理所有数学模型求解器 (ModelSolver01_06) 的实例与计算。
  * 3. 协调模型计算请求，实现界面与算法的解耦。
+ * 4. 模型界面与求解器都按需创建：界面在栈中先放占位页，模型页首次显示该模型时才创建；
+ *    求解器在第一次计算该模型时创建 (加锁，拟合线程中调用也安全)。
  */
 
 #ifndef MODELMANAGER_H
@@ -15,6 +17,8 @@
 #include <QVector>
 #include <QStackedWidget>
 #include <QPushButton>
+#include <QSharedPointer>
+#include <QMutex>
 
 // 引入新的界面类和求解器类头文件
 #include "wt_modelwidget.h"
@@ -48,11 +52,27 @@ public:
 
     // 核心计算接口：代理给对应的 Solver 进行计算 (线程安全，可在拟合线程调用)
     ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 带计算选项的重载：精度随调用传入，不受 setHighPrecision 影响
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime, const ModelSolver01_06::CalcOptions& options);
+    // 交互预览曲线：经无因次型曲线库插值，只改变时间/压力换算的参数 (φ、μ、Ct、q、h 等) 不再重新反演
+    // control 非空时可在计算中途取消，取消后返回空曲线 (见 CalcOptions::control)
+    ModelCurveData calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                         SolverControl* control = nullptr);
+    // 自适应时间网格的理论曲线 (AdaptiveTimeGrid)：求解器在 [tMin, tMax] 上自行选点，径向流等平直段稀疏，
+    // 井储、线性流、边界过渡处加密 (无观测数据、只需画出曲线形状时使用)
+    ModelCurveData calculateAdaptiveCurve(ModelType type, const QMap<QString, double>& params, double tMin, double tMax,
+                                          SolverControl* control = nullptr);
+
+    // 型曲线库文件位置 (程序启动时载入，退出时保存)
+    static QString typeCurveLibraryPath();
+
+    // 按需创建独立求解器 (各自持有 Laplace 缓存)，供单个拟合任务独占使用
+    QSharedPointer<ModelSolver01_06> createSolver(ModelType type) const;
 
     // 获取默认参数
     QMap<QString, double> getDefaultParameters(ModelType type);
 
-    // 设置全局计算精度
+    // 设置全局计算精度 (仅在界面线程调用；后台计算请使用带选项的接口)
     void setHighPrecision(bool high);
 
     // 刷新所有界面模型的参数显示
@@ -76,21 +96,30 @@ private slots:
     // 接收 Widget 计算完成的信号
     void onWidgetCalculationCompleted(const QString& t, const QMap<QString, double>& r);
 
+protected:
+    // 模型页首次显示时创建当前模型的界面
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private:
     void createMainWidget();
-    void connectModelSignals();
+    // 创建 (或返回已创建的) 模型界面，替换栈中同一位置的占位页
+    WT_ModelWidget* ensureModelWidget(int index);
+    // 返回 (必要时创建) 后台计算用的求解器；index 越界时返回 nullptr
+    ModelSolver01_06* solverAt(int index);
 
 private:
     QWidget* m_mainWidget;
     QStackedWidget* m_modelStack;
 
-    // [修改] 界面列表使用 WT_ModelWidget
+    // [修改] 界面列表使用 WT_ModelWidget (未创建的为 nullptr，栈中对应位置为占位页)
     QVector<WT_ModelWidget*> m_modelWidgets;
 
-    // [新增] 求解器列表，用于纯数学计算 (与界面分离)
+    // [新增] 求解器列表，用于纯数学计算 (与界面分离，未创建的为 nullptr)
     QVector<ModelSolver01_06*> m_solvers;
+    QMutex m_solverMutex;
 
     ModelType m_currentModelType;
+    bool m_highPrecision;   // 不带选项的计算接口所使用的默认精度
 
     QVector<double> m_cachedObsTime;
     QVector<double> m_cachedObsPressure;
@@ -3,20 +3,63 @@
  * 文件作用: 项目参数单例类实现文件
  * 功能描述:
  * 1. 实现项目数据的加载与保存。
- * 2. [关键] loadProject 时强制读取 _date.json 到 m_fullProjectData["table_data"]，解决数据丢失问题。
+ * 2. [关键] loadProject 时清空上一个项目的表格缓存 m_tableData，解决数据串项目问题。
+ * 3. 表格数据以列式二进制文件 _date.wtd 保存 (见 ProjectDataFile)；没有该文件时读取旧版 _date.json。
+ * 4. 附属文件不在 loadProject 中读取，由各页面首次请求时在后台线程加载，打开项目只解析 .pwt 主文件。
+ * 5. 保存时先与内存中的上次内容比较，只把变化的文件交给单线程写入队列；QSaveFile 保证写入中断时原文件完好。
  */
 
 #include "modelparameter.h"
+#include "projectdatafile.h"
+#include "curvedatafile.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QFileInfo>
 #include <QDebug>
+#include <QtConcurrent>
+#include <QSaveFile>
+#include <QDir>
+#include <QDateTime>
+#include <cstring>
+#include <memory>
 
 ModelParameter* ModelParameter::m_instance = nullptr;
 
-ModelParameter::ModelParameter(QObject* parent) : QObject(parent), m_hasLoaded(false)
+namespace {
+
+// 按位比较两列数值 (NaN 空值也视为相同)
+bool sameValues(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return a.size() == b.size()
+        && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+
+// 判断表格内容是否与上次保存的相同，相同则无需重写 _date.wtd
+bool sameTable(const TextDataTable& a, const TextDataTable& b)
+{
+    if (a.rowCount != b.rowCount || a.headers != b.headers || a.columns.size() != b.columns.size()) return false;
+    for (int c = 0; c < a.columns.size(); ++c) {
+        const TextDataColumn& x = a.columns[c];
+        const TextDataColumn& y = b.columns[c];
+        if (x.isNumeric != y.isNumeric) return false;
+        if (x.isNumeric ? !sameValues(x.values, y.values) : x.texts != y.texts) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ModelParameter::ModelParameter(QObject* parent) : QObject(parent), m_hasLoaded(false),
+    m_tableState(NotLoaded), m_plottingState(NotLoaded), m_dirtySections(0)
 {
     m_phi = 0.05; m_h = 20.0; m_mu = 0.5; m_B = 1.05; m_Ct = 5e-4; m_q = 50.0; m_rw = 0.1;
+
+    // 单线程：同一文件的多次写入按提交顺序执行，不会相互覆盖
+    m_writerPool.setMaxThreadCount(1);
+    m_writerPool.setExpiryTimeout(-1);
+
+    connect(&m_tableWatcher, &QFutureWatcher<TextDataTable>::finished, this, &ModelParameter::onTableLoadFinished);
+    connect(&m_plottingWatcher, &QFutureWatcher<QJsonArray>::finished, this, &ModelParameter::onPlottingLoadFinished);
 }
 
 ModelParameter* ModelParameter::instance()
@@ -47,6 +90,7 @@ void ModelParameter::setParameters(double phi, double h, double mu, double B, do
         m_fullProjectData["reservoir"] = reservoir;
         m_fullProjectData["pvt"] = pvt;
     }
+    m_dirtySections |= ProjectSection;
 }
 
 // 构造图表数据路径: 原文件名 + "_chart.json"
@@ -58,8 +102,26 @@ QString ModelParameter::getPlottingDataFilePath() const
     return fi.absolutePath() + "/" + baseName + "_chart.json";
 }
 
-// 构造表格数据路径: 原文件名 + "_date.json"
+// 构造曲线数组路径: 原文件名 + "_chart.wtd"
+QString ModelParameter::getPlottingCurveDataFilePath() const
+{
+    if (m_projectFilePath.isEmpty()) return QString();
+    QFileInfo fi(m_projectFilePath);
+    QString baseName = fi.completeBaseName();
+    return fi.absolutePath() + "/" + baseName + "_chart.wtd";
+}
+
+// 构造表格数据路径: 原文件名 + "_date.wtd"
 QString ModelParameter::getTableDataFilePath() const
+{
+    if (m_projectFilePath.isEmpty()) return QString();
+    QFileInfo fi(m_projectFilePath);
+    QString baseName = fi.completeBaseName();
+    return fi.absolutePath() + "/" + baseName + "_date.wtd";
+}
+
+// 旧版表格数据路径: 原文件名 + "_date.json" (只读，兼容旧项目)
+QString ModelParameter::getLegacyTableDataFilePath() const
 {
     if (m_projectFilePath.isEmpty()) return QString();
     QFileInfo fi(m_projectFilePath);
@@ -69,6 +131,9 @@ QString ModelParameter::getTableDataFilePath() const
 
 bool ModelParameter::loadProject(const QString& filePath)
 {
+    // 上一个项目 (或同一项目) 的写入必须先落盘，否则可能读到旧文件
+    waitForPendingWrites();
+
     // 1. 加载主项目文件 (.pwt)
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -102,45 +167,112 @@ bool ModelParameter::loadProject(const QString& filePath)
     m_projectFilePath = filePath;
     m_projectPath = QFileInfo(filePath).absolutePath();
     m_hasLoaded = true;
+    m_dirtySections = 0;
 
-    // 2. 加载图表数据 (_chart.json)
-    QString chartPath = getPlottingDataFilePath();
-    QFile chartFile(chartPath);
-    if (chartFile.exists() && chartFile.open(QIODevice::ReadOnly)) {
-        QJsonDocument d = QJsonDocument::fromJson(chartFile.readAll());
-        if (!d.isNull() && d.isObject()) {
-            QJsonObject obj = d.object();
-            if (obj.contains("plotting_data")) {
-                m_fullProjectData["plotting_data"] = obj["plotting_data"];
-            }
+    // 2. 附属文件 (_chart.json、_date.wtd) 不在此处读取，由页面首次请求时后台加载
+    // 先清除内存中的旧数据，防止显示上一个项目的表格和图表
+    m_fullProjectData.remove("plotting_data");
+    m_fullProjectData.remove("table_data");
+    resetSidecarData();
+
+    return true;
+}
+
+void ModelParameter::resetSidecarData()
+{
+    // 进行中的后台加载仍会执行完，但状态已不是 Loading，结果在 onXxxLoadFinished 中被丢弃
+    m_tableData = TextDataTable();
+    m_plottingData = QJsonArray();
+    m_tableState = NotLoaded;
+    m_plottingState = NotLoaded;
+}
+
+// 读取表格数据 (_date.wtd，没有时读取旧版 _date.json)
+// 必须确保这里的逻辑与 DataEditorWidget::onSave 对应
+TextDataTable ModelParameter::readTableFile(const QString& path, const QString& legacyPath)
+{
+    TextDataTable table;
+    if (QFile::exists(path)) {
+        QString error;
+        if (ProjectDataFile::read(path, table, &error)) {
+            qDebug() << "成功加载表格数据文件:" << path << "数据量:" << table.rowCount;
+        } else {
+            qDebug() << "表格数据文件解析失败:" << path << error;
         }
-        chartFile.close();
+        return table;
     }
 
-    // 3. [关键修复] 加载表格数据 (_date.json)
-    // 必须确保这里的逻辑与 DataEditorWidget::onSave 对应
-    QString datePath = getTableDataFilePath();
-    QFile dateFile(datePath);
+    QFile dateFile(legacyPath);
     if (dateFile.exists() && dateFile.open(QIODevice::ReadOnly)) {
         QJsonDocument d = QJsonDocument::fromJson(dateFile.readAll());
-        if (!d.isNull() && d.isObject()) {
-            QJsonObject obj = d.object();
-            if (obj.contains("table_data")) {
-                // 将读取到的数组存入内存，供 DataEditorWidget::loadFromProjectData 获取
-                m_fullProjectData["table_data"] = obj["table_data"];
-                qDebug() << "成功加载表格数据文件:" << datePath << "数据量:" << obj["table_data"].toArray().size();
-            }
+        if (!d.isNull() && d.isObject() && d.object().contains("table_data")) {
+            // 旧格式转换为列式数据，下次保存时写为 _date.wtd
+            table = ProjectDataFile::fromJsonArray(d.object()["table_data"].toArray());
+            qDebug() << "成功加载旧版表格数据文件:" << legacyPath << "数据量:" << table.rowCount;
         } else {
-            qDebug() << "表格数据文件解析失败:" << datePath;
+            qDebug() << "表格数据文件解析失败:" << legacyPath;
         }
         dateFile.close();
     } else {
-        qDebug() << "未找到表格数据文件:" << datePath;
-        // 如果文件不存在，务必清除内存中的旧数据，防止显示错误
-        m_fullProjectData.remove("table_data");
+        qDebug() << "未找到表格数据文件:" << path;
     }
+    return table;
+}
 
-    return true;
+// 读取图表数据 (_chart.json)
+QJsonArray ModelParameter::readPlottingFile(const QString& path)
+{
+    QFile chartFile(path);
+    if (chartFile.exists() && chartFile.open(QIODevice::ReadOnly)) {
+        QJsonDocument d = QJsonDocument::fromJson(chartFile.readAll());
+        chartFile.close();
+        if (!d.isNull() && d.isObject()) return d.object().value("plotting_data").toArray();
+    }
+    return QJsonArray();
+}
+
+void ModelParameter::requestTableData()
+{
+    if (m_tableState == Loaded) {
+        QMetaObject::invokeMethod(this, &ModelParameter::tableDataReady, Qt::QueuedConnection);
+        return;
+    }
+    if (m_tableState == Loading) return; // 完成时统一发出信号
+    if (m_projectFilePath.isEmpty()) return;
+
+    m_tableState = Loading;
+    m_tableWatcher.setFuture(QtConcurrent::run(&ModelParameter::readTableFile,
+                                               getTableDataFilePath(), getLegacyTableDataFilePath()));
+}
+
+void ModelParameter::requestPlottingData()
+{
+    if (m_plottingState == Loaded) {
+        QMetaObject::invokeMethod(this, &ModelParameter::plottingDataReady, Qt::QueuedConnection);
+        return;
+    }
+    if (m_plottingState == Loading) return;
+    if (m_projectFilePath.isEmpty()) return;
+
+    m_plottingState = Loading;
+    m_plottingWatcher.setFuture(QtConcurrent::run(&ModelParameter::readPlottingFile, getPlottingDataFilePath()));
+}
+
+void ModelParameter::onTableLoadFinished()
+{
+    // 项目已关闭/切换，或数据已被同步读取、保存覆盖时丢弃本次结果
+    if (m_tableState != Loading) return;
+    m_tableData = m_tableWatcher.result();
+    m_tableState = Loaded;
+    emit tableDataReady();
+}
+
+void ModelParameter::onPlottingLoadFinished()
+{
+    if (m_plottingState != Loading) return;
+    m_plottingData = m_plottingWatcher.result();
+    m_plottingState = Loaded;
+    emit plottingDataReady();
 }
 
 bool ModelParameter::saveProject()
@@ -148,31 +280,132 @@ bool ModelParameter::saveProject()
     if (!m_hasLoaded || m_projectFilePath.isEmpty()) return false;
 
     // 更新参数到内存对象
-    QJsonObject reservoir;
-    if(m_fullProjectData.contains("reservoir")) reservoir = m_fullProjectData["reservoir"].toObject();
+    QJsonObject oldReservoir = m_fullProjectData.value("reservoir").toObject();
+    QJsonObject reservoir = oldReservoir;
     reservoir["porosity"] = m_phi;
     reservoir["thickness"] = m_h;
     reservoir["wellRadius"] = m_rw;
     reservoir["productionRate"] = m_q;
-    m_fullProjectData["reservoir"] = reservoir;
 
-    QJsonObject pvt;
-    if(m_fullProjectData.contains("pvt")) pvt = m_fullProjectData["pvt"].toObject();
+    QJsonObject oldPvt = m_fullProjectData.value("pvt").toObject();
+    QJsonObject pvt = oldPvt;
     pvt["viscosity"] = m_mu;
     pvt["volumeFactor"] = m_B;
     pvt["compressibility"] = m_Ct;
-    m_fullProjectData["pvt"] = pvt;
+
+    if (reservoir != oldReservoir || pvt != oldPvt) {
+        m_fullProjectData["reservoir"] = reservoir;
+        m_fullProjectData["pvt"] = pvt;
+        m_dirtySections |= ProjectSection;
+    }
+
+    flushProjectFile();
+    return true;
+}
+
+void ModelParameter::flushProjectFile()
+{
+    if (!(m_dirtySections & ProjectSection) || m_projectFilePath.isEmpty()) return;
+    m_dirtySections &= ~ProjectSection;
 
     // 保存 .pwt 主文件时，剔除大数据块，只保留配置
     QJsonObject dataToWrite = m_fullProjectData;
     dataToWrite.remove("plotting_data");
     dataToWrite.remove("table_data");
 
-    QFile file(m_projectFilePath);
-    if (!file.open(QIODevice::WriteOnly)) return false;
-    file.write(QJsonDocument(dataToWrite).toJson());
-    file.close();
+    const QString path = m_projectFilePath;
+    enqueueWrite(ProjectSection, path, [path, dataToWrite](QString* error) {
+        return writeJsonFile(path, dataToWrite, error);
+    });
+}
+
+void ModelParameter::enqueueWrite(Section section, const QString& filePath, const std::function<bool(QString*)>& writer)
+{
+    QAtomicInt& latest = m_writeSerial[section == ProjectSection ? 0 : (section == PlottingSection ? 1 : 2)];
+    const int serial = latest.fetchAndAddOrdered(1) + 1;
+
+    m_writerPool.start([this, &latest, serial, filePath, writer]() {
+        // 同一文件已有更新的快照排队时，本次写入已过时，直接跳过
+        if (latest.loadAcquire() != serial) return;
 
+        QString error;
+        if (writer(&error)) {
+            qDebug() << "已保存:" << filePath;
+            return;
+        }
+        qDebug() << "保存失败:" << filePath << error;
+        QMetaObject::invokeMethod(this, [this, filePath, error]() {
+            emit saveFailed(filePath, error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ModelParameter::waitForPendingWrites()
+{
+    m_writerPool.waitForDone();
+}
+
+void ModelParameter::backupProject(const QString& backupDir, int maxBackups)
+{
+    if (m_projectFilePath.isEmpty() || backupDir.isEmpty() || maxBackups < 1) return;
+
+    // 旧版 _date.json 只在没有 _date.wtd 时才有意义，一并列入，不存在的文件跳过
+    const QStringList files = { m_projectFilePath, getPlottingDataFilePath(), getPlottingCurveDataFilePath(),
+                                getTableDataFilePath(), getLegacyTableDataFilePath() };
+    const QString baseName = QFileInfo(m_projectFilePath).completeBaseName();
+
+    m_writerPool.start([this, files, backupDir, baseName, maxBackups]() {
+        QString error;
+        if (copyProjectFiles(files, backupDir, baseName, maxBackups, &error)) return;
+        qDebug() << "项目备份失败:" << backupDir << error;
+        QMetaObject::invokeMethod(this, [this, backupDir, error]() {
+            emit saveFailed(backupDir, error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// 写入线程中执行：复制到新的时间戳目录，再按名称 (即时间) 删除最旧的多余备份
+bool ModelParameter::copyProjectFiles(const QStringList& files, const QString& backupDir, const QString& baseName,
+                                      int maxBackups, QString* errorMessage)
+{
+    QDir root(backupDir);
+    const QString folder = baseName + "_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+    if (!root.mkpath(folder)) {
+        if (errorMessage) *errorMessage = "无法创建备份目录";
+        return false;
+    }
+
+    const QString target = root.filePath(folder);
+    for (const QString& file : files) {
+        if (!QFile::exists(file)) continue;
+        const QString dst = target + "/" + QFileInfo(file).fileName();
+        QFile::remove(dst);
+        if (!QFile::copy(file, dst)) {
+            if (errorMessage) *errorMessage = "无法复制 " + file;
+            return false;
+        }
+    }
+
+    QStringList backups = root.entryList(QStringList() << baseName + "_????????_??????", QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    while (backups.size() > maxBackups) {
+        QDir(root.filePath(backups.takeFirst())).removeRecursively();
+    }
+    return true;
+}
+
+// 写入 JSON 文件：先写临时文件，提交成功后原子替换
+bool ModelParameter::writeJsonFile(const QString& filePath, const QJsonObject& obj, QString* errorMessage)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(obj).toJson());
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
     return true;
 }
 
@@ -182,22 +415,19 @@ void ModelParameter::closeProject()
     m_projectPath.clear();
     m_projectFilePath.clear();
     m_fullProjectData = QJsonObject();
+    m_dirtySections = 0;
+    resetSidecarData();
     m_phi=0.05; m_h=20.0; m_mu=0.5; m_B=1.05; m_Ct=5e-4; m_q=50.0; m_rw=0.1;
 }
 
 void ModelParameter::saveFittingResult(const QJsonObject& fittingData)
 {
     if (m_projectFilePath.isEmpty()) return;
-    m_fullProjectData["fitting"] = fittingData;
-
-    QFile file(m_projectFilePath);
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonObject dataToWrite = m_fullProjectData;
-        dataToWrite.remove("plotting_data");
-        dataToWrite.remove("table_data");
-        file.write(QJsonDocument(dataToWrite).toJson());
-        file.close();
+    if (m_fullProjectData.value("fitting").toObject() != fittingData) {
+        m_fullProjectData["fitting"] = fittingData;
+        m_dirtySections |= ProjectSection;
     }
+    flushProjectFile();
 }
 
 QJsonObject ModelParameter::getFittingResult() const
@@ -205,49 +435,62 @@ QJsonObject ModelParameter::getFittingResult() const
     return m_fullProjectData.value("fitting").toObject();
 }
 
-void ModelParameter::savePlottingData(const QJsonArray& plots)
+bool ModelParameter::isPlottingDataUnchanged(const QJsonArray& plots) const
+{
+    // 只有缓存内容可信 (已加载) 时才能据此判断未变化
+    return m_plottingState == Loaded && m_plottingData == plots;
+}
+
+void ModelParameter::savePlottingData(const QJsonArray& plots, const QMap<QString, QVector<double>>& curveData)
 {
     if (m_projectFilePath.isEmpty()) return;
+    if (isPlottingDataUnchanged(plots)) return;
 
-    m_fullProjectData["plotting_data"] = plots;
+    m_plottingData = plots;
+    m_plottingState = Loaded;
 
-    QString dataFilePath = getPlottingDataFilePath();
     QJsonObject dataObj;
     dataObj["plotting_data"] = plots;
 
-    QFile file(dataFilePath);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(dataObj).toJson());
-        file.close();
-    }
+    // 先写曲线数组再写配置：配置引用的数组总是已经落盘
+    const QString path = getPlottingDataFilePath();
+    const QString curvePath = getPlottingCurveDataFilePath();
+    enqueueWrite(PlottingSection, path, [path, curvePath, dataObj, curveData](QString* error) {
+        return CurveDataFile::write(curvePath, curveData, error) && writeJsonFile(path, dataObj, error);
+    });
 }
 
-QJsonArray ModelParameter::getPlottingData() const
+QJsonArray ModelParameter::getPlottingData()
 {
-    return m_fullProjectData.value("plotting_data").toArray();
+    if (m_plottingState == Loading) {
+        m_plottingWatcher.waitForFinished();
+        onPlottingLoadFinished();
+    } else if (m_plottingState == NotLoaded && !m_projectFilePath.isEmpty()) {
+        m_plottingData = readPlottingFile(getPlottingDataFilePath());
+        m_plottingState = Loaded;
+    }
+    return m_plottingData;
 }
 
 // 保存表格数据
-void ModelParameter::saveTableData(const QJsonArray& tableData)
+void ModelParameter::saveTableData(const TextDataTable& tableData)
 {
     if (m_projectFilePath.isEmpty()) return;
 
-    // 1. 更新内存缓存
-    m_fullProjectData["table_data"] = tableData;
+    // 1. 内容未变化时不重写 (压缩和写盘远比逐列比较耗时)
+    if (m_tableState == Loaded && sameTable(m_tableData, tableData)) return;
 
-    // 2. 写入独立文件 _date.json
-    QString dataFilePath = getTableDataFilePath();
-    QJsonObject dataObj;
-    dataObj["table_data"] = tableData;
+    // 2. 更新内存缓存 (进行中的后台加载结果随之作废)
+    m_tableData = tableData;
+    m_tableState = Loaded;
 
-    QFile file(dataFilePath);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(dataObj).toJson());
-        file.close();
-        qDebug() << "表格数据已保存至:" << dataFilePath << "条目数:" << tableData.size();
-    } else {
-        qDebug() << "表格数据保存失败:" << dataFilePath;
-    }
+    // 3. 在写入线程中写独立文件 _date.wtd (列式二进制，文本列压缩)
+    //    快照用共享指针持有，排队过程中不再深拷贝列数据
+    const QString path = getTableDataFilePath();
+    auto snapshot = std::make_shared<const TextDataTable>(tableData);
+    enqueueWrite(TableSection, path, [path, snapshot](QString* error) {
+        return ProjectDataFile::write(path, *snapshot, true, error);
+    });
 }
 
 
@@ -271,13 +514,22 @@ void ModelParameter::resetAllData()
     // 3. [关键] 清空核心数据存储对象
     // 你的代码中，表格数据、绘图数据、拟合数据全都在这个对象里
     m_fullProjectData = QJsonObject();
+    m_dirtySections = 0;
+    resetSidecarData();
 
     qDebug() << "ModelParameter: 所有全局数据缓存已清空 (m_fullProjectData 已重置)。";
 }
 
 // 获取表格数据
-QJsonArray ModelParameter::getTableData() const
+TextDataTable ModelParameter::getTableData()
 {
-    // 直接从内存缓存中读取（loadProject 时已填充）
-    return m_fullProjectData.value("table_data").toArray();
+    // 后台加载进行中则等待；从未请求过则同步读取
+    if (m_tableState == Loading) {
+        m_tableWatcher.waitForFinished();
+        onTableLoadFinished();
+    } else if (m_tableState == NotLoaded && !m_projectFilePath.isEmpty()) {
+        m_tableData = readTableFile(getTableDataFilePath(), getLegacyTableDataFilePath());
+        m_tableState = Loaded;
+    }
+    return m_tableData;
 }
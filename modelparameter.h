@@ -3,8 +3,11 @@
  * 文件作用: 项目参数单例类头文件
  * 功能描述:
  * 1. 管理项目核心数据（孔隙度、粘度等）和文件路径。
- * 2. 负责 _chart.json (图表) 和 _date.json (表格) 的路径生成和存取。
+ * 2. 负责 _chart.json (图表)、_chart.wtd (曲线数组，二进制) 和 _date.wtd (表格，列式二进制) 的路径生成和存取；
+ *    旧版 _date.json 只读。
  * 3. 确保项目保存和加载时，数据表格的内容能被正确持久化。
+ * 4. 打开项目时只读取 .pwt 主文件；表格、绘图附属文件在首次请求时于后台线程读取，完成后发出就绪信号。
+ * 5. 保存按文件分区记录脏标记，只写入内容有变化的文件；写入在单线程后台队列中执行 (临时文件 + 替换)。
  */
 
 #ifndef MODELPARAMETER_H
@@ -16,6 +19,13 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QMutex>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QMap>
+#include <QVector>
+#include <functional>
+#include "textdatareader.h" // TextDataTable 定义
 
 class ModelParameter : public QObject
 {
@@ -29,12 +39,21 @@ public:
     // ========================================================================
 
     // 加载项目文件 (.pwt)
-    // 作用：读取主文件配置，并自动寻找同目录下的 _date.json 加载表格数据
+    // 作用：只读取主文件配置 (油藏、PVT、拟合状态)；_chart.json、_date.wtd 等附属文件按需加载
     bool loadProject(const QString& filePath);
 
-    // 保存基础参数到 .pwt 文件
+    // 保存基础参数到 .pwt 文件；参数和拟合状态都未变化时不写文件
+    // 写入在后台进行，返回 false 仅表示没有打开的项目，写入失败通过 saveFailed 通知
     bool saveProject();
 
+    // 是否有尚未提交写入的修改
+    bool hasUnsavedChanges() const { return m_dirtySections != 0; }
+    // 等待后台写入队列清空 (切换项目、退出程序前调用)
+    void waitForPendingWrites();
+
+    // 在写入队列末尾把项目文件复制到 backupDir/<项目名>_<时间>/，只保留最近 maxBackups 份
+    void backupProject(const QString& backupDir, int maxBackups);
+
     // 关闭项目，清空内存数据
     void closeProject();
 
@@ -56,7 +75,7 @@ public:
     double getQ() const { return m_q; }
     double getRw() const { return m_rw; }
 
-    // 保存拟合结果
+    // 保存拟合结果 (与上次内容相同时不写文件)
     void saveFittingResult(const QJsonObject& fittingData);
     QJsonObject getFittingResult() const;
 
@@ -64,22 +83,45 @@ public:
     // 独立数据文件存取 (关键修复部分)
     // ========================================================================
 
-    // 保存绘图数据到 "_chart.json"
-    void savePlottingData(const QJsonArray& plots);
-    QJsonArray getPlottingData() const;
-
-    // 保存表格数据到 "_date.json"
+    // 保存绘图数据：曲线配置写入 "_chart.json"，曲线数组写入 "_chart.wtd" (配置与上次相同时不写文件)
+    // 配置中以数组名称引用 curveData 中的数组，数组内容变化时名称随之变化
+    void savePlottingData(const QJsonArray& plots, const QMap<QString, QVector<double>>& curveData);
+    // 配置与已保存的内容相同 (调用方据此省去收集曲线数组)
+    bool isPlottingDataUnchanged(const QJsonArray& plots) const;
+    // 曲线数组文件路径，由绘图页面用 CurveDataFile 映射读取
+    QString getPlottingCurveDataFilePath() const;
+    // 获取绘图数据；尚未加载时同步读取 (后台加载进行中则等待其完成)
+    QJsonArray getPlottingData();
+
+    // 保存表格数据到 "_date.wtd" (与上次内容相同时不写文件)
     // DataEditorWidget 调用此函数将表格内容写入磁盘
-    void saveTableData(const QJsonArray& tableData);
+    void saveTableData(const TextDataTable& tableData);
 
 
     // 重置所有项目数据（清空缓存）
     void resetAllData();
 
 
-    // 获取表格数据
-    // DataEditorWidget 加载项目时调用此函数恢复界面
-    QJsonArray getTableData() const;
+    // 获取表格数据；尚未加载时同步读取 (后台加载进行中则等待其完成)
+    // DataEditorWidget 收到 tableDataReady 后调用此函数恢复界面
+    TextDataTable getTableData();
+
+    // 按需异步加载附属文件：首次请求时在后台线程读取，完成后发出对应的就绪信号；
+    // 已加载时在下一轮事件循环直接发出信号
+    void requestTableData();
+    void requestPlottingData();
+    bool isTableDataReady() const { return m_tableState == Loaded; }
+    bool isPlottingDataReady() const { return m_plottingState == Loaded; }
+
+signals:
+    void tableDataReady();
+    void plottingDataReady();
+    // 后台写入失败
+    void saveFailed(const QString& filePath, const QString& errorMessage);
+
+private slots:
+    void onTableLoadFinished();
+    void onPlottingLoadFinished();
 
 private:
     explicit ModelParameter(QObject* parent = nullptr);
@@ -91,6 +133,20 @@ private:
 
     // 缓存完整的JSON对象，包含从各个子文件读取的内容
     QJsonObject m_fullProjectData;
+    // 附属文件数据分别缓存，不再放入 JSON 对象
+    enum LoadState { NotLoaded, Loading, Loaded };
+    TextDataTable m_tableData;        // 表格数据 (列式)
+    QJsonArray m_plottingData;        // 绘图曲线
+    LoadState m_tableState;
+    LoadState m_plottingState;
+    QFutureWatcher<TextDataTable> m_tableWatcher;
+    QFutureWatcher<QJsonArray> m_plottingWatcher;
+
+    // 保存分区：每个分区对应一个磁盘文件
+    enum Section { ProjectSection = 0x1, PlottingSection = 0x2, TableSection = 0x4 };
+    int m_dirtySections;              // 已修改但尚未提交写入的分区
+    QThreadPool m_writerPool;         // 单线程写入队列，保证按提交顺序落盘
+    QAtomicInt m_writeSerial[3];      // 各分区最新写入任务序号，排队中的旧快照据此跳过
 
     // 基础参数变量
     double m_phi;
@@ -104,6 +160,21 @@ private:
     // 辅助：获取附属文件的绝对路径
     QString getPlottingDataFilePath() const;
     QString getTableDataFilePath() const;
+    QString getLegacyTableDataFilePath() const;
+    // 清除附属文件缓存，进行中的后台加载结果将被丢弃
+    void resetSidecarData();
+
+    // 将已修改的 .pwt 主文件内容提交到写入队列
+    void flushProjectFile();
+    // 提交一次分区写入；writer 在写入线程中执行，只能使用按值捕获的快照
+    void enqueueWrite(Section section, const QString& filePath, const std::function<bool(QString*)>& writer);
+    static bool writeJsonFile(const QString& filePath, const QJsonObject& obj, QString* errorMessage);
+    static bool copyProjectFiles(const QStringList& files, const QString& backupDir, const QString& baseName,
+                                 int maxBackups, QString* errorMessage);
+
+    // 后台线程中执行的文件读取，只依赖参数中的路径
+    static TextDataTable readTableFile(const QString& path, const QString& legacyPath);
+    static QJsonArray readPlottingFile(const QString& path);
 };
 
 #endif // MODELPARAMETER_H
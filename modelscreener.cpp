@@ -0,0 +1,116 @@
+/*
+ * 文件名: modelscreener.cpp
+ * 文件作用: 模型自动筛选实现
+ * 功能描述:
+ * 1. 观测数据按 pointsPerCycle 抽稀一次，全部候选模型共用。
+ * 2. 各候选模型并发拟合，统计残差个数 n、拟合参数个数 k，计算 AIC / BIC。
+ * 3. 排序后按需对第一名在全部数据上高精度精修。
+ */
+
+#include "modelscreener.h"
+
+#include <QtConcurrent>
+#include <QAtomicInt>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void ModelScreener::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv)
+{
+    m_obsTime = t;
+    m_obsDeltaP = deltaP;
+    m_obsDerivative = deriv;
+}
+
+double ModelScreener::criterionValue(const Ranking& r, Criterion criterion)
+{
+    switch (criterion) {
+    case ByAic: return r.aic;
+    case ByBic: return r.bic;
+    case ByMse: return r.mse;
+    }
+    return r.mse;
+}
+
+QList<ModelScreener::Ranking> ModelScreener::run(const QList<Candidate>& candidates, const Options& options)
+{
+    QList<Ranking> rankings;
+    if (candidates.isEmpty() || m_obsTime.isEmpty()) return rankings;
+
+    // 筛选用的抽稀数据：与界面设置无关，固定按 pointsPerCycle 取点
+    LogTimeResampler::Options resample;
+    resample.enabled = true;
+    resample.pointsPerCycle = options.pointsPerCycle;
+    LogTimeResampler::Result screenData = LogTimeResampler::resample(m_obsTime, m_obsDeltaP, m_obsDerivative, resample);
+    if (screenData.time.isEmpty()) return rankings;
+
+    FittingCore::Options fitOptions = options.fit;
+    fitOptions.highPrecision = false;
+
+    QVector<Ranking> results(candidates.size());
+    QAtomicInt finished(0);
+    const int total = candidates.size();
+
+    auto screenOne = [&](int index) {
+        const Candidate& c = candidates[index];
+        Ranking& r = results[index];
+        r.type = c.type;
+        r.parameterCount = std::count_if(c.params.begin(), c.params.end(), [](const FitParameter& p) { return p.isFit; });
+
+        FittingCore core(QSharedPointer<ModelSolver01_06>::create(c.type));
+        core.setObservedData(screenData.time, screenData.deltaP, screenData.derivative);
+        if (m_stopRequested) core.setStopPredicate(m_stopRequested);
+        FittingCore::Result fit = core.run(c.params, fitOptions);
+
+        r.params = fit.params;
+        r.mse = (r.parameterCount > 0 && std::isfinite(fit.mse)) ? fit.mse : std::numeric_limits<double>::infinity();
+        r.iterations = fit.iterations;
+        r.residualCount = core.residualCount();
+
+        // 以均方误差为方差估计的高斯似然；误差为 0 时取极小值避免 log(0)
+        const double n = r.residualCount;
+        const double logMse = std::log(qMax(r.mse, 1e-300));
+        r.aic = n * logMse + 2.0 * r.parameterCount;
+        r.bic = n * logMse + r.parameterCount * std::log(qMax(n, 1.0));
+
+        int done = finished.fetchAndAddOrdered(1) + 1;
+        if (m_onProgress) m_onProgress(done, total);
+    };
+
+    QVector<int> indices(total);
+    for (int i = 0; i < total; ++i) indices[i] = i;
+    QtConcurrent::blockingMap(indices, screenOne);
+
+    rankings = QList<Ranking>(results.begin(), results.end());
+    std::stable_sort(rankings.begin(), rankings.end(), [&](const Ranking& a, const Ranking& b) {
+        bool fa = std::isfinite(a.mse), fb = std::isfinite(b.mse);
+        if (fa != fb) return fa;
+        return criterionValue(a, options.criterion) < criterionValue(b, options.criterion);
+    });
+
+    // 只精修第一名：以筛选结果为初值，在全部数据上高精度迭代
+    if (options.refineBest && std::isfinite(rankings[0].mse) && !(m_stopRequested && m_stopRequested())) {
+        Ranking& best = rankings[0];
+        QList<FitParameter> start;
+        for (const Candidate& c : candidates) {
+            if (c.type == best.type) { start = c.params; break; }
+        }
+        for (auto& p : start) p.value = best.params.value(p.name, p.value);
+
+        FittingCore refine(QSharedPointer<ModelSolver01_06>::create(best.type));
+        refine.setObservedData(m_obsTime, m_obsDeltaP, m_obsDerivative);
+        if (m_onRefineIteration) refine.setIterationCallback(m_onRefineIteration);
+        if (m_stopRequested) refine.setStopPredicate(m_stopRequested);
+        FittingCore::Options refineOptions = options.fit;
+        refineOptions.maxIterations = options.refineIterations;
+        refineOptions.highPrecision = true;
+        FittingCore::Result refined = refine.run(start, refineOptions);
+        if (std::isfinite(refined.mse)) {
+            best.params = refined.params;
+            best.mse = refined.mse;
+            best.iterations += refined.iterations;
+            best.refined = true;
+        }
+    }
+    return rankings;
+}
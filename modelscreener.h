@@ -0,0 +1,84 @@
+/*
+ * 文件名: modelscreener.h
+ * 文件作用: 模型自动筛选头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 同时拟合多个候选模型 (通常为 Model_1 ~ Model_6)，各模型在线程池中并发执行、各用独立求解器。
+ * 2. 筛选阶段使用低阶 Stehfest (FittingCore 迭代默认) 和对数时间抽稀后的数据，降低单个模型的计算量。
+ * 3. 按误差与信息准则 (AIC / BIC，计入各模型实际拟合的参数个数) 排序。
+ * 4. 只对排名第一的模型在全部数据上以高精度精修。
+ */
+
+#ifndef MODELSCREENER_H
+#define MODELSCREENER_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "fittingcore.h"
+#include "logtimeresampler.h"
+
+class ModelScreener
+{
+public:
+    // 排序依据
+    enum Criterion {
+        ByAic = 0,  // n*ln(SSE/n) + 2k
+        ByBic,      // n*ln(SSE/n) + k*ln(n)
+        ByMse
+    };
+
+    // 候选模型及其初始参数 (参数表需与该模型匹配，是否拟合由 isFit 决定)
+    struct Candidate {
+        ModelSolver01_06::ModelType type;
+        QList<FitParameter> params;
+    };
+
+    struct Options {
+        int pointsPerCycle = 15;        // 筛选阶段每个对数周期保留的点数
+        Criterion criterion = ByAic;
+        FittingCore::Options fit;       // 筛选阶段拟合选项 (highPrecision 被忽略，始终为低精度)
+        bool refineBest = true;         // 是否精修排名第一的模型
+        int refineIterations = 10;      // 精修最大迭代次数
+    };
+
+    // 单个模型的筛选结果
+    struct Ranking {
+        ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+        QMap<QString, double> params;
+        double mse = 0.0;
+        int residualCount = 0;          // n
+        int parameterCount = 0;         // k
+        double aic = 0.0;
+        double bic = 0.0;
+        int iterations = 0;
+        bool refined = false;           // params/mse 是否为全数据高精度精修后的值
+    };
+
+    using ProgressCallback = std::function<void(int finished, int total)>;
+    using StopPredicate = std::function<bool()>;
+    // 精修阶段的迭代曲线 (在调用 run 的线程中调用)
+    using IterationCallback = FittingCore::IterationCallback;
+
+    void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv);
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+    void setRefineCallback(IterationCallback cb) { m_onRefineIteration = cb; }
+
+    // 返回按 options.criterion 升序排列的结果；无法求值的模型排在最后
+    QList<Ranking> run(const QList<Candidate>& candidates, const Options& options);
+
+    static double criterionValue(const Ranking& r, Criterion criterion);
+
+private:
+    QVector<double> m_obsTime;
+    QVector<double> m_obsDeltaP;
+    QVector<double> m_obsDerivative;
+
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+    IterationCallback m_onRefineIteration;
+};
+
+#endif // MODELSCREENER_H
@@ -3,27 +3,328 @@
  * 文件作用: 压裂水平井复合页岩油模型核心计算类实现
  * 功能描述:
  * 1. 实现6种不同边界和井储条件组合的页岩油数学模型解。
- * 2. 包含 Stehfest 数值反演算法、自适应高斯积分、Bessel 函数调用等核心算法。
+ * 2. 包含 Stehfest、固定 Talbot、de Hoog、Euler 数值反演算法、自适应高斯积分、Bessel 函数调用等核心算法。
  * 3. 实现了数据处理和物理量到无因次量的转换逻辑。
+ * 4. 热路径计数 (HotPathProfiler)：Bessel 函数与积分节点在一次 Laplace 求值内累加，求值结束时计入一次。
+ * 5. 裂缝流量方程组的缓冲区取自每线程工作区 (InfluenceWorkspace、FlowWorkspace)，逐个 z 求值时不申请堆内存。
  */
 
 #include "modelsolver01-06.h"
-#include "pressurederivativecalculator.h" // 假设此文件为通用算法库，若未包含可将导数计算逻辑移入此处
+#include "besselkernel.h"
+#include "adaptivequadrature.h"
+#include "typecurvelibrary.h"
+#include "solverjob.h"
+#include "hotpathprofiler.h"
 
 #include <Eigen/Dense>
-#include <boost/math/special_functions/bessel.hpp>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <climits>
+#include <limits>
 #include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+// 按连续区间分块并行处理各时间点，结果由 f 按下标写回，输出顺序与串行完全一致
+template <typename Func>
+void forEachPoint(QThreadPool* pool, int numPoints, int minParallelPoints, const Func& f)
+{
+    if (numPoints >= minParallelPoints && pool->maxThreadCount() > 1) {
+        int chunkCount = qMin(numPoints, pool->maxThreadCount() * 4);
+        QVector<QPair<int, int>> chunks;
+        chunks.reserve(chunkCount);
+        for (int c = 0; c < chunkCount; ++c) {
+            chunks.append(qMakePair(numPoints * c / chunkCount, numPoints * (c + 1) / chunkCount));
+        }
+        QtConcurrent::blockingMap(pool, chunks, [&](const QPair<int, int>& range) {
+            for (int k = range.first; k < range.second; ++k) f(k);
+        });
+    } else {
+        for (int k = 0; k < numPoints; ++k) f(k);
+    }
+}
+
+// Bessel 函数的 double / Dual 重载，Dual 版本按以下导数关系传播：
+// K0' = -K1, K1' = -K0 - K1/x, I0e' = I1e - I0e, I1e' = I0e - I1e/x - I1e
+inline double besselK0(double x) { return BesselKernel::k0(x); }
+inline double besselK1(double x) { return BesselKernel::k1(x); }
+inline double besselI0e(double x) { return BesselKernel::i0e(std::abs(x)); }
+inline double besselI1e(double x) { return BesselKernel::i1e(std::abs(x)); }
+
+template <int N>
+Dual<N> besselK0(const Dual<N>& x)
+{
+    return Dual<N>::chain(x, BesselKernel::k0(x.v), -BesselKernel::k1(x.v));
+}
+
+template <int N>
+Dual<N> besselK1(const Dual<N>& x)
+{
+    double k1 = BesselKernel::k1(x.v);
+    return Dual<N>::chain(x, k1, -BesselKernel::k0(x.v) - k1 / x.v);
+}
+
+template <int N>
+Dual<N> besselI0e(const Dual<N>& x)
+{
+    double i0e = BesselKernel::i0e(std::abs(x.v));
+    return Dual<N>::chain(x, i0e, BesselKernel::i1e(std::abs(x.v)) - i0e);
+}
+
+template <int N>
+Dual<N> besselI1e(const Dual<N>& x)
+{
+    double i1e = BesselKernel::i1e(std::abs(x.v));
+    return Dual<N>::chain(x, i1e, BesselKernel::i0e(std::abs(x.v)) - i1e / x.v - i1e);
+}
+
+// 积分节点上的 K0 与 I0e 批量求值
+inline void besselK0I0eBatch(const double* x, double* k0, double* i0e, int n)
+{
+    BesselKernel::k0Batch(x, k0, n);
+    BesselKernel::i0eBatch(x, i0e, n);
+}
+
+// 复参数版本 (复平面反演)
+typedef std::complex<double> Complex;
+
+inline Complex besselK0(const Complex& x) { Complex k0, k1, i0e, i1e; BesselKernel::evaluateComplex(x, k0, k1, i0e, i1e); return k0; }
+inline Complex besselK1(const Complex& x) { Complex k0, k1, i0e, i1e; BesselKernel::evaluateComplex(x, k0, k1, i0e, i1e); return k1; }
+inline Complex besselI0e(const Complex& x) { Complex k0, k1, i0e, i1e; BesselKernel::evaluateComplex(x, k0, k1, i0e, i1e); return i0e; }
+inline Complex besselI1e(const Complex& x) { Complex k0, k1, i0e, i1e; BesselKernel::evaluateComplex(x, k0, k1, i0e, i1e); return i1e; }
+
+inline void besselK0I0eBatch(const Complex* x, Complex* k0, Complex* i0e, int n)
+{
+    Complex k1, i1e;
+    for (int k = 0; k < n; ++k) BesselKernel::evaluateComplex(x[k], k0[k], k1, i0e[k], i1e);
+}
+
+// 复数对偶数：导数关系与实数版本相同
+template <int N>
+void besselComplexDual(const Dual<N, Complex>& x, Dual<N, Complex>* k0, Dual<N, Complex>* k1, Dual<N, Complex>* i0e, Dual<N, Complex>* i1e)
+{
+    Complex vk0, vk1, vi0, vi1;
+    BesselKernel::evaluateComplex(x.v, vk0, vk1, vi0, vi1);
+    if (k0) *k0 = Dual<N, Complex>::chain(x, vk0, -vk1);
+    if (k1) *k1 = Dual<N, Complex>::chain(x, vk1, -vk0 - vk1 / x.v);
+    if (i0e) *i0e = Dual<N, Complex>::chain(x, vi0, vi1 - vi0);
+    if (i1e) *i1e = Dual<N, Complex>::chain(x, vi1, vi0 - vi1 / x.v - vi1);
+}
+
+template <int N> Dual<N, Complex> besselK0(const Dual<N, Complex>& x) { Dual<N, Complex> r; besselComplexDual<N>(x, &r, nullptr, nullptr, nullptr); return r; }
+template <int N> Dual<N, Complex> besselK1(const Dual<N, Complex>& x) { Dual<N, Complex> r; besselComplexDual<N>(x, nullptr, &r, nullptr, nullptr); return r; }
+template <int N> Dual<N, Complex> besselI0e(const Dual<N, Complex>& x) { Dual<N, Complex> r; besselComplexDual<N>(x, nullptr, nullptr, &r, nullptr); return r; }
+template <int N> Dual<N, Complex> besselI1e(const Dual<N, Complex>& x) { Dual<N, Complex> r; besselComplexDual<N>(x, nullptr, nullptr, nullptr, &r); return r; }
+
+template <int N>
+void besselK0I0eBatch(const Dual<N, Complex>* x, Dual<N, Complex>* k0, Dual<N, Complex>* i0e, int n)
+{
+    for (int k = 0; k < n; ++k) besselComplexDual<N>(x[k], &k0[k], nullptr, &i0e[k], nullptr);
+}
+
+// 泛型代码中的分支判断：复数取实部，大小比较取模 (double、Dual 与 std::abs(valueOf) 一致)
+inline double valueOf(const Complex& x) { return x.real(); }
+inline double magnitudeOf(double x) { return std::abs(x); }
+template <int N> inline double magnitudeOf(const Dual<N>& x) { return std::abs(x.v); }
+inline double magnitudeOf(const Complex& x) { return std::abs(x); }
+template <int N> inline double magnitudeOf(const Dual<N, Complex>& x) { return std::abs(x.v); }
+
+// 复平面反演的标量类型：Complex 只求值，Dual<W, Complex> 同时求偏导数
+// time() 给出反演公式中的时间 t (求导时沿 ln(tD) 方向，dt/dln tD = t)，realPart() 取实部得到原函数值
+template <typename C> struct InversionScalar;
+
+template <> struct InversionScalar<Complex> {
+    static Complex time(double t, int) { return t; }
+    static double realPart(const Complex& x) { return x.real(); }
+};
+
+template <int W> struct InversionScalar<Dual<W, Complex>> {
+    static Dual<W, Complex> time(double t, int lnTdDir) { return Dual<W, Complex>::variable(t, lnTdDir, t); }
+    static Dual<W> realPart(const Dual<W, Complex>& x)
+    {
+        Dual<W> r(x.v.real());
+        for (int j = 0; j < W; ++j) r.d[j] = x.d[j].real();
+        return r;
+    }
+};
+
+// 压敏效应修正 pd(γ) = -ln(1 - γ pd)/γ，导数按链式法则 deriv(γ) = deriv / (1 - γ pd)；
+// gamaD 为零附近时 dpd/dγ ≈ pd²/2，d deriv/dγ ≈ pd·deriv
+template <int W>
+void pressureSensitiveCorrection(Dual<W>& pd, Dual<W>& deriv, const Dual<W>& gamaD, int gamaDir)
+{
+    if (std::abs(gamaD.v) > 1e-9) {
+        Dual<W> argG = 1.0 - gamaD * pd;
+        if (argG.v > 1e-12) {
+            pd = -1.0 / gamaD * log(argG);
+            deriv = deriv / argG;
+        }
+    } else if (gamaDir >= 0) {
+        deriv.d[gamaDir] = pd.v * deriv.v;
+        pd.d[gamaDir] = 0.5 * pd.v * pd.v;
+    }
+}
+
+template <int N>
+void besselK0I0eBatch(const Dual<N>* x, Dual<N>* k0, Dual<N>* i0e, int n)
+{
+    double xv[AdaptiveQuadrature::KRONROD_POINTS];
+    double k0v[AdaptiveQuadrature::KRONROD_POINTS], k1v[AdaptiveQuadrature::KRONROD_POINTS];
+    double i0v[AdaptiveQuadrature::KRONROD_POINTS], i1v[AdaptiveQuadrature::KRONROD_POINTS];
+    for (int k = 0; k < n; ++k) xv[k] = x[k].v;
+    BesselKernel::k0Batch(xv, k0v, n);
+    BesselKernel::k1Batch(xv, k1v, n);
+    BesselKernel::i0eBatch(xv, i0v, n);
+    BesselKernel::i1eBatch(xv, i1v, n);
+    for (int k = 0; k < n; ++k) {
+        k0[k] = Dual<N>::chain(x[k], k0v[k], -k1v[k]);
+        i0e[k] = Dual<N>::chain(x[k], i0v[k], i1v[k] - i0v[k]);
+    }
+}
+
+// Stehfest 系数的 long double 表：阶乘与求和都在扩展精度下进行 (下标 1..N 有效)
+const QVector<long double>& extendedStehfestCoefficients(int N)
+{
+    static const QVector<QVector<long double>> table = []() {
+        QVector<long double> fact(2 * ModelSolver01_06::MAX_STEHFEST_N + 1, 1.0L);
+        for (int i = 2; i < fact.size(); ++i) fact[i] = fact[i - 1] * i;
+        QVector<QVector<long double>> t(ModelSolver01_06::MAX_STEHFEST_N + 1);
+        for (int n = 2; n <= ModelSolver01_06::MAX_STEHFEST_N; n += 2) {
+            QVector<long double> v(n + 1, 0.0L);
+            for (int i = 1; i <= n; ++i) {
+                long double s = 0.0L;
+                for (int k = (i + 1) / 2; k <= std::min(i, n / 2); ++k) {
+                    s += std::pow((long double)k, (long double)(n / 2)) * fact[2 * k]
+                         / (fact[n / 2 - k] * fact[k] * fact[k - 1] * fact[i - k] * fact[2 * k - i]);
+                }
+                v[i] = ((i + n / 2) % 2 == 0 ? 1.0L : -1.0L) * s;
+            }
+            t[n] = v;
+        }
+        return t;
+    }();
+    return table[N];
+}
+
+// Stehfest 精确求和：V_m F_m 的 Neumaier 补偿求和 (long double)，误差估计取 N 阶与 N-2 阶之差；
+// tolerance > 0 时从 4 阶逐次加 2，连续两次相邻两阶相对差低于 tolerance 时停止 (低阶偶然一致不算收敛)；
+// 12 阶以上相邻差开始成倍增大说明 Laplace 值的舍入误差已主导，同样停止；结果取相邻差最小的一阶
+double accurateStehfest(int maxN, double tolerance, double scale, const std::function<double(int)>& F, double& relativeError)
+{
+    long double f[ModelSolver01_06::MAX_STEHFEST_N + 1];
+    int evaluated = 0;
+    auto sumOrder = [&](int n) {
+        while (evaluated < n) {
+            ++evaluated;
+            f[evaluated] = F(evaluated);
+        }
+        const QVector<long double>& V = extendedStehfestCoefficients(n);
+        long double sum = 0.0L, compensation = 0.0L;
+        for (int m = 1; m <= n; ++m) {
+            long double term = V[m] * f[m];
+            long double t = sum + term;
+            if (std::fabs(sum) >= std::fabs(term)) compensation += (sum - t) + term;
+            else compensation += (term - t) + sum;
+            sum = t;
+        }
+        return (double)((sum + compensation) * scale);
+    };
+    auto relative = [](double diff, double value) {
+        return std::abs(diff) / qMax(std::abs(value), std::numeric_limits<double>::min());
+    };
+
+    relativeError = std::numeric_limits<double>::quiet_NaN();
+    if (tolerance <= 0.0 || maxN <= 4) {
+        double value = sumOrder(maxN);
+        if (maxN >= 4) relativeError = relative(value - sumOrder(maxN - 2), value);
+        return value;
+    }
+
+    double previous = sumOrder(4);
+    double best = previous, bestDiff = std::numeric_limits<double>::infinity();
+    int agreed = 0;
+    for (int n = 6; n <= maxN; n += 2) {
+        double value = sumOrder(n);
+        double diff = std::abs(value - previous);
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            best = value;
+        } else if (n > 12 && diff > 2.0 * bestDiff) {
+            break;
+        }
+        agreed = diff <= tolerance * std::abs(value) ? agreed + 1 : 0;
+        if (agreed >= 2) break;
+        previous = value;
+    }
+    relativeError = relative(bestDiff, best);
+    return best;
+}
+
+// 型曲线的键只含决定无因次解形状的参数：kf、km 只以比值进入 Laplace 解，压敏系数在插值后修正
+TypeCurveLibrary::Key typeCurveKey(int modelType, const ModelSolver01_06::ParamSet& params, int N,
+                                   ModelSolver01_06::InversionMethod method)
+{
+    using ParamSet = ModelSolver01_06::ParamSet;
+    TypeCurveLibrary::Key key;
+    key.modelType = modelType;
+    key.inversion = method;
+    key.order = N;
+    const int shapeSlots[] = { ParamSet::LFD, ParamSet::RMD, ParamSet::RED, ParamSet::OMEGA1, ParamSet::OMEGA2,
+                               ParamSet::LAMBDA1, ParamSet::NF, ParamSet::CD, ParamSet::S };
+    key.shape[0] = TypeCurveLibrary::canonical(params[ParamSet::KF] / params[ParamSet::KM]);
+    for (int i = 0; i < TypeCurveLibrary::SHAPE_COUNT - 1; ++i) key.shape[i + 1] = TypeCurveLibrary::canonical(params[shapeSlots[i]]);
+    return key;
+}
+
+// 每线程复用的工作区，按标量类型各一份：容量随出现过的最大 nf 增长后保留 (QVector 缩小时不释放容量)，
+// 逐个 z 求值时不再申请堆内存，多线程求值也不争用分配器。缓冲区只在单次调用内有效
+template <typename T>
+struct InfluenceWorkspace {
+    QVector<T> coefficients;   // 等间距布缝的影响系数 (Toeplitz 矩阵第一行，nf 个)
+    QVector<T> matrix;         // 一般情形的影响矩阵 (nf×nf，行优先)
+
+    static InfluenceWorkspace& local()
+    {
+        thread_local InfluenceWorkspace ws;
+        return ws;
+    }
+};
+
+// 流量方程组求解 (S 为 double 或 std::complex<double>，对偶数版本用其数值部分)
+template <typename S>
+struct FlowWorkspace {
+    typedef Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Matrix<S, Eigen::Dynamic, 1> Vector;
+
+    QVector<S> values, ones, y, rhs, dy;                     // Toeplitz 方程组：系数数值部分、右端与解
+    QVector<S> levinsonR, levinsonB, levinsonY, levinsonTmp; // Levinson 递推的中间量
+    Matrix matrix, rhsMatrix, dx;                            // 一般情形的 (nf+1)×(nf+1) 方程组
+    Vector b, x;
+    Eigen::FullPivLU<Matrix> lu;
+
+    static FlowWorkspace& local()
+    {
+        thread_local FlowWorkspace ws;
+        return ws;
+    }
+};
+
+} // namespace
+
 // 构造函数
 ModelSolver01_06::ModelSolver01_06(ModelType type)
     : m_type(type)
     , m_highPrecision(true)
+    , m_cacheEnabled(true)
 {
 }
 
@@ -38,6 +339,121 @@ void ModelSolver01_06::setHighPrecision(bool high)
     m_highPrecision = high;
 }
 
+// 求解器专用线程池，与拟合任务使用的全局线程池分开，避免互相占满
+QThreadPool* ModelSolver01_06::solverThreadPool()
+{
+    static QThreadPool* pool = []() {
+        QThreadPool* p = new QThreadPool();
+        p->setMaxThreadCount(QThread::idealThreadCount());
+        return p;
+    }();
+    return pool;
+}
+
+void ModelSolver01_06::setMaxThreadCount(int count)
+{
+    if (count <= 0) count = QThread::idealThreadCount();
+    solverThreadPool()->setMaxThreadCount(count);
+}
+
+int ModelSolver01_06::maxThreadCount()
+{
+    return solverThreadPool()->maxThreadCount();
+}
+
+void ModelSolver01_06::setLaplaceCacheEnabled(bool enabled)
+{
+    m_cacheEnabled = enabled;
+    if (!enabled) clearLaplaceCache();
+}
+
+void ModelSolver01_06::clearLaplaceCache()
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_laplaceCache.clear();
+    m_cacheOrder.clear();
+}
+
+// 参数名表，顺序与 ParamSet::Index 一致
+static const char* const kParamNames[ModelSolver01_06::ParamSet::COUNT] = {
+    "kf", "km", "LfD", "rmD", "reD", "omega1", "omega2", "lambda1", "nf", "cD", "S",
+    "phi", "h", "mu", "B", "Ct", "q", "L", "Lf", "gamaD", "N"
+};
+
+// 参数缺省值，与原按名称取值时的默认值保持一致
+static const double kParamDefaults[ModelSolver01_06::ParamSet::COUNT] = {
+    1e-3, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 4.0, 0.0, 0.0,
+    0.05, 20.0, 0.5, 1.05, 5e-4, 5.0, 1000.0, 0.0, 0.0, 4.0
+};
+
+int ModelSolver01_06::ParamSet::indexOf(const QString& name)
+{
+    for (int i = 0; i < COUNT; ++i) {
+        if (name == QLatin1String(kParamNames[i])) return i;
+    }
+    return -1;
+}
+
+ModelSolver01_06::ParamSet ModelSolver01_06::ParamSet::fromMap(const QMap<QString, double>& params)
+{
+    ParamSet p;
+    for (int i = 0; i < COUNT; ++i) {
+        p.v[i] = params.value(QLatin1String(kParamNames[i]), kParamDefaults[i]);
+    }
+    return p;
+}
+
+QMap<QString, double> ModelSolver01_06::ParamSet::toMap() const
+{
+    QMap<QString, double> map;
+    for (int i = 0; i < COUNT; ++i) map.insert(QLatin1String(kParamNames[i]), v[i]);
+    return map;
+}
+
+// Laplace 参数哈希 (FNV-1a，对前 LAPLACE_COUNT 项数值的二进制位计算)
+// 物理参数 (phi, mu, q 等) 只影响时间换算和量纲，不影响 z 处的 Laplace 值
+quint64 ModelSolver01_06::hashParameters(const ParamSet& params)
+{
+    quint64 h = 1469598103934665603ULL;
+    for (int i = 0; i < ParamSet::LAPLACE_COUNT; ++i) {
+        quint64 bits;
+        std::memcpy(&bits, &params.v[i], sizeof(bits));
+        h ^= bits;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool ModelSolver01_06::sameLaplaceParameters(const ParamSet& a, const ParamSet& b)
+{
+    return std::memcmp(a.v, b.v, sizeof(double) * ParamSet::LAPLACE_COUNT) == 0;
+}
+
+// 获取当前参数组对应的缓存块，不存在则新建 (超出上限时淘汰最早的参数组)
+QSharedPointer<ModelSolver01_06::LaplaceCacheBlock> ModelSolver01_06::acquireCacheBlock(const ParamSet& params)
+{
+    quint64 key = hashParameters(params);
+    QMutexLocker locker(&m_cacheMutex);
+
+    auto it = m_laplaceCache.find(key);
+    if (it != m_laplaceCache.end()) {
+        if (sameLaplaceParameters(it.value()->params, params)) return it.value();
+        // 哈希碰撞：用新参数组替换旧块
+        m_laplaceCache.erase(it);
+        m_cacheOrder.removeAll(key);
+    }
+
+    while (m_cacheOrder.size() >= MAX_CACHE_BLOCKS) {
+        m_laplaceCache.remove(m_cacheOrder.takeFirst());
+    }
+
+    QSharedPointer<LaplaceCacheBlock> block(new LaplaceCacheBlock);
+    block->params = params;
+    m_laplaceCache.insert(key, block);
+    m_cacheOrder.append(key);
+    return block;
+}
+
 // 获取模型名称
 QString ModelSolver01_06::getModelName(ModelType type)
 {
@@ -65,9 +481,76 @@ QVector<double> ModelSolver01_06::generateLogTimeSteps(int count, double startEx
     return t;
 }
 
-// 核心计算函数
+// 不带选项的计算接口：使用实例上设置的精度
 ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
+    CalcOptions options;
+    options.highPrecision = m_highPrecision;
+    return calculateTheoreticalCurve(params, providedTime, options);
+}
+
+int ModelSolver01_06::resolveStehfestN(const ParamSet& params, const CalcOptions& options)
+{
+    int N = options.stehfestN > 0 ? options.stehfestN : (int)params[ParamSet::N];
+    if (!options.highPrecision) N = 4;
+    if (N % 2 != 0 || N < 2 || N > MAX_STEHFEST_N) N = 4;
+    return N;
+}
+
+// 各模型类型的默认反演方法，下标为 ModelType
+static std::atomic<int> s_defaultInversion[ModelSolver01_06::Model_6 + 1] = {};
+
+void ModelSolver01_06::setDefaultInversion(ModelType type, InversionMethod method)
+{
+    if (type < Model_1 || type > Model_6) return;
+    if (method == DefaultInversion) method = StehfestInversion;
+    s_defaultInversion[type].store(method);
+}
+
+ModelSolver01_06::InversionMethod ModelSolver01_06::defaultInversion(ModelType type)
+{
+    if (type < Model_1 || type > Model_6) return StehfestInversion;
+    return static_cast<InversionMethod>(s_defaultInversion[type].load());
+}
+
+ModelSolver01_06::InversionMethod ModelSolver01_06::resolveInversion(const CalcOptions& options) const
+{
+    return options.inversion == DefaultInversion ? defaultInversion(m_type) : options.inversion;
+}
+
+const char* ModelSolver01_06::inversionName(InversionMethod method)
+{
+    switch (method) {
+    case StehfestInversion: return "Stehfest";
+    case TalbotInversion: return "Talbot";
+    case DeHoogInversion: return "de Hoog";
+    case EulerInversion: return "Euler";
+    default: return "Default";
+    }
+}
+
+// 以线源解 (K0(√s)/s) 对比解析解标定：N=4/8/12 时各方法误差不劣于同阶 Stehfest，
+// Euler 的舍入误差随 10^(M/3) 放大，M 超过 20 后不再提高精度
+int ModelSolver01_06::inversionOrder(InversionMethod method, int stehfestN)
+{
+    switch (method) {
+    case TalbotInversion: return qBound(8, stehfestN + 4, 32);
+    case DeHoogInversion: return qBound(8, stehfestN / 2 + 6, 20);
+    case EulerInversion: return qBound(8, stehfestN + 4, 20);
+    default: return stehfestN;
+    }
+}
+
+// QMap 参数接口：在边界处一次性解析参数名
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, const CalcOptions& options)
+{
+    return calculateTheoreticalCurve(ParamSet::fromMap(params), providedTime, options);
+}
+
+// 核心计算函数
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const ParamSet& params, const QVector<double>& providedTime, const CalcOptions& options)
+{
+    WT_PROFILE_SCOPE(CurveScope);
     // 1. 准备时间序列
     QVector<double> tPoints = providedTime;
     if (tPoints.isEmpty()) {
@@ -75,14 +558,14 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     }
 
     // 2. 提取物理参数
-    double phi = params.value("phi", 0.05);
-    double mu = params.value("mu", 0.5);
-    double B = params.value("B", 1.05);
-    double Ct = params.value("Ct", 5e-4);
-    double q = params.value("q", 5.0);
-    double h = params.value("h", 20.0);
-    double kf = params.value("kf", 1e-3);
-    double L = params.value("L", 1000.0);
+    double phi = params[ParamSet::PHI];
+    double mu = params[ParamSet::MU];
+    double B = params[ParamSet::B];
+    double Ct = params[ParamSet::CT];
+    double q = params[ParamSet::Q];
+    double h = params[ParamSet::H];
+    double kf = params[ParamSet::KF];
+    double L = params[ParamSet::L];
 
     // 3. 计算无因次时间 tD
     QVector<double> tD_vec;
@@ -100,8 +583,24 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
 
     // 4. 计算无因次压力和导数
     QVector<double> PD_vec, Deriv_vec;
-    auto func = std::bind(&ModelSolver01_06::flaplace_composite, this, std::placeholders::_1, std::placeholders::_2);
-    calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec);
+    int nf = (int)params[ParamSet::NF];
+    if (nf < 1) nf = 1;
+    const QVector<double> xwD = fracturePositions(nf);
+    const LaplaceKernel<double> kernel = laplaceKernel<double>(m_type);
+    const LaplaceKernel<std::complex<double>> complexKernel = laplaceKernel<std::complex<double>>(m_type);
+    auto func = [kernel, &xwD](double z, const ParamSet& p) { return kernel(z, laplaceArgs<double>(p), xwD); };
+    auto complexFunc = [complexKernel, &xwD](const std::complex<double>& z, const ParamSet& p) {
+        return complexKernel(z, laplaceArgs<std::complex<double>>(p), xwD);
+    };
+    if (options.typeCurveLookup) {
+        lookupTypeCurve(tD_vec, params, resolveStehfestN(params, options), resolveInversion(options), func, complexFunc, PD_vec, Deriv_vec,
+                        options.control);
+    } else {
+        calculatePDandDeriv(tD_vec, params, resolveStehfestN(params, options), resolveInversion(options), func, complexFunc, PD_vec, Deriv_vec,
+                            options);
+    }
+    // 已停止的计算结果不完整，直接丢弃
+    if (options.control && options.control->shouldStop()) return ModelCurveData();
 
     // 5. 将无因次量转换为物理量 (压差 dp)
     // dp = 1.842e-3 * q * mu * B / (k * h) * pD
@@ -117,69 +616,699 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     return std::make_tuple(tPoints, finalP, finalDP);
 }
 
-// Stehfest 数值反演计算 PD 和导数
-void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                                           std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                                           QVector<double>& outPD, QVector<double>& outDeriv)
+// 数值反演计算 PD 和导数
+void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const ParamSet& params, int N, InversionMethod method,
+                                           std::function<double(double, const ParamSet&)> laplaceFunc,
+                                           std::function<std::complex<double>(const std::complex<double>&, const ParamSet&)> complexLaplaceFunc,
+                                           QVector<double>& outPD, QVector<double>& outDeriv, const CalcOptions& options)
 {
     int numPoints = tD.size();
     outPD.resize(numPoints);
     outDeriv.resize(numPoints);
+    SolverControl* control = options.control;
 
-    int N_param = (int)params.value("N", 4);
-    int N = m_highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4;
     double ln2 = log(2.0);
 
-    double gamaD = params.value("gamaD", 0.0);
+    // 系数只与 N 有关，循环外取一次共享表即可
+    const QVector<double>& V = getStehfestCoefficients(N);
 
-    for (int k = 0; k < numPoints; ++k) {
-        double t = tD[k];
-        if (t <= 1e-12) { outPD[k] = 0; continue; }
+    double gamaD = params[ParamSet::GAMAD];
 
-        double pd_val = 0.0;
-        for (int m = 1; m <= N; ++m) {
-            double z = m * ln2 / t;
-            double pf = laplaceFunc(z, params);
-            if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
+    // 同一参数组的 Laplace 值可在多次调用之间复用 (拟合接受步 -> 刷新曲线 -> 最终曲线)
+    QSharedPointer<LaplaceCacheBlock> cache;
+    if (m_cacheEnabled) cache = acquireCacheBlock(params);
+
+    // 停止后剩余节点不再求值 (返回 0 且不写入缓存)，整条曲线由调用方丢弃
+    auto cancelled = [control]() { return control && control->shouldStop(); };
+    if (control) control->addWork(numPoints);
+
+    auto evalLaplace = [&](double z) -> double {
+        if (cancelled()) return 0.0;
+        quint64 zKey = 0;
+        if (cache) {
+            std::memcpy(&zKey, &z, sizeof(zKey));
+            QMutexLocker locker(&cache->mutex);
+            auto it = cache->values.constFind(zKey);
+            if (it != cache->values.constEnd()) {
+                WT_PROFILE_COUNT(LaplaceCacheHits, 1);
+                return it.value();
+            }
+            WT_PROFILE_COUNT(LaplaceCacheMisses, 1);
+        }
+        double pf = laplaceFunc(z, params);
+        if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
+        if (cache) {
+            QMutexLocker locker(&cache->mutex);
+            if (cache->values.size() < MAX_CACHE_ENTRIES) cache->values.insert(zKey, pf);
+        }
+        return pf;
+    };
+
+    // 复平面节点：同一参数组下 Talbot、de Hoog 的节点只取决于时间分段，跨调用可复用
+    auto evalComplex = [&](const std::complex<double>& s) -> std::complex<double> {
+        if (cancelled()) return 0.0;
+        QPair<quint64, quint64> sKey(0, 0);
+        if (cache) {
+            double re = s.real(), im = s.imag();
+            std::memcpy(&sKey.first, &re, sizeof(quint64));
+            std::memcpy(&sKey.second, &im, sizeof(quint64));
+            QMutexLocker locker(&cache->mutex);
+            auto it = cache->complexValues.constFind(sKey);
+            if (it != cache->complexValues.constEnd()) {
+                WT_PROFILE_COUNT(LaplaceCacheHits, 1);
+                return it.value();
+            }
+            WT_PROFILE_COUNT(LaplaceCacheMisses, 1);
+        }
+        std::complex<double> pf = complexLaplaceFunc(s, params);
+        if (!std::isfinite(pf.real()) || !std::isfinite(pf.imag())) pf = 0.0;
+        if (cache) {
+            QMutexLocker locker(&cache->mutex);
+            if (cache->complexValues.size() < MAX_CACHE_ENTRIES) cache->complexValues.insert(sKey, pf);
         }
-        outPD[k] = pd_val * ln2 / t;
+        return pf;
+    };
+
+    // 各时间点互相独立，只写入自己的下标；导数 tD·dpD/dtD = tD·L⁻¹{s·p̄D} 与 pD 共用同一组 Laplace 值
+    double* pdData = outPD.data();
+    double* derivData = outDeriv.data();
+    const std::function<std::complex<double>(const std::complex<double>&)> complexLaplace = evalComplex;
+    QVector<std::complex<double>> inverted, invertedDeriv;
+    if (method != StehfestInversion) {
+        inverted.resize(numPoints);
+        invertedDeriv.resize(numPoints);
+    }
+    switch (method) {
+    case TalbotInversion:
+        invertTalbot(tD, inversionOrder(method, N), complexLaplace, -1, inverted.data(), invertedDeriv.data());
+        break;
+    case DeHoogInversion:
+        invertDeHoog(tD, inversionOrder(method, N), complexLaplace, -1, inverted.data(), invertedDeriv.data());
+        break;
+    case EulerInversion:
+        invertEuler(tD, inversionOrder(method, N), complexLaplace, -1, inverted.data(), invertedDeriv.data());
+        break;
+    default: {
+        const bool accurate = options.compensatedStehfest || options.stehfestTolerance > 0.0 || options.inversionError;
+        double* errorData = nullptr;
+        if (options.inversionError) {
+            *options.inversionError = QVector<double>(numPoints, std::numeric_limits<double>::quiet_NaN());
+            errorData = options.inversionError->data();
+        }
+        auto invertPoint = [&](int k) {
+            double t = tD[k];
+            if (t <= 1e-12 || cancelled()) {
+                pdData[k] = 0;
+                derivData[k] = 0;
+                if (control) control->advance();
+                return;
+            }
+
+            if (accurate) {
+                // 各阶共用节点 z = m ln2 / t，提高阶数只需补求新增的节点；导数按同样的选阶规则反演 z·p̄(z)，节点值逐点保留
+                double values[MAX_STEHFEST_N + 1];
+                int evaluated = 0;
+                auto value = [&](int m) {
+                    while (evaluated < m) {
+                        ++evaluated;
+                        values[evaluated] = evalLaplace(evaluated * ln2 / t);
+                    }
+                    return values[m];
+                };
+                double relativeError, derivError;
+                pdData[k] = accurateStehfest(N, options.stehfestTolerance, ln2 / t, value, relativeError);
+                derivData[k] = accurateStehfest(N, options.stehfestTolerance, ln2,
+                                                [&](int m) { return m * ln2 / t * value(m); }, derivError);
+                if (errorData) errorData[k] = relativeError;
+                if (control) control->advance();
+                return;
+            }
 
-        // 考虑压敏效应修正
-        if (std::abs(gamaD) > 1e-9) {
-            double arg = 1.0 - gamaD * outPD[k];
+            // pD = ln2/t Σ V_m p̄(z_m)，tD·dpD/dtD = t·ln2/t Σ V_m z_m p̄(z_m) = (ln2)²/t Σ V_m m p̄(z_m)
+            double pd_val = 0.0, deriv_val = 0.0;
+            for (int m = 1; m <= N; ++m) {
+                double z = m * ln2 / t;
+                double pf = evalLaplace(z);
+                pd_val += V[m] * pf;
+                deriv_val += V[m] * m * pf;
+            }
+            pdData[k] = pd_val * ln2 / t;
+            derivData[k] = deriv_val * ln2 * ln2 / t;
+            if (control) control->advance();
+        };
+        forEachPoint(solverThreadPool(), numPoints, PARALLEL_MIN_POINTS, invertPoint);
+        break;
+    }
+    }
+    for (int k = 0; k < inverted.size(); ++k) {
+        double v = inverted[k].real();
+        double d = invertedDeriv[k].real();
+        pdData[k] = std::isfinite(v) ? v : 0.0;
+        derivData[k] = std::isfinite(d) ? d : 0.0;
+    }
+    // 复平面方法的节点按时间分段共享，整段反演完成后一并计入进度
+    if (control && method != StehfestInversion) control->advance(numPoints);
+
+    finishDimensionlessCurve(gamaD, outPD, outDeriv);
+}
+
+void ModelSolver01_06::finishDimensionlessCurve(double gamaD, QVector<double>& pd, QVector<double>& deriv)
+{
+    int numPoints = pd.size();
+    // 考虑压敏效应修正：pd(γ) = -ln(1 - γ pd)/γ，对 ln tD 求导得 deriv / (1 - γ pd)
+    if (std::abs(gamaD) > 1e-9) {
+        for (int k = 0; k < numPoints; ++k) {
+            double arg = 1.0 - gamaD * pd[k];
             if (arg > 1e-12) {
-                outPD[k] = -1.0 / gamaD * std::log(arg);
+                pd[k] = -1.0 / gamaD * std::log(arg);
+                deriv[k] /= arg;
             }
         }
     }
+    for (int k = 0; k < numPoints; ++k) deriv[k] = std::abs(deriv[k]);
+}
+
+quint64 ModelSolver01_06::typeCurveHash(const ParamSet& params, const CalcOptions& options) const
+{
+    return typeCurveKey(m_type, params, resolveStehfestN(params, options), resolveInversion(options)).hash();
+}
 
-    // 计算导数 (Bourdet 导数)
-    if (numPoints > 2) {
-        // 依赖外部库 PressureDerivativeCalculator
-        outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
+void ModelSolver01_06::lookupTypeCurve(const QVector<double>& tD, const ParamSet& params, int N, InversionMethod method,
+                                       std::function<double(double, const ParamSet&)> laplaceFunc,
+                                       std::function<std::complex<double>(const std::complex<double>&, const ParamSet&)> complexLaplaceFunc,
+                                       QVector<double>& outPD, QVector<double>& outDeriv, SolverControl* control)
+{
+    const TypeCurveLibrary::Key key = typeCurveKey(m_type, params, N, method);
+
+    // 插值需要区间两侧各再多一个网格点
+    int first = INT_MAX, last = INT_MIN;
+    for (double t : tD) {
+        if (!(t > 1e-12)) continue;
+        int k = TypeCurveLibrary::latticeIndex(t);
+        first = qMin(first, k - 1);
+        last = qMax(last, k + 2);
+    }
+    outPD = QVector<double>(tD.size(), 0.0);
+    if (first > last) {
+        outDeriv = QVector<double>(tD.size(), 0.0);
+        return;
+    }
+
+    TypeCurveLibrary& library = TypeCurveLibrary::shared();
+    QVector<double> lattice;
+    QVector<int> missing;
+    library.fetch(key, first, last, lattice, missing);
+    WT_PROFILE_COUNT(TypeCurveHits, (last - first + 1) - missing.size());
+    WT_PROFILE_COUNT(TypeCurveMisses, missing.size());
+    if (!missing.isEmpty()) {
+        QVector<double> missingTime(missing.size());
+        for (int i = 0; i < missing.size(); ++i) missingTime[i] = TypeCurveLibrary::latticeTime(missing[i]);
+        ParamSet shapeParams = params;
+        shapeParams[ParamSet::GAMAD] = 0.0;
+        QVector<double> missingPD, unusedDeriv;
+        // 型曲线库中的网格值与调用方的精度选项无关，只传入停止控制
+        CalcOptions latticeOptions;
+        latticeOptions.control = control;
+        calculatePDandDeriv(missingTime, shapeParams, N, method, laplaceFunc, complexLaplaceFunc, missingPD, unusedDeriv, latticeOptions);
+        // 停止时网格值不完整，不能进入型曲线库
+        if (control && control->shouldStop()) {
+            outDeriv = QVector<double>(tD.size(), 0.0);
+            return;
+        }
+        library.store(key, missing, missingPD);
+        for (int i = 0; i < missing.size(); ++i) lattice[missing[i] - first] = missingPD[i];
+    }
+
+    // 导数取 Hermite 插值函数的解析导数，与插值得到的 pD 一致
+    QVector<double> logDerivative;
+    QVector<double> pd = TypeCurveLibrary::interpolate(first, lattice, tD, &logDerivative);
+    outDeriv = QVector<double>(tD.size(), 0.0);
+    for (int k = 0; k < tD.size(); ++k) {
+        if (tD[k] > 1e-12) {
+            outPD[k] = pd[k];
+            outDeriv[k] = logDerivative[k];
+        }
+    }
+    finishDimensionlessCurve(params[ParamSet::GAMAD], outPD, outDeriv);
+}
+
+// 按固定对数网格分段：段号 b 覆盖 [ρ^b, ρ^(b+1))，ρ = INVERSION_BAND_RATIO；网格与时间序列无关，相同分段的节点跨调用一致
+QMap<int, QVector<int>> ModelSolver01_06::inversionBands(const QVector<double>& tD)
+{
+    QMap<int, QVector<int>> bands;
+    const double logRatio = std::log(INVERSION_BAND_RATIO);
+    for (int k = 0; k < tD.size(); ++k) {
+        if (!(tD[k] > 1e-12)) continue;
+        bands[(int)std::floor(std::log(tD[k]) / logRatio)].append(k);
+    }
+    return bands;
+}
+
+// 固定 Talbot 反演 (Abate-Valkó)：f(t) ≈ r/M Re[½F(r)e^{rt} + Σ_{k=1}^{M-1} e^{t s_k} F(s_k) (1 + iσ_k)]
+// s_k = rθ_k(cotθ_k + i)，σ_k = θ_k + (θ_k cotθ_k - 1)cotθ_k，θ_k = kπ/M；
+// 段内各点共用以分段几何中点 t_ref 确定的围道 r = 2M/(5 t_ref)，每段只求 M 个 Laplace 值，各点只做一次长度 M 的加权求和
+template <typename C>
+void ModelSolver01_06::invertTalbot(const QVector<double>& tD, int M, const std::function<C(const C&)>& F, int lnTdDir, C* out,
+                                    C* outDeriv)
+{
+    typedef std::complex<double> Z;
+    using std::exp;
+    for (int k = 0; k < tD.size(); ++k) out[k] = C(0.0);
+    if (outDeriv) {
+        for (int k = 0; k < tD.size(); ++k) outDeriv[k] = C(0.0);
+    }
+    const QMap<int, QVector<int>> bands = inversionBands(tD);
+    if (bands.isEmpty()) return;
+
+    QVector<double> cotTheta(M), sigma(M);
+    for (int j = 1; j < M; ++j) {
+        double theta = j * M_PI / M;
+        cotTheta[j] = 1.0 / std::tan(theta);
+        sigma[j] = theta + (theta * cotTheta[j] - 1.0) * cotTheta[j];
+    }
+
+    // 全部分段的节点一起并行求值
+    QVector<double> radius;
+    QVector<Z> nodes;
+    for (auto it = bands.constBegin(); it != bands.constEnd(); ++it) {
+        double r = 2.0 * M / (5.0 * std::pow(INVERSION_BAND_RATIO, it.key() + 0.5));
+        radius.append(r);
+        nodes.append(Z(r, 0.0));
+        for (int j = 1; j < M; ++j) {
+            double theta = j * M_PI / M;
+            nodes.append(r * theta * Z(cotTheta[j], 1.0));
+        }
+    }
+    QVector<C> values(nodes.size());
+    C* valueData = values.data();
+    forEachPoint(solverThreadPool(), nodes.size(), PARALLEL_MIN_POINTS, [&](int i) { valueData[i] = F(C(nodes[i])); });
+
+    int band = 0;
+    for (auto it = bands.constBegin(); it != bands.constEnd(); ++it, ++band) {
+        double r = radius[band];
+        const Z* s = nodes.constData() + band * M;
+        const C* fs = values.constData() + band * M;
+        for (int k : it.value()) {
+            C t = InversionScalar<C>::time(tD[k], lnTdDir);
+            C w = 0.5 * exp(r * t);
+            C sum = w * fs[0];
+            C derivSum = w * Z(r) * fs[0];
+            for (int j = 1; j < M; ++j) {
+                w = exp(t * s[j]) * Z(1.0, sigma[j]);
+                sum += w * fs[j];
+                if (outDeriv) derivSum += w * s[j] * fs[j];
+            }
+            out[k] = sum * Z(r / M);
+            if (outDeriv) outDeriv[k] = t * derivSum * Z(r / M);
+        }
+    }
+}
+
+// de Hoog-Knight-Stokes 反演：Bromwich 积分的 Fourier 级数 (周期 2T，s_k = γ + ikπ/T，k = 0..2M)
+// 用商差 (QD) 算法化为连分式，再以余项估计加速收敛；QD 表只取决于节点值，段内各点共用，
+// 每点只需一次 2M 阶连分式递推。T 取段内最大时间的 2 倍，γ = -ln(tol)/(2T)
+template <typename C>
+void ModelSolver01_06::invertDeHoog(const QVector<double>& tD, int M, const std::function<C(const C&)>& F, int lnTdDir, C* out,
+                                    C* outDeriv)
+{
+    typedef std::complex<double> Z;
+    using std::exp;
+    using std::sqrt;
+    for (int k = 0; k < tD.size(); ++k) out[k] = C(0.0);
+    if (outDeriv) {
+        for (int k = 0; k < tD.size(); ++k) outDeriv[k] = C(0.0);
+    }
+    const QMap<int, QVector<int>> bands = inversionBands(tD);
+    if (bands.isEmpty()) return;
+
+    const int terms = 2 * M + 1;
+    QVector<double> period, gamma;
+    QVector<Z> nodes;
+    for (auto it = bands.constBegin(); it != bands.constEnd(); ++it) {
+        double T = 2.0 * std::pow(INVERSION_BAND_RATIO, it.key() + 1);
+        double g = -std::log(DEHOOG_TOLERANCE) / (2.0 * T);
+        period.append(T);
+        gamma.append(g);
+        for (int j = 0; j < terms; ++j) nodes.append(Z(g, j * M_PI / T));
+    }
+    QVector<C> values(nodes.size());
+    C* valueData = values.data();
+    forEachPoint(solverThreadPool(), nodes.size(), PARALLEL_MIN_POINTS, [&](int i) { valueData[i] = F(C(nodes[i])); });
+
+    QVector<C> e(terms), q(terms), ePrev(terms), d(terms), dDeriv(terms), A(terms), B(terms), sa(terms);
+
+    // QD 表按列递推：q^(1)_i = a_{i+1}/a_i，e^(r)_i = q^(r)_{i+1} - q^(r)_i + e^(r-1)_{i+1}，
+    // q^(r+1)_i = q^(r)_{i+1} e^(r)_{i+1} / e^(r)_i；连分式系数 d_0 = a_0/2，d_{2r-1} = -q^(r)_0，d_{2r} = -e^(r)_0
+    auto qdTable = [&](const C* a, QVector<C>& dOut) {
+        dOut[0] = 0.5 * a[0];
+        ePrev.fill(C(0.0));
+        for (int i = 0; i < terms - 1; ++i) q[i] = a[i + 1] / (i == 0 ? dOut[0] : a[i]);
+        for (int r = 1; r <= M; ++r) {
+            int rows = terms - 2 * r;
+            for (int i = 0; i < rows; ++i) e[i] = q[i + 1] - q[i] + ePrev[i + 1];
+            dOut[2 * r - 1] = -q[0];
+            dOut[2 * r] = -e[0];
+            if (r < M) {
+                for (int i = 0; i < rows - 1; ++i) q[i] = q[i + 1] * e[i + 1] / e[i];
+            }
+            for (int i = 0; i < rows; ++i) ePrev[i] = e[i];
+        }
+    };
+    // 2M 阶连分式递推与余项估计
+    auto continuedFraction = [&](const QVector<C>& dc, const C& z) {
+        A[0] = C(0.0); A[1] = dc[0];
+        B[0] = C(1.0); B[1] = C(1.0);
+        for (int n = 2; n < terms; ++n) {
+            A[n] = A[n - 1] + dc[n - 1] * z * A[n - 2];
+            B[n] = B[n - 1] + dc[n - 1] * z * B[n - 2];
+        }
+        C h = 0.5 * (1.0 + (dc[terms - 2] - dc[terms - 1]) * z);
+        C rem = -h * (1.0 - sqrt(1.0 + dc[terms - 1] * z / (h * h)));
+        C num = A[terms - 1] + rem * A[terms - 2];
+        C den = B[terms - 1] + rem * B[terms - 2];
+        return C(num / den);
+    };
+
+    int band = 0;
+    for (auto it = bands.constBegin(); it != bands.constEnd(); ++it, ++band) {
+        const C* a = values.constData() + band * terms;
+        double T = period[band];
+        qdTable(a, d);
+        // 导数：同一组节点上 s_k F(s_k) 的级数
+        if (outDeriv) {
+            const Z* s = nodes.constData() + band * terms;
+            for (int j = 0; j < terms; ++j) sa[j] = s[j] * a[j];
+            qdTable(sa.constData(), dDeriv);
+        }
+
+        for (int k : it.value()) {
+            C t = InversionScalar<C>::time(tD[k], lnTdDir);
+            C z = exp(Z(0.0, M_PI / T) * t);
+            C scale = exp(gamma[band] * t) / Z(T);
+            out[k] = scale * continuedFraction(d, z);
+            if (outDeriv) outDeriv[k] = t * scale * continuedFraction(dDeriv, z);
+        }
+    }
+}
+
+// Abate-Whitt Euler 反演：f(t) ≈ 10^(M/3)/t Re Σ_{k=0}^{2M} η_k F(β_k/t)，β_k = M ln10/3 + ikπ，
+// η_k = (-1)^k ξ_k，ξ_0 = 1/2，ξ_1..ξ_M = 1，ξ_2M = 2^-M，ξ_{2M-k} = ξ_{2M-k+1} + 2^-M C(M,k) (0<k<M)
+// 节点随 t 缩放，各点单独求值
+template <typename C>
+void ModelSolver01_06::invertEuler(const QVector<double>& tD, int M, const std::function<C(const C&)>& F, int lnTdDir, C* out,
+                                   C* outDeriv)
+{
+    typedef std::complex<double> Z;
+    const int terms = 2 * M + 1;
+    QVector<double> eta(terms);
+    QVector<double> xi(terms, 1.0);
+    xi[0] = 0.5;
+    double scale = std::pow(2.0, -M);
+    xi[2 * M] = scale;
+    double binom = 1.0;
+    for (int k = 1; k < M; ++k) {
+        binom *= double(M - k + 1) / k;
+        xi[2 * M - k] = xi[2 * M - k + 1] + scale * binom;
+    }
+    for (int k = 0; k < terms; ++k) eta[k] = (k % 2 == 0 ? 1.0 : -1.0) * xi[k];
+
+    const double beta0 = M * std::log(10.0) / 3.0;
+    const double prefactor = std::pow(10.0, M / 3.0);
+    auto invertPoint = [&](int k) {
+        if (tD[k] <= 1e-12) {
+            out[k] = C(0.0);
+            if (outDeriv) outDeriv[k] = C(0.0);
+            return;
+        }
+        C t = InversionScalar<C>::time(tD[k], lnTdDir);
+        C sum(0.0), derivSum(0.0);
+        for (int j = 0; j < terms; ++j) {
+            C s = Z(beta0, j * M_PI) / t;
+            C fs = Z(eta[j]) * F(s);
+            sum += fs;
+            if (outDeriv) derivSum += s * fs;
+        }
+        out[k] = Z(prefactor) / t * sum;
+        // t·L⁻¹{s F(s)} 中的 t 与 10^(M/3)/t 相消
+        if (outDeriv) outDeriv[k] = Z(prefactor) * derivSum;
+    };
+    forEachPoint(solverThreadPool(), tD.size(), PARALLEL_MIN_POINTS, invertPoint);
+}
+
+// 灵敏度计算：曲线值与 calculateTheoreticalCurve 相同，偏导数由对偶数正演一次给出
+// 物理参数只通过两个比例系数进入曲线：tD = c_t * t (c_t ∝ kf/(phi*mu*Ct*L^2))，dp = c_p * pD (c_p ∝ q*mu*B/(kf*h))，
+// 前者作为一个 ln(tD) 求导方向随 Laplace 参数一起传播，后者直接解析求导
+ModelCurveData ModelSolver01_06::calculateCurveSensitivity(const ParamSet& params, const QVector<double>& providedTime,
+                                                           const CalcOptions& options, const QVector<int>& wrt, CurveSensitivity& out)
+{
+    WT_PROFILE_SCOPE(SensitivityScope);
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+    int numPoints = tPoints.size();
+
+    double phi = params[ParamSet::PHI];
+    double mu = params[ParamSet::MU];
+    double B = params[ParamSet::B];
+    double Ct = params[ParamSet::CT];
+    double q = params[ParamSet::Q];
+    double h = params[ParamSet::H];
+    double kf = params[ParamSet::KF];
+    double L = params[ParamSet::L];
+
+    double td_coeff = 14.4 * kf / (phi * mu * Ct * pow(L, 2));
+    QVector<double> tD_vec(numPoints);
+    for (int i = 0; i < numPoints; ++i) tD_vec[i] = td_coeff * tPoints[i];
+
+    // 分配求导方向：ln(tD) (仅当求导参数影响时间换算时)、各 Laplace 参数、gamaD
+    QVector<int> dirOf(ParamSet::COUNT, -1);
+    int dirs = 0;
+    int lnTdDir = -1;
+    for (int slot : wrt) {
+        if (slot == ParamSet::KF || slot == ParamSet::PHI || slot == ParamSet::MU || slot == ParamSet::CT || slot == ParamSet::L) {
+            lnTdDir = dirs++;
+            break;
+        }
+    }
+    for (int slot : wrt) {
+        if (slot >= 0 && slot < ParamSet::LAPLACE_COUNT && isDifferentiable(slot) && dirOf[slot] < 0) dirOf[slot] = dirs++;
+    }
+    if (wrt.contains(ParamSet::GAMAD)) dirOf[ParamSet::GAMAD] = dirs++;
+
+    // 带灵敏度的反演，按方向数选择对偶数宽度
+    // 导数 tD·dpD/dtD 由同一次反演给出 (带符号)，其偏导数与 pD 的偏导数一同传播
+    QVector<double> PD_vec, rawDeriv;
+    QVector<QVector<double>> dPD, dRawDeriv;
+    int N = resolveStehfestN(params, options);
+    InversionMethod method = resolveInversion(options);
+    if (dirs <= 4) {
+        invertWithSensitivity<4>(tD_vec, params, N, method, dirOf, lnTdDir, dirs, PD_vec, dPD, rawDeriv, dRawDeriv, options.control);
+    } else if (dirs <= 8) {
+        invertWithSensitivity<8>(tD_vec, params, N, method, dirOf, lnTdDir, dirs, PD_vec, dPD, rawDeriv, dRawDeriv, options.control);
     } else {
-        outDeriv.fill(0.0);
+        invertWithSensitivity<MAX_SENSITIVITY_DIRECTIONS>(tD_vec, params, N, method, dirOf, lnTdDir, dirs, PD_vec, dPD, rawDeriv, dRawDeriv,
+                                                          options.control);
+    }
+    // 已停止：返回空曲线，偏导数只保留与 wrt 对应的空列
+    if (options.control && options.control->shouldStop()) {
+        out.wrt = wrt;
+        out.dP = QVector<QVector<double>>(wrt.size());
+        out.dDeriv = QVector<QVector<double>>(wrt.size());
+        return ModelCurveData();
+    }
+
+    // 带符号的导数对参数求导后再乘以符号，即得绝对值导数的偏导数
+    double p_coeff = 1.842e-3 * q * mu * B / (kf * h);
+
+    QVector<double> finalP(numPoints), finalDP(numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        finalP[i] = p_coeff * PD_vec[i];
+        finalDP[i] = p_coeff * std::abs(rawDeriv[i]);
+    }
+
+    out.wrt = wrt;
+    out.dP = QVector<QVector<double>>(wrt.size(), QVector<double>(numPoints, 0.0));
+    out.dDeriv = QVector<QVector<double>>(wrt.size(), QVector<double>(numPoints, 0.0));
+
+    for (int w = 0; w < wrt.size(); ++w) {
+        int slot = wrt[w];
+
+        // d ln(c_t)/dθ 与 d ln(c_p)/dθ
+        double dlnTd = 0.0, dlnPc = 0.0;
+        switch (slot) {
+        case ParamSet::KF: dlnTd = 1.0 / kf; dlnPc = -1.0 / kf; break;
+        case ParamSet::PHI: dlnTd = -1.0 / phi; break;
+        case ParamSet::MU: dlnTd = -1.0 / mu; dlnPc = 1.0 / mu; break;
+        case ParamSet::CT: dlnTd = -1.0 / Ct; break;
+        case ParamSet::L: dlnTd = -2.0 / L; break;
+        case ParamSet::Q: dlnPc = 1.0 / q; break;
+        case ParamSet::B: dlnPc = 1.0 / B; break;
+        case ParamSet::H: dlnPc = -1.0 / h; break;
+        default: break;
+        }
+
+        int dir = (slot >= 0 && slot < ParamSet::COUNT) ? dirOf[slot] : -1;
+        const bool viaTd = lnTdDir >= 0 && dlnTd != 0.0;
+        double* dp = out.dP[w].data();
+        double* dd = out.dDeriv[w].data();
+        for (int i = 0; i < numPoints; ++i) {
+            double dPDi = 0.0, dRaw = 0.0;
+            if (dir >= 0) {
+                dPDi += dPD[dir][i];
+                dRaw += dRawDeriv[dir][i];
+            }
+            if (viaTd) {
+                dPDi += dlnTd * dPD[lnTdDir][i];
+                dRaw += dlnTd * dRawDeriv[lnTdDir][i];
+            }
+            double sign = rawDeriv[i] > 0 ? 1.0 : (rawDeriv[i] < 0 ? -1.0 : 0.0);
+            dp[i] = p_coeff * (dPDi + dlnPc * PD_vec[i]);
+            dd[i] = p_coeff * (sign * dRaw + dlnPc * std::abs(rawDeriv[i]));
+        }
     }
+
+    return std::make_tuple(tPoints, finalP, finalDP);
 }
 
-// 拉普拉斯空间下的复合模型总函数 (包含井储和表皮)
-double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double>& p) {
-    double kf = p.value("kf");
-    double km = p.value("km");
-    double LfD = p.value("LfD");
-    double rmD = p.value("rmD");
-    double reD = p.value("reD", 0.0);
-    double omga1 = p.value("omega1");
-    double omga2 = p.value("omega2");
-    double remda1 = p.value("lambda1");
-    int nf = (int)p.value("nf", 4);
-    if(nf < 1) nf = 1;
-
-    double M12 = kf / km;
-
-    // 生成裂缝位置 xwD
+// 带灵敏度的反演：Laplace 参数为对偶数自变量，不使用 Laplace 缓存 (缓存只存函数值)
+// Stehfest：z 和 ln2/t 随 ln(tD) 方向变化 (dz/dln tD = -z)；
+// 复平面方法：节点 s 与参数无关，以 Dual<W, complex> 求 F(s) 及其偏导数，与求值路径共用同一组分段节点，
+// 反演公式中的时间 t 沿 ln(tD) 方向求导
+template <int W>
+void ModelSolver01_06::invertWithSensitivity(const QVector<double>& tD, const ParamSet& params, int N, InversionMethod method,
+                                             const QVector<int>& dirOf, int lnTdDir, int dirs,
+                                             QVector<double>& outPD, QVector<QVector<double>>& outDPD,
+                                             QVector<double>& outDeriv, QVector<QVector<double>>& outDDeriv, SolverControl* control) const
+{
+    typedef Dual<W> D;
+    int numPoints = tD.size();
+    outPD = QVector<double>(numPoints, 0.0);
+    outDPD = QVector<QVector<double>>(dirs, QVector<double>(numPoints, 0.0));
+    outDeriv = QVector<double>(numPoints, 0.0);
+    outDDeriv = QVector<QVector<double>>(dirs, QVector<double>(numPoints, 0.0));
+    if (control) control->addWork(numPoints);
+
+    double ln2 = log(2.0);
+    const QVector<double>& V = getStehfestCoefficients(N);
+
+    int nf = (int)params[ParamSet::NF];
+    if (nf < 1) nf = 1;
+    const QVector<double> xwD = fracturePositions(nf);
+
+    auto arg = [&](int slot) { return D::variable(params[slot], dirOf[slot]); };
+    LaplaceArgs<D> a;
+    a.kf = arg(ParamSet::KF);
+    a.km = arg(ParamSet::KM);
+    a.LfD = arg(ParamSet::LFD);
+    a.rmD = arg(ParamSet::RMD);
+    a.reD = arg(ParamSet::RED);
+    a.omega1 = arg(ParamSet::OMEGA1);
+    a.omega2 = arg(ParamSet::OMEGA2);
+    a.lambda1 = arg(ParamSet::LAMBDA1);
+    a.cD = arg(ParamSet::CD);
+    a.S = arg(ParamSet::S);
+    D gamaD = arg(ParamSet::GAMAD);
+    int gamaDir = dirOf[ParamSet::GAMAD];
+
+    // 各时间点只写入自己的下标，先取出写指针避免并行时隐式共享分离
+    double* pdData = outPD.data();
+    double* derivData = outDeriv.data();
+    QVector<double*> dData(dirs), dDerivData(dirs);
+    for (int j = 0; j < dirs; ++j) {
+        dData[j] = outDPD[j].data();
+        dDerivData[j] = outDDeriv[j].data();
+    }
+    // 写出一个时间点的 pD、导数及其偏导数 (非有限的偏导数记为 0)
+    auto store = [&](int k, const D& pd, const D& deriv) {
+        pdData[k] = pd.v;
+        derivData[k] = std::isfinite(deriv.v) ? deriv.v : 0.0;
+        for (int j = 0; j < dirs; ++j) {
+            dData[j][k] = pd.d[j];
+            dDerivData[j][k] = std::isfinite(deriv.d[j]) ? deriv.d[j] : 0.0;
+        }
+    };
+
+    if (method != StehfestInversion) {
+        typedef Dual<W, std::complex<double>> DC;
+        auto complexArg = [&](int slot) { return DC::variable(params[slot], dirOf[slot]); };
+        LaplaceArgs<DC> ac;
+        ac.kf = complexArg(ParamSet::KF);
+        ac.km = complexArg(ParamSet::KM);
+        ac.LfD = complexArg(ParamSet::LFD);
+        ac.rmD = complexArg(ParamSet::RMD);
+        ac.reD = complexArg(ParamSet::RED);
+        ac.omega1 = complexArg(ParamSet::OMEGA1);
+        ac.omega2 = complexArg(ParamSet::OMEGA2);
+        ac.lambda1 = complexArg(ParamSet::LAMBDA1);
+        ac.cD = complexArg(ParamSet::CD);
+        ac.S = complexArg(ParamSet::S);
+
+        const LaplaceKernel<DC> complexKernel = laplaceKernel<DC>(m_type);
+        const std::function<DC(const DC&)> F = [&](const DC& s) {
+            if (control && control->shouldStop()) return DC(0.0);
+            DC pf = complexKernel(s, ac, xwD);
+            if (!std::isfinite(pf.v.real()) || !std::isfinite(pf.v.imag())) return DC(0.0);
+            for (int j = 0; j < W; ++j) {
+                if (!std::isfinite(pf.d[j].real()) || !std::isfinite(pf.d[j].imag())) pf.d[j] = 0.0;
+            }
+            return pf;
+        };
+
+        QVector<DC> inverted(numPoints), invertedDeriv(numPoints);
+        int M = inversionOrder(method, N);
+        if (method == TalbotInversion) invertTalbot(tD, M, F, lnTdDir, inverted.data(), invertedDeriv.data());
+        else if (method == DeHoogInversion) invertDeHoog(tD, M, F, lnTdDir, inverted.data(), invertedDeriv.data());
+        else invertEuler(tD, M, F, lnTdDir, inverted.data(), invertedDeriv.data());
+
+        for (int k = 0; k < numPoints; ++k) {
+            if (tD[k] <= 1e-12) continue;
+            D pd = InversionScalar<DC>::realPart(inverted[k]);
+            D deriv = InversionScalar<DC>::realPart(invertedDeriv[k]);
+            if (!std::isfinite(pd.v)) continue;
+            for (int j = 0; j < W; ++j) {
+                if (!std::isfinite(pd.d[j])) pd.d[j] = 0.0;
+            }
+            pressureSensitiveCorrection(pd, deriv, gamaD, gamaDir);
+            store(k, pd, deriv);
+        }
+        if (control) control->advance(numPoints);
+        return;
+    }
+
+    const LaplaceKernel<D> kernel = laplaceKernel<D>(m_type);
+    auto invertPoint = [&](int k) {
+        double t = tD[k];
+        if (control) control->advance();
+        if (t <= 1e-12 || (control && control->shouldStop())) return;
+
+        // pD = ln2/t Σ V_m p̄(z_m)，tD·dpD/dtD = ln2·(ln2/t) Σ V_m m p̄(z_m)
+        D pd_val(0.0), deriv_val(0.0);
+        for (int m = 1; m <= N; ++m) {
+            if (control && control->shouldStop()) return;
+            double zv = m * ln2 / t;
+            D z = D::variable(zv, lnTdDir, -zv);
+            D pf = kernel(z, a, xwD);
+            if (std::isnan(pf.v) || std::isinf(pf.v)) continue;
+            for (int j = 0; j < W; ++j) {
+                if (!std::isfinite(pf.d[j])) pf.d[j] = 0.0;
+            }
+            pd_val += V[m] * pf;
+            deriv_val += (V[m] * m) * pf;
+        }
+        D scale = D::variable(ln2 / t, lnTdDir, -ln2 / t);
+        D pd = pd_val * scale;
+        D deriv = ln2 * deriv_val * scale;
+        pressureSensitiveCorrection(pd, deriv, gamaD, gamaDir);
+        store(k, pd, deriv);
+    };
+
+    forEachPoint(solverThreadPool(), numPoints, PARALLEL_MIN_POINTS, invertPoint);
+}
+
+// 生成裂缝位置 xwD
+QVector<double> ModelSolver01_06::fracturePositions(int nf)
+{
     QVector<double> xwD;
     if (nf == 1) {
         xwD.append(0.0);
@@ -189,145 +1318,464 @@ double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double
         double step = (end - start) / (nf - 1);
         for(int i=0; i<nf; ++i) xwD.append(start + i * step);
     }
+    return xwD;
+}
 
-    double temp = omga2;
-    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
-    double fs2 = M12 * temp;
+// 外边界策略：给出点源解中外边界项对 I0、I1 的系数 (已乘以 exp(gama2*rmD - gama2*reD) 缩放)
+// 无限大外边界没有 reD 项，不求任何外边界 Bessel 函数
+struct ModelSolver01_06::InfiniteBoundary {
+    template <typename T>
+    static void outerTerms(const T&, const T&, const T&, T&, T&, qint64&) {}
+};
 
-    // 计算不含井储的拉普拉斯空间压力
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type);
+// 封闭外边界：系数 K1(gama2*reD) / I1(gama2*reD)
+struct ModelSolver01_06::ClosedBoundary {
+    template <typename T>
+    static void outerTerms(const T& gama2, const T& reD, const T& arg_g2_rm, T& term_i0, T& term_i1, qint64& besselCalls) {
+        using std::exp;
+        T arg_re = gama2 * reD;
+        T i1_re_s = besselI1e(arg_re);
+        T k1_re = besselK1(arg_re);
+        besselCalls += 4;
+        if (magnitudeOf(i1_re_s) > 1e-100) {
+            T scale = exp(arg_g2_rm - arg_re);
+            term_i0 = (k1_re / i1_re_s) * besselI0e(arg_g2_rm) * scale;
+            term_i1 = (k1_re / i1_re_s) * besselI1e(arg_g2_rm) * scale;
+        }
+    }
+};
+
+// 定压外边界：系数 -K0(gama2*reD) / I0(gama2*reD)
+struct ModelSolver01_06::ConstantPressureBoundary {
+    template <typename T>
+    static void outerTerms(const T& gama2, const T& reD, const T& arg_g2_rm, T& term_i0, T& term_i1, qint64& besselCalls) {
+        using std::exp;
+        T arg_re = gama2 * reD;
+        T i0_re_s = besselI0e(arg_re);
+        T k0_re = besselK0(arg_re);
+        besselCalls += 4;
+        if (magnitudeOf(i0_re_s) > 1e-100) {
+            T scale = exp(arg_g2_rm - arg_re);
+            term_i0 = -(k0_re / i0_re_s) * besselI0e(arg_g2_rm) * scale;
+            term_i1 = -(k0_re / i0_re_s) * besselI1e(arg_g2_rm) * scale;
+        }
+    }
+};
 
-    // 加入井储和表皮效应
-    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
-    if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
+// 井储策略：变井储模型 (1、3、5) 在 Laplace 空间计入井储和表皮，其余模型直接使用点源解
+struct ModelSolver01_06::WellboreStorage {
+    template <typename T>
+    static T apply(const T& z, const T& pf, const T& cD, const T& S) {
+        if (valueOf(cD) > 1e-12 || std::abs(valueOf(S)) > 1e-12) {
+            T zpS = z * pf + S;
+            return zpS / (z + cD * z * z * zpS);
         }
+        return pf;
+    }
+};
+
+struct ModelSolver01_06::NoWellboreStorage {
+    template <typename T>
+    static T apply(const T&, const T& pf, const T&, const T&) { return pf; }
+};
+
+template <typename T>
+ModelSolver01_06::LaplaceKernel<T> ModelSolver01_06::laplaceKernel(ModelType type)
+{
+    switch (type) {
+    case Model_1: return &laplaceComposite<InfiniteBoundary, WellboreStorage, T>;
+    case Model_2: return &laplaceComposite<InfiniteBoundary, NoWellboreStorage, T>;
+    case Model_3: return &laplaceComposite<ClosedBoundary, WellboreStorage, T>;
+    case Model_4: return &laplaceComposite<ClosedBoundary, NoWellboreStorage, T>;
+    case Model_5: return &laplaceComposite<ConstantPressureBoundary, WellboreStorage, T>;
+    case Model_6: return &laplaceComposite<ConstantPressureBoundary, NoWellboreStorage, T>;
     }
+    return &laplaceComposite<InfiniteBoundary, NoWellboreStorage, T>;
+}
+
+template <typename T>
+ModelSolver01_06::LaplaceArgs<T> ModelSolver01_06::laplaceArgs(const ParamSet& p)
+{
+    LaplaceArgs<T> a;
+    a.kf = p[ParamSet::KF];
+    a.km = p[ParamSet::KM];
+    a.LfD = p[ParamSet::LFD];
+    a.rmD = p[ParamSet::RMD];
+    a.reD = p[ParamSet::RED];
+    a.omega1 = p[ParamSet::OMEGA1];
+    a.omega2 = p[ParamSet::OMEGA2];
+    a.lambda1 = p[ParamSet::LAMBDA1];
+    a.cD = p[ParamSet::CD];
+    a.S = p[ParamSet::S];
+    return a;
+}
+
+// 拉普拉斯空间下的复合模型总函数 (包含井储和表皮)
+template <class Boundary, class Storage, typename T>
+T ModelSolver01_06::laplaceComposite(const T& z, const LaplaceArgs<T>& p, const QVector<double>& xwD) {
+    WT_PROFILE_COUNT(LaplaceEvaluations, 1);
+    T M12 = p.kf / p.km;
 
-    return pf;
+    T temp = p.omega2;
+    T fs1 = p.omega1 + p.lambda1 * temp / (p.lambda1 + z * temp);
+    T fs2 = M12 * temp;
+
+    // 计算不含井储的拉普拉斯空间压力，再按井储策略加入井储和表皮效应
+    T pf = pwdComposite<Boundary>(z, fs1, fs2, M12, p.LfD, p.rmD, p.reD, xwD);
+    return Storage::apply(z, pf, p.cD, p.S);
 }
 
 // 核心点源解叠加计算
-double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type) {
-    using namespace boost::math;
-    QVector<double> ywD(nf, 0.0); // 假设裂缝在y方向无偏移
-    double gama1 = sqrt(z * fs1);
-    double gama2 = sqrt(z * fs2);
-    double arg_g2_rm = gama2 * rmD;
-    double arg_g1_rm = gama1 * rmD;
-
-    double k0_g2 = cyl_bessel_k(0, arg_g2_rm);
-    double k1_g2 = cyl_bessel_k(1, arg_g2_rm);
-    double k0_g1 = cyl_bessel_k(0, arg_g1_rm);
-    double k1_g1 = cyl_bessel_k(1, arg_g1_rm);
-
-    double term_mAB_i0 = 0.0;
-    double term_mAB_i1 = 0.0;
-
-    bool isInfinite = (type == Model_1 || type == Model_2);
-    bool isClosed = (type == Model_3 || type == Model_4);
-    bool isConstP = (type == Model_5 || type == Model_6);
+template <class Boundary, typename T>
+T ModelSolver01_06::pwdComposite(const T& z, const T& fs1, const T& fs2, const T& M12, const T& LfD, const T& rmD, const T& reD,
+                                 const QVector<double>& xwD) {
+    using std::sqrt;
+    using std::exp;
+
+    int nf = xwD.size();
+    T gama1 = sqrt(z * fs1);
+    T gama2 = sqrt(z * fs2);
+    T arg_g2_rm = gama2 * rmD;
+    T arg_g1_rm = gama1 * rmD;
+
+    T k0_g2 = besselK0(arg_g2_rm);
+    T k1_g2 = besselK1(arg_g2_rm);
+    T k0_g1 = besselK0(arg_g1_rm);
+    T k1_g1 = besselK1(arg_g1_rm);
+    // 本次求值的 Bessel 函数与积分节点计数，返回前一并计入
+    qint64 besselCalls = 6;
+    qint64 quadratureNodes = 0;
 
     // 边界条件处理
-    if (!isInfinite) {
-        double arg_re = gama2 * reD;
-        double i1_re_s = scaled_besseli(1, arg_re);
-        double i0_re_s = scaled_besseli(0, arg_re);
-        double k1_re = cyl_bessel_k(1, arg_re);
-        double k0_re = cyl_bessel_k(0, arg_re);
-        double i0_g2_s = scaled_besseli(0, arg_g2_rm);
-        double i1_g2_s = scaled_besseli(1, arg_g2_rm);
-
-        if (isClosed) {
-            if (i1_re_s > 1e-100) {
-                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+    T term_mAB_i0 = T(0.0);
+    T term_mAB_i1 = T(0.0);
+    Boundary::outerTerms(gama2, reD, arg_g2_rm, term_mAB_i0, term_mAB_i1, besselCalls);
+
+    T term1 = term_mAB_i0 + k0_g2;
+    T term2 = term_mAB_i1 - k1_g2;
+
+    T Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
+
+    T i1_g1_s = besselI1e(arg_g1_rm);
+    T i0_g1_s = besselI0e(arg_g1_rm);
+
+    T Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+
+    if (magnitudeOf(Acdown_scaled) < 1e-100) Acdown_scaled = T(1e-100);
+
+    T Ac_prefactor = Acup / Acdown_scaled;
+
+    // 沿裂缝积分换元 a = LfD*u (u ∈ [-1, 1])，积分区间不再随 LfD 变化，LfD 的导数由被积函数给出
+    // 绝对误差容限同比缩放，积分节点与接受判据和在 [-LfD, LfD] 上直接积分一致
+    const double lfd = valueOf(LfD);
+    const double absTol = lfd > 0 ? 1e-5 / lfd : 1e-5;
+
+    // 裂缝 j 对裂缝 i 的影响系数，只取决于两缝的相对位置 (dx, dy)
+    auto influence = [&](double dx, double dy) -> T {
+        // 一次求出子区间全部积分节点上的值，Bessel 函数走批量接口
+        auto integrand = [&](const double* u, T* out, int n) {
+            T arg[AdaptiveQuadrature::KRONROD_POINTS];
+            T k0v[AdaptiveQuadrature::KRONROD_POINTS];
+            T i0v[AdaptiveQuadrature::KRONROD_POINTS];
+            for (int k = 0; k < n; ++k) {
+                T delta = dx - LfD * u[k];
+                T arg_dist = gama1 * sqrt(delta * delta + dy * dy);
+                arg[k] = magnitudeOf(arg_dist) < 1e-10 ? T(1e-10) : arg_dist;
             }
-        } else if (isConstP) {
-            if (i0_re_s > 1e-100) {
-                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+            besselK0I0eBatch(arg, k0v, i0v, n);
+            quadratureNodes += n;
+            for (int k = 0; k < n; ++k) {
+                T exponent = arg[k] - arg_g1_rm;
+                out[k] = k0v[k];
+                if (valueOf(exponent) > -700.0) {
+                    out[k] += Ac_prefactor * i0v[k] * exp(exponent);
+                }
             }
+        };
+        T val = AdaptiveQuadrature::integrateBatch<T>(integrand, -1.0, 1.0, absTol, 1e-10, 10) * LfD;
+        return z * val / (M12 * z * 2.0 * LfD);
+    };
+
+    // 裂缝在 y 方向无偏移：等间距布缝时积分区间关于 0 对称，影响系数只取决于 |i-j|，
+    // 影响矩阵为对称 Toeplitz 矩阵：只需 nf 个积分，并用 Levinson 递推求解
+    bool uniform = true;
+    for (int i = 2; i < nf && uniform; ++i) {
+        if (std::abs((xwD[i] - xwD[i - 1]) - (xwD[1] - xwD[0])) > 1e-12) uniform = false;
+    }
+
+    auto flushCounts = [&]() {
+        WT_PROFILE_COUNT(BesselCalls, besselCalls + 2 * quadratureNodes);
+        WT_PROFILE_COUNT(QuadratureNodes, quadratureNodes);
+        WT_PROFILE_COUNT(FlowSolves, 1);
+    };
+
+    InfluenceWorkspace<T>& iw = InfluenceWorkspace<T>::local();
+    QVector<T>& t = iw.coefficients;
+    if (uniform) {
+        t.resize(nf);
+        for (int k = 0; k < nf; ++k) t[k] = influence(xwD[k] - xwD[0], 0.0);
+        T pwd;
+        if (solveFlowUniform(t, z, pwd)) {
+            flushCounts();
+            return pwd;
         }
     }
 
-    double term1 = term_mAB_i0 + k0_g2;
-    double term2 = term_mAB_i1 - k1_g2;
+    // 一般情形 (或 Levinson 递推失效时)：建立完整线性方程组求解裂缝各段流量分布
+    // Levinson 失效时直接展开已有的 Toeplitz 系数，不再重新积分
+    QVector<T>& A = iw.matrix;
+    A.resize(nf * nf);
+    if (uniform) {
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) A[i * nf + j] = t[std::abs(i - j)];
+        }
+    } else {
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) A[i * nf + j] = influence(xwD[i] - xwD[j], 0.0);
+        }
+    }
+    flushCounts();
+    return solveFlowGeneral(A, nf, z);
+}
 
-    double Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
+// 方程组 T q = p*1, z*sum(q) = 1  =>  q = p*y (T y = 1)，p = 1/(z*sum(y))
+bool ModelSolver01_06::solveFlowUniform(const QVector<double>& t, double z, double& pwd)
+{
+    FlowWorkspace<double>& ws = FlowWorkspace<double>::local();
+    ws.ones.fill(1.0, t.size());
+    if (!solveSymmetricToeplitz(t, ws.ones, ws.y)) return false;
+    double sumY = 0.0;
+    for (double v : ws.y) sumY += v;
+    if (!(std::abs(z * sumY) > 1e-300)) return false;
+    pwd = 1.0 / (z * sumY);
+    return true;
+}
 
-    double i1_g1_s = scaled_besseli(1, arg_g1_rm);
-    double i0_g1_s = scaled_besseli(0, arg_g1_rm);
+template <int W, typename S>
+bool ModelSolver01_06::solveFlowUniform(const QVector<Dual<W, S>>& t, const Dual<W, S>& z, Dual<W, S>& pwd)
+{
+    int nf = t.size();
+    FlowWorkspace<S>& ws = FlowWorkspace<S>::local();
+    QVector<S>& t0 = ws.values;
+    QVector<S>& y = ws.y;
+    QVector<S>& rhs = ws.rhs;
+    QVector<S>& dy = ws.dy;
+    t0.resize(nf);
+    rhs.resize(nf);
+    ws.ones.fill(S(1.0), nf);
+    for (int k = 0; k < nf; ++k) t0[k] = t[k].v;
+    if (!solveSymmetricToeplitz(t0, ws.ones, y)) return false;
 
-    double Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+    // T·dy = -dT·y，矩阵与数值解相同，每个方向一次 Levinson 递推
+    Dual<W, S> sumY(0.0);
+    for (const S& v : y) sumY.v += v;
+    for (int j = 0; j < W; ++j) {
+        bool active = false;
+        for (int k = 0; k < nf && !active; ++k) active = (t[k].d[j] != S(0.0));
+        if (!active) continue;
+        for (int i = 0; i < nf; ++i) {
+            S s(0.0);
+            for (int k = 0; k < nf; ++k) s += t[std::abs(i - k)].d[j] * y[k];
+            rhs[i] = -s;
+        }
+        if (!solveSymmetricToeplitz(t0, rhs, dy)) return false;
+        for (const S& v : dy) sumY.d[j] += v;
+    }
 
-    if (std::abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
+    if (!(std::abs(z.v * sumY.v) > 1e-300)) return false;
+    pwd = 1.0 / (z * sumY);
+    return true;
+}
 
-    double Ac_prefactor = Acup / Acdown_scaled;
+bool ModelSolver01_06::solveFlowUniform(const QVector<std::complex<double>>& t, const std::complex<double>& z, std::complex<double>& pwd)
+{
+    FlowWorkspace<std::complex<double>>& ws = FlowWorkspace<std::complex<double>>::local();
+    ws.ones.fill(1.0, t.size());
+    if (!solveSymmetricToeplitz(t, ws.ones, ws.y)) return false;
+    std::complex<double> sumY = 0.0;
+    for (const std::complex<double>& v : ws.y) sumY += v;
+    if (!(std::abs(z * sumY) > 1e-300)) return false;
+    pwd = 1.0 / (z * sumY);
+    return true;
+}
 
-    // 建立线性方程组求解裂缝各段流量分布
+// 补充方程：各裂缝压力相等，流量和为1 (增广为 (nf+1) 阶方程组)
+double ModelSolver01_06::solveFlowGeneral(const QVector<double>& A, int nf, double z)
+{
     int size = nf + 1;
-    Eigen::MatrixXd A_mat(size, size);
-    Eigen::VectorXd b_vec(size);
-    b_vec.setZero();
+    FlowWorkspace<double>& ws = FlowWorkspace<double>::local();
+    Eigen::MatrixXd& A_mat = ws.matrix;
+    Eigen::VectorXd& b_vec = ws.b;
+    A_mat.resize(size, size);
+    b_vec.setZero(size);
     b_vec(nf) = 1.0; // 定产条件
 
     for (int i = 0; i < nf; ++i) {
-        for (int j = 0; j < nf; ++j) {
-            auto integrand = [&](double a) -> double {
-                double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
-                double arg_dist = gama1 * dist;
-                if (arg_dist < 1e-10) arg_dist = 1e-10;
-
-                double term2 = 0.0;
-                double exponent = arg_dist - arg_g1_rm;
-                if (exponent > -700.0) {
-                    term2 = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
-                }
-                return cyl_bessel_k(0, arg_dist) + term2;
-            };
-            // 沿裂缝积分
-            double val = adaptiveGauss(integrand, -LfD, LfD, 1e-5, 0, 10);
-            A_mat(i, j) = z * val / (M12 * z * 2 * LfD);
+        for (int j = 0; j < nf; ++j) A_mat(i, j) = A[i * nf + j];
+        A_mat(i, nf) = -1.0;
+        A_mat(nf, i) = z; // 注意这里 z 系数
+    }
+    A_mat(nf, nf) = 0.0;
+
+    ws.lu.compute(A_mat);
+    ws.x = ws.lu.solve(b_vec);
+    return ws.x(nf);
+}
+
+template <int W, typename S>
+Dual<W, S> ModelSolver01_06::solveFlowGeneral(const QVector<Dual<W, S>>& A, int nf, const Dual<W, S>& z)
+{
+    typedef typename FlowWorkspace<S>::Matrix Matrix;
+    typedef typename FlowWorkspace<S>::Vector Vector;
+    int size = nf + 1;
+    FlowWorkspace<S>& ws = FlowWorkspace<S>::local();
+    Matrix& A_mat = ws.matrix;
+    Vector& b_vec = ws.b;
+    A_mat.resize(size, size);
+    b_vec.setZero(size);
+    b_vec(nf) = 1.0;
+
+    for (int i = 0; i < nf; ++i) {
+        for (int j = 0; j < nf; ++j) A_mat(i, j) = A[i * nf + j].v;
+        A_mat(i, nf) = -1.0;
+        A_mat(nf, i) = z.v;
+    }
+    A_mat(nf, nf) = 0.0;
+
+    Eigen::FullPivLU<Matrix>& lu = ws.lu;
+    lu.compute(A_mat);
+    Vector& x = ws.x;
+    x = lu.solve(b_vec);
+
+    // A·dx = -dA·x，W 个方向一起作为右端矩阵求解
+    Matrix& rhs = ws.rhsMatrix;
+    rhs.resize(size, W);
+    for (int j = 0; j < W; ++j) {
+        for (int i = 0; i < nf; ++i) {
+            S s(0.0);
+            for (int k = 0; k < nf; ++k) s += A[i * nf + k].d[j] * x(k);
+            rhs(i, j) = -s;
         }
+        S s(0.0);
+        for (int k = 0; k < nf; ++k) s += z.d[j] * x(k);
+        rhs(nf, j) = -s;
     }
-    // 补充方程：各裂缝压力相等，流量和为1
+    Matrix& dx = ws.dx;
+    dx = lu.solve(rhs);
+
+    Dual<W, S> result(x(nf));
+    for (int j = 0; j < W; ++j) result.d[j] = dx(nf, j);
+    return result;
+}
+
+std::complex<double> ModelSolver01_06::solveFlowGeneral(const QVector<std::complex<double>>& A, int nf, const std::complex<double>& z)
+{
+    int size = nf + 1;
+    FlowWorkspace<std::complex<double>>& ws = FlowWorkspace<std::complex<double>>::local();
+    Eigen::MatrixXcd& A_mat = ws.matrix;
+    Eigen::VectorXcd& b_vec = ws.b;
+    A_mat.resize(size, size);
+    b_vec.setZero(size);
+    b_vec(nf) = 1.0;
+
     for (int i = 0; i < nf; ++i) {
+        for (int j = 0; j < nf; ++j) A_mat(i, j) = A[i * nf + j];
         A_mat(i, nf) = -1.0;
-        A_mat(nf, i) = z; // 注意这里 z 系数
+        A_mat(nf, i) = z;
     }
     A_mat(nf, nf) = 0.0;
 
-    return A_mat.fullPivLu().solve(b_vec)(nf);
+    ws.lu.compute(A_mat);
+    ws.x = ws.lu.solve(b_vec);
+    return ws.x(nf);
 }
 
-// 缩放的贝塞尔 I 函数 I(x)*exp(-x)，防止溢出
+// 对称 Toeplitz 方程组 T x = b 的 Levinson 递推求解，O(n^2)
+// t[k] 为第 k 条对角线的值；主子式接近奇异时返回 false，由调用方退回一般解法
+// 标量类型 S 为 double 或 std::complex<double> (复对称矩阵，递推中不取共轭)
+template <typename S>
+bool ModelSolver01_06::solveSymmetricToeplitz(const QVector<S>& t, const QVector<S>& b, QVector<S>& x)
+{
+    int n = t.size();
+    x.resize(n);
+    if (n == 0) return true;
+    if (std::abs(t[0]) < 1e-300) return false;
+
+    // 归一化为主对角线为 1 的形式；中间量取自本线程工作区 (与调用方传入的 b、x 不是同一缓冲区)
+    FlowWorkspace<S>& ws = FlowWorkspace<S>::local();
+    QVector<S>& r = ws.levinsonR;
+    QVector<S>& rhs = ws.levinsonB;
+    r.resize(n);
+    rhs.resize(n);
+    for (int k = 0; k < n; ++k) {
+        r[k] = t[k] / t[0];
+        rhs[k] = b[k] / t[0];
+    }
+
+    x[0] = rhs[0];
+    if (n == 1) return true;
+
+    QVector<S>& yv = ws.levinsonY;
+    QVector<S>& tmp = ws.levinsonTmp;
+    yv.resize(n);
+    tmp.resize(n);
+    yv[0] = -r[1];
+    S beta = 1.0;
+    S alpha = -r[1];
+
+    for (int k = 1; k < n; ++k) {
+        beta *= (1.0 - alpha * alpha);
+        if (!(std::abs(beta) > 1e-14)) return false;
+
+        S mu = rhs[k];
+        for (int i = 0; i < k; ++i) mu -= r[i + 1] * x[k - 1 - i];
+        mu /= beta;
+
+        for (int i = 0; i < k; ++i) tmp[i] = x[i] + mu * yv[k - 1 - i];
+        for (int i = 0; i < k; ++i) x[i] = tmp[i];
+        x[k] = mu;
+
+        if (k < n - 1) {
+            alpha = -r[k + 1];
+            for (int i = 0; i < k; ++i) alpha -= r[i + 1] * yv[k - 1 - i];
+            alpha /= beta;
+
+            for (int i = 0; i < k; ++i) tmp[i] = yv[i] + alpha * yv[k - 1 - i];
+            for (int i = 0; i < k; ++i) yv[i] = tmp[i];
+            yv[k] = alpha;
+        }
+    }
+
+    for (int k = 0; k < n; ++k) {
+        if (!std::isfinite(std::abs(x[k]))) return false;
+    }
+    return true;
+}
+
+// 缩放的贝塞尔 I 函数 I(x)*exp(-x)，防止溢出 (直接由展开式给出缩放值，大参数无需截断)
 double ModelSolver01_06::scaled_besseli(int v, double x) {
     if (x < 0) x = -x;
-    if (x > 600.0) return 1.0 / std::sqrt(2.0 * M_PI * x);
-    return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
+    return v == 0 ? BesselKernel::i0e(x) : BesselKernel::i1e(x);
 }
 
-// 高斯积分点
-double ModelSolver01_06::gauss15(std::function<double(double)> f, double a, double b) {
-    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
-    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
-    double h = 0.5 * (b - a); double c = 0.5 * (a + b); double s = W[0] * f(c);
-    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; s += W[i] * (f(c - dx) + f(c + dx)); }
-    return s * h;
-}
+// Stehfest 系数表 (惰性生成，C++11 局部静态变量初始化保证线程安全)
+const QVector<double>& ModelSolver01_06::getStehfestCoefficients(int N)
+{
+    static const QVector<QVector<double>> table = []() {
+        QVector<QVector<double>> t(MAX_STEHFEST_N + 1);
+        for (int n = 2; n <= MAX_STEHFEST_N; n += 2) {
+            QVector<double> v(n + 1, 0.0);
+            for (int i = 1; i <= n; ++i) v[i] = stefestCoefficient(i, n);
+            t[n] = v;
+        }
+        return t;
+    }();
 
-// 自适应高斯积分
-double ModelSolver01_06::adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth) {
-    double c = (a + b) / 2.0; double v1 = gauss15(f, a, b); double v2 = gauss15(f, a, c) + gauss15(f, c, b);
-    if (depth >= maxDepth || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
-    return adaptiveGauss(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss(f, c, b, eps/2, depth+1, maxDepth);
+    if (N % 2 != 0 || N < 2 || N > MAX_STEHFEST_N) N = 4;
+    return table[N];
 }
 
-// Stehfest 系数
+// Stehfest 系数 (单项计算，仅用于生成系数表)
 double ModelSolver01_06::stefestCoefficient(int i, int N) {
     double s = 0.0; int k1 = (i + 1) / 2; int k2 = std::min(i, N / 2);
     for (int k = k1; k <= k2; ++k) {
@@ -5,6 +5,14 @@
  * 1. 定义模型类型枚举 (ModelType) 和曲线数据类型 (ModelCurveData)。
  * 2. 声明纯数学计算逻辑，包括拉普拉斯变换、贝塞尔函数计算、Stehfest 数值反演等。
  * 3. 不依赖任何 UI 控件，仅负责数据输入与结果输出。
+ * 4. Laplace 空间解对标量类型泛型，可用对偶数 (Dual) 前向自动微分，一次正演给出曲线对各参数的偏导数。
+ * 5. 数值反演可选 Stehfest (实轴) 或固定 Talbot、de Hoog、Euler (复平面)，按调用或按模型类型设置。
+ * 6. 可选由无因次型曲线库插值 (CalcOptions::typeCurveLookup)，只改变时间/压力换算的参数无需重新反演。
+ * 7. 计算可由调用方控制 (CalcOptions::control，见 SolverControl)：各 Laplace 求值与时间点前检查取消/截止时间，
+ *    停止后返回空曲线且不写入任何缓存；按已完成的时间点报告进度。
+ * 8. Stehfest 精确模式：long double 系数表 + Neumaier 补偿求和，按相邻阶数之差估计反演误差，可按点自适应选阶。
+ * 9. 六种模型类型为外边界策略 × 井储策略的组合，编译期展开为各自的 Laplace 内核，每次反演按模型类型选择一次。
+ * 10. 理论导数 tD·dpD/dtD 由反演 s·p̄D 得到 (与 pD 共用同一组 Laplace 值)，逐点独立，不依赖时间网格疏密。
  */
 
 #ifndef MODELSOLVER01_06_H  // 修改点：将 - 改为 _
@@ -13,8 +21,18 @@
 #include <QMap>
 #include <QVector>
 #include <QString>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThreadPool>
 #include <tuple>
+#include <complex>
 #include <functional>
+#include "dualnumber.h"
+
+class SolverControl;
 
 // 类型定义: <时间, 压力, 导数>
 using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
@@ -32,15 +50,93 @@ public:
         Model_6      // 定压边界 + 恒定井储
     };
 
+    // Laplace 数值反演方法
+    enum InversionMethod {
+        DefaultInversion = -1,  // 使用该模型类型的默认方法 (setDefaultInversion)
+        StehfestInversion = 0,  // Stehfest：实轴上 N 个点，每个时间点单独求值
+        TalbotInversion,        // 固定 Talbot 围道：同一时间分段内的各点共享围道节点
+        DeHoogInversion,        // de Hoog 商差算法加速的 Fourier 级数：同一时间分段内共享节点
+        EulerInversion          // Abate-Whitt Euler 求和：Bromwich 直线上 2M+1 个点，每个时间点单独求值
+    };
+
+    // 单次计算选项：随调用传入，不修改求解器状态，多线程并发调用互不影响
+    struct CalcOptions {
+        bool highPrecision = true;  // false 时 Stehfest 固定使用 4 阶（拟合迭代用）
+        int stehfestN = 0;          // >0 时强制使用该阶数，0 表示读取参数表中的 "N"
+        InversionMethod inversion = DefaultInversion; // 反演方法，复平面方法的节点数由 Stehfest 阶数换算 (inversionOrder)
+        bool typeCurveLookup = false; // 由型曲线库 (TypeCurveLibrary) 插值无因次解，只缺网格点时才反演 (交互预览用)
+        SolverControl* control = nullptr; // 取消、截止时间与进度 (非空时由计算过程检查，停止后返回空曲线)
+
+        // Stehfest 精确模式 (只作用于曲线计算，不作用于灵敏度与型曲线库路径)：
+        // 高阶 (N > 12) 系数正负交替、量级达 1e8，double 求和会丢失大部分有效数字
+        bool compensatedStehfest = false; // long double 系数表与 Neumaier 补偿求和
+        double stehfestTolerance = 0.0;   // >0 时按点自适应选阶：从 4 阶起每次加 2 (不超过解析出的 N)，相邻两阶相对差低于该值即停止
+        QVector<double>* inversionError = nullptr; // 非空时写入各时间点 pD 的相对误差估计 (相邻两阶之差，无法估计时为 NaN)；设置即启用精确模式
+    };
+
+    // 热路径使用的定长参数表：参数名只在界面边界处解析一次，计算过程中按下标直接访问
+    // 前 LAPLACE_COUNT 项决定 Laplace 空间解，同时作为 Laplace 缓存的键
+    struct ParamSet {
+        enum Index {
+            KF = 0, KM, LFD, RMD, RED, OMEGA1, OMEGA2, LAMBDA1, NF, CD, S,
+            LAPLACE_COUNT,
+            PHI = LAPLACE_COUNT, H, MU, B, CT, Q, L, LF, GAMAD, N,
+            COUNT
+        };
+        double v[COUNT];
+
+        double operator[](int i) const { return v[i]; }
+        double& operator[](int i) { return v[i]; }
+
+        // 参数名到下标的映射，非求解器参数返回 -1
+        static int indexOf(const QString& name);
+        // 与 QMap 之间的转换 (缺省项取求解器默认值)
+        static ParamSet fromMap(const QMap<QString, double>& params);
+        QMap<QString, double> toMap() const;
+    };
+
     // 构造函数
     explicit ModelSolver01_06(ModelType type);
     virtual ~ModelSolver01_06();
 
-    // 设置计算精度
+    // 设置计算精度（仅作为不带选项的计算接口的默认值）
     void setHighPrecision(bool high);
+    bool isHighPrecision() const { return m_highPrecision; }
+    ModelType modelType() const { return m_type; }
+
+    // Laplace 空间求值缓存开关与清理（默认开启）
+    void setLaplaceCacheEnabled(bool enabled);
+    void clearLaplaceCache();
 
     // 核心计算接口：根据参数和时间序列计算理论曲线
     ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 可重入计算接口：精度与阶数由 options 指定，可在多个线程中对同一实例并发调用
+    ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, const CalcOptions& options);
+    // 定长参数表版本 (拟合迭代等热路径使用，避免反复按名称查找)
+    ModelCurveData calculateTheoreticalCurve(const ParamSet& params, const QVector<double>& providedTime, const CalcOptions& options);
+    // 参数组在型曲线库中的键的哈希：相同时两组参数只差时间与压力的换算 (options.typeCurveLookup 下共用同一条型曲线)
+    quint64 typeCurveHash(const ParamSet& params, const CalcOptions& options) const;
+
+    // 曲线对参数的灵敏度：dP[k][i]、dDeriv[k][i] 为第 i 个时间点的压差、导数对参数 wrt[k] 的偏导数
+    struct CurveSensitivity {
+        QVector<int> wrt;                   // ParamSet 下标
+        QVector<QVector<double>> dP;
+        QVector<QVector<double>> dDeriv;
+    };
+
+    // 可求导的参数：除裂缝条数 NF 和 Stehfest 阶数 N 以外的全部参数
+    static bool isDifferentiable(int slot) { return slot >= 0 && slot < ParamSet::COUNT && slot != ParamSet::NF && slot != ParamSet::N; }
+
+    /**
+     * @brief 前向自动微分计算理论曲线及其对参数的偏导数
+     * 一次加宽 (对偶数) 的正演同时得到曲线和全部偏导数，代替 2p 次有限差分正演；
+     * LfD 视为独立参数 (由 L、Lf 换算的链式关系由调用方处理)，不可求导的参数对应的偏导数为 0。
+     * 同时求导的方向数 (时间换算方向 + Laplace 参数 + gamaD) 不超过 MAX_SENSITIVITY_DIRECTIONS。
+     * 反演方法与 calculateTheoreticalCurve 相同 (options.inversion)；复平面方法的曲线与偏导数共用同一组分段节点。
+     */
+    ModelCurveData calculateCurveSensitivity(const ParamSet& params, const QVector<double>& providedTime,
+                                             const CalcOptions& options, const QVector<int>& wrt, CurveSensitivity& out);
+    static const int MAX_SENSITIVITY_DIRECTIONS = 12;
 
     // 获取模型名称（静态辅助函数）
     static QString getModelName(ModelType type);
@@ -48,28 +144,149 @@ public:
     // 生成对数时间步长（静态辅助函数，供内部或外部生成时间序列使用）
     static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
 
+    // Stehfest 系数表允许的最大阶数 (偶数)
+    static const int MAX_STEHFEST_N = 20;
+
+    // 求解器并行线程数上限（所有求解器实例共享，<=0 表示按 CPU 核数自动设置）
+    static void setMaxThreadCount(int count);
+    static int maxThreadCount();
+
+    // 获取 N 阶 Stehfest 系数表（只读共享，下标 1..N 有效，首次调用时一次性生成全部偶数阶）
+    static const QVector<double>& getStehfestCoefficients(int N);
+
+    // 各模型类型的默认反演方法 (全部实例共享，初始均为 Stehfest)
+    static void setDefaultInversion(ModelType type, InversionMethod method);
+    static InversionMethod defaultInversion(ModelType type);
+    static const char* inversionName(InversionMethod method);
+
+    // 复平面方法与 Stehfest N 阶精度相当的节点参数 M：Talbot、Euler 为 N+4，de Hoog 为 N/2+6
+    static int inversionOrder(InversionMethod method, int stehfestN);
+
 private:
-    // 计算无因次压力和导数
-    void calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                             std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                             QVector<double>& outPD, QVector<double>& outDeriv);
+    // 计算无因次压力和导数：Stehfest 使用 laplaceFunc，复平面方法使用 complexLaplaceFunc
+    // options 只使用其中的 control 与 Stehfest 精确模式设置 (阶数与方法由 N、method 给出)
+    void calculatePDandDeriv(const QVector<double>& tD, const ParamSet& params, int N, InversionMethod method,
+                             std::function<double(double, const ParamSet&)> laplaceFunc,
+                             std::function<std::complex<double>(const std::complex<double>&, const ParamSet&)> complexLaplaceFunc,
+                             QVector<double>& outPD, QVector<double>& outDeriv, const CalcOptions& options);
+
+    // 型曲线库路径：在固定对数网格上补齐缺失的无因次解 (不含压敏修正) 后插值到 tD
+    void lookupTypeCurve(const QVector<double>& tD, const ParamSet& params, int N, InversionMethod method,
+                         std::function<double(double, const ParamSet&)> laplaceFunc,
+                         std::function<std::complex<double>(const std::complex<double>&, const ParamSet&)> complexLaplaceFunc,
+                         QVector<double>& outPD, QVector<double>& outDeriv, SolverControl* control = nullptr);
+    // 压敏效应修正 (两条计算路径共用)：deriv 输入为修正前带符号的 tD·dpD/dtD，修正后取绝对值
+    static void finishDimensionlessCurve(double gamaD, QVector<double>& pd, QVector<double>& deriv);
+
+    // 根据计算选项与参数表确定 Stehfest 阶数
+    static int resolveStehfestN(const ParamSet& params, const CalcOptions& options);
+    // 根据计算选项与模型类型确定反演方法
+    InversionMethod resolveInversion(const CalcOptions& options) const;
+
+    // 复平面反演：out[k] 的实部为 tD[k] 处的原函数值 (tD<=1e-12 时为 0)，F 的各节点在求解器线程池中并行求值
+    // C 为 std::complex<double> 或 Dual<W, std::complex<double>>；lnTdDir>=0 时时间 t 在该方向上对 ln(tD) 求导
+    // outDeriv 非空时由同一组节点值同时给出 t·L⁻¹{s F(s)}，即 tD·dpD/dtD (pD(0) = 0)
+    template <typename C>
+    static void invertTalbot(const QVector<double>& tD, int M, const std::function<C(const C&)>& F, int lnTdDir, C* out,
+                             C* outDeriv = nullptr);
+    template <typename C>
+    static void invertDeHoog(const QVector<double>& tD, int M, const std::function<C(const C&)>& F, int lnTdDir, C* out,
+                             C* outDeriv = nullptr);
+    template <typename C>
+    static void invertEuler(const QVector<double>& tD, int M, const std::function<C(const C&)>& F, int lnTdDir, C* out,
+                            C* outDeriv = nullptr);
+    // Talbot、de Hoog 的时间分段：按 INVERSION_BAND_RATIO 的固定对数网格分组，返回 段号 -> 时间点下标
+    static QMap<int, QVector<int>> inversionBands(const QVector<double>& tD);
+
+    // 生成 nf 条裂缝的无因次位置 xwD (每条曲线计算一次，不随 z 重复生成)
+    static QVector<double> fracturePositions(int nf);
+
+    // 决定 Laplace 空间解的参数，标量类型 T 为 double 或 Dual<N>
+    template <typename T>
+    struct LaplaceArgs {
+        T kf, km, LfD, rmD, reD, omega1, omega2, lambda1, cD, S;
+    };
+
+    // 外边界策略 (无限大、封闭、定压) 与井储策略 (计入或不计入井储、表皮)，定义见 .cpp；
+    // 新增边界类型时增加一个外边界策略并在 laplaceKernel 中登记，内核中不增加运行时分支
+    struct InfiniteBoundary;
+    struct ClosedBoundary;
+    struct ConstantPressureBoundary;
+    struct WellboreStorage;
+    struct NoWellboreStorage;
 
-    // 拉普拉斯空间下的复合模型函数
-    double flaplace_composite(double z, const QMap<QString, double>& p);
+    // Laplace 空间解内核：由模型类型选定一次 (每条曲线或每次反演)，之后逐个 z 直接调用
+    template <typename T>
+    using LaplaceKernel = T (*)(const T& z, const LaplaceArgs<T>& p, const QVector<double>& xwD);
+    template <typename T>
+    static LaplaceKernel<T> laplaceKernel(ModelType type);
+    template <typename T>
+    static LaplaceArgs<T> laplaceArgs(const ParamSet& p);
 
-    // 计算点源解的拉普拉斯变换值
-    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type);
+    // 复合模型与点源解的泛型实现 (double 求值，Dual 同时求偏导数，std::complex 供复平面反演)
+    template <class Boundary, class Storage, typename T>
+    static T laplaceComposite(const T& z, const LaplaceArgs<T>& p, const QVector<double>& xwD);
+    template <class Boundary, typename T>
+    static T pwdComposite(const T& z, const T& fs1, const T& fs2, const T& M12, const T& LfD, const T& rmD, const T& reD,
+                          const QVector<double>& xwD);
+
+    // 带灵敏度的反演 (Stehfest 或复平面方法)：W 为对偶数宽度，dirOf[slot] 为参数对应的求导方向 (-1 表示不求导)
+    // outDeriv 为压敏修正后带符号的 tD·dpD/dtD，outDDeriv 为其偏导数
+    template <int W>
+    void invertWithSensitivity(const QVector<double>& tD, const ParamSet& params, int N, InversionMethod method,
+                               const QVector<int>& dirOf, int lnTdDir, int dirs,
+                               QVector<double>& outPD, QVector<QVector<double>>& outDPD,
+                               QVector<double>& outDeriv, QVector<QVector<double>>& outDDeriv, SolverControl* control) const;
+
+    // 裂缝流量方程组求解：等间距布缝为对称 Toeplitz 矩阵 (nf 个影响系数)，一般情形为 nf×nf 影响矩阵 (行优先)
+    // 对偶数版本先求数值解，再用同一矩阵对每个方向求解 A·dx = -dA·x
+    static bool solveFlowUniform(const QVector<double>& t, double z, double& pwd);
+    template <int W, typename S>
+    static bool solveFlowUniform(const QVector<Dual<W, S>>& t, const Dual<W, S>& z, Dual<W, S>& pwd);
+    static double solveFlowGeneral(const QVector<double>& A, int nf, double z);
+    template <int W, typename S>
+    static Dual<W, S> solveFlowGeneral(const QVector<Dual<W, S>>& A, int nf, const Dual<W, S>& z);
+    static bool solveFlowUniform(const QVector<std::complex<double>>& t, const std::complex<double>& z, std::complex<double>& pwd);
+    static std::complex<double> solveFlowGeneral(const QVector<std::complex<double>>& A, int nf, const std::complex<double>& z);
 
     // 数学辅助函数
     double scaled_besseli(int v, double x);
-    double gauss15(std::function<double(double)> f, double a, double b);
-    double adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth);
-    double stefestCoefficient(int i, int N);
-    double factorial(int n);
+    template <typename S>
+    static bool solveSymmetricToeplitz(const QVector<S>& t, const QVector<S>& b, QVector<S>& x);
+    static double stefestCoefficient(int i, int N);
+    static double factorial(int n);
+
+    // Laplace 求值缓存：同一组 Laplace 参数下按 z 记忆 Laplace 空间解
+    struct LaplaceCacheBlock {
+        ParamSet params;                // 参数副本，用于排除哈希碰撞 (只比较 Laplace 参数)
+        QHash<quint64, double> values;  // key 为 z 的二进制位
+        QHash<QPair<quint64, quint64>, std::complex<double>> complexValues; // 复平面节点，key 为实部、虚部的二进制位
+        QMutex mutex;
+    };
+    static quint64 hashParameters(const ParamSet& params);
+    static bool sameLaplaceParameters(const ParamSet& a, const ParamSet& b);
+    static QThreadPool* solverThreadPool();
+    QSharedPointer<LaplaceCacheBlock> acquireCacheBlock(const ParamSet& params);
 
 private:
     ModelType m_type;       // 当前模型类型
     bool m_highPrecision;   // 高精度计算标志
+
+    // 缓存容量上限：最多保留的参数组数，以及每组参数下的 z 点数
+    static const int MAX_CACHE_BLOCKS = 16;
+    static const int MAX_CACHE_ENTRIES = 65536;
+
+    // 时间点少于该值时串行计算，避免线程调度开销超过收益
+    static const int PARALLEL_MIN_POINTS = 16;
+
+    // Talbot、de Hoog 共享节点的时间分段比 (段内最大与最小时间之比)；de Hoog 离散化误差目标
+    static constexpr double INVERSION_BAND_RATIO = 3.0;
+    static constexpr double DEHOOG_TOLERANCE = 1e-12;
+
+    bool m_cacheEnabled;
+    QMutex m_cacheMutex;
+    QHash<quint64, QSharedPointer<LaplaceCacheBlock>> m_laplaceCache;
+    QList<quint64> m_cacheOrder;  // 先进先出淘汰顺序
 };
 
 #endif // MODELSOLVER01_06_H  // 修改点：保持一致
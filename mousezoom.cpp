@@ -2,18 +2,104 @@
 #include <QApplication>
 #include <QMenu>
 #include <QAction>
+#include <QLabel>
 #include <cmath>
 
+namespace {
+// 当前存在的全部图，系统设置变更时统一切换
+QList<MouseZoom*>& liveInstances()
+{
+    static QList<MouseZoom*> instances;
+    return instances;
+}
+MouseZoom::RenderMode s_defaultRenderMode = MouseZoom::RasterRender;
+bool s_defaultFrameTimeVisible = false;
+}
+
 MouseZoom::MouseZoom(QWidget *parent)
-    : QCustomPlot(parent)
+    : QCustomPlot(parent),
+    m_frameTimeLabel(nullptr)
 {
     setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectItems);
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QCustomPlot::customContextMenuRequested, this, &MouseZoom::onCustomContextMenuRequested);
+
+    // 帧耗时显示为子控件，不属于图层，保存图片时不会带上
+    m_frameTimeLabel = new QLabel(this);
+    m_frameTimeLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_frameTimeLabel->setStyleSheet("QLabel { background-color: rgba(255, 255, 255, 200); color: #505050; padding: 1px 4px; }");
+    m_frameTimeLabel->hide();
+    connect(this, &QCustomPlot::afterReplot, this, &MouseZoom::updateFrameTimeLabel);
+
+    liveInstances().append(this);
+    if (s_defaultRenderMode != RasterRender) setRenderMode(s_defaultRenderMode);
+    setFrameTimeVisible(s_defaultFrameTimeVisible);
 }
 
 MouseZoom::~MouseZoom()
 {
+    liveInstances().removeAll(this);
+}
+
+MouseZoom::RenderMode MouseZoom::setRenderMode(RenderMode mode)
+{
+    bool wantGl = mode == OpenGlRender;
+    if (wantGl != openGl()) {
+        // 未以 QCUSTOMPLOT_USE_OPENGL 编译或上下文创建失败时 setOpenGl 保持软件光栅
+        setOpenGl(wantGl);
+        replot(rpQueuedReplot);
+    }
+    if (wantGl && !openGl()) qDebug() << "MouseZoom: OpenGL 不可用，使用软件光栅绘制";
+    return renderMode();
+}
+
+void MouseZoom::setFrameTimeVisible(bool visible)
+{
+    m_frameTimeLabel->setVisible(visible);
+    if (visible) updateFrameTimeLabel();
+}
+
+bool MouseZoom::isFrameTimeVisible() const
+{
+    return !m_frameTimeLabel->isHidden();
+}
+
+void MouseZoom::setDefaultRenderMode(RenderMode mode)
+{
+    s_defaultRenderMode = mode;
+    for (MouseZoom* plot : liveInstances()) plot->setRenderMode(mode);
+}
+
+MouseZoom::RenderMode MouseZoom::defaultRenderMode()
+{
+    return s_defaultRenderMode;
+}
+
+void MouseZoom::setDefaultFrameTimeVisible(bool visible)
+{
+    s_defaultFrameTimeVisible = visible;
+    for (MouseZoom* plot : liveInstances()) plot->setFrameTimeVisible(visible);
+}
+
+void MouseZoom::updateFrameTimeLabel()
+{
+    if (m_frameTimeLabel->isHidden()) return;
+    // replotTime(true) 为最近若干次重绘的平均耗时 (毫秒)
+    m_frameTimeLabel->setText(QString("%1  %2 ms").arg(openGl() ? "OpenGL" : "软件", QString::number(replotTime(true), 'f', 1)));
+    m_frameTimeLabel->adjustSize();
+    placeFrameTimeLabel();
+}
+
+void MouseZoom::placeFrameTimeLabel()
+{
+    m_frameTimeLabel->move(width() - m_frameTimeLabel->width() - 6, 4);
+    m_frameTimeLabel->raise();
+}
+
+void MouseZoom::resizeEvent(QResizeEvent *event)
+{
+    QCustomPlot::resizeEvent(event);
+    if (m_frameTimeLabel) placeFrameTimeLabel();
 }
 
 void MouseZoom::wheelEvent(QWheelEvent *event)
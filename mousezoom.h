@@ -3,14 +3,35 @@
 
 #include "qcustomplot.h"
 
+class QLabel;
+
 class MouseZoom : public QCustomPlot
 {
     Q_OBJECT
 
 public:
+    // 绘制方式：OpenGL 需要以 QCUSTOMPLOT_USE_OPENGL 编译，上下文创建失败时自动退回软件光栅
+    enum RenderMode {
+        RasterRender = 0,
+        OpenGlRender
+    };
+
     explicit MouseZoom(QWidget *parent = nullptr);
     ~MouseZoom();
 
+    // 设置本图的绘制方式，返回实际生效的方式
+    RenderMode setRenderMode(RenderMode mode);
+    RenderMode renderMode() const { return openGl() ? OpenGlRender : RasterRender; }
+
+    // 在右上角显示最近若干帧的平均重绘耗时 (不进入导出图片)
+    void setFrameTimeVisible(bool visible);
+    bool isFrameTimeVisible() const;
+
+    // 全局默认值 (系统设置)：作用于已创建与之后创建的所有图 (仅在界面线程调用)
+    static void setDefaultRenderMode(RenderMode mode);
+    static RenderMode defaultRenderMode();
+    static void setDefaultFrameTimeVisible(bool visible);
+
 signals:
     void saveImageRequested();
     void exportDataRequested();
@@ -24,12 +45,17 @@ signals:
 
 protected:
     void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private slots:
     void onCustomContextMenuRequested(const QPoint &pos);
+    void updateFrameTimeLabel();
 
 private:
     double distToSegment(const QPointF& p, const QPointF& s, const QPointF& e);
+    void placeFrameTimeLabel();
+
+    QLabel* m_frameTimeLabel;
 };
 
 #endif // MOUSEZOOM_H
@@ -0,0 +1,196 @@
+/*
+ * 文件名: multistartfitter.cpp
+ * 文件作用: 多起点全局拟合实现
+ * 功能描述:
+ * 1. 拉丁超立方起点生成：每一维分层后随机置乱，分层内均匀抖动。
+ * 2. 各起点并发运行 FittingCore，共享当前最优误差用于淘汰判定。
+ * 3. 结果去重：对数/线性化后的参数向量各分量相对差都很小时视为同一个解。
+ */
+
+#include "multistartfitter.h"
+
+#include <QtConcurrent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+
+MultiStartFitter::MultiStartFitter(SolverFactory factory)
+    : m_factory(factory)
+{
+}
+
+void MultiStartFitter::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv)
+{
+    m_obsTime = t;
+    m_obsDeltaP = deltaP;
+    m_obsDerivative = deriv;
+}
+
+QVector<QVector<double>> MultiStartFitter::latinHypercube(int count, int dims, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    QVector<QVector<double>> points(count, QVector<double>(dims, 0.0));
+    std::vector<int> strata(count);
+    for (int d = 0; d < dims; ++d) {
+        for (int i = 0; i < count; ++i) strata[i] = i;
+        std::shuffle(strata.begin(), strata.end(), rng);
+        for (int i = 0; i < count; ++i) {
+            points[i][d] = (strata[i] + uniform(rng)) / count;
+        }
+    }
+    return points;
+}
+
+bool MultiStartFitter::sampleInLogSpace(const FitParameter& p)
+{
+    return p.min > 0 && p.max > 10.0 * p.min && p.name != "S" && p.name != "nf";
+}
+
+QList<MultiStartFitter::Solution> MultiStartFitter::run(const QList<FitParameter>& params, const Options& options)
+{
+    QList<Solution> solutions;
+    if (!m_factory || m_obsTime.isEmpty()) return solutions;
+
+    QVector<int> fitIndices;
+    for (int i = 0; i < params.size(); ++i) {
+        if (params[i].isFit) fitIndices.append(i);
+    }
+    int dims = fitIndices.size();
+    int seedCount = qMax(1, options.seedCount);
+
+    // 正值且跨一个数量级以上的参数在对数空间采样，其余在线性空间采样
+    QVector<bool> logSample(dims);
+    for (int k = 0; k < dims; ++k) {
+        logSample[k] = sampleInLogSpace(params[fitIndices[k]]);
+    }
+
+    // 第 0 个起点为当前参数值，其余由拉丁超立方采样得到
+    QVector<QList<FitParameter>> seeds;
+    seeds.reserve(seedCount);
+    seeds.append(params);
+    if (seedCount > 1 && dims > 0) {
+        QVector<QVector<double>> unit = latinHypercube(seedCount - 1, dims, options.randomSeed);
+        for (const QVector<double>& u : unit) {
+            QList<FitParameter> seed = params;
+            for (int k = 0; k < dims; ++k) {
+                FitParameter& p = seed[fitIndices[k]];
+                if (logSample[k]) p.value = std::pow(10.0, std::log10(p.min) + u[k] * (std::log10(p.max) - std::log10(p.min)));
+                else p.value = p.min + u[k] * (p.max - p.min);
+                if (p.name == "nf") p.value = std::round(p.value);
+            }
+            seeds.append(seed);
+        }
+    }
+    seedCount = seeds.size();
+
+    // 求解器在调用线程中创建，工作线程各自独占一个
+    QVector<QSharedPointer<ModelSolver01_06>> solvers(seedCount);
+    for (int i = 0; i < seedCount; ++i) solvers[i] = m_factory();
+
+    // 改进曲线在默认时间网格上计算；有产量历史时改为观测时间上的叠加曲线 (各线程只读共享)
+    RateSuperposition superposition;
+    if (!m_rateSchedule.isEmpty()) superposition = RateSuperposition(m_rateSchedule, m_obsTime, RateSuperposition::Options());
+
+    QVector<Solution> results(seedCount);
+    QMutex bestMutex;
+    double bestMse = std::numeric_limits<double>::infinity();
+    QAtomicInt finished(0);
+
+    auto runSeed = [&](int index) {
+        int acceptedSteps = 0;
+        double currentMse = std::numeric_limits<double>::infinity();
+        bool pruned = false;
+
+        FittingCore core(solvers[index]);
+        core.setObservedData(m_obsTime, m_obsDeltaP, m_obsDerivative);
+        core.setRateSchedule(m_rateSchedule);
+        core.setFitWindows(m_windows);
+        core.setStepCallback([&](double mse, const QMap<QString, double>& p) {
+            ++acceptedSteps;
+            currentMse = mse;
+            bool improved = false;
+            {
+                QMutexLocker locker(&bestMutex);
+                if (mse < bestMse) {
+                    bestMse = mse;
+                    improved = true;
+                }
+            }
+            if (improved && m_onImprovement) {
+                ModelCurveData curve = superposition.isValid()
+                    ? superposition.evaluate(*solvers[index], ModelSolver01_06::ParamSet::fromMap(p), ModelSolver01_06::CalcOptions())
+                    : solvers[index]->calculateTheoreticalCurve(p, QVector<double>(), ModelSolver01_06::CalcOptions());
+                m_onImprovement(mse, p, curve);
+            }
+        });
+        core.setStopPredicate([&]() {
+            if (m_stopRequested && m_stopRequested()) return true;
+            if (acceptedSteps < options.pruneAfterSteps) return false;
+            QMutexLocker locker(&bestMutex);
+            if (currentMse > options.pruneFactor * bestMse) {
+                pruned = true;
+                return true;
+            }
+            return false;
+        });
+
+        FittingCore::Result r = core.run(seeds[index], options.fit);
+        Solution& s = results[index];
+        s.params = r.params;
+        s.mse = r.mse;
+        s.iterations = r.iterations;
+        s.seedIndex = index;
+        s.pruned = pruned;
+
+        int done = finished.fetchAndAddOrdered(1) + 1;
+        if (m_onProgress) m_onProgress(done, seedCount);
+    };
+
+    QVector<int> indices(seedCount);
+    for (int i = 0; i < seedCount; ++i) indices[i] = i;
+    QtConcurrent::blockingMap(indices, runSeed);
+
+    // 按误差排序；淘汰的起点排在未淘汰的之后
+    QVector<Solution> sorted = results;
+    std::sort(sorted.begin(), sorted.end(), [](const Solution& a, const Solution& b) {
+        if (a.pruned != b.pruned) return !a.pruned;
+        return a.mse < b.mse;
+    });
+
+    // 去重：各拟合参数 (对数参数取 log10) 之差都不超过 1e-3 (相对于取值范围) 视为同一解
+    auto sameSolution = [&](const Solution& a, const Solution& b) {
+        for (int k = 0; k < dims; ++k) {
+            const FitParameter& p = params[fitIndices[k]];
+            double va = a.params.value(p.name), vb = b.params.value(p.name);
+            double diff, range;
+            if (logSample[k] && va > 0 && vb > 0) {
+                diff = std::abs(std::log10(va) - std::log10(vb));
+                range = std::log10(p.max) - std::log10(p.min);
+            } else {
+                diff = std::abs(va - vb);
+                range = std::abs(p.max - p.min);
+            }
+            if (diff > 1e-3 * qMax(range, 1e-12)) return false;
+        }
+        return true;
+    };
+
+    int keep = qMax(1, options.keepBest);
+    for (const Solution& s : sorted) {
+        if (!std::isfinite(s.mse)) continue;
+        bool duplicate = false;
+        for (const Solution& kept : solutions) {
+            if (sameSolution(s, kept)) { duplicate = true; break; }
+        }
+        if (duplicate) continue;
+        solutions.append(s);
+        if (solutions.size() >= keep) break;
+    }
+    return solutions;
+}
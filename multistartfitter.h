@@ -0,0 +1,81 @@
+/*
+ * 文件名: multistartfitter.h
+ * 文件作用: 多起点全局拟合头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 在各拟合参数的上下限内按拉丁超立方生成起点 (跨多个数量级的正值参数在对数空间采样)，当前参数值固定作为第一个起点。
+ * 2. 各起点各用一个独立求解器运行 FittingCore，在线程池中并发执行。
+ * 3. 迭代若干步后误差仍远大于当前最优的起点提前停止 (淘汰)，节省计算量。
+ * 4. 结果按误差排序并去除收敛到同一点的重复解，返回最优的 K 组。
+ * 5. 可设置产量历史，各起点均做变产量 (叠加) 拟合。
+ */
+
+#ifndef MULTISTARTFITTER_H
+#define MULTISTARTFITTER_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include <functional>
+#include "fittingcore.h"
+
+class MultiStartFitter
+{
+public:
+    struct Options {
+        int seedCount = 16;             // 起点个数 (含当前参数值)
+        int keepBest = 5;               // 返回的最优解个数
+        quint32 randomSeed = 12345;     // 采样随机种子，相同种子得到相同起点
+        int pruneAfterSteps = 5;        // 接受步数达到该值后开始淘汰检查
+        double pruneFactor = 10.0;      // 误差超过当前最优的该倍数时淘汰
+        FittingCore::Options fit;       // 单个起点的拟合选项
+    };
+
+    // 单个起点的拟合结果
+    struct Solution {
+        QMap<QString, double> params;
+        double mse = 0.0;
+        int iterations = 0;
+        int seedIndex = 0;
+        bool pruned = false;            // 是否被提前淘汰
+    };
+
+    using SolverFactory = std::function<QSharedPointer<ModelSolver01_06>()>;
+    // 出现新的全局最优时调用 (在工作线程中)，curve 为该解在默认时间网格上的理论曲线 (有产量历史时为观测时间上的叠加曲线)
+    using ImprovementCallback = std::function<void(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)>;
+    using ProgressCallback = std::function<void(int finished, int total)>;
+    using StopPredicate = std::function<bool()>;
+
+    explicit MultiStartFitter(SolverFactory factory);
+
+    void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv);
+    void setRateSchedule(const RateSuperposition::Schedule& schedule) { m_rateSchedule = schedule; }
+    // 时间窗口权重与屏蔽点 (见 FittingCore::setFitWindows)
+    void setFitWindows(const FitWindows& windows) { m_windows = windows; }
+    void setImprovementCallback(ImprovementCallback cb) { m_onImprovement = cb; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    // 运行全部起点，返回按误差升序排列、去重后的最优解 (最多 keepBest 个)
+    QList<Solution> run(const QList<FitParameter>& params, const Options& options);
+
+    // 拉丁超立方采样：count 个 dims 维单位立方体内的点，每一维的 count 个分层各恰好落一个点
+    static QVector<QVector<double>> latinHypercube(int count, int dims, quint32 seed);
+    // 正值且跨一个数量级以上的参数 (S、nf 除外) 在对数空间采样
+    static bool sampleInLogSpace(const FitParameter& p);
+
+private:
+    SolverFactory m_factory;
+    QVector<double> m_obsTime;
+    QVector<double> m_obsDeltaP;
+    QVector<double> m_obsDerivative;
+    RateSuperposition::Schedule m_rateSchedule;
+    FitWindows m_windows;
+
+    ImprovementCallback m_onImprovement;
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+};
+
+#endif // MULTISTARTFITTER_H
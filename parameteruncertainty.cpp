@@ -0,0 +1,277 @@
+/*
+ * 文件名: parameteruncertainty.cpp
+ * 文件作用: 拟合参数不确定性分析实现
+ * 功能描述:
+ * 1. 线性化：JᵀJ 做对称特征分解，远小于最大特征值的方向视为不可辨识，伪逆只保留其余方向。
+ * 2. 自助法：压差与导数残差使用同一组块起点重抽样，保留两者之间及相邻点之间的相关性。
+ * 3. 自助法样本拟合时不使用目标误差提前结束 (初值即为原拟合结果，否则样本可能一步不动)。
+ * 4. 区间端点换回物理量后截断到参数上下限。
+ */
+
+#include "parameteruncertainty.h"
+
+#include <QtConcurrent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 标准正态分布的 90% 分位数
+const double Z90 = 1.2815515655446004;
+// 特征值低于最大特征值的该倍数时视为不可辨识方向
+const double EIGEN_TOLERANCE = 1e-10;
+
+double toPhysical(const FitParameter& p, bool logScale, double x)
+{
+    double v = logScale ? std::pow(10.0, x) : x;
+    return qBound(p.min, v, p.max);
+}
+}
+
+ParameterUncertainty::ParameterUncertainty(SolverFactory factory)
+    : m_factory(factory)
+{
+}
+
+void ParameterUncertainty::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv)
+{
+    m_obsTime = t;
+    m_obsDeltaP = deltaP;
+    m_obsDerivative = deriv;
+}
+
+ParameterUncertainty::Interval ParameterUncertainty::Result::interval(const QString& name) const
+{
+    for (const Interval& i : intervals) {
+        if (i.name == name) return i;
+    }
+    return Interval();
+}
+
+double ParameterUncertainty::quantile(QVector<double> values, double q)
+{
+    if (values.isEmpty()) return std::numeric_limits<double>::quiet_NaN();
+    std::sort(values.begin(), values.end());
+    double pos = qBound(0.0, q, 1.0) * (values.size() - 1);
+    int k = (int)std::floor(pos);
+    if (k + 1 >= values.size()) return values.last();
+    double s = pos - k;
+    return values[k] * (1.0 - s) + values[k + 1] * s;
+}
+
+ParameterUncertainty::Result ParameterUncertainty::run(const QList<FitParameter>& fitted, const Options& options)
+{
+    if (!m_factory || m_obsTime.isEmpty()) return Result();
+    if (options.method == ResidualBootstrap) return runBootstrap(fitted, options);
+    return runLinearized(fitted, options);
+}
+
+ParameterUncertainty::Result ParameterUncertainty::runLinearized(const QList<FitParameter>& fitted, const Options& options)
+{
+    Result result;
+    result.method = Linearized;
+
+    FittingCore core(m_factory());
+    core.setObservedData(m_obsTime, m_obsDeltaP, m_obsDerivative);
+    core.setRateSchedule(m_rateSchedule);
+    core.setFitWindows(m_windows);
+    Eigen::VectorXd r;
+    Eigen::MatrixXd J;
+    if (!core.linearize(fitted, options.weight, options.fit.highPrecision, r, J)) return result;
+
+    const int m = r.size();
+    const int n = J.cols();
+    double sigma2 = r.squaredNorm() / qMax(1, m - n);
+    // 报告的残差标准差与自助法一致：压差段的对数残差 (去掉权重)
+    const int np = qMin(qMin(m_obsDeltaP.size(), m_obsTime.size()), m);
+    if (np > 0 && options.weight > 0.0) result.residualSigma = std::sqrt(r.head(np).squaredNorm() / np) / options.weight;
+
+    // 协方差 σ² (JᵀJ)⁺：不可辨识方向不参与求逆，相关参数标记为不可辨识
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(J.transpose() * J);
+    const Eigen::VectorXd& lambda = eig.eigenvalues();
+    const Eigen::MatrixXd& V = eig.eigenvectors();
+    double tol = EIGEN_TOLERANCE * qMax(lambda.maxCoeff(), 0.0);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(n, n);
+    QVector<bool> identifiable(n, true);
+    for (int k = 0; k < n; ++k) {
+        if (lambda[k] > tol && lambda[k] > 0.0) {
+            cov += (sigma2 / lambda[k]) * V.col(k) * V.col(k).transpose();
+            continue;
+        }
+        for (int j = 0; j < n; ++j) {
+            if (std::abs(V(j, k)) > 0.1) identifiable[j] = false;
+        }
+    }
+
+    int column = 0;
+    for (const FitParameter& p : fitted) {
+        if (!p.isFit) continue;
+        Interval interval;
+        interval.name = p.name;
+        interval.logScale = FittingCore::optimizesInLogSpace(p);
+        interval.identifiable = identifiable[column];
+        double x = interval.logScale ? std::log10(p.value) : p.value;
+        double s = std::sqrt(qMax(0.0, cov(column, column)));
+        interval.p50 = p.value;
+        if (interval.identifiable) {
+            interval.p90 = toPhysical(p, interval.logScale, x - Z90 * s);
+            interval.p10 = toPhysical(p, interval.logScale, x + Z90 * s);
+        } else {
+            interval.p90 = p.min;
+            interval.p10 = p.max;
+        }
+        result.intervals.append(interval);
+        ++column;
+    }
+    result.valid = true;
+    if (m_onProgress) m_onProgress(1, 1);
+    return result;
+}
+
+ParameterUncertainty::Result ParameterUncertainty::runBootstrap(const QList<FitParameter>& fitted, const Options& options)
+{
+    Result result;
+    result.method = ResidualBootstrap;
+
+    QMap<QString, double> bestMap;
+    QVector<int> fitIndices;
+    QVector<bool> logScale;
+    for (int i = 0; i < fitted.size(); ++i) {
+        bestMap.insert(fitted[i].name, fitted[i].value);
+        if (!fitted[i].isFit) continue;
+        fitIndices.append(i);
+        logScale.append(FittingCore::optimizesInLogSpace(fitted[i]));
+    }
+    const int dims = fitIndices.size();
+    if (dims == 0) return result;
+
+    // 拟合曲线与对数残差 (无法取对数或时间窗口权重为 0 的点不参与重抽样，合成数据中保留观测值)
+    FittingCore base(m_factory());
+    base.setObservedData(m_obsTime, m_obsDeltaP, m_obsDerivative);
+    base.setRateSchedule(m_rateSchedule);
+    ModelCurveData curve = base.evaluateCurve(bestMap, options.fit.highPrecision);
+    const QVector<double>& pCal = std::get<1>(curve);
+    const QVector<double>& dCal = std::get<2>(curve);
+    const int n = qMin(m_obsDeltaP.size(), pCal.size());
+    const int nd = qMin(qMin(m_obsDerivative.size(), dCal.size()), n);
+    if (n < 2) return result;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    QVector<double> ep(n, nan), ed(n, nan);
+    double sse = 0.0;
+    int used = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!(m_windows.weightAt(m_obsTime[i]) > 0)) continue;
+        if (m_obsDeltaP[i] > 1e-10 && pCal[i] > 1e-10) {
+            ep[i] = std::log(m_obsDeltaP[i] / pCal[i]);
+            sse += ep[i] * ep[i];
+            ++used;
+        }
+        if (i < nd && m_obsDerivative[i] > 1e-10 && dCal[i] > 1e-10) ed[i] = std::log(m_obsDerivative[i] / dCal[i]);
+    }
+    result.residualSigma = used > 0 ? std::sqrt(sse / used) : 0.0;
+
+    const int block = options.blockLength > 0 ? qMin(options.blockLength, n)
+                                              : qMax(1, (int)std::lround(std::cbrt((double)n)));
+    const int sampleCount = qMax(1, options.samples);
+
+    FittingCore::Options fitOptions = options.fit;
+    fitOptions.targetMse = 0.0;
+    fitOptions.weight = options.weight;
+
+    // 求解器在调用线程中创建 (blockingMap 的调用线程也参与计算，比线程数多一个)，样本取用空闲求解器，没有时等待
+    QThreadPool* pool = QThreadPool::globalInstance();
+    int solverCount = qMin(sampleCount, pool->maxThreadCount() + 1);
+    QVector<QSharedPointer<ModelSolver01_06>> idleSolvers;
+    for (int i = 0; i < solverCount; ++i) idleSolvers.append(m_factory());
+    QMutex solverMutex;
+    QWaitCondition solverReleased;
+
+    QVector<QVector<double>> samples(sampleCount);
+    QAtomicInt finished(0);
+
+    auto runSample = [&](int index) {
+        if (m_stopRequested && m_stopRequested()) return;
+
+        std::seed_seq seq{ options.randomSeed, (quint32)index };
+        std::mt19937 rng(seq);
+        std::uniform_int_distribution<int> startDist(0, n - block);
+        QVector<double> synthP = m_obsDeltaP.mid(0, n);
+        QVector<double> synthD = m_obsDerivative.mid(0, nd);
+        for (int i = 0; i < n; i += block) {
+            int start = startDist(rng);
+            for (int k = 0; k < block && i + k < n; ++k) {
+                int target = i + k, source = start + k;
+                if (std::isfinite(ep[target]) && std::isfinite(ep[source])) synthP[target] = pCal[target] * std::exp(ep[source]);
+                if (target < nd && std::isfinite(ed[target]) && source < nd && std::isfinite(ed[source]))
+                    synthD[target] = dCal[target] * std::exp(ed[source]);
+            }
+        }
+
+        QSharedPointer<ModelSolver01_06> solver;
+        {
+            QMutexLocker locker(&solverMutex);
+            while (idleSolvers.isEmpty()) solverReleased.wait(&solverMutex);
+            solver = idleSolvers.takeLast();
+        }
+        FittingCore core(solver);
+        core.setObservedData(m_obsTime.mid(0, n), synthP, synthD);
+        core.setRateSchedule(m_rateSchedule);
+        core.setFitWindows(m_windows);
+        core.setStopPredicate(m_stopRequested);
+        FittingCore::Result r = core.run(fitted, fitOptions);
+        {
+            QMutexLocker locker(&solverMutex);
+            idleSolvers.append(solver);
+        }
+        solverReleased.wakeOne();
+
+        bool stopped = m_stopRequested && m_stopRequested();
+        if (!stopped && std::isfinite(r.mse)) {
+            QVector<double> x(dims);
+            for (int k = 0; k < dims; ++k) {
+                double v = r.params.value(fitted[fitIndices[k]].name);
+                x[k] = logScale[k] ? std::log10(qMax(v, 1e-300)) : v;
+            }
+            samples[index] = x;
+        }
+
+        int done = finished.fetchAndAddOrdered(1) + 1;
+        if (m_onProgress) m_onProgress(done, sampleCount);
+    };
+
+    QVector<int> indices(sampleCount);
+    for (int i = 0; i < sampleCount; ++i) indices[i] = i;
+    QtConcurrent::blockingMap(pool, indices, runSample);
+
+    QVector<QVector<double>> columns(dims);
+    for (const QVector<double>& x : samples) {
+        if (x.size() != dims) {
+            ++result.failed;
+            continue;
+        }
+        ++result.samples;
+        for (int k = 0; k < dims; ++k) columns[k].append(x[k]);
+    }
+    if (result.samples == 0) return result;
+
+    for (int k = 0; k < dims; ++k) {
+        const FitParameter& p = fitted[fitIndices[k]];
+        Interval interval;
+        interval.name = p.name;
+        interval.logScale = logScale[k];
+        interval.p90 = toPhysical(p, logScale[k], quantile(columns[k], 0.1));
+        interval.p50 = toPhysical(p, logScale[k], quantile(columns[k], 0.5));
+        interval.p10 = toPhysical(p, logScale[k], quantile(columns[k], 0.9));
+        result.intervals.append(interval);
+    }
+    result.valid = true;
+    return result;
+}
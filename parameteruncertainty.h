@@ -0,0 +1,95 @@
+/*
+ * 文件名: parameteruncertainty.h
+ * 文件作用: 拟合参数不确定性分析头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 线性化协方差：在拟合结果处计算雅可比 J，协方差 σ²(JᵀJ)⁻¹，σ² 由残差平方和按自由度估计；
+ *    对数参数在 log10 空间按正态分布给出分位数，只需一次雅可比计算。
+ * 2. 残差自助法 (bootstrap)：拟合曲线加上按块重抽样的对数残差构成合成观测数据，各样本以拟合结果为初值重新拟合，
+ *    由全部样本的经验分布给出分位数；样本在线程池中并发拟合，每个工作线程独占一个求解器。
+ * 3. 每个样本的随机数由随机种子与样本序号确定，结果与线程调度无关，相同种子可重现。
+ * 4. 分位数采用储量评估的超越概率约定：P90 为低值 (90% 概率不低于该值)，P50 为中值，P10 为高值。
+ */
+
+#ifndef PARAMETERUNCERTAINTY_H
+#define PARAMETERUNCERTAINTY_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include <functional>
+#include "fittingcore.h"
+
+class ParameterUncertainty
+{
+public:
+    enum Method {
+        Linearized = 0,     // 线性化协方差
+        ResidualBootstrap   // 残差自助法重新拟合
+    };
+
+    struct Options {
+        Method method = Linearized;
+        double weight = 0.5;            // 压差残差权重 (与拟合一致)
+        int samples = 100;              // 自助法样本数
+        int blockLength = 0;            // 残差重抽样的块长 (点数)，<=0 时取观测点数的立方根
+        quint32 randomSeed = 12345;
+        FittingCore::Options fit;       // 各样本重新拟合的选项
+    };
+
+    // 单个拟合参数的分位数 (超越概率约定：p90 <= p50 <= p10)
+    struct Interval {
+        QString name;
+        double p90 = 0.0;
+        double p50 = 0.0;
+        double p10 = 0.0;
+        bool logScale = false;  // 是否在 log10 空间估计
+        bool identifiable = true; // 线性化时 JᵀJ 在该方向上接近奇异则为 false (区间不可信)
+    };
+
+    struct Result {
+        bool valid = false;
+        Method method = Linearized;
+        QList<Interval> intervals;      // 与拟合参数 (isFit) 的顺序一致
+        int samples = 0;                // 自助法成功拟合的样本数
+        int failed = 0;                 // 自助法拟合失败或被停止的样本数
+        double residualSigma = 0.0;     // 压差对数残差 ln(观测/拟合) 的标准差
+        Interval interval(const QString& name) const;
+    };
+
+    using SolverFactory = std::function<QSharedPointer<ModelSolver01_06>()>;
+    using ProgressCallback = std::function<void(int finished, int total)>;
+    using StopPredicate = std::function<bool()>;
+
+    explicit ParameterUncertainty(SolverFactory factory);
+
+    void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv);
+    void setRateSchedule(const RateSuperposition::Schedule& schedule) { m_rateSchedule = schedule; }
+    // 时间窗口权重与屏蔽点 (见 FittingCore::setFitWindows)
+    void setFitWindows(const FitWindows& windows) { m_windows = windows; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    // fitted 为拟合结果 (value 为最优值)，isFit 的参数给出区间
+    Result run(const QList<FitParameter>& fitted, const Options& options);
+
+    // 经验分位数 (线性插值)，q 为累积概率 0..1
+    static double quantile(QVector<double> values, double q);
+
+private:
+    Result runLinearized(const QList<FitParameter>& fitted, const Options& options);
+    Result runBootstrap(const QList<FitParameter>& fitted, const Options& options);
+
+    SolverFactory m_factory;
+    QVector<double> m_obsTime;
+    QVector<double> m_obsDeltaP;
+    QVector<double> m_obsDerivative;
+    RateSuperposition::Schedule m_rateSchedule;
+    FitWindows m_windows;
+
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+};
+
+#endif // PARAMETERUNCERTAINTY_H
@@ -0,0 +1,178 @@
+/*
+ * 文件名: performancelogdialog.cpp
+ * 文件作用: 拟合性能日志汇总对话框实现
+ * 功能描述:
+ * 1. 界面由代码构建，样式与性能统计面板一致 (白底黑字)。
+ * 2. 打开时读取一次日志；拟合在对话框打开期间完成时点“刷新”重新读取。
+ */
+
+#include "performancelogdialog.h"
+#include "modelsolver01-06.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+QTableWidgetItem* readOnlyItem(const QString& text)
+{
+    QTableWidgetItem* item = new QTableWidgetItem(text);
+    item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+    return item;
+}
+
+QString formatCost(double us)
+{
+    return us > 0 ? QString::number(us, 'f', 2) : QString("-");
+}
+
+} // namespace
+
+PerformanceLogDialog::PerformanceLogDialog(const QString& logPath, QWidget* parent)
+    : QDialog(parent), m_logPath(logPath)
+{
+    setWindowTitle("拟合性能日志");
+    resize(980, 680);
+    setStyleSheet("QDialog { background-color: white; color: black; font-family: \"Microsoft YaHei\", Arial; } "
+                  "QLabel { color: black; background: transparent; } "
+                  "QComboBox { color: black; background-color: white; } "
+                  "QTableWidget { color: black; background-color: white; gridline-color: #ddd; } "
+                  "QHeaderView::section { color: black; background-color: #f0f0f0; border: 1px solid #ddd; padding: 2px; } "
+                  "QPushButton { color: white; background-color: #4a90e2; border: none; border-radius: 4px; padding: 6px 12px; } "
+                  "QPushButton:hover { background-color: #357abd; }");
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    m_labelStatus = new QLabel;
+    m_labelStatus->setWordWrap(true);
+    mainLayout->addWidget(m_labelStatus);
+
+    QHBoxLayout* groupLayout = new QHBoxLayout;
+    m_comboGroup = new QComboBox;
+    m_comboGroup->addItem("模型 / 裂缝条数", FitPerformanceLog::ByModel);
+    m_comboGroup->addItem("Stehfest 阶数", FitPerformanceLog::ByStehfest);
+    m_comboGroup->addItem("反演方法", FitPerformanceLog::ByInversion);
+    m_comboGroup->addItem("抽稀密度", FitPerformanceLog::ByDecimation);
+    m_comboGroup->addItem("优化算法", FitPerformanceLog::ByAlgorithm);
+    groupLayout->addWidget(new QLabel("分组:"));
+    groupLayout->addWidget(m_comboGroup);
+    groupLayout->addStretch();
+    mainLayout->addLayout(groupLayout);
+
+    // 汇总表：各组中位数
+    m_tableSummary = new QTableWidget(0, 8);
+    m_tableSummary->setHorizontalHeaderLabels({ "分组", "次数", "偏慢", "耗时 (ms)", "迭代", "正演次数",
+                                                "µs / (正演·点)", "MSE" });
+    m_tableSummary->verticalHeader()->setVisible(false);
+    m_tableSummary->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_tableSummary->horizontalHeader()->setStretchLastSection(true);
+    m_tableSummary->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // 记录表：最新的在最上面
+    m_tableRecords = new QTableWidget(0, 15);
+    m_tableRecords->setHorizontalHeaderLabels({ "时间", "分析", "来源", "模型", "nf", "点数", "重采样", "N", "反演",
+                                                "算法", "迭代", "正演次数", "耗时 (ms)", "µs / (正演·点)", "SSE" });
+    m_tableRecords->verticalHeader()->setVisible(false);
+    m_tableRecords->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_tableRecords->horizontalHeader()->setStretchLastSection(true);
+    m_tableRecords->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QSplitter* splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(m_tableSummary);
+    splitter->addWidget(m_tableRecords);
+    mainLayout->addWidget(splitter, 1);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    QPushButton* btnRefresh = new QPushButton("刷新");
+    QPushButton* btnClear = new QPushButton("清空日志");
+    QPushButton* btnClose = new QPushButton("关闭");
+    btnClose->setStyleSheet("background-color: #6c757d; color: white;");
+    btnLayout->addStretch();
+    btnLayout->addWidget(btnRefresh);
+    btnLayout->addWidget(btnClear);
+    btnLayout->addWidget(btnClose);
+    mainLayout->addLayout(btnLayout);
+
+    connect(m_comboGroup, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int) { updateSummary(); });
+    connect(btnRefresh, &QPushButton::clicked, this, &PerformanceLogDialog::reload);
+    connect(btnClear, &QPushButton::clicked, this, &PerformanceLogDialog::onClear);
+    connect(btnClose, &QPushButton::clicked, this, &QDialog::close);
+
+    reload();
+}
+
+void PerformanceLogDialog::reload()
+{
+    m_records = FitPerformanceLog::load(m_logPath);
+    m_slow = FitPerformanceLog::flagSlow(m_records);
+
+    int slowCount = 0;
+    for (bool s : m_slow) slowCount += s ? 1 : 0;
+    if (m_logPath.isEmpty()) {
+        m_labelStatus->setText("项目尚未保存，拟合记录不会写入性能日志。");
+    } else {
+        m_labelStatus->setText(QString("%1\n共 %2 条记录，偏慢 %3 条 (同模型、同裂缝条数下每次正演每点耗时超过中位数 3 倍)")
+                                   .arg(m_logPath).arg(m_records.size()).arg(slowCount));
+    }
+    updateSummary();
+    updateRecords();
+}
+
+void PerformanceLogDialog::updateSummary()
+{
+    const auto groupBy = FitPerformanceLog::GroupBy(m_comboGroup->currentData().toInt());
+    const QVector<FitPerformanceLog::Summary> summaries = FitPerformanceLog::summarize(m_records, groupBy);
+    m_tableSummary->setRowCount(summaries.size());
+    for (int r = 0; r < summaries.size(); ++r) {
+        const FitPerformanceLog::Summary& s = summaries[r];
+        m_tableSummary->setItem(r, 0, readOnlyItem(s.key));
+        m_tableSummary->setItem(r, 1, readOnlyItem(QString::number(s.count)));
+        m_tableSummary->setItem(r, 2, readOnlyItem(QString::number(s.slowCount)));
+        m_tableSummary->setItem(r, 3, readOnlyItem(QString::number(s.medianWallMs, 'f', 0)));
+        m_tableSummary->setItem(r, 4, readOnlyItem(QString::number(s.medianIterations, 'f', 1)));
+        m_tableSummary->setItem(r, 5, readOnlyItem(QString::number(s.medianForwardSolves, 'f', 0)));
+        m_tableSummary->setItem(r, 6, readOnlyItem(formatCost(s.medianUsPerSolvePoint)));
+        m_tableSummary->setItem(r, 7, readOnlyItem(QString::number(s.medianMse, 'e', 3)));
+    }
+}
+
+void PerformanceLogDialog::updateRecords()
+{
+    const int n = m_records.size();
+    m_tableRecords->setRowCount(n);
+    const QColor slowColor(255, 220, 220);
+    for (int r = 0; r < n; ++r) {
+        const int i = n - 1 - r;
+        const FitPerformanceLog::Record& rec = m_records[i];
+        QStringList cells;
+        cells << rec.timestamp << rec.analysis << rec.source
+              << ModelSolver01_06::getModelName((ModelSolver01_06::ModelType)rec.modelType)
+              << QString::number(rec.nf)
+              << QString("%1 / %2").arg(rec.fitPoints).arg(rec.observedPoints)
+              << (rec.pointsPerCycle > 0 ? QString::number(rec.pointsPerCycle) : QString("-"))
+              << rec.stehfest << rec.inversion << rec.algorithm
+              << QString::number(rec.iterations) << QString::number(rec.forwardSolves)
+              << QString::number(rec.wallMs) << formatCost(rec.usPerSolvePoint())
+              << QString::number(rec.sse, 'e', 3);
+        for (int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = readOnlyItem(cells[c]);
+            if (m_slow[i]) item->setBackground(slowColor);
+            m_tableRecords->setItem(r, c, item);
+        }
+    }
+}
+
+void PerformanceLogDialog::onClear()
+{
+    if (m_records.isEmpty()) return;
+    if (QMessageBox::question(this, "清空日志", "确定删除全部性能记录吗？") != QMessageBox::Yes) return;
+    if (!FitPerformanceLog::clear(m_logPath)) QMessageBox::warning(this, "错误", "无法删除日志文件。");
+    reload();
+}
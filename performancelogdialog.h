@@ -0,0 +1,44 @@
+/*
+ * 文件名: performancelogdialog.h
+ * 文件作用: 拟合性能日志汇总对话框头文件
+ * 功能描述:
+ * 1. 读取项目性能日志 (FitPerformanceLog)，按模型、Stehfest 阶数、反演方法、抽稀密度或算法分组列出中位数。
+ * 2. 记录表按时间倒序列出每次拟合，偏慢记录 (同模型同裂缝条数下单位计算量耗时超过中位数 3 倍) 以浅红色标出。
+ * 3. 可刷新与清空日志。
+ */
+
+#ifndef PERFORMANCELOGDIALOG_H
+#define PERFORMANCELOGDIALOG_H
+
+#include <QDialog>
+#include <QVector>
+#include "fitperformancelog.h"
+
+class QComboBox;
+class QLabel;
+class QTableWidget;
+
+class PerformanceLogDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceLogDialog(const QString& logPath, QWidget* parent = nullptr);
+
+private:
+    void reload();
+    void updateSummary();
+    void updateRecords();
+    void onClear();
+
+    QString m_logPath;
+    QVector<FitPerformanceLog::Record> m_records;
+    QVector<bool> m_slow;
+
+    QLabel* m_labelStatus;
+    QComboBox* m_comboGroup;
+    QTableWidget* m_tableSummary;
+    QTableWidget* m_tableRecords;
+};
+
+#endif // PERFORMANCELOGDIALOG_H
@@ -14,7 +14,7 @@
 // 初始化静态计数器
 int PlottingDialog1::s_curveCounter = 1;
 
-PlottingDialog1::PlottingDialog1(QStandardItemModel* model, QWidget *parent) :
+PlottingDialog1::PlottingDialog1(MeasurementTableModel* model, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::PlottingDialog1),
     m_dataModel(model),
@@ -55,8 +55,8 @@ void PlottingDialog1::populateComboBoxes()
     if (!m_dataModel) return;
     QStringList headers;
     for(int i=0; i<m_dataModel->columnCount(); ++i) {
-        QStandardItem* item = m_dataModel->horizontalHeaderItem(i);
-        headers << (item ? item->text() : QString("列 %1").arg(i+1));
+        QString header = m_dataModel->headerText(i);
+        headers << (header.isNull() ? QString("列 %1").arg(i+1) : header);
     }
     ui->combo_XCol->addItems(headers);
     ui->combo_YCol->addItems(headers);
@@ -11,9 +11,9 @@
 #define PLOTTINGDIALOG2_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
 #include "qcustomplot.h"
+#include "measurementtablemodel.h"
 
 namespace Ui {
 class PlottingDialog2;
@@ -24,7 +24,7 @@ class PlottingDialog2 : public QDialog
     Q_OBJECT
 
 public:
-    explicit PlottingDialog2(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog2(MeasurementTableModel* model, QWidget *parent = nullptr);
     ~PlottingDialog2();
 
     // --- 全局设置 ---
@@ -66,7 +66,7 @@ private slots:
 
 private:
     Ui::PlottingDialog2 *ui;
-    QStandardItemModel* m_dataModel;
+    MeasurementTableModel* m_dataModel;
     static int s_counter;
 
     // 内部存储选中的颜色
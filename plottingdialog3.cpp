@@ -15,7 +15,7 @@
 int PlottingDialog3::s_counter = 1;
 
 // 构造函数实现
-PlottingDialog3::PlottingDialog3(QStandardItemModel* model, QWidget *parent) :
+PlottingDialog3::PlottingDialog3(MeasurementTableModel* model, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::PlottingDialog3),
     m_dataModel(model),
@@ -48,7 +48,12 @@ PlottingDialog3::PlottingDialog3(QStandardItemModel* model, QWidget *parent) :
     // 连接信号与槽
 
     // 1. 平滑复选框切换
+    for (int m = SignalFilter::MovingAverage; m <= SignalFilter::WaveletDenoise; ++m)
+        ui->comboSmoothMethod->addItem(SignalFilter::methodName(SignalFilter::Method(m)), m);
     connect(ui->checkSmooth, &QCheckBox::toggled, this, &PlottingDialog3::onSmoothToggled);
+    connect(ui->comboSmoothMethod, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        onSmoothToggled(ui->checkSmooth->isChecked());
+    });
     onSmoothToggled(ui->checkSmooth->isChecked()); // 初始化状态
 
     // 2. 试井类型切换（控制地层压力输入框）
@@ -76,8 +81,8 @@ void PlottingDialog3::populateComboBoxes()
     QStringList headers;
     // 遍历模型的水平表头，获取列名
     for(int i=0; i<m_dataModel->columnCount(); ++i) {
-        QStandardItem* item = m_dataModel->horizontalHeaderItem(i);
-        headers << (item ? item->text() : QString("列 %1").arg(i+1));
+        QString header = m_dataModel->headerText(i);
+        headers << (header.isNull() ? QString("列 %1").arg(i+1) : header);
     }
     // 将列名添加到下拉框中
     ui->comboTime->addItems(headers);
@@ -123,7 +128,11 @@ void PlottingDialog3::setupStyleOptions()
 // 平滑选项切换槽函数
 void PlottingDialog3::onSmoothToggled(bool checked)
 {
-    ui->spinSmooth->setEnabled(checked);
+    // 窗口点数用于移动平均与 Savitzky-Golay，窗口宽度用于对数时间平均
+    const SignalFilter::Method method = getSmoothMethod();
+    ui->comboSmoothMethod->setEnabled(checked);
+    ui->spinSmooth->setEnabled(checked && (method == SignalFilter::MovingAverage || method == SignalFilter::SavitzkyGolay));
+    ui->spinSmoothWindow->setEnabled(checked && method == SignalFilter::LogTimeAverage);
 }
 
 // 试井类型切换槽函数
@@ -179,6 +188,8 @@ double PlottingDialog3::getInitialPressure() const {
 double PlottingDialog3::getLSpacing() const { return ui->spinL->value(); }
 bool PlottingDialog3::isSmoothEnabled() const { return ui->checkSmooth->isChecked(); }
 int PlottingDialog3::getSmoothFactor() const { return ui->spinSmooth->value(); }
+SignalFilter::Method PlottingDialog3::getSmoothMethod() const { return SignalFilter::Method(ui->comboSmoothMethod->currentData().toInt()); }
+double PlottingDialog3::getSmoothWindow() const { return ui->spinSmoothWindow->value(); }
 QString PlottingDialog3::getXLabel() const { return ui->lineXLabel->text(); }
 QString PlottingDialog3::getYLabel() const { return ui->lineYLabel->text(); }
 
@@ -5,15 +5,17 @@
  * 1. 声明了用于配置曲线样式的对话框类。
  * 2. 提供获取用户设置（如试井类型、地层压力、曲线名称、图例、L-Spacing等）的接口。
  * 3. 管理界面交互逻辑，如颜色选择、试井类型切换带来的输入框状态变化等。
+ * 4. 导数平滑可选移动平均、对数时间窗口平均、Savitzky-Golay 与小波去噪 (SignalFilter)。
  */
 
 #ifndef PLOTTINGDIALOG3_H
 #define PLOTTINGDIALOG3_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
 #include "qcustomplot.h"
+#include "measurementtablemodel.h"
+#include "signalfilter.h"
 
 namespace Ui {
 class PlottingDialog3;
@@ -31,7 +33,7 @@ public:
     };
 
     // 构造函数：初始化对话框，接收数据模型用于列选择
-    explicit PlottingDialog3(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog3(MeasurementTableModel* model, QWidget *parent = nullptr);
     // 析构函数：释放UI资源
     ~PlottingDialog3();
 
@@ -52,6 +54,8 @@ public:
     double getLSpacing() const;         // 获取导数计算步长 L-Spacing
     bool isSmoothEnabled() const;       // 获取是否启用平滑处理
     int getSmoothFactor() const;        // 获取平滑因子
+    SignalFilter::Method getSmoothMethod() const; // 获取平滑方法
+    double getSmoothWindow() const;     // 获取对数时间窗口宽度 (对数周期)
 
     // --- 坐标轴标签接口 ---
     QString getXLabel() const;          // 获取X轴标签文本
@@ -88,7 +92,7 @@ private slots:
 
 private:
     Ui::PlottingDialog3 *ui;
-    QStandardItemModel* m_dataModel; // 指向数据源模型的指针
+    MeasurementTableModel* m_dataModel; // 指向数据源模型的指针
     static int s_counter;            // 静态计数器，用于生成默认的曲线名称
 
     // 内部成员变量：存储当前选择的颜色
@@ -11,7 +11,7 @@
 #include "ui_plottingdialog4.h"
 #include <QColorDialog>
 
-PlottingDialog4::PlottingDialog4(QStandardItemModel* model, QWidget *parent) :
+PlottingDialog4::PlottingDialog4(MeasurementTableModel* model, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::PlottingDialog4),
     m_dataModel(model)
@@ -10,9 +10,9 @@
 #define PLOTTINGDIALOG4_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
 #include "qcustomplot.h"
+#include "measurementtablemodel.h"
 
 namespace Ui {
 class PlottingDialog4;
@@ -24,7 +24,7 @@ class PlottingDialog4 : public QDialog
 
 public:
     // 构造函数
-    explicit PlottingDialog4(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog4(MeasurementTableModel* model, QWidget *parent = nullptr);
     ~PlottingDialog4();
 
     /**
@@ -74,7 +74,7 @@ private slots:
 
 private:
     Ui::PlottingDialog4 *ui;
-    QStandardItemModel* m_dataModel;
+    MeasurementTableModel* m_dataModel;
 
     QColor m_color1, m_lineColor1;
     QColor m_color2, m_lineColor2;
@@ -8,7 +8,8 @@
  */
 
 #include "pressurederivativecalculator.h"
-#include <QStandardItem>
+#include "derivativeengine.h"
+#include <QColor>
 #include <QRegularExpression>
 #include <QDebug>
 #include <cmath>
@@ -23,7 +24,7 @@ PressureDerivativeCalculator::~PressureDerivativeCalculator()
 }
 
 PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivative(
-    QStandardItemModel* model, const PressureDerivativeConfig& config)
+    MeasurementTableModel* model, const PressureDerivativeConfig& config)
 {
     PressureDerivativeResult result;
     result.success = false;
@@ -71,14 +72,13 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
     pressureData.reserve(rowCount);
 
     for (int row = 0; row < rowCount; ++row) {
-        QStandardItem* timeItem = model->item(row, config.timeColumnIndex);
-        QStandardItem* pressureItem = model->item(row, config.pressureColumnIndex);
+        // 数值列直接取值，文本列 (如带单位后缀) 再按文本解析
+        bool okT = false, okP = false;
+        double timeValue = model->value(row, config.timeColumnIndex, &okT);
+        double pressureValue = model->value(row, config.pressureColumnIndex, &okP);
 
-        double timeValue = 0.0;
-        double pressureValue = 0.0;
-
-        if (timeItem) timeValue = parseNumericValue(timeItem->text());
-        if (pressureItem) pressureValue = parseNumericValue(pressureItem->text());
+        if (!okT) timeValue = parseNumericValue(model->text(row, config.timeColumnIndex));
+        if (!okP) pressureValue = parseNumericValue(model->text(row, config.pressureColumnIndex));
 
         // 检查时间值有效性
         if (timeValue < 0) {
@@ -165,14 +165,12 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
     model->insertColumn(deltaPColIdx);
 
     QString deltaPHeader = QString("压差(Delta P)\\%1").arg(config.pressureUnit);
-    model->setHorizontalHeaderItem(deltaPColIdx, new QStandardItem(deltaPHeader));
+    model->setHeaderData(deltaPColIdx, Qt::Horizontal, deltaPHeader);
 
     for (int row = 0; row < rowCount; ++row) {
-        QString val = formatValue(deltaPData[row], 6);
-        QStandardItem* item = new QStandardItem(val);
-        item->setForeground(QBrush(QColor("darkgreen"))); // 绿色文字区分压差
-        model->setItem(row, deltaPColIdx, item);
+        model->setText(row, deltaPColIdx, formatValue(deltaPData[row], 6));
     }
+    model->setColumnForeground(deltaPColIdx, QColor("darkgreen")); // 绿色文字区分压差
     // 记录压差列索引
     result.deltaPColumnIndex = deltaPColIdx;
     result.deltaPColumnName = deltaPHeader;
@@ -183,15 +181,13 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
     model->insertColumn(derivColIdx);
 
     QString derivHeader = QString("压力导数\\%1").arg(config.pressureUnit);
-    model->setHorizontalHeaderItem(derivColIdx, new QStandardItem(derivHeader));
+    model->setHeaderData(derivColIdx, Qt::Horizontal, derivHeader);
 
     for (int row = 0; row < rowCount; ++row) {
-        QString val = formatValue(derivativeData[row], 6);
-        QStandardItem* item = new QStandardItem(val);
-        item->setForeground(QBrush(QColor("#1565C0"))); // 蓝色文字区分导数
-        model->setItem(row, derivColIdx, item);
+        model->setText(row, derivColIdx, formatValue(derivativeData[row], 6));
         result.processedRows++;
     }
+    model->setColumnForeground(derivColIdx, QColor("#1565C0")); // 蓝色文字区分导数
 
     // 记录导数列索引
     result.derivativeColumnIndex = derivColIdx;
@@ -210,131 +206,16 @@ PressureDerivativeResult PressureDerivativeCalculator::calculatePressureDerivati
     return result;
 }
 
-// 静态方法实现：Bourdet 导数核心算法
+// 静态方法实现：Bourdet 导数 (算法实现见 DerivativeEngine，各模块统一调用)
 QVector<double> PressureDerivativeCalculator::calculateBourdetDerivative(
     const QVector<double>& timeData,
     const QVector<double>& pressureDropData,
     double lSpacing)
 {
-    QVector<double> derivativeData;
-    int n = timeData.size();
-    derivativeData.reserve(n);
-
-    if (n == 0) return derivativeData;
-
-    for (int i = 0; i < n; ++i) {
-        double derivative = 0.0;
-        double ti = timeData[i];
-        double pi = pressureDropData[i];
-
-        // 寻找左侧点j：ln(ti) - ln(tj) ≥ L
-        int leftIndex = findLeftPoint(timeData, i, lSpacing);
-
-        // 寻找右侧点k：ln(tk) - ln(ti) ≥ L
-        int rightIndex = findRightPoint(timeData, i, lSpacing);
-
-        // 1. 如果找到左右两个点，使用加权平均法 (Bourdet Standard)
-        if (leftIndex >= 0 && rightIndex >= 0) {
-            double tj = timeData[leftIndex];
-            double pj = pressureDropData[leftIndex];
-            double tk = timeData[rightIndex];
-            double pk = pressureDropData[rightIndex];
-
-            // 计算对数差值
-            double deltaXL = std::log(ti) - std::log(tj);
-            double deltaXR = std::log(tk) - std::log(ti);
-
-            // 计算左导数和右导数
-            double mL = calculateDerivativeValue(ti, tj, pi, pj);
-            double mR = calculateDerivativeValue(tk, ti, pk, pi);
-
-            // 加权平均公式
-            if (deltaXL + deltaXR > 1e-12) {
-                derivative = (mL * deltaXR + mR * deltaXL) / (deltaXL + deltaXR);
-            } else {
-                derivative = 0.0;
-            }
-        }
-        // 2. 边界情况：只找到左侧点 (曲线末端)
-        else if (leftIndex >= 0 && rightIndex < 0) {
-            double tj = timeData[leftIndex];
-            double pj = pressureDropData[leftIndex];
-            derivative = calculateDerivativeValue(ti, tj, pi, pj);
-        }
-        // 3. 边界情况：只找到右侧点 (曲线开端)
-        else if (leftIndex < 0 && rightIndex >= 0) {
-            double tk = timeData[rightIndex];
-            double pk = pressureDropData[rightIndex];
-            derivative = calculateDerivativeValue(tk, ti, pk, pi);
-        }
-        // 4. L-Spacing 范围内点不足
-        else {
-            // 使用简单的相邻点差分作为保底
-            if (i > 0) {
-                double t_prev = timeData[i-1];
-                double p_prev = pressureDropData[i-1];
-                derivative = calculateDerivativeValue(ti, t_prev, pi, p_prev);
-            } else if (i < n - 1) {
-                double t_next = timeData[i+1];
-                double p_next = pressureDropData[i+1];
-                derivative = calculateDerivativeValue(t_next, ti, p_next, pi);
-            } else {
-                derivative = 0.0;
-            }
-        }
-
-        // 导数结果取绝对值（双对数图要求正值）
-        derivativeData.append(std::abs(derivative));
-    }
-
-    return derivativeData;
-}
-
-int PressureDerivativeCalculator::findLeftPoint(const QVector<double>& timeData, int currentIndex, double lSpacing)
-{
-    if (currentIndex <= 0 || timeData.isEmpty()) return -1;
-    double ti = timeData[currentIndex];
-    if (ti <= 0) return -1;
-    double lnTi = std::log(ti);
-
-    for (int j = currentIndex - 1; j >= 0; --j) {
-        double tj = timeData[j];
-        if (tj <= 0) continue;
-        double lnTj = std::log(tj);
-        if ((lnTi - lnTj) >= lSpacing) return j;
-    }
-    return -1;
-}
-
-int PressureDerivativeCalculator::findRightPoint(const QVector<double>& timeData, int currentIndex, double lSpacing)
-{
-    int n = timeData.size();
-    if (currentIndex >= n - 1 || timeData.isEmpty()) return -1;
-    double ti = timeData[currentIndex];
-    if (ti <= 0) return -1;
-    double lnTi = std::log(ti);
-
-    for (int k = currentIndex + 1; k < n; ++k) {
-        double tk = timeData[k];
-        if (tk <= 0) continue;
-        double lnTk = std::log(tk);
-        if ((lnTk - lnTi) >= lSpacing) return k;
-    }
-    return -1;
-}
-
-double PressureDerivativeCalculator::calculateDerivativeValue(double t1, double t2, double p1, double p2)
-{
-    if (t1 <= 0 || t2 <= 0) return 0.0;
-    double lnT1 = std::log(t1);
-    double lnT2 = std::log(t2);
-    double deltaLnT = lnT1 - lnT2;
-
-    if (std::abs(deltaLnT) < 1e-10) return 0.0;
-    return (p1 - p2) / deltaLnT;
+    return DerivativeEngine::bourdet(timeData, pressureDropData, lSpacing);
 }
 
-PressureDerivativeConfig PressureDerivativeCalculator::autoDetectColumns(QStandardItemModel* model)
+PressureDerivativeConfig PressureDerivativeCalculator::autoDetectColumns(MeasurementTableModel* model)
 {
     PressureDerivativeConfig config;
     if (!model) return config;
@@ -343,14 +224,13 @@ PressureDerivativeConfig PressureDerivativeCalculator::autoDetectColumns(QStanda
     return config;
 }
 
-int PressureDerivativeCalculator::findPressureColumn(QStandardItemModel* model)
+int PressureDerivativeCalculator::findPressureColumn(MeasurementTableModel* model)
 {
     if (!model) return -1;
     QStringList pressureKeywords = {"压力", "pressure", "pres", "P\\", "压力\\"};
     for (int col = 0; col < model->columnCount(); ++col) {
-        QStandardItem* headerItem = model->horizontalHeaderItem(col);
-        if (headerItem) {
-            QString headerText = headerItem->text();
+        QString headerText = model->headerText(col);
+        if (!headerText.isNull()) {
             for (const QString& keyword : pressureKeywords) {
                 if (headerText.contains(keyword, Qt::CaseInsensitive)) {
                     if (!headerText.contains("压降") && !headerText.contains("导数") && !headerText.contains("Delta")) {
@@ -363,14 +243,13 @@ int PressureDerivativeCalculator::findPressureColumn(QStandardItemModel* model)
     return -1;
 }
 
-int PressureDerivativeCalculator::findTimeColumn(QStandardItemModel* model)
+int PressureDerivativeCalculator::findTimeColumn(MeasurementTableModel* model)
 {
     if (!model) return -1;
     QStringList timeKeywords = {"时间", "time", "t\\", "小时", "hour", "min", "sec"};
     for (int col = 0; col < model->columnCount(); ++col) {
-        QStandardItem* headerItem = model->horizontalHeaderItem(col);
-        if (headerItem) {
-            QString headerText = headerItem->text();
+        QString headerText = model->headerText(col);
+        if (!headerText.isNull()) {
             for (const QString& keyword : timeKeywords) {
                 if (headerText.contains(keyword, Qt::CaseInsensitive)) {
                     return col;
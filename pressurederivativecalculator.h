@@ -13,7 +13,7 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
-#include <QStandardItemModel>
+#include "measurementtablemodel.h"
 
 // 压力导数计算结果结构
 struct PressureDerivativeResult {
@@ -94,7 +94,7 @@ public:
      * @param config 计算配置
      * @return 计算结果
      */
-    PressureDerivativeResult calculatePressureDerivative(QStandardItemModel* model,
+    PressureDerivativeResult calculatePressureDerivative(MeasurementTableModel* model,
                                                          const PressureDerivativeConfig& config);
 
     /**
@@ -102,7 +102,7 @@ public:
      * @param model 数据模型
      * @return 配置对象，包含检测到的列索引
      */
-    PressureDerivativeConfig autoDetectColumns(QStandardItemModel* model);
+    PressureDerivativeConfig autoDetectColumns(MeasurementTableModel* model);
 
     // =========================================================================
     // 静态核心算法接口 (Saphir 风格 Bourdet 导数)
@@ -124,13 +124,8 @@ signals:
     void calculationCompleted(const PressureDerivativeResult& result);
 
 private:
-    // 内部静态辅助函数
-    static int findLeftPoint(const QVector<double>& timeData, int currentIndex, double lSpacing);
-    static int findRightPoint(const QVector<double>& timeData, int currentIndex, double lSpacing);
-    static double calculateDerivativeValue(double t1, double t2, double p1, double p2);
-
-    int findPressureColumn(QStandardItemModel* model);
-    int findTimeColumn(QStandardItemModel* model);
+    int findPressureColumn(MeasurementTableModel* model);
+    int findTimeColumn(MeasurementTableModel* model);
     double parseNumericValue(const QString& str);
     QString formatValue(double value, int precision = 6);
 };
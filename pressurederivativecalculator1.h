@@ -27,12 +27,12 @@ public:
      * @param smoothFactor 平滑因子（窗口大小，奇数）
      * @return 计算结果
      */
-    PressureDerivativeResult calculateSmoothedDerivative(QStandardItemModel* model,
+    PressureDerivativeResult calculateSmoothedDerivative(MeasurementTableModel* model,
                                                          const PressureDerivativeConfig& config,
                                                          int smoothFactor);
 
     /**
-     * @brief 移动平均平滑算法 (类似Matlab smooth)
+     * @brief 移动平均平滑算法 (类似Matlab smooth，前缀和实现，O(n))
      * @param data 原始数据
      * @param span 平滑窗口大小 (必须为正奇数，偶数会自动+1)
      * @return 平滑后的数据
@@ -0,0 +1,233 @@
+/*
+ * 文件名: profilerpanel.cpp
+ * 文件作用: 热路径性能统计面板实现
+ * 功能描述:
+ * 1. 界面由代码构建，样式与其他数据处理对话框一致 (白底黑字)。
+ * 2. 只在窗口显示期间每 500 ms 刷新一次；计数为全局值，同时进行的预览计算、其他拟合也计入。
+ */
+
+#include "profilerpanel.h"
+#include "hotpathprofiler.h"
+
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+const char* const kCounterLabels[HotPathProfiler::CounterCount] = {
+    "Laplace 求值", "Laplace 缓存命中", "Laplace 缓存未命中", "型曲线库命中", "型曲线库未命中",
+    "Bessel 函数", "积分节点", "裂缝方程组求解", "线性子问题求解", "残差求值", "雅可比列"
+};
+
+const char* const kScopeLabels[HotPathProfiler::ScopeCount] = {
+    "理论曲线", "曲线灵敏度", "残差", "雅可比", "线性子问题"
+};
+
+QString formatRate(double rate)
+{
+    return rate < 0 ? QString("-") : QString::number(rate * 100.0, 'f', 1) + " %";
+}
+
+QString formatScope(qint64 ns, qint64 calls)
+{
+    return QString("%1 ms / %2 次").arg(ns / 1e6, 0, 'f', 2).arg(calls);
+}
+
+QTableWidgetItem* readOnlyItem(const QString& text)
+{
+    QTableWidgetItem* item = new QTableWidgetItem(text);
+    item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+    return item;
+}
+
+} // namespace
+
+ProfilerPanel::ProfilerPanel(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("性能统计");
+    resize(760, 640);
+    setStyleSheet("QDialog { background-color: white; color: black; font-family: \"Microsoft YaHei\", Arial; } "
+                  "QLabel { color: black; background: transparent; } "
+                  "QCheckBox { color: black; background: transparent; } "
+                  "QTableWidget { color: black; background-color: white; gridline-color: #ddd; } "
+                  "QHeaderView::section { color: black; background-color: #f0f0f0; border: 1px solid #ddd; padding: 2px; } "
+                  "QPushButton { color: white; background-color: #4a90e2; border: none; border-radius: 4px; padding: 6px 12px; } "
+                  "QPushButton:hover { background-color: #357abd; }");
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    m_labelStatus = new QLabel;
+    m_labelStatus->setWordWrap(true);
+    m_labelHitRates = new QLabel;
+    mainLayout->addWidget(m_labelStatus);
+    mainLayout->addWidget(m_labelHitRates);
+
+    // 汇总表：计数与作用域耗时
+    m_tableTotals = new QTableWidget(HotPathProfiler::CounterCount + HotPathProfiler::ScopeCount, 3);
+    m_tableTotals->setHorizontalHeaderLabels({ "累计", "最近一次迭代", "平均每次迭代" });
+    QStringList rowLabels;
+    for (const char* label : kCounterLabels) rowLabels << label;
+    for (const char* label : kScopeLabels) rowLabels << QString("%1 耗时").arg(label);
+    m_tableTotals->setVerticalHeaderLabels(rowLabels);
+    m_tableTotals->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_tableTotals->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // 迭代表：每次迭代 (接受步) 的耗时与计数增量
+    m_tableIterations = new QTableWidget(0, 9);
+    m_tableIterations->setHorizontalHeaderLabels({ "迭代", "耗时 (ms)", "Laplace 求值", "缓存命中率", "Bessel 函数",
+                                                   "积分节点", "残差求值", "雅可比列", "线性子问题 (ms)" });
+    m_tableIterations->verticalHeader()->setVisible(false);
+    m_tableIterations->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_tableIterations->horizontalHeader()->setStretchLastSection(true);
+    m_tableIterations->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QSplitter* splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(m_tableTotals);
+    splitter->addWidget(m_tableIterations);
+    mainLayout->addWidget(splitter, 1);
+
+    // 底部：清零、时间线与导出
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    m_checkTrace = new QCheckBox("记录时间线");
+    m_checkTrace->setToolTip(QString("记录各作用域的起止时刻，每个线程最多 %1 个事件").arg(HotPathProfiler::MAX_TRACE_EVENTS));
+    m_checkTrace->setChecked(HotPathProfiler::isTraceEnabled());
+    QPushButton* btnReset = new QPushButton("清零");
+    QPushButton* btnExport = new QPushButton("导出 Chrome Trace...");
+    QPushButton* btnClose = new QPushButton("关闭");
+    btnClose->setStyleSheet("background-color: #6c757d; color: white;");
+    btnLayout->addWidget(m_checkTrace);
+    btnLayout->addStretch();
+    btnLayout->addWidget(btnReset);
+    btnLayout->addWidget(btnExport);
+    btnLayout->addWidget(btnClose);
+    mainLayout->addLayout(btnLayout);
+
+    const bool compiledIn = HotPathProfiler::isCompiledIn();
+    m_checkTrace->setEnabled(compiledIn);
+    btnExport->setEnabled(compiledIn);
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &ProfilerPanel::refresh);
+    connect(btnReset, &QPushButton::clicked, this, &ProfilerPanel::onReset);
+    connect(btnExport, &QPushButton::clicked, this, &ProfilerPanel::onExportTrace);
+    connect(btnClose, &QPushButton::clicked, this, &QDialog::close);
+    connect(m_checkTrace, &QCheckBox::toggled, this, &ProfilerPanel::onTraceToggled);
+}
+
+void ProfilerPanel::showEvent(QShowEvent* event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    m_refreshTimer->start();
+}
+
+void ProfilerPanel::hideEvent(QHideEvent* event)
+{
+    m_refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void ProfilerPanel::refresh()
+{
+    if (!HotPathProfiler::isCompiledIn()) {
+        m_labelStatus->setText("计算核心未以 WELLTEST_PROFILING 编译，计数与计时不可用 (以 qmake CONFIG+=profiling 构建)。");
+        m_labelHitRates->clear();
+        return;
+    }
+
+    const HotPathProfiler::Totals totals = HotPathProfiler::totals();
+    const QVector<HotPathProfiler::IterationRecord> iterations = HotPathProfiler::recentIterations();
+    const HotPathProfiler::Totals last = iterations.isEmpty() ? HotPathProfiler::Totals() : iterations.last().delta;
+
+    // 平均值按迭代表中的记录计算 (最多 MAX_ITERATION_RECORDS 次)
+    HotPathProfiler::Totals sum;
+    qint64 wallNs = 0;
+    for (const HotPathProfiler::IterationRecord& rec : iterations) {
+        for (int i = 0; i < HotPathProfiler::CounterCount; ++i) sum.counters[i] += rec.delta.counters[i];
+        for (int i = 0; i < HotPathProfiler::ScopeCount; ++i) {
+            sum.scopeNs[i] += rec.delta.scopeNs[i];
+            sum.scopeCalls[i] += rec.delta.scopeCalls[i];
+        }
+        wallNs += rec.wallNs;
+    }
+    const int n = iterations.size();
+
+    m_labelStatus->setText(QString("最近一次拟合: %1 次迭代，平均每次 %2 ms%3")
+                               .arg(n)
+                               .arg(n > 0 ? wallNs / 1e6 / n : 0.0, 0, 'f', 2)
+                               .arg(HotPathProfiler::isTraceEnabled()
+                                        ? QString("；时间线事件 %1 个").arg(HotPathProfiler::traceEventCount())
+                                        : QString()));
+    m_labelHitRates->setText(QString("Laplace 缓存命中率: 累计 %1，最近一次迭代 %2    型曲线库命中率: 累计 %3")
+                                 .arg(formatRate(totals.laplaceHitRate()))
+                                 .arg(formatRate(last.laplaceHitRate()))
+                                 .arg(formatRate(totals.typeCurveHitRate())));
+
+    for (int i = 0; i < HotPathProfiler::CounterCount; ++i) {
+        m_tableTotals->setItem(i, 0, readOnlyItem(QString::number(totals.counters[i])));
+        m_tableTotals->setItem(i, 1, readOnlyItem(QString::number(last.counters[i])));
+        m_tableTotals->setItem(i, 2, readOnlyItem(n > 0 ? QString::number(double(sum.counters[i]) / n, 'f', 1) : QString("-")));
+    }
+    for (int i = 0; i < HotPathProfiler::ScopeCount; ++i) {
+        const int row = HotPathProfiler::CounterCount + i;
+        m_tableTotals->setItem(row, 0, readOnlyItem(formatScope(totals.scopeNs[i], totals.scopeCalls[i])));
+        m_tableTotals->setItem(row, 1, readOnlyItem(formatScope(last.scopeNs[i], last.scopeCalls[i])));
+        m_tableTotals->setItem(row, 2, readOnlyItem(n > 0 ? QString("%1 ms").arg(sum.scopeNs[i] / 1e6 / n, 0, 'f', 2) : QString("-")));
+    }
+
+    // 最新的迭代在最上面
+    m_tableIterations->setRowCount(n);
+    for (int r = 0; r < n; ++r) {
+        const HotPathProfiler::IterationRecord& rec = iterations[n - 1 - r];
+        const qint64* c = rec.delta.counters;
+        m_tableIterations->setItem(r, 0, readOnlyItem(QString::number(rec.index)));
+        m_tableIterations->setItem(r, 1, readOnlyItem(QString::number(rec.wallNs / 1e6, 'f', 2)));
+        m_tableIterations->setItem(r, 2, readOnlyItem(QString::number(c[HotPathProfiler::LaplaceEvaluations])));
+        m_tableIterations->setItem(r, 3, readOnlyItem(formatRate(rec.delta.laplaceHitRate())));
+        m_tableIterations->setItem(r, 4, readOnlyItem(QString::number(c[HotPathProfiler::BesselCalls])));
+        m_tableIterations->setItem(r, 5, readOnlyItem(QString::number(c[HotPathProfiler::QuadratureNodes])));
+        m_tableIterations->setItem(r, 6, readOnlyItem(QString::number(c[HotPathProfiler::ResidualEvaluations])));
+        m_tableIterations->setItem(r, 7, readOnlyItem(QString::number(c[HotPathProfiler::JacobianColumns])));
+        m_tableIterations->setItem(r, 8, readOnlyItem(QString::number(rec.delta.scopeNs[HotPathProfiler::StepSolveScope] / 1e6, 'f', 3)));
+    }
+}
+
+void ProfilerPanel::onReset()
+{
+    HotPathProfiler::reset();
+    HotPathProfiler::clearTrace();
+    refresh();
+}
+
+void ProfilerPanel::onTraceToggled(bool enabled)
+{
+    HotPathProfiler::setTraceEnabled(enabled);
+    refresh();
+}
+
+void ProfilerPanel::onExportTrace()
+{
+    if (HotPathProfiler::traceEventCount() == 0 && HotPathProfiler::recentIterations().isEmpty()) {
+        QMessageBox::information(this, "提示", "还没有时间线记录。请勾选“记录时间线”后运行一次拟合。");
+        return;
+    }
+    QString path = QFileDialog::getSaveFileName(this, "导出 Chrome Trace", "welltest-trace.json", "Chrome Trace (*.json)");
+    if (path.isEmpty()) return;
+    QString error;
+    if (!HotPathProfiler::writeChromeTrace(path, &error)) {
+        QMessageBox::warning(this, "错误", "无法写入文件: " + error);
+        return;
+    }
+    QMessageBox::information(this, "完成", "已导出，可在 chrome://tracing 或 Perfetto 中打开。");
+}
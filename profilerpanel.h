@@ -0,0 +1,45 @@
+/*
+ * 文件名: profilerpanel.h
+ * 文件作用: 热路径性能统计面板头文件
+ * 功能描述:
+ * 1. 非模态窗口，定时读取 HotPathProfiler 的累计值与最近若干次迭代记录。
+ * 2. 汇总表列出各计数与作用域耗时 (累计、最近一次迭代、平均每次迭代)，以及 Laplace 缓存、型曲线库命中率。
+ * 3. 迭代表逐行列出每次迭代的耗时与计数增量；可清零、开启时间线并导出 Chrome Trace JSON。
+ */
+
+#ifndef PROFILERPANEL_H
+#define PROFILERPANEL_H
+
+#include <QDialog>
+
+class QCheckBox;
+class QLabel;
+class QTableWidget;
+class QTimer;
+
+class ProfilerPanel : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ProfilerPanel(QWidget* parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void refresh();
+    void onReset();
+    void onTraceToggled(bool enabled);
+    void onExportTrace();
+
+    QLabel* m_labelStatus;
+    QLabel* m_labelHitRates;
+    QTableWidget* m_tableTotals;
+    QTableWidget* m_tableIterations;
+    QCheckBox* m_checkTrace;
+    QTimer* m_refreshTimer;
+};
+
+#endif // PROFILERPANEL_H
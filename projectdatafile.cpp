@@ -0,0 +1,309 @@
+/*
+ * 文件名: projectdatafile.cpp
+ * 文件作用: 项目表格数据二进制文件 (_date.wtd) 读写实现
+ * 功能描述:
+ * 1. 文件结构：文件头 (标识、版本、列数、行数)、列目录 (类型、编码、表头、数据位置)、各列数据。
+ * 2. 写入时文本列和可压缩的数值列用 qCompress 压缩，经 QSaveFile 原子替换，避免保存中断损坏旧文件。
+ * 3. 读取时内存映射文件，未压缩的数值列直接整段拷贝到列缓冲区，不做任何文本解析。
+ * 4. 旧版 JSON 行数组按列判定数值/文本类型，转换为与文本导入相同的列式数据。
+ */
+
+#include "projectdatafile.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonObject>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// 文件头：标识 (8) + 版本 (4) + 列数 (4) + 行数 (8)，共 24 字节
+// 列目录 (每列)：类型 (1) + 编码 (1) + 保留 (2) + 表头字节数 (4) + 表头 UTF-8 (补齐到 8 字节)
+//               + 数据偏移 (8) + 存储字节数 (8) + 解压后字节数 (8)
+// 数据区：各列依次排列，每列起点 8 字节对齐，便于映射后直接按 double 访问
+const char kMagic[8] = {'W', 'T', 'D', 'A', 'T', 'A', '\r', '\n'};
+const quint32 kVersion = 1;
+const qint64 kHeaderSize = 24;
+
+enum ColumnType : quint8 { NumericColumn = 0, TextColumn = 1 };
+enum Encoding : quint8 { RawEncoding = 0, ZlibEncoding = 1 };
+
+inline qint64 align8(qint64 v) { return (v + 7) & ~qint64(7); }
+
+template <typename T>
+void appendLE(QByteArray& out, T v)
+{
+    T le = qToLittleEndian(v);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+}
+
+void padTo8(QByteArray& out)
+{
+    while (out.size() % 8) out.append('\0');
+}
+
+// 数值列按 little-endian 字节序编码
+QByteArray encodeNumbers(const std::vector<double>& values, int rows)
+{
+    QByteArray raw(qsizetype(rows) * 8, Qt::Uninitialized);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int r = 0; r < rows; ++r) {
+        double v = r < int(values.size()) ? values[r] : nan;
+        quint64 bits;
+        std::memcpy(&bits, &v, 8);
+        qToLittleEndian(bits, raw.data() + qsizetype(r) * 8);
+    }
+    return raw;
+}
+
+// 文本列逐行编码为 [UTF-8 字节数 (4)][UTF-8 字节]
+QByteArray encodeTexts(const std::vector<QString>& texts, int rows)
+{
+    QByteArray raw;
+    for (int r = 0; r < rows; ++r) {
+        QByteArray utf8 = r < int(texts.size()) ? texts[r].toUtf8() : QByteArray();
+        appendLE(raw, quint32(utf8.size()));
+        raw.append(utf8);
+    }
+    return raw;
+}
+
+} // namespace
+
+bool ProjectDataFile::write(const QString& filePath, const TextDataTable& table, bool compress, QString* errorMessage)
+{
+    struct ColumnBlob {
+        quint8 type;
+        quint8 encoding;
+        QByteArray header;
+        QByteArray stored;
+        const char* data;
+        qint64 storedSize;
+        qint64 rawSize;
+        qint64 offset;
+    };
+
+    int rows = table.rowCount;
+    int cols = int(qMax(table.columns.size(), table.headers.size()));
+    QVector<ColumnBlob> blobs(cols);
+
+    for (int c = 0; c < cols; ++c) {
+        ColumnBlob& b = blobs[c];
+        b.header = c < table.headers.size() ? table.headers[c].toUtf8() : QByteArray();
+        bool numeric = c >= table.columns.size() || table.columns[c].isNumeric;
+        b.type = numeric ? NumericColumn : TextColumn;
+        b.encoding = RawEncoding;
+
+        bool directNumbers = false;
+        if (numeric) {
+            // little-endian 平台上完整的数值列无需转换，直接写出列缓冲区
+            directNumbers = Q_BYTE_ORDER == Q_LITTLE_ENDIAN && c < table.columns.size()
+                            && int(table.columns[c].values.size()) == rows;
+            if (!directNumbers) {
+                b.stored = encodeNumbers(c < table.columns.size() ? table.columns[c].values : std::vector<double>(), rows);
+            }
+            b.rawSize = qint64(rows) * 8;
+        } else {
+            b.stored = encodeTexts(table.columns[c].texts, rows);
+            b.rawSize = b.stored.size();
+        }
+        b.data = directNumbers ? reinterpret_cast<const char*>(table.columns[c].values.data()) : b.stored.constData();
+
+        if (compress && b.rawSize > 0) {
+            // 文本列总是压缩；数值列 (如等间隔时间、重复的流量) 只有压缩后不足原大小 90% 才压缩
+            QByteArray packed = qCompress(reinterpret_cast<const uchar*>(b.data), qsizetype(b.rawSize), 1);
+            if (!numeric || packed.size() < b.rawSize * 9 / 10) {
+                b.stored = packed;
+                b.data = b.stored.constData();
+                b.encoding = ZlibEncoding;
+            }
+        }
+        b.storedSize = (b.encoding == RawEncoding && directNumbers) ? b.rawSize : b.stored.size();
+    }
+
+    // 目录定长，先计算大小，再依次分配各列的对齐偏移
+    qint64 directorySize = 0;
+    for (const ColumnBlob& b : blobs) directorySize += 8 + align8(b.header.size()) + 24;
+    qint64 offset = align8(kHeaderSize + directorySize);
+    for (ColumnBlob& b : blobs) {
+        b.offset = offset;
+        offset = align8(offset + b.storedSize);
+    }
+
+    QByteArray head;
+    head.append(kMagic, 8);
+    appendLE(head, kVersion);
+    appendLE(head, quint32(cols));
+    appendLE(head, qint64(rows));
+    for (const ColumnBlob& b : blobs) {
+        head.append(char(b.type));
+        head.append(char(b.encoding));
+        appendLE(head, quint16(0));
+        appendLE(head, quint32(b.header.size()));
+        head.append(b.header);
+        padTo8(head);
+        appendLE(head, b.offset);
+        appendLE(head, b.storedSize);
+        appendLE(head, b.rawSize);
+    }
+    padTo8(head);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = "无法写入文件: " + filePath;
+        return false;
+    }
+    file.write(head);
+    static const char zeros[8] = {0};
+    for (const ColumnBlob& b : blobs) {
+        qint64 pos = file.pos();
+        if (pos < b.offset) file.write(zeros, b.offset - pos);
+        file.write(b.data, b.storedSize);
+    }
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = "保存文件失败: " + filePath;
+        return false;
+    }
+    return true;
+}
+
+bool ProjectDataFile::read(const QString& filePath, TextDataTable& table, QString* errorMessage)
+{
+    table = TextDataTable();
+    auto fail = [&](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        table = TextDataTable();
+        return false;
+    };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return fail("无法打开文件: " + filePath);
+
+    qint64 size = file.size();
+    const uchar* data = size > 0 ? file.map(0, size) : nullptr;
+    QByteArray fallback;
+    if (!data) {
+        fallback = file.readAll();
+        data = reinterpret_cast<const uchar*>(fallback.constData());
+        size = fallback.size();
+    }
+
+    if (size < kHeaderSize || std::memcmp(data, kMagic, 8) != 0) return fail("不是有效的表格数据文件。");
+    quint32 version = qFromLittleEndian<quint32>(data + 8);
+    if (version > kVersion) return fail("表格数据文件版本过高，请升级软件。");
+    quint32 cols = qFromLittleEndian<quint32>(data + 12);
+    qint64 rows = qFromLittleEndian<qint64>(data + 16);
+    if (rows < 0 || rows > std::numeric_limits<int>::max()) return fail("表格数据文件已损坏。");
+
+    table.rowCount = int(rows);
+    table.headerProcessed = true;
+    table.columns.resize(int(qMin<quint32>(cols, quint32(size / 32))));
+    if (quint32(table.columns.size()) != cols) return fail("表格数据文件已损坏。");
+
+    qint64 pos = kHeaderSize;
+    for (quint32 c = 0; c < cols; ++c) {
+        if (pos + 8 > size) return fail("表格数据文件已损坏。");
+        quint8 type = data[pos];
+        quint8 encoding = data[pos + 1];
+        qint64 headerBytes = qFromLittleEndian<quint32>(data + pos + 4);
+        qint64 fixedEnd = pos + 8 + align8(headerBytes);
+        if (fixedEnd + 24 > size) return fail("表格数据文件已损坏。");
+        table.headers.append(QString::fromUtf8(reinterpret_cast<const char*>(data + pos + 8), int(headerBytes)));
+        qint64 offset = qFromLittleEndian<qint64>(data + fixedEnd);
+        qint64 storedSize = qFromLittleEndian<qint64>(data + fixedEnd + 8);
+        qint64 rawSize = qFromLittleEndian<qint64>(data + fixedEnd + 16);
+        pos = fixedEnd + 24;
+        if (offset < 0 || storedSize < 0 || offset + storedSize > size) return fail("表格数据文件已损坏。");
+
+        // 压缩列先解压，未压缩列直接引用映射内存
+        QByteArray unpacked;
+        const uchar* payload = data + offset;
+        if (encoding == ZlibEncoding) {
+            unpacked = qUncompress(payload, qsizetype(storedSize));
+            if (unpacked.size() != rawSize) return fail("表格数据文件已损坏。");
+            payload = reinterpret_cast<const uchar*>(unpacked.constData());
+        } else if (encoding != RawEncoding || storedSize != rawSize) {
+            return fail("表格数据文件已损坏。");
+        }
+
+        TextDataColumn& col = table.columns[int(c)];
+        if (type == NumericColumn) {
+            if (rawSize != rows * 8) return fail("表格数据文件已损坏。");
+            col.isNumeric = true;
+            col.values.resize(size_t(rows));
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            std::memcpy(col.values.data(), payload, size_t(rawSize));
+#else
+            for (qint64 r = 0; r < rows; ++r) {
+                quint64 bits = qFromLittleEndian<quint64>(payload + r * 8);
+                std::memcpy(&col.values[size_t(r)], &bits, 8);
+            }
+#endif
+        } else if (type == TextColumn) {
+            col.isNumeric = false;
+            col.texts.reserve(size_t(rows));
+            qint64 p = 0;
+            for (qint64 r = 0; r < rows; ++r) {
+                if (p + 4 > rawSize) return fail("表格数据文件已损坏。");
+                qint64 n = qFromLittleEndian<quint32>(payload + p);
+                p += 4;
+                if (p + n > rawSize) return fail("表格数据文件已损坏。");
+                col.texts.push_back(QString::fromUtf8(reinterpret_cast<const char*>(payload + p), int(n)));
+                p += n;
+            }
+        } else {
+            return fail("表格数据文件包含未知的列类型。");
+        }
+    }
+
+    table.success = true;
+    return true;
+}
+
+TextDataTable ProjectDataFile::fromJsonArray(const QJsonArray& array)
+{
+    TextDataTable table;
+    table.success = true;
+    if (array.isEmpty()) return table;
+
+    QJsonObject headerObj = array.first().toObject();
+    if (headerObj.contains("headers")) {
+        for (const QJsonValue& h : headerObj["headers"].toArray()) table.headers.append(h.toString());
+        table.headerProcessed = true;
+    }
+
+    QVector<QJsonArray> rows;
+    rows.reserve(array.size());
+    int cols = table.headers.size();
+    for (int i = 1; i < array.size(); ++i) {
+        QJsonObject rowObj = array[i].toObject();
+        if (!rowObj.contains("row_data")) continue;
+        rows.append(rowObj["row_data"].toArray());
+        cols = qMax(cols, int(rows.last().size()));
+    }
+    table.rowCount = rows.size();
+    table.columns.resize(cols);
+
+    // 与表格模型的写入规则一致：空白为缺失值，只要有一个非数值单元格整列按文本处理
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int c = 0; c < cols; ++c) {
+        TextDataColumn& col = table.columns[c];
+        col.values.reserve(size_t(rows.size()));
+        for (const QJsonArray& row : rows) {
+            QString text = c < row.size() ? row[c].toString() : QString();
+            QString trimmed = text.trimmed();
+            if (trimmed.isEmpty()) { col.values.push_back(nan); continue; }
+            bool ok = false;
+            double v = trimmed.toDouble(&ok);
+            if (!ok) { col.isNumeric = false; break; }
+            col.values.push_back(v);
+        }
+        if (!col.isNumeric) {
+            col.values = std::vector<double>();
+            col.texts.reserve(size_t(rows.size()));
+            for (const QJsonArray& row : rows) col.texts.push_back(c < row.size() ? row[c].toString() : QString());
+        }
+    }
+    return table;
+}
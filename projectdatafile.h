@@ -0,0 +1,33 @@
+/*
+ * 文件名: projectdatafile.h
+ * 文件作用: 项目表格数据二进制文件 (_date.wtd) 读写头文件
+ * 功能描述:
+ * 1. 按列存储表格数据：数值列为连续的 little-endian double，文本列为长度前缀的 UTF-8 字符串。
+ * 2. 各列可单独压缩 (zlib)，未压缩的数值列 8 字节对齐，读取时直接从映射内存整段拷贝。
+ * 3. 提供旧版 _date.json 行数组格式到列式数据的转换，旧格式只读不写。
+ */
+
+#ifndef PROJECTDATAFILE_H
+#define PROJECTDATAFILE_H
+
+#include <QString>
+#include <QJsonArray>
+#include "textdatareader.h" // TextDataTable 定义
+
+class ProjectDataFile
+{
+public:
+    /**
+     * @brief 写入二进制表格数据文件 (先写临时文件，成功后替换原文件)
+     * @param compress 是否尝试压缩各列；文本列压缩率高，数值列只在能明显变小时才压缩
+     */
+    static bool write(const QString& filePath, const TextDataTable& table, bool compress = true, QString* errorMessage = nullptr);
+
+    // 读取二进制表格数据文件，格式不符或数据损坏时返回 false
+    static bool read(const QString& filePath, TextDataTable& table, QString* errorMessage = nullptr);
+
+    // 旧版 _date.json 的 table_data 数组 (首项为 headers，其余为 row_data) 转为列式数据
+    static TextDataTable fromJsonArray(const QJsonArray& array);
+};
+
+#endif // PROJECTDATAFILE_H
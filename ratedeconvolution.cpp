@@ -0,0 +1,542 @@
+/*
+ * 文件名: ratedeconvolution.cpp
+ * 文件作用: 压力-产量反卷积实现
+ * 功能描述:
+ * 1. 响应表示：σ = ln t 的等距节点上 z 线性插值，p_u(t) = ∫ exp(z(σ)) dσ 逐段解析积分；
+ *    节点处的累积值与各段积分对 z 的偏导数每次求值只算一次，压力点对 z 的雅可比由后缀和得到，每对 (压力点, 产量段) 为 O(1)。
+ * 2. 叠加：p(t_j) = p0 - Σ_i (q_i - q_{i-1}) p_u(t_j - T_i)，对各段产量 q_i 是线性的。
+ * 3. 求解：阻尼 Gauss-Newton (Marquardt 对角阻尼)，法方程按压力点分块并发累加，规模为节点数 + 段数 + 1，直接 LDLT 求解。
+ * 4. 数据整理：产量先按容差合并、再自底向上合并产量最接近的相邻段直到段数上限；压力按 (流动段, 对数时间箱) 一次扫描取平均。
+ */
+
+#include "ratedeconvolution.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+namespace {
+
+// (e^x - 1) / x
+double phi(double x)
+{
+    if (std::abs(x) < 1e-3) return 1.0 + x * (0.5 + x * (1.0 / 6.0 + x / 24.0));
+    return std::expm1(x) / x;
+}
+
+// ∫_0^u v e^{a v} dv
+double psi(double a, double u)
+{
+    const double x = a * u;
+    if (std::abs(x) < 1e-3) return u * u * (0.5 + x * (1.0 / 3.0 + x * (0.125 + x / 30.0)));
+    return (std::exp(x) * (x - 1.0) + 1.0) / (a * a);
+}
+
+// 按时间排序的采样 (已按时间递增时不复制，只记录指针)
+struct SampleView {
+    const double* time = nullptr;
+    const double* value = nullptr;
+    int count = 0;
+    QVector<int> order;     // 时间不递增时的排序下标，为空表示按原顺序
+
+    SampleView(const double* t, const double* v, int n) : time(t), value(v), count(n)
+    {
+        double last = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < n; ++i) {
+            if (!std::isfinite(t[i]) || !std::isfinite(v[i])) continue;
+            if (t[i] < last) {
+                order.resize(n);
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [t](int a, int b) {
+                    // 非有限时间排在最后 (随后被跳过)
+                    if (!std::isfinite(t[a])) return false;
+                    if (!std::isfinite(t[b])) return true;
+                    return t[a] < t[b];
+                });
+                break;
+            }
+            last = t[i];
+        }
+    }
+    // 按时间顺序遍历有效采样
+    template <typename F> void forEach(F f) const
+    {
+        for (int k = 0; k < count; ++k) {
+            const int i = order.isEmpty() ? k : order[k];
+            if (std::isfinite(time[i]) && std::isfinite(value[i])) f(time[i], value[i]);
+        }
+    }
+};
+
+// 节点上的响应：累积值 P_k、各段积分 F_k 及其偏导数
+struct Response {
+    double sigma0 = 0.0;
+    double h = 1.0;
+    int nodes = 0;
+    std::vector<double> ez;     // exp(z_k)
+    std::vector<double> P;      // p_u(t_k)
+    std::vector<double> dF0;    // ∂F_k/∂z_k
+    std::vector<double> dF1;    // ∂F_k/∂z_{k+1}
+
+    void update(const double* z)
+    {
+        ez.resize(nodes);
+        P.resize(nodes);
+        dF0.assign(qMax(0, nodes - 1), 0.0);
+        dF1.assign(qMax(0, nodes - 1), 0.0);
+        for (int k = 0; k < nodes; ++k) ez[k] = std::exp(z[k]);
+        P[0] = ez[0];
+        for (int k = 0; k + 1 < nodes; ++k) {
+            const double a = z[k + 1] - z[k];
+            const double F = h * ez[k] * phi(a);
+            dF1[k] = h * ez[k] * psi(a, 1.0);
+            dF0[k] = F - dF1[k];
+            P[k + 1] = P[k] + F;
+        }
+    }
+
+    // p_u(τ)；cell 为累积值所在节点 (-1 表示在第一个节点之前)，d0/d1 为局部部分对 z_cell、z_{cell+1} 的偏导数
+    double evaluate(double tau, const double* z, int& cell, double& d0, double& d1) const
+    {
+        d0 = d1 = 0.0;
+        const double sigma = std::log(tau);
+        const double x = (sigma - sigma0) / h;
+        if (x <= 0.0) {
+            // 早于第一个节点：p_u ∝ t (导数与 p_u 相等)
+            cell = -1;
+            const double value = ez[0] * std::exp(sigma - sigma0);
+            d0 = value;
+            return value;
+        }
+        if (x >= nodes - 1) {
+            // 晚于最后一个节点：导数保持不变
+            cell = nodes - 1;
+            d0 = ez[cell] * (sigma - sigma0 - h * (nodes - 1));
+            return P[cell] + d0;
+        }
+        cell = qMin(int(x), nodes - 2);
+        const double u = x - cell;
+        const double a = z[cell + 1] - z[cell];
+        const double local = h * ez[cell] * u * phi(a * u);
+        d1 = h * ez[cell] * psi(a, u);
+        d0 = local - d1;
+        return P[cell] + local;
+    }
+};
+
+// 压力分箱
+struct PressureBins {
+    QVector<double> time, pressure;
+    int samples = 0;
+};
+
+PressureBins binPressure(const SampleView& view, const QVector<double>& starts, double minElapsed, int pointsPerCycle)
+{
+    PressureBins bins;
+    int period = -2, bin = -1, count = 0;
+    double sumT = 0.0, sumP = 0.0;
+    double firstTime = std::numeric_limits<double>::quiet_NaN();
+    int segment = -1;
+    auto flush = [&]() {
+        if (count > 0) {
+            bins.time.append(sumT / count);
+            bins.pressure.append(sumP / count);
+        }
+        count = 0;
+        sumT = sumP = 0.0;
+    };
+    view.forEach([&](double t, double p) {
+        ++bins.samples;
+        if (std::isnan(firstTime)) firstTime = t;
+        while (segment + 1 < starts.size() && starts[segment + 1] <= t) ++segment;
+        // 生产开始前的采样从第一个采样起分箱
+        const double origin = segment >= 0 ? starts[segment] : firstTime;
+        const double elapsed = t - origin;
+        const int b = elapsed < minElapsed ? 0 : 1 + int(std::floor(pointsPerCycle * std::log10(elapsed / minElapsed)));
+        if (segment != period || b != bin) {
+            flush();
+            period = segment;
+            bin = b;
+        }
+        sumT += t;
+        sumP += p;
+        ++count;
+    });
+    flush();
+    return bins;
+}
+
+// 产量合并到段数上限：自底向上每次合并一对相邻段，代价为合并后产量 (按体积守恒取平均) 的平方误差增量
+// d1·d2/(d1+d2)·(q1-q2)^2，产量变化大的边界 (如关井) 最后才被合并
+RateSuperposition::Schedule coarsenRates(const RateSuperposition::Schedule& in, double endTime, int maxSegments)
+{
+    const int n = in.startTime.size();
+    if (n <= maxSegments) return in;
+    std::vector<double> rate(in.rate.begin(), in.rate.end()), duration(n);
+    for (int i = 0; i < n; ++i) duration[i] = (i + 1 < n ? in.startTime[i + 1] : endTime) - in.startTime[i];
+    std::vector<int> next(n), prev(n), version(n, 0);
+    for (int i = 0; i < n; ++i) {
+        next[i] = i + 1 < n ? i + 1 : -1;
+        prev[i] = i - 1;
+    }
+    auto cost = [&](int a) {
+        const int b = next[a];
+        const double d = duration[a] + duration[b];
+        return d > 0 ? duration[a] * duration[b] / d * (rate[a] - rate[b]) * (rate[a] - rate[b]) : 0.0;
+    };
+    // (代价, 左段, 左段版本, 右段版本)；段被合并后版本加一，旧条目作废
+    using Entry = std::tuple<double, int, int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (int i = 0; i + 1 < n; ++i) queue.emplace(cost(i), i, 0, 0);
+    int segments = n;
+    while (segments > maxSegments && !queue.empty()) {
+        auto [c, a, va, vb] = queue.top();
+        queue.pop();
+        const int b = next[a];
+        if (b < 0 || version[a] != va || version[b] != vb) continue;
+        const double d = duration[a] + duration[b];
+        rate[a] = d > 0 ? (rate[a] * duration[a] + rate[b] * duration[b]) / d : rate[a];
+        duration[a] = d;
+        next[a] = next[b];
+        if (next[b] >= 0) prev[next[b]] = a;
+        version[b] = -1;
+        ++version[a];
+        --segments;
+        if (prev[a] >= 0) queue.emplace(cost(prev[a]), prev[a], version[prev[a]], version[a]);
+        if (next[a] >= 0) queue.emplace(cost(a), a, version[a], version[next[a]]);
+    }
+    RateSuperposition::Schedule out;
+    for (int i = 0; i >= 0; i = next[i]) {
+        out.startTime.append(in.startTime[i]);
+        out.rate.append(rate[i]);
+    }
+    return out;
+}
+
+} // namespace
+
+void RateDeconvolution::setPressureSamples(const double* time, const double* pressure, int count)
+{
+    m_pressureTime = time;
+    m_pressure = pressure;
+    m_pressureCount = (time && pressure) ? count : 0;
+}
+
+void RateDeconvolution::setRateSamples(const double* time, const double* rate, int count)
+{
+    m_rateTime = time;
+    m_rate = rate;
+    m_rateCount = (time && rate) ? count : 0;
+}
+
+RateDeconvolution::Result RateDeconvolution::run(const Options& options) const
+{
+    Result result;
+    QElapsedTimer clock;
+    clock.start();
+    auto stopped = [&]() { return m_stopRequested && m_stopRequested(); };
+
+    // ---------------- 产量：合并为阶梯产量 ----------------
+    SampleView rateView(m_rateTime, m_rate, m_rateCount);
+    double rateScale = 0.0;
+    rateView.forEach([&](double, double q) {
+        rateScale = qMax(rateScale, std::abs(q));
+        ++result.rateSamples;
+    });
+    if (result.rateSamples == 0 || rateScale <= 0) {
+        result.error = "没有有效的产量记录";
+        return result;
+    }
+    const double rateTolerance = options.rateTolerance * rateScale;
+    RateSuperposition::Schedule measured;
+    rateView.forEach([&](double t, double q) {
+        if (!measured.startTime.isEmpty() && std::abs(q - measured.rate.last()) <= rateTolerance) return;
+        if (!measured.startTime.isEmpty() && t == measured.startTime.last()) {
+            measured.rate.last() = q;
+            return;
+        }
+        measured.startTime.append(t);
+        measured.rate.append(q);
+    });
+    // 开头的零产量段不影响压力
+    while (!measured.rate.isEmpty() && std::abs(measured.rate.first()) <= rateTolerance) {
+        measured.startTime.removeFirst();
+        measured.rate.removeFirst();
+    }
+
+    // ---------------- 压力：按流动段对数时间分箱 ----------------
+    SampleView pressureView(m_pressureTime, m_pressure, m_pressureCount);
+    double lastPressureTime = -std::numeric_limits<double>::infinity();
+    pressureView.forEach([&](double t, double) { lastPressureTime = t; });
+    // 晚于最后一个压力点开始的产量段不影响任何压力点
+    while (!measured.startTime.isEmpty() && measured.startTime.last() >= lastPressureTime) {
+        measured.startTime.removeLast();
+        measured.rate.removeLast();
+    }
+    if (measured.startTime.isEmpty()) {
+        result.error = "压力记录未覆盖生产期";
+        return result;
+    }
+    const double t0 = measured.startTime.first();
+    const double span = lastPressureTime - t0;
+    RateSuperposition::Schedule schedule = coarsenRates(measured, lastPressureTime, qMax(1, options.maxRateSegments));
+
+    const double minElapsed = options.minTime > 0 ? options.minTime : 1e-5 * span;
+    int pointsPerCycle = qMax(1, options.pressurePointsPerCycle);
+    PressureBins bins = binPressure(pressureView, schedule.startTime, minElapsed, pointsPerCycle);
+    for (int attempt = 0; attempt < 8 && bins.time.size() > options.maxPressurePoints && pointsPerCycle > 1; ++attempt) {
+        pointsPerCycle = qMax(1, int(pointsPerCycle * double(options.maxPressurePoints) / bins.time.size()));
+        bins = binPressure(pressureView, schedule.startTime, minElapsed, pointsPerCycle);
+    }
+    result.pressureSamples = bins.samples;
+    const int M = bins.time.size();
+    const int S = schedule.startTime.size();
+    if (M < 3) {
+        result.error = "压力采样点不足";
+        return result;
+    }
+    if (stopped()) {
+        result.error = "已取消";
+        return result;
+    }
+
+    // ---------------- 节点与未知量 ----------------
+    // 每个压力点之前的产量段数 (压力点按时间递增)
+    QVector<int> active(M);
+    double minTau = span;
+    for (int j = 0, s = 0; j < M; ++j) {
+        while (s < S && schedule.startTime[s] < bins.time[j]) ++s;
+        active[j] = s;
+        if (s > 0) minTau = qMin(minTau, bins.time[j] - schedule.startTime[s - 1]);
+    }
+    Response response;
+    response.sigma0 = std::log(qMax(minElapsed, minTau));
+    const double cycles = qMax(0.5, (std::log(span) - response.sigma0) / std::log(10.0));
+    response.nodes = qMax(3, int(std::ceil(cycles * qMax(1, options.nodesPerCycle))) + 1);
+    response.h = (std::log(span) - response.sigma0) / (response.nodes - 1);
+    if (!(response.h > 0)) {
+        result.error = "生产时间过短";
+        return result;
+    }
+    const int K = response.nodes;
+    const bool fitP0 = options.estimateInitialPressure;
+    const bool fitRates = options.rateWeight > 0;
+    const int p0Col = K;
+    const int rateCol = K + (fitP0 ? 1 : 0);
+    const int nVars = rateCol + (fitRates ? S : 0);
+
+    // 初值：生产前的平均压力 (没有时取最大或最小压力)，导数取常数
+    double p0 = options.initialPressure;
+    if (fitP0) {
+        double sum = 0.0;
+        int count = 0;
+        for (int j = 0; j < M && active[j] == 0; ++j) {
+            sum += bins.pressure[j];
+            ++count;
+        }
+        double meanRate = 0.0;
+        for (double q : schedule.rate) meanRate += q;
+        if (count > 0) p0 = sum / count;
+        else p0 = meanRate >= 0 ? *std::max_element(bins.pressure.begin(), bins.pressure.end())
+                                : *std::min_element(bins.pressure.begin(), bins.pressure.end());
+    }
+    double pScale = 0.0;
+    for (double p : bins.pressure) pScale = qMax(pScale, std::abs(p - p0));
+    if (!(pScale > 0)) pScale = 1.0;
+
+    Eigen::VectorXd x(nVars);
+    x.head(K).setConstant(std::log(pScale / (rateScale * qMax(1.0, cycles * std::log(10.0)))));
+    if (fitP0) x[p0Col] = p0;
+    for (int i = 0; fitRates && i < S; ++i) x[rateCol + i] = schedule.rate[i];
+
+    const double rateW = fitRates ? pScale * std::sqrt(options.rateWeight * M / S) / rateScale : 0.0;
+    const double curveW = pScale * std::sqrt(qMax(0.0, options.regularization) * M / qMax(1, K - 2)) / (response.h * response.h);
+
+    // ---------------- 残差、雅可比与法方程 ----------------
+    // 压力点分块：每块的列只涉及 z、p0 与该块之前的产量段 (前缀)
+    const int chunkRows = qMax(16, M / qMax(1, 4 * QThread::idealThreadCount()));
+    QVector<int> chunks;
+    for (int start = 0; start < M; start += chunkRows) chunks.append(start);
+
+    Eigen::VectorXd model(M);
+    auto rateAt = [&](const Eigen::VectorXd& v, int i) { return fitRates ? v[rateCol + i] : schedule.rate[i]; };
+
+    // withJacobian 为真时累加 A (下三角) 与 g；返回目标函数的压力部分 Σ r_p^2
+    auto assemble = [&](const Eigen::VectorXd& v, bool withJacobian, Eigen::MatrixXd* A, Eigen::VectorXd* g) {
+        response.update(v.data());
+        const double pInit = fitP0 ? v[p0Col] : options.initialPressure;
+        QMutex mutex;
+        double sse = 0.0;
+        QtConcurrent::blockingMap(chunks, [&](int start) {
+            const int end = qMin(M, start + chunkRows);
+            const int prefix = rateCol + (fitRates ? active[end - 1] : 0);
+            Eigen::MatrixXd Jc;
+            Eigen::VectorXd rc(end - start);
+            if (withJacobian) Jc.setZero(end - start, prefix);
+            std::vector<double> cum(K), local(K);
+            double chunkSse = 0.0;
+            for (int j = start; j < end; ++j) {
+                const int s = active[j];
+                double p = pInit;
+                if (withJacobian) {
+                    std::fill(cum.begin(), cum.end(), 0.0);
+                    std::fill(local.begin(), local.end(), 0.0);
+                }
+                double uNext = 0.0;
+                for (int i = s - 1; i >= 0; --i) {
+                    int cell;
+                    double d0, d1;
+                    const double u = response.evaluate(bins.time[j] - schedule.startTime[i], v.data(), cell, d0, d1);
+                    const double dq = rateAt(v, i) - (i > 0 ? rateAt(v, i - 1) : 0.0);
+                    p -= dq * u;
+                    if (withJacobian) {
+                        const double c = -dq;
+                        if (cell >= 0) cum[cell] += c;
+                        const int c0 = qMax(cell, 0);
+                        local[c0] += c * d0;
+                        if (cell >= 0 && cell + 1 < K) local[cell + 1] += c * d1;
+                        if (fitRates) Jc(j - start, rateCol + i) = -(u - uNext);
+                    }
+                    uNext = u;
+                }
+                model[j] = p;
+                const double r = p - bins.pressure[j];
+                rc[j - start] = r;
+                chunkSse += r * r;
+                if (!withJacobian) continue;
+                // 累积值 P_cell 对 z 的偏导数：∇P_c = e^{z0} e_0 + Σ_{m<c} ∇F_m，按后缀和一次求出
+                double suffix = 0.0, total = 0.0;
+                for (int c = 0; c < K; ++c) total += cum[c];
+                double* row = &Jc(j - start, 0);
+                const Eigen::Index stride = Jc.outerStride();
+                auto at = [&](int col) -> double& { return row[col * stride]; };
+                at(0) += total * response.ez[0];
+                for (int m = K - 2; m >= 0; --m) {
+                    suffix += cum[m + 1];
+                    at(m) += suffix * response.dF0[m];
+                    at(m + 1) += suffix * response.dF1[m];
+                }
+                for (int c = 0; c < K; ++c) at(c) += local[c];
+                if (fitP0) at(p0Col) = 1.0;
+            }
+            QMutexLocker locker(&mutex);
+            sse += chunkSse;
+            if (withJacobian) {
+                A->topLeftCorner(prefix, prefix).selfadjointView<Eigen::Lower>().rankUpdate(Jc.transpose());
+                g->head(prefix).noalias() += Jc.transpose() * rc;
+            }
+        });
+        return sse;
+    };
+    // 正则项与产量误差项 (带状、对角)
+    auto penalty = [&](const Eigen::VectorXd& v, Eigen::MatrixXd* A, Eigen::VectorXd* g) {
+        double sse = 0.0;
+        for (int k = 1; k + 1 < K; ++k) {
+            const double r = curveW * (v[k - 1] - 2.0 * v[k] + v[k + 1]);
+            sse += r * r;
+            if (!A) continue;
+            const int cols[3] = { k - 1, k, k + 1 };
+            const double w[3] = { curveW, -2.0 * curveW, curveW };
+            for (int a = 0; a < 3; ++a) {
+                (*g)[cols[a]] += w[a] * r;
+                for (int b = 0; b <= a; ++b) (*A)(cols[a], cols[b]) += w[a] * w[b];
+            }
+        }
+        for (int i = 0; fitRates && i < S; ++i) {
+            const double r = rateW * (v[rateCol + i] - schedule.rate[i]);
+            sse += r * r;
+            if (!A) continue;
+            (*g)[rateCol + i] += rateW * r;
+            (*A)(rateCol + i, rateCol + i) += rateW * rateW;
+        }
+        return sse;
+    };
+
+    // ---------------- 阻尼 Gauss-Newton ----------------
+    Eigen::MatrixXd A(nVars, nVars);
+    Eigen::VectorXd g(nVars);
+    double mu = 1e-3;
+    double objective = assemble(x, false, nullptr, nullptr) + penalty(x, nullptr, nullptr);
+    bool needJacobian = true;
+    for (int iter = 0; iter < options.maxIterations; ++iter) {
+        if (stopped()) {
+            result.error = "已取消";
+            return result;
+        }
+        if (m_onProgress) m_onProgress(100 * iter / qMax(1, options.maxIterations));
+        if (needJacobian) {
+            A.setZero();
+            g.setZero();
+            assemble(x, true, &A, &g);
+            penalty(x, &A, &g);
+            needJacobian = false;
+        }
+        Eigen::MatrixXd damped = A;
+        for (int c = 0; c < nVars; ++c) damped(c, c) += mu * qMax(A(c, c), 1e-12 * pScale * pScale);
+        Eigen::LDLT<Eigen::MatrixXd, Eigen::Lower> ldlt(damped);
+        if (ldlt.info() != Eigen::Success) {
+            result.error = "法方程求解失败";
+            return result;
+        }
+        Eigen::VectorXd step = ldlt.solve(-g);
+        if (!step.allFinite()) {
+            mu *= 10.0;
+            continue;
+        }
+        Eigen::VectorXd trial = x + step;
+        const double trialObjective = assemble(trial, false, nullptr, nullptr) + penalty(trial, nullptr, nullptr);
+        ++result.iterations;
+        if (std::isfinite(trialObjective) && trialObjective < objective) {
+            const double decrease = (objective - trialObjective) / qMax(objective, 1e-300);
+            x = trial;
+            objective = trialObjective;
+            mu = qMax(1e-10, mu / 3.0);
+            needJacobian = true;
+            if (decrease < options.tolerance) {
+                result.converged = true;
+                break;
+            }
+        } else {
+            mu *= 4.0;
+            if (mu > 1e10) {
+                result.converged = true;    // 当前点已无法再下降
+                break;
+            }
+        }
+    }
+
+    // ---------------- 结果 ----------------
+    const double pressureSse = assemble(x, false, nullptr, nullptr);
+    response.update(x.data());
+    result.referenceRate = options.referenceRate > 0 ? options.referenceRate : rateScale;
+    result.initialPressure = fitP0 ? x[p0Col] : options.initialPressure;
+    for (int k = 0; k < K; ++k) {
+        result.time.append(std::exp(response.sigma0 + k * response.h));
+        result.deltaP.append(result.referenceRate * response.P[k]);
+        result.derivative.append(result.referenceRate * response.ez[k]);
+    }
+    result.rates.startTime = schedule.startTime;
+    double rateSse = 0.0;
+    for (int i = 0; i < S; ++i) {
+        const double q = rateAt(x, i);
+        result.rates.rate.append(q);
+        rateSse += (q - schedule.rate[i]) * (q - schedule.rate[i]) / (rateScale * rateScale);
+    }
+    result.fitTime = bins.time;
+    result.fitPressure = bins.pressure;
+    result.modelPressure = QVector<double>(model.data(), model.data() + M);
+    result.pressureRms = std::sqrt(pressureSse / M);
+    result.rateRms = std::sqrt(rateSse / S);
+    result.elapsedMs = clock.elapsed();
+    if (m_onProgress) m_onProgress(100);
+    return result;
+}
@@ -0,0 +1,94 @@
+/*
+ * 文件名: ratedeconvolution.h
+ * 文件作用: 压力-产量反卷积头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 由长期生产的压力与产量记录求单位产量响应 p_u(t) (von Schroeter / Levitan 方法)，
+ *    得到的 Δp 与导数曲线可像常规试井数据一样用 ModelSolver01_06 拟合。
+ * 2. 未知量为对数时间节点上的 z = ln(dp_u/d ln t) (节点间线性，保证导数为正)、初始地层压力与各段产量；
+ *    目标函数为压力误差、产量误差 (总体最小二乘) 与 z 曲率正则项之和，用阻尼 Gauss-Newton 求解。
+ * 3. 输入按指针逐段读取 (可直接使用表格的列缓冲区，不复制原始数据)：产量合并为有限段数的阶梯产量，
+ *    压力在各流动段内按距该段开始的对数时间分箱取平均，10^5 ~ 10^6 个采样点也只需一次线性扫描。
+ * 4. 压力点按行分块在线程池中并发计算残差、雅可比与法方程；压力点按时间排序后每行只与之前的产量段相关，
+ *    法方程只累加各块的非零前缀；曲率正则项为带状 (五对角)、产量误差项为对角，直接加到法方程上。
+ */
+
+#ifndef RATEDECONVOLUTION_H
+#define RATEDECONVOLUTION_H
+
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "ratesuperposition.h"
+
+class RateDeconvolution
+{
+public:
+    struct Options {
+        int nodesPerCycle = 8;              // 响应节点：每个对数周期的节点数
+        double minTime = 0.0;               // 响应的最短时间；<=0 时取总时长的 1e-5 倍与最早的分箱时间中较大者
+        int pressurePointsPerCycle = 10;    // 压力分箱：各流动段内每个对数周期的点数
+        int maxPressurePoints = 5000;       // 分箱后的压力点上限 (超过时降低分箱密度)
+        double rateTolerance = 1e-3;        // 与上一段产量相对差 (相对于最大产量) 不超过该值的采样点并入上一段
+        int maxRateSegments = 400;          // 产量段数上限 (优先合并产量接近的相邻段，按体积守恒取平均)
+
+        double regularization = 1e-6;       // 曲率正则权重 λ (无因次，越大响应越平滑)
+        double rateWeight = 1.0;            // 产量误差权重 ν (无因次)；0 表示产量视为准确，只拟合压力
+        bool estimateInitialPressure = true;
+        double initialPressure = 0.0;       // 不估计时使用的初始地层压力
+
+        double referenceRate = 0.0;         // 输出曲线的参考产量 (Δp = q_ref · p_u)；<=0 时取最大产量
+        int maxIterations = 50;
+        double tolerance = 1e-8;            // 目标函数相对下降量低于该值时结束
+    };
+
+    struct Result {
+        QString error;                      // 为空表示成功
+
+        // 反卷积响应 (节点时间上，已乘参考产量)：可作为恒定产量 referenceRate 下的 Δp 与导数拟合
+        QVector<double> time;
+        QVector<double> deltaP;
+        QVector<double> derivative;
+        double referenceRate = 0.0;
+        double initialPressure = 0.0;
+
+        // 校正后的产量历史与分箱压力点上的模型压力
+        RateSuperposition::Schedule rates;
+        QVector<double> fitTime;
+        QVector<double> fitPressure;        // 分箱平均的实测压力
+        QVector<double> modelPressure;
+
+        double pressureRms = 0.0;           // 压力误差均方根 (压力单位)
+        double rateRms = 0.0;               // 产量校正量均方根 (相对于最大产量)
+        int pressureSamples = 0;            // 读取的有效压力采样点数
+        int rateSamples = 0;
+        int iterations = 0;
+        bool converged = false;
+        qint64 elapsedMs = 0;
+    };
+
+    using ProgressCallback = std::function<void(int percent)>;
+    using StopPredicate = std::function<bool()>;
+
+    // 压力与产量采样 (同一时钟)；只保存指针，调用方在 run 结束前保持数据有效。非有限值的采样点跳过
+    void setPressureSamples(const double* time, const double* pressure, int count);
+    // 产量采样：每个采样点的产量保持到下一个采样点 (与 RateSuperposition::fromSamples 相同)，正值为生产
+    void setRateSamples(const double* time, const double* rate, int count);
+
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    Result run(const Options& options) const;
+
+private:
+    const double* m_pressureTime = nullptr;
+    const double* m_pressure = nullptr;
+    int m_pressureCount = 0;
+    const double* m_rateTime = nullptr;
+    const double* m_rate = nullptr;
+    int m_rateCount = 0;
+
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+};
+
+#endif // RATEDECONVOLUTION_H
@@ -0,0 +1,194 @@
+/*
+ * 文件名: ratesuperposition.cpp
+ * 文件作用: 变产量叠加计算实现
+ * 功能描述:
+ * 1. 产量历史整理：按时间排序，合并相邻的相同产量段。
+ * 2. 叠加权重：每个 (观测点, 产量变化) 对的经过时间落在单位响应网格上，
+ *    三次 Hermite 插值的斜率取网格值的中心差分，因而插值结果是网格值的线性组合，按观测点合并为稀疏行。
+ * 3. 单位产量响应与灵敏度由求解器在网格上一次求出，再经同一组权重叠加。
+ */
+
+#include "ratesuperposition.h"
+#include "derivativeengine.h"
+
+#include <algorithm>
+#include <cmath>
+
+RateSuperposition::Schedule RateSuperposition::fromSamples(const QVector<double>& time, const QVector<double>& rate, double rateTolerance)
+{
+    Schedule schedule;
+    int n = qMin(time.size(), rate.size());
+    QVector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (std::isfinite(time[i]) && std::isfinite(rate[i])) order.append(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return time[a] < time[b]; });
+
+    for (int i : order) {
+        double q = rate[i];
+        if (!schedule.isEmpty()) {
+            double last = schedule.rate.last();
+            if (std::abs(q - last) <= rateTolerance * qMax(qMax(std::abs(q), std::abs(last)), 1e-300)) continue;
+            // 同一时刻的多个采样点只保留最后一个产量
+            if (time[i] == schedule.startTime.last()) {
+                schedule.rate.last() = q;
+                continue;
+            }
+        }
+        schedule.startTime.append(time[i]);
+        schedule.rate.append(q);
+    }
+    return schedule;
+}
+
+RateSuperposition::RateSuperposition(const Schedule& schedule, const QVector<double>& t, const Options& options)
+    : m_time(t), m_lSpacing(options.lSpacing)
+{
+    // 产量变化量 Δq_i = q_i - q_{i-1} (q_{-1} = 0)，变化为零的段不参与叠加
+    QVector<double> stepTime, stepRate;
+    double previous = 0.0;
+    int steps = qMin(schedule.startTime.size(), schedule.rate.size());
+    for (int i = 0; i < steps; ++i) {
+        double dq = schedule.rate[i] - previous;
+        previous = schedule.rate[i];
+        if (dq == 0.0) continue;
+        stepTime.append(schedule.startTime[i]);
+        stepRate.append(dq);
+    }
+
+    double minElapsed = HUGE_VAL, maxElapsed = 0.0;
+    for (double tj : t) {
+        for (double ts : stepTime) {
+            double e = tj - ts;
+            if (e <= 0.0) continue;
+            minElapsed = qMin(minElapsed, e);
+            maxElapsed = qMax(maxElapsed, e);
+        }
+    }
+    if (!(maxElapsed > 0.0)) return;
+
+    // 对数等距网格 [lo, maxElapsed]
+    int pointsPerCycle = qMax(2, options.pointsPerCycle);
+    double lo = qMax(minElapsed, maxElapsed * options.minElapsedRatio);
+    double u0 = std::log(lo);
+    double u1 = std::log(maxElapsed);
+    if (u1 - u0 < 1e-12) u1 = u0 + std::log(10.0) / pointsPerCycle;
+    int gridSize = qMax(2, (int)std::ceil((u1 - u0) / std::log(10.0) * pointsPerCycle) + 1);
+    double h = (u1 - u0) / (gridSize - 1);
+    m_responseTime.resize(gridSize);
+    for (int k = 0; k < gridSize; ++k) m_responseTime[k] = std::exp(u0 + k * h);
+
+    // 网格点 k 处斜率 (每个网格步长) 对网格值的系数：内部点中心差分，端点单侧差分
+    auto addSlope = [&](QVector<double>& row, int k, double w) {
+        if (k == 0) { row[1] += w; row[0] -= w; }
+        else if (k == gridSize - 1) { row[k] += w; row[k - 1] -= w; }
+        else { row[k + 1] += 0.5 * w; row[k - 1] -= 0.5 * w; }
+    };
+
+    QVector<double> row(gridSize);
+    m_rowStart.reserve(t.size() + 1);
+    for (double tj : t) {
+        m_rowStart.append(m_column.size());
+        row.fill(0.0);
+        for (int i = 0; i < stepTime.size(); ++i) {
+            double e = tj - stepTime[i];
+            if (e <= 0.0) continue;
+            double dq = stepRate[i];
+            if (e < lo) {
+                // 网格下限以下按早期线性段外推
+                row[0] += dq * e / lo;
+                continue;
+            }
+            double x = (std::log(e) - u0) / h;
+            int k = qBound(0, (int)std::floor(x), gridSize - 2);
+            double s = qBound(0.0, x - k, 1.0);
+            double s2 = s * s, s3 = s2 * s;
+            row[k] += dq * (2.0 * s3 - 3.0 * s2 + 1.0);
+            row[k + 1] += dq * (-2.0 * s3 + 3.0 * s2);
+            addSlope(row, k, dq * (s3 - 2.0 * s2 + s));
+            addSlope(row, k + 1, dq * (s3 - s2));
+        }
+        for (int k = 0; k < gridSize; ++k) {
+            if (row[k] == 0.0) continue;
+            m_column.append(k);
+            m_weight.append(row[k]);
+        }
+    }
+    m_rowStart.append(m_column.size());
+}
+
+QVector<double> RateSuperposition::apply(const QVector<double>& unitResponse) const
+{
+    QVector<double> out(m_time.size(), 0.0);
+    if (unitResponse.size() != m_responseTime.size()) return out;
+    const double* u = unitResponse.constData();
+    for (int j = 0; j < m_time.size(); ++j) {
+        double s = 0.0;
+        for (int k = m_rowStart[j]; k < m_rowStart[j + 1]; ++k) s += m_weight[k] * u[m_column[k]];
+        out[j] = s;
+    }
+    return out;
+}
+
+QVector<double> RateSuperposition::derivative(const QVector<double>& p) const
+{
+    if (p.size() <= 2) return QVector<double>(p.size(), 0.0);
+    DerivativeEngine::Options derivOptions;
+    derivOptions.algorithm = DerivativeEngine::Bourdet;
+    derivOptions.lSpacing = m_lSpacing;
+    derivOptions.absoluteValue = false;
+    return DerivativeEngine::compute(m_time, p, derivOptions);
+}
+
+ModelCurveData RateSuperposition::evaluate(ModelSolver01_06& solver, const ModelSolver01_06::ParamSet& params,
+                                           const ModelSolver01_06::CalcOptions& options) const
+{
+    if (!isValid()) return std::make_tuple(m_time, QVector<double>(m_time.size(), 0.0), QVector<double>(m_time.size(), 0.0));
+
+    ModelSolver01_06::ParamSet unit = params;
+    unit[ModelSolver01_06::ParamSet::Q] = 1.0;
+    ModelCurveData response = solver.calculateTheoreticalCurve(unit, m_responseTime, options);
+    // 求解被停止 (CalcOptions::control) 时单位响应为空，叠加结果同样为空
+    if (std::get<1>(response).size() != m_responseTime.size()) return ModelCurveData();
+
+    QVector<double> p = apply(std::get<1>(response));
+    QVector<double> d = derivative(p);
+    for (double& v : d) v = std::abs(v);
+    return std::make_tuple(m_time, p, d);
+}
+
+// 叠加对单位响应是线性的：偏导数同样经权重叠加；导数的偏导数按带符号原始导数求出后乘以符号
+ModelCurveData RateSuperposition::evaluateSensitivity(ModelSolver01_06& solver, const ModelSolver01_06::ParamSet& params,
+                                                      const ModelSolver01_06::CalcOptions& options, const QVector<int>& wrt,
+                                                      ModelSolver01_06::CurveSensitivity& out) const
+{
+    int n = m_time.size();
+    out.wrt = wrt;
+    out.dP = QVector<QVector<double>>(wrt.size(), QVector<double>(n, 0.0));
+    out.dDeriv = QVector<QVector<double>>(wrt.size(), QVector<double>(n, 0.0));
+    if (!isValid()) return std::make_tuple(m_time, QVector<double>(n, 0.0), QVector<double>(n, 0.0));
+
+    ModelSolver01_06::ParamSet unit = params;
+    unit[ModelSolver01_06::ParamSet::Q] = 1.0;
+    ModelSolver01_06::CurveSensitivity unitSens;
+    ModelCurveData response = solver.calculateCurveSensitivity(unit, m_responseTime, options, wrt, unitSens);
+    if (std::get<1>(response).size() != m_responseTime.size()) return ModelCurveData();
+
+    QVector<double> p = apply(std::get<1>(response));
+    QVector<double> raw = derivative(p);
+    QVector<double> d(n);
+    for (int i = 0; i < n; ++i) d[i] = std::abs(raw[i]);
+
+    for (int w = 0; w < wrt.size(); ++w) {
+        // 产量由产量历史给定，参数 q 不影响叠加结果
+        if (wrt[w] == ModelSolver01_06::ParamSet::Q) continue;
+        out.dP[w] = apply(unitSens.dP.value(w));
+        QVector<double> dRaw = derivative(out.dP[w]);
+        for (int i = 0; i < n; ++i) {
+            double sign = raw[i] > 0 ? 1.0 : (raw[i] < 0 ? -1.0 : 0.0);
+            out.dDeriv[w][i] = sign * dRaw[i];
+        }
+    }
+    return std::make_tuple(m_time, p, d);
+}
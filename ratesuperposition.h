@@ -0,0 +1,76 @@
+/*
+ * 文件名: ratesuperposition.h
+ * 文件作用: 变产量叠加计算头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 以产量历史 (各段起始时间与产量) 描述变产量生产，相邻产量相同的段合并。
+ * 2. 单位产量响应只在一条覆盖全部 t - t_i 的对数等距网格上求解一次，
+ *    叠加 Δp(t) = Σ (q_i - q_{i-1}) p_u(t - t_i) 由网格值的三次 Hermite 插值 (对 ln t) 给出。
+ * 3. 插值权重在构造时一次性算好 (对网格值是线性的)，曲线与各参数的灵敏度共用同一组权重。
+ * 4. 叠加后的压力导数对 ln t 用 Bourdet 算法计算，与观测数据的导数处理一致。
+ */
+
+#ifndef RATESUPERPOSITION_H
+#define RATESUPERPOSITION_H
+
+#include <QVector>
+#include "modelsolver01-06.h"
+
+class RateSuperposition
+{
+public:
+    // 产量历史：第 i 段从 startTime[i] 开始，产量 rate[i] 保持到下一段开始；时间与观测时间使用同一时钟
+    struct Schedule {
+        QVector<double> startTime;
+        QVector<double> rate;
+        bool isEmpty() const { return startTime.isEmpty(); }
+    };
+
+    struct Options {
+        int pointsPerCycle = 25;    // 单位产量响应网格每个对数周期的点数
+        double lSpacing = 0.1;      // 叠加后压力导数的 Bourdet 窗口
+        double minElapsedRatio = 1e-8; // 网格下限不低于最大经过时间的该倍数，更短的经过时间按 p_u ∝ t 外推
+    };
+
+    /**
+     * @brief 由产量列构造产量历史 (阶梯产量，每个采样点的产量保持到下一个采样点)
+     * 时间按升序排列，与上一段产量相对差不超过 rateTolerance 的采样点并入上一段
+     */
+    static Schedule fromSamples(const QVector<double>& time, const QVector<double>& rate, double rateTolerance = 1e-6);
+
+    RateSuperposition() = default;
+    // 为观测时间 t 建立叠加权重；产量历史为空或 t 中没有晚于首段起始时间的点时 isValid() 为 false
+    RateSuperposition(const Schedule& schedule, const QVector<double>& t, const Options& options);
+
+    bool isValid() const { return !m_responseTime.isEmpty(); }
+    // 需要求解单位产量响应的时间网格 (递增)
+    const QVector<double>& responseTime() const { return m_responseTime; }
+    const QVector<double>& time() const { return m_time; }
+
+    // 网格上的单位产量响应 (或其灵敏度) 叠加到观测时间上
+    QVector<double> apply(const QVector<double>& unitResponse) const;
+
+    /**
+     * @brief 变产量理论曲线：参数中的产量 q 换为 1 求单位产量响应，叠加后计算导数
+     * 压敏效应修正作用在单位产量响应上 (按线性叠加处理)
+     */
+    ModelCurveData evaluate(ModelSolver01_06& solver, const ModelSolver01_06::ParamSet& params,
+                            const ModelSolver01_06::CalcOptions& options) const;
+    // 变产量曲线及其对参数的偏导数 (与 ModelSolver01_06::calculateCurveSensitivity 的约定相同，产量 q 的偏导数为 0)
+    ModelCurveData evaluateSensitivity(ModelSolver01_06& solver, const ModelSolver01_06::ParamSet& params,
+                                       const ModelSolver01_06::CalcOptions& options, const QVector<int>& wrt,
+                                       ModelSolver01_06::CurveSensitivity& out) const;
+
+private:
+    QVector<double> derivative(const QVector<double>& p) const;
+
+    QVector<double> m_time;
+    QVector<double> m_responseTime;
+    double m_lSpacing = 0.1;
+
+    // 叠加权重 (按观测点分行的稀疏行)：p(t_j) = Σ_k m_weight[k] * p_u[m_column[k]]，k ∈ [m_rowStart[j], m_rowStart[j+1])
+    QVector<int> m_rowStart;
+    QVector<int> m_column;
+    QVector<double> m_weight;
+};
+
+#endif // RATESUPERPOSITION_H
@@ -0,0 +1,176 @@
+/*
+ * 文件名: rowfilterproxymodel.cpp
+ * 文件作用: 按行号集合筛选的轻量代理模型实现
+ * 功能描述:
+ * 1. 设置或清除筛选只替换行号数组并重置代理，耗时与源表行数无关。
+ * 2. 筛选状态下的源行映射用二分查找；源数据变化只转发落在筛选结果中的行。
+ */
+
+#include "rowfilterproxymodel.h"
+#include <algorithm>
+
+RowFilterProxyModel::RowFilterProxyModel(QObject* parent)
+    : QAbstractProxyModel(parent),
+    m_filtered(false),
+    m_resetPending(false)
+{
+}
+
+void RowFilterProxyModel::setSourceModel(QAbstractItemModel* newSource)
+{
+    beginResetModel();
+    if (QAbstractItemModel* old = sourceModel()) disconnect(old, nullptr, this, nullptr);
+    QAbstractProxyModel::setSourceModel(newSource);
+    m_filtered = false;
+    m_rows.clear();
+
+    if (newSource) {
+        connect(newSource, &QAbstractItemModel::dataChanged, this, &RowFilterProxyModel::onSourceDataChanged);
+        connect(newSource, &QAbstractItemModel::headerDataChanged, this, &RowFilterProxyModel::onSourceHeaderDataChanged);
+        connect(newSource, &QAbstractItemModel::rowsAboutToBeInserted, this,
+                [this](const QModelIndex&, int first, int last) { onSourceRowsAboutToChange(true, first, last); });
+        connect(newSource, &QAbstractItemModel::rowsInserted, this, [this]() { onSourceRowsChanged(true); });
+        connect(newSource, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                [this](const QModelIndex&, int first, int last) { onSourceRowsAboutToChange(false, first, last); });
+        connect(newSource, &QAbstractItemModel::rowsRemoved, this, [this]() { onSourceRowsChanged(false); });
+        // 列不参与筛选，直接转发
+        connect(newSource, &QAbstractItemModel::columnsAboutToBeInserted, this,
+                [this](const QModelIndex&, int first, int last) { beginInsertColumns(QModelIndex(), first, last); });
+        connect(newSource, &QAbstractItemModel::columnsInserted, this, [this]() { endInsertColumns(); });
+        connect(newSource, &QAbstractItemModel::columnsAboutToBeRemoved, this,
+                [this](const QModelIndex&, int first, int last) { beginRemoveColumns(QModelIndex(), first, last); });
+        connect(newSource, &QAbstractItemModel::columnsRemoved, this, [this]() { endRemoveColumns(); });
+        connect(newSource, &QAbstractItemModel::modelAboutToBeReset, this, &RowFilterProxyModel::onSourceAboutToBeReset);
+        connect(newSource, &QAbstractItemModel::modelReset, this, &RowFilterProxyModel::onSourceReset);
+        connect(newSource, &QAbstractItemModel::layoutAboutToBeChanged, this, &RowFilterProxyModel::onSourceAboutToBeReset);
+        connect(newSource, &QAbstractItemModel::layoutChanged, this, &RowFilterProxyModel::onSourceReset);
+    }
+    endResetModel();
+}
+
+void RowFilterProxyModel::setRowFilter(const QVector<int>& rows)
+{
+    beginResetModel();
+    m_rows = rows;
+    m_filtered = true;
+    endResetModel();
+}
+
+void RowFilterProxyModel::clearRowFilter()
+{
+    if (!m_filtered) return;
+    beginResetModel();
+    m_rows.clear();
+    m_filtered = false;
+    endResetModel();
+}
+
+QModelIndex RowFilterProxyModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (parent.isValid() || row < 0 || column < 0 || row >= rowCount() || column >= columnCount()) return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex RowFilterProxyModel::parent(const QModelIndex&) const
+{
+    return QModelIndex();
+}
+
+int RowFilterProxyModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !sourceModel()) return 0;
+    return m_filtered ? int(m_rows.size()) : sourceModel()->rowCount();
+}
+
+int RowFilterProxyModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !sourceModel()) return 0;
+    return sourceModel()->columnCount();
+}
+
+QModelIndex RowFilterProxyModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel()) return QModelIndex();
+    const int row = m_filtered ? m_rows.value(proxyIndex.row(), -1) : proxyIndex.row();
+    return sourceModel()->index(row, proxyIndex.column());
+}
+
+QModelIndex RowFilterProxyModel::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid()) return QModelIndex();
+    if (!m_filtered) return index(sourceIndex.row(), sourceIndex.column());
+    auto it = std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), sourceIndex.row());
+    if (it == m_rows.constEnd() || *it != sourceIndex.row()) return QModelIndex();
+    return index(int(it - m_rows.constBegin()), sourceIndex.column());
+}
+
+void RowFilterProxyModel::mappedRange(int first, int last, int& begin, int& end) const
+{
+    begin = int(std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), first) - m_rows.constBegin());
+    end = int(std::upper_bound(m_rows.constBegin(), m_rows.constEnd(), last) - m_rows.constBegin());
+}
+
+void RowFilterProxyModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                              const QList<int>& roles)
+{
+    if (m_resetPending) return;
+    int begin = topLeft.row();
+    int end = bottomRight.row() + 1;
+    if (m_filtered) mappedRange(topLeft.row(), bottomRight.row(), begin, end);
+    if (begin >= end) return;
+    emit dataChanged(index(begin, topLeft.column()), index(end - 1, bottomRight.column()), roles);
+}
+
+void RowFilterProxyModel::onSourceHeaderDataChanged(Qt::Orientation orientation, int first, int last)
+{
+    if (m_resetPending) return;
+    if (orientation == Qt::Vertical && m_filtered) {
+        int begin, end;
+        mappedRange(first, last, begin, end);
+        if (begin < end) emit headerDataChanged(orientation, begin, end - 1);
+        return;
+    }
+    emit headerDataChanged(orientation, first, last);
+}
+
+void RowFilterProxyModel::onSourceRowsAboutToChange(bool insert, int first, int last)
+{
+    if (m_filtered) {
+        // 筛选结果中的行号随之失效：整体重置为显示全部行
+        beginResetModel();
+        m_resetPending = true;
+    } else if (insert) {
+        beginInsertRows(QModelIndex(), first, last);
+    } else {
+        beginRemoveRows(QModelIndex(), first, last);
+    }
+}
+
+void RowFilterProxyModel::onSourceRowsChanged(bool insert)
+{
+    if (m_resetPending) {
+        onSourceReset();
+    } else if (insert) {
+        endInsertRows();
+    } else {
+        endRemoveRows();
+    }
+}
+
+void RowFilterProxyModel::onSourceAboutToBeReset()
+{
+    if (m_resetPending) return;
+    beginResetModel();
+    m_resetPending = true;
+}
+
+void RowFilterProxyModel::onSourceReset()
+{
+    if (!m_resetPending) return;
+    const bool wasFiltered = m_filtered;
+    m_rows.clear();
+    m_filtered = false;
+    m_resetPending = false;
+    endResetModel();
+    if (wasFiltered) emit rowFilterInvalidated();
+}
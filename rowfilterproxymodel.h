@@ -0,0 +1,58 @@
+/*
+ * 文件名: rowfilterproxymodel.h
+ * 文件作用: 按行号集合筛选的轻量代理模型头文件
+ * 功能描述:
+ * 1. 筛选结果直接以升序的源行号数组给出，代理只做行号映射，不逐行调用过滤函数、不比较单元格文字。
+ * 2. 未设置筛选时与源模型一一对应，转发源模型的全部增删行列、数据与表头变化。
+ * 3. 筛选状态下源模型增删行或重置时，筛选失效并恢复显示全部行，同时发出 rowFilterInvalidated()。
+ */
+
+#ifndef ROWFILTERPROXYMODEL_H
+#define ROWFILTERPROXYMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QVector>
+
+class RowFilterProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit RowFilterProxyModel(QObject* parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+
+    // 只显示 rows 中的源行 (升序、无重复)
+    void setRowFilter(const QVector<int>& rows);
+    // 恢复显示全部行
+    void clearRowFilter();
+    bool isFiltered() const { return m_filtered; }
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+
+signals:
+    // 源模型的行结构变化使筛选失效 (此时已恢复显示全部行)
+    void rowFilterInvalidated();
+
+private:
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+    void onSourceHeaderDataChanged(Qt::Orientation orientation, int first, int last);
+    void onSourceRowsAboutToChange(bool insert, int first, int last);
+    void onSourceRowsChanged(bool insert);
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+
+    // 筛选状态下 first..last 之间的源行在 m_rows 中的范围 [begin, end)
+    void mappedRange(int first, int last, int& begin, int& end) const;
+
+    bool m_filtered;
+    bool m_resetPending;      // 源模型结构变化期间代理处于重置中
+    QVector<int> m_rows;      // 筛选后显示的源行号 (升序)
+};
+
+#endif // ROWFILTERPROXYMODEL_H
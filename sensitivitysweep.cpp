@@ -0,0 +1,96 @@
+/*
+ * 文件名: sensitivitysweep.cpp
+ * 文件作用: 参数敏感性分析方案展开实现
+ * 功能描述:
+ * 1. 单因素方案先给出基准组，再按轴顺序列出各轴其余取值。
+ * 2. 全因子方案按混合进制计数展开，最后一个轴变化最快。
+ * 3. 方案条数按 64 位累乘并在超过上限时提前截止，避免取值很多时整数溢出。
+ */
+
+#include "sensitivitysweep.h"
+
+#include <QStringList>
+
+int SensitivitySweep::caseCount(const QList<Axis>& axes, Design design)
+{
+    qint64 count = 1;
+    for (const Axis& axis : axes) {
+        if (axis.values.size() < 2) continue;
+        if (design == FullFactorial) count *= axis.values.size();
+        else count += axis.values.size() - 1;
+        if (count > MAX_CASES) return MAX_CASES + 1;
+    }
+    return (int)count;
+}
+
+QList<SensitivitySweep::Case> SensitivitySweep::expand(const QMap<QString, double>& base, const QList<Axis>& axes, Design design)
+{
+    QList<Case> cases;
+    if (caseCount(axes, design) > MAX_CASES) return cases;
+
+    QList<Axis> active;
+    QMap<QString, double> baseParams = base;
+    for (const Axis& axis : axes) {
+        if (axis.values.isEmpty()) continue;
+        baseParams[axis.name] = axis.values.first();
+        if (axis.values.size() >= 2) active.append(axis);
+    }
+
+    if (design == OneAtATime || active.isEmpty()) {
+        Case baseCase;
+        baseCase.params = baseParams;
+        updateDependent(baseCase.params);
+        if (!active.isEmpty()) {
+            QStringList parts;
+            for (const Axis& axis : active) parts << formatValue(axis.name, axis.values.first());
+            baseCase.label = parts.join(", ");
+        }
+        cases.append(baseCase);
+        for (const Axis& axis : active) {
+            for (int k = 1; k < axis.values.size(); ++k) {
+                Case c;
+                c.params = baseParams;
+                c.params[axis.name] = axis.values[k];
+                updateDependent(c.params);
+                c.label = formatValue(axis.name, axis.values[k]);
+                cases.append(c);
+            }
+        }
+        return cases;
+    }
+
+    QVector<int> digit(active.size(), 0);
+    while (true) {
+        Case c;
+        c.params = baseParams;
+        QStringList parts;
+        for (int a = 0; a < active.size(); ++a) {
+            double value = active[a].values[digit[a]];
+            c.params[active[a].name] = value;
+            parts << formatValue(active[a].name, value);
+        }
+        updateDependent(c.params);
+        c.label = parts.join(", ");
+        cases.append(c);
+
+        int a = active.size() - 1;
+        while (a >= 0 && ++digit[a] == active[a].values.size()) {
+            digit[a] = 0;
+            --a;
+        }
+        if (a < 0) break;
+    }
+    return cases;
+}
+
+void SensitivitySweep::updateDependent(QMap<QString, double>& params)
+{
+    if (params.contains("L") && params.contains("Lf") && params["L"] > 1e-9) {
+        params["LfD"] = params["Lf"] / params["L"];
+    }
+}
+
+QString SensitivitySweep::formatValue(const QString& name, double value)
+{
+    return QString("%1 = %2").arg(name).arg(value, 0, 'g', 6);
+}
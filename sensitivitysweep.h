@@ -0,0 +1,54 @@
+/*
+ * 文件名: sensitivitysweep.h
+ * 文件作用: 参数敏感性分析方案展开头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 由若干取多个值的参数 (扫描轴) 展开为参数组列表，每组带图例说明。
+ * 2. 单因素 (OneAtATime)：各轴的第一个值为基准，基准方案之外每次只改变一个参数。
+ * 3. 全因子 (FullFactorial)：各轴取值的全部组合，条数为各轴取值个数之积。
+ * 4. 参数组中的 L 或 Lf 变化时同步换算 LfD = Lf / L；算出的参数组交给 SolverJob::startConcurrent 并发计算。
+ */
+
+#ifndef SENSITIVITYSWEEP_H
+#define SENSITIVITYSWEEP_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+class SensitivitySweep
+{
+public:
+    enum Design {
+        OneAtATime = 0,  // 单因素
+        FullFactorial    // 全因子
+    };
+
+    // 扫描轴：参数名及其取值 (取值个数 >= 2 才视为扫描)
+    struct Axis {
+        QString name;
+        QVector<double> values;
+    };
+
+    struct Case {
+        QMap<QString, double> params;
+        QString label;  // 与基准不同的参数取值，如 "kf = 0.001, S = 2"；无扫描轴时为空
+    };
+
+    // 单次方案的曲线条数上限 (超出时 expand 返回空列表，由调用方提示)
+    static const int MAX_CASES = 400;
+
+    /**
+     * @brief 展开扫描方案
+     * base 为全部参数的取值 (扫描轴上的参数以轴的第一个值覆盖)，axes 中取值少于两个的轴忽略。
+     * 方案条数可先用 caseCount 估计，超过 MAX_CASES 时返回空列表。
+     */
+    static QList<Case> expand(const QMap<QString, double>& base, const QList<Axis>& axes, Design design);
+    static int caseCount(const QList<Axis>& axes, Design design);
+
+private:
+    static void updateDependent(QMap<QString, double>& params);
+    static QString formatValue(const QString& name, double value);
+};
+
+#endif // SENSITIVITYSWEEP_H
@@ -0,0 +1,55 @@
+/*
+ * 文件名: seriesdata.cpp
+ * 文件作用: 试井数据序列共享容器实现
+ * 功能描述:
+ * 1. 构造时三列截到相同长度，长度本来一致时不复制。
+ * 2. logPlottable 先检查是否有需要剔除或替换的点，没有时返回自身的共享副本。
+ */
+
+#include "seriesdata.h"
+
+SeriesData::SeriesData(const QVector<double>& time, const QVector<double>& pressure, const QVector<double>& derivative)
+{
+    const int n = qMin(time.size(), pressure.size());
+    m_time = time.size() == n ? time : time.mid(0, n);
+    m_pressure = pressure.size() == n ? pressure : pressure.mid(0, n);
+    if (derivative.size() == n) {
+        m_derivative = derivative;
+    } else {
+        m_derivative = derivative.mid(0, qMin(n, derivative.size()));
+        m_derivative.resize(n);
+    }
+}
+
+SeriesData SeriesData::logPlottable(double threshold) const
+{
+    const int n = size();
+    bool dropPoints = false, fixDerivative = false;
+    for (int i = 0; i < n && !dropPoints; ++i) {
+        if (!(m_time[i] > threshold) || !(m_pressure[i] > threshold)) dropPoints = true;
+        else if (!(m_derivative[i] > threshold)) fixDerivative = true;
+    }
+    if (!dropPoints && !fixDerivative) return *this;
+
+    SeriesData result;
+    if (!dropPoints) {
+        result.m_time = m_time;
+        result.m_pressure = m_pressure;
+        result.m_derivative = m_derivative;
+        for (double& v : result.m_derivative) {
+            if (!(v > threshold)) v = 1e-10;
+        }
+        return result;
+    }
+
+    result.m_time.reserve(n);
+    result.m_pressure.reserve(n);
+    result.m_derivative.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (!(m_time[i] > threshold) || !(m_pressure[i] > threshold)) continue;
+        result.m_time.append(m_time[i]);
+        result.m_pressure.append(m_pressure[i]);
+        result.m_derivative.append(m_derivative[i] > threshold ? m_derivative[i] : 1e-10);
+    }
+    return result;
+}
@@ -0,0 +1,39 @@
+/*
+ * 文件名: seriesdata.h
+ * 文件作用: 试井数据序列 (时间、压差、导数三列) 的共享容器头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 三列各自隐式共享，复制 SeriesData 只增加引用计数；曲线配置、拟合页面与拟合器持有同一份数据。
+ * 2. 双对数显示用的过滤 (剔除非正的时间与压差、非正导数以 1e-10 代替) 没有需要改动的点时直接共享原数据，
+ *    只有被改动的列才生成新数组。
+ */
+
+#ifndef SERIESDATA_H
+#define SERIESDATA_H
+
+#include <QVector>
+
+class SeriesData
+{
+public:
+    SeriesData() = default;
+    // 导数可以为空或短于时间列，缺失部分按 0 处理
+    SeriesData(const QVector<double>& time, const QVector<double>& pressure,
+               const QVector<double>& derivative = QVector<double>());
+
+    int size() const { return m_time.size(); }
+    bool isEmpty() const { return m_time.isEmpty(); }
+
+    const QVector<double>& time() const { return m_time; }
+    const QVector<double>& pressure() const { return m_pressure; }
+    const QVector<double>& derivative() const { return m_derivative; }
+
+    // 双对数图可绘制的部分：保留 t、p 均大于阈值的点，导数不大于阈值时以 1e-10 代替
+    SeriesData logPlottable(double threshold = 1e-8) const;
+
+private:
+    QVector<double> m_time;
+    QVector<double> m_pressure;
+    QVector<double> m_derivative;
+};
+
+#endif // SERIESDATA_H
@@ -12,6 +12,7 @@
 #include "ui_settingswidget.h"
 #include <QDebug>
 #include <QDate>
+#include <QRegularExpression>
 
 // 默认常量定义
 const int SettingsWidget::DEFAULT_AUTO_SAVE = 10;
@@ -71,6 +72,9 @@ void SettingsWidget::initInterface()
     ui->cmbPlotBackground->clear();
     ui->cmbPlotBackground->addItems({"白色主题 (默认)", "深色主题 (护眼)", "灰色网格"});
 
+    ui->cmbPlotRenderer->clear();
+    ui->cmbPlotRenderer->addItems({"软件绘制 (默认)", "OpenGL 硬件加速"});
+
     // 4. 初始化日志级别
     ui->cmbLogLevel->clear();
     ui->cmbLogLevel->addItems({"仅错误 (Error)", "警告与错误 (Warning)", "一般信息 (Info)", "详细调试 (Debug)"});
@@ -91,6 +95,8 @@ void SettingsWidget::loadSettings()
     ui->cmbPlotBackground->setCurrentIndex(m_settings->value("plot/background", 0).toInt());
     ui->chkShowGrid->setChecked(m_settings->value("plot/showGrid", true).toBool());
     ui->spinLineWidth->setValue(m_settings->value("plot/lineWidth", 2).toInt());
+    ui->cmbPlotRenderer->setCurrentIndex(m_settings->value("plot/renderer", 0).toInt());
+    ui->chkShowFrameTime->setChecked(m_settings->value("plot/showFrameTime", false).toBool());
 
     // --- 4. 路径设置 ---
     QString docPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
@@ -106,6 +112,11 @@ void SettingsWidget::loadSettings()
     ui->spinLogDays->setValue(m_settings->value("system/logRetention", 30).toInt());
     ui->cmbLogLevel->setCurrentIndex(m_settings->value("system/logLevel", 2).toInt());
 
+    // --- 6. 计算性能 ---
+    ui->spinSolverThreads->setValue(m_settings->value("performance/solverThreads", 0).toInt());
+    ui->lineFitWorkers->setText(m_settings->value("performance/fitWorkers", QString()).toString());
+    ui->lineFitWorkerToken->setText(m_settings->value("performance/fitWorkerToken", QString()).toString());
+
     m_isModified = false;
 }
 
@@ -127,6 +138,8 @@ void SettingsWidget::applySettings()
     m_settings->setValue("plot/background", ui->cmbPlotBackground->currentIndex());
     m_settings->setValue("plot/showGrid", ui->chkShowGrid->isChecked());
     m_settings->setValue("plot/lineWidth", ui->spinLineWidth->value());
+    m_settings->setValue("plot/renderer", ui->cmbPlotRenderer->currentIndex());
+    m_settings->setValue("plot/showFrameTime", ui->chkShowFrameTime->isChecked());
 
     m_settings->setValue("paths/data", ui->lineDataPath->text());
     m_settings->setValue("paths/report", ui->lineReportPath->text());
@@ -139,12 +152,17 @@ void SettingsWidget::applySettings()
     m_settings->setValue("system/logRetention", ui->spinLogDays->value());
     m_settings->setValue("system/logLevel", ui->cmbLogLevel->currentIndex());
 
+    m_settings->setValue("performance/solverThreads", ui->spinSolverThreads->value());
+    m_settings->setValue("performance/fitWorkers", ui->lineFitWorkers->text().trimmed());
+    m_settings->setValue("performance/fitWorkerToken", ui->lineFitWorkerToken->text().trimmed());
+
     m_settings->sync(); // 强制写入磁盘
 
     // 发射信号通知系统其他部分
     emit settingsChanged();
     emit unitSystemChanged();
     emit plotStyleChanged();
+    emit performanceSettingsChanged();
 
     QMessageBox::information(this, "系统设置", "设置已保存并生效！");
     m_isModified = false;
@@ -240,8 +258,18 @@ QString SettingsWidget::getReportPath() const { return ui->lineReportPath->text(
 QString SettingsWidget::getBackupPath() const { return ui->lineBackupPath->text(); }
 int SettingsWidget::getAutoSaveInterval() const { return ui->spinAutoSave->value(); }
 bool SettingsWidget::isBackupEnabled() const { return ui->chkEnableBackup->isChecked(); }
+int SettingsWidget::getMaxBackups() const { return ui->spinMaxBackups->value(); }
 int SettingsWidget::getPressureUnitIndex() const { return ui->cmbPressureUnit->currentIndex(); }
 int SettingsWidget::getRateUnitIndex() const { return ui->cmbRateUnit->currentIndex(); }
 int SettingsWidget::getPrecision() const { return ui->spinPrecision->value(); }
 int SettingsWidget::getPlotBackgroundStyle() const { return ui->cmbPlotBackground->currentIndex(); }
 bool SettingsWidget::isGridVisibleDefault() const { return ui->chkShowGrid->isChecked(); }
+int SettingsWidget::getPlotRenderMode() const { return ui->cmbPlotRenderer->currentIndex(); }
+bool SettingsWidget::isFrameTimeVisible() const { return ui->chkShowFrameTime->isChecked(); }
+int SettingsWidget::getSolverThreadCount() const { return ui->spinSolverThreads->value(); }
+QStringList SettingsWidget::getFitWorkers() const
+{
+    static const QRegularExpression separators("[,;\\s]+");
+    return ui->lineFitWorkers->text().split(separators, Qt::SkipEmptyParts);
+}
+QString SettingsWidget::getFitWorkerToken() const { return ui->lineFitWorkerToken->text().trimmed(); }
@@ -41,6 +41,7 @@ public:
     // 系统配置
     int getAutoSaveInterval() const;
     bool isBackupEnabled() const;
+    int getMaxBackups() const;
 
     // 单位配置 [新增]
     int getPressureUnitIndex() const; // 0: MPa, 1: psi
@@ -50,6 +51,13 @@ public:
     // 绘图配置 [新增]
     int getPlotBackgroundStyle() const; // 0: 白色, 1: 深色
     bool isGridVisibleDefault() const;
+    int getPlotRenderMode() const;      // 0: 软件光栅, 1: OpenGL (MouseZoom::RenderMode)
+    bool isFrameTimeVisible() const;
+
+    // 计算性能配置
+    int getSolverThreadCount() const;   // 0: 自动
+    QStringList getFitWorkers() const;  // 远程拟合节点 "主机:端口"，空表示只在本机拟合
+    QString getFitWorkerToken() const;  // 远程拟合节点的共享访问令牌
 
 signals:
     // 配置变更信号
@@ -57,6 +65,7 @@ signals:
     void themeChanged(int themeIdx);  // 主题变更
     void unitSystemChanged();         // 单位制变更
     void plotStyleChanged();          // 绘图风格变更
+    void performanceSettingsChanged(); // 计算性能配置变更
 
 private slots:
     // 侧边导航栏切换
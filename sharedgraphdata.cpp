@@ -0,0 +1,50 @@
+/*
+ * 文件名: sharedgraphdata.cpp
+ * 文件作用: 曲线绘图数据容器的共享缓存实现
+ * 功能描述:
+ * 1. 以数组数据地址与长度识别同一份数据；隐式共享数组在被修改前会先分离，地址随之改变，不会误用旧容器。
+ * 2. 每次查找时顺带清除已失效的缓存项。
+ */
+
+#include "sharedgraphdata.h"
+
+QList<SharedGraphData::Entry>& SharedGraphData::entries()
+{
+    static QList<Entry> cache;
+    return cache;
+}
+
+QSharedPointer<QCPGraphDataContainer> SharedGraphData::container(const QVector<double>& keys, const QVector<double>& values)
+{
+    const int n = qMin(keys.size(), values.size());
+    QList<Entry>& cache = entries();
+    for (int i = cache.size() - 1; i >= 0; --i) {
+        if (cache[i].data.isNull()) cache.removeAt(i);
+    }
+    if (n > 0) {
+        for (const Entry& e : cache) {
+            if (e.keys.constData() == keys.constData() && e.values.constData() == values.constData()
+                && e.keys.size() == keys.size() && e.values.size() == values.size()) {
+                QSharedPointer<QCPGraphDataContainer> data = e.data.toStrongRef();
+                if (data) return data;
+            }
+        }
+    }
+
+    QVector<QCPGraphData> points(n);
+    bool sorted = true;
+    for (int i = 0; i < n; ++i) {
+        points[i].key = keys[i];
+        points[i].value = values[i];
+        if (i > 0 && keys[i] < keys[i - 1]) sorted = false;
+    }
+    QSharedPointer<QCPGraphDataContainer> data(new QCPGraphDataContainer);
+    data->set(points, sorted);
+    if (n > 0) cache.append({keys, values, data});
+    return data;
+}
+
+void SharedGraphData::assign(QCPGraph* graph, const QVector<double>& keys, const QVector<double>& values)
+{
+    if (graph) graph->setData(container(keys, values));
+}
@@ -0,0 +1,37 @@
+/*
+ * 文件名: sharedgraphdata.h
+ * 文件作用: 曲线绘图数据容器的共享缓存头文件
+ * 功能描述:
+ * 1. 同一对横、纵坐标数组 (隐式共享的同一份数据) 只生成一个 QCPGraphDataContainer，
+ *    主图、弹出窗口等各处的 QCPGraph 通过 setData(QSharedPointer) 共用该容器。
+ * 2. 缓存只保存弱引用，最后一条使用该容器的曲线释放后缓存项随之失效。
+ * 3. 共用容器的曲线不能再调用 setData(keys, values) / addData 原地修改数据，
+ *    需要改数据时重新调用 assign 或换成自己的容器。仅在界面线程使用。
+ */
+
+#ifndef SHAREDGRAPHDATA_H
+#define SHAREDGRAPHDATA_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include "qcustomplot.h"
+
+class SharedGraphData
+{
+public:
+    // 取得 (必要时生成) 与 keys、values 对应的共享容器
+    static QSharedPointer<QCPGraphDataContainer> container(const QVector<double>& keys, const QVector<double>& values);
+
+    // 代替 graph->setData(keys, values)
+    static void assign(QCPGraph* graph, const QVector<double>& keys, const QVector<double>& values);
+
+private:
+    struct Entry {
+        QVector<double> keys;   // 持有数组引用，保证缓存期间数组地址不会被其他数据重用
+        QVector<double> values;
+        QWeakPointer<QCPGraphDataContainer> data;
+    };
+    static QList<Entry>& entries();
+};
+
+#endif // SHAREDGRAPHDATA_H
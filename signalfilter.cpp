@@ -0,0 +1,259 @@
+/*
+ * 文件名: signalfilter.cpp
+ * 文件作用: 仪表数据与导数曲线的平滑去噪实现
+ * 功能描述:
+ * 1. 移动平均与对数时间窗口平均共用前缀和，每点只做一次减法与除法；NaN/inf 不计入前缀和，
+ *    只影响包含它的窗口 (与逐窗口求和的结果一致)，不会污染其后的全部输出。
+ * 2. Savitzky-Golay 系数由窗口内的小型正规方程求得 (Eigen)，内部点的卷积循环为定长内积。
+ * 3. 小波去噪的边界按镜像延拓，各层噪声水平用 nth_element 求中位数，不做整体排序。
+ */
+
+#include "signalfilter.h"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+// 只含有限值的前缀和 prefix[i] = Σ(data[k] - offset)，k < i 且 data[k] 有限；bad[i] 为其中非有限值的个数。
+// offset 取第一个有限值，降低长序列累加的舍入误差；有非有限值时另存原始数据，原地平滑时逐点求和仍读原值
+struct WindowPrefix {
+    std::vector<double> prefix;
+    std::vector<int> bad;
+    std::vector<double> raw;
+    double offset = 0.0;
+};
+
+void fillPrefix(const double* data, int n, WindowPrefix& w)
+{
+    w.offset = 0.0;
+    for (int i = 0; i < n; ++i) {
+        if (std::isfinite(data[i])) { w.offset = data[i]; break; }
+    }
+    w.prefix.resize(n + 1);
+    w.bad.resize(n + 1);
+    w.prefix[0] = 0.0;
+    w.bad[0] = 0;
+    for (int i = 0; i < n; ++i) {
+        const bool finite = std::isfinite(data[i]);
+        w.prefix[i + 1] = w.prefix[i] + (finite ? data[i] - w.offset : 0.0);
+        w.bad[i + 1] = w.bad[i] + (finite ? 0 : 1);
+    }
+    if (w.bad[n] > 0) w.raw.assign(data, data + n);
+    else w.raw.clear();
+}
+
+// 窗口 [lo, hi] 的平均；窗口内有 NaN/inf 时逐点求和，结果与直接求和相同
+inline double windowMean(const WindowPrefix& w, int lo, int hi)
+{
+    if (w.bad[hi + 1] == w.bad[lo]) return w.offset + (w.prefix[hi + 1] - w.prefix[lo]) / (hi - lo + 1);
+    double sum = 0.0;
+    for (int k = lo; k <= hi; ++k) sum += w.raw[k];
+    return sum / (hi - lo + 1);
+}
+
+// Savitzky-Golay：窗口 [0, m) 内在位置 s 处求值的系数 (窗口坐标按半宽缩放到 [-1, 1]，改善条件数)
+std::vector<double> sgCoefficients(int m, int order, int s)
+{
+    const double h = 0.5 * (m - 1);
+    Eigen::MatrixXd A(m, order + 1);
+    for (int k = 0; k < m; ++k) {
+        const double x = (k - h) / h;
+        double v = 1.0;
+        for (int j = 0; j <= order; ++j) { A(k, j) = v; v *= x; }
+    }
+    Eigen::VectorXd e(order + 1);
+    const double xs = (s - h) / h;
+    double v = 1.0;
+    for (int j = 0; j <= order; ++j) { e(j) = v; v *= xs; }
+    const Eigen::VectorXd c = A * (A.transpose() * A).ldlt().solve(e);
+    return std::vector<double>(c.data(), c.data() + m);
+}
+
+// 镜像延拓的下标 (调用方保证 |越界| < n)
+inline int mirror(int i, int n)
+{
+    if (i < 0) return -i;
+    if (i >= n) return 2 * (n - 1) - i;
+    return i;
+}
+
+} // namespace
+
+QString SignalFilter::methodName(Method method)
+{
+    switch (method) {
+    case MovingAverage: return QString("移动平均");
+    case LogTimeAverage: return QString("对数时间窗口平均");
+    case SavitzkyGolay: return QString("Savitzky-Golay");
+    case WaveletDenoise: return QString("小波去噪");
+    }
+    return QString();
+}
+
+QVector<double> SignalFilter::apply(const Options& options, const QVector<double>& time, const QVector<double>& data)
+{
+    const int n = data.size();
+    if (!options.enabled || n < 3) return data;
+
+    QVector<double> out(n);
+    switch (options.method) {
+    case MovingAverage:
+        movingAverage(data.constData(), n, options.span, out.data());
+        break;
+    case SavitzkyGolay:
+        savitzkyGolay(data.constData(), n, options.span, options.polyOrder, out.data());
+        break;
+    case WaveletDenoise:
+        waveletDenoise(data.constData(), n, options.waveletLevels, options.thresholdScale, out.data());
+        break;
+    case LogTimeAverage: {
+        if (time.size() != n) return data;
+        // 只平滑 t > 0 的点；时间未排序时按时间排序后平滑再放回原位置
+        QVector<int> order;
+        order.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            if (time[i] > 0 && std::isfinite(time[i])) order.append(i);
+        }
+        const bool sorted = order.size() == n && std::is_sorted(time.constBegin(), time.constEnd());
+        if (sorted) {
+            logTimeAverage(time.constData(), data.constData(), n, options.windowCycles, out.data());
+            break;
+        }
+        std::stable_sort(order.begin(), order.end(), [&time](int a, int b) { return time[a] < time[b]; });
+        const int m = order.size();
+        std::vector<double> ts(m), ys(m);
+        for (int k = 0; k < m; ++k) { ts[k] = time[order[k]]; ys[k] = data[order[k]]; }
+        logTimeAverage(ts.data(), ys.data(), m, options.windowCycles, ys.data());
+        out = data;
+        for (int k = 0; k < m; ++k) out[order[k]] = ys[k];
+        break;
+    }
+    }
+    return out;
+}
+
+QVector<double> SignalFilter::movingAverage(const QVector<double>& data, int span)
+{
+    QVector<double> out(data.size());
+    movingAverage(data.constData(), data.size(), span, out.data());
+    return out;
+}
+
+void SignalFilter::movingAverage(const double* data, int n, int span, double* out)
+{
+    if (n <= 0) return;
+    if (span <= 1) {
+        if (out != data) std::copy(data, data + n, out);
+        return;
+    }
+    if (span % 2 == 0) span++;
+    const int half = (span - 1) / 2;
+
+    WindowPrefix prefix;
+    fillPrefix(data, n, prefix);
+    // 边缘处窗口自动缩小 (类似 Matlab smooth 的默认行为)
+    for (int i = 0; i < n; ++i) {
+        const int start = std::max(0, i - half);
+        const int end = std::min(n - 1, i + half);
+        out[i] = windowMean(prefix, start, end);
+    }
+}
+
+void SignalFilter::logTimeAverage(const double* time, const double* data, int n, double windowCycles, double* out)
+{
+    if (n <= 0) return;
+    if (windowCycles <= 0) {
+        if (out != data) std::copy(data, data + n, out);
+        return;
+    }
+    const double factor = std::pow(10.0, 0.5 * windowCycles);
+
+    WindowPrefix prefix;
+    fillPrefix(data, n, prefix);
+    // 时间非递减：窗口两端随 i 单调右移
+    int lo = 0, hi = 0;
+    for (int i = 0; i < n; ++i) {
+        const double tLow = time[i] / factor;
+        const double tHigh = time[i] * factor;
+        while (lo < i && time[lo] < tLow) ++lo;
+        if (hi < i) hi = i;
+        while (hi + 1 < n && time[hi + 1] <= tHigh) ++hi;
+        out[i] = windowMean(prefix, lo, hi);
+    }
+}
+
+void SignalFilter::savitzkyGolay(const double* data, int n, int span, int polyOrder, double* out)
+{
+    if (n <= 0) return;
+    if (span % 2 == 0) span++;
+    if (span > n) span = (n % 2 == 1) ? n : n - 1;
+    const int order = std::max(0, std::min(polyOrder, span - 1));
+    if (span <= 1 || order >= span - 1) {
+        std::copy(data, data + n, out);
+        return;
+    }
+    const int half = (span - 1) / 2;
+
+    // 内部点：窗口中心的卷积系数
+    const std::vector<double> center = sgCoefficients(span, order, half);
+    for (int i = half; i < n - half; ++i) {
+        const double* window = data + i - half;
+        double sum = 0.0;
+        for (int k = 0; k < span; ++k) sum += center[k] * window[k];
+        out[i] = sum;
+    }
+    // 边缘点：首尾两个窗口上的同一拟合多项式在各点处求值
+    for (int s = 0; s < half; ++s) {
+        const std::vector<double> c = sgCoefficients(span, order, s);
+        double head = 0.0, tail = 0.0;
+        for (int k = 0; k < span; ++k) {
+            head += c[k] * data[k];
+            // 尾部窗口与首部镜像：位置 span-1-s 的系数为 c 反序
+            tail += c[span - 1 - k] * data[n - span + k];
+        }
+        out[s] = head;
+        out[n - 1 - s] = tail;
+    }
+}
+
+void SignalFilter::waveletDenoise(const double* data, int n, int levels, double thresholdScale, double* out)
+{
+    if (n <= 0) return;
+    // 第 j 层的核跨度为 4·2^j，镜像延拓要求小于 n
+    int maxLevels = 0;
+    while (maxLevels < levels && 4 * (1 << maxLevels) < n) ++maxLevels;
+    if (maxLevels == 0) {
+        std::copy(data, data + n, out);
+        return;
+    }
+
+    std::vector<double> approx(data, data + n), next(n), detail(n), magnitude(n), result(n, 0.0);
+    const double universal = std::sqrt(2.0 * std::log(double(n)));
+    for (int j = 0; j < maxLevels; ++j) {
+        const int step = 1 << j;
+        // B3 样条 [1 4 6 4 1]/16，隔 step 取点
+        for (int i = 0; i < n; ++i) {
+            next[i] = (approx[mirror(i - 2 * step, n)] + approx[mirror(i + 2 * step, n)]
+                       + 4.0 * (approx[mirror(i - step, n)] + approx[mirror(i + step, n)])
+                       + 6.0 * approx[i]) / 16.0;
+        }
+        for (int i = 0; i < n; ++i) {
+            detail[i] = approx[i] - next[i];
+            magnitude[i] = std::abs(detail[i]);
+        }
+        // 噪声水平 σ = median(|w|) / 0.6745
+        std::nth_element(magnitude.begin(), magnitude.begin() + n / 2, magnitude.end());
+        const double threshold = thresholdScale * universal * magnitude[n / 2] / 0.6745;
+        for (int i = 0; i < n; ++i) {
+            const double w = detail[i];
+            const double shrunk = std::abs(w) - threshold;
+            if (shrunk > 0) result[i] += w > 0 ? shrunk : -shrunk;
+        }
+        approx.swap(next);
+    }
+    for (int i = 0; i < n; ++i) out[i] = result[i] + approx[i];
+}
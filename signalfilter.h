@@ -0,0 +1,58 @@
+/*
+ * 文件名: signalfilter.h
+ * 文件作用: 仪表数据与导数曲线的平滑去噪头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 移动平均：前缀和实现，与窗口宽度无关的 O(n)；边缘处窗口自动缩小，NaN/inf 只影响包含它的窗口 (与原 smoothData 一致)。
+ * 2. 对数时间窗口平均：窗口为 [t/10^(w/2), t·10^(w/2)]，早期稀疏点与晚期密集点按相同的对数宽度平滑，双指针 + 前缀和 O(n)。
+ * 3. Savitzky-Golay：窗口内多项式最小二乘，内部点使用同一组卷积系数，边缘点按各自位置的拟合系数求值。
+ * 4. 小波去噪：à trous (B3 样条) 平稳小波分解，各层按 MAD 估计噪声并做软阈值 (通用阈值)，O(n·层数)。
+ * 5. 各算法直接读写连续缓冲区 (const double* / double*)，QVector 接口只是包装。
+ */
+
+#ifndef SIGNALFILTER_H
+#define SIGNALFILTER_H
+
+#include <QString>
+#include <QVector>
+
+class SignalFilter
+{
+public:
+    enum Method {
+        MovingAverage = 0,      // 按点数的移动平均 (原有方式)
+        LogTimeAverage,         // 对数时间窗口平均
+        SavitzkyGolay,          // Savitzky-Golay 多项式平滑
+        WaveletDenoise          // 小波软阈值去噪
+    };
+
+    struct Options {
+        bool enabled = false;
+        Method method = MovingAverage;
+        int span = 5;                   // 移动平均与 Savitzky-Golay 的窗口点数 (偶数自动加一)
+        int polyOrder = 2;              // Savitzky-Golay 多项式阶数 (小于窗口点数)
+        double windowCycles = 0.2;      // 对数时间窗口的总宽度 (对数周期)
+        int waveletLevels = 4;          // 小波分解层数 (受数据长度限制)
+        double thresholdScale = 1.0;    // 小波阈值相对于通用阈值 σ·sqrt(2 ln n) 的倍数
+    };
+
+    // 方法名称 (界面下拉框使用)
+    static QString methodName(Method method);
+
+    /**
+     * @brief 按选项平滑
+     * @param time 与 data 对应的时间，只有对数时间窗口平均使用 (长度与 data 不同时原样返回；t<=0 的点保持原值，时间未排序时自动排序)
+     * @return options.enabled 为 false 时原样返回
+     */
+    static QVector<double> apply(const Options& options, const QVector<double>& time, const QVector<double>& data);
+
+    // 缓冲区接口：out 长度为 n；movingAverage 与 logTimeAverage 先求前缀和，out 可与 data 相同 (原地平滑)
+    static void movingAverage(const double* data, int n, int span, double* out);
+    // time 须非递减
+    static void logTimeAverage(const double* time, const double* data, int n, double windowCycles, double* out);
+    static void savitzkyGolay(const double* data, int n, int span, int polyOrder, double* out);
+    static void waveletDenoise(const double* data, int n, int levels, double thresholdScale, double* out);
+
+    static QVector<double> movingAverage(const QVector<double>& data, int span);
+};
+
+#endif // SIGNALFILTER_H
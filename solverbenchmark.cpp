@@ -0,0 +1,348 @@
+/*
+ * 文件名: solverbenchmark.cpp
+ * 文件作用: 求解器性能基准程序 (无界面)
+ * 功能描述:
+ * 1. 统计 6 种模型在不同裂缝条数、时间点数下 calculateTheoreticalCurve 的耗时，以及各 Laplace 反演方法的耗时与精度。
+ * 2. 统计 DerivativeEngine 各导数算法在不同数据量下的耗时。
+ * 3. 在合成数据上运行一次完整的 Levenberg-Marquardt 拟合并统计耗时与迭代次数。
+ * 4. 结果以 JSON 输出，便于不同版本之间对比性能回归。
+ */
+
+#include "modelsolver01-06.h"
+#include "fittingcore.h"
+#include "derivativeengine.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <cmath>
+
+namespace {
+
+using ModelType = ModelSolver01_06::ModelType;
+
+// 单项计时结果
+struct Timing {
+    int runs = 0;
+    double minMs = 0.0;
+    double meanMs = 0.0;
+};
+
+// 重复执行直到累计耗时超过 minTotalMs 或达到 maxRuns 次，至少执行一次
+template <typename Func>
+Timing measure(Func&& f, double minTotalMs, int maxRuns)
+{
+    Timing t;
+    double total = 0.0;
+    QElapsedTimer timer;
+    while (t.runs < maxRuns && (t.runs == 0 || total < minTotalMs)) {
+        timer.start();
+        f();
+        double ms = timer.nsecsElapsed() / 1e6;
+        if (t.runs == 0 || ms < t.minMs) t.minMs = ms;
+        total += ms;
+        ++t.runs;
+    }
+    t.meanMs = total / t.runs;
+    return t;
+}
+
+QJsonObject timingToJson(const Timing& t)
+{
+    QJsonObject obj;
+    obj["runs"] = t.runs;
+    obj["min_ms"] = t.minMs;
+    obj["mean_ms"] = t.meanMs;
+    return obj;
+}
+
+// 基准参数：与 ModelManager::getDefaultParameters 一致，物理参数取求解器默认值 (不依赖项目设置)
+QMap<QString, double> benchmarkParameters(ModelType type, int nf)
+{
+    QMap<QString, double> p;
+    p.insert("phi", 0.05);
+    p.insert("h", 20.0);
+    p.insert("mu", 0.5);
+    p.insert("B", 1.05);
+    p.insert("Ct", 5e-4);
+    p.insert("q", 5.0);
+
+    p.insert("nf", nf);
+    p.insert("kf", 1e-3);
+    p.insert("km", 1e-4);
+    p.insert("L", 1000.0);
+    p.insert("Lf", 100.0);
+    p.insert("LfD", 0.1);
+    p.insert("rmD", 4.0);
+    p.insert("omega1", 0.4);
+    p.insert("omega2", 0.08);
+    p.insert("lambda1", 1e-3);
+    p.insert("gamaD", 0.02);
+    p.insert("N", 8.0);
+
+    bool hasStorage = (type == ModelSolver01_06::Model_1 || type == ModelSolver01_06::Model_3 || type == ModelSolver01_06::Model_5);
+    p.insert("cD", hasStorage ? 0.01 : 0.0);
+    p.insert("S", hasStorage ? 1.0 : 0.0);
+    if (type != ModelSolver01_06::Model_1 && type != ModelSolver01_06::Model_2) p.insert("reD", 10.0);
+    return p;
+}
+
+// 1. 理论曲线计算
+void benchmarkCurves(QJsonArray& results, bool quick, QTextStream& log)
+{
+    const QList<int> nfList = quick ? QList<int>{1, 4, 16} : QList<int>{1, 4, 16, 32};
+    const QList<int> pointList = quick ? QList<int>{100, 1000} : QList<int>{100, 1000, 10000};
+
+    for (int m = 0; m < 6; ++m) {
+        ModelType type = static_cast<ModelType>(m);
+        for (int nf : nfList) {
+            for (int points : pointList) {
+                ModelSolver01_06 solver(type);
+                solver.setLaplaceCacheEnabled(false); // 测量原始计算量，避免重复运行命中缓存
+                QMap<QString, double> params = benchmarkParameters(type, nf);
+                QVector<double> t = ModelSolver01_06::generateLogTimeSteps(points, -3.0, 3.0);
+                ModelSolver01_06::CalcOptions options;
+
+                Timing timing = measure([&]() {
+                    solver.calculateTheoreticalCurve(params, t, options);
+                }, 500.0, 20);
+
+                QJsonObject obj = timingToJson(timing);
+                obj["name"] = "curve";
+                obj["model"] = m + 1;
+                obj["nf"] = nf;
+                obj["points"] = points;
+                results.append(obj);
+                log << QString("curve  model=%1 nf=%2 points=%3  %4 ms\n")
+                       .arg(m + 1).arg(nf).arg(points).arg(timing.meanMs, 0, 'f', 3);
+                log.flush();
+            }
+        }
+    }
+}
+
+// 1b. 各反演方法：同一 Stehfest 阶数换算的节点数下的耗时，以及相对高阶 Talbot 参考曲线的最大相对误差
+void benchmarkInversion(QJsonArray& results, bool quick, QTextStream& log)
+{
+    const QList<int> pointList = quick ? QList<int>{100} : QList<int>{100, 1000};
+    const ModelSolver01_06::InversionMethod methods[] = {
+        ModelSolver01_06::StehfestInversion, ModelSolver01_06::TalbotInversion,
+        ModelSolver01_06::DeHoogInversion, ModelSolver01_06::EulerInversion
+    };
+
+    for (int m = 0; m < 6; ++m) {
+        ModelType type = static_cast<ModelType>(m);
+        for (int points : pointList) {
+            ModelSolver01_06 solver(type);
+            solver.setLaplaceCacheEnabled(false);
+            QMap<QString, double> params = benchmarkParameters(type, 4);
+            QVector<double> t = ModelSolver01_06::generateLogTimeSteps(points, -3.0, 3.0);
+
+            ModelSolver01_06::CalcOptions refOptions;
+            refOptions.inversion = ModelSolver01_06::TalbotInversion;
+            refOptions.stehfestN = ModelSolver01_06::MAX_STEHFEST_N;
+            const QVector<double> refP = std::get<1>(solver.calculateTheoreticalCurve(params, t, refOptions));
+
+            for (ModelSolver01_06::InversionMethod method : methods) {
+                ModelSolver01_06::CalcOptions options;
+                options.inversion = method;
+                QVector<double> p;
+                Timing timing = measure([&]() {
+                    p = std::get<1>(solver.calculateTheoreticalCurve(params, t, options));
+                }, 500.0, 5);
+
+                double maxError = 0.0;
+                for (int i = 0; i < points; ++i) {
+                    if (std::abs(refP[i]) > 0) maxError = qMax(maxError, std::abs(p[i] - refP[i]) / std::abs(refP[i]));
+                }
+
+                QJsonObject obj = timingToJson(timing);
+                obj["name"] = "curve_inversion";
+                obj["model"] = m + 1;
+                obj["points"] = points;
+                obj["inversion"] = ModelSolver01_06::inversionName(method);
+                obj["max_rel_error"] = maxError;
+                results.append(obj);
+                log << QString("inversion model=%1 points=%2 %3  %4 ms  err=%5\n")
+                       .arg(m + 1).arg(points).arg(ModelSolver01_06::inversionName(method))
+                       .arg(timing.meanMs, 0, 'f', 3).arg(maxError, 0, 'e', 2);
+                log.flush();
+            }
+        }
+    }
+}
+
+// 2. 压力导数 (等时间间隔的高频压力计数据)，逐一统计各导数算法
+void benchmarkDerivative(QJsonArray& results, bool quick, QTextStream& log)
+{
+    struct AlgorithmCase { DerivativeEngine::Algorithm algorithm; const char* name; };
+    const QList<AlgorithmCase> algorithms = {
+        {DerivativeEngine::Bourdet, "bourdet"},
+        {DerivativeEngine::ThreePoint, "three_point"},
+        {DerivativeEngine::ClarkVanGolfRacht, "clark_van_golf_racht"},
+        {DerivativeEngine::SavitzkyGolay, "savitzky_golay"}
+    };
+
+    const QList<int> sizes = quick ? QList<int>{1000, 10000} : QList<int>{1000, 10000, 100000};
+    for (int n : sizes) {
+        QVector<double> t(n), p(n);
+        for (int i = 0; i < n; ++i) {
+            t[i] = (i + 1) / 3600.0; // 1 秒采样，单位 h
+            p[i] = 2.0 * std::log(t[i] + 1e-3) + 0.01 * std::sin(0.1 * i) + 10.0;
+        }
+
+        for (const AlgorithmCase& c : algorithms) {
+            DerivativeEngine::Options options;
+            options.algorithm = c.algorithm;
+            options.lSpacing = 0.1;
+
+            Timing timing = measure([&]() {
+                DerivativeEngine::compute(t, p, options);
+            }, 500.0, 20);
+
+            QJsonObject obj = timingToJson(timing);
+            obj["name"] = QString("%1_derivative").arg(c.name);
+            obj["points"] = n;
+            obj["l_spacing"] = options.lSpacing;
+            results.append(obj);
+            log << QString("%1 points=%2  %3 ms\n").arg(c.name).arg(n).arg(timing.meanMs, 0, 'f', 3);
+            log.flush();
+        }
+    }
+}
+
+// 3. 合成数据上的完整 LM 拟合：由真值生成观测曲线，从偏离的初值出发拟合 3 个参数
+void benchmarkFit(QJsonArray& results, QTextStream& log)
+{
+    ModelType type = ModelSolver01_06::Model_2;
+    QMap<QString, double> truth = benchmarkParameters(type, 4);
+    QVector<double> t = ModelSolver01_06::generateLogTimeSteps(60, -2.0, 2.0);
+
+    ModelSolver01_06 reference(type);
+    ModelCurveData observed = reference.calculateTheoreticalCurve(truth, t, ModelSolver01_06::CalcOptions());
+
+    QList<FitParameter> params;
+    for (auto it = truth.constBegin(); it != truth.constEnd(); ++it) {
+        FitParameter fp;
+        fp.name = it.key();
+        fp.displayName = it.key();
+        fp.value = it.value();
+        fp.isFit = false;
+        fp.min = it.value() * 1e-3;
+        fp.max = it.value() * 1e3;
+        fp.isVisible = true;
+        if (fp.name == "kf") { fp.value *= 3.0; fp.isFit = true; }
+        else if (fp.name == "km") { fp.value *= 0.5; fp.isFit = true; }
+        else if (fp.name == "omega1") { fp.value *= 1.5; fp.isFit = true; fp.max = 1.0; }
+        params.append(fp);
+    }
+
+    // 各优化算法对比；LM 另测每 4 次迭代完整计算一次雅可比 (其间 Broyden 秩一更新) 的方式，
+    // 以及在此基础上的分级精度 (N=4 -> 8 -> 12，数据密度逐级加大)
+    struct FitCase {
+        LeastSquaresOptimizer::Algorithm algorithm;
+        int refreshInterval;
+        bool staged;
+    };
+    const FitCase cases[] = {
+        { LeastSquaresOptimizer::LevenbergMarquardt, 1, false },
+        { LeastSquaresOptimizer::LevenbergMarquardt, 4, false },
+        { LeastSquaresOptimizer::LevenbergMarquardt, 4, true },
+        { LeastSquaresOptimizer::DoglegTrustRegion, 1, false },
+        { LeastSquaresOptimizer::BoundedLBFGS, 1, false }
+    };
+    for (const FitCase& c : cases) {
+        // 收敛阈值比界面默认值严格，保证测到多次完整迭代 (雅可比 + 步长调整)
+        FittingCore::Options options;
+        options.targetMse = 1e-8;
+        options.algorithm = c.algorithm;
+        options.jacobianRefreshInterval = c.refreshInterval;
+        if (c.staged) {
+            options.stehfestSchedule = { 4, 8, 12 };
+            options.pointsPerCycleSchedule = { 10, 25, 0 };
+        }
+
+        FittingCore::Result fitResult;
+        Timing timing = measure([&]() {
+            FittingCore core(QSharedPointer<ModelSolver01_06>::create(type));
+            core.setObservedData(std::get<0>(observed), std::get<1>(observed), std::get<2>(observed));
+            fitResult = core.run(params, options);
+        }, 0.0, 1);
+
+        QString name = QString("%1_fit").arg(LeastSquaresOptimizer::algorithmName(c.algorithm));
+        if (c.refreshInterval > 1) name += "_broyden";
+        if (c.staged) name += "_staged";
+        QJsonObject obj = timingToJson(timing);
+        obj["name"] = name;
+        obj["model"] = (int)type + 1;
+        obj["nf"] = 4;
+        obj["points"] = t.size();
+        obj["fitted_parameters"] = 3;
+        obj["jacobian_refresh_interval"] = c.refreshInterval;
+        obj["iterations"] = fitResult.iterations;
+        obj["jacobian_evaluations"] = fitResult.jacobianEvaluations;
+        obj["precision_stages"] = fitResult.precisionStages;
+        obj["final_mse"] = fitResult.mse;
+        results.append(obj);
+        log << QString("%1 iterations=%2 jacobians=%3 mse=%4  %5 ms\n")
+               .arg(name).arg(fitResult.iterations).arg(fitResult.jacobianEvaluations)
+               .arg(fitResult.mse, 0, 'e', 3).arg(timing.meanMs, 0, 'f', 3);
+        log.flush();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("solverbenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("ModelSolver01_06 / Bourdet 导数 / LM 拟合性能基准");
+    parser.addHelpOption();
+    QCommandLineOption quickOption("quick", "缩小规模快速运行 (跳过最大的裂缝条数与点数)");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "JSON 结果输出文件 (默认输出到标准输出)", "file");
+    parser.addOption(quickOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    bool quick = parser.isSet(quickOption);
+    QTextStream log(stderr);
+
+    QJsonArray results;
+    benchmarkCurves(results, quick, log);
+    benchmarkInversion(results, quick, log);
+    benchmarkDerivative(results, quick, log);
+    benchmarkFit(results, log);
+
+    QJsonObject root;
+    root["suite"] = "solverbenchmark";
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["qt_version"] = QString(qVersion());
+    root["solver_threads"] = ModelSolver01_06::maxThreadCount();
+    root["stehfest_n"] = 8;
+    root["laplace_cache"] = false;
+    root["quick"] = quick;
+    root["results"] = results;
+
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            log << "无法写入文件: " << parser.value(outputOption) << "\n";
+            return 1;
+        }
+        file.write(json);
+        file.close();
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
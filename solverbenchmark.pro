@@ -0,0 +1,28 @@
+######################################################################
+# 求解器性能基准程序 (无界面)
+# 构建: qmake WellTestAll.pro && make  (或先构建 welltestcore.pro)
+# 运行: solverbenchmark [--quick] [--output result.json]
+# 热路径计数: qmake CONFIG+=profiling WellTestAll.pro (计算核心与基准程序同时打开 WELLTEST_PROFILING)
+######################################################################
+QT += core gui concurrent
+QT -= widgets
+
+TEMPLATE = app
+TARGET = solverbenchmark
+CONFIG += console c++17
+CONFIG -= app_bundle
+INCLUDEPATH += .
+
+# 与主程序保持一致的优化选项，保证测得的时间有可比性
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+include(welltestcore.pri)
+
+unix: LIBS += -lm
+win32: LIBS += -lm
+
+SOURCES += solverbenchmark.cpp
+
+QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
@@ -0,0 +1,167 @@
+/*
+ * 文件名: solverjob.cpp
+ * 文件作用: 可取消、可报告进度的求解任务实现
+ * 功能描述:
+ * 1. 停止判断：取消标志为原子量，截止时间按 steady_clock 比较，外部停止条件成立后锁存为已停止。
+ * 2. 进度回调只在千分位增大时触发 (比较交换)，避免每个时间点都回调。
+ * 3. 异步任务使用 QtConcurrent::run 的 QPromise 形式，future 的取消状态作为控制块的停止条件。
+ * 4. 并发任务在局部线程池中启动固定数目的工作者，按原子计数依次领取参数组；
+ *    每条曲线内部的时间点仍在求解器线程池中并行，工作者只补足单条曲线并行不足的部分。
+ */
+
+#include "solverjob.h"
+
+#include <QPromise>
+#include <QThread>
+#include <QtConcurrent>
+#include <chrono>
+
+namespace {
+qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+void SolverControl::setDeadline(qint64 msecs)
+{
+    m_deadlineNs.store(msecs < 0 ? -1 : steadyNowNs() + msecs * 1000000, std::memory_order_relaxed);
+}
+
+bool SolverControl::shouldStop()
+{
+    if (m_stopped.load(std::memory_order_relaxed)) return true;
+    qint64 deadline = m_deadlineNs.load(std::memory_order_relaxed);
+    if (deadline >= 0 && steadyNowNs() >= deadline) {
+        m_timedOut.store(true, std::memory_order_relaxed);
+        m_stopped.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    if (m_stopPredicate && m_stopPredicate()) {
+        m_stopped.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void SolverControl::addWork(int points)
+{
+    if (points > 0) m_total.fetch_add(points, std::memory_order_relaxed);
+}
+
+void SolverControl::advance(int points)
+{
+    int done = m_done.fetch_add(points, std::memory_order_relaxed) + points;
+    if (!m_onProgress) return;
+    int total = m_total.load(std::memory_order_relaxed);
+    if (total <= 0) return;
+    int permille = (int)qMin<qint64>(1000, (qint64)done * 1000 / total);
+    int last = m_reportedPermille.load(std::memory_order_relaxed);
+    while (permille > last) {
+        if (m_reportedPermille.compare_exchange_weak(last, permille, std::memory_order_relaxed)) {
+            m_onProgress(permille / 1000.0);
+            break;
+        }
+    }
+}
+
+double SolverControl::progress() const
+{
+    int total = m_total.load(std::memory_order_relaxed);
+    return total > 0 ? qMin(1.0, double(m_done.load(std::memory_order_relaxed)) / total) : 0.0;
+}
+
+void SolverControl::resetProgress()
+{
+    m_total.store(0, std::memory_order_relaxed);
+    m_done.store(0, std::memory_order_relaxed);
+    m_reportedPermille.store(-1, std::memory_order_relaxed);
+}
+
+QFuture<ModelCurveData> SolverJob::start(ModelSolver01_06* solver, const QList<QMap<QString, double>>& paramSets,
+                                         const QVector<double>& t, const ModelSolver01_06::CalcOptions& options,
+                                         qint64 deadlineMs, QThreadPool* pool)
+{
+    return QtConcurrent::run(pool, [solver, paramSets, t, options, deadlineMs](QPromise<ModelCurveData>& promise) {
+        const int count = paramSets.size();
+        promise.setProgressRange(0, PROGRESS_RANGE);
+        if (!solver || count == 0) return;
+
+        SolverControl control;
+        control.setStopPredicate([&promise]() { return promise.isCanceled(); });
+        control.setDeadline(deadlineMs);
+        int current = 0;
+        // 第 i 条曲线占总进度的 [i/count, (i+1)/count)
+        control.setProgressCallback([&promise, &current, count](double fraction) {
+            promise.setProgressValue((int)((current + fraction) / count * PROGRESS_RANGE));
+        });
+
+        ModelSolver01_06::CalcOptions jobOptions = options;
+        jobOptions.control = &control;
+        for (current = 0; current < count; ++current) {
+            control.resetProgress();
+            ModelCurveData curve = solver->calculateTheoreticalCurve(paramSets[current], t, jobOptions);
+            if (control.shouldStop()) return;
+            promise.addResult(curve, current);
+            promise.setProgressValue((current + 1) * PROGRESS_RANGE / count);
+        }
+    });
+}
+
+QFuture<ModelCurveData> SolverJob::startConcurrent(ModelSolver01_06* solver, const QList<QMap<QString, double>>& paramSets,
+                                                   const QVector<double>& t, const ModelSolver01_06::CalcOptions& options,
+                                                   int maxConcurrentCurves, qint64 deadlineMs, QThreadPool* pool)
+{
+    return QtConcurrent::run(pool, [solver, paramSets, t, options, maxConcurrentCurves, deadlineMs](QPromise<ModelCurveData>& promise) {
+        const int count = paramSets.size();
+        promise.setProgressRange(0, PROGRESS_RANGE);
+        if (!solver || count == 0) return;
+
+        SolverControl control;
+        control.setStopPredicate([&promise]() { return promise.isCanceled(); });
+        control.setDeadline(deadlineMs);
+        if (count == 1) {
+            control.setProgressCallback([&promise](double fraction) { promise.setProgressValue((int)(fraction * PROGRESS_RANGE)); });
+        }
+        ModelSolver01_06::CalcOptions jobOptions = options;
+        jobOptions.control = &control;
+
+        // 第一轮：每条型曲线的第一组参数及不查型曲线的全部参数组；第二轮：其余参数组
+        QVector<int> firstWave, secondWave;
+        QHash<quint64, int> seenShapes;
+        for (int i = 0; i < count; ++i) {
+            if (options.typeCurveLookup) {
+                quint64 shape = solver->typeCurveHash(ModelSolver01_06::ParamSet::fromMap(paramSets[i]), options);
+                if (seenShapes.contains(shape)) {
+                    secondWave.append(i);
+                    continue;
+                }
+                seenShapes.insert(shape, i);
+            }
+            firstWave.append(i);
+        }
+
+        int threads = maxConcurrentCurves > 0 ? maxConcurrentCurves : QThread::idealThreadCount();
+        std::atomic<int> finished{0};
+        auto runWave = [&](const QVector<int>& wave) {
+            std::atomic<int> next{0};
+            QThreadPool workers;
+            workers.setMaxThreadCount(qMax(1, threads));
+            for (int w = 0; w < qMin(threads, wave.size()); ++w) {
+                workers.start([&]() {
+                    for (int k = next++; k < wave.size(); k = next++) {
+                        if (control.shouldStop()) return;
+                        const int i = wave[k];
+                        ModelCurveData curve = solver->calculateTheoreticalCurve(paramSets[i], t, jobOptions);
+                        if (control.shouldStop()) return;
+                        promise.addResult(curve, i);
+                        promise.setProgressValue((finished.fetch_add(1) + 1) * PROGRESS_RANGE / count);
+                    }
+                });
+            }
+            workers.waitForDone();
+        };
+        runWave(firstWave);
+        if (!control.shouldStop()) runWave(secondWave);
+    });
+}
@@ -0,0 +1,95 @@
+/*
+ * 文件名: solverjob.h
+ * 文件作用: 可取消、可报告进度的求解任务头文件 (不依赖界面)
+ * 功能描述:
+ * 1. SolverControl：一次计算的控制块，由求解器在每个 Laplace 求值点与每个时间点检查，
+ *    取消、截止时间到或外部停止条件成立后计算尽快返回空曲线 (不写入任何缓存)。
+ * 2. SolverControl 同时统计已完成的时间点数，进度按千分位变化时回调 (可能在求解器的工作线程中)。
+ * 3. SolverJob：在线程池中异步计算一组参数的理论曲线，返回 QFuture，每条曲线一个结果；
+ *    future.cancel() 即取消，进度范围 0..PROGRESS_RANGE，可设置截止时间。
+ * 4. 多条曲线可并发计算 (startConcurrent)，每条算完立即报告结果；共用同一条型曲线的参数组
+ *    先只算一条，其余在它补齐型曲线后再算，避免重复反演。
+ */
+
+#ifndef SOLVERJOB_H
+#define SOLVERJOB_H
+
+#include <QFuture>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include "modelsolver01-06.h"
+
+class SolverControl
+{
+public:
+    using StopPredicate = std::function<bool()>;
+    // fraction 为当前计算已完成的比例 (0..1)，可能同时在多个线程中调用
+    using ProgressCallback = std::function<void(double fraction)>;
+
+    SolverControl() = default;
+    SolverControl(const SolverControl&) = delete;
+    SolverControl& operator=(const SolverControl&) = delete;
+
+    // 以下设置应在计算开始前完成，计算期间只读
+    void setStopPredicate(StopPredicate pred) { m_stopPredicate = pred; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    // 截止时间：从现在起 msecs 毫秒，<0 表示不限时
+    void setDeadline(qint64 msecs);
+
+    // 可在任意线程调用
+    void cancel() { m_stopped.store(true, std::memory_order_relaxed); }
+    // 取消、截止时间到或停止条件成立时返回 true，此后一直为 true
+    bool shouldStop();
+    bool isStopped() const { return m_stopped.load(std::memory_order_relaxed); }
+    // 是否因截止时间到而停止
+    bool timedOut() const { return m_timedOut.load(std::memory_order_relaxed); }
+
+    // 进度统计 (单位为时间点)：求解器开始一段计算时登记总量，每完成一个时间点推进一次
+    void addWork(int points);
+    void advance(int points = 1);
+    double progress() const;
+    // 清零进度统计 (同一控制块依次用于多次计算时)
+    void resetProgress();
+
+private:
+    std::atomic<bool> m_stopped{false};
+    std::atomic<bool> m_timedOut{false};
+    std::atomic<qint64> m_deadlineNs{-1}; // steady_clock 时刻 (纳秒)
+    std::atomic<int> m_total{0};
+    std::atomic<int> m_done{0};
+    std::atomic<int> m_reportedPermille{-1};
+    StopPredicate m_stopPredicate;
+    ProgressCallback m_onProgress;
+};
+
+class SolverJob
+{
+public:
+    static const int PROGRESS_RANGE = 1000;
+
+    /**
+     * @brief 在 pool 中依次计算 paramSets 中各参数组在时间 t 上的理论曲线 (第 i 个结果对应第 i 组参数)
+     * 进度为全部曲线的总进度；取消或超过截止时间 (deadlineMs >= 0) 后剩余曲线不再计算，future 只含已完成的结果。
+     * solver 由调用方持有，须在任务结束前保持有效 (析构前可 cancel 后 waitForFinished)。
+     */
+    static QFuture<ModelCurveData> start(ModelSolver01_06* solver, const QList<QMap<QString, double>>& paramSets,
+                                         const QVector<double>& t, const ModelSolver01_06::CalcOptions& options,
+                                         qint64 deadlineMs = -1, QThreadPool* pool = QThreadPool::globalInstance());
+
+    /**
+     * @brief 同时计算至多 maxConcurrentCurves 条曲线 (<=0 时按 CPU 核数)，结果按完成先后报告，下标仍对应参数组
+     * 逐条接收结果用 QFutureWatcher::resultReadyAt；进度按已完成的曲线条数计 (只有一条曲线时按时间点计)。
+     * options.typeCurveLookup 为 true 时，型曲线相同 (typeCurveHash) 的参数组中第一组先算，其余在第二轮计算并直接命中型曲线库。
+     */
+    static QFuture<ModelCurveData> startConcurrent(ModelSolver01_06* solver, const QList<QMap<QString, double>>& paramSets,
+                                                   const QVector<double>& t, const ModelSolver01_06::CalcOptions& options,
+                                                   int maxConcurrentCurves = 0, qint64 deadlineMs = -1,
+                                                   QThreadPool* pool = QThreadPool::globalInstance());
+};
+
+#endif // SOLVERJOB_H
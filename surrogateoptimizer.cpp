@@ -0,0 +1,272 @@
+/*
+ * 文件名: surrogateoptimizer.cpp
+ * 文件作用: 代理模型辅助全局搜索实现
+ * 功能描述:
+ * 1. 单位立方体坐标与模型参数互相换算，裂缝条数 nf 取整后再换回坐标，保证样本与真实求解一致。
+ * 2. 高斯过程：核 k(a,b) = s^2 * exp(-|a-b|^2 / (2*l^2)) 加微小噪声项，
+ *    s^2 取边缘似然的解析最优值，l 在一组候选值中按边缘似然选取。
+ * 3. 候选点一半在整个立方体内均匀抽取，一半在当前最优样本附近按正态扰动抽取。
+ */
+
+#include "surrogateoptimizer.h"
+#include "multistartfitter.h"
+
+#include <QtConcurrent>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+
+SurrogateOptimizer::SurrogateOptimizer(QSharedPointer<ModelSolver01_06> solver)
+    : m_solver(solver)
+{
+}
+
+void SurrogateOptimizer::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv)
+{
+    m_obsTime = t;
+    m_obsDeltaP = deltaP;
+    m_obsDerivative = deriv;
+}
+
+bool SurrogateOptimizer::fitGaussianProcess(const Eigen::MatrixXd& X, const Eigen::VectorXd& y, GaussianProcess& gp)
+{
+    const int n = X.rows();
+    if (n == 0) return false;
+    const double nugget = 1e-6;
+
+    gp.X = X;
+    gp.mean = y.mean();
+    double var = (y.array() - gp.mean).square().sum() / n;
+    gp.scale = var > 1e-24 ? std::sqrt(var) : 1.0;
+    Eigen::VectorXd yn = (y.array() - gp.mean) / gp.scale;
+
+    // 两两距离平方只算一次，各候选长度尺度共用
+    Eigen::MatrixXd dist2(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = i; j < n; ++j) {
+            dist2(i, j) = dist2(j, i) = (X.row(i) - X.row(j)).squaredNorm();
+        }
+    }
+
+    static const double lengthScales[] = { 0.05, 0.1, 0.15, 0.2, 0.3, 0.5, 0.8, 1.2 };
+    double bestLikelihood = -std::numeric_limits<double>::infinity();
+    Eigen::MatrixXd K(n, n);
+    for (double l : lengthScales) {
+        K = (-dist2.array() / (2.0 * l * l)).exp().matrix();
+        K.diagonal().array() += nugget;
+        Eigen::LLT<Eigen::MatrixXd> llt(K);
+        if (llt.info() != Eigen::Success) continue;
+
+        Eigen::VectorXd alpha = llt.solve(yn);
+        double s2 = qMax(yn.dot(alpha) / n, 1e-12);
+        // 代入 s^2 最优值后的对数边缘似然 (略去常数项)
+        double logDet = 2.0 * llt.matrixL().toDenseMatrix().diagonal().array().log().sum();
+        double likelihood = -0.5 * n * std::log(s2) - 0.5 * logDet;
+        if (likelihood > bestLikelihood) {
+            bestLikelihood = likelihood;
+            gp.lengthScale = l;
+            gp.signalVariance = s2;
+            gp.alpha = alpha;
+            gp.llt = llt;
+        }
+    }
+    return std::isfinite(bestLikelihood);
+}
+
+void SurrogateOptimizer::predict(const GaussianProcess& gp, const Eigen::VectorXd& x, double& mean, double& stddev)
+{
+    const int n = gp.X.rows();
+    Eigen::VectorXd k(n);
+    for (int i = 0; i < n; ++i) {
+        k[i] = std::exp(-(gp.X.row(i).transpose() - x).squaredNorm() / (2.0 * gp.lengthScale * gp.lengthScale));
+    }
+    Eigen::VectorXd v = gp.llt.matrixL().solve(k);
+    double var = gp.signalVariance * qMax(1.0 - v.squaredNorm(), 0.0);
+    mean = gp.mean + gp.scale * k.dot(gp.alpha);
+    stddev = gp.scale * std::sqrt(var);
+}
+
+double SurrogateOptimizer::expectedImprovement(double best, double mean, double stddev)
+{
+    double improvement = best - mean;
+    if (stddev < 1e-12) return qMax(improvement, 0.0);
+    double z = improvement / stddev;
+    double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+    double pdf = std::exp(-0.5 * z * z) / std::sqrt(2.0 * M_PI);
+    return improvement * cdf + stddev * pdf;
+}
+
+SurrogateOptimizer::Result SurrogateOptimizer::run(const QList<FitParameter>& params, const Options& options)
+{
+    Result result;
+    for (const auto& p : params) result.params.insert(p.name, p.value);
+    if (!m_solver || m_obsTime.isEmpty()) return result;
+
+    QVector<int> fitIndices;
+    for (int i = 0; i < params.size(); ++i) {
+        if (params[i].isFit) fitIndices.append(i);
+    }
+    const int dims = fitIndices.size();
+    if (dims == 0) return result;
+
+    FittingCore core(m_solver);
+    core.setObservedData(m_obsTime, m_obsDeltaP, m_obsDerivative);
+    core.setFitWindows(m_windows);
+    const double weight = options.fit.weight;
+
+    // 单位立方体坐标 <-> 参数值
+    QVector<bool> logSample(dims);
+    QVector<double> lo(dims), hi(dims);
+    for (int k = 0; k < dims; ++k) {
+        const FitParameter& p = params[fitIndices[k]];
+        logSample[k] = MultiStartFitter::sampleInLogSpace(p);
+        lo[k] = logSample[k] ? std::log10(p.min) : p.min;
+        hi[k] = logSample[k] ? std::log10(p.max) : p.max;
+    }
+    auto toParams = [&](const Eigen::VectorXd& u) {
+        QMap<QString, double> map = result.params;
+        for (int k = 0; k < dims; ++k) {
+            const FitParameter& p = params[fitIndices[k]];
+            double v = lo[k] + u[k] * (hi[k] - lo[k]);
+            if (logSample[k]) v = std::pow(10.0, v);
+            if (p.name == "nf") v = std::round(v);
+            map[p.name] = v;
+        }
+        return map;
+    };
+    auto toUnit = [&](const QMap<QString, double>& map) {
+        Eigen::VectorXd u(dims);
+        for (int k = 0; k < dims; ++k) {
+            double v = map.value(params[fitIndices[k]].name);
+            if (logSample[k]) v = v > 0 ? std::log10(v) : lo[k];
+            double range = hi[k] - lo[k];
+            u[k] = range > 0 ? qBound(0.0, (v - lo[k]) / range, 1.0) : 0.0;
+        }
+        return u;
+    };
+    // 取整参数的坐标落到与真实求解一致的位置，避免同一个点被代理模型当作两个样本
+    auto snap = [&](const Eigen::VectorXd& u) { return toUnit(toParams(u)); };
+
+    const int maxEvaluations = qMax(2, options.maxEvaluations);
+    int initialCount = options.initialSamples > 0 ? options.initialSamples : qMax(6, 2 * dims + 2);
+    initialCount = qMin(initialCount, maxEvaluations);
+
+    // 初始样本：当前参数值 + 拉丁超立方
+    QVector<Eigen::VectorXd> samples;
+    samples.append(toUnit(result.params));
+    QVector<QVector<double>> lhs = MultiStartFitter::latinHypercube(initialCount - 1, dims, options.randomSeed);
+    for (const QVector<double>& point : lhs) {
+        samples.append(snap(Eigen::Map<const Eigen::VectorXd>(point.constData(), dims)));
+    }
+    QVector<double> mse(samples.size());
+    QVector<int> indices(samples.size());
+    for (int i = 0; i < indices.size(); ++i) indices[i] = i;
+    QtConcurrent::blockingMap(indices, [&](int i) {
+        mse[i] = core.evaluateMse(toParams(samples[i]), weight);
+    });
+
+    int bestIndex = -1;
+    auto reportIfBest = [&](int i) {
+        if (!std::isfinite(mse[i])) return;
+        if (bestIndex >= 0 && mse[i] >= mse[bestIndex]) return;
+        bestIndex = i;
+        if (m_onImprovement) {
+            QMap<QString, double> map = toParams(samples[i]);
+            FittingCore::updateDependentParameters(map);
+            m_onImprovement(mse[i], map, m_solver->calculateTheoreticalCurve(map, QVector<double>(), ModelSolver01_06::CalcOptions()));
+        }
+    };
+    for (int i = 0; i < samples.size(); ++i) reportIfBest(i);
+
+    const int searchPercent = options.localRefine ? 80 : 100;
+    std::mt19937 rng(options.randomSeed + 1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    while (samples.size() < maxEvaluations) {
+        if (m_stopRequested && m_stopRequested()) break;
+        if (m_onProgress) m_onProgress(samples.size() * searchPercent / maxEvaluations);
+
+        // 无法求值的样本按当前最差值再加 1 个数量级参与建模，使代理模型避开该区域
+        const int n = samples.size();
+        double worst = -std::numeric_limits<double>::infinity();
+        for (double v : mse) if (std::isfinite(v)) worst = qMax(worst, std::log10(qMax(v, 1e-300)));
+        if (!std::isfinite(worst)) break;
+
+        Eigen::MatrixXd X(n, dims);
+        Eigen::VectorXd y(n);
+        for (int i = 0; i < n; ++i) {
+            X.row(i) = samples[i].transpose();
+            y[i] = std::isfinite(mse[i]) ? std::log10(qMax(mse[i], 1e-300)) : worst + 1.0;
+        }
+        GaussianProcess gp;
+        if (!fitGaussianProcess(X, y, gp)) break;
+
+        const double best = y[bestIndex];
+        const Eigen::VectorXd& center = samples[bestIndex];
+        double bestEi = -1.0;
+        Eigen::VectorXd next(dims), candidate(dims);
+        for (int c = 0; c < options.candidateCount; ++c) {
+            if (c % 2 == 0) {
+                for (int k = 0; k < dims; ++k) candidate[k] = uniform(rng);
+            } else {
+                for (int k = 0; k < dims; ++k) candidate[k] = qBound(0.0, center[k] + 0.5 * gp.lengthScale * normal(rng), 1.0);
+            }
+            double mean, stddev;
+            predict(gp, candidate, mean, stddev);
+            double ei = expectedImprovement(best, mean, stddev);
+            if (ei > bestEi) {
+                bestEi = ei;
+                next = candidate;
+            }
+        }
+        if (bestEi < options.improvementTolerance) {
+            result.converged = true;
+            break;
+        }
+
+        next = snap(next);
+        bool duplicate = false;
+        for (const Eigen::VectorXd& s : samples) {
+            if ((s - next).squaredNorm() < 1e-12) { duplicate = true; break; }
+        }
+        if (duplicate) {
+            result.converged = true;
+            break;
+        }
+
+        samples.append(next);
+        mse.append(core.evaluateMse(toParams(next), weight));
+        reportIfBest(samples.size() - 1);
+    }
+
+    result.evaluations = samples.size();
+    if (bestIndex < 0) return result;
+
+    result.params = toParams(samples[bestIndex]);
+    FittingCore::updateDependentParameters(result.params);
+    result.mse = mse[bestIndex];
+
+    // 局部精修：代理模型只负责找到正确的盆地，最后几步交给 FittingCore
+    if (options.localRefine && !(m_stopRequested && m_stopRequested())) {
+        QList<FitParameter> start = params;
+        for (auto& p : start) p.value = result.params.value(p.name, p.value);
+        if (m_onImprovement) core.setIterationCallback(m_onImprovement);
+        if (m_onProgress) {
+            core.setProgressCallback([this, searchPercent](int percent) {
+                m_onProgress(searchPercent + percent * (100 - searchPercent) / 100);
+            });
+        }
+        if (m_stopRequested) core.setStopPredicate(m_stopRequested);
+
+        FittingCore::Result refined = core.run(start, options.fit);
+        result.refineIterations = refined.iterations;
+        if (refined.mse < result.mse) {
+            result.params = refined.params;
+            result.mse = refined.mse;
+        }
+    }
+    if (m_onProgress) m_onProgress(100);
+    return result;
+}
@@ -0,0 +1,90 @@
+/*
+ * 文件名: surrogateoptimizer.h
+ * 文件作用: 代理模型辅助全局搜索头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 在拟合参数上下限构成的单位立方体内 (跨数量级的参数取对数) 搜索 log10(MSE) 的全局最小值。
+ * 2. 初始样本由当前参数值和拉丁超立方采样组成，并发调用真实求解器计算。
+ * 3. 以高斯过程 (平方指数核，长度尺度按边缘似然选取) 拟合已求解样本，
+ *    按期望改进 (EI) 在大量候选点中挑选下一个点，只对该点调用真实求解器。
+ * 4. 期望改进足够小或达到求解次数上限后结束，可选以最优样本为初值用 FittingCore 局部精修。
+ */
+
+#ifndef SURROGATEOPTIMIZER_H
+#define SURROGATEOPTIMIZER_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include <functional>
+#include <Eigen/Dense>
+#include "fittingcore.h"
+
+class SurrogateOptimizer
+{
+public:
+    struct Options {
+        int maxEvaluations = 40;        // 真实求解次数上限 (含初始样本，不含局部精修)
+        int initialSamples = 0;         // 初始样本数，0 表示自动取 max(6, 2*维数+2)
+        int candidateCount = 2000;      // 每轮评估期望改进的候选点个数
+        double improvementTolerance = 1e-3; // 最大期望改进 (log10(MSE) 单位) 低于该值时结束
+        quint32 randomSeed = 12345;     // 采样随机种子
+        bool localRefine = true;        // 结束后是否以最优样本为初值局部精修
+        FittingCore::Options fit;       // 局部精修选项，weight 同时用于全局搜索的误差计算
+    };
+
+    struct Result {
+        QMap<QString, double> params;
+        double mse = 0.0;
+        int evaluations = 0;            // 全局搜索阶段的真实求解次数
+        int refineIterations = 0;       // 局部精修迭代次数
+        bool converged = false;         // 是否因期望改进足够小而结束
+    };
+
+    // 出现新的最优样本时调用 (在调用 run 的线程中)，curve 为该解在默认时间网格上的理论曲线
+    using ImprovementCallback = std::function<void(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)>;
+    using ProgressCallback = std::function<void(int percent)>;
+    using StopPredicate = std::function<bool()>;
+
+    // solver 由调用方提供，搜索期间独占使用 (初始样本会并发调用其计算接口)
+    explicit SurrogateOptimizer(QSharedPointer<ModelSolver01_06> solver);
+
+    void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv);
+    // 时间窗口权重与屏蔽点 (见 FittingCore::setFitWindows)
+    void setFitWindows(const FitWindows& windows) { m_windows = windows; }
+    void setImprovementCallback(ImprovementCallback cb) { m_onImprovement = cb; }
+    void setProgressCallback(ProgressCallback cb) { m_onProgress = cb; }
+    void setStopPredicate(StopPredicate pred) { m_stopRequested = pred; }
+
+    Result run(const QList<FitParameter>& params, const Options& options);
+
+private:
+    // 高斯过程模型：输入为单位立方体坐标，输出为标准化后的 log10(MSE)
+    struct GaussianProcess {
+        Eigen::MatrixXd X;          // 样本 (n × d)
+        Eigen::VectorXd alpha;      // K^-1 * y
+        Eigen::LLT<Eigen::MatrixXd> llt;
+        double lengthScale = 0.2;
+        double signalVariance = 1.0;
+        double mean = 0.0;
+        double scale = 1.0;
+    };
+
+    static bool fitGaussianProcess(const Eigen::MatrixXd& X, const Eigen::VectorXd& y, GaussianProcess& gp);
+    // 预测均值与标准差 (log10(MSE) 单位)
+    static void predict(const GaussianProcess& gp, const Eigen::VectorXd& x, double& mean, double& stddev);
+    static double expectedImprovement(double best, double mean, double stddev);
+
+    QSharedPointer<ModelSolver01_06> m_solver;
+    QVector<double> m_obsTime;
+    QVector<double> m_obsDeltaP;
+    QVector<double> m_obsDerivative;
+    FitWindows m_windows;
+
+    ImprovementCallback m_onImprovement;
+    ProgressCallback m_onProgress;
+    StopPredicate m_stopRequested;
+};
+
+#endif // SURROGATEOPTIMIZER_H
@@ -0,0 +1,212 @@
+/*
+ * 文件名: tablesearchindex.cpp
+ * 文件作用: 数据表搜索索引实现
+ * 功能描述:
+ * 1. 数值列把 (值, 行号) 整体排序，范围查询只需两次二分查找，再把命中的行号排序输出。
+ * 2. 文字搜索按组并行比较 (每块各自构造通配符正则)，命中组的行号合并到按行的标记数组后顺序输出。
+ */
+
+#include "tablesearchindex.h"
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include "columnexpression.h"
+#include "measurementtablemodel.h"
+
+namespace {
+
+// 列名 运算符 数值
+const QRegularExpression kConditionPattern(
+    "^\\s*(.+?)\\s*(>=|<=|!=|==|=|>|<)\\s*([-+]?(?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][-+]?\\d+)?)\\s*$");
+
+QVector<int> intersectSorted(const QVector<int>& a, const QVector<int>& b)
+{
+    QVector<int> out;
+    out.reserve(qMin(a.size(), b.size()));
+    std::set_intersection(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(), std::back_inserter(out));
+    return out;
+}
+
+} // namespace
+
+TableSearchIndex::TableSearchIndex(const TextDataTable& table)
+    : m_rowCount(table.rowCount),
+    m_columns(size_t(table.columns.size()))
+{
+    std::vector<int> ids(m_columns.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    QtConcurrent::blockingMap(ids, [&](int c) {
+        m_columns[size_t(c)].header = table.headers.value(c);
+        buildColumn(table.columns[c], m_rowCount, m_columns[size_t(c)]);
+    });
+}
+
+void TableSearchIndex::buildColumn(const TextDataColumn& source, int rowCount, ColumnIndex& index)
+{
+    index.isNumeric = source.isNumeric;
+    if (source.isNumeric) {
+        std::vector<std::pair<double, int>> pairs;
+        pairs.reserve(source.values.size());
+        for (int r = 0; r < rowCount && r < int(source.values.size()); ++r) {
+            if (!std::isnan(source.values[size_t(r)])) pairs.emplace_back(source.values[size_t(r)], r);
+        }
+        std::sort(pairs.begin(), pairs.end());
+
+        index.sortedValues.resize(pairs.size());
+        index.rows.resize(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            index.sortedValues[i] = pairs[i].first;
+            index.rows[i] = pairs[i].second;
+            if (i == 0 || pairs[i].first != pairs[i - 1].first) index.offsets.push_back(int(i));
+        }
+        index.offsets.push_back(int(pairs.size()));
+        return;
+    }
+
+    // 文本列：先给每行确定组号，再按组计数排布 (组内行号保持升序)
+    QHash<QString, int> groupOf;
+    std::vector<int> groups(static_cast<size_t>(rowCount));
+    for (int r = 0; r < rowCount; ++r) {
+        const QString& text = r < int(source.texts.size()) ? source.texts[size_t(r)] : QString();
+        auto it = groupOf.constFind(text);
+        if (it == groupOf.constEnd()) {
+            it = groupOf.insert(text, int(index.keys.size()));
+            index.keys.append(text);
+        }
+        groups[size_t(r)] = it.value();
+    }
+    index.offsets.assign(size_t(index.keys.size()) + 1, 0);
+    for (int g : groups) ++index.offsets[size_t(g) + 1];
+    std::partial_sum(index.offsets.begin(), index.offsets.end(), index.offsets.begin());
+    std::vector<int> fill(index.offsets.begin(), index.offsets.end() - 1);
+    index.rows.resize(static_cast<size_t>(rowCount));
+    for (int r = 0; r < rowCount; ++r) index.rows[size_t(fill[size_t(groups[size_t(r)])]++)] = r;
+}
+
+int TableSearchIndex::findColumn(const QString& name) const
+{
+    // 表头全称或单位前的名称 ("压力\MPa" 可写作 "压力")，不区分大小写
+    for (int c = 0; c < int(m_columns.size()); ++c) {
+        const QString& header = m_columns[size_t(c)].header;
+        if (header.compare(name, Qt::CaseInsensitive) == 0 ||
+            header.section('\\', 0, 0).trimmed().compare(name, Qt::CaseInsensitive) == 0) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+QVector<int> TableSearchIndex::search(const QString& query, QString* errorMessage) const
+{
+    const QStringList parts = query.split("&&");
+    QVector<QRegularExpressionMatch> conditions;
+    QVector<int> columns;
+    for (const QString& part : parts) {
+        QRegularExpressionMatch m = kConditionPattern.match(part);
+        int column = m.hasMatch() ? findColumn(m.captured(1)) : -1;
+        if (column < 0) {
+            // 单个查询不是条件时按文字搜索
+            if (parts.size() == 1) return searchText(query.trimmed());
+            if (errorMessage) *errorMessage = "无法识别的条件: " + part.trimmed();
+            return QVector<int>();
+        }
+        if (!m_columns[size_t(column)].isNumeric) {
+            if (errorMessage) *errorMessage = QString("列 %1 不是数值列").arg(m.captured(1));
+            return QVector<int>();
+        }
+        conditions.append(m);
+        columns.append(column);
+    }
+
+    QVector<int> rows;
+    for (int i = 0; i < conditions.size(); ++i) {
+        QVector<int> hit = searchCondition(m_columns[size_t(columns[i])], conditions[i].captured(2),
+                                           conditions[i].captured(3).toDouble());
+        rows = i == 0 ? hit : intersectSorted(rows, hit);
+    }
+    return rows;
+}
+
+QVector<int> TableSearchIndex::searchCondition(const ColumnIndex& column, const QString& op, double value) const
+{
+    const std::vector<double>& v = column.sortedValues;
+    const int n = int(v.size());
+    const int lo = int(std::lower_bound(v.begin(), v.end(), value) - v.begin());
+    const int hi = int(std::upper_bound(v.begin(), v.end(), value) - v.begin());
+
+    QVector<int> rows;
+    auto take = [&](int begin, int end) {
+        rows.append(QVector<int>(column.rows.begin() + begin, column.rows.begin() + end));
+    };
+    if (op == ">") take(hi, n);
+    else if (op == ">=") take(lo, n);
+    else if (op == "<") take(0, lo);
+    else if (op == "<=") take(0, hi);
+    else if (op == "!=") { take(0, lo); take(hi, n); }
+    else take(lo, hi);
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+QVector<int> TableSearchIndex::searchText(const QString& text) const
+{
+    const bool wildcard = text.contains(QRegularExpression("[*?\\[]"));
+    const QString pattern = wildcard ? QRegularExpression::wildcardToRegularExpression(
+                                           text, QRegularExpression::UnanchoredWildcardConversion)
+                                     : QString();
+    auto matcher = [&]() {
+        QRegularExpression re(pattern, QRegularExpression::CaseInsensitiveOption);
+        return [re, wildcard, &text](const QString& key) {
+            return wildcard ? re.match(key).hasMatch() : key.contains(text, Qt::CaseInsensitive);
+        };
+    };
+
+    // 能匹配空文字的查询 (如 "*") 匹配所有行
+    if (matcher()(QString())) {
+        QVector<int> all(m_rowCount);
+        std::iota(all.begin(), all.end(), 0);
+        return all;
+    }
+
+    std::vector<char> rowHit(static_cast<size_t>(m_rowCount), 0);
+    for (const ColumnIndex& column : m_columns) {
+        const int groups = int(column.offsets.size()) - 1;
+        std::vector<char> groupHit(size_t(qMax(groups, 0)), 0);
+        ColumnExpression::forEachChunk(groups, [&](int begin, int count) {
+            auto matches = matcher(); // 每块使用独立的正则对象
+            for (int g = begin; g < begin + count; ++g) {
+                const QString key = column.isNumeric
+                                        ? MeasurementTableModel::formatNumber(column.sortedValues[size_t(column.offsets[size_t(g)])])
+                                        : column.keys[g];
+                groupHit[size_t(g)] = matches(key);
+            }
+        });
+        for (int g = 0; g < groups; ++g) {
+            if (!groupHit[size_t(g)]) continue;
+            for (int i = column.offsets[size_t(g)]; i < column.offsets[size_t(g) + 1]; ++i) rowHit[size_t(column.rows[size_t(i)])] = 1;
+        }
+    }
+
+    QVector<int> rows;
+    for (int r = 0; r < m_rowCount; ++r) {
+        if (rowHit[size_t(r)]) rows.append(r);
+    }
+    return rows;
+}
+
+QFuture<TableSearchIndex::Result> TableSearchIndex::start(const QSharedPointer<const TableSearchIndex>& index,
+                                                          TextDataTable table, const QString& query)
+{
+    return QtConcurrent::run([index, table = std::move(table), query]() {
+        Result result;
+        result.query = query;
+        result.index = index ? index : QSharedPointer<const TableSearchIndex>(new TableSearchIndex(table));
+        result.rows = result.index->search(query, &result.errorMessage);
+        return result;
+    });
+}
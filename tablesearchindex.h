@@ -0,0 +1,69 @@
+/*
+ * 文件名: tablesearchindex.h
+ * 文件作用: 数据表搜索索引头文件
+ * 功能描述:
+ * 1. 由表格快照为每一列建立索引：数值列按值排序 (值相等的行连续排列)，文本列按不同文字分组。
+ * 2. 查询 "列名 运算符 数值" (运算符 > >= < <= = == !=，多个条件用 && 连接取交集) 在数值索引上二分查找范围。
+ * 3. 其他查询为文字搜索 (不区分大小写，支持 * ? [] 通配符)，在所有列中查找包含该文字的单元格；
+ *    每个不同的值只比较一次，数值按表格显示格式比较。
+ * 4. 建立索引与查询都在线程池中进行，结果为升序的源行号，供 RowFilterProxyModel 直接使用。
+ */
+
+#ifndef TABLESEARCHINDEX_H
+#define TABLESEARCHINDEX_H
+
+#include <QFuture>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <vector>
+#include "textdatareader.h"
+
+class TableSearchIndex
+{
+public:
+    struct Result {
+        QString query;
+        QSharedPointer<const TableSearchIndex> index;   // 本次使用 (或新建立) 的索引
+        QVector<int> rows;                              // 匹配的源行号 (升序)
+        QString errorMessage;                           // 查询有误时非空，此时 rows 为空
+    };
+
+    // 由表格快照建立全部列的索引 (耗时，各列在全局线程池中并行建立)
+    explicit TableSearchIndex(const TextDataTable& table);
+
+    int rowCount() const { return m_rowCount; }
+
+    // 执行查询；查询有误时返回空集合，errorMessage 给出原因
+    QVector<int> search(const QString& query, QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief 在后台执行查询
+     * @param index 已建立的索引；为空时先由 table 建立 (table 在 index 非空时不使用)
+     */
+    static QFuture<Result> start(const QSharedPointer<const TableSearchIndex>& index, TextDataTable table,
+                                 const QString& query);
+
+private:
+    struct ColumnIndex {
+        QString header;
+        bool isNumeric = true;
+        // 行号按组排列，第 k 组为 rows[offsets[k], offsets[k + 1])；
+        // 数值列按值升序 (空值不入索引)，一组为相等的值；文本列一组为相同的文字 (keys[k])
+        std::vector<int> rows;
+        std::vector<int> offsets;
+        std::vector<double> sortedValues;   // 数值列：与 rows 一一对应的值
+        QStringList keys;                   // 文本列：各组的文字
+    };
+
+    static void buildColumn(const TextDataColumn& source, int rowCount, ColumnIndex& index);
+
+    int findColumn(const QString& name) const;
+    QVector<int> searchCondition(const ColumnIndex& column, const QString& op, double value) const;
+    QVector<int> searchText(const QString& text) const;
+
+    int m_rowCount;
+    std::vector<ColumnIndex> m_columns;
+};
+
+#endif // TABLESEARCHINDEX_H
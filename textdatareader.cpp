@@ -0,0 +1,361 @@
+/*
+ * 文件名: textdatareader.cpp
+ * 文件作用: 文本数据文件 (CSV/TXT) 流式读取器实现
+ * 功能描述:
+ * 1. 顺序处理表头行、起始行之前的前导部分，确定分隔符和表头。
+ * 2. 其余数据区按换行边界切分为若干块，各块在线程池中并发扫描行、切分字段，
+ *    数值字段用 std::from_chars 直接从字节解析为 double，遇到非数值字段的列转为文本列。
+ * 3. 按块顺序合并各块的列缓冲区，行序与文件一致；文本列再并发做编码转换。
+ * 4. 文件无法映射时 (如空文件或特殊设备) 退回到一次性读入缓冲区，解析流程不变。
+ */
+
+#include "textdatareader.h"
+#include <QFile>
+#include <QTextCodec>
+#include <QThread>
+#include <QAtomicInt>
+#include <QtConcurrent>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+
+namespace {
+
+// 每个分块的最小字节数，过小的分块调度开销大于解析收益
+const qint64 kMinChunkBytes = 1 << 20;
+// 每个线程平均分到的块数，略多于线程数便于负载均衡
+const int kChunksPerThread = 4;
+
+inline bool isAsciiSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// 去除 [begin, end) 首尾空白
+inline void trimSpan(const char* data, qint64& begin, qint64& end)
+{
+    while (begin < end && isAsciiSpace(data[begin])) ++begin;
+    while (end > begin && isAsciiSpace(data[end - 1])) --end;
+}
+
+} // namespace
+
+// 数据区的一个分块：[begin, end) 两端均位于行首，各块互不重叠、按文件顺序排列
+struct TextDataReader::ParseChunk {
+    qint64 begin = 0;
+    qint64 end = 0;
+    bool preScanned = false;                      // 行位置已在前导段确定，无需再扫描
+    QVector<qint64> rowBegin, rowEnd;             // 块内数据行 (已去除首尾空白)
+    int columnCount = 0;                          // 块内出现的最大字段数
+    std::vector<std::vector<double>> values;      // 块内各列数值 (空单元格为 NaN)
+    std::vector<char> numeric;                    // 块内各列是否全部为数值
+    std::vector<std::vector<QString>> texts;      // 文本列解码结果 (按 textColumns 顺序)
+};
+
+TextDataReader::TextDataReader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TextDataTable TextDataReader::read(const DataImportSettings& settings)
+{
+    TextDataTable table;
+
+    QFile file(settings.filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        table.errorMessage = "无法打开文件: " + settings.filePath;
+        return table;
+    }
+
+    // 选择解码器 (仅用于表头和文本列)
+    QTextCodec* codec = nullptr;
+    if (settings.encoding.startsWith("GBK")) codec = QTextCodec::codecForName("GBK");
+    else if (settings.encoding.startsWith("UTF-8")) codec = QTextCodec::codecForName("UTF-8");
+    else if (settings.encoding.startsWith("ISO")) codec = QTextCodec::codecForName("ISO-8859-1");
+    else codec = QTextCodec::codecForLocale();
+    if (!codec) codec = QTextCodec::codecForName("UTF-8");
+
+    emit progressUpdated(0, "正在映射文件...");
+
+    // 内存映射整个文件；映射失败时退回到读入缓冲区
+    qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray fallback;
+    if (size > 0) data = reinterpret_cast<const char*>(file.map(0, size));
+    if (!data) {
+        fallback = file.readAll();
+        data = fallback.constData();
+        size = fallback.size();
+    }
+
+    qint64 pos = 0;
+    if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF &&
+        static_cast<unsigned char>(data[1]) == 0xBB && static_cast<unsigned char>(data[2]) == 0xBF) {
+        pos = 3; // 跳过 UTF-8 BOM
+    }
+
+    // ---------- 第一遍：顺序处理前导行 (首行、表头行及起始行之前的部分) ----------
+    // 前导段之后的每个非空行都是数据行，与行号无关，因此可以任意分块
+    int startIdx = settings.startRow - 1;
+    int headerIdx = settings.headerRow - 1;
+    int leadLines = qMax(qMax(startIdx, settings.useHeader ? headerIdx + 1 : 0), 1);
+    char separator = ',';
+    QVector<FieldSpan> fields;
+    QVector<ParseChunk> chunks;
+
+    ParseChunk lead;
+    lead.preScanned = true;
+    for (int lineNo = 0; lineNo < leadLines && pos < size; ++lineNo) {
+        const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', size_t(size - pos)));
+        qint64 lineBegin = pos;
+        qint64 lineEnd = nl ? (nl - data) : size;
+        pos = lineEnd + 1;
+
+        if (lineNo == 0) separator = detectSeparator(settings.separator, data, lineBegin, lineEnd);
+
+        bool isHeader = settings.useHeader && lineNo == headerIdx;
+        if (lineNo < startIdx && !isHeader) continue;
+
+        trimSpan(data, lineBegin, lineEnd);
+        if (lineBegin == lineEnd) continue;
+
+        if (isHeader) {
+            splitLine(data, lineBegin, lineEnd, separator, fields);
+            for (const FieldSpan& f : fields) table.headers.append(codec->toUnicode(data + f.begin, int(f.end - f.begin)));
+            table.headerProcessed = true;
+        } else {
+            lead.rowBegin.append(lineBegin);
+            lead.rowEnd.append(lineEnd);
+        }
+    }
+    if (!lead.rowBegin.isEmpty()) chunks.append(lead);
+
+    // 剩余部分按换行边界切块
+    qint64 remaining = qMax<qint64>(0, size - pos);
+    int threads = qMax(1, QThread::idealThreadCount());
+    qint64 chunkBytes = qMax(kMinChunkBytes, remaining / (threads * kChunksPerThread) + 1);
+    while (pos < size) {
+        ParseChunk chunk;
+        chunk.begin = pos;
+        qint64 cut = pos + chunkBytes;
+        if (cut >= size) {
+            cut = size;
+        } else {
+            const char* nl = static_cast<const char*>(std::memchr(data + cut, '\n', size_t(size - cut)));
+            cut = nl ? (nl - data) + 1 : size;
+        }
+        chunk.end = cut;
+        chunks.append(chunk);
+        pos = cut;
+    }
+
+    // ---------- 第二遍：各块并发扫描数据行并解析数值字段 ----------
+    runChunks(chunks, [data, separator](ParseChunk& chunk) { parseChunk(data, separator, chunk); },
+              5, 75, "正在解析数值...");
+
+    // 按块顺序合并：某列在任一块中出现非数值字段，整列按文本处理
+    int rowCount = 0;
+    int columnCount = table.headers.size();
+    for (const ParseChunk& chunk : chunks) {
+        rowCount += chunk.rowBegin.size();
+        columnCount = qMax(columnCount, chunk.columnCount);
+    }
+    table.rowCount = rowCount;
+    table.columns.resize(columnCount);
+
+    emit progressUpdated(80, "正在合并数据列...");
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    QVector<int> textColumns;
+    for (int c = 0; c < columnCount; ++c) {
+        TextDataColumn& col = table.columns[c];
+        for (const ParseChunk& chunk : chunks) {
+            if (c < chunk.columnCount && !chunk.numeric[c]) { col.isNumeric = false; break; }
+        }
+        if (!col.isNumeric) {
+            textColumns.append(c);
+            continue;
+        }
+        col.values.reserve(rowCount);
+        for (ParseChunk& chunk : chunks) {
+            if (c < chunk.columnCount) {
+                col.values.insert(col.values.end(), chunk.values[c].begin(), chunk.values[c].end());
+                chunk.values[c] = std::vector<double>();
+            } else {
+                col.values.insert(col.values.end(), size_t(chunk.rowBegin.size()), nan);
+            }
+        }
+    }
+
+    // ---------- 第三遍：只对文本列做编码转换 ----------
+    if (!textColumns.isEmpty()) {
+        runChunks(chunks, [data, separator, codec, &textColumns](ParseChunk& chunk) {
+                      decodeChunk(data, separator, codec, textColumns, chunk);
+                  }, 85, 10, "正在转换文本列...");
+
+        for (int i = 0; i < textColumns.size(); ++i) {
+            std::vector<QString>& texts = table.columns[textColumns[i]].texts;
+            texts.reserve(rowCount);
+            for (ParseChunk& chunk : chunks) {
+                texts.insert(texts.end(), std::make_move_iterator(chunk.texts[i].begin()),
+                             std::make_move_iterator(chunk.texts[i].end()));
+                chunk.texts[i] = std::vector<QString>();
+            }
+        }
+    }
+
+    file.close();
+    emit progressUpdated(100, "读取完成");
+    table.success = true;
+    return table;
+}
+
+void TextDataReader::parseChunk(const char* data, char separator, ParseChunk& chunk)
+{
+    if (!chunk.preScanned) {
+        qint64 pos = chunk.begin;
+        while (pos < chunk.end) {
+            const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', size_t(chunk.end - pos)));
+            qint64 lineBegin = pos;
+            qint64 lineEnd = nl ? (nl - data) : chunk.end;
+            pos = lineEnd + 1;
+
+            trimSpan(data, lineBegin, lineEnd);
+            if (lineBegin == lineEnd) continue;
+            chunk.rowBegin.append(lineBegin);
+            chunk.rowEnd.append(lineEnd);
+        }
+    }
+
+    int rows = chunk.rowBegin.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    QVector<FieldSpan> fields;
+    for (int r = 0; r < rows; ++r) {
+        splitLine(data, chunk.rowBegin[r], chunk.rowEnd[r], separator, fields);
+        int nFields = fields.size();
+        if (nFields > chunk.columnCount) {
+            chunk.values.resize(nFields);
+            chunk.numeric.resize(nFields, 1);
+            for (int c = chunk.columnCount; c < nFields; ++c) {
+                chunk.values[c].reserve(rows);
+                chunk.values[c].assign(r, nan);
+            }
+            chunk.columnCount = nFields;
+        }
+
+        for (int c = 0; c < chunk.columnCount; ++c) {
+            if (!chunk.numeric[c]) continue;
+            std::vector<double>& values = chunk.values[c];
+            if (c >= nFields || fields[c].begin == fields[c].end) {
+                values.push_back(nan);
+                continue;
+            }
+            double v;
+            if (parseDouble(data + fields[c].begin, fields[c].end - fields[c].begin, v)) {
+                values.push_back(v);
+            } else {
+                // 出现非数值字段，该列在本块内停止数值解析并释放缓冲
+                chunk.numeric[c] = 0;
+                values = std::vector<double>();
+            }
+        }
+    }
+}
+
+void TextDataReader::decodeChunk(const char* data, char separator, QTextCodec* codec,
+                                 const QVector<int>& textColumns, ParseChunk& chunk)
+{
+    // 每个线程使用独立的解码器，避免共享编码器状态；字段均为完整字节序列
+    std::unique_ptr<QTextDecoder> decoder(codec->makeDecoder());
+    int rows = chunk.rowBegin.size();
+    chunk.texts.assign(size_t(textColumns.size()), std::vector<QString>());
+    for (std::vector<QString>& texts : chunk.texts) texts.reserve(rows);
+
+    QVector<FieldSpan> fields;
+    for (int r = 0; r < rows; ++r) {
+        splitLine(data, chunk.rowBegin[r], chunk.rowEnd[r], separator, fields);
+        for (int i = 0; i < textColumns.size(); ++i) {
+            int c = textColumns[i];
+            if (c < fields.size())
+                chunk.texts[i].push_back(decoder->toUnicode(data + fields[c].begin, int(fields[c].end - fields[c].begin)));
+            else
+                chunk.texts[i].push_back(QString());
+        }
+    }
+}
+
+void TextDataReader::runChunks(QVector<ParseChunk>& chunks, const std::function<void(ParseChunk&)>& fn,
+                               int progressBase, int progressSpan, const QString& message)
+{
+    if (chunks.isEmpty()) return;
+
+    // 工作线程只累加完成计数，进度信号始终在调用线程发出
+    QAtomicInt finished(0);
+    QFuture<void> future = QtConcurrent::map(chunks, [&fn, &finished](ParseChunk& chunk) {
+        fn(chunk);
+        finished.fetchAndAddRelaxed(1);
+    });
+    int total = chunks.size();
+    while (!future.isFinished()) {
+        emit progressUpdated(progressBase + progressSpan * finished.loadRelaxed() / total, message);
+        QThread::msleep(20);
+    }
+    future.waitForFinished();
+}
+
+void TextDataReader::splitLine(const char* data, qint64 lineBegin, qint64 lineEnd, char separator, QVector<FieldSpan>& fields)
+{
+    fields.clear();
+    qint64 fieldBegin = lineBegin;
+    while (true) {
+        const char* sep = static_cast<const char*>(std::memchr(data + fieldBegin, separator, size_t(lineEnd - fieldBegin)));
+        qint64 fieldEnd = sep ? (sep - data) : lineEnd;
+
+        // 去除首尾空白和包围引号
+        FieldSpan f = {fieldBegin, fieldEnd};
+        trimSpan(data, f.begin, f.end);
+        if (f.end > f.begin && data[f.begin] == '"' && data[f.end - 1] == '"') {
+            if (f.end - f.begin >= 2) { ++f.begin; --f.end; }
+            else f.begin = f.end;
+        }
+        fields.append(f);
+
+        if (!sep) break;
+        fieldBegin = fieldEnd + 1;
+    }
+}
+
+char TextDataReader::detectSeparator(const QString& setting, const char* data, qint64 lineBegin, qint64 lineEnd)
+{
+    if (setting.contains("Tab")) return '\t';
+    if (setting.contains("Space")) return ' ';
+    if (setting.contains("Semicolon")) return ';';
+    if (setting.contains("Auto")) {
+        qint64 tabs = 0, commas = 0;
+        for (qint64 i = lineBegin; i < lineEnd; ++i) {
+            if (data[i] == '\t') ++tabs;
+            else if (data[i] == ',') ++commas;
+        }
+        if (tabs > commas) return '\t';
+    }
+    return ',';
+}
+
+bool TextDataReader::parseDouble(const char* begin, qint64 length, double& value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    // 快速路径：std::from_chars 与区域设置无关且不分配内存；不接受前导正号，在此跳过
+    const char* end = begin + length;
+    const char* p = begin;
+    if (p < end && *p == '+') ++p;
+    if (p < end && *p != '+' && !(p != begin && *p == '-')) {
+        std::from_chars_result r = std::from_chars(p, end, value);
+        if (r.ec == std::errc() && r.ptr == end) return true;
+    }
+#endif
+    // 溢出、下溢等快速路径不处理的写法交给 Qt 解析，保持原有的判定结果
+    bool ok = false;
+    value = QByteArray::fromRawData(begin, int(length)).toDouble(&ok);
+    return ok;
+}
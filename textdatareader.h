@@ -0,0 +1,84 @@
+/*
+ * 文件名: textdatareader.h
+ * 文件作用: 文本数据文件 (CSV/TXT) 流式读取器头文件
+ * 功能描述:
+ * 1. 以内存映射方式读取文件，不再整体读入并解码为一个大字符串。
+ * 2. 数值列直接从字节解析为列式 double 缓冲区，只有文本列才做编码转换。
+ * 3. 数据区按换行边界切分为若干块，在线程池中并发解析，合并时保持原有行序。
+ * 4. 分块处理并通过信号报告进度，适用于井下永久压力计导出的数百万行数据。
+ * 5. 表头行、起始行、分隔符、去引号等规则与 DataImportSettings 的原有语义一致。
+ */
+
+#ifndef TEXTDATAREADER_H
+#define TEXTDATAREADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+#include <functional>
+#include "dataimportdialog.h" // DataImportSettings 定义
+
+class QTextCodec;
+
+// 单列数据：数值列只存 values (空单元格为 NaN)，文本列只存 texts
+struct TextDataColumn {
+    bool isNumeric;
+    std::vector<double> values;
+    std::vector<QString> texts;
+
+    TextDataColumn() : isNumeric(true) {}
+};
+
+// 读取结果
+struct TextDataTable {
+    bool success;
+    QString errorMessage;
+    bool headerProcessed;           // 是否读取到表头行
+    QStringList headers;            // 表头字段 (可能少于或多于数据列数)
+    int rowCount;                   // 数据行数
+    QVector<TextDataColumn> columns;
+
+    TextDataTable() : success(false), headerProcessed(false), rowCount(0) {}
+};
+
+class TextDataReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TextDataReader(QObject *parent = nullptr);
+
+    /**
+     * @brief 按导入配置读取文本文件
+     * @param settings 导入配置 (编码、分隔符、表头行、起始行)
+     * @return 列式数据表，失败时 success 为 false 并给出 errorMessage
+     */
+    TextDataTable read(const DataImportSettings& settings);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+
+private:
+    // 一行中的一个字段在缓冲区中的位置 [begin, end)
+    struct FieldSpan { qint64 begin; qint64 end; };
+    // 数据区的一个分块及其解析结果 (定义见实现文件)
+    struct ParseChunk;
+
+    // 扫描分块内的数据行并解析数值字段 (在工作线程中执行)
+    static void parseChunk(const char* data, char separator, ParseChunk& chunk);
+    // 对分块内的文本列做编码转换 (在工作线程中执行)
+    static void decodeChunk(const char* data, char separator, QTextCodec* codec,
+                            const QVector<int>& textColumns, ParseChunk& chunk);
+    // 在线程池中对所有分块执行 fn，期间按完成块数报告进度
+    void runChunks(QVector<ParseChunk>& chunks, const std::function<void(ParseChunk&)>& fn,
+                   int progressBase, int progressSpan, const QString& message);
+
+    // 将 [lineBegin, lineEnd) 按分隔符切分为字段 (已去除首尾空白和包围引号)
+    static void splitLine(const char* data, qint64 lineBegin, qint64 lineEnd, char separator, QVector<FieldSpan>& fields);
+    static char detectSeparator(const QString& setting, const char* data, qint64 lineBegin, qint64 lineEnd);
+    static bool parseDouble(const char* begin, qint64 length, double& value);
+};
+
+#endif // TEXTDATAREADER_H
@@ -0,0 +1,147 @@
+/*
+ * 文件名: timestampparser.cpp
+ * 文件作用: 日期/时刻文本快速解析实现
+ * 功能描述:
+ * 1. 固定格式解析只检查长度、分隔符和 ASCII 数字，并校验月、日 (含闰年)、时、分、秒的范围。
+ * 2. 天数按公历日期直接换算 (days_from_civil)，不构造 QDate/QDateTime。
+ */
+
+#include "timestampparser.h"
+#include <QDate>
+#include <QTime>
+
+namespace {
+
+const qint64 kUnixEpochJulianDay = 2440588; // 1970-01-01
+
+// 读取 [pos, pos + n) 的十进制数字，不是数字时返回 -1
+inline int readDigits(const QString& text, int pos, int n)
+{
+    int v = 0;
+    for (int i = pos; i < pos + n; ++i) {
+        const ushort c = text[i].unicode();
+        if (c < '0' || c > '9') return -1;
+        v = v * 10 + (c - '0');
+    }
+    return v;
+}
+
+inline bool isLeapYear(int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+inline int daysInMonth(int y, int m)
+{
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && isLeapYear(y) ? 29 : days[m - 1];
+}
+
+// 公历日期到 1970-01-01 起天数的换算 (y >= 1)
+inline qint64 daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    const qint64 era = y / 400;
+    const qint64 yoe = y - era * 400;
+    const qint64 doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const qint64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+template <typename Parse>
+TimestampParser::Format detect(const QStringList& samples, std::initializer_list<TimestampParser::Format> candidates,
+                               Parse parse)
+{
+    TimestampParser::Format best = TimestampParser::UnknownFormat;
+    int bestCount = 0;
+    for (TimestampParser::Format format : candidates) {
+        int count = 0;
+        for (const QString& s : samples) {
+            if (parse(s, format) != TimestampParser::INVALID) ++count;
+        }
+        if (count > bestCount) {
+            best = format;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+TimestampParser::Format TimestampParser::detectDateFormat(const QStringList& samples)
+{
+    return detect(samples, {DateDash, DateSlash}, parseDateFixed);
+}
+
+TimestampParser::Format TimestampParser::detectTimeFormat(const QStringList& samples)
+{
+    return detect(samples, {TimeHms, TimeHm}, parseTimeFixed);
+}
+
+qint64 TimestampParser::parseDate(const QString& text, Format format)
+{
+    if (text.isEmpty()) return INVALID;
+    qint64 days = parseDateFixed(text, format);
+    return days != INVALID ? days : parseDateFallback(text);
+}
+
+qint64 TimestampParser::parseTime(const QString& text, Format format)
+{
+    if (text.isEmpty()) return INVALID;
+    qint64 seconds = parseTimeFixed(text, format);
+    return seconds != INVALID ? seconds : parseTimeFallback(text);
+}
+
+qint64 TimestampParser::parseDateFixed(const QString& text, Format format)
+{
+    // yyyy?MM?dd
+    if (format != DateDash && format != DateSlash) return INVALID;
+    const QChar sep = format == DateDash ? QLatin1Char('-') : QLatin1Char('/');
+    if (text.size() != 10 || text[4] != sep || text[7] != sep) return INVALID;
+    const int y = readDigits(text, 0, 4);
+    const int m = readDigits(text, 5, 2);
+    const int d = readDigits(text, 8, 2);
+    if (y < 1 || m < 1 || m > 12 || d < 1 || d > daysInMonth(y, m)) return INVALID;
+    return daysFromCivil(y, m, d);
+}
+
+qint64 TimestampParser::parseTimeFixed(const QString& text, Format format)
+{
+    int h, m, s = 0;
+    if (format == TimeHms) {
+        // h:mm:ss 或 hh:mm:ss
+        const int hourDigits = int(text.size()) - 6;
+        if (hourDigits < 1 || hourDigits > 2) return INVALID;
+        if (text[hourDigits] != QLatin1Char(':') || text[hourDigits + 3] != QLatin1Char(':')) return INVALID;
+        h = readDigits(text, 0, hourDigits);
+        m = readDigits(text, hourDigits + 1, 2);
+        s = readDigits(text, hourDigits + 4, 2);
+    } else if (format == TimeHm) {
+        // hh:mm
+        if (text.size() != 5 || text[2] != QLatin1Char(':')) return INVALID;
+        h = readDigits(text, 0, 2);
+        m = readDigits(text, 3, 2);
+    } else {
+        return INVALID;
+    }
+    if (h < 0 || h > 23 || m < 0 || m > 59 || s < 0 || s > 59) return INVALID;
+    return qint64(h) * 3600 + m * 60 + s;
+}
+
+qint64 TimestampParser::parseDateFallback(const QString& text)
+{
+    static const QStringList fmts = {"yyyy-MM-dd", "yyyy/MM/dd"};
+    for (const QString& f : fmts) {
+        QDate d = QDate::fromString(text, f);
+        if (d.isValid()) return d.toJulianDay() - kUnixEpochJulianDay;
+    }
+    return INVALID;
+}
+
+qint64 TimestampParser::parseTimeFallback(const QString& text)
+{
+    static const QStringList fmts = {"hh:mm:ss", "h:mm:ss", "hh:mm"};
+    for (const QString& f : fmts) {
+        QTime t = QTime::fromString(text, f);
+        if (t.isValid()) return t.msecsSinceStartOfDay() / 1000;
+    }
+    return INVALID;
+}
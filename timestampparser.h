@@ -0,0 +1,49 @@
+/*
+ * 文件名: timestampparser.h
+ * 文件作用: 日期/时刻文本快速解析头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 从一列的样本文本中识别一次格式 (日期 yyyy-MM-dd / yyyy/MM/dd，时刻 hh:mm:ss / h:mm:ss / hh:mm)，
+ *    之后按该固定格式逐字符解析，不再逐行尝试 QDate/QTime::fromString 的各个格式。
+ * 2. 日期解析为自 1970-01-01 起的天数，时刻解析为当天秒数，二者都是 qint64，
+ *    组合为按墙钟时间计的秒数 (天数 * 86400 + 当天秒数)，不受时区与夏令时影响。
+ * 3. 与识别格式不符的单元格再按原有的多格式方式解析，结果与逐行 fromString 一致。
+ */
+
+#ifndef TIMESTAMPPARSER_H
+#define TIMESTAMPPARSER_H
+
+#include <QString>
+#include <QStringList>
+#include <limits>
+
+class TimestampParser
+{
+public:
+    // 解析失败的返回值
+    static const qint64 INVALID = std::numeric_limits<qint64>::min();
+    static const qint64 SECONDS_PER_DAY = 86400;
+
+    enum Format {
+        UnknownFormat,
+        DateDash,       // yyyy-MM-dd
+        DateSlash,      // yyyy/MM/dd
+        TimeHms,        // hh:mm:ss 或 h:mm:ss
+        TimeHm          // hh:mm
+    };
+
+    // 按样本中能解析的个数选出日期/时刻格式，全部不能解析时返回 UnknownFormat
+    static Format detectDateFormat(const QStringList& samples);
+    static Format detectTimeFormat(const QStringList& samples);
+
+    // 按固定格式解析，format 为 UnknownFormat 或文本不符时改用多格式解析
+    static qint64 parseDate(const QString& text, Format format); // 自 1970-01-01 起的天数
+    static qint64 parseTime(const QString& text, Format format); // 当天秒数
+
+private:
+    static qint64 parseDateFixed(const QString& text, Format format);
+    static qint64 parseTimeFixed(const QString& text, Format format);
+    static qint64 parseDateFallback(const QString& text);
+    static qint64 parseTimeFallback(const QString& text);
+};
+
+#endif // TIMESTAMPPARSER_H
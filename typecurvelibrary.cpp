@@ -0,0 +1,214 @@
+/*
+ * 文件名: typecurvelibrary.cpp
+ * 文件作用: 无因次型曲线库实现
+ * 功能描述:
+ * 1. 曲线按参数位模式的哈希查找，并保存完整的键用于排除哈希碰撞 (与 Laplace 缓存一致)。
+ * 2. 插值斜率取网格值的中心差分 (端点单侧差分)，在 ln tD 上做三次 Hermite 插值。
+ * 3. 文件格式：魔数、版本、曲线条数，每条曲线为键与 (网格下标, pD) 表，使用 QDataStream 读写。
+ */
+
+#include "typecurvelibrary.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QMutexLocker>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const quint32 FILE_MAGIC = 0x54434C42; // "TCLB"
+const quint32 FILE_VERSION = 1;
+}
+
+bool TypeCurveLibrary::Key::operator==(const Key& other) const
+{
+    return modelType == other.modelType && inversion == other.inversion && order == other.order
+           && std::memcmp(shape, other.shape, sizeof(shape)) == 0;
+}
+
+quint64 TypeCurveLibrary::Key::hash() const
+{
+    quint64 h = 1469598103934665603ULL;
+    auto mix = [&h](quint64 bits) {
+        h ^= bits;
+        h *= 1099511628211ULL;
+    };
+    mix((quint64)modelType);
+    mix((quint64)inversion);
+    mix((quint64)order);
+    for (int i = 0; i < SHAPE_COUNT; ++i) {
+        quint64 bits;
+        std::memcpy(&bits, &shape[i], sizeof(bits));
+        mix(bits);
+    }
+    return h;
+}
+
+TypeCurveLibrary& TypeCurveLibrary::shared()
+{
+    static TypeCurveLibrary library;
+    return library;
+}
+
+int TypeCurveLibrary::latticeIndex(double tD)
+{
+    return (int)std::floor(std::log10(tD) * POINTS_PER_CYCLE);
+}
+
+double TypeCurveLibrary::latticeTime(int index)
+{
+    return std::pow(10.0, double(index) / POINTS_PER_CYCLE);
+}
+
+double TypeCurveLibrary::canonical(double value)
+{
+    if (value == 0.0 || !std::isfinite(value)) return value;
+    int exponent;
+    double mantissa = std::frexp(value, &exponent);
+    return std::ldexp(std::round(std::ldexp(mantissa, 40)), exponent - 40);
+}
+
+TypeCurveLibrary::Curve* TypeCurveLibrary::findCurve(const Key& key, bool create)
+{
+    quint64 h = key.hash();
+    auto it = m_curves.find(h);
+    if (it != m_curves.end()) {
+        if (it.value().key == key) return &it.value();
+        if (!create) return nullptr;
+        // 哈希碰撞：用新参数组替换旧曲线
+        m_curves.erase(it);
+        m_order.removeAll(h);
+    }
+    if (!create) return nullptr;
+
+    while (m_order.size() >= MAX_CURVES) {
+        m_curves.remove(m_order.takeFirst());
+    }
+    Curve& curve = m_curves[h];
+    curve.key = key;
+    m_order.append(h);
+    return &curve;
+}
+
+void TypeCurveLibrary::fetch(const Key& key, int first, int last, QVector<double>& values, QVector<int>& missing)
+{
+    values = QVector<double>(qMax(0, last - first + 1), 0.0);
+    missing.clear();
+    QMutexLocker locker(&m_mutex);
+    const Curve* curve = findCurve(key, false);
+    for (int k = first; k <= last; ++k) {
+        if (curve) {
+            auto it = curve->values.constFind(k);
+            if (it != curve->values.constEnd()) {
+                values[k - first] = it.value();
+                continue;
+            }
+        }
+        missing.append(k);
+    }
+}
+
+void TypeCurveLibrary::store(const Key& key, const QVector<int>& indices, const QVector<double>& values)
+{
+    int n = qMin(indices.size(), values.size());
+    if (n == 0) return;
+    QMutexLocker locker(&m_mutex);
+    Curve* curve = findCurve(key, true);
+    for (int i = 0; i < n; ++i) curve->values.insert(indices[i], values[i]);
+}
+
+QVector<double> TypeCurveLibrary::interpolate(int first, const QVector<double>& lattice, const QVector<double>& tD,
+                                              QVector<double>* logDerivative)
+{
+    int n = lattice.size();
+    QVector<double> out(tD.size(), 0.0);
+    if (logDerivative) *logDerivative = QVector<double>(tD.size(), 0.0);
+    if (n < 2) return out;
+    // 网格坐标 x = log10(tD)·POINTS_PER_CYCLE，dx/dln tD = POINTS_PER_CYCLE/ln10
+    const double dxdLnT = POINTS_PER_CYCLE / std::log(10.0);
+
+    // 网格点 k 的斜率 (每个网格步长)
+    auto slope = [&](int k) {
+        if (k == 0) return lattice[1] - lattice[0];
+        if (k == n - 1) return lattice[n - 1] - lattice[n - 2];
+        return 0.5 * (lattice[k + 1] - lattice[k - 1]);
+    };
+
+    for (int i = 0; i < tD.size(); ++i) {
+        if (!(tD[i] > 0.0)) continue;
+        double x = std::log10(tD[i]) * POINTS_PER_CYCLE - first;
+        int k = qBound(0, (int)std::floor(x), n - 2);
+        double s = qBound(0.0, x - k, 1.0);
+        double s2 = s * s, s3 = s2 * s;
+        out[i] = (2.0 * s3 - 3.0 * s2 + 1.0) * lattice[k] + (-2.0 * s3 + 3.0 * s2) * lattice[k + 1]
+                 + (s3 - 2.0 * s2 + s) * slope(k) + (s3 - s2) * slope(k + 1);
+        if (logDerivative) {
+            (*logDerivative)[i] = dxdLnT * ((6.0 * s2 - 6.0 * s) * (lattice[k] - lattice[k + 1])
+                                            + (3.0 * s2 - 4.0 * s + 1.0) * slope(k) + (3.0 * s2 - 2.0 * s) * slope(k + 1));
+        }
+    }
+    return out;
+}
+
+bool TypeCurveLibrary::save(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+
+    QMutexLocker locker(&m_mutex);
+    out << FILE_MAGIC << FILE_VERSION << (qint32)POINTS_PER_CYCLE << (qint32)m_order.size();
+    for (quint64 h : m_order) {
+        const Curve& curve = m_curves[h];
+        out << (qint32)curve.key.modelType << (qint32)curve.key.inversion << (qint32)curve.key.order;
+        for (int i = 0; i < SHAPE_COUNT; ++i) out << curve.key.shape[i];
+        out << curve.values;
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+bool TypeCurveLibrary::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0, version = 0;
+    qint32 pointsPerCycle = 0, count = 0;
+    in >> magic >> version >> pointsPerCycle >> count;
+    // 网格密度不同的库无法复用
+    if (magic != FILE_MAGIC || version != FILE_VERSION || pointsPerCycle != POINTS_PER_CYCLE || count < 0) return false;
+
+    QMutexLocker locker(&m_mutex);
+    for (int c = 0; c < count && in.status() == QDataStream::Ok; ++c) {
+        qint32 modelType, inversion, order;
+        Key key;
+        in >> modelType >> inversion >> order;
+        key.modelType = modelType;
+        key.inversion = inversion;
+        key.order = order;
+        for (int i = 0; i < SHAPE_COUNT; ++i) in >> key.shape[i];
+        QHash<int, double> values;
+        in >> values;
+        if (in.status() != QDataStream::Ok) break;
+
+        Curve* curve = findCurve(key, true);
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it) curve->values.insert(it.key(), it.value());
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+void TypeCurveLibrary::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_curves.clear();
+    m_order.clear();
+}
+
+int TypeCurveLibrary::curveCount()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_curves.size();
+}
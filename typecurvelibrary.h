@@ -0,0 +1,80 @@
+/*
+ * 文件名: typecurvelibrary.h
+ * 文件作用: 无因次型曲线库头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 按无因次参数组 (模型类型、反演方法与阶数、kf/km、LfD、rmD、reD、ω1、ω2、λ1、nf、cD、S) 保存 pD(tD)，
+ *    tD 取固定的对数网格 (每个对数周期 POINTS_PER_CYCLE 点)，网格与调用无关，同一曲线可逐次补齐。
+ * 2. 其余参数 (φ、μ、Ct、B、q、h 及 kf、L 的整体缩放) 只改变时间与压力的换算，命中后只需插值，不再反演。
+ * 3. 网格值在 ln tD 上做三次 Hermite 插值，导数 tD·dpD/dtD 取插值函数的解析导数；压敏修正不进入型曲线，由调用方在插值后施加。
+ * 4. 全进程共享一个库 (互斥保护)，可保存到文件并在下次启动时载入。
+ */
+
+#ifndef TYPECURVELIBRARY_H
+#define TYPECURVELIBRARY_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+class TypeCurveLibrary
+{
+public:
+    // 决定无因次曲线形状的参数个数 (kf/km、LfD、rmD、reD、ω1、ω2、λ1、nf、cD、S)
+    static const int SHAPE_COUNT = 10;
+    // 对数网格密度：网格点 k 对应 tD = 10^(k / POINTS_PER_CYCLE)
+    static const int POINTS_PER_CYCLE = 40;
+    // 最多保留的曲线条数，超出时按先进先出淘汰
+    static const int MAX_CURVES = 512;
+
+    struct Key {
+        int modelType = 0;
+        int inversion = 0;  // ModelSolver01_06::InversionMethod (已解析，不含 DefaultInversion)
+        int order = 0;      // Stehfest 阶数
+        double shape[SHAPE_COUNT] = {};
+
+        bool operator==(const Key& other) const;
+        quint64 hash() const;
+    };
+
+    static TypeCurveLibrary& shared();
+
+    static int latticeIndex(double tD);
+    static double latticeTime(int index);
+    // 键中的参数值截为 40 位尾数 (约 12 位有效数字)，换算得到的比值 (如 kf/km) 末位舍入不同时仍命中同一曲线
+    static double canonical(double value);
+
+    /**
+     * @brief 取出网格 [first, last] 上的已存值
+     * values 长度为 last-first+1，未存的位置为 0 并把网格下标写入 missing
+     */
+    void fetch(const Key& key, int first, int last, QVector<double>& values, QVector<int>& missing);
+    // 存入网格点的值 (indices 与 values 一一对应)
+    void store(const Key& key, const QVector<int>& indices, const QVector<double>& values);
+
+    // 网格 first.. 上的连续值 lattice 插值到 tD (tD<=0 时为 0)；
+    // logDerivative 非空时同时给出插值函数对 ln tD 的导数 (与插值值一致的解析导数)
+    static QVector<double> interpolate(int first, const QVector<double>& lattice, const QVector<double>& tD,
+                                       QVector<double>* logDerivative = nullptr);
+
+    // 二进制文件读写；载入时与现有曲线合并，格式或版本不符时返回 false
+    bool save(const QString& path);
+    bool load(const QString& path);
+
+    void clear();
+    int curveCount();
+
+private:
+    struct Curve {
+        Key key;
+        QHash<int, double> values; // 网格下标 -> pD
+    };
+    Curve* findCurve(const Key& key, bool create);
+
+    QMutex m_mutex;
+    QHash<quint64, Curve> m_curves;
+    QList<quint64> m_order; // 先进先出淘汰顺序
+};
+
+#endif // TYPECURVELIBRARY_H
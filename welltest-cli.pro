@@ -0,0 +1,28 @@
+######################################################################
+# 命令行拟合程序 (无界面)
+# 构建: qmake WellTestAll.pro && make  (或先构建 welltestcore.pro)
+# 运行: welltest-cli --spec spec.json [--data data.csv] [--output result.json] [--csv curve.csv]
+######################################################################
+QT = core concurrent
+
+TEMPLATE = app
+TARGET = welltest-cli
+CONFIG += console c++17
+CONFIG -= app_bundle
+INCLUDEPATH += .
+
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+include(welltestcore.pri)
+
+unix: LIBS += -lm
+win32: LIBS += -lm
+
+SOURCES += welltestcli.cpp
+
+QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
+
+unix:!android: target.path = /opt/WellTest/bin
+!isEmpty(target.path): INSTALLS += target
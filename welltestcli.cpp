@@ -0,0 +1,364 @@
+/*
+ * 文件名: welltestcli.cpp
+ * 文件作用: 命令行拟合程序 welltest-cli (无界面，只链接 welltestcore 静态库)
+ * 功能描述:
+ * 1. 读取观测数据文件 (逗号/分号/制表符/空格分隔的文本，# 开头为注释，非数值行跳过)，
+ *    列号由参数说明指定；没有导数列时用 DerivativeEngine 的 Bourdet 算法计算。
+ * 2. 读取 JSON 参数说明：格式与拟合分析页状态 (getJsonState) 相同，也可直接包含 observedData。
+ * 3. 按说明中的重采样、算法、权重、反演方法设置运行 FittingCore (可选多起点)，结果以 JSON 输出，
+ *    可另存观测值与模型值对照的 CSV。
+ * 4. 说明中给出 rateHistory (time、rate 数组) 时做变产量叠加拟合，模型曲线同样按叠加计算。
+ */
+
+#include "modelsolver01-06.h"
+#include "fittingcore.h"
+#include "multistartfitter.h"
+#include "derivativeengine.h"
+#include "logtimeresampler.h"
+#include "ratesuperposition.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <cmath>
+
+namespace {
+
+using ModelType = ModelSolver01_06::ModelType;
+
+// 参数说明中允许的算法名称
+bool parseAlgorithm(const QString& name, LeastSquaresOptimizer::Algorithm& algorithm)
+{
+    QString key = name.toLower();
+    if (key.isEmpty() || key == "lm") algorithm = LeastSquaresOptimizer::LevenbergMarquardt;
+    else if (key == "dogleg") algorithm = LeastSquaresOptimizer::DoglegTrustRegion;
+    else if (key == "lbfgsb") algorithm = LeastSquaresOptimizer::BoundedLBFGS;
+    else return false;
+    return true;
+}
+
+// 参数说明中允许的反演方法名称
+bool parseInversion(const QString& name, ModelSolver01_06::InversionMethod& method)
+{
+    QString key = name.toLower();
+    if (key.isEmpty() || key == "stehfest") method = ModelSolver01_06::StehfestInversion;
+    else if (key == "talbot") method = ModelSolver01_06::TalbotInversion;
+    else if (key == "dehoog") method = ModelSolver01_06::DeHoogInversion;
+    else if (key == "euler") method = ModelSolver01_06::EulerInversion;
+    else return false;
+    return true;
+}
+
+// 读取文本数据文件的指定列；返回 false 时 error 给出原因
+bool readDataFile(const QString& path, int timeCol, int pressureCol, int derivCol,
+                  QVector<double>& t, QVector<double>& p, QVector<double>& d, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = "无法打开数据文件: " + path;
+        return false;
+    }
+    static const QRegularExpression separators("[,;\\t ]+");
+    int maxCol = qMax(timeCol, qMax(pressureCol, derivCol));
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        QStringList fields = line.split(separators, Qt::SkipEmptyParts);
+        if (fields.size() <= maxCol) continue;
+
+        bool okT, okP, okD = true;
+        double tv = fields[timeCol].toDouble(&okT);
+        double pv = fields[pressureCol].toDouble(&okP);
+        double dv = derivCol >= 0 ? fields[derivCol].toDouble(&okD) : 0.0;
+        // 表头等非数值行跳过
+        if (!okT || !okP || !okD) continue;
+        t.append(tv);
+        p.append(pv);
+        if (derivCol >= 0) d.append(dv);
+    }
+    if (t.isEmpty()) {
+        error = "数据文件中没有可用的数值行: " + path;
+        return false;
+    }
+    return true;
+}
+
+// 参数说明中的参数表：兼容分析页状态的 isFit 与简写 fit；未给上下限时取 [value/100, value*100]
+QList<FitParameter> parseParameters(const QJsonArray& arr)
+{
+    QList<FitParameter> params;
+    for (const auto& v : arr) {
+        QJsonObject obj = v.toObject();
+        FitParameter p;
+        p.name = obj["name"].toString();
+        p.displayName = p.name;
+        p.value = obj["value"].toDouble();
+        p.isFit = obj.contains("isFit") ? obj["isFit"].toBool() : obj["fit"].toBool();
+        p.min = obj.contains("min") ? obj["min"].toDouble() : (p.value > 0 ? p.value * 0.01 : 0.0);
+        p.max = obj.contains("max") ? obj["max"].toDouble() : (p.value > 0 ? p.value * 100.0 : 100.0);
+        p.isVisible = true;
+        if (!p.name.isEmpty()) params.append(p);
+    }
+    return params;
+}
+
+QJsonArray toJsonArray(const QVector<double>& v)
+{
+    QJsonArray arr;
+    for (double x : v) arr.append(x);
+    return arr;
+}
+
+bool writeFile(const QString& path, const QByteArray& data, QTextStream& log)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        log << "无法写入文件: " << path << "\n";
+        return false;
+    }
+    file.write(data);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("welltest-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("试井模型命令行拟合");
+    parser.addHelpOption();
+    QCommandLineOption specOption(QStringList() << "s" << "spec", "JSON 参数说明 (模型、参数、权重、重采样等)", "file");
+    QCommandLineOption dataOption(QStringList() << "d" << "data", "观测数据文件 (省略时使用参数说明中的 observedData)", "file");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "JSON 结果输出文件 (默认输出到标准输出)", "file");
+    QCommandLineOption csvOption("csv", "观测值与模型值对照 CSV 输出文件", "file");
+    QCommandLineOption algorithmOption("algorithm", "优化算法: lm、dogleg、lbfgsb (覆盖参数说明)", "name");
+    QCommandLineOption multiStartOption("multistart", "多起点全局拟合的起点数 (覆盖参数说明)", "count");
+    QCommandLineOption inversionOption("inversion", "Laplace 反演方法: stehfest、talbot、dehoog、euler (覆盖参数说明)", "name");
+    parser.addOption(specOption);
+    parser.addOption(dataOption);
+    parser.addOption(outputOption);
+    parser.addOption(csvOption);
+    parser.addOption(algorithmOption);
+    parser.addOption(multiStartOption);
+    parser.addOption(inversionOption);
+    parser.process(app);
+
+    QTextStream log(stderr);
+    if (!parser.isSet(specOption)) {
+        log << "缺少参数说明文件 (--spec)\n";
+        return 2;
+    }
+
+    // 1. 参数说明
+    QFile specFile(parser.value(specOption));
+    if (!specFile.open(QIODevice::ReadOnly)) {
+        log << "无法打开参数说明文件: " << specFile.fileName() << "\n";
+        return 2;
+    }
+    QJsonParseError parseError;
+    QJsonObject spec = QJsonDocument::fromJson(specFile.readAll(), &parseError).object();
+    if (parseError.error != QJsonParseError::NoError) {
+        log << "参数说明解析失败: " << parseError.errorString() << "\n";
+        return 2;
+    }
+
+    int type = spec["modelType"].toInt(-1);
+    if (type < ModelSolver01_06::Model_1 || type > ModelSolver01_06::Model_6) {
+        log << "modelType 无效，应为 0-5\n";
+        return 2;
+    }
+    ModelType modelType = (ModelType)type;
+
+    QList<FitParameter> params = parseParameters(spec["parameters"].toArray());
+    bool anyFit = false;
+    for (const auto& p : params) anyFit = anyFit || p.isFit;
+    if (!anyFit) {
+        log << "参数说明中没有拟合参数 (isFit)\n";
+        return 2;
+    }
+
+    FittingCore::Options options;
+    options.jacobianRefreshInterval = 4;
+    if (spec.contains("weight")) options.weight = spec["weight"].toDouble();
+    else if (spec.contains("fitWeightVal")) options.weight = spec["fitWeightVal"].toInt() / 100.0;
+    options.maxIterations = spec["maxIterations"].toInt(options.maxIterations);
+    options.targetMse = spec["targetMse"].toDouble(options.targetMse);
+    QString algorithmName = parser.isSet(algorithmOption) ? parser.value(algorithmOption) : spec["algorithm"].toString();
+    if (!parseAlgorithm(algorithmName, options.algorithm)) {
+        log << "未知算法: " << algorithmName << "\n";
+        return 2;
+    }
+    int seedCount = parser.isSet(multiStartOption) ? parser.value(multiStartOption).toInt() : spec["multiStart"].toInt(0);
+    // 反演方法设为该模型类型的默认值，拟合与结果曲线的全部求解器实例都使用它
+    ModelSolver01_06::InversionMethod inversion;
+    QString inversionName = parser.isSet(inversionOption) ? parser.value(inversionOption) : spec["inversion"].toString();
+    if (!parseInversion(inversionName, inversion)) {
+        log << "未知反演方法: " << inversionName << "\n";
+        return 2;
+    }
+    ModelSolver01_06::setDefaultInversion(modelType, inversion);
+
+    // 2. 观测数据
+    QVector<double> t, p, d;
+    if (parser.isSet(dataOption)) {
+        QJsonObject cols = spec["columns"].toObject();
+        QString error;
+        if (!readDataFile(parser.value(dataOption), cols["time"].toInt(0), cols["pressure"].toInt(1), cols["derivative"].toInt(-1), t, p, d, error)) {
+            log << error << "\n";
+            return 3;
+        }
+    } else {
+        QJsonObject obs = spec["observedData"].toObject();
+        for (auto v : obs["time"].toArray()) t.append(v.toDouble());
+        for (auto v : obs["pressure"].toArray()) p.append(v.toDouble());
+        for (auto v : obs["derivative"].toArray()) d.append(v.toDouble());
+        if (t.isEmpty() || p.size() != t.size()) {
+            log << "没有观测数据：请用 --data 指定数据文件或在参数说明中给出 observedData\n";
+            return 3;
+        }
+    }
+    if (d.size() != t.size()) d = DerivativeEngine::bourdet(t, p, spec["lSpacing"].toDouble(0.1));
+
+    LogTimeResampler::Options resample;
+    bool refineOnFullData = false;
+    if (spec.contains("resample")) {
+        QJsonObject rs = spec["resample"].toObject();
+        resample.enabled = rs["enabled"].toBool(false);
+        resample.pointsPerCycle = rs["pointsPerCycle"].toInt(resample.pointsPerCycle);
+        resample.aggregation = LogTimeResampler::Aggregation(rs["aggregation"].toInt(LogTimeResampler::Median));
+        resample.rejectOutliers = rs["rejectOutliers"].toBool(resample.rejectOutliers);
+        resample.outlierThreshold = rs["outlierThreshold"].toDouble(resample.outlierThreshold);
+        refineOnFullData = rs["refineOnFullData"].toBool(false);
+    }
+    LogTimeResampler::Result fitData = LogTimeResampler::resample(t, p, d, resample);
+    log << "观测数据 " << t.size() << " 点，拟合使用 " << fitData.time.size() << " 点\n";
+
+    // 产量历史：各段起始时间与产量，时间与观测数据同一时钟
+    RateSuperposition::Schedule schedule;
+    if (spec.contains("rateHistory")) {
+        QJsonObject rh = spec["rateHistory"].toObject();
+        QVector<double> rt, rq;
+        for (auto v : rh["time"].toArray()) rt.append(v.toDouble());
+        for (auto v : rh["rate"].toArray()) rq.append(v.toDouble());
+        if (rt.isEmpty() || rq.size() != rt.size()) {
+            log << "rateHistory 的 time 与 rate 长度不一致或为空\n";
+            return 2;
+        }
+        schedule = RateSuperposition::fromSamples(rt, rq);
+        log << "变产量叠加: " << schedule.startTime.size() << " 段产量\n";
+    }
+
+    // 3. 拟合
+    QElapsedTimer timer;
+    timer.start();
+    FittingCore::Result result;
+    if (seedCount > 1) {
+        MultiStartFitter fitter([modelType]() { return QSharedPointer<ModelSolver01_06>::create(modelType); });
+        fitter.setObservedData(fitData.time, fitData.deltaP, fitData.derivative);
+        fitter.setRateSchedule(schedule);
+        MultiStartFitter::Options msOptions;
+        msOptions.seedCount = seedCount;
+        msOptions.keepBest = 1;
+        msOptions.fit = options;
+        QList<MultiStartFitter::Solution> solutions = fitter.run(params, msOptions);
+        if (!solutions.isEmpty()) {
+            result.params = solutions[0].params;
+            result.mse = solutions[0].mse;
+            result.iterations = solutions[0].iterations;
+        }
+    } else {
+        FittingCore core(QSharedPointer<ModelSolver01_06>::create(modelType));
+        core.setObservedData(fitData.time, fitData.deltaP, fitData.derivative);
+        core.setRateSchedule(schedule);
+        core.setStepCallback([&log](double mse, const QMap<QString, double>&) {
+            log << QString("  MSE = %1").arg(mse, 0, 'e', 4) << "\n";
+        });
+        result = core.run(params, options);
+    }
+    if (refineOnFullData && fitData.time.size() < t.size() && !result.params.isEmpty()) {
+        for (auto& fp : params) fp.value = result.params.value(fp.name, fp.value);
+        FittingCore refine(QSharedPointer<ModelSolver01_06>::create(modelType));
+        refine.setObservedData(t, p, d);
+        refine.setRateSchedule(schedule);
+        FittingCore::Options refineOptions;
+        refineOptions.weight = options.weight;
+        refineOptions.maxIterations = 5;
+        refineOptions.highPrecision = true;
+        FittingCore::Result refined = refine.run(params, refineOptions);
+        result.params = refined.params;
+        result.mse = refined.mse;
+        result.iterations += refined.iterations;
+    }
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+    if (result.params.isEmpty() || !std::isfinite(result.mse)) {
+        log << "拟合失败：误差无法计算，请检查参数范围\n";
+        return 4;
+    }
+
+    // 4. 输出：模型曲线在观测时间上以高精度计算
+    ModelSolver01_06 solver(modelType);
+    ModelSolver01_06::CalcOptions calcOptions;
+    calcOptions.highPrecision = true;
+    ModelCurveData curve;
+    if (schedule.isEmpty()) {
+        curve = solver.calculateTheoreticalCurve(result.params, t, calcOptions);
+    } else {
+        RateSuperposition superposition(schedule, t, RateSuperposition::Options());
+        curve = superposition.evaluate(solver, ModelSolver01_06::ParamSet::fromMap(result.params), calcOptions);
+    }
+    const QVector<double>& modelP = std::get<1>(curve);
+    const QVector<double>& modelD = std::get<2>(curve);
+
+    QJsonObject fitted;
+    for (auto it = result.params.begin(); it != result.params.end(); ++it) fitted[it.key()] = it.value();
+
+    QJsonObject root;
+    root["modelType"] = type;
+    root["modelName"] = ModelSolver01_06::getModelName(modelType);
+    root["algorithm"] = LeastSquaresOptimizer::algorithmName(options.algorithm);
+    root["inversion"] = ModelSolver01_06::inversionName(inversion);
+    root["multiStart"] = seedCount > 1 ? seedCount : 0;
+    root["rateSteps"] = schedule.startTime.size();
+    root["mse"] = result.mse;
+    root["iterations"] = result.iterations;
+    root["elapsed_ms"] = elapsedMs;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["parameters"] = fitted;
+    QJsonObject curveObj;
+    curveObj["time"] = toJsonArray(std::get<0>(curve));
+    curveObj["pressure"] = toJsonArray(modelP);
+    curveObj["derivative"] = toJsonArray(modelD);
+    root["curve"] = curveObj;
+
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        if (!writeFile(parser.value(outputOption), json, log)) return 5;
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    if (parser.isSet(csvOption)) {
+        QByteArray csv = "time,observed_pressure,observed_derivative,model_pressure,model_derivative\n";
+        for (int i = 0; i < t.size(); ++i) {
+            csv += QString("%1,%2,%3,%4,%5\n")
+                       .arg(t[i], 0, 'g', 10).arg(p[i], 0, 'g', 10).arg(d.value(i), 0, 'g', 10)
+                       .arg(modelP.value(i), 0, 'g', 10).arg(modelD.value(i), 0, 'g', 10).toUtf8();
+        }
+        if (!writeFile(parser.value(csvOption), csv, log)) return 5;
+    }
+
+    log << QString("完成: MSE = %1, 迭代 %2 次, %3 ms").arg(result.mse, 0, 'e', 4).arg(result.iterations).arg(elapsedMs, 0, 'f', 1) << "\n";
+    return 0;
+}
@@ -0,0 +1,19 @@
+######################################################################
+# 链接 welltestcore 静态库 (在使用方的 .pro 中 include 本文件)
+# 静态库与使用方在同一构建目录下生成，先构建 welltestcore.pro
+######################################################################
+QT *= core concurrent
+INCLUDEPATH += $$PWD
+INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
+unix: INCLUDEPATH += /usr/include/eigen3
+
+# 与 welltestcore.pro 保持一致，使 WT_PROFILE_* 宏在使用方与静态库中含义相同
+CONFIG(profiling): DEFINES *= WELLTEST_PROFILING
+
+win32:CONFIG(release, debug|release): WELLTESTCORE_DIR = $$OUT_PWD/release
+else:win32:CONFIG(debug, debug|release): WELLTESTCORE_DIR = $$OUT_PWD/debug
+else: WELLTESTCORE_DIR = $$OUT_PWD
+
+LIBS += -L$$WELLTESTCORE_DIR -lwelltestcore
+win32-g++|!win32: PRE_TARGETDEPS += $$WELLTESTCORE_DIR/libwelltestcore.a
+else: PRE_TARGETDEPS += $$WELLTESTCORE_DIR/welltestcore.lib
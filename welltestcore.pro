@@ -0,0 +1,89 @@
+######################################################################
+# 试井计算核心静态库 (无界面，只依赖 QtCore / QtConcurrent)
+# 包含模型求解器、导数计算、数据重采样、拟合与优化算法，
+# 由 WellTest (界面)、welltest-cli (命令行)、solverbenchmark (基准) 共同链接
+######################################################################
+QT = core concurrent
+
+TEMPLATE = lib
+TARGET = welltestcore
+CONFIG += staticlib c++17
+INCLUDEPATH += .
+
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+# 热路径计时与计数 (HotPathProfiler)，默认不编入；需要时以 qmake CONFIG+=profiling 构建，
+# 否则 WT_PROFILE_* 宏展开为空，发布版界面、命令行与计算节点的热路径不含计数代码
+CONFIG(profiling): DEFINES += WELLTEST_PROFILING
+
+HEADERS += adaptivequadrature.h \
+           adaptivetimegrid.h \
+           besselkernel.h \
+           columnexpression.h \
+           csvexporter.h \
+           curvedatafile.h \
+           datachangetracker.h \
+           derivativeengine.h \
+           derivativeseries.h \
+           dualnumber.h \
+           fitperformancelog.h \
+           fittingcore.h \
+           fitwindows.h \
+           gaugeseries.h \
+           hotpathprofiler.h \
+           jointfitter.h \
+           leastsquaresoptimizer.h \
+           logtimeresampler.h \
+           minmaxpyramid.h \
+           modelscreener.h \
+           modelsolver01-06.h \
+           multistartfitter.h \
+           parameteruncertainty.h \
+           ratedeconvolution.h \
+           ratesuperposition.h \
+           sensitivitysweep.h \
+           seriesdata.h \
+           signalfilter.h \
+           solverjob.h \
+           surrogateoptimizer.h \
+           timestampparser.h \
+           typecurvelibrary.h
+
+SOURCES += adaptivetimegrid.cpp \
+           besselkernel.cpp \
+           columnexpression.cpp \
+           csvexporter.cpp \
+           curvedatafile.cpp \
+           datachangetracker.cpp \
+           derivativeengine.cpp \
+           derivativeseries.cpp \
+           fitperformancelog.cpp \
+           fittingcore.cpp \
+           fitwindows.cpp \
+           gaugeseries.cpp \
+           hotpathprofiler.cpp \
+           jointfitter.cpp \
+           leastsquaresoptimizer.cpp \
+           logtimeresampler.cpp \
+           minmaxpyramid.cpp \
+           modelscreener.cpp \
+           modelsolver01-06.cpp \
+           multistartfitter.cpp \
+           parameteruncertainty.cpp \
+           ratedeconvolution.cpp \
+           ratesuperposition.cpp \
+           sensitivitysweep.cpp \
+           seriesdata.cpp \
+           signalfilter.cpp \
+           solverjob.cpp \
+           surrogateoptimizer.cpp \
+           timestampparser.cpp \
+           typecurvelibrary.cpp
+
+INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
+INCLUDEPATH += D:/08YYYXXX/boost_1_89_0
+unix: INCLUDEPATH += /usr/include/eigen3
+
+QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
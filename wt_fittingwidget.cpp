@@ -3,8 +3,24 @@
  * 文件作用: 试井拟合分析主界面类的实现文件
  * 功能描述:
  * 1. 初始化界面，集成 ChartWidget 作为绘图容器。
- * 2. 实现了多线程 Levenberg-Marquardt 拟合算法。
+ * 2. 在后台线程中调用 FittingCore 执行 Levenberg-Marquardt 拟合，并刷新迭代曲线。
  * 3. 包含了右侧坐标系动态加载和 35% 比例初始化逻辑。
+ * 4. 拟合迭代使用对数时间重采样后的观测数据 (LogTimeResampler)，可选最后在全部数据上高精度精修。
+ * 5. 可选多起点全局拟合 (MultiStartFitter)，结束后列出去重后的若干组解供选择；
+ *    或代理模型全局搜索 (SurrogateOptimizer)，适合单次求解较慢的模型。
+ * 6. 模型自动筛选 (ModelScreener)：6 种模型并行拟合，按 AIC/BIC 排序，可一键切换到所选模型。
+ * 7. 交互式参数调节：滑块绑定所选参数行，拖动或编辑数值时在单线程预览池中异步计算，
+ *    先以 4 阶 Stehfest 在稀疏时间点上粗算，再经型曲线库精算；新请求取消并丢弃旧请求的结果。
+ * 8. 尚无观测数据时理论曲线在自适应时间网格上计算 (AdaptiveTimeGrid)，只在曲线有结构处加密。
+ * 9. 观测数据以 SeriesData 保存，与拟合器共享同一份数组；绘图容器经 SharedGraphData 共用，迭代刷新不再逐点复制。
+ * 10. 拟合迭代的显示按帧率合并 (最高 30 帧/秒，不超过屏幕刷新率)，只显示最新状态；迭代曲线沿用残差求值结果。
+ * 11. 拟合曲线 CSV 导出经 CsvExportDialog 在后台写入，界面线程只取出曲线数据。
+ * 12. 分析报告由 FittingReport 生成：界面线程离屏绘制 2 倍像素的曲线图，编码与写文件在后台进行。
+ * 13. 从项目表格加载且自动计算导数的观测数据由 DerivativeSeries 生成并保留，表格修改合并通知后在后台更新。
+ * 14. 拟合与滚动拟合以上一次的续算状态 (FittingCore::WarmStart) 开始，结束后保存新的状态；页面状态中以 warmStart 保存。
+ * 15. 拟合窗口：ChartWidget 框选横轴范围加入带权重的时间窗口，框选矩形屏蔽或恢复其中的数据点；
+ *     窗口画在网格层 (曲线之下)，屏蔽点以灰色叉号标出；窗口规则交给各拟合器，观测数据不复制。
+ * 16. 性能统计面板为非模态窗口，拟合进行中也可打开查看。
  */
 
 #include "wt_fittingwidget.h"
@@ -12,13 +28,16 @@
 #include "modelparameter.h"
 #include "modelselect.h"
 #include "fittingdatadialog.h"
-#include "pressurederivativecalculator.h"
-#include "pressurederivativecalculator1.h"
+#include "sharedgraphdata.h"
+#include "csvexportdialog.h"
+#include "gaugestreamdialog.h"
+#include "profilerpanel.h"
 
 #include <QtConcurrent>
 #include <QMessageBox>
 #include <QDebug>
 #include <cmath>
+#include <limits>
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
@@ -29,11 +48,78 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QTableWidget>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QDateTime>
-#include <QBuffer>
-#include <Eigen/Dense>
+#include <QElapsedTimer>
+#include <QSignalBlocker>
+#include <QInputDialog>
+#include <QMenu>
+#include <QMutexLocker>
+#include <QScreen>
+#include <QThread>
+
+namespace {
+// 参数滑块的刻度数
+const int PARAM_SLIDER_STEPS = 1000;
+// 交互刷新时限：上一次精算超过该耗时时先显示粗算曲线
+const qint64 PREVIEW_BUDGET_MS = 50;
+// 粗算曲线每个对数周期的时间点数
+const int COARSE_POINTS_PER_CYCLE = 5;
+// 无观测数据时理论曲线的时间范围
+const double DEFAULT_CURVE_T_MIN = 1e-4;
+const double DEFAULT_CURVE_T_MAX = 1e4;
+// 拟合迭代显示的目标帧率 (不超过屏幕刷新率)
+const double ITERATION_FRAME_RATE = 30.0;
+// 图表标题
+const char* const PLOT_TITLE = "试井解释拟合 (Well Test Fitting)";
+// 滚动拟合的迭代次数上限 (以上一次结果为初值，通常几步即收敛)
+const int ROLLING_FIT_MAX_ITERATIONS = 15;
+
+QVector<double> coarsePreviewTime(const QVector<double>& t)
+{
+    if (t.isEmpty()) {
+        int count = (int)std::lround(std::log10(DEFAULT_CURVE_T_MAX / DEFAULT_CURVE_T_MIN) * COARSE_POINTS_PER_CYCLE) + 1;
+        return ModelSolver01_06::generateLogTimeSteps(count, std::log10(DEFAULT_CURVE_T_MIN), std::log10(DEFAULT_CURVE_T_MAX));
+    }
+    double lo = HUGE_VAL, hi = 0.0;
+    for (double v : t) {
+        if (v <= 0) continue;
+        lo = qMin(lo, v);
+        hi = qMax(hi, v);
+    }
+    if (!(hi > lo)) return t;
+    int count = qMax(2, (int)std::ceil(std::log10(hi / lo) * COARSE_POINTS_PER_CYCLE) + 1);
+    return ModelSolver01_06::generateLogTimeSteps(count, std::log10(lo), std::log10(hi));
+}
+
+// 精算曲线：有观测数据时取数据的时间点并经型曲线库插值，否则在默认时间范围内自适应选点
+ModelCurveData refinedModelCurve(ModelManager* manager, ModelManager::ModelType type, const QMap<QString, double>& params,
+                                 const QVector<double>& t, SolverControl* control)
+{
+    if (t.isEmpty()) return manager->calculateAdaptiveCurve(type, params, DEFAULT_CURVE_T_MIN, DEFAULT_CURVE_T_MAX, control);
+    return manager->calculatePreviewCurve(type, params, t, control);
+}
+
+// 观测数据的单元格数值：空单元格与无法解析的文字为 NaN (不参与)
+double observedValue(MeasurementTableModel* model, int row, int column)
+{
+    bool ok = false;
+    double v = model->value(row, column, &ok);
+    return ok ? v : std::numeric_limits<double>::quiet_NaN();
+}
+
+QVector<double> observedColumn(MeasurementTableModel* model, int column)
+{
+    QVector<double> values(model->rowCount());
+    for (int r = 0; r < values.size(); ++r) values[r] = observedValue(model, r, column);
+    return values;
+}
+}
 
 FittingWidget::FittingWidget(QWidget *parent) :
     QWidget(parent),
@@ -44,7 +130,10 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_plot(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
-    m_isFitting(false)
+    m_refineOnFullData(false),
+    m_isFitting(false),
+    m_previewGeneration(0),
+    m_lastRefineMs(-1)
 {
     ui->setupUi(this);
 
@@ -54,10 +143,11 @@ FittingWidget::FittingWidget(QWidget *parent) :
 
     // 获取底层绘图指针
     m_plot = m_chartWidget->getPlot();
-    m_chartWidget->setTitle("试井解释拟合 (Well Test Fitting)");
+    m_chartWidget->setTitle(PLOT_TITLE);
 
     // 连接导出数据信号
     connect(m_chartWidget, &ChartWidget::exportDataTriggered, this, &FittingWidget::onExportCurveData);
+    connect(m_chartWidget, &ChartWidget::regionSelected, this, &FittingWidget::onRegionSelected);
 
     // [修改] 设置 Splitter 初始比例 (左 35% : 右 65%)
     // 假设初始总宽1000，按350:650分配
@@ -74,20 +164,41 @@ FittingWidget::FittingWidget(QWidget *parent) :
     qRegisterMetaType<QMap<QString,double>>("QMap<QString,double>");
     qRegisterMetaType<ModelManager::ModelType>("ModelManager::ModelType");
     qRegisterMetaType<QVector<double>>("QVector<double>");
+    qRegisterMetaType<SeriesData>("SeriesData");
 
-    connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
+    // 迭代显示按屏幕刷新率合并：拟合线程只更新最新状态，界面线程按帧间隔取出
+    m_iterationTimer = new QTimer(this);
+    m_iterationTimer->setSingleShot(true);
+    connect(m_iterationTimer, &QTimer::timeout, this, [this]() { flushIterationUpdate(); });
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_liveWatcher, &QFutureWatcher<DerivativeSeries>::finished, this, &FittingWidget::onLiveUpdateFinished);
 
     connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::onSliderWeightChanged);
+    connect(ui->checkMultiStart, &QCheckBox::toggled, ui->spinSeedCount, &QSpinBox::setEnabled);
+    connect(ui->checkSurrogate, &QCheckBox::toggled, ui->spinEvalCount, &QSpinBox::setEnabled);
+    // 两种全局方法互斥
+    connect(ui->checkMultiStart, &QCheckBox::toggled, this, [this](bool on) { if(on) ui->checkSurrogate->setChecked(false); });
+    connect(ui->checkSurrogate, &QCheckBox::toggled, this, [this](bool on) { if(on) ui->checkMultiStart->setChecked(false); });
 
     ui->sliderWeight->setRange(0, 100);
     ui->sliderWeight->setValue(50);
     onSliderWeightChanged(50);
+
+    // 交互式参数调节：选中参数行后滑块绑定该参数，数值改动即在后台刷新曲线
+    m_previewPool.setMaxThreadCount(1);
+    ui->sliderParam->setRange(0, PARAM_SLIDER_STEPS);
+    connect(ui->sliderParam, &QSlider::valueChanged, this, &FittingWidget::onParamSliderChanged);
+    connect(ui->tableParams, &QTableWidget::cellChanged, this, &FittingWidget::onParamCellChanged);
+    connect(ui->tableParams, &QTableWidget::currentCellChanged, this, &FittingWidget::onParamRowSelected);
 }
 
 FittingWidget::~FittingWidget()
 {
+    // 预览任务结果要回到本对象，析构前等其结束 (已取消的任务很快返回)
+    cancelPreview();
+    m_previewPool.waitForDone();
+    stopGaugeStream();
     delete ui;
 }
 
@@ -98,7 +209,7 @@ void FittingWidget::setModelManager(ModelManager *m)
     initializeDefaultModel();
 }
 
-void FittingWidget::setProjectDataModel(QStandardItemModel *model)
+void FittingWidget::setProjectDataModel(MeasurementTableModel* model)
 {
     m_projectModel = model;
 }
@@ -167,6 +278,12 @@ void FittingWidget::setupPlot() {
     m_plot->addGraph(); m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
     m_plot->graph(3)->setName("理论导数");
 
+    // 屏蔽点标记 (压差与导数点上各画一个叉号)
+    m_maskGraph = m_plot->addGraph();
+    m_maskGraph->setPen(Qt::NoPen);
+    m_maskGraph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCross, QColor(128, 128, 128), 9));
+    m_maskGraph->setName("屏蔽点");
+
     m_plot->legend->setVisible(true);
     m_plot->legend->setFont(QFont("Microsoft YaHei", 9));
     m_plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
@@ -177,36 +294,59 @@ void FittingWidget::on_btnLoadData_clicked() {
     if (dlg.exec() != QDialog::Accepted) return;
 
     FittingDataSettings settings = dlg.getSettings();
-    QStandardItemModel* sourceModel = dlg.getPreviewModel();
+    MeasurementTableModel* sourceModel = dlg.getPreviewModel();
 
     if (!sourceModel || sourceModel->rowCount() == 0) {
         QMessageBox::warning(this, "警告", "所选数据源为空，无法加载！");
         return;
     }
 
-    QVector<double> rawTime, rawPressureData, finalDeriv;
-    int skip = settings.skipRows;
-    int rows = sourceModel->rowCount();
+    QVector<double> rawTime, finalDeltaP, finalDeriv;
+    DerivativeSeries series;
 
-    for (int i = skip; i < rows; ++i) {
-        QStandardItem* itemT = sourceModel->item(i, settings.timeColIndex);
-        QStandardItem* itemP = sourceModel->item(i, settings.pressureColIndex);
+    if (settings.derivColIndex == -1) {
+        // 自动计算导数：与绘图页面共用 DerivativeSeries (Bourdet, L=0.15)，序列保留下来供表格修改后就地更新
+        DerivativeSeries::Settings seriesSettings;
+        seriesSettings.timeColumn = settings.timeColIndex;
+        seriesSettings.pressureColumn = settings.pressureColIndex;
+        seriesSettings.firstRow = settings.skipRows;
+        seriesSettings.drawdown = (settings.testType == Test_Drawdown);
+        seriesSettings.initialPressure = settings.initialPressure;
+        seriesSettings.lSpacing = 0.15;
+        series = DerivativeSeries(seriesSettings);
+        series.rebuild(observedColumn(sourceModel, settings.timeColIndex),
+                       observedColumn(sourceModel, settings.pressureColIndex));
+        rawTime = series.time();
+        finalDeltaP = series.deltaP();
+        finalDeriv = series.derivative();
+    } else {
+        QVector<double> rawPressureData;
+        int skip = settings.skipRows;
+        int rows = sourceModel->rowCount();
 
-        if (itemT && itemP) {
+        // 数值直接从列缓冲区读取，不再逐格做字符串转换
+        for (int i = skip; i < rows; ++i) {
             bool okT, okP;
-            double t = itemT->text().toDouble(&okT);
-            double p = itemP->text().toDouble(&okP);
+            double t = sourceModel->value(i, settings.timeColIndex, &okT);
+            double p = sourceModel->value(i, settings.pressureColIndex, &okP);
 
             if (okT && okP && t > 0) {
                 rawTime.append(t);
                 rawPressureData.append(p);
-                if (settings.derivColIndex >= 0) {
-                    QStandardItem* itemD = sourceModel->item(i, settings.derivColIndex);
-                    if (itemD) finalDeriv.append(itemD->text().toDouble());
-                    else finalDeriv.append(0.0);
-                }
+                finalDeriv.append(sourceModel->value(i, settings.derivColIndex));
             }
         }
+
+        double p_shutin = rawPressureData.value(0);
+        for (double p : rawPressureData) {
+            double deltaP = 0.0;
+            if (settings.testType == Test_Drawdown) {
+                deltaP = std::abs(settings.initialPressure - p);
+            } else {
+                deltaP = std::abs(p - p_shutin);
+            }
+            finalDeltaP.append(deltaP);
+        }
     }
 
     if (rawTime.isEmpty()) {
@@ -214,54 +354,75 @@ void FittingWidget::on_btnLoadData_clicked() {
         return;
     }
 
-    QVector<double> finalDeltaP;
-    double p_shutin = rawPressureData.first();
+    if (finalDeriv.size() != rawTime.size()) {
+        finalDeriv.resize(rawTime.size());
+    }
+    finalDeriv = SignalFilter::apply(settings.smoothing, rawTime, finalDeriv);
 
-    for (double p : rawPressureData) {
-        double deltaP = 0.0;
-        if (settings.testType == Test_Drawdown) {
-            deltaP = std::abs(settings.initialPressure - p);
-        } else {
-            deltaP = std::abs(p - p_shutin);
-        }
-        finalDeltaP.append(deltaP);
+    m_resampleOptions = settings.resample;
+    m_refineOnFullData = settings.refineOnFullData;
+    stopGaugeStream();
+    setObservedData(rawTime, finalDeltaP, finalDeriv);
+
+    // 来自项目表格时观测数据跟随表格修改 (导数列由用户指定时不跟随)
+    if (series.isBuilt() && sourceModel == m_projectModel) {
+        m_liveWatcher.waitForFinished();
+        m_liveSeries = series;
+        m_liveSmoothing = settings.smoothing;
+        m_livePending = DataChangeSet();
+        m_liveShowPending = false;
+        m_liveLinked = true;
     }
 
-    if (settings.derivColIndex == -1) {
-        finalDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(rawTime, finalDeltaP, 0.15);
-        if (settings.enableSmoothing) {
-            finalDeriv = PressureDerivativeCalculator1::smoothData(finalDeriv, settings.smoothingSpan);
-        }
-    } else {
-        if (settings.enableSmoothing) {
-            finalDeriv = PressureDerivativeCalculator1::smoothData(finalDeriv, settings.smoothingSpan);
-        }
-        if (finalDeriv.size() != rawTime.size()) {
-            finalDeriv.resize(rawTime.size());
-        }
+    QString msg = "观测数据已成功加载。";
+    if (m_resampleOptions.enabled) {
+        msg += QString("\n拟合使用重采样数据：%1 点 (原始 %2 点)。").arg(m_fitData.size()).arg(m_observed.size());
     }
+    QMessageBox::information(this, "成功", msg);
+}
 
-    setObservedData(rawTime, finalDeltaP, finalDeriv);
-    QMessageBox::information(this, "成功", "观测数据已成功加载。");
+void FittingWidget::setResampleOptions(const LogTimeResampler::Options& options, bool refineOnFullData)
+{
+    m_resampleOptions = options;
+    m_refineOnFullData = refineOnFullData;
+    updateFitData();
 }
 
-void FittingWidget::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& d) {
-    m_obsTime = t;
-    m_obsDeltaP = deltaP;
-    m_obsDerivative = d;
-
-    QVector<double> vt, vp, vd;
-    for(int i=0; i<t.size(); ++i) {
-        if(t[i]>1e-8 && deltaP[i]>1e-8) {
-            vt << t[i];
-            vp << deltaP[i];
-            if(i < d.size() && d[i] > 1e-8) vd << d[i];
-            else vd << 1e-10;
+void FittingWidget::updateFitData()
+{
+    if (!m_resampleOptions.enabled) {
+        m_fitData = m_observed;
+        return;
+    }
+    // 屏蔽点不参与重采样分箱；未重采样时由拟合器按窗口规则跳过，不复制数据
+    SeriesData source = m_observed;
+    if (!m_fitWindows.maskedTimes().isEmpty()) {
+        QVector<double> t, p, d;
+        for (int i = 0; i < m_observed.size(); ++i) {
+            if (m_fitWindows.isMasked(m_observed.time()[i])) continue;
+            t.append(m_observed.time()[i]);
+            p.append(m_observed.pressure()[i]);
+            d.append(i < m_observed.derivative().size() ? m_observed.derivative()[i] : 0.0);
         }
+        source = SeriesData(t, p, d);
     }
+    LogTimeResampler::Result r = LogTimeResampler::resample(source.time(), source.pressure(), source.derivative(), m_resampleOptions);
+    m_fitData = SeriesData(r.time, r.deltaP, r.derivative);
+}
 
-    m_plot->graph(0)->setData(vt, vp);
-    m_plot->graph(1)->setData(vt, vd);
+void FittingWidget::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& d) {
+    // 先恢复暂存的模型和参数，新的观测数据再覆盖其中保存的观测数据
+    applyPendingState();
+    m_liveLinked = false;
+    m_gaugeLinked = false;
+
+    m_observed = SeriesData(t, deltaP, d);
+    updateFitData();
+
+    SeriesData shown = m_observed.logPlottable();
+    SharedGraphData::assign(m_plot->graph(0), shown.time(), shown.pressure());
+    SharedGraphData::assign(m_plot->graph(1), shown.time(), shown.derivative());
+    updateFitWindowDisplay();
 
     m_plot->rescaleAxes();
     if(m_plot->xAxis->range().lower <= 0) m_plot->xAxis->setRangeLower(1e-3);
@@ -269,6 +430,321 @@ void FittingWidget::setObservedData(const QVector<double>& t, const QVector<doub
     m_plot->replot();
 }
 
+void FittingWidget::applyDataChanges(const DataChangeSet& changes)
+{
+    if (!m_liveLinked) return;
+    const DerivativeSeries::Settings& s = m_liveSeries.settings();
+    // 列号已移动或换了表格：不再跟随
+    if (!changes.keepsColumn(s.timeColumn) || !changes.keepsColumn(s.pressureColumn)) {
+        m_liveLinked = false;
+        m_livePending = DataChangeSet();
+        return;
+    }
+    if (!changes.touches(s.timeColumn) && !changes.touches(s.pressureColumn)) return;
+
+    m_livePending.merge(changes);
+    if (!m_isFitting && !m_liveWatcher.isRunning()) flushLiveUpdate();
+}
+
+void FittingWidget::startLiveUpdate(const DataChangeSet& changes)
+{
+    if (!m_projectModel) return;
+    const DerivativeSeries::Settings& s = m_liveSeries.settings();
+
+    // 时间列未改变时只读取被修改的压力单元格
+    QVector<QPair<int, double>> cells;
+    bool incremental = false;
+    if (!changes.touches(s.timeColumn)) {
+        for (const QPair<int, int>& range : changes.rowRanges) {
+            for (int r = range.first; r <= qMin(range.second, m_projectModel->rowCount() - 1); ++r) {
+                cells.append(qMakePair(r, observedValue(m_projectModel, r, s.pressureColumn)));
+            }
+        }
+        incremental = m_liveSeries.canUpdatePressure(cells);
+    }
+    QVector<double> t, p;
+    if (!incremental) {
+        cells.clear();
+        t = observedColumn(m_projectModel, s.timeColumn);
+        p = observedColumn(m_projectModel, s.pressureColumn);
+    }
+
+    m_liveWatcher.setFuture(QtConcurrent::run([series = m_liveSeries, cells, t, p, incremental]() mutable {
+        if (incremental) series.updatePressure(cells);
+        else series.rebuild(t, p);
+        return series;
+    }));
+}
+
+void FittingWidget::onLiveUpdateFinished()
+{
+    if (!m_liveLinked || m_liveWatcher.future().resultCount() == 0) return;
+    m_liveSeries = m_liveWatcher.result();
+    m_liveShowPending = true;
+    // 拟合进行中不替换观测数据，拟合结束后再显示
+    if (!m_isFitting) flushLiveUpdate();
+}
+
+void FittingWidget::flushLiveUpdate()
+{
+    if (!m_liveLinked) return;
+    if (m_liveShowPending) {
+        m_liveShowPending = false;
+        const QVector<double> deriv = SignalFilter::apply(m_liveSmoothing, m_liveSeries.time(), m_liveSeries.derivative());
+        setObservedData(m_liveSeries.time(), m_liveSeries.deltaP(), deriv);
+        m_liveLinked = true; // setObservedData 解除了跟随，此处恢复
+    }
+    if (!m_livePending.isEmpty() && !m_liveWatcher.isRunning()) {
+        const DataChangeSet changes = m_livePending;
+        m_livePending = DataChangeSet();
+        startLiveUpdate(changes);
+    }
+}
+
+void FittingWidget::on_btnFitWindows_clicked()
+{
+    if (m_isFitting) return;
+    QMenu menu(this);
+    QAction* actWindow = menu.addAction("框选时间窗口...");
+    QAction* actMask = menu.addAction("框选屏蔽数据点");
+    QAction* actUnmask = menu.addAction("框选恢复数据点");
+    menu.addSeparator();
+    QAction* actOnly = menu.addAction("只拟合窗口内的数据");
+    actOnly->setCheckable(true);
+    actOnly->setChecked(m_fitWindows.outsideWeight() == 0.0);
+    actOnly->setEnabled(!m_fitWindows.windows().isEmpty() || actOnly->isChecked());
+    QAction* actClear = menu.addAction("清除窗口与屏蔽点");
+    actClear->setEnabled(!m_fitWindows.isEmpty());
+
+    QAction* chosen = menu.exec(ui->btnFitWindows->mapToGlobal(QPoint(0, ui->btnFitWindows->height())));
+    if (!chosen) return;
+    if (chosen == actOnly) {
+        m_fitWindows.setOutsideWeight(actOnly->isChecked() ? 0.0 : 1.0);
+        fitWindowsChanged();
+    } else if (chosen == actClear) {
+        m_fitWindows.clear();
+        fitWindowsChanged();
+    } else {
+        m_regionPurpose = chosen == actWindow ? RegionWindow : (chosen == actMask ? RegionMask : RegionUnmask);
+        // 时间窗口只取横轴范围
+        m_chartWidget->beginRegionSelection(m_regionPurpose == RegionWindow);
+    }
+}
+
+void FittingWidget::onRegionSelected(double xLower, double xUpper, double yLower, double yUpper)
+{
+    const RegionPurpose purpose = m_regionPurpose;
+    m_regionPurpose = RegionNone;
+    if (purpose == RegionNone || m_isFitting || !(xUpper > xLower)) return;
+
+    if (purpose == RegionWindow) {
+        bool ok = false;
+        double weight = QInputDialog::getDouble(this, "拟合窗口",
+                                                QString("时间 %1 ~ %2 h 内的残差权重 (0 为不参与拟合):").arg(xLower, 0, 'g', 4).arg(xUpper, 0, 'g', 4),
+                                                1.0, 0.0, 100.0, 2, &ok);
+        if (!ok) return;
+        m_fitWindows.addWindow(xLower, xUpper, weight);
+    } else {
+        // 压差或导数点落在框内的时间
+        QVector<double> times;
+        const QVector<double>& t = m_observed.time();
+        const QVector<double>& p = m_observed.pressure();
+        const QVector<double>& d = m_observed.derivative();
+        for (int i = 0; i < t.size(); ++i) {
+            if (t[i] < xLower || t[i] > xUpper) continue;
+            bool inP = i < p.size() && p[i] >= yLower && p[i] <= yUpper;
+            bool inD = i < d.size() && d[i] >= yLower && d[i] <= yUpper;
+            if (inP || inD) times.append(t[i]);
+        }
+        if (times.isEmpty()) return;
+        m_fitWindows.setMasked(times, purpose == RegionMask);
+    }
+    fitWindowsChanged();
+}
+
+void FittingWidget::fitWindowsChanged()
+{
+    if (m_resampleOptions.enabled) updateFitData();
+    updateFitWindowDisplay();
+    m_plot->replot();
+}
+
+void FittingWidget::updateFitWindowDisplay()
+{
+    for (QCPItemRect* item : m_windowItems) m_plot->removeItem(item);
+    m_windowItems.clear();
+    for (const FitWindows::Window& w : m_fitWindows.windows()) {
+        QCPItemRect* rect = new QCPItemRect(m_plot);
+        rect->setLayer("grid");
+        rect->setSelectable(false);
+        rect->topLeft->setTypeY(QCPItemPosition::ptAxisRectRatio);
+        rect->bottomRight->setTypeY(QCPItemPosition::ptAxisRectRatio);
+        rect->topLeft->setCoords(w.start, 0.0);
+        rect->bottomRight->setCoords(w.end, 1.0);
+        // 权重为 0 的窗口灰色，其余绿色，权重越大颜色越深
+        int alpha = w.weight > 0 ? qBound(20, int(30 * w.weight), 90) : 60;
+        rect->setPen(Qt::NoPen);
+        rect->setBrush(w.weight > 0 ? QColor(40, 167, 69, alpha) : QColor(128, 128, 128, alpha));
+        m_windowItems.append(rect);
+    }
+
+    QVector<double> keys, values;
+    const QVector<double>& t = m_observed.time();
+    const QVector<double>& p = m_observed.pressure();
+    const QVector<double>& d = m_observed.derivative();
+    for (int i = 0; i < t.size() && !m_fitWindows.maskedTimes().isEmpty(); ++i) {
+        if (!m_fitWindows.isMasked(t[i])) continue;
+        if (i < p.size() && p[i] > 0) { keys.append(t[i]); values.append(p[i]); }
+        if (i < d.size() && d[i] > 0) { keys.append(t[i]); values.append(d[i]); }
+    }
+    m_maskGraph->setData(keys, values);
+    if (keys.isEmpty()) m_maskGraph->removeFromLegend();
+    else m_maskGraph->addToLegend();
+}
+
+void FittingWidget::on_btnProfiler_clicked()
+{
+    if (!m_profilerPanel) m_profilerPanel = new ProfilerPanel(this);
+    m_profilerPanel->show();
+    m_profilerPanel->raise();
+    m_profilerPanel->activateWindow();
+}
+
+void FittingWidget::on_btnLiveGauge_clicked()
+{
+    if (m_gaugeThread) {
+        if (QMessageBox::question(this, "实时数据", "停止接收实时数据？\n已接收的数据保留为观测数据。") == QMessageBox::Yes) {
+            stopGaugeStream();
+        }
+        return;
+    }
+
+    GaugeStreamDialog dlg(m_gaugeSettings, m_gaugeFitEvery, this);
+    if (dlg.exec() != QDialog::Accepted) return;
+    m_gaugeSettings = dlg.settings();
+    m_gaugeFitEvery = dlg.fitEvery();
+    startGaugeStream();
+}
+
+void FittingWidget::startGaugeStream()
+{
+    stopGaugeStream();
+
+    GaugeStreamReader* reader = new GaugeStreamReader(m_gaugeSettings);
+    m_gaugeThread = new QThread(this);
+    reader->moveToThread(m_gaugeThread);
+    connect(m_gaugeThread, &QThread::started, reader, &GaugeStreamReader::start);
+    connect(m_gaugeThread, &QThread::finished, reader, &QObject::deleteLater);
+    connect(reader, &GaugeStreamReader::snapshotReady, this, &FittingWidget::onGaugeSnapshot);
+    connect(reader, &GaugeStreamReader::statusChanged, this, [this](const QString& message) {
+        m_chartWidget->setTitle(QString(PLOT_TITLE) + " - " + message);
+    });
+
+    m_gaugeLinked = true;
+    m_gaugeShowPending = false;
+    m_gaugePending = SeriesData();
+    m_gaugePoints = 0;
+    m_gaugeFitPoints = 0;
+    ui->btnLiveGauge->setText("停止实时数据");
+    m_gaugeThread->start();
+}
+
+void FittingWidget::stopGaugeStream()
+{
+    if (!m_gaugeThread) return;
+    // 读取对象在线程结束时删除，其后不会再有快照到达；已排队的快照因 m_gaugeLinked 为假被忽略
+    m_gaugeThread->quit();
+    m_gaugeThread->wait();
+    delete m_gaugeThread;
+    m_gaugeThread = nullptr;
+    m_gaugeLinked = false;
+    m_gaugeShowPending = false;
+    m_gaugePending = SeriesData();
+    m_chartWidget->setTitle(PLOT_TITLE);
+    ui->btnLiveGauge->setText("实时数据...");
+}
+
+void FittingWidget::onGaugeSnapshot(const SeriesData& data, qint64 acceptedCount)
+{
+    if (!m_gaugeLinked) {
+        // 观测数据已被其他数据替换：不再接收
+        stopGaugeStream();
+        return;
+    }
+    m_gaugePending = data;
+    m_gaugePoints = acceptedCount;
+    m_gaugeShowPending = true;
+    m_chartWidget->setTitle(QString("%1 - 实时数据 %2 点").arg(QString(PLOT_TITLE)).arg(data.size()));
+    // 拟合进行中不替换观测数据，拟合结束后再显示
+    if (!m_isFitting) flushGaugeSnapshot();
+}
+
+void FittingWidget::flushGaugeSnapshot()
+{
+    if (!m_gaugeLinked || !m_gaugeShowPending) return;
+    m_gaugeShowPending = false;
+    const SeriesData data = m_gaugePending;
+    m_gaugePending = SeriesData();
+    setObservedData(data.time(), data.pressure(), data.derivative());
+    m_gaugeLinked = true; // setObservedData 解除了跟随，此处恢复
+
+    if (m_gaugeFitEvery > 0 && m_gaugePoints - m_gaugeFitPoints >= m_gaugeFitEvery) startRollingFit();
+}
+
+void FittingWidget::startRollingFit()
+{
+    if (m_isFitting || !m_modelManager || m_fitData.isEmpty()) return;
+
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+    bool anyFit = false;
+    for (const auto& p : params) anyFit = anyFit || p.isFit;
+    if (!anyFit) return;
+
+    cancelPreview();
+    m_isFitting = true;
+    m_rollingFit = true;
+    m_stopRequested = false;
+    ui->btnRunFit->setEnabled(false);
+    m_gaugeFitPoints = m_gaugePoints;
+    m_multiStartSolutions.clear();
+    m_screenRankings.clear();
+    m_uncertaintyPending = false;
+    m_paramChart->clearUncertainty();
+
+    ModelManager::ModelType modelType = m_currentModelType;
+    double w = ui->sliderWeight->value() / 100.0;
+    FittingCore::WarmStart warm = m_warmStart;
+    m_watcher.setFuture(QtConcurrent::run([this, modelType, params, w, warm]() {
+        runRollingFit(modelType, params, w, warm);
+    }));
+}
+
+void FittingWidget::runRollingFit(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, const FittingCore::WarmStart& warm)
+{
+    // 参数表中是上一次拟合 (或手动调节) 的结果，作为初值在新数据上单级迭代几步
+    FittingCore core(m_modelManager->createSolver(modelType));
+    core.setObservedData(m_fitData);
+    core.setFitWindows(m_fitWindows);
+    core.setIterationCallback([this](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        queueIterationUpdate(mse, p, curve);
+    });
+    core.setProgressCallback([this](int percent) { emit sigProgress(percent); });
+    core.setStopPredicate([this]() { return m_stopRequested; });
+
+    FittingCore::Options options;
+    options.weight = weight;
+    options.maxIterations = ROLLING_FIT_MAX_ITERATIONS;
+    options.jacobianRefreshInterval = 4;
+    // 新增的点由保存的灵敏度插值得到雅可比，通常不必重新完整计算
+    options.warmStart = warm;
+    FittingCore::Result result = core.run(params, options);
+
+    storeWarmStart(modelType, result.warmStart);
+    recordPerformance(FitPerformanceLog::makeRecord(result, options, modelType, m_fitData.size(), m_observed.size()), "rolling");
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
+
 void FittingWidget::onSliderWeightChanged(int value)
 {
     double wPressure = value / 100.0;
@@ -290,12 +766,13 @@ void FittingWidget::on_btnSelectParams_clicked()
 
 void FittingWidget::on_btnRunFit_clicked() {
     if(m_isFitting) return;
-    if(m_obsTime.isEmpty()) {
+    if(m_observed.isEmpty()) {
         QMessageBox::warning(this,"错误","请先加载观测数据。");
         return;
     }
 
     m_paramChart->updateParamsFromTable();
+    cancelPreview();
     m_isFitting = true;
     m_stopRequested = false;
     ui->btnRunFit->setEnabled(false);
@@ -303,10 +780,104 @@ void FittingWidget::on_btnRunFit_clicked() {
     ModelManager::ModelType modelType = m_currentModelType;
     QList<FitParameter> paramsCopy = m_paramChart->getParameters();
     double w = ui->sliderWeight->value() / 100.0;
+    bool multiStart = ui->checkMultiStart->isChecked();
+    int seedCount = ui->spinSeedCount->value();
+    bool surrogate = ui->checkSurrogate->isChecked();
+    int evalCount = ui->spinEvalCount->value();
+    m_multiStartSolutions.clear();
+    m_screenRankings.clear();
+    m_uncertaintyPending = false;
+    m_paramChart->clearUncertainty();
+    FittingCore::WarmStart warm = m_warmStart;
 
     // 启动异步线程拟合
-    m_watcher.setFuture(QtConcurrent::run([this, modelType, paramsCopy, w](){
-        runOptimizationTask(modelType, paramsCopy, w);
+    m_watcher.setFuture(QtConcurrent::run([this, modelType, paramsCopy, w, multiStart, seedCount, surrogate, evalCount, warm](){
+        if (multiStart) runMultiStartOptimization(modelType, paramsCopy, w, seedCount);
+        else if (surrogate) runSurrogateOptimization(modelType, paramsCopy, w, evalCount);
+        else runOptimizationTask(modelType, paramsCopy, w, warm);
+    }));
+}
+
+void FittingWidget::on_btnAutoScreen_clicked() {
+    if(m_isFitting || !m_modelManager) return;
+    if(m_observed.isEmpty()) {
+        QMessageBox::warning(this,"错误","请先加载观测数据。");
+        return;
+    }
+
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> current = m_paramChart->getParameters();
+    bool anyFit = false;
+    for(const auto& p : current) anyFit = anyFit || p.isFit;
+    if(!anyFit) {
+        QMessageBox::warning(this,"错误","请先在参数表中选择要拟合的参数。");
+        return;
+    }
+
+    QList<ModelScreener::Candidate> candidates;
+    for(int i = ModelManager::Model_1; i <= ModelManager::Model_6; ++i) {
+        ModelManager::ModelType type = (ModelManager::ModelType)i;
+        candidates.append({ type, screeningParameters(type, current) });
+    }
+
+    m_isFitting = true;
+    m_stopRequested = false;
+    ui->btnRunFit->setEnabled(false);
+    m_multiStartSolutions.clear();
+    m_screenRankings.clear();
+    m_uncertaintyPending = false;
+    m_paramChart->clearUncertainty();
+    m_screenCandidates = candidates;
+    double w = ui->sliderWeight->value() / 100.0;
+
+    m_watcher.setFuture(QtConcurrent::run([this, candidates, w](){
+        runModelScreening(candidates, w);
+    }));
+}
+
+void FittingWidget::on_btnUncertainty_clicked() {
+    if(m_isFitting || !m_modelManager) return;
+    if(m_fitData.isEmpty()) {
+        QMessageBox::warning(this,"错误","请先加载观测数据。");
+        return;
+    }
+
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+    bool anyFit = false;
+    for(const auto& p : params) anyFit = anyFit || p.isFit;
+    if(!anyFit) {
+        QMessageBox::warning(this,"错误","请先在参数表中选择拟合参数 (以当前数值作为拟合结果)。");
+        return;
+    }
+
+    QStringList methods;
+    methods << "线性化协方差 (快速)" << "残差自助法 (多次重新拟合)";
+    bool ok = false;
+    QString method = QInputDialog::getItem(this, "参数不确定性", "估计方法:", methods, 0, false, &ok);
+    if(!ok) return;
+
+    ParameterUncertainty::Options options;
+    options.weight = ui->sliderWeight->value() / 100.0;
+    options.method = method == methods[1] ? ParameterUncertainty::ResidualBootstrap : ParameterUncertainty::Linearized;
+    if(options.method == ParameterUncertainty::ResidualBootstrap) {
+        options.samples = QInputDialog::getInt(this, "参数不确定性", "自助法样本数:", options.samples, 10, 1000, 10, &ok);
+        if(!ok) return;
+        options.fit.maxIterations = 20;
+        options.fit.jacobianRefreshInterval = 4;
+    }
+
+    cancelPreview();
+    m_isFitting = true;
+    m_stopRequested = false;
+    ui->btnRunFit->setEnabled(false);
+    m_multiStartSolutions.clear();
+    m_screenRankings.clear();
+    m_uncertaintyPending = true;
+    ModelManager::ModelType modelType = m_currentModelType;
+
+    m_watcher.setFuture(QtConcurrent::run([this, modelType, params, options](){
+        runUncertaintyAnalysis(modelType, params, options);
     }));
 }
 
@@ -346,6 +917,7 @@ void FittingWidget::on_btn_modelSelect_clicked() {
         if (found) {
             m_paramChart->switchModel(newType);
             m_currentModelType = newType;
+            m_warmStart = FittingCore::WarmStart();
             ui->btn_modelSelect->setText("当前: " + name);
             updateModelCurve();
         } else {
@@ -404,309 +976,594 @@ void FittingWidget::onExportCurveData() {
 
     if (!graphObsP || !graphModP) return;
 
-    QFile f(path);
-    if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&f);
-        out << "Obs_Time,Obs_DP,Obs_Deriv,Model_Time,Model_DP,Model_Deriv\n";
-
-        auto itObsP = graphObsP->data()->begin();
-        auto itObsD = graphObsD->data()->begin();
-        auto itModP = graphModP->data()->begin();
-        auto itModD = graphModD->data()->begin();
-
-        auto endObsP = graphObsP->data()->end();
-        auto endModP = graphModP->data()->end();
-
-        while (itObsP != endObsP || itModP != endModP) {
-            QStringList line;
-
-            if (itObsP != endObsP) {
-                line << QString::number(itObsP->key, 'g', 10);
-                line << QString::number(itObsP->value, 'g', 10);
-                if (itObsD != graphObsD->data()->end()) {
-                    line << QString::number(itObsD->value, 'g', 10);
-                    ++itObsD;
-                } else {
-                    line << "";
-                }
-                ++itObsP;
-            } else {
-                line << "" << "" << "";
-            }
-
-            if (itModP != endModP) {
-                line << QString::number(itModP->key, 'g', 10);
-                line << QString::number(itModP->value, 'g', 10);
-                if (itModD != graphModD->data()->end()) {
-                    line << QString::number(itModD->value, 'g', 10);
-                    ++itModD;
-                } else {
-                    line << "";
-                }
-                ++itModP;
-            } else {
-                line << "" << "" << "";
-            }
-
-            out << line.join(",") << "\n";
-        }
-
-        f.close();
-        QMessageBox::information(this, "导出成功", "拟合曲线数据已保存。");
-    }
+    // 界面线程只取出曲线数据 (按横坐标排序，与图中一致)，格式化与写盘在后台进行
+    // 导数列与压力列逐行对应，比压力列长的部分不输出
+    auto keysOf = [](QCPGraph* g) {
+        QVector<double> v;
+        v.reserve(g->data()->size());
+        for (auto it = g->data()->constBegin(); it != g->data()->constEnd(); ++it) v.append(it->key);
+        return v;
+    };
+    auto valuesOf = [](QCPGraph* g, int maxCount) {
+        QVector<double> v;
+        v.reserve(qMin(g->data()->size(), maxCount));
+        for (auto it = g->data()->constBegin(); it != g->data()->constEnd() && v.size() < maxCount; ++it) v.append(it->value);
+        return v;
+    };
+    const int obsCount = graphObsP->data()->size();
+    const int modCount = graphModP->data()->size();
+    QVector<CsvExporter::Column> columns = {
+        {"Obs_Time", keysOf(graphObsP)}, {"Obs_DP", valuesOf(graphObsP, obsCount)}, {"Obs_Deriv", valuesOf(graphObsD, obsCount)},
+        {"Model_Time", keysOf(graphModP)}, {"Model_DP", valuesOf(graphModP, modCount)}, {"Model_Deriv", valuesOf(graphModD, modCount)}
+    };
+    CsvExportDialog::start(this, path, columns, ',', 10, [this](const QString& error) {
+        if (error.isEmpty()) QMessageBox::information(this, "导出成功", "拟合曲线数据已保存。");
+        else QMessageBox::warning(this, "导出失败", error);
+    });
 }
 
-void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight, const FittingCore::WarmStart& warm) {
+    runLevenbergMarquardtOptimization(modelType, fitParams, weight, warm);
 }
 
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    // 关键：在后台线程中调用 Manager 的 setHighPrecision，现在这会设置后台 Solver 的精度
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
-
-    QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) {
-        if(params[i].isFit) fitIndices.append(i);
-    }
-    int nParams = fitIndices.size();
-
-    if(nParams == 0) {
+void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, const FittingCore::WarmStart& warm) {
+    if(!m_modelManager) {
         QMetaObject::invokeMethod(this, "onFitFinished");
         return;
     }
 
-    double lambda = 0.01;
-    int maxIter = 50;
-    double currentSSE = 1e15;
+    // 为本次拟合创建独立求解器，不改动任何共享求解器的状态；算法本身由 FittingCore 实现
+    // 迭代在重采样后的数据上进行，残差计算量与原始采样密度无关
+    FittingCore core(m_modelManager->createSolver(modelType));
+    core.setObservedData(m_fitData);
+    core.setFitWindows(m_fitWindows);
+    core.setIterationCallback([this](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        queueIterationUpdate(mse, p, curve);
+    });
+    core.setProgressCallback([this](int percent) { emit sigProgress(percent); });
+    core.setStopPredicate([this]() { return m_stopRequested; });
+
+    FittingCore::Options options;
+    options.weight = weight;
+    options.jacobianRefreshInterval = 4; // 接受步之间用 Broyden 更新，每 4 次迭代完整计算一次雅可比
+    // 分级精度：N=4 抽稀数据上粗迭代，改进停滞后升到 N=8、N=12 并逐级加密到全部拟合数据
+    options.stehfestSchedule = { 4, 8, 12 };
+    options.pointsPerCycleSchedule = { 10, 25, 0 };
+    // 参数集合未变且起点与上次结束处相近时，沿用上次的雅可比、阻尼与精度级
+    options.warmStart = warm;
+    FittingCore::Result result = core.run(params, options);
+
+    // 可选：以重采样结果为初值，在全部观测数据上用高精度求解再迭代几步
+    // 续算状态取分级拟合的结果 (精度级对应上面的分级设置)
+    FittingCore::Result refined;
+    FitPerformanceLog::Record perf = FitPerformanceLog::makeRecord(result, options, modelType, m_fitData.size(), m_observed.size());
+    if (refineOnFullData(modelType, params, result.params, weight, refined)) FitPerformanceLog::accumulate(perf, refined);
+
+    storeWarmStart(modelType, result.warmStart);
+    recordPerformance(perf, "fit");
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
+
+void FittingWidget::storeWarmStart(ModelManager::ModelType modelType, const FittingCore::WarmStart& warm)
+{
+    if (!warm.isValid() || m_stopRequested) return;
+    QMetaObject::invokeMethod(this, [this, modelType, warm]() {
+        if (modelType == m_currentModelType) m_warmStart = warm;
+    }, Qt::QueuedConnection);
+}
 
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
+void FittingWidget::recordPerformance(FitPerformanceLog::Record record, const QString& source)
+{
+    if (m_stopRequested) return;
+    record.source = source;
+    record.pointsPerCycle = m_resampleOptions.enabled ? m_resampleOptions.pointsPerCycle : 0;
+    QMetaObject::invokeMethod(this, [this, record]() { emit performanceRecorded(record); }, Qt::QueuedConnection);
+}
 
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+bool FittingWidget::refineOnFullData(ModelManager::ModelType modelType, QList<FitParameter> params, const QMap<QString, double>& start,
+                                     double weight, FittingCore::Result& result)
+{
+    if (!m_refineOnFullData || m_fitData.size() >= m_observed.size() || m_stopRequested) return false;
 
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
-    currentSSE = calculateSumSquaredError(residuals);
+    for (auto& p : params) {
+        if (start.contains(p.name)) p.value = start[p.name];
+    }
+    FittingCore refine(m_modelManager->createSolver(modelType));
+    refine.setObservedData(m_observed);
+    refine.setFitWindows(m_fitWindows);
+    refine.setIterationCallback([this](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        queueIterationUpdate(mse, p, curve);
+    });
+    refine.setStopPredicate([this]() { return m_stopRequested; });
+
+    FittingCore::Options refineOptions;
+    refineOptions.weight = weight;
+    refineOptions.maxIterations = 5;
+    refineOptions.highPrecision = true;
+    result = refine.run(params, refineOptions);
+    return true;
+}
 
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+void FittingWidget::runMultiStartOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, int seedCount)
+{
+    if(!m_modelManager) return;
 
-    for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
+    ModelManager* manager = m_modelManager;
+    MultiStartFitter fitter([manager, modelType]() { return manager->createSolver(modelType); });
+    fitter.setObservedData(m_fitData.time(), m_fitData.pressure(), m_fitData.derivative());
+    fitter.setFitWindows(m_fitWindows);
+    fitter.setImprovementCallback([this](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        queueIterationUpdate(mse, p, curve);
+    });
+    fitter.setProgressCallback([this](int finished, int total) { emit sigProgress(finished * 100 / total); });
+    fitter.setStopPredicate([this]() { return m_stopRequested; });
+
+    MultiStartFitter::Options options;
+    options.seedCount = seedCount;
+    options.fit.weight = weight;
+    options.fit.jacobianRefreshInterval = 4;
+    QList<MultiStartFitter::Solution> solutions = fitter.run(params, options);
+    if (solutions.isEmpty()) return;
+
+    // 全数据精修只对最优解进行；各起点的改进通知可能乱序到达，最后再显示一次最优解
+    FittingCore::Result refined;
+    if (refineOnFullData(modelType, params, solutions[0].params, weight, refined)) {
+        solutions[0].params = refined.params;
+        solutions[0].mse = refined.mse;
+    } else {
+        ModelCurveData curve = manager->createSolver(modelType)->calculateTheoreticalCurve(solutions[0].params, QVector<double>(), ModelSolver01_06::CalcOptions());
+        queueIterationUpdate(solutions[0].mse, solutions[0].params, curve);
+    }
 
-        emit sigProgress(iter * 100 / maxIter);
+    // 拟合线程结束 (QFutureWatcher::finished) 之后界面线程才读取
+    m_multiStartSolutions = solutions;
+}
 
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
-        int nRes = residuals.size();
+void FittingWidget::runSurrogateOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, int evalCount)
+{
+    if(!m_modelManager) return;
 
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
+    SurrogateOptimizer optimizer(m_modelManager->createSolver(modelType));
+    optimizer.setObservedData(m_fitData.time(), m_fitData.pressure(), m_fitData.derivative());
+    optimizer.setFitWindows(m_fitWindows);
+    optimizer.setImprovementCallback([this](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        queueIterationUpdate(mse, p, curve);
+    });
+    optimizer.setProgressCallback([this](int percent) { emit sigProgress(percent); });
+    optimizer.setStopPredicate([this]() { return m_stopRequested; });
+
+    SurrogateOptimizer::Options options;
+    options.maxEvaluations = evalCount;
+    options.fit.weight = weight;
+    options.fit.maxIterations = 15;
+    SurrogateOptimizer::Result result = optimizer.run(params, options);
+
+    FittingCore::Result refined;
+    refineOnFullData(modelType, params, result.params, weight, refined);
+}
 
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                g[i] += J[k][i] * residuals[k];
-                for(int j=0; j<=i; ++j) {
-                    H[i][j] += J[k][i] * J[k][j];
-                }
+// 某个模型的候选参数表：取该模型的默认参数，同名参数沿用当前的取值、上下限和是否拟合；
+// 定井储模型 (Model_2/4/6) 的井储系数与表皮系数为 0，不参与拟合
+QList<FitParameter> FittingWidget::screeningParameters(ModelManager::ModelType type, const QList<FitParameter>& current) const
+{
+    QMap<QString, double> defaults = m_modelManager->getDefaultParameters(type);
+    bool constantStorage = (type == ModelManager::Model_2 || type == ModelManager::Model_4 || type == ModelManager::Model_6);
+
+    QList<FitParameter> params;
+    for(auto it = defaults.begin(); it != defaults.end(); ++it) {
+        FitParameter p;
+        p.name = it.key();
+        p.displayName = it.key();
+        p.value = it.value();
+        p.isFit = false;
+        p.min = p.value > 0 ? p.value * 0.01 : 0.0;
+        p.max = p.value > 0 ? p.value * 100.0 : 100.0;
+        p.isVisible = true;
+        for(const FitParameter& c : current) {
+            if(c.name == p.name) {
+                p = c;
+                break;
             }
         }
-        for(int i=0; i<nParams; ++i) {
-            for(int j=i+1; j<nParams; ++j) {
-                H[i][j] = H[j][i];
-            }
+        if(constantStorage && (p.name == "cD" || p.name == "S")) {
+            p.value = 0.0;
+            p.isFit = false;
         }
+        params.append(p);
+    }
+    return params;
+}
 
-        bool stepAccepted = false;
-        for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) {
-                H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            }
-
-            QVector<double> negG(nParams);
-            for(int i=0;i<nParams;++i) negG[i] = -g[i];
-
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-            QMap<QString, double> trialMap = currentParamMap;
+void FittingWidget::runModelScreening(QList<ModelScreener::Candidate> candidates, double weight)
+{
+    ModelScreener screener;
+    screener.setObservedData(m_observed.time(), m_observed.pressure(), m_observed.derivative());
+    screener.setProgressCallback([this](int finished, int total) { emit sigProgress(finished * 90 / total); });
+    screener.setRefineCallback([this](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        queueIterationUpdate(mse, p, curve);
+    });
+    screener.setStopPredicate([this]() { return m_stopRequested; });
+
+    ModelScreener::Options options;
+    options.fit.weight = weight;
+    options.fit.maxIterations = 30;
+    options.fit.jacobianRefreshInterval = 4;
+    QList<ModelScreener::Ranking> rankings = screener.run(candidates, options);
+    emit sigProgress(100);
+
+    // 拟合线程结束 (QFutureWatcher::finished) 之后界面线程才读取
+    m_screenRankings = rankings;
+}
 
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
+void FittingWidget::runUncertaintyAnalysis(ModelManager::ModelType modelType, QList<FitParameter> params, ParameterUncertainty::Options options)
+{
+    if(!m_modelManager) return;
 
-                if(isLog) newVal = pow(10.0, log10(oldVal) + delta[i]);
-                else newVal = oldVal + delta[i];
+    ModelManager* manager = m_modelManager;
+    ParameterUncertainty analysis([manager, modelType]() { return manager->createSolver(modelType); });
+    analysis.setObservedData(m_fitData.time(), m_fitData.pressure(), m_fitData.derivative());
+    analysis.setFitWindows(m_fitWindows);
+    analysis.setProgressCallback([this](int finished, int total) { emit sigProgress(finished * 100 / total); });
+    analysis.setStopPredicate([this]() { return m_stopRequested; });
 
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
-            }
+    // 拟合线程结束 (QFutureWatcher::finished) 之后界面线程才读取
+    m_uncertaintyResult = analysis.run(params, options);
+}
 
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9)
-                trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
+void FittingWidget::showUncertaintyResults()
+{
+    m_uncertaintyPending = false;
+    const ParameterUncertainty::Result& result = m_uncertaintyResult;
+    if(!result.valid) {
+        QMessageBox::warning(this, "参数不确定性", m_stopRequested ? "分析已停止。" : "无法完成分析 (模型无法求值或样本拟合全部失败)。");
+        return;
+    }
+    m_paramChart->setUncertainty(result.intervals);
 
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
-            double newSSE = calculateSumSquaredError(newRes);
+    QString text;
+    if(result.method == ParameterUncertainty::ResidualBootstrap)
+        text = QString("残差自助法：成功 %1 个样本，失败 %2 个。").arg(result.samples).arg(result.failed);
+    else
+        text = "线性化协方差估计完成。";
+    text += QString("\n残差标准差 (对数): %1").arg(result.residualSigma, 0, 'g', 4);
+    text += "\n参数表中列出 P90 / P50 / P10 (P90 为低值，P10 为高值)。";
+    for(const auto& i : result.intervals) {
+        if(!i.identifiable) {
+            text += "\n注意：部分参数不可辨识 (数据对其不敏感或参数间强相关)，区间取参数上下限。";
+            break;
+        }
+    }
+    QMessageBox::information(this, "参数不确定性", text);
+}
 
-            if(newSSE < currentSSE) {
-                currentSSE = newSSE;
-                currentParamMap = trialMap;
-                residuals = newRes;
-                lambda /= 10.0;
-                stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
+void FittingWidget::showScreeningResults()
+{
+    QList<ModelScreener::Ranking> rankings = m_screenRankings;
+    m_screenRankings.clear();
+    if(rankings.isEmpty()) return;
+
+    QDialog dlg(this);
+    dlg.setWindowTitle("模型自动筛选结果");
+    QVBoxLayout* layout = new QVBoxLayout(&dlg);
+    layout->addWidget(new QLabel("按 AIC 升序排列 (数值越小越好)，第 1 名已在全部数据上高精度精修：", &dlg));
+
+    QTableWidget* table = new QTableWidget(rankings.size(), 7, &dlg);
+    table->setHorizontalHeaderLabels(QStringList() << "排名" << "模型" << "误差(MSE)" << "AIC" << "BIC" << "拟合参数数" << "迭代次数");
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    for(int r = 0; r < rankings.size(); ++r) {
+        const ModelScreener::Ranking& s = rankings[r];
+        bool valid = std::isfinite(s.mse);
+        table->setItem(r, 0, new QTableWidgetItem(QString::number(r + 1)));
+        table->setItem(r, 1, new QTableWidgetItem(ModelManager::getModelTypeName(s.type)));
+        table->setItem(r, 2, new QTableWidgetItem(valid ? QString::number(s.mse, 'e', 3) : QString("失败")));
+        table->setItem(r, 3, new QTableWidgetItem(valid ? QString::number(s.aic, 'f', 1) : QString("-")));
+        table->setItem(r, 4, new QTableWidgetItem(valid ? QString::number(s.bic, 'f', 1) : QString("-")));
+        table->setItem(r, 5, new QTableWidgetItem(QString::number(s.parameterCount)));
+        table->setItem(r, 6, new QTableWidgetItem(QString::number(s.iterations)));
+    }
+    table->selectRow(0);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(table);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(&dlg);
+    buttons->addButton("切换到所选模型", QDialogButtonBox::AcceptRole);
+    buttons->addButton("关闭", QDialogButtonBox::RejectRole);
+    connect(buttons, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+    layout->addWidget(buttons);
+    dlg.resize(720, 320);
+
+    if(dlg.exec() != QDialog::Accepted || table->currentRow() < 0) return;
+    const ModelScreener::Ranking& chosen = rankings[table->currentRow()];
+    if(!std::isfinite(chosen.mse)) return;
+
+    QList<FitParameter> params;
+    for(const ModelScreener::Candidate& c : m_screenCandidates) {
+        if(c.type == chosen.type) { params = c.params; break; }
+    }
+    // 切换模型后再写入参数，保留显示名称等由参数表生成的信息
+    m_paramChart->switchModel(chosen.type);
+    QList<FitParameter> tableParams = m_paramChart->getParameters();
+    for(auto& p : tableParams) {
+        for(const FitParameter& c : params) {
+            if(c.name == p.name) {
+                p.isFit = c.isFit;
+                p.min = c.min;
+                p.max = c.max;
                 break;
-            } else {
-                lambda *= 10.0;
             }
         }
-        if(!stepAccepted && lambda > 1e10) break;
+        p.value = chosen.params.value(p.name, p.value);
     }
-
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
-
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
-
-    QMetaObject::invokeMethod(this, "onFitFinished");
+    m_paramChart->setParameters(tableParams);
+    if (chosen.type != m_currentModelType) m_warmStart = FittingCore::WarmStart();
+    m_currentModelType = chosen.type;
+    ui->btn_modelSelect->setText("当前: " + ModelManager::getModelTypeName(chosen.type));
+    updateModelCurve();
 }
 
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
-    if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
-
-    // 调用 Manager 接口，Manager 内部会调用 Solver，线程安全
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
-    const QVector<double>& pCal = std::get<1>(res);
-    const QVector<double>& dpCal = std::get<2>(res);
+void FittingWidget::showMultiStartResults()
+{
+    QList<MultiStartFitter::Solution> solutions = m_multiStartSolutions;
+    m_multiStartSolutions.clear();
+    if (solutions.isEmpty()) return;
 
-    QVector<double> r;
-    double wp = weight;
-    double wd = 1.0 - weight;
+    QList<FitParameter> fitParams;
+    for (const FitParameter& p : m_paramChart->getParameters()) {
+        if (p.isFit) fitParams.append(p);
+    }
 
-    int count = qMin(m_obsDeltaP.size(), pCal.size());
-    for(int i=0; i<count; ++i) {
-        if(m_obsDeltaP[i] > 1e-10 && pCal[i] > 1e-10)
-            r.append( (log(m_obsDeltaP[i]) - log(pCal[i])) * wp );
-        else
-            r.append(0.0);
+    QDialog dlg(this);
+    dlg.setWindowTitle("多起点拟合结果");
+    QVBoxLayout* layout = new QVBoxLayout(&dlg);
+    layout->addWidget(new QLabel(QString("共得到 %1 组不同的解 (按误差升序)，第 1 组已应用到参数表：").arg(solutions.size()), &dlg));
+
+    QTableWidget* table = new QTableWidget(solutions.size(), fitParams.size() + 3, &dlg);
+    QStringList headers;
+    headers << "起点" << "误差(MSE)" << "迭代次数";
+    for (const FitParameter& p : fitParams) headers << p.displayName;
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    for (int r = 0; r < solutions.size(); ++r) {
+        const MultiStartFitter::Solution& s = solutions[r];
+        QString seedText = s.seedIndex == 0 ? QString("当前值") : QString::number(s.seedIndex);
+        if (s.pruned) seedText += " (提前停止)";
+        table->setItem(r, 0, new QTableWidgetItem(seedText));
+        table->setItem(r, 1, new QTableWidgetItem(QString::number(s.mse, 'e', 3)));
+        table->setItem(r, 2, new QTableWidgetItem(QString::number(s.iterations)));
+        for (int c = 0; c < fitParams.size(); ++c) {
+            table->setItem(r, c + 3, new QTableWidgetItem(QString::number(s.params.value(fitParams[c].name), 'g', 5)));
+        }
     }
+    table->selectRow(0);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(table);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(&dlg);
+    QPushButton* btnApply = buttons->addButton("应用所选解", QDialogButtonBox::AcceptRole);
+    buttons->addButton("关闭", QDialogButtonBox::RejectRole);
+    connect(buttons, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+    connect(table, &QTableWidget::itemSelectionChanged, [table, btnApply]() {
+        btnApply->setEnabled(!table->selectedItems().isEmpty());
+    });
+    layout->addWidget(buttons);
+    dlg.resize(640, 320);
+
+    if (dlg.exec() != QDialog::Accepted || table->currentRow() < 0) return;
+
+    const MultiStartFitter::Solution& chosen = solutions[table->currentRow()];
+    QVector<double> targetT = m_fitData.time();
+    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(m_currentModelType, chosen.params, targetT);
+    onIterationUpdate(chosen.mse, chosen.params, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+}
 
-    int dCount = qMin(m_obsDerivative.size(), dpCal.size());
-    dCount = qMin(dCount, count);
-    for(int i=0; i<dCount; ++i) {
-        if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10)
-            r.append( (log(m_obsDerivative[i]) - log(dpCal[i])) * wd );
-        else
-            r.append(0.0);
+void FittingWidget::updateModelCurve() {
+    if(!m_modelManager) {
+        QMessageBox::critical(this, "错误", "ModelManager 未初始化！");
+        return;
     }
-    return r;
+    ui->tableParams->clearFocus();
+    // 同步计算的曲线即为最新结果，尚未完成的预览直接丢弃
+    cancelPreview();
+
+    QMap<QString,double> currentParams = currentModelParams();
+
+    // 手动调整参数时的预览曲线经型曲线库插值，缩放类参数的改动无需重新反演
+    ModelCurveData res = refinedModelCurve(m_modelManager, m_currentModelType, currentParams, modelCurveTime(), nullptr);
+    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
 }
 
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
-    int nRes = baseResiduals.size();
-    int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
+QMap<QString, double> FittingWidget::currentModelParams() {
+    m_paramChart->updateParamsFromTable();
 
-    for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j];
-        QString pName = currentFitParams[idx].name;
-        double val = params.value(pName);
-        bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
+    QMap<QString,double> currentParams;
+    for(const auto& p : m_paramChart->getParameters()) currentParams.insert(p.name, p.value);
 
-        double h;
-        QMap<QString, double> pPlus = params;
-        QMap<QString, double> pMinus = params;
+    if(currentParams.contains("L") && currentParams.contains("Lf") && currentParams["L"] > 1e-9)
+        currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
+    else
+        currentParams["LfD"] = 0.0;
+    return currentParams;
+}
 
-        if(isLog) {
-            h = 0.01;
-            double valLog = log10(val);
-            pPlus[pName] = pow(10.0, valLog + h);
-            pMinus[pName] = pow(10.0, valLog - h);
-        } else {
-            h = 1e-4;
-            pPlus[pName] = val + h;
-            pMinus[pName] = val - h;
-        }
+QVector<double> FittingWidget::modelCurveTime() const {
+    // 理论曲线只需画出形状，使用重采样后的时间点即可；无数据时为空，由求解器自适应选点
+    return m_fitData.time();
+}
 
-        auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
+void FittingWidget::cancelPreview() {
+    ++m_previewGeneration;
+    if(m_previewControl) m_previewControl->cancel();
+    // 排队中尚未开始的旧请求直接移除
+    m_previewPool.clear();
+}
 
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
+void FittingWidget::requestPreviewCurve() {
+    // 拟合过程中曲线由迭代结果刷新
+    if(!m_modelManager || m_isFitting) return;
+    cancelPreview();
 
-        if(rPlus.size() == nRes && rMinus.size() == nRes) {
-            for(int i=0; i<nRes; ++i) {
-                J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
-            }
+    QSharedPointer<SolverControl> control = QSharedPointer<SolverControl>::create();
+    m_previewControl = control;
+    int generation = m_previewGeneration;
+    ModelManager* manager = m_modelManager;
+    ModelManager::ModelType type = m_currentModelType;
+    QMap<QString,double> params = currentModelParams();
+    QVector<double> targetT = modelCurveTime();
+
+    m_previewPool.start([this, manager, type, params, targetT, control, generation]() {
+        // 上一次精算超出交互时限 (或尚无记录) 时，先粗算并立即显示
+        qint64 lastMs = m_lastRefineMs.load();
+        if(lastMs < 0 || lastMs > PREVIEW_BUDGET_MS) {
+            ModelSolver01_06::CalcOptions coarse;
+            coarse.highPrecision = false;
+            coarse.control = control.data();
+            ModelCurveData curve = manager->calculateTheoreticalCurve(type, params, coarsePreviewTime(targetT), coarse);
+            if(control->isStopped()) return;
+            QMetaObject::invokeMethod(this, [this, generation, curve]() { showPreviewCurve(generation, curve); }, Qt::QueuedConnection);
         }
-    }
-    return J;
+
+        QElapsedTimer timer;
+        timer.start();
+        ModelCurveData curve = refinedModelCurve(manager, type, params, targetT, control.data());
+        if(control->isStopped()) return;
+        m_lastRefineMs.store(timer.elapsed());
+        QMetaObject::invokeMethod(this, [this, generation, curve]() { showPreviewCurve(generation, curve); }, Qt::QueuedConnection);
+    });
 }
 
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size();
-    if (n == 0) return QVector<double>();
+void FittingWidget::showPreviewCurve(int generation, const ModelCurveData& curve) {
+    // 结果返回前已有更新的请求 (或已开始拟合) 时丢弃
+    if(generation != m_previewGeneration || m_isFitting) return;
+    plotCurves(std::get<0>(curve), std::get<1>(curve), std::get<2>(curve), true);
+}
 
-    Eigen::MatrixXd matA(n, n);
-    Eigen::VectorXd vecB(n);
+double FittingWidget::sliderToValue(const FitParameter& p, int position) const {
+    double s = double(position) / PARAM_SLIDER_STEPS;
+    // 跨数量级的参数按对数刻度，与多起点采样的判断一致
+    double v = MultiStartFitter::sampleInLogSpace(p) ? p.min * std::pow(p.max / p.min, s) : p.min + (p.max - p.min) * s;
+    if(p.name == "nf") v = std::round(v);
+    return v;
+}
 
-    for (int i = 0; i < n; ++i) {
-        vecB(i) = b[i];
-        for (int j = 0; j < n; ++j) {
-            matA(i, j) = A[i][j];
-        }
+int FittingWidget::valueToSlider(const FitParameter& p, double value) const {
+    double s = 0.0;
+    if(MultiStartFitter::sampleInLogSpace(p)) {
+        if(value > 0) s = std::log(value / p.min) / std::log(p.max / p.min);
+    } else if(p.max > p.min) {
+        s = (value - p.min) / (p.max - p.min);
     }
+    return qBound(0, (int)std::lround(s * PARAM_SLIDER_STEPS), PARAM_SLIDER_STEPS);
+}
 
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
+void FittingWidget::bindParamSlider(const QString& name) {
+    m_sliderParam = name;
+    QSignalBlocker blocker(ui->sliderParam);
 
-    QVector<double> res(n);
-    for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
+    int row = -1;
+    for(int i=0; i<ui->tableParams->rowCount(); ++i) {
+        QTableWidgetItem* item = ui->tableParams->item(i, 1);
+        if(item && item->data(Qt::UserRole).toString() == name) { row = i; break; }
+    }
+    for(const auto& p : m_paramChart->getParameters()) {
+        if(p.name != name) continue;
+        if(row < 0 || !(p.max > p.min)) break;
+        ui->sliderParam->setEnabled(true);
+        ui->label_ParamSlider->setText(QString("拖动调节: %1").arg(p.displayName));
+        ui->sliderParam->setValue(valueToSlider(p, ui->tableParams->item(row, 2)->text().toDouble()));
+        return;
+    }
+    ui->sliderParam->setEnabled(false);
+    ui->label_ParamSlider->setText("拖动调节: (请选择参数)");
 }
 
-double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
-    double sse = 0.0;
-    for(double v : residuals) sse += v*v;
-    return sse;
+void FittingWidget::onParamRowSelected(int row) {
+    QTableWidgetItem* item = row >= 0 ? ui->tableParams->item(row, 1) : nullptr;
+    if(item) bindParamSlider(item->data(Qt::UserRole).toString());
 }
 
-void FittingWidget::updateModelCurve() {
-    if(!m_modelManager) {
-        QMessageBox::critical(this, "错误", "ModelManager 未初始化！");
+void FittingWidget::onParamSliderChanged(int position) {
+    if(m_isFitting || m_sliderParam.isEmpty()) return;
+    for(const auto& p : m_paramChart->getParameters()) {
+        if(p.name != m_sliderParam) continue;
+        double value = sliderToValue(p, position);
+        for(int i=0; i<ui->tableParams->rowCount(); ++i) {
+            QTableWidgetItem* item = ui->tableParams->item(i, 1);
+            if(!item || item->data(Qt::UserRole).toString() != m_sliderParam) continue;
+            QSignalBlocker blocker(ui->tableParams);
+            ui->tableParams->item(i, 2)->setText(QString::number(value, 'g', 6));
+            break;
+        }
+        requestPreviewCurve();
         return;
     }
-    ui->tableParams->clearFocus();
-
-    m_paramChart->updateParamsFromTable();
-    QList<FitParameter> params = m_paramChart->getParameters();
+}
 
-    QMap<QString,double> currentParams;
-    for(const auto& p : params) currentParams.insert(p.name, p.value);
+void FittingWidget::onParamCellChanged(int row, int column) {
+    // 只响应数值列的编辑
+    if(column != 2 || m_isFitting) return;
+    m_paramChart->clearUncertainty();
+    QTableWidgetItem* item = ui->tableParams->item(row, 1);
+    if(item && item->data(Qt::UserRole).toString() == m_sliderParam) bindParamSlider(m_sliderParam);
+    requestPreviewCurve();
+}
 
-    if(currentParams.contains("L") && currentParams.contains("Lf") && currentParams["L"] > 1e-9)
-        currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
-    else
-        currentParams["LfD"] = 0.0;
+void FittingWidget::queueIterationUpdate(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)
+{
+    bool schedule = false;
+    {
+        QMutexLocker locker(&m_iterationMutex);
+        m_pendingIteration.mse = mse;
+        m_pendingIteration.params = params;
+        m_pendingIteration.curve = curve;
+        schedule = !m_iterationQueued;
+        m_iterationQueued = true;
+    }
+    // 已安排取出时只覆盖最新状态，不再投递事件
+    if (schedule) QMetaObject::invokeMethod(this, [this]() { flushIterationUpdate(); }, Qt::QueuedConnection);
+}
 
-    ModelManager::ModelType type = m_currentModelType;
-    QVector<double> targetT = m_obsTime;
-    if(targetT.isEmpty()) {
-        for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e));
+int FittingWidget::iterationFrameInterval() const
+{
+    double rate = ITERATION_FRAME_RATE;
+    if (QScreen* s = screen()) {
+        if (s->refreshRate() > 0) rate = qMin(rate, s->refreshRate());
     }
+    return qMax(1, qRound(1000.0 / rate));
+}
 
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
-    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+void FittingWidget::flushIterationUpdate(bool force)
+{
+    if (!force && m_iterationClock.isValid()) {
+        qint64 wait = iterationFrameInterval() - m_iterationClock.elapsed();
+        if (wait > 0) {
+            if (!m_iterationTimer->isActive()) m_iterationTimer->start(int(wait));
+            return;
+        }
+    }
+    m_iterationTimer->stop();
+
+    PendingIteration latest;
+    {
+        QMutexLocker locker(&m_iterationMutex);
+        if (!m_iterationQueued) return;
+        latest = m_pendingIteration;
+        m_pendingIteration = PendingIteration();
+        m_iterationQueued = false;
+    }
+    m_iterationClock.start();
+    onIterationUpdate(latest.mse, latest.params, std::get<0>(latest.curve), std::get<1>(latest.curve), std::get<2>(latest.curve));
 }
 
 void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
                                       const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve) {
     ui->label_Error->setText(QString("误差(MSE): %1").arg(err, 0, 'e', 3));
+    m_paramChart->clearUncertainty();
 
     ui->tableParams->blockSignals(true);
     for(int i=0; i<ui->tableParams->rowCount(); ++i) {
@@ -717,32 +1574,48 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
         }
     }
     ui->tableParams->blockSignals(false);
+    if(!m_sliderParam.isEmpty()) bindParamSlider(m_sliderParam);
 
     plotCurves(t, p_curve, d_curve, true);
 }
 
 void FittingWidget::onFitFinished() {
+    // 拟合线程结束时 QFutureWatcher 与任务本身都会通知，只处理第一次
+    if(!m_isFitting) return;
+    // 尚在等待帧间隔的最新迭代 (通常是最终曲线) 立即显示
+    flushIterationUpdate(true);
     m_isFitting = false;
     ui->btnRunFit->setEnabled(true);
+    const bool rolling = m_rollingFit;
+    m_rollingFit = false;
+    flushLiveUpdate();
+    flushGaugeSnapshot();
+    if(rolling) return;
+    if(!m_multiStartSolutions.isEmpty()) {
+        showMultiStartResults();
+        return;
+    }
+    if(!m_screenRankings.isEmpty()) {
+        showScreeningResults();
+        return;
+    }
+    if(m_uncertaintyPending) {
+        showUncertaintyResults();
+        return;
+    }
     QMessageBox::information(this, "完成", "拟合完成。");
 }
 
 void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
     if (!m_plot) return;
 
-    QVector<double> vt, vp, vd;
-    for(int i=0; i<t.size(); ++i) {
-        if(t[i]>1e-8 && p[i]>1e-8) {
-            vt<<t[i];
-            vp<<p[i];
-            if(i<d.size() && d[i]>1e-8) vd<<d[i]; else vd<<1e-10;
-        }
-    }
     if(isModel) {
-        m_plot->graph(2)->setData(vt, vp);
-        m_plot->graph(3)->setData(vt, vd);
+        // 曲线点全部可绘制时直接共享求解结果，不再逐点复制
+        SeriesData shown = SeriesData(t, p, d).logPlottable();
+        SharedGraphData::assign(m_plot->graph(2), shown.time(), shown.pressure());
+        SharedGraphData::assign(m_plot->graph(3), shown.time(), shown.derivative());
 
-        if (m_obsTime.isEmpty() && !vt.isEmpty()) {
+        if (m_observed.isEmpty() && !shown.isEmpty()) {
             m_plot->rescaleAxes();
             if(m_plot->xAxis->range().lower<=0) m_plot->xAxis->setRangeLower(1e-3);
             if(m_plot->yAxis->range().lower<=0) m_plot->yAxis->setRangeLower(1e-3);
@@ -753,9 +1626,6 @@ void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>&
 
 void FittingWidget::on_btnExportReport_clicked()
 {
-    m_paramChart->updateParamsFromTable();
-    QList<FitParameter> params = m_paramChart->getParameters();
-
     QString defaultDir = ModelParameter::instance()->getProjectPath();
     if(defaultDir.isEmpty()) defaultDir = ".";
     QString fileName = QFileDialog::getSaveFileName(this, "导出试井分析报告",
@@ -763,91 +1633,50 @@ void FittingWidget::on_btnExportReport_clicked()
                                                     "Word 文档 (*.doc);;HTML 文件 (*.html)");
     if(fileName.isEmpty()) return;
 
-    ModelParameter* mp = ModelParameter::instance();
-
-    QString html = "<html><head><style>";
-    html += "body { font-family: 'Times New Roman', 'SimSun', serif; }";
-    html += "h1 { text-align: center; font-size: 24px; font-weight: bold; margin-bottom: 20px; }";
-    html += "h2 { font-size: 18px; font-weight: bold; background-color: #f2f2f2; padding: 5px; border-left: 5px solid #2d89ef; margin-top: 20px; }";
-    html += "table { width: 100%; border-collapse: collapse; margin-bottom: 15px; font-size: 14px; }";
-    html += "td, th { border: 1px solid #888; padding: 6px; text-align: center; }";
-    html += "th { background-color: #e0e0e0; font-weight: bold; }";
-    html += ".param-table td { text-align: left; padding-left: 10px; }";
-    html += "</style></head><body>";
-
-    html += "<h1>试井解释分析报告</h1>";
-    html += "<p style='text-align:right;'>生成日期: " + QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm") + "</p>";
-
-    html += "<h2>1. 基础信息</h2>";
-    html += "<table class='param-table'>";
-    html += "<tr><td width='30%'>项目路径</td><td>" + mp->getProjectPath() + "</td></tr>";
-    html += "<tr><td>测试产量 (q)</td><td>" + QString::number(mp->getQ()) + " m³/d</td></tr>";
-    html += "<tr><td>有效厚度 (h)</td><td>" + QString::number(mp->getH()) + " m</td></tr>";
-    html += "<tr><td>孔隙度 (φ)</td><td>" + QString::number(mp->getPhi()) + "</td></tr>";
-    html += "<tr><td>井筒半径 (rw)</td><td>" + QString::number(mp->getRw()) + " m</td></tr>";
-    html += "</table>";
-
-    html += "<h2>2. 流体高压物性 (PVT)</h2>";
-    html += "<table class='param-table'>";
-    html += "<tr><td width='30%'>原油粘度 (μ)</td><td>" + QString::number(mp->getMu()) + " mPa·s</td></tr>";
-    html += "<tr><td>体积系数 (B)</td><td>" + QString::number(mp->getB()) + "</td></tr>";
-    html += "<tr><td>综合压缩系数 (Ct)</td><td>" + QString::number(mp->getCt()) + " MPa⁻¹</td></tr>";
-    html += "</table>";
-
-    html += "<h2>3. 解释模型选择</h2>";
-    html += "<p><strong>当前模型:</strong> " + ModelManager::getModelTypeName(m_currentModelType) + "</p>";
-
-    html += "<h2>4. 拟合结果参数</h2>";
-    html += "<table>";
-    html += "<tr><th>参数名称</th><th>符号</th><th>拟合结果</th><th>单位</th></tr>";
-    for(const auto& p : params) {
+    // 界面线程只准备内容与离屏绘图，PNG 编码与写文件在后台进行
+    QFuture<QString> future = FittingReport::start(fileName, FittingReport::currentProjectInfo(),
+                                                   {reportSection(FittingReport::IMAGE_SCALE)});
+    ui->btnExportReport->setEnabled(false);
+    auto* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, fileName]() {
+        watcher->deleteLater();
+        ui->btnExportReport->setEnabled(true);
+        QString error = watcher->future().resultCount() > 0 ? watcher->result() : QString("报告生成已取消。");
+        if(error.isEmpty()) QMessageBox::information(this, "导出成功", "报告已保存至:\n" + fileName);
+        else QMessageBox::critical(this, "错误", error);
+    });
+    watcher->setFuture(future);
+}
+
+FittingReport::Section FittingWidget::reportSection(double imageScale)
+{
+    applyPendingState();
+    m_paramChart->updateParamsFromTable();
+
+    FittingReport::Section section;
+    section.modelName = ModelManager::getModelTypeName(m_currentModelType);
+    if(m_paramChart->hasUncertainty()) {
+        section.uncertaintyNote = m_uncertaintyResult.method == ParameterUncertainty::ResidualBootstrap
+            ? QString("残差自助法 (%1 个样本)").arg(m_uncertaintyResult.samples) : QString("线性化协方差");
+    }
+    for(const auto& p : m_paramChart->getParameters()) {
         QString dummy, symbol, uniSym, unit;
         FittingParameterChart::getParamDisplayInfo(p.name, dummy, symbol, uniSym, unit);
         if(unit == "无因次" || unit == "小数") unit = "-";
 
-        html += "<tr>";
-        html += "<td>" + p.displayName + "</td>";
-        html += "<td>" + uniSym + "</td>";
-        if(p.isFit)
-            html += "<td><strong>" + QString::number(p.value, 'g', 6) + "</strong></td>";
-        else
-            html += "<td>" + QString::number(p.value, 'g', 6) + "</td>";
-        html += "<td>" + unit + "</td>";
-        html += "</tr>";
-    }
-    html += "</table>";
-
-    html += "<h2>5. 拟合曲线图</h2>";
-    QString imgBase64 = getPlotImageBase64();
-    if(!imgBase64.isEmpty()) {
-        html += "<div style='text-align:center;'><img src='data:image/png;base64," + imgBase64 + "' width='600' /></div>";
-    } else {
-        html += "<p>图像导出失败。</p>";
-    }
-
-    html += "</body></html>";
-
-    QFile file(fileName);
-    if(file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out.setEncoding(QStringConverter::Utf8);
-        out << html;
-        file.close();
-        QMessageBox::information(this, "导出成功", "报告已保存至:\n" + fileName);
-    } else {
-        QMessageBox::critical(this, "错误", "无法写入文件，请检查权限或文件是否被占用。");
+        FittingReport::ParamRow row;
+        row.displayName = p.displayName;
+        row.symbol = uniSym;
+        row.value = QString::number(p.value, 'g', 6);
+        row.unit = unit;
+        row.uncertainty = p.isFit ? m_paramChart->uncertaintyText(p.name) : QString("-");
+        row.isFit = p.isFit;
+        section.params.append(row);
     }
-}
 
-QString FittingWidget::getPlotImageBase64()
-{
-    if(!m_plot) return "";
-    QPixmap pixmap = m_plot->toPixmap(800, 600);
-    QByteArray byteArray;
-    QBuffer buffer(&byteArray);
-    buffer.open(QIODevice::WriteOnly);
-    pixmap.save(&buffer, "PNG");
-    return QString::fromLatin1(byteArray.toBase64().data());
+    // toPixmap 在缓冲区中按倍率重绘，不改变屏幕上的图
+    if(m_plot) section.chart = m_plot->toPixmap(800, 600, imageScale).toImage();
+    return section;
 }
 
 void FittingWidget::on_btnSaveFit_clicked()
@@ -857,6 +1686,9 @@ void FittingWidget::on_btnSaveFit_clicked()
 
 QJsonObject FittingWidget::getJsonState() const
 {
+    // 未显示过的页面直接返回原状态，避免为保存而构建曲线
+    if (!m_pendingState.isEmpty()) return m_pendingState;
+
     const_cast<FittingWidget*>(this)->m_paramChart->updateParamsFromTable();
     QList<FitParameter> params = m_paramChart->getParameters();
 
@@ -886,18 +1718,50 @@ QJsonObject FittingWidget::getJsonState() const
     root["parameters"] = paramsArray;
 
     QJsonArray timeArr, pressArr, derivArr;
-    for(double v : m_obsTime) timeArr.append(v);
-    for(double v : m_obsDeltaP) pressArr.append(v);
-    for(double v : m_obsDerivative) derivArr.append(v);
+    for(double v : m_observed.time()) timeArr.append(v);
+    for(double v : m_observed.pressure()) pressArr.append(v);
+    for(double v : m_observed.derivative()) derivArr.append(v);
     QJsonObject obsData;
     obsData["time"] = timeArr;
     obsData["pressure"] = pressArr;
     obsData["derivative"] = derivArr;
     root["observedData"] = obsData;
 
+    QJsonObject resample;
+    resample["enabled"] = m_resampleOptions.enabled;
+    resample["pointsPerCycle"] = m_resampleOptions.pointsPerCycle;
+    resample["aggregation"] = (int)m_resampleOptions.aggregation;
+    resample["rejectOutliers"] = m_resampleOptions.rejectOutliers;
+    resample["outlierThreshold"] = m_resampleOptions.outlierThreshold;
+    resample["refineOnFullData"] = m_refineOnFullData;
+    root["resample"] = resample;
+
+    if (m_warmStart.isValid()) root["warmStart"] = m_warmStart.toJson();
+    if (!m_fitWindows.isEmpty()) root["fitWindows"] = m_fitWindows.toJson();
+
     return root;
 }
 
+void FittingWidget::setPendingState(const QJsonObject& data)
+{
+    m_pendingState = data;
+    if (isVisible()) applyPendingState();
+}
+
+void FittingWidget::applyPendingState()
+{
+    if (m_pendingState.isEmpty()) return;
+    QJsonObject state = m_pendingState;
+    m_pendingState = QJsonObject();
+    loadFittingState(state);
+}
+
+void FittingWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    applyPendingState();
+}
+
 void FittingWidget::loadFittingState(const QJsonObject& root)
 {
     if (root.isEmpty()) return;
@@ -907,6 +1771,7 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         m_currentModelType = (ModelManager::ModelType)type;
         ui->btn_modelSelect->setText("当前: " + ModelManager::getModelTypeName(m_currentModelType));
     }
+    m_warmStart = FittingCore::WarmStart::fromJson(root["warmStart"].toObject());
 
     m_paramChart->resetParams(m_currentModelType);
 
@@ -944,6 +1809,21 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         ui->sliderWeight->setValue((int)(w * 100));
     }
 
+    if (root.contains("resample")) {
+        QJsonObject rs = root["resample"].toObject();
+        LogTimeResampler::Options opt;
+        opt.enabled = rs["enabled"].toBool(false);
+        opt.pointsPerCycle = rs["pointsPerCycle"].toInt(opt.pointsPerCycle);
+        opt.aggregation = LogTimeResampler::Aggregation(rs["aggregation"].toInt(LogTimeResampler::Median));
+        opt.rejectOutliers = rs["rejectOutliers"].toBool(opt.rejectOutliers);
+        opt.outlierThreshold = rs["outlierThreshold"].toDouble(opt.outlierThreshold);
+        m_resampleOptions = opt;
+        m_refineOnFullData = rs["refineOnFullData"].toBool(false);
+    }
+
+    // 窗口规则按时间记录，须在观测数据之前恢复
+    m_fitWindows = FitWindows::fromJson(root["fitWindows"].toObject());
+
     if (root.contains("observedData")) {
         QJsonObject obs = root["observedData"].toObject();
         QJsonArray tArr = obs["time"].toArray();
@@ -3,9 +3,18 @@
  * 文件作用: 试井拟合分析主界面类的头文件
  * 功能描述:
  * 1. 定义拟合分析界面的主要控件成员变量和布局逻辑。
- * 2. 声明用于Levenberg-Marquardt非线性回归拟合的核心算法函数。
+ * 2. 声明拟合任务入口，Levenberg-Marquardt 算法本身由 FittingCore 提供。
  * 3. 声明观测数据（时间、压差、导数）的管理函数。
  * 4. 集成 ChartWidget 以统一图表显示和交互体验。
+ * 5. 声明多起点全局拟合、代理模型全局搜索入口及结果选择对话框。
+ * 6. 声明模型自动筛选 (6 种模型并行拟合并按信息准则排序) 入口及结果对话框。
+ * 7. 声明交互式参数调节：拖动滑块或编辑数值时后台异步刷新理论曲线 (先粗算后精算，过期请求取消并丢弃)。
+ * 8. 声明拟合参数不确定性分析入口，P90 / P50 / P10 显示在参数表并写入报告。
+ * 9. 从项目表格加载并自动计算导数的观测数据跟随表格修改，在后台更新 (只改了压力单元格时就地更新)。
+ * 10. 观测数据可来自实时压力计 (增长的数据文件或 TCP 数据流)，按最小间隔刷新，可每增加若干点后台滚动拟合。
+ * 11. 保存上一次拟合的续算状态 (雅可比、阻尼、精度级)，随页面状态写入项目，再次拟合时从该状态继续。
+ * 12. 拟合时间窗口与屏蔽点 (FitWindows) 在图上框选，所有拟合方式都只用窗口内、未屏蔽的点。
+ * 13. 性能统计面板 (ProfilerPanel) 显示拟合各次迭代的耗时与求值计数。
  */
 
 #ifndef WT_FITTINGWIDGET_H
@@ -15,13 +24,36 @@
 #include <QMap>
 #include <QVector>
 #include <QFutureWatcher>
+#include <QThreadPool>
 #include <QJsonObject>
-#include <QStandardItemModel>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <atomic>
+
+class QThread;
+class ProfilerPanel;
 #include "modelmanager.h" // 包含 ModelManager 的 ModelType 定义
 #include "mousezoom.h"
 #include "chartwidget.h"  // [新增] 引入图表组件头文件
 #include "fittingparameterchart.h"
+#include "fittingcore.h"
+#include "fitperformancelog.h"
+#include "multistartfitter.h"
+#include "surrogateoptimizer.h"
+#include "modelscreener.h"
+#include "parameteruncertainty.h"
 #include "paramselectdialog.h"
+#include "measurementtablemodel.h"
+#include "datachangetracker.h"
+#include "derivativeseries.h"
+#include "logtimeresampler.h"
+#include "signalfilter.h"
+#include "seriesdata.h"
+#include "solverjob.h"
+#include "fittingreport.h"
+#include "gaugestreamreader.h"
 
 namespace Ui { class FittingWidget; }
 
@@ -36,31 +68,52 @@ public:
     // 设置模型管理器
     void setModelManager(ModelManager* m);
     // 设置项目数据模型
-    void setProjectDataModel(QStandardItemModel* model);
+    void setProjectDataModel(MeasurementTableModel* model);
+
+    // 设置拟合前的对数时间重采样；已有观测数据时立即重新抽稀
+    void setResampleOptions(const LogTimeResampler::Options& options, bool refineOnFullData);
 
-    // 设置观测数据
+    // 设置观测数据 (完整数据用于显示和保存，拟合迭代使用重采样后的数据)；观测数据不再跟随项目表格
     void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& deriv);
+    // 项目表格修改 (已合并) 后更新跟随表格的观测数据；拟合进行中时推迟到拟合结束
+    void applyDataChanges(const DataChangeSet& changes);
     // 更新基础参数
     void updateBasicParameters();
 
     // 状态保存与加载
     void loadFittingState(const QJsonObject& data = QJsonObject());
     QJsonObject getJsonState() const;
+    // 暂存项目中的拟合状态，页面首次显示 (或设置观测数据) 时才恢复到界面
+    void setPendingState(const QJsonObject& data);
+
+    // 是否正在进行界面发起的拟合
+    bool isFitting() const { return m_isFitting; }
+
+    // 报告中本页的一节：模型、参数表与离屏绘制的曲线图 (imageScale 为像素倍率)；暂存的状态先恢复
+    FittingReport::Section reportSection(double imageScale);
+
+protected:
+    void showEvent(QShowEvent *event) override;
 
 signals:
     // 拟合完成信号
     void fittingCompleted(ModelManager::ModelType modelType, const QMap<QString, double>& parameters);
-    // 迭代更新信号
-    void sigIterationUpdated(double error, QMap<QString, double> currentParams, QVector<double> t, QVector<double> p, QVector<double> d);
     // 进度信号
     void sigProgress(int progress);
     // 请求保存信号
     void sigRequestSave();
+    // 一次拟合完成 (未手动停止) 后的性能记录，在界面线程发出；分析页名称由接收方填写
+    void performanceRecorded(const FitPerformanceLog::Record& record);
 
 private slots:
     // 数据加载与模型选择
     void on_btnLoadData_clicked();
+    void on_btnLiveGauge_clicked();
+    void on_btnFitWindows_clicked();
+    void on_btnProfiler_clicked();
     void on_btn_modelSelect_clicked();
+    void on_btnAutoScreen_clicked();
+    void on_btnUncertainty_clicked();
 
     // 参数管理
     void on_btnSelectParams_clicked();
@@ -84,10 +137,15 @@ private slots:
     void onFitFinished();
     void onSliderWeightChanged(int value);
 
+    // 交互式参数调节
+    void onParamSliderChanged(int position);
+    void onParamCellChanged(int row, int column);
+    void onParamRowSelected(int row);
+
 private:
     Ui::FittingWidget *ui;
     ModelManager* m_modelManager;
-    QStandardItemModel* m_projectModel;
+    MeasurementTableModel* m_projectModel;
 
     // [修改] 使用 ChartWidget 管理图表
     ChartWidget* m_chartWidget;
@@ -100,33 +158,146 @@ private:
     // 参数表格管理类
     FittingParameterChart* m_paramChart;
 
-    // 观测数据缓存
-    QVector<double> m_obsTime;
-    QVector<double> m_obsDeltaP;
-    QVector<double> m_obsDerivative;
+    // 观测数据缓存 (导数列补齐到与时间等长)
+    SeriesData m_observed;
+
+    // 跟随项目表格的观测数据：后台更新的序列与平滑窗口 (0 为不平滑)，更新进行中到达的修改合并到下一轮
+    bool m_liveLinked = false;
+    DerivativeSeries m_liveSeries;
+    SignalFilter::Options m_liveSmoothing;
+    QFutureWatcher<DerivativeSeries> m_liveWatcher;
+    DataChangeSet m_livePending;
+    bool m_liveShowPending = false;      // 拟合进行中完成的更新，拟合结束后显示
+    void startLiveUpdate(const DataChangeSet& changes);
+    void onLiveUpdateFinished();
+    // 显示更新后的序列，并继续处理合并的修改
+    void flushLiveUpdate();
+
+    // 实时压力计数据：读取对象在独立线程中运行，快照在拟合进行中到达时推迟到拟合结束后显示
+    GaugeStreamReader::Settings m_gaugeSettings;
+    QThread* m_gaugeThread = nullptr;
+    bool m_gaugeLinked = false;
+    SeriesData m_gaugePending;
+    bool m_gaugeShowPending = false;
+    qint64 m_gaugePoints = 0;           // 最近一次快照的累计点数
+    // 滚动拟合：每增加 m_gaugeFitEvery 点 (0 为不拟合) 以参数表当前值为初值重新拟合
+    int m_gaugeFitEvery = 0;
+    qint64 m_gaugeFitPoints = 0;        // 上一次滚动拟合开始时的累计点数
+    bool m_rollingFit = false;          // 当前拟合为滚动拟合 (结束时不提示)
+    void startGaugeStream();
+    void stopGaugeStream();
+    void onGaugeSnapshot(const SeriesData& data, qint64 acceptedCount);
+    // 显示最新快照，满足点数间隔时开始滚动拟合
+    void flushGaugeSnapshot();
+    void startRollingFit();
+    void runRollingFit(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, const FittingCore::WarmStart& warm);
+
+    // 上一次 LM/Dogleg 拟合结束时的续算状态 (对应 m_currentModelType，切换模型时清空)
+    FittingCore::WarmStart m_warmStart;
+    // 拟合线程结束时调用：模型未切换才保存 (排队到界面线程执行)
+    void storeWarmStart(ModelManager::ModelType modelType, const FittingCore::WarmStart& warm);
+    // 拟合线程结束时调用：补全来源与重采样密度后排队到界面线程发出 performanceRecorded
+    void recordPerformance(FitPerformanceLog::Record record, const QString& source);
+
+    // 拟合时间窗口与屏蔽点：框选完成后按用途处理；拟合进行中不可修改 (拟合线程直接读取)
+    enum RegionPurpose { RegionNone, RegionWindow, RegionMask, RegionUnmask };
+    FitWindows m_fitWindows;
+    RegionPurpose m_regionPurpose = RegionNone;
+    QList<QCPItemRect*> m_windowItems;
+    QCPGraph* m_maskGraph = nullptr;
+    void onRegionSelected(double xLower, double xUpper, double yLower, double yUpper);
+    // 窗口或屏蔽点变化后：重建拟合数据 (屏蔽点不参与重采样) 并刷新图上的标记
+    void fitWindowsChanged();
+    void updateFitWindowDisplay();
+
+    // 性能统计面板 (首次打开时创建，关闭后保留)
+    ProfilerPanel* m_profilerPanel = nullptr;
+
+    // 重采样后的拟合数据 (未启用重采样时与观测数据相同)
+    LogTimeResampler::Options m_resampleOptions;
+    bool m_refineOnFullData;
+    SeriesData m_fitData;
+    void updateFitData();
 
     // 拟合状态控制
     bool m_isFitting;
     bool m_stopRequested;
     QFutureWatcher<void> m_watcher;
 
+    // 尚未恢复到界面的拟合状态 (为空表示已恢复或无需恢复)
+    QJsonObject m_pendingState;
+    void applyPendingState();
+
     // 初始化图表设置
     void setupPlot();
     // 初始化默认模型
     void initializeDefaultModel();
     // 更新模型曲线
     void updateModelCurve();
+    // 参数表当前值 (含由 Lf、L 换算的 LfD) 与理论曲线的时间点 (无观测数据时为空，曲线按自适应网格计算)
+    QMap<QString, double> currentModelParams();
+    QVector<double> modelCurveTime() const;
+
+    // 交互预览：后台先用低阶 Stehfest 在稀疏时间点上粗算，再经型曲线库精算；新请求取消尚未完成的旧请求
+    void requestPreviewCurve();
+    void cancelPreview();
+    void showPreviewCurve(int generation, const ModelCurveData& curve);
+    // 滑块绑定的参数 (按参数名，表格刷新后仍有效) 及其位置与数值的换算
+    void bindParamSlider(const QString& name);
+    double sliderToValue(const FitParameter& p, int position) const;
+    int valueToSlider(const FitParameter& p, double value) const;
+    QString m_sliderParam;
+    QThreadPool m_previewPool;                          // 单线程：排队中的过期请求可直接清除
+    QSharedPointer<SolverControl> m_previewControl;     // 当前预览任务的取消控制
+    int m_previewGeneration;                            // 预览请求序号，结果回到界面线程时序号不符即丢弃
+    std::atomic<qint64> m_lastRefineMs;                 // 上一次精算耗时，在交互时限内时省略粗算
+
+    // 拟合任务入口 (后台线程执行，算法实现见 FittingCore)
+    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight, const FittingCore::WarmStart& warm);
+    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, const FittingCore::WarmStart& warm);
+    // 多起点全局拟合：各起点并发运行，结果存入 m_multiStartSolutions
+    void runMultiStartOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, int seedCount);
+    // 代理模型全局搜索：真实求解次数不超过 evalCount，最后局部精修
+    void runSurrogateOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight, int evalCount);
+    // 以 params 为初值在全部观测数据上高精度精修 (未启用或无需精修时返回 false)
+    bool refineOnFullData(ModelManager::ModelType modelType, QList<FitParameter> params, const QMap<QString, double>& start,
+                          double weight, FittingCore::Result& result);
+
+    // 最近一次多起点拟合的最优解 (拟合完成后在界面显示)
+    QList<MultiStartFitter::Solution> m_multiStartSolutions;
+    void showMultiStartResults();
+
+    // 模型自动筛选：候选参数表在界面线程中由当前参数表生成，结果拟合完成后在界面显示
+    QList<FitParameter> screeningParameters(ModelManager::ModelType type, const QList<FitParameter>& current) const;
+    void runModelScreening(QList<ModelScreener::Candidate> candidates, double weight);
+    QList<ModelScreener::Candidate> m_screenCandidates;
+    QList<ModelScreener::Ranking> m_screenRankings;
+    void showScreeningResults();
+
+    // 参数不确定性分析：在拟合使用的数据上进行，结果拟合线程结束后显示到参数表 (报告沿用最近一次结果)
+    void runUncertaintyAnalysis(ModelManager::ModelType modelType, QList<FitParameter> params, ParameterUncertainty::Options options);
+    ParameterUncertainty::Result m_uncertaintyResult;
+    bool m_uncertaintyPending = false;
+    void showUncertaintyResults();
 
-    // 核心拟合算法函数 (Levenberg-Marquardt)
-    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
-    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
-    double calculateSumSquaredError(const QVector<double>& residuals);
+    // 拟合迭代显示：拟合线程只覆盖最新一次结果，界面线程按帧间隔取出，中间状态合并
+    struct PendingIteration {
+        double mse = 0.0;
+        QMap<QString, double> params;
+        ModelCurveData curve;
+    };
+    QMutex m_iterationMutex;
+    PendingIteration m_pendingIteration; // 以下两项受 m_iterationMutex 保护
+    bool m_iterationQueued = false;      // 已安排界面线程取出
+    QElapsedTimer m_iterationClock;      // 上次刷新显示的时刻
+    QTimer* m_iterationTimer;
+    // 任意线程调用
+    void queueIterationUpdate(double mse, const QMap<QString, double>& params, const ModelCurveData& curve);
+    // 未到帧间隔时推迟到间隔结束；force 时立即显示
+    void flushIterationUpdate(bool force = false);
+    int iterationFrameInterval() const;
 
     // 辅助绘图函数
-    QString getPlotImageBase64();
     void plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel);
 };
 
@@ -6,19 +6,25 @@
  * 2. 响应用户操作，收集界面参数，调用 ModelSolver01_06 进行计算。
  * 3. 将计算结果绘制在 QCustomPlot 图表上。
  * 4. 实现了 UI 逻辑与数学逻辑的分离。
+ * 5. 计算通过 SolverJob 在后台线程进行，不阻塞界面；进度显示在计算按钮上，再次点击即停止。
+ * 6. 结果数据页用表格模型显示 (只格式化可见行，选中行可复制)，CSV 导出经 CsvExportDialog 在后台写入。
  */
 
 #include "wt_modelwidget.h"
 #include "ui_wt_modelwidget.h"
 #include "modelmanager.h" // 仅用于获取项目路径等辅助功能
 #include "modelparameter.h"
+#include "csvexportdialog.h"
 
 #include <QDebug>
 #include <QMessageBox>
 #include <QFileDialog>
-#include <QTextStream>
+#include <QHeaderView>
+#include <QAction>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <algorithm>
 #include <QDateTime>
-#include <QCoreApplication>
 #include <QSplitter>
 
 WT_ModelWidget::WT_ModelWidget(ModelType type, QWidget *parent)
@@ -26,6 +32,7 @@ WT_ModelWidget::WT_ModelWidget(ModelType type, QWidget *parent)
     , ui(new Ui::WT_ModelWidget)
     , m_type(type)
     , m_highPrecision(true)
+    , m_resultModel(nullptr)
 {
     ui->setupUi(this);
 
@@ -51,6 +58,9 @@ WT_ModelWidget::WT_ModelWidget(ModelType type, QWidget *parent)
 
 WT_ModelWidget::~WT_ModelWidget()
 {
+    // 后台计算使用求解器，先停止并等待结束
+    m_calcWatcher.cancel();
+    m_calcWatcher.waitForFinished();
     delete m_solver; // 清理求解器资源
     delete ui;
 }
@@ -63,7 +73,11 @@ QString WT_ModelWidget::getModelName() const {
 WT_ModelWidget::ModelCurveData WT_ModelWidget::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
     if (m_solver) {
-        return m_solver->calculateTheoreticalCurve(params, providedTime);
+        // 敏感性扫描中 φ、μ、Ct 等换算类参数的各条曲线共用同一条无因次型曲线
+        ModelSolver01_06::CalcOptions options;
+        options.highPrecision = m_highPrecision;
+        options.typeCurveLookup = true;
+        return m_solver->calculateTheoreticalCurve(params, providedTime, options);
     }
     return ModelCurveData();
 }
@@ -89,6 +103,20 @@ void WT_ModelWidget::initUi() {
     ui->cDEdit->setVisible(hasStorage);
     ui->label_s->setVisible(hasStorage);
     ui->sEdit->setVisible(hasStorage);
+
+    m_resultModel = new CurveTableModel(this);
+    ui->resultTableView->setModel(m_resultModel);
+    ui->resultTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->resultTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->resultTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->resultTableView->setWordWrap(false);
+
+    QAction* copyAction = new QAction("复制", ui->resultTableView);
+    copyAction->setShortcut(QKeySequence::Copy);
+    copyAction->setShortcutContext(Qt::WidgetShortcut);
+    ui->resultTableView->addAction(copyAction);
+    ui->resultTableView->setContextMenuPolicy(Qt::ActionsContextMenu);
+    connect(copyAction, &QAction::triggered, this, &WT_ModelWidget::onCopyResultRows);
 }
 
 void WT_ModelWidget::initChart() {
@@ -135,6 +163,11 @@ void WT_ModelWidget::initChart() {
 
 void WT_ModelWidget::setupConnections() {
     connect(ui->calculateButton, &QPushButton::clicked, this, &WT_ModelWidget::onCalculateClicked);
+    connect(&m_calcWatcher, &QFutureWatcher<ModelCurveData>::resultReadyAt, this, &WT_ModelWidget::onCalculationResultReady);
+    connect(&m_calcWatcher, &QFutureWatcher<ModelCurveData>::finished, this, &WT_ModelWidget::onCalculationFinished);
+    connect(&m_calcWatcher, &QFutureWatcher<ModelCurveData>::progressValueChanged, this, [this](int value) {
+        ui->calculateButton->setText(QString("计算中 %1% (点击停止)").arg(value * 100 / SolverJob::PROGRESS_RANGE));
+    });
     connect(ui->resetButton, &QPushButton::clicked, this, &WT_ModelWidget::onResetParameters);
     connect(ui->chartWidget, &ChartWidget::exportDataTriggered, this, &WT_ModelWidget::onExportData);
     connect(ui->btnExportDataTab, &QPushButton::clicked, this, &WT_ModelWidget::onExportData);
@@ -222,18 +255,15 @@ void WT_ModelWidget::onShowPointsToggled(bool checked) {
 }
 
 void WT_ModelWidget::onCalculateClicked() {
-    ui->calculateButton->setEnabled(false);
-    ui->calculateButton->setText("计算中...");
-    QCoreApplication::processEvents();
+    // 计算进行中再次点击即停止 (求解器在下一个求值点返回)
+    if (m_calcWatcher.isRunning()) {
+        m_calcWatcher.cancel();
+        return;
+    }
     runCalculation();
-    ui->calculateButton->setEnabled(true);
-    ui->calculateButton->setText("开始计算");
 }
 
 void WT_ModelWidget::runCalculation() {
-    MouseZoom* plot = ui->chartWidget->getPlot();
-    plot->clearGraphs();
-
     // 收集界面输入参数
     QMap<QString, QVector<double>> rawParams;
     rawParams["phi"] = parseInput(ui->phiEdit->text());
@@ -266,18 +296,23 @@ void WT_ModelWidget::runCalculation() {
         rawParams["S"] = {0.0};
     }
 
-    // 检查敏感性参数 (多值)
-    QString sensitivityKey = "";
-    QVector<double> sensitivityValues;
+    // 检查敏感性参数 (多值)，每个多值参数为一个扫描轴
+    QList<SensitivitySweep::Axis> axes;
+    QStringList sweepKeys;
     for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
         if(it.key() == "t") continue;
         if(it.value().size() > 1) {
-            sensitivityKey = it.key();
-            sensitivityValues = it.value();
-            break;
+            axes.append({it.key(), it.value()});
+            sweepKeys << it.key();
         }
     }
-    bool isSensitivity = !sensitivityKey.isEmpty();
+    SensitivitySweep::Design design = ui->comboSweepDesign->currentIndex() == 1 ? SensitivitySweep::FullFactorial
+                                                                                 : SensitivitySweep::OneAtATime;
+    int caseCount = SensitivitySweep::caseCount(axes, design);
+    if (caseCount > SensitivitySweep::MAX_CASES) {
+        QMessageBox::warning(this, "敏感性分析", QString("参数组合超过 %1 条曲线，请减少多值参数的取值个数。").arg(SensitivitySweep::MAX_CASES));
+        return;
+    }
 
     // 构建基础参数字典
     QMap<QString, double> baseParams;
@@ -298,56 +333,100 @@ void WT_ModelWidget::runCalculation() {
     // 调用 Solver 的静态方法生成时间
     QVector<double> t = ModelSolver01_06::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
 
-    int iterations = isSensitivity ? sensitivityValues.size() : 1;
-    iterations = qMin(iterations, (int)m_colorList.size());
-
-    QString resultTextHeader = QString("计算完成 (%1)\n").arg(getModelName());
-    if(isSensitivity) resultTextHeader += QString("敏感性参数: %1\n").arg(sensitivityKey);
-
-    // 循环计算曲线
-    for(int i = 0; i < iterations; ++i) {
-        QMap<QString, double> currentParams = baseParams;
-        double val = 0;
-        if (isSensitivity) {
-            val = sensitivityValues[i];
-            currentParams[sensitivityKey] = val;
-            if (sensitivityKey == "L" || sensitivityKey == "Lf") {
-                if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
-            }
-        }
+    // 各条曲线的参数在界面线程中准备好，计算在后台任务中并发进行
+    m_calcCases = SensitivitySweep::expand(baseParams, axes, design);
+    m_calcSweepKeys = sweepKeys;
+    m_calcBaseParams = baseParams;
+    QList<QMap<QString, double>> paramSets;
+    for (const SensitivitySweep::Case& c : m_calcCases) paramSets.append(c.params);
 
-        // 调用 Solver 计算
-        ModelCurveData res = calculateTheoreticalCurve(currentParams, t);
+    // 曲线随算随画，先清空旧曲线
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->clearGraphs();
+    plot->replot();
 
-        // 缓存最后一次结果用于显示
-        res_tD = std::get<0>(res);
-        res_pD = std::get<1>(res);
-        res_dpD = std::get<2>(res);
+    // 敏感性扫描中 φ、μ、Ct 等换算类参数的各条曲线共用同一条无因次型曲线
+    ModelSolver01_06::CalcOptions options;
+    options.highPrecision = m_highPrecision;
+    options.typeCurveLookup = true;
+    ui->calculateButton->setText("计算中... (点击停止)");
+    m_calcWatcher.setFuture(SolverJob::startConcurrent(m_solver, paramSets, t, options));
+}
 
-        QColor curveColor = isSensitivity ? m_colorList[i] : Qt::red;
-        QString legendName;
-        if (isSensitivity) legendName = QString("%1 = %2").arg(sensitivityKey).arg(val);
-        else legendName = "理论曲线";
+void WT_ModelWidget::onCalculationResultReady(int index) {
+    if (index < 0 || index >= m_calcCases.size()) return;
+    bool isSensitivity = !m_calcSweepKeys.isEmpty();
+    ModelCurveData res = m_calcWatcher.resultAt(index);
+    if (isSensitivity) plotCurve(res, m_calcCases[index].label, sweepColor(index, m_calcCases.size()), true);
+    else plotCurve(res, "理论曲线", Qt::red, false);
 
-        plotCurve(res, legendName, curveColor, isSensitivity);
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->rescaleAxes();
+    if(plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
+    if(plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
+    plot->replot();
+}
+
+QColor WT_ModelWidget::sweepColor(int index, int count) const {
+    if (count <= m_colorList.size()) return m_colorList[index];
+    return QColor::fromHsv((index * 360 / count) % 360, 220, 200);
+}
+
+void WT_ModelWidget::onCalculationFinished() {
+    ui->calculateButton->setText("开始计算");
+
+    // 停止时已完成的曲线已画出，结果文本取第一条已完成的曲线 (基准方案优先)
+    QFuture<ModelCurveData> future = m_calcWatcher.future();
+    const int count = m_calcCases.size();
+    int ready = 0, shown = -1;
+    for (int i = 0; i < count; ++i) {
+        if (!future.isResultReadyAt(i)) continue;
+        if (shown < 0) shown = i;
+        ++ready;
+    }
+    if (ready == 0) {
+        ui->resultSummaryLabel->setText("计算已停止。");
+        m_resultModel->clear();
+        return;
     }
+    bool isSensitivity = !m_calcSweepKeys.isEmpty();
 
-    // 更新结果文本
-    QString resultText = resultTextHeader;
-    resultText += "t(h)\t\tDp(MPa)\t\tdDp(MPa)\n";
-    for(int i=0; i<res_pD.size(); ++i) {
-        resultText += QString("%1\t%2\t%3\n").arg(res_tD[i],0,'e',4).arg(res_pD[i],0,'e',4).arg(res_dpD[i],0,'e',4);
+    QString resultTextHeader = QString("计算完成 (%1)").arg(getModelName());
+    if (ready < count) resultTextHeader = QString("计算已停止 (%1)，完成 %2/%3 条曲线").arg(getModelName()).arg(ready).arg(count);
+    if(isSensitivity) {
+        resultTextHeader += QString("\n敏感性参数: %1 (%2 条曲线)").arg(m_calcSweepKeys.join(", ")).arg(count);
+        resultTextHeader += QString("\n下表曲线: %1").arg(m_calcCases[shown].label);
     }
-    ui->resultTextEdit->setText(resultText);
 
-    // 调整图表视图
-    ui->chartWidget->getPlot()->rescaleAxes();
-    if(plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
-    if(plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
-    plot->replot();
+    ModelCurveData res = future.resultAt(shown);
+    res_tD = std::get<0>(res);
+    res_pD = std::get<1>(res);
+    res_dpD = std::get<2>(res);
+
+    // 更新结果表格 (数组隐式共享，只在显示时格式化可见行)
+    ui->resultSummaryLabel->setText(resultTextHeader);
+    m_resultModel->setColumns({"t(h)", "Dp(MPa)", "dDp(MPa)"}, {res_tD, res_pD, res_dpD});
 
     onShowPointsToggled(ui->checkShowPoints->isChecked());
-    emit calculationCompleted(getModelName(), baseParams);
+    if (ready == count) emit calculationCompleted(getModelName(), m_calcBaseParams);
+}
+
+void WT_ModelWidget::onCopyResultRows() {
+    QItemSelectionModel* selection = ui->resultTableView->selectionModel();
+    if (!selection || !selection->hasSelection()) return;
+
+    // 按选区 (连续行段) 取文本，全选大表时不逐个生成下标
+    QList<QItemSelectionRange> ranges = selection->selection();
+    std::sort(ranges.begin(), ranges.end(), [](const QItemSelectionRange& a, const QItemSelectionRange& b) { return a.top() < b.top(); });
+    QString text = m_resultModel->headerText();
+    int next = 0;
+    for (const QItemSelectionRange& range : ranges) {
+        int first = qMax(range.top(), next);
+        if (first > range.bottom()) continue;
+        text += m_resultModel->rowsText(first, range.bottom());
+        next = range.bottom() + 1;
+    }
+    QGuiApplication::clipboard()->setText(text);
 }
 
 void WT_ModelWidget::plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity) {
@@ -382,15 +461,13 @@ void WT_ModelWidget::onExportData() {
     if(defaultDir.isEmpty()) defaultDir = ".";
     QString path = QFileDialog::getSaveFileName(this, "导出CSV数据", defaultDir + "/CalculatedData.csv", "CSV Files (*.csv)");
     if (path.isEmpty()) return;
-    QFile f(path);
-    if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&f);
-        out << "t,Dp,dDp\n";
-        for (int i = 0; i < res_tD.size(); ++i) {
-            double dp = (i < res_dpD.size()) ? res_dpD[i] : 0.0;
-            out << res_tD[i] << "," << res_pD[i] << "," << dp << "\n";
-        }
-        f.close();
-        QMessageBox::information(this, "导出成功", "数据文件已保存");
-    }
+
+    // 导数缺失的行按 0 输出；数值位数与 QTextStream 默认一致 (6 位有效数字)
+    QVector<double> dp = res_dpD;
+    if (dp.size() < res_tD.size()) dp.resize(res_tD.size(), 0.0);
+    QVector<CsvExporter::Column> columns = { {"t", res_tD}, {"Dp", res_pD}, {"dDp", dp} };
+    CsvExportDialog::start(this, path, columns, ',', 6, [this](const QString& error) {
+        if (error.isEmpty()) QMessageBox::information(this, "导出成功", "数据文件已保存");
+        else QMessageBox::warning(this, "导出失败", error);
+    });
 }
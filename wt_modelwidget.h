@@ -5,6 +5,8 @@
  * 1. 管理用户界面，处理参数输入、按钮响应和图表展示。
  * 2. 包含 ModelSolver01_06 实例，调用其进行数学计算。
  * 3. 继承自 QWidget，不再包含复杂的数学算法实现。
+ * 4. 计算在后台任务 (SolverJob) 中进行，按钮显示进度，计算中再次点击即停止。
+ * 5. 多个参数输入多个值时按单因素或全因子方案 (SensitivitySweep) 展开，各条曲线并发计算，算完一条画一条。
  */
 
 #ifndef WT_MODELWIDGET_H
@@ -14,9 +16,13 @@
 #include <QMap>
 #include <QVector>
 #include <QColor>
+#include <QFutureWatcher>
 #include <tuple>
 #include "chartwidget.h"
+#include "curvetablemodel.h"
 #include "modelsolver01-06.h"
+#include "solverjob.h"
+#include "sensitivitysweep.h"
 
 namespace Ui {
 class WT_ModelWidget;
@@ -55,16 +61,26 @@ public slots:
     void onShowPointsToggled(bool checked);
     void onExportData();
 
+private slots:
+    // 后台计算完成一条曲线：立即绘制
+    void onCalculationResultReady(int index);
+    // 后台计算结束 (完成或停止)：输出结果表格
+    void onCalculationFinished();
+    // 复制结果表格中选中的行 (含表头)
+    void onCopyResultRows();
+
 private:
     void initUi();
     void initChart();
     void setupConnections();
-    void runCalculation(); // UI 触发的计算流程封装
+    void runCalculation(); // UI 触发的计算流程封装 (收集参数后启动后台计算)
 
     // 辅助函数
     QVector<double> parseInput(const QString& text);
     void setInputText(QLineEdit* edit, double value);
     void plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity);
+    // 第 index 条敏感性曲线的颜色：曲线不多时用固定色表，否则按色相均分
+    QColor sweepColor(int index, int count) const;
 
 private:
     Ui::WT_ModelWidget *ui;
@@ -74,6 +90,15 @@ private:
     bool m_highPrecision;
     QList<QColor> m_colorList;
 
+    // 后台计算任务及其参数 (绘图与结果文本用)
+    QFutureWatcher<ModelCurveData> m_calcWatcher;
+    QStringList m_calcSweepKeys;     // 多值参数名，为空表示单条曲线
+    QList<SensitivitySweep::Case> m_calcCases;
+    QMap<QString, double> m_calcBaseParams;
+
+    // 结果数据页的表格模型 (按可见行格式化，不生成整表文本)
+    CurveTableModel* m_resultModel;
+
     // 缓存计算结果
     QVector<double> res_tD;
     QVector<double> res_pD;
@@ -9,6 +9,14 @@
  * - 压力产量/导数分析：坐标轴标签恢复为标准默认值 ("Time", "Pressure" 等)。
  * - 新建曲线：坐标轴标签继续使用列名。
  * 4. 新建窗口修复：确保新建窗口中的图表也能正确显示线型和标签。
+ * 5. 大数据量曲线经 GraphDecimator 分级抽稀显示，缩放、平移只绘制与像素数相当的点。
+ * 6. 压力产量、导数分析的曲线数据 (压差、导数、平滑) 在后台线程中生成，进度显示在按钮上，完成后再绘图。
+ * 7. 曲线数组存放在 _chart.wtd (按 "dataId/数组名" 命名)，_chart.json 只保存曲线配置；
+ *    打开项目时只映射数组文件，显示、导出某条曲线时才取出它的数组。旧项目 JSON 中的数组仍可读取。
+ * 8. 曲线数据导出经 CsvExportDialog 在后台写入，表头与数据使用同一分隔符。
+ * 9. 反卷积分析复用压力产量的列选择对话框，在后台由 RateDeconvolution 直接读取列副本的缓冲区，
+ *    生成的 Δp 与导数按导数曲线显示、保存。
+ * 10. 导数平滑按曲线保存的方法 (移动平均、对数时间平均、Savitzky-Golay、小波) 经 SignalFilter 计算，表格修改后同样重算。
  */
 
 #include "wt_plottingwidget.h"
@@ -20,10 +28,12 @@
 #include "chartwindow.h"
 #include "modelparameter.h"
 #include "chartsetting1.h"
+#include "graphdecimator.h"
+#include "csvexportdialog.h"
+#include "ratedeconvolution.h"
 
 #include <QMessageBox>
 #include <QFileDialog>
-#include <QTextStream>
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -31,17 +41,14 @@
 #include <QtMath>
 #include <QDebug>
 #include <QSplitter>
+#include <QtConcurrent>
+#include <QUuid>
+#include <algorithm>
 
 // ============================================================================
 // 辅助函数与 CurveInfo 实现
 // ============================================================================
 
-QJsonArray vectorToJson(const QVector<double>& vec) {
-    QJsonArray arr;
-    for(double v : vec) arr.append(v);
-    return arr;
-}
-
 QVector<double> jsonToVector(const QJsonArray& arr) {
     QVector<double> vec;
     for(const auto& val : arr) vec.append(val.toDouble());
@@ -55,8 +62,7 @@ QJsonObject CurveInfo::toJson() const {
     obj["type"] = type;
     obj["xCol"] = xCol;
     obj["yCol"] = yCol;
-    obj["xData"] = vectorToJson(xData);
-    obj["yData"] = vectorToJson(yData);
+    obj["dataId"] = dataId;
     obj["pointShape"] = (int)pointShape;
     obj["pointColor"] = pointColor.name();
     obj["lineStyle"] = (int)lineStyle;
@@ -65,8 +71,6 @@ QJsonObject CurveInfo::toJson() const {
     if (type == 1) {
         obj["x2Col"] = x2Col;
         obj["y2Col"] = y2Col;
-        obj["x2Data"] = vectorToJson(x2Data);
-        obj["y2Data"] = vectorToJson(y2Data);
         obj["prodLegendName"] = prodLegendName;
         obj["prodGraphType"] = prodGraphType;
         obj["prodColor"] = prodColor.name();
@@ -77,7 +81,8 @@ QJsonObject CurveInfo::toJson() const {
         obj["LSpacing"] = LSpacing;
         obj["isSmooth"] = isSmooth;
         obj["smoothFactor"] = smoothFactor;
-        obj["derivData"] = vectorToJson(derivData);
+        obj["smoothMethod"] = smoothMethod;
+        obj["smoothWindow"] = smoothWindow;
         obj["derivShape"] = (int)derivShape;
         obj["derivPointColor"] = derivPointColor.name();
         obj["derivLineStyle"] = (int)derivLineStyle;
@@ -95,8 +100,13 @@ CurveInfo CurveInfo::fromJson(const QJsonObject& json) {
     info.xCol = json["xCol"].toInt(-1);
     info.yCol = json["yCol"].toInt(-1);
 
-    info.xData = jsonToVector(json["xData"].toArray());
-    info.yData = jsonToVector(json["yData"].toArray());
+    // 旧项目的数组直接写在 JSON 中：读入后换用新的 dataId，下次保存时转存到 _chart.wtd
+    const bool legacyArrays = json.contains("xData");
+    info.dataId = json["dataId"].toString();
+    if (legacyArrays) {
+        info.xData = jsonToVector(json["xData"].toArray());
+        info.yData = jsonToVector(json["yData"].toArray());
+    }
 
     info.pointShape = (QCPScatterStyle::ScatterShape)json["pointShape"].toInt();
     info.pointColor = QColor(json["pointColor"].toString());
@@ -106,8 +116,10 @@ CurveInfo CurveInfo::fromJson(const QJsonObject& json) {
     if (info.type == 1) {
         info.x2Col = json["x2Col"].toInt(-1);
         info.y2Col = json["y2Col"].toInt(-1);
-        info.x2Data = jsonToVector(json["x2Data"].toArray());
-        info.y2Data = jsonToVector(json["y2Data"].toArray());
+        if (legacyArrays) {
+            info.x2Data = jsonToVector(json["x2Data"].toArray());
+            info.y2Data = jsonToVector(json["y2Data"].toArray());
+        }
         info.prodLegendName = json["prodLegendName"].toString();
         info.prodGraphType = json["prodGraphType"].toInt();
         info.prodColor = QColor(json["prodColor"].toString());
@@ -117,16 +129,57 @@ CurveInfo CurveInfo::fromJson(const QJsonObject& json) {
         info.LSpacing = json["LSpacing"].toDouble();
         info.isSmooth = json["isSmooth"].toBool();
         info.smoothFactor = json["smoothFactor"].toInt();
-        info.derivData = jsonToVector(json["derivData"].toArray());
+        info.smoothMethod = json["smoothMethod"].toInt(SignalFilter::MovingAverage);
+        info.smoothWindow = json["smoothWindow"].toDouble(0.2);
+        if (legacyArrays) info.derivData = jsonToVector(json["derivData"].toArray());
         info.derivShape = (QCPScatterStyle::ScatterShape)json["derivShape"].toInt();
         info.derivPointColor = QColor(json["derivPointColor"].toString());
         info.derivLineStyle = (Qt::PenStyle)json["derivLineStyle"].toInt();
         info.derivLineColor = QColor(json["derivLineColor"].toString());
         info.prodLegendName = json["prodLegendName"].toString();
     }
+
+    if (legacyArrays || info.dataId.isEmpty()) info.renewDataId();
+    else info.dataLoaded = false;
     return info;
 }
 
+void CurveInfo::renewDataId()
+{
+    dataId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    dataLoaded = true;
+}
+
+void CurveInfo::collectArrays(QMap<QString, QVector<double>>& out) const
+{
+    out.insert(dataId + "/xData", xData);
+    out.insert(dataId + "/yData", yData);
+    if (type == 1) {
+        out.insert(dataId + "/x2Data", x2Data);
+        out.insert(dataId + "/y2Data", y2Data);
+    } else if (type == 2) {
+        out.insert(dataId + "/derivData", derivData);
+    }
+}
+
+bool CurveInfo::loadArrays(const CurveDataFile& file)
+{
+    QMap<QString, QVector<double>> keys;
+    collectArrays(keys);
+    for (auto it = keys.constBegin(); it != keys.constEnd(); ++it) {
+        if (!file.contains(it.key())) return false;
+    }
+    xData = file.array(dataId + "/xData");
+    yData = file.array(dataId + "/yData");
+    if (type == 1) {
+        x2Data = file.array(dataId + "/x2Data");
+        y2Data = file.array(dataId + "/y2Data");
+    } else if (type == 2) {
+        derivData = file.array(dataId + "/derivData");
+    }
+    return true;
+}
+
 // ============================================================================
 // WT_PlottingWidget 主类实现
 // ============================================================================
@@ -140,7 +193,12 @@ WT_PlottingWidget::WT_PlottingWidget(QWidget *parent) :
     m_exportStartIndex(0),
     m_exportEndIndex(0),
     m_graphPress(nullptr),
-    m_graphProd(nullptr)
+    m_graphProd(nullptr),
+    m_projectDataPending(false),
+    m_waitingForProjectData(false),
+    m_curveTaskButton(nullptr),
+    m_curveTaskNewWindow(false),
+    m_curveTaskFollowTable(true)
 {
     ui->setupUi(this);
 
@@ -152,6 +210,14 @@ WT_PlottingWidget::WT_PlottingWidget(QWidget *parent) :
 
     connect(ui->customPlot, &ChartWidget::exportDataTriggered, this, &WT_PlottingWidget::onExportDataTriggered);
     connect(ui->customPlot->getPlot(), &QCustomPlot::plottableClick, this, &WT_PlottingWidget::onGraphClicked);
+    connect(ModelParameter::instance(), &ModelParameter::plottingDataReady, this, &WT_PlottingWidget::onProjectPlottingDataReady);
+
+    // 压力产量、导数曲线的后台计算：进度显示在发起计算的按钮上
+    connect(&m_curveWatcher, &QFutureWatcher<CurveInfo>::finished, this, &WT_PlottingWidget::onCurveTaskFinished);
+    connect(&m_curveWatcher, &QFutureWatcher<CurveInfo>::progressValueChanged, this, [this](int value) {
+        if (m_curveTaskButton) m_curveTaskButton->setText(QString("计算中 %1%").arg(value));
+    });
+    connect(&m_liveWatcher, &QFutureWatcher<QVector<LiveCurveJob>>::finished, this, &WT_PlottingWidget::onLiveCurvesUpdated);
 
     ui->customPlot->setChartMode(ChartWidget::Mode_Single);
     ui->customPlot->setTitle("试井分析图表");
@@ -163,7 +229,12 @@ WT_PlottingWidget::~WT_PlottingWidget()
     delete ui;
 }
 
-void WT_PlottingWidget::setDataModel(QStandardItemModel* model) { m_dataModel = model; }
+void WT_PlottingWidget::setDataModel(MeasurementTableModel* model)
+{
+    // 换了表格：已有曲线的列号不再对应
+    if (model != m_dataModel) m_liveCurves.clear();
+    m_dataModel = model;
+}
 void WT_PlottingWidget::setProjectPath(const QString& path) { m_projectPath = path; }
 
 void WT_PlottingWidget::applyDialogStyle(QWidget* dialog) {
@@ -188,13 +259,79 @@ void WT_PlottingWidget::applyDialogStyle(QWidget* dialog) {
 void WT_PlottingWidget::loadProjectData()
 {
     m_curves.clear();
+    m_liveCurves.clear();
+    m_pendingChanges = DataChangeSet();
+    m_curveFile.close();
     ui->listWidget_Curves->clear();
     ui->customPlot->getPlot()->clearGraphs();
     ui->customPlot->getPlot()->replot();
     m_currentDisplayedCurve.clear();
 
+    m_projectDataPending = true;
+    m_waitingForProjectData = false;
+    if (isVisible()) {
+        m_projectDataPending = false;
+        m_waitingForProjectData = true;
+        ModelParameter::instance()->requestPlottingData();
+    }
+}
+
+void WT_PlottingWidget::commitProjectData()
+{
+    if (!ModelParameter::instance()->hasLoadedProject()) return;
+    // 页面还未显示过或数据仍在读取时，m_curves 为空，不能覆盖项目中的曲线
+    if (m_projectDataPending || m_waitingForProjectData) return;
+
+    QJsonArray curvesArray;
+    for(auto it = m_curves.begin(); it != m_curves.end(); ++it) {
+        curvesArray.append(it.value().toJson());
+    }
+    ModelParameter* mp = ModelParameter::instance();
+    if (mp->isPlottingDataUnchanged(curvesArray)) return;
+
+    // 保存会替换 _chart.wtd：先把尚未读取的曲线数组取到内存，再解除映射
+    QMap<QString, QVector<double>> curveData;
+    for(auto it = m_curves.begin(); it != m_curves.end(); ++it) {
+        ensureCurveData(it.value());
+        it.value().collectArrays(curveData);
+    }
+    m_curveFile.close();
+    mp->savePlottingData(curvesArray, curveData);
+}
+
+bool WT_PlottingWidget::ensureCurveData(CurveInfo& info)
+{
+    if (info.dataLoaded) return true;
+    if (!m_curveFile.isOpen()) {
+        // 保存后映射已关闭，等写入完成再重新打开
+        ModelParameter::instance()->waitForPendingWrites();
+        m_curveFile.open(ModelParameter::instance()->getPlottingCurveDataFilePath());
+    }
+    // 数组缺失时不再重复读取，曲线按空数据处理
+    info.dataLoaded = true;
+    if (info.loadArrays(m_curveFile)) return true;
+    qDebug() << "曲线数据缺失:" << info.name;
+    return false;
+}
+
+void WT_PlottingWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (m_projectDataPending) {
+        m_projectDataPending = false;
+        m_waitingForProjectData = true;
+        ModelParameter::instance()->requestPlottingData();
+    }
+}
+
+void WT_PlottingWidget::onProjectPlottingDataReady()
+{
+    if (!m_waitingForProjectData) return;
+    m_waitingForProjectData = false;
+
     QJsonArray plots = ModelParameter::instance()->getPlottingData();
     if (plots.isEmpty()) return;
+    m_curveFile.open(ModelParameter::instance()->getPlottingCurveDataFilePath());
 
     for (const auto& val : plots) {
         CurveInfo info = CurveInfo::fromJson(val.toObject());
@@ -219,11 +356,7 @@ void WT_PlottingWidget::saveProjectData()
         msgBox.exec();
         return;
     }
-    QJsonArray curvesArray;
-    for(auto it = m_curves.begin(); it != m_curves.end(); ++it) {
-        curvesArray.append(it.value().toJson());
-    }
-    ModelParameter::instance()->savePlottingData(curvesArray);
+    commitProjectData();
 
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("保存");
@@ -256,17 +389,11 @@ void WT_PlottingWidget::on_btn_NewCurve_clicked()
         QString xLabel = m_dataModel->headerData(info.xCol, Qt::Horizontal).toString();
         QString yLabel = m_dataModel->headerData(info.yCol, Qt::Horizontal).toString();
 
-        info.xData.clear(); info.yData.clear();
-        for(int i=0; i<m_dataModel->rowCount(); ++i) {
-            double xVal = m_dataModel->item(i, info.xCol)->text().toDouble();
-            double yVal = m_dataModel->item(i, info.yCol)->text().toDouble();
-            if (xVal > 1e-9 && yVal > 1e-9) {
-                info.xData.append(xVal);
-                info.yData.append(yVal);
-            }
-        }
+        buildSimpleCurve(info, m_dataModel->columnValues(info.xCol), m_dataModel->columnValues(info.yCol));
+        info.renewDataId();
 
         m_curves.insert(info.name, info);
+        m_liveCurves.insert(info.name, DerivativeSeries());
         ui->listWidget_Curves->addItem(info.name);
 
         if(dlg.isNewWindow()) {
@@ -278,7 +405,7 @@ void WT_PlottingWidget::on_btn_NewCurve_clicked()
 
             QCPGraph* graph = cw->getPlot()->addGraph();
             graph->setName(info.legendName);
-            graph->setData(info.xData, info.yData);
+            GraphDecimator::setGraphData(graph, info.xData, info.yData);
             graph->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
             // 【修复】尊重弹窗选择的线型
@@ -307,7 +434,7 @@ void WT_PlottingWidget::on_btn_NewCurve_clicked()
 // 2. 压力产量分析 (双坐标系)
 void WT_PlottingWidget::on_btn_PressureRate_clicked()
 {
-    if(!m_dataModel) return;
+    if(!m_dataModel || m_curveWatcher.isRunning()) return;
     PlottingDialog2 dlg(m_dataModel, this);
     applyDialogStyle(&dlg);
 
@@ -319,88 +446,28 @@ void WT_PlottingWidget::on_btn_PressureRate_clicked()
         info.xCol = dlg.getPressXCol(); info.yCol = dlg.getPressYCol();
         info.x2Col = dlg.getProdXCol(); info.y2Col = dlg.getProdYCol();
 
-        // 【标签设置】压力产量：使用标准默认标签 (解决弹窗输入不一致问题)
-        QString pressLabel = "Pressure";
-        QString prodLabel = "Production";
-        QString timeLabel = "Time";
-
-        for(int i=0; i<m_dataModel->rowCount(); ++i) {
-            info.xData.append(m_dataModel->item(i, info.xCol)->text().toDouble());
-            info.yData.append(m_dataModel->item(i, info.yCol)->text().toDouble());
-            info.x2Data.append(m_dataModel->item(i, info.x2Col)->text().toDouble());
-            info.y2Data.append(m_dataModel->item(i, info.y2Col)->text().toDouble());
-        }
-
         info.pointShape = dlg.getPressShape(); info.pointColor = dlg.getPressPointColor();
         info.lineStyle = dlg.getPressLineStyle(); info.lineColor = dlg.getPressLineColor();
         info.prodLegendName = dlg.getProdLegend();
         info.prodGraphType = dlg.getProdGraphType();
         info.prodColor = dlg.getProdColor();
 
-        m_curves.insert(info.name, info);
-        ui->listWidget_Curves->addItem(info.name);
-
-        if(dlg.isNewWindow()) {
-            ChartWindow* w = new ChartWindow();
-            w->setWindowTitle(info.name);
-            ChartWidget* cw = w->getChartWidget();
-            cw->setChartMode(ChartWidget::Mode_Stacked);
-            cw->setTitle(info.name);
-
-            QCPAxisRect* top = cw->getTopRect();
-            QCPAxisRect* bottom = cw->getBottomRect();
-            MouseZoom* plot = cw->getPlot();
-
-            if (top && bottom) {
-                top->axis(QCPAxis::atLeft)->setLabel(pressLabel);
-                bottom->axis(QCPAxis::atLeft)->setLabel(prodLabel);
-                bottom->axis(QCPAxis::atBottom)->setLabel(timeLabel);
-
-                QCPGraph* gPress = plot->addGraph(top->axis(QCPAxis::atBottom), top->axis(QCPAxis::atLeft));
-                gPress->setData(info.xData, info.yData);
-                gPress->setName(info.legendName);
-                gPress->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
-
-                // 【修复】压力曲线：尊重弹窗线型
-                gPress->setPen(QPen(info.lineColor, 2, info.lineStyle));
-                gPress->setLineStyle(info.lineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
-
-                QCPGraph* gProd = plot->addGraph(bottom->axis(QCPAxis::atBottom), bottom->axis(QCPAxis::atLeft));
-                gProd->setName(info.prodLegendName);
-                if(info.prodGraphType == 0) {
-                    gProd->setData(info.x2Data, info.y2Data);
-                    gProd->setLineStyle(QCPGraph::lsStepLeft); // 阶梯图
-                } else {
-                    gProd->setData(info.x2Data, info.y2Data);
-                    gProd->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, info.prodColor, info.prodColor, 6));
-                    gProd->setLineStyle(QCPGraph::lsNone); // 散点图
-                }
-                gProd->setPen(QPen(info.prodColor, 2));
-
-                plot->rescaleAxes();
-                plot->replot();
-            }
-            w->show();
-            m_openedWindows.append(w);
-
-        } else {
-            ui->customPlot->setChartMode(ChartWidget::Mode_Stacked);
-            if (ui->customPlot->getTopRect()) ui->customPlot->getTopRect()->axis(QCPAxis::atLeft)->setLabel(pressLabel);
-            if (ui->customPlot->getBottomRect()) {
-                ui->customPlot->getBottomRect()->axis(QCPAxis::atLeft)->setLabel(prodLabel);
-                ui->customPlot->getBottomRect()->axis(QCPAxis::atBottom)->setLabel(timeLabel);
-            }
-
-            drawStackedPlot(info);
-            m_currentDisplayedCurve = info.name;
-        }
+        // 列数据在界面线程中取出 (表格可能随后被编辑)，曲线数组在后台整理
+        const QVector<double> xs = m_dataModel->columnValues(info.xCol);
+        const QVector<double> ys = m_dataModel->columnValues(info.yCol);
+        const QVector<double> x2s = m_dataModel->columnValues(info.x2Col);
+        const QVector<double> y2s = m_dataModel->columnValues(info.y2Col);
+        startCurveTask(ui->btn_PressureRate, dlg.isNewWindow(),
+                       QtConcurrent::run([info, xs, ys, x2s, y2s](QPromise<CurveInfo>& promise) {
+                           buildPressureRateCurve(promise, info, xs, ys, x2s, y2s);
+                       }));
     }
 }
 
 // 3. 导数分析
 void WT_PlottingWidget::on_btn_Derivative_clicked()
 {
-    if(!m_dataModel) return;
+    if(!m_dataModel || m_curveWatcher.isRunning()) return;
     PlottingDialog3 dlg(m_dataModel, this);
     applyDialogStyle(&dlg);
 
@@ -416,101 +483,443 @@ void WT_PlottingWidget::on_btn_Derivative_clicked()
         info.LSpacing = dlg.getLSpacing();
         info.isSmooth = dlg.isSmoothEnabled();
         info.smoothFactor = dlg.getSmoothFactor();
+        info.smoothMethod = (int)dlg.getSmoothMethod();
+        info.smoothWindow = dlg.getSmoothWindow();
+
+        info.pointShape = dlg.getPressShape(); info.pointColor = dlg.getPressPointColor();
+        info.lineStyle = dlg.getPressLineStyle(); info.lineColor = dlg.getPressLineColor();
+        info.derivShape = dlg.getDerivShape(); info.derivPointColor = dlg.getDerivPointColor();
+        info.derivLineStyle = dlg.getDerivLineStyle(); info.derivLineColor = dlg.getDerivLineColor();
+        info.prodLegendName = dlg.getDerivLegend();
+
+        const QVector<double> ts = m_dataModel->columnValues(info.xCol);
+        const QVector<double> ps = m_dataModel->columnValues(info.yCol);
+        startCurveTask(ui->btn_Derivative, dlg.isNewWindow(),
+                       QtConcurrent::run([info, ts, ps](QPromise<CurveInfo>& promise) {
+                           buildDerivativeCurve(promise, info, ts, ps);
+                       }));
+    }
+}
+
+// 4. 反卷积分析 (压力与产量历史 -> 恒定参考产量下的 Δp 与导数)
+void WT_PlottingWidget::on_btn_Deconvolution_clicked()
+{
+    if(!m_dataModel || m_curveWatcher.isRunning()) return;
+    PlottingDialog2 dlg(m_dataModel, this);
+    dlg.setWindowTitle("反卷积分析");
+    applyDialogStyle(&dlg);
+
+    if(dlg.exec() == QDialog::Accepted) {
+        CurveInfo info;
+        info.name = dlg.getChartName();
+        info.legendName = dlg.getPressLegend();
+        info.type = 2;
+        info.xCol = dlg.getPressXCol(); info.yCol = dlg.getPressYCol();
+        info.x2Col = dlg.getProdXCol(); info.y2Col = dlg.getProdYCol();
+        info.testType = 0;
+        info.initialPressure = 0.0;
+        info.LSpacing = 0.0;
+        info.isSmooth = false;
+        info.smoothFactor = 0;
+        info.smoothMethod = SignalFilter::MovingAverage;
+        info.smoothWindow = 0.0;
+
+        info.pointShape = dlg.getPressShape(); info.pointColor = dlg.getPressPointColor();
+        info.lineStyle = dlg.getPressLineStyle(); info.lineColor = dlg.getPressLineColor();
+        // 导数使用与导数分析相同的默认样式
+        info.derivShape = QCPScatterStyle::ssTriangle; info.derivPointColor = Qt::blue;
+        info.derivLineStyle = Qt::NoPen; info.derivLineColor = Qt::blue;
+        info.prodLegendName = "Derivative";
+
+        const QVector<double> ts = m_dataModel->columnValues(info.xCol);
+        const QVector<double> ps = m_dataModel->columnValues(info.yCol);
+        const QVector<double> qts = m_dataModel->columnValues(info.x2Col);
+        const QVector<double> qs = m_dataModel->columnValues(info.y2Col);
+        QString* error = &m_curveTaskError;
+        error->clear();
+        // 反卷积曲线由整段历史求得，不随表格单元格修改就地更新
+        startCurveTask(ui->btn_Deconvolution, dlg.isNewWindow(),
+                       QtConcurrent::run([info, ts, ps, qts, qs, error](QPromise<CurveInfo>& promise) {
+                           buildDeconvolutionCurve(promise, info, ts, ps, qts, qs, error);
+                       }), false);
+    }
+}
+
+// ---------------- 后台曲线计算 ----------------
+
+void WT_PlottingWidget::buildPressureRateCurve(QPromise<CurveInfo>& promise, CurveInfo info,
+                                               const QVector<double>& xs, const QVector<double>& ys,
+                                               const QVector<double>& x2s, const QVector<double>& y2s)
+{
+    promise.setProgressRange(0, 100);
+    // 压力与产量两组各取两列的公共长度
+    const int n1 = qMin(xs.size(), ys.size());
+    const int n2 = qMin(x2s.size(), y2s.size());
+    info.xData = xs.size() == n1 ? xs : xs.mid(0, n1);
+    info.yData = ys.size() == n1 ? ys : ys.mid(0, n1);
+    promise.setProgressValue(50);
+    info.x2Data = x2s.size() == n2 ? x2s : x2s.mid(0, n2);
+    info.y2Data = y2s.size() == n2 ? y2s : y2s.mid(0, n2);
+    promise.setProgressValue(100);
+    promise.addResult(info);
+}
+
+void WT_PlottingWidget::buildDerivativeCurve(QPromise<CurveInfo>& promise, CurveInfo info,
+                                             const QVector<double>& ts, const QVector<double>& ps)
+{
+    promise.setProgressRange(0, 100);
+    // 与拟合页面共用同一导数序列 (Bourdet L-Spacing)，保证两处曲线一致；表格修改后也按同一规则更新
+    DerivativeSeries series(derivativeSettings(info));
+    series.rebuild(ts, ps);
+    info.xData = series.time();
+    info.yData = series.deltaP();
+    promise.setProgressValue(80);
+    // 有效点不足时不使用导数，由界面线程提示
+    if(info.xData.size() < 3 || promise.isCanceled()) {
+        promise.addResult(info);
+        return;
+    }
 
-        double p_shutin = 0;
-        if(m_dataModel->rowCount() > 0) {
-            p_shutin = m_dataModel->item(0, info.yCol)->text().toDouble();
+    info.derivData = SignalFilter::apply(smoothingOptions(info), series.time(), series.derivative());
+    promise.setProgressValue(100);
+    promise.addResult(info);
+}
+
+void WT_PlottingWidget::buildDeconvolutionCurve(QPromise<CurveInfo>& promise, CurveInfo info,
+                                                const QVector<double>& ts, const QVector<double>& ps,
+                                                const QVector<double>& qts, const QVector<double>& qs, QString* error)
+{
+    promise.setProgressRange(0, 100);
+    // 列副本在任务结束前有效，求解器直接读取其缓冲区
+    RateDeconvolution deconvolution;
+    deconvolution.setPressureSamples(ts.constData(), ps.constData(), qMin(ts.size(), ps.size()));
+    deconvolution.setRateSamples(qts.constData(), qs.constData(), qMin(qts.size(), qs.size()));
+    deconvolution.setProgressCallback([&promise](int percent) { promise.setProgressValue(percent); });
+    deconvolution.setStopPredicate([&promise]() { return promise.isCanceled(); });
+
+    const RateDeconvolution::Result result = deconvolution.run(RateDeconvolution::Options());
+    if(!result.error.isEmpty()) {
+        *error = result.error;
+        promise.addResult(info);
+        return;
+    }
+    info.xData = result.time;
+    info.yData = result.deltaP;
+    info.derivData = result.derivative;
+    info.initialPressure = result.initialPressure;
+    info.legendName = QString("%1 (q=%2)").arg(info.legendName).arg(result.referenceRate, 0, 'g', 4);
+    promise.setProgressValue(100);
+    promise.addResult(info);
+}
+
+void WT_PlottingWidget::startCurveTask(QPushButton* button, bool newWindow, const QFuture<CurveInfo>& future, bool followTable)
+{
+    m_curveTaskButton = button;
+    m_curveTaskButtonText = button->text();
+    m_curveTaskNewWindow = newWindow;
+    m_curveTaskFollowTable = followTable;
+    ui->btn_PressureRate->setEnabled(false);
+    ui->btn_Derivative->setEnabled(false);
+    ui->btn_Deconvolution->setEnabled(false);
+    button->setText(QString("计算中 0%"));
+    m_curveWatcher.setFuture(future);
+}
+
+void WT_PlottingWidget::onCurveTaskFinished()
+{
+    if(m_curveTaskButton) m_curveTaskButton->setText(m_curveTaskButtonText);
+    m_curveTaskButton = nullptr;
+    ui->btn_PressureRate->setEnabled(true);
+    ui->btn_Derivative->setEnabled(true);
+    ui->btn_Deconvolution->setEnabled(true);
+    if(m_curveWatcher.isCanceled() || m_curveWatcher.future().resultCount() == 0) return;
+
+    CurveInfo info = m_curveWatcher.result();
+    if(!m_curveTaskError.isEmpty()) {
+        QMessageBox::warning(this, "错误", m_curveTaskError);
+        m_curveTaskError.clear();
+        return;
+    }
+    if(info.type == 2 && info.xData.size() < 3) {
+        QMessageBox::warning(this, "错误", "有效数据点不足（需 > 0）");
+        return;
+    }
+    info.renewDataId();
+
+    m_curves.insert(info.name, info);
+    if(m_curveTaskFollowTable) m_liveCurves.insert(info.name, DerivativeSeries());
+    ui->listWidget_Curves->addItem(info.name);
+    if(m_curveTaskNewWindow) openCurveWindow(info);
+    else showAnalysisCurve(info);
+}
+
+// 压力产量、导数分析曲线显示在主图中
+void WT_PlottingWidget::showAnalysisCurve(const CurveInfo& info)
+{
+    if(info.type == 1) {
+        // 【标签设置】压力产量：使用标准默认标签 (解决弹窗输入不一致问题)
+        ui->customPlot->setChartMode(ChartWidget::Mode_Stacked);
+        if (ui->customPlot->getTopRect()) ui->customPlot->getTopRect()->axis(QCPAxis::atLeft)->setLabel("Pressure");
+        if (ui->customPlot->getBottomRect()) {
+            ui->customPlot->getBottomRect()->axis(QCPAxis::atLeft)->setLabel("Production");
+            ui->customPlot->getBottomRect()->axis(QCPAxis::atBottom)->setLabel("Time");
         }
+        drawStackedPlot(info);
+    } else {
+        // 【标签设置】导数分析：标准默认标签
+        ui->customPlot->setChartMode(ChartWidget::Mode_Single);
+        ui->customPlot->getPlot()->xAxis->setLabel("Time");
+        ui->customPlot->getPlot()->yAxis->setLabel("Pressure & Derivative");
+        drawDerivativePlot(info);
+    }
+    m_currentDisplayedCurve = info.name;
+}
 
-        for(int i=0; i<m_dataModel->rowCount(); ++i) {
-            double t = m_dataModel->item(i, info.xCol)->text().toDouble();
-            double p = m_dataModel->item(i, info.yCol)->text().toDouble();
-            double dp = (info.testType == 0) ? std::abs(info.initialPressure - p) : std::abs(p - p_shutin);
-            if(t > 0 && dp > 0) { info.xData.append(t); info.yData.append(dp); }
+// 压力产量、导数分析曲线显示在新窗口中
+void WT_PlottingWidget::openCurveWindow(const CurveInfo& info)
+{
+    ChartWindow* w = new ChartWindow();
+    w->setWindowTitle(info.name);
+    ChartWidget* cw = w->getChartWidget();
+    cw->setTitle(info.name);
+    MouseZoom* plot = cw->getPlot();
+
+    if(info.type == 1) {
+        cw->setChartMode(ChartWidget::Mode_Stacked);
+        QCPAxisRect* top = cw->getTopRect();
+        QCPAxisRect* bottom = cw->getBottomRect();
+
+        if (top && bottom) {
+            top->axis(QCPAxis::atLeft)->setLabel("Pressure");
+            bottom->axis(QCPAxis::atLeft)->setLabel("Production");
+            bottom->axis(QCPAxis::atBottom)->setLabel("Time");
+
+            QCPGraph* gPress = plot->addGraph(top->axis(QCPAxis::atBottom), top->axis(QCPAxis::atLeft));
+            GraphDecimator::setGraphData(gPress, info.xData, info.yData);
+            gPress->setName(info.legendName);
+            gPress->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
+
+            // 【修复】压力曲线：尊重弹窗线型
+            gPress->setPen(QPen(info.lineColor, 2, info.lineStyle));
+            gPress->setLineStyle(info.lineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
+
+            QCPGraph* gProd = plot->addGraph(bottom->axis(QCPAxis::atBottom), bottom->axis(QCPAxis::atLeft));
+            gProd->setName(info.prodLegendName);
+            GraphDecimator::setGraphData(gProd, info.x2Data, info.y2Data);
+            if(info.prodGraphType == 0) {
+                gProd->setLineStyle(QCPGraph::lsStepLeft); // 阶梯图
+            } else {
+                gProd->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, info.prodColor, info.prodColor, 6));
+                gProd->setLineStyle(QCPGraph::lsNone); // 散点图
+            }
+            gProd->setPen(QPen(info.prodColor, 2));
         }
+    } else {
+        cw->setChartMode(ChartWidget::Mode_Single);
+        plot->xAxis->setLabel("Time");
+        plot->yAxis->setLabel("Pressure & Derivative");
+
+        QCPGraph* g1 = plot->addGraph();
+        GraphDecimator::setGraphData(g1, info.xData, info.yData);
+        g1->setName(info.legendName);
+        g1->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
+        // 【修复】尊重弹窗线型
+        g1->setPen(QPen(info.lineColor, 2, info.lineStyle));
+        g1->setLineStyle(info.lineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
+
+        QCPGraph* g2 = plot->addGraph();
+        GraphDecimator::setGraphData(g2, info.xData, info.derivData);
+        g2->setName(info.prodLegendName);
+        g2->setScatterStyle(QCPScatterStyle(info.derivShape, info.derivPointColor, info.derivPointColor, 6));
+        // 【修复】尊重弹窗线型
+        g2->setPen(QPen(info.derivLineColor, 2, info.derivLineStyle));
+        g2->setLineStyle(info.derivLineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
+    }
+
+    plot->rescaleAxes();
+    plot->replot();
+    w->show();
+    m_openedWindows.append(w);
+}
 
-        if(info.xData.size() < 3) {
-            QMessageBox::warning(this, "错误", "有效数据点不足（需 > 0）");
-            return;
+// ---------------- 跟随表格的曲线 ----------------
+
+void WT_PlottingWidget::buildSimpleCurve(CurveInfo& info, const QVector<double>& xs, const QVector<double>& ys)
+{
+    info.xData.clear(); info.yData.clear();
+    for(int i=0; i<qMin(xs.size(), ys.size()); ++i) {
+        if (xs[i] > 1e-9 && ys[i] > 1e-9) {
+            info.xData.append(xs[i]);
+            info.yData.append(ys[i]);
         }
+    }
+}
 
-        QVector<double> derData;
-        for (int i = 0; i < info.xData.size(); ++i) {
-            double t = info.xData[i];
-            double logT = std::log(t);
-            int l=i, r=i;
-            while(l>0 && std::log(info.xData[l]) > logT - info.LSpacing) l--;
-            while(r<info.xData.size()-1 && std::log(info.xData[r]) < logT + info.LSpacing) r++;
-            double num = info.yData[r] - info.yData[l];
-            double den = std::log(info.xData[r]) - std::log(info.xData[l]);
-            derData.append(std::abs(den)>1e-6 ? num/den : 0);
+DerivativeSeries::Settings WT_PlottingWidget::derivativeSettings(const CurveInfo& info)
+{
+    // 恢复试井以第一行压力为关井压力，压差不为正的点不绘制
+    DerivativeSeries::Settings settings;
+    settings.timeColumn = info.xCol;
+    settings.pressureColumn = info.yCol;
+    settings.drawdown = (info.testType == 0);
+    settings.initialPressure = info.initialPressure;
+    settings.referenceRow = 0;
+    settings.requirePositiveDeltaP = true;
+    settings.lSpacing = info.LSpacing;
+    return settings;
+}
+
+SignalFilter::Options WT_PlottingWidget::smoothingOptions(const CurveInfo& info)
+{
+    SignalFilter::Options options;
+    options.enabled = info.isSmooth;
+    options.method = SignalFilter::Method(info.smoothMethod);
+    options.span = info.smoothFactor;
+    options.windowCycles = info.smoothWindow;
+    return options;
+}
+
+void WT_PlottingWidget::applyDataChanges(const DataChangeSet& changes)
+{
+    if(m_liveCurves.isEmpty()) return;
+    if(m_liveWatcher.isRunning()) {
+        m_pendingChanges.merge(changes);
+        return;
+    }
+    startLiveCurveUpdate(changes);
+}
+
+void WT_PlottingWidget::startLiveCurveUpdate(const DataChangeSet& changes)
+{
+    if(!m_dataModel) return;
+
+    QVector<LiveCurveJob> jobs;
+    for(auto it = m_liveCurves.begin(); it != m_liveCurves.end();) {
+        auto curve = m_curves.constFind(it.key());
+        if(curve == m_curves.constEnd()) {
+            it = m_liveCurves.erase(it);
+            continue;
+        }
+        const CurveInfo& info = curve.value();
+        QVector<int> columns = { info.xCol, info.yCol };
+        if(info.type == 1) columns << info.x2Col << info.y2Col;
+
+        // 列号已移动或换了表格：曲线不再跟随表格
+        if(!std::all_of(columns.begin(), columns.end(), [&](int c) { return changes.keepsColumn(c); })) {
+            it = m_liveCurves.erase(it);
+            continue;
+        }
+        if(std::none_of(columns.begin(), columns.end(), [&](int c) { return changes.touches(c); })) {
+            ++it;
+            continue;
         }
 
-        if(info.isSmooth && info.smoothFactor > 1) {
-            QVector<double> smoothed;
-            int half = info.smoothFactor/2;
-            for (int i = 0; i < derData.size(); ++i) {
-                double sum = 0; int cnt = 0;
-                for (int j = i - half; j <= i + half; ++j) {
-                    if (j >= 0 && j < derData.size()) { sum += derData[j]; cnt++; }
+        LiveCurveJob job;
+        job.info = info;
+        job.series = it.value();
+        if(info.type == 2 && !changes.touches(info.xCol)) {
+            // 只读取被修改的压力单元格
+            for(const QPair<int, int>& range : changes.rowRanges) {
+                for(int r = range.first; r <= qMin(range.second, m_dataModel->rowCount() - 1); ++r) {
+                    job.cells.append(qMakePair(r, m_dataModel->value(r, info.yCol)));
                 }
-                smoothed.append(sum / cnt);
             }
-            info.derivData = smoothed;
-        } else {
-            info.derivData = derData;
+            job.incremental = job.series.canUpdatePressure(job.cells);
         }
+        if(!job.incremental) {
+            job.cells.clear();
+            job.xs = m_dataModel->columnValues(info.xCol);
+            job.ys = m_dataModel->columnValues(info.yCol);
+            if(info.type == 1) {
+                job.x2s = m_dataModel->columnValues(info.x2Col);
+                job.y2s = m_dataModel->columnValues(info.y2Col);
+            }
+        }
+        jobs.append(job);
+        ++it;
+    }
+    if(jobs.isEmpty()) return;
 
-        info.pointShape = dlg.getPressShape(); info.pointColor = dlg.getPressPointColor();
-        info.lineStyle = dlg.getPressLineStyle(); info.lineColor = dlg.getPressLineColor();
-        info.derivShape = dlg.getDerivShape(); info.derivPointColor = dlg.getDerivPointColor();
-        info.derivLineStyle = dlg.getDerivLineStyle(); info.derivLineColor = dlg.getDerivLineColor();
-        info.prodLegendName = dlg.getDerivLegend();
-
-        m_curves.insert(info.name, info);
-        ui->listWidget_Curves->addItem(info.name);
+    m_liveWatcher.setFuture(QtConcurrent::run([jobs]() mutable {
+        for(LiveCurveJob& job : jobs) runLiveCurveJob(job);
+        return jobs;
+    }));
+}
 
-        if(dlg.isNewWindow()) {
-            ChartWindow* w = new ChartWindow();
-            w->setWindowTitle(info.name);
-            ChartWidget* cw = w->getChartWidget();
-            cw->setChartMode(ChartWidget::Mode_Single);
-            cw->setTitle(info.name);
+void WT_PlottingWidget::runLiveCurveJob(LiveCurveJob& job)
+{
+    CurveInfo& info = job.info;
+    if(info.type == 0) {
+        buildSimpleCurve(info, job.xs, job.ys);
+    } else if(info.type == 1) {
+        const int n1 = qMin(job.xs.size(), job.ys.size());
+        const int n2 = qMin(job.x2s.size(), job.y2s.size());
+        info.xData = job.xs.mid(0, n1);
+        info.yData = job.ys.mid(0, n1);
+        info.x2Data = job.x2s.mid(0, n2);
+        info.y2Data = job.y2s.mid(0, n2);
+    } else {
+        if(job.incremental) {
+            job.series.updatePressure(job.cells);
+        } else {
+            job.series = DerivativeSeries(derivativeSettings(info));
+            job.series.rebuild(job.xs, job.ys);
+        }
+        info.xData = job.series.time();
+        info.yData = job.series.deltaP();
+        info.derivData = SignalFilter::apply(smoothingOptions(info), job.series.time(), job.series.derivative());
+    }
+    // 列数据只在任务中使用
+    job.xs.clear(); job.ys.clear(); job.x2s.clear(); job.y2s.clear();
+}
 
-            // 【标签设置】导数分析：标准默认标签
-            cw->getPlot()->xAxis->setLabel("Time");
-            cw->getPlot()->yAxis->setLabel("Pressure & Derivative");
-
-            QCPGraph* g1 = cw->getPlot()->addGraph();
-            g1->setData(info.xData, info.yData);
-            g1->setName(info.legendName);
-            g1->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
-            // 【修复】尊重弹窗线型
-            g1->setPen(QPen(info.lineColor, 2, info.lineStyle));
-            g1->setLineStyle(info.lineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
-
-            QCPGraph* g2 = cw->getPlot()->addGraph();
-            g2->setData(info.xData, info.derivData);
-            g2->setName(info.prodLegendName);
-            g2->setScatterStyle(QCPScatterStyle(info.derivShape, info.derivPointColor, info.derivPointColor, 6));
-            // 【修复】尊重弹窗线型
-            g2->setPen(QPen(info.derivLineColor, 2, info.derivLineStyle));
-            g2->setLineStyle(info.derivLineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
+void WT_PlottingWidget::onLiveCurvesUpdated()
+{
+    const QVector<LiveCurveJob> jobs = m_liveWatcher.future().resultCount() > 0 ? m_liveWatcher.result()
+                                                                                : QVector<LiveCurveJob>();
+    bool displayedChanged = false;
+    for(const LiveCurveJob& job : jobs) {
+        const QString& name = job.info.name;
+        // 重算期间曲线被删除、不再跟随表格或改了列：丢弃结果
+        if(!m_liveCurves.contains(name) || !m_curves.contains(name)) continue;
+        CurveInfo& info = m_curves[name];
+        if(info.xCol != job.info.xCol || info.yCol != job.info.yCol ||
+            (info.type == 1 && (info.x2Col != job.info.x2Col || info.y2Col != job.info.y2Col))) continue;
+
+        // 只替换数组，曲线样式可能已在重算期间修改
+        info.xData = job.info.xData;
+        info.yData = job.info.yData;
+        info.x2Data = job.info.x2Data;
+        info.y2Data = job.info.y2Data;
+        info.derivData = job.info.derivData;
+        info.renewDataId();
+        m_liveCurves[name] = job.series;
+        if(name == m_currentDisplayedCurve) displayedChanged = true;
+    }
+    if(displayedChanged) refreshDisplayedCurve();
 
-            cw->getPlot()->rescaleAxes();
-            cw->getPlot()->replot();
+    if(!m_pendingChanges.isEmpty()) {
+        const DataChangeSet next = m_pendingChanges;
+        m_pendingChanges = DataChangeSet();
+        startLiveCurveUpdate(next);
+    }
+}
 
-            w->show();
-            m_openedWindows.append(w);
-        } else {
-            ui->customPlot->setChartMode(ChartWidget::Mode_Single);
-            ui->customPlot->getPlot()->xAxis->setLabel("Time");
-            ui->customPlot->getPlot()->yAxis->setLabel("Pressure & Derivative");
+void WT_PlottingWidget::refreshDisplayedCurve()
+{
+    const QList<QListWidgetItem*> items = ui->listWidget_Curves->findItems(m_currentDisplayedCurve, Qt::MatchExactly);
+    if(items.isEmpty()) return;
 
-            drawDerivativePlot(info);
-            m_currentDisplayedCurve = info.name;
-        }
+    // 重画会重设坐标范围：先记下用户当前的缩放
+    MouseZoom* plot = ui->customPlot->getPlot();
+    QList<QPair<QCPAxis*, QCPRange>> ranges;
+    for(QCPAxisRect* rect : plot->axisRects()) {
+        for(QCPAxis* axis : rect->axes()) ranges.append(qMakePair(axis, axis->range()));
     }
+    plot->clearGraphs();
+    on_listWidget_Curves_itemDoubleClicked(items.first());
+    for(const QPair<QCPAxis*, QCPRange>& range : ranges) range.first->setRange(range.second);
+    plot->replot();
 }
 
 // ---------------- 绘图具体实现 ----------------
@@ -521,7 +930,7 @@ void WT_PlottingWidget::addCurveToPlot(const CurveInfo& info)
 
     QCPGraph* graph = plot->addGraph();
     graph->setName(info.legendName);
-    graph->setData(info.xData, info.yData);
+    GraphDecimator::setGraphData(graph, info.xData, info.yData);
     graph->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
     // 【修复】尊重弹窗中选择的线型 (info.lineStyle)
@@ -541,7 +950,7 @@ void WT_PlottingWidget::drawStackedPlot(const CurveInfo& info)
     if (!topRect || !bottomRect) return;
 
     m_graphPress = plot->addGraph(topRect->axis(QCPAxis::atBottom), topRect->axis(QCPAxis::atLeft));
-    m_graphPress->setData(info.xData, info.yData);
+    GraphDecimator::setGraphData(m_graphPress, info.xData, info.yData);
     m_graphPress->setName(info.legendName);
     m_graphPress->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
@@ -573,7 +982,7 @@ void WT_PlottingWidget::drawStackedPlot(const CurveInfo& info)
         m_graphProd->setPen(QPen(info.prodColor, 2));
         m_graphProd->setLineStyle(QCPGraph::lsNone);
     }
-    m_graphProd->setData(px, py);
+    GraphDecimator::setGraphData(m_graphProd, px, py);
     m_graphProd->setName(info.prodLegendName);
 
     m_graphPress->rescaleAxes();
@@ -587,12 +996,12 @@ void WT_PlottingWidget::drawDerivativePlot(const CurveInfo& info)
 
     QCPGraph* g1 = plot->addGraph();
     g1->setName(info.legendName);
-    g1->setData(info.xData, info.yData);
+    GraphDecimator::setGraphData(g1, info.xData, info.yData);
     g1->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
     QCPGraph* g2 = plot->addGraph();
     g2->setName(info.prodLegendName);
-    g2->setData(info.xData, info.derivData);
+    GraphDecimator::setGraphData(g2, info.xData, info.derivData);
     g2->setScatterStyle(QCPScatterStyle(info.derivShape, info.derivPointColor, info.derivPointColor, 6));
 
     // 【修复】尊重弹窗线型
@@ -610,6 +1019,7 @@ void WT_PlottingWidget::on_listWidget_Curves_itemDoubleClicked(QListWidgetItem *
 {
     QString name = item->text();
     if(!m_curves.contains(name)) return;
+    ensureCurveData(m_curves[name]);
     CurveInfo info = m_curves[name];
     m_currentDisplayedCurve = name;
     ui->customPlot->setTitle(name);
@@ -707,42 +1117,53 @@ void WT_PlottingWidget::executeExport(bool fullRange, double start, double end)
     QString name = m_projectPath + "/export.csv";
     QString file = QFileDialog::getSaveFileName(this, "保存", name, "CSV Files (*.csv);;Excel Files (*.xls);;Text Files (*.txt)");
     if(file.isEmpty()) return;
-    QFile f(file);
-    if(!f.open(QIODevice::WriteOnly | QIODevice::Text)) return;
-    QTextStream out(&f);
-    QString sep = ",";
-    if(file.endsWith(".txt") || file.endsWith(".xls")) sep = "\t";
+    char sep = ',';
+    if(file.endsWith(".txt") || file.endsWith(".xls")) sep = '\t';
 
     CurveInfo& info = m_curves[m_currentDisplayedCurve];
-
-    if(ui->customPlot->getChartMode() == ChartWidget::Mode_Stacked) {
-        out << (fullRange ? "Time,P,Q\n" : "AdjTime,P,Q,OrigTime\n");
-        for(int i=0; i<info.xData.size(); ++i) {
-            double t = info.xData[i];
-            if(!fullRange && (t < start || t > end)) continue;
-            double p = info.yData[i];
-            double q = getProductionValueAt(t, info);
-            if(fullRange) out << t << sep << p << sep << q << "\n";
-            else out << (t-start) << sep << p << sep << q << sep << t << "\n";
+    ensureCurveData(info);
+
+    // 界面线程只挑出导出范围内的行，格式化与写盘在后台进行
+    const bool stacked = ui->customPlot->getChartMode() == ChartWidget::Mode_Stacked;
+    const int n = qMin(info.xData.size(), info.yData.size());
+    QVector<double> ts, vs, qs, origTs;
+    if(fullRange) {
+        ts = info.xData.mid(0, n);
+        vs = info.yData.mid(0, n);
+        if(stacked) {
+            qs.reserve(n);
+            for(int i=0; i<n; ++i) qs.append(getProductionValueAt(ts[i], info));
         }
     } else {
-        out << (fullRange ? "Time,Value\n" : "AdjTime,Value,OrigTime\n");
-        for(int i=0; i<info.xData.size(); ++i) {
+        for(int i=0; i<n; ++i) {
             double t = info.xData[i];
-            if(!fullRange && (t < start || t > end)) continue;
-            double val = info.yData[i];
-            if(fullRange) out << t << sep << val << "\n";
-            else out << (t-start) << sep << val << sep << t << "\n";
+            if(t < start || t > end) continue;
+            ts.append(t - start);
+            vs.append(info.yData[i]);
+            if(stacked) qs.append(getProductionValueAt(t, info));
+            origTs.append(t);
         }
     }
-    f.close();
-    QMessageBox msg(this);
-    msg.setWindowTitle("成功");
-    msg.setText("导出完成。");
-    msg.setIcon(QMessageBox::Information);
-    msg.setStandardButtons(QMessageBox::Ok);
-    applyDialogStyle(&msg);
-    msg.exec();
+
+    QVector<CsvExporter::Column> columns;
+    columns.append({fullRange ? "Time" : "AdjTime", ts});
+    if(stacked) {
+        columns.append({"P", vs});
+        columns.append({"Q", qs});
+    } else {
+        columns.append({"Value", vs});
+    }
+    if(!fullRange) columns.append({"OrigTime", origTs});
+
+    CsvExportDialog::start(this, file, columns, sep, 6, [this](const QString& error) {
+        QMessageBox msg(this);
+        msg.setWindowTitle(error.isEmpty() ? "成功" : "错误");
+        msg.setText(error.isEmpty() ? "导出完成。" : error);
+        msg.setIcon(error.isEmpty() ? QMessageBox::Information : QMessageBox::Warning);
+        msg.setStandardButtons(QMessageBox::Ok);
+        applyDialogStyle(&msg);
+        msg.exec();
+    });
 }
 
 double WT_PlottingWidget::getProductionValueAt(double t, const CurveInfo& info) {
@@ -791,16 +1212,11 @@ void WT_PlottingWidget::on_btn_Manage_clicked() {
         info.lineStyle = dlg.getLineStyle1(); info.lineColor = dlg.getLineColor1();
 
         if(info.type == 0) {
-            info.xData.clear(); info.yData.clear();
-            for(int i=0; i<m_dataModel->rowCount(); ++i) {
-                double xVal = m_dataModel->item(i, info.xCol)->text().toDouble();
-                double yVal = m_dataModel->item(i, info.yCol)->text().toDouble();
-                if (xVal > 1e-9 && yVal > 1e-9) {
-                    info.xData.append(xVal);
-                    info.yData.append(yVal);
-                }
-            }
+            buildSimpleCurve(info, m_dataModel->columnValues(info.xCol), m_dataModel->columnValues(info.yCol));
+            info.renewDataId();
         }
+        // 列可能已改变：导数序列缓存在下次表格修改时重建
+        if(m_liveCurves.contains(name)) m_liveCurves[name] = DerivativeSeries();
 
         if (hasSecond) {
             if (info.type == 1) {
@@ -831,6 +1247,7 @@ void WT_PlottingWidget::on_btn_Delete_clicked() {
 
     if(msgBox.exec() == QMessageBox::Yes) {
         m_curves.remove(name);
+        m_liveCurves.remove(name);
         delete item;
         if(m_currentDisplayedCurve == name) {
             ui->customPlot->getPlot()->clearGraphs();
@@ -845,7 +1262,12 @@ void WT_PlottingWidget::on_btn_Save_clicked() { saveProjectData(); }
 void WT_PlottingWidget::clearAllPlots()
 {
     m_curves.clear();
+    m_liveCurves.clear();
+    m_pendingChanges = DataChangeSet();
+    m_curveFile.close();
     m_currentDisplayedCurve.clear();
+    m_projectDataPending = false;
+    m_waitingForProjectData = false;
     ui->listWidget_Curves->clear();
     qDeleteAll(m_openedWindows);
     m_openedWindows.clear();
@@ -5,17 +5,28 @@
  * 1. 管理试井分析曲线的创建、显示、修改和删除。
  * 2. 与 ChartWidget 交互，管理绘图逻辑。
  * 3. 强制黑字白底样式，优化左侧功能布局。
+ * 4. 曲线数组保存在 _chart.wtd 中，打开项目时只映射文件，曲线首次显示时才取出数组。
+ * 5. 本次会话中由表格列生成的曲线跟随表格修改：合并后的修改在后台只重算用到被修改列的曲线，
+ *    导数曲线只改了压力单元格时就地更新受影响的点。
+ * 6. 反卷积分析：由长期压力与产量记录求恒定参考产量下的 Δp 与导数曲线 (RateDeconvolution)，不跟随表格修改。
  */
 
 #ifndef WT_PLOTTINGWIDGET_H
 #define WT_PLOTTINGWIDGET_H
 
 #include <QWidget>
-#include <QStandardItemModel>
 #include <QMap>
 #include <QListWidgetItem>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QPushButton>
 #include "chartwidget.h"
 #include "chartwindow.h"
+#include "curvedatafile.h"
+#include "datachangetracker.h"
+#include "derivativeseries.h"
+#include "measurementtablemodel.h"
+#include "signalfilter.h"
 
 // 曲线配置结构体
 struct CurveInfo {
@@ -43,14 +54,27 @@ struct CurveInfo {
     double LSpacing;
     bool isSmooth;
     int smoothFactor;
+    int smoothMethod;      // SignalFilter::Method
+    double smoothWindow;   // 对数时间平均的窗口宽度 (对数周期)
     QVector<double> derivData;
     QCPScatterStyle::ScatterShape derivShape;
     QColor derivPointColor;
     Qt::PenStyle derivLineStyle;
     QColor derivLineColor;
 
+    // 曲线数组不写入 JSON：按 dataId 存放在 _chart.wtd 中，数组重新生成后需换用新的 dataId
+    // 从项目读取的曲线在首次使用前数组为空 (dataLoaded 为 false)
+    QString dataId;
+    bool dataLoaded = true;
+
     QJsonObject toJson() const;
     static CurveInfo fromJson(const QJsonObject& json);
+    // 数组已在内存中重新生成：换用新的 dataId
+    void renewDataId();
+    // 按 _chart.wtd 中的名称列出本曲线的数组
+    void collectArrays(QMap<QString, QVector<double>>& out) const;
+    // 从已映射的 _chart.wtd 取出本曲线的数组，缺少任一数组时返回 false
+    bool loadArrays(const CurveDataFile& file);
 };
 
 namespace Ui {
@@ -65,17 +89,27 @@ public:
     explicit WT_PlottingWidget(QWidget *parent = nullptr);
     ~WT_PlottingWidget();
 
-    void setDataModel(QStandardItemModel* model);
+    void setDataModel(MeasurementTableModel* model);
     void setProjectPath(const QString& path);
 
+    // 打开项目时调用：界面可见时才请求读取绘图数据，未显示过的页面推迟到首次显示
     void loadProjectData();
     void saveProjectData();
+    // 不弹提示地把曲线列表提交给项目保存；项目绘图数据尚未加载时不提交
+    void commitProjectData();
     void clearAllPlots();
 
+    // 表格修改 (已合并) 后重算跟随表格的曲线；后台重算进行中时合并到下一轮
+    void applyDataChanges(const DataChangeSet& changes);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private slots:
     void on_btn_NewCurve_clicked();
     void on_btn_PressureRate_clicked();
     void on_btn_Derivative_clicked();
+    void on_btn_Deconvolution_clicked();
 
     void on_listWidget_Curves_itemDoubleClicked(QListWidgetItem *item);
 
@@ -86,9 +120,16 @@ private slots:
     void onExportDataTriggered();
     void onGraphClicked(QCPAbstractPlottable *plottable, int dataIndex, QMouseEvent *event);
 
+    // 项目绘图数据后台读取完成
+    void onProjectPlottingDataReady();
+    // 压力产量、导数、反卷积曲线后台计算完成
+    void onCurveTaskFinished();
+    // 跟随表格的曲线后台重算完成
+    void onLiveCurvesUpdated();
+
 private:
     Ui::WT_PlottingWidget *ui;
-    QStandardItemModel* m_dataModel;
+    MeasurementTableModel* m_dataModel;
     QString m_projectPath;
 
     QMap<QString, CurveInfo> m_curves;
@@ -104,10 +145,58 @@ private:
     QCPGraph* m_graphPress;
     QCPGraph* m_graphProd;
 
+    bool m_projectDataPending; // 项目绘图数据尚未请求 (等待页面首次显示)
+    bool m_waitingForProjectData; // 已请求，等待后台读取完成
+
+    // 项目的 _chart.wtd 映射，曲线数组按需从中取出；保存前解除映射
+    CurveDataFile m_curveFile;
+    // 确保曲线数组已读入 (映射已关闭时重新打开)；数据缺失时数组保持为空并返回 false
+    bool ensureCurveData(CurveInfo& info);
+
     void addCurveToPlot(const CurveInfo& info);
     void drawStackedPlot(const CurveInfo& info);
     void drawDerivativePlot(const CurveInfo& info);
 
+    // 后台曲线计算：列数据由界面线程取出，任务只读写自己的副本
+    QFutureWatcher<CurveInfo> m_curveWatcher;
+    QPushButton* m_curveTaskButton;    // 显示进度的按钮，完成后恢复原文字
+    QString m_curveTaskButtonText;
+    bool m_curveTaskNewWindow;         // 完成后在新窗口中显示
+    bool m_curveTaskFollowTable;       // 完成后的曲线跟随表格修改
+    QString m_curveTaskError;          // 后台计算失败的原因 (界面线程读取)
+    void startCurveTask(QPushButton* button, bool newWindow, const QFuture<CurveInfo>& future, bool followTable = true);
+    static void buildPressureRateCurve(QPromise<CurveInfo>& promise, CurveInfo info,
+                                       const QVector<double>& xs, const QVector<double>& ys,
+                                       const QVector<double>& x2s, const QVector<double>& y2s);
+    static void buildDerivativeCurve(QPromise<CurveInfo>& promise, CurveInfo info,
+                                     const QVector<double>& ts, const QVector<double>& ps);
+    // 反卷积：结果曲线的 xData/yData/derivData 为响应的时间、Δp 与导数；失败时 xData 为空，原因写入 error
+    static void buildDeconvolutionCurve(QPromise<CurveInfo>& promise, CurveInfo info,
+                                        const QVector<double>& ts, const QVector<double>& ps,
+                                        const QVector<double>& qts, const QVector<double>& qs, QString* error);
+    void showAnalysisCurve(const CurveInfo& info);
+    void openCurveWindow(const CurveInfo& info);
+    static void buildSimpleCurve(CurveInfo& info, const QVector<double>& xs, const QVector<double>& ys);
+    static DerivativeSeries::Settings derivativeSettings(const CurveInfo& info);
+    static SignalFilter::Options smoothingOptions(const CurveInfo& info);
+
+    // 跟随表格的曲线 (曲线名 -> 导数序列缓存，非导数曲线与尚未重算过的导数曲线为空序列)；
+    // 从项目读取的曲线与独立窗口中的曲线不跟随表格
+    struct LiveCurveJob {
+        CurveInfo info;
+        DerivativeSeries series;
+        bool incremental = false;            // 导数曲线只改了压力单元格：就地更新
+        QVector<QPair<int, double>> cells;   // 就地更新：被修改的压力单元格 (行号, 新值)
+        QVector<double> xs, ys, x2s, y2s;    // 整段重算：曲线用到的列
+    };
+    QMap<QString, DerivativeSeries> m_liveCurves;
+    QFutureWatcher<QVector<LiveCurveJob>> m_liveWatcher;
+    DataChangeSet m_pendingChanges;          // 重算进行中到达的修改
+    void startLiveCurveUpdate(const DataChangeSet& changes);
+    static void runLiveCurveJob(LiveCurveJob& job);
+    // 重画主图中的当前曲线，保留坐标范围
+    void refreshDisplayedCurve();
+
     void executeExport(bool fullRange, double start = 0, double end = 0);
     double getProductionValueAt(double t, const CurveInfo& info);
     QListWidgetItem* getCurrentSelectedItem();
@@ -0,0 +1,780 @@
+/*
+ * 文件名: xlsxreader.cpp
+ * 文件作用: Excel 工作簿 (.xlsx) 内置读取器实现
+ * 功能描述:
+ * 1. ZipArchive：内存映射 ZIP 文件，解析中央目录，按名称取出条目 (存储或 DEFLATE 压缩)。
+ * 2. Inflater：RFC 1951 DEFLATE 解码，输出缓冲区写满即停止，供预览只解压开头部分。
+ * 3. 解析 workbook.xml、关系表、sharedStrings.xml、styles.xml，确定第一个工作表和日期样式。
+ * 4. 用 QXmlStreamReader 逐行扫描工作表 XML，数值列写入 double 缓冲区，文本列保留字符串。
+ */
+
+#include "xlsxreader.h"
+#include <QFile>
+#include <QHash>
+#include <QDate>
+#include <QTime>
+#include <QXmlStreamReader>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// DEFLATE 解码
+// ---------------------------------------------------------------------------
+
+// 快速查表的位数，更长的码字走逐位解码
+const int kFastBits = 10;
+
+// 规范哈夫曼码表
+struct Huffman {
+    quint16 fast[1 << kFastBits];   // 以低位优先的位串为下标：(码长 << 9) | 符号，0 表示查不到
+    quint16 count[16];              // 各码长的码字个数
+    quint16 symbol[320];            // 按码长、符号值排序的符号
+
+    // 由各符号码长构造码表；码长超额时返回 false，不完整的码允许存在
+    bool build(const quint8* lengths, int n)
+    {
+        std::memset(count, 0, sizeof(count));
+        for (int i = 0; i < n; ++i) count[lengths[i]]++;
+        count[0] = 0;
+
+        int left = 1;
+        for (int len = 1; len <= 15; ++len) {
+            left <<= 1;
+            left -= count[len];
+            if (left < 0) return false;
+        }
+
+        quint16 offs[16];
+        offs[1] = 0;
+        for (int len = 1; len < 15; ++len) offs[len + 1] = quint16(offs[len] + count[len]);
+        for (int i = 0; i < n; ++i) {
+            if (lengths[i]) symbol[offs[lengths[i]]++] = quint16(i);
+        }
+
+        std::memset(fast, 0, sizeof(fast));
+        int code = 0;
+        int index = 0;
+        for (int len = 1; len <= kFastBits; ++len) {
+            for (int k = 0; k < count[len]; ++k, ++code, ++index) {
+                // 规范码按高位优先分配，位流按低位优先读取，填表前反转位序
+                int rev = 0;
+                for (int b = 0; b < len; ++b) {
+                    if (code & (1 << b)) rev |= 1 << (len - 1 - b);
+                }
+                quint16 entry = quint16((len << 9) | symbol[index]);
+                for (int f = rev; f < (1 << kFastBits); f += 1 << len) fast[f] = entry;
+            }
+            code <<= 1;
+        }
+        return true;
+    }
+};
+
+const quint16 kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const quint8 kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const quint16 kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                8193, 12289, 16385, 24577};
+const quint8 kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+class Inflater
+{
+public:
+    Inflater(const uchar* in, qint64 inSize, char* out, qint64 outSize)
+        : m_in(in), m_inSize(inSize), m_inPos(0), m_bitBuf(0), m_bitCount(0),
+          m_out(out), m_outSize(outSize), m_outPos(0)
+    {
+    }
+
+    // 返回解码得到的字节数，数据损坏时返回 -1；输出缓冲区写满即停止
+    qint64 run()
+    {
+        int last = 0;
+        do {
+            if (m_inPos > m_inSize + 8) return -1;
+            last = int(bits(1));
+            int type = int(bits(2));
+            int status;
+            if (type == 0) status = stored();
+            else if (type == 1) status = fixed();
+            else if (type == 2) status = dynamic();
+            else return -1;
+
+            if (status < 0) return -1;
+            if (status > 0) break; // 输出已满
+        } while (!last);
+        return m_outPos;
+    }
+
+private:
+    const uchar* m_in;
+    qint64 m_inSize;
+    qint64 m_inPos;
+    quint64 m_bitBuf;
+    int m_bitCount;
+    char* m_out;
+    qint64 m_outSize;
+    qint64 m_outPos;
+
+    // 补足位缓冲；越过输入末尾时补 0，由 run() 中的越界检查终止
+    inline void refill()
+    {
+        while (m_bitCount <= 56) {
+            quint64 b = m_inPos < m_inSize ? m_in[m_inPos] : 0;
+            ++m_inPos;
+            m_bitBuf |= b << m_bitCount;
+            m_bitCount += 8;
+        }
+    }
+
+    inline quint32 bits(int n)
+    {
+        if (n == 0) return 0;
+        if (m_bitCount < n) refill();
+        quint32 v = quint32(m_bitBuf & ((quint64(1) << n) - 1));
+        m_bitBuf >>= n;
+        m_bitCount -= n;
+        return v;
+    }
+
+    inline int decode(const Huffman& h)
+    {
+        if (m_bitCount < 15) refill();
+        quint16 e = h.fast[m_bitBuf & ((1 << kFastBits) - 1)];
+        if (e) {
+            int len = e >> 9;
+            m_bitBuf >>= len;
+            m_bitCount -= len;
+            return e & 511;
+        }
+
+        // 长码字：逐位比较规范码区间
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len <= 15; ++len) {
+            code |= int((m_bitBuf >> (len - 1)) & 1);
+            int c = h.count[len];
+            if (code - c < first) {
+                m_bitBuf >>= len;
+                m_bitCount -= len;
+                return h.symbol[index + (code - first)];
+            }
+            index += c;
+            first += c;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    // 存储块：丢弃到字节边界，把位缓冲中尚未使用的整字节退回输入
+    int stored()
+    {
+        bits(m_bitCount & 7);
+        m_inPos -= m_bitCount / 8;
+        m_bitBuf = 0;
+        m_bitCount = 0;
+
+        if (m_inPos + 4 > m_inSize) return -1;
+        quint32 len = quint32(m_in[m_inPos]) | (quint32(m_in[m_inPos + 1]) << 8);
+        quint32 nlen = quint32(m_in[m_inPos + 2]) | (quint32(m_in[m_inPos + 3]) << 8);
+        m_inPos += 4;
+        if (len != (~nlen & 0xFFFF)) return -1;
+        if (m_inPos + len > m_inSize) return -1;
+
+        qint64 n = qMin<qint64>(len, m_outSize - m_outPos);
+        std::memcpy(m_out + m_outPos, m_in + m_inPos, size_t(n));
+        m_outPos += n;
+        m_inPos += len;
+        return n < qint64(len) ? 1 : 0;
+    }
+
+    int codes(const Huffman& lit, const Huffman& dist)
+    {
+        for (;;) {
+            int sym = decode(lit);
+            if (sym < 0) return -1;
+            if (sym < 256) {
+                if (m_outPos >= m_outSize) return 1;
+                m_out[m_outPos++] = char(sym);
+            } else if (sym == 256) {
+                return 0;
+            } else {
+                sym -= 257;
+                if (sym >= 29) return -1;
+                int len = kLengthBase[sym] + int(bits(kLengthExtra[sym]));
+                int ds = decode(dist);
+                if (ds < 0 || ds >= 30) return -1;
+                qint64 d = kDistBase[ds] + qint64(bits(kDistExtra[ds]));
+                if (d > m_outPos) return -1;
+
+                qint64 n = qMin<qint64>(len, m_outSize - m_outPos);
+                const char* src = m_out + m_outPos - d;
+                char* dst = m_out + m_outPos;
+                for (qint64 i = 0; i < n; ++i) dst[i] = src[i]; // 允许源与目标重叠
+                m_outPos += n;
+                if (n < len) return 1;
+            }
+            if (m_inPos > m_inSize + 8) return -1;
+        }
+    }
+
+    int fixed()
+    {
+        static Huffman lit, dist;
+        static bool ready = [] {
+            quint8 lengths[288];
+            int i = 0;
+            for (; i < 144; ++i) lengths[i] = 8;
+            for (; i < 256; ++i) lengths[i] = 9;
+            for (; i < 280; ++i) lengths[i] = 7;
+            for (; i < 288; ++i) lengths[i] = 8;
+            lit.build(lengths, 288);
+            for (i = 0; i < 30; ++i) lengths[i] = 5;
+            dist.build(lengths, 30);
+            return true;
+        }();
+        Q_UNUSED(ready);
+        return codes(lit, dist);
+    }
+
+    int dynamic()
+    {
+        static const quint8 order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        int nlen = int(bits(5)) + 257;
+        int ndist = int(bits(5)) + 1;
+        int ncode = int(bits(4)) + 4;
+        if (nlen > 286 || ndist > 30) return -1;
+
+        quint8 lengths[320] = {0};
+        for (int i = 0; i < ncode; ++i) lengths[order[i]] = quint8(bits(3));
+
+        Huffman lencode;
+        if (!lencode.build(lengths, 19)) return -1;
+
+        int index = 0;
+        std::memset(lengths, 0, sizeof(lengths));
+        while (index < nlen + ndist) {
+            int sym = decode(lencode);
+            if (sym < 0) return -1;
+            if (sym < 16) {
+                lengths[index++] = quint8(sym);
+                continue;
+            }
+            quint8 len = 0;
+            int rep;
+            if (sym == 16) {
+                if (index == 0) return -1;
+                len = lengths[index - 1];
+                rep = 3 + int(bits(2));
+            } else if (sym == 17) {
+                rep = 3 + int(bits(3));
+            } else {
+                rep = 11 + int(bits(7));
+            }
+            if (index + rep > nlen + ndist) return -1;
+            while (rep--) lengths[index++] = len;
+        }
+        if (lengths[256] == 0) return -1;
+
+        Huffman lit, dist;
+        if (!lit.build(lengths, nlen) || !dist.build(lengths + nlen, ndist)) return -1;
+        return codes(lit, dist);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// ZIP 容器
+// ---------------------------------------------------------------------------
+
+inline quint16 readU16(const uchar* p) { return quint16(p[0] | (p[1] << 8)); }
+inline quint32 readU32(const uchar* p) { return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24); }
+
+class ZipArchive
+{
+public:
+    bool open(const QString& path, QString* errorMessage)
+    {
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            if (errorMessage) *errorMessage = "无法打开文件: " + path;
+            return false;
+        }
+        m_size = m_file.size();
+        if (m_size > 0) m_data = m_file.map(0, m_size);
+        if (!m_data) {
+            m_fallback = m_file.readAll();
+            m_data = reinterpret_cast<const uchar*>(m_fallback.constData());
+            m_size = m_fallback.size();
+        }
+
+        // 从文件尾向前查找中央目录结束记录 (其后最多跟 64KB 注释)
+        qint64 eocd = -1;
+        for (qint64 i = m_size - 22; i >= 0 && i >= m_size - 22 - 65535; --i) {
+            if (readU32(m_data + i) == 0x06054b50) { eocd = i; break; }
+        }
+        if (eocd < 0) {
+            if (errorMessage) *errorMessage = "文件不是有效的 XLSX 工作簿。";
+            return false;
+        }
+
+        int entryCount = readU16(m_data + eocd + 10);
+        qint64 pos = readU32(m_data + eocd + 16);
+        for (int i = 0; i < entryCount; ++i) {
+            if (pos + 46 > m_size || readU32(m_data + pos) != 0x02014b50) break;
+            Entry e;
+            e.method = readU16(m_data + pos + 10);
+            e.compressedSize = readU32(m_data + pos + 20);
+            e.size = readU32(m_data + pos + 24);
+            e.localOffset = readU32(m_data + pos + 42);
+            int nameLen = readU16(m_data + pos + 28);
+            int extraLen = readU16(m_data + pos + 30);
+            int commentLen = readU16(m_data + pos + 32);
+            if (pos + 46 + nameLen > m_size) break;
+            QString name = QString::fromUtf8(reinterpret_cast<const char*>(m_data + pos + 46), nameLen);
+            m_entries.insert(name, e);
+            pos += 46 + nameLen + extraLen + commentLen;
+        }
+        return true;
+    }
+
+    bool contains(const QString& name) const { return m_entries.contains(name); }
+
+    // 读取条目内容；maxBytes >= 0 时只解压前 maxBytes 字节
+    QByteArray read(const QString& name, qint64 maxBytes = -1) const
+    {
+        auto it = m_entries.constFind(name);
+        if (it == m_entries.constEnd()) return QByteArray();
+        const Entry& e = it.value();
+
+        qint64 local = e.localOffset;
+        if (local + 30 > m_size || readU32(m_data + local) != 0x04034b50) return QByteArray();
+        qint64 dataPos = local + 30 + readU16(m_data + local + 26) + readU16(m_data + local + 28);
+        if (dataPos + qint64(e.compressedSize) > m_size) return QByteArray();
+
+        qint64 outSize = e.size;
+        if (maxBytes >= 0) outSize = qMin(outSize, maxBytes);
+
+        if (e.method == 0) {
+            return QByteArray(reinterpret_cast<const char*>(m_data + dataPos), int(qMin<qint64>(outSize, e.compressedSize)));
+        }
+        if (e.method != 8) return QByteArray();
+
+        QByteArray out(int(outSize), Qt::Uninitialized);
+        Inflater inflater(m_data + dataPos, e.compressedSize, out.data(), outSize);
+        qint64 n = inflater.run();
+        if (n < 0) return QByteArray();
+        out.resize(int(n));
+        return out;
+    }
+
+private:
+    struct Entry {
+        quint16 method;
+        quint32 compressedSize;
+        quint32 size;
+        quint32 localOffset;
+    };
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    QByteArray m_fallback;
+    QHash<QString, Entry> m_entries;
+};
+
+// ---------------------------------------------------------------------------
+// 工作簿辅助函数
+// ---------------------------------------------------------------------------
+
+// 单元格数字格式的日期类别
+enum DateKind : char { NotDate = 0, DateOnly, TimeOnly, DateTime };
+
+// 内置数字格式编号对应的日期类别 (含中文版 Excel 的区域日期格式)
+DateKind builtinDateKind(int id)
+{
+    if ((id >= 14 && id <= 17) || (id >= 27 && id <= 31) || id == 36 || (id >= 50 && id <= 58)) return DateOnly;
+    if ((id >= 18 && id <= 21) || (id >= 32 && id <= 35) || (id >= 45 && id <= 47)) return TimeOnly;
+    if (id == 22) return DateTime;
+    return NotDate;
+}
+
+// 自定义格式串的日期类别：去掉引号文本、方括号区段和转义字符后检查 y/d/h/s 占位符
+DateKind customDateKind(const QString& formatCode)
+{
+    bool hasDate = false, hasTime = false, hasMonthOrMinute = false;
+    bool inQuote = false;
+    for (int i = 0; i < formatCode.size(); ++i) {
+        QChar ch = formatCode[i];
+        if (inQuote) { if (ch == '"') inQuote = false; continue; }
+        if (ch == '"') { inQuote = true; continue; }
+        if (ch == '\\' || ch == '_' || ch == '*') { ++i; continue; }
+        if (ch == '[') {
+            // [h]、[mm]、[ss] 为累计时间，其余方括号 (颜色、区域) 忽略
+            int close = formatCode.indexOf(']', i);
+            if (close < 0) break;
+            QString inner = formatCode.mid(i + 1, close - i - 1).toLower();
+            if (!inner.isEmpty() && (inner[0] == 'h' || inner[0] == 'm' || inner[0] == 's')) hasTime = true;
+            i = close;
+            continue;
+        }
+        QChar c = ch.toLower();
+        if (c == 'y' || c == 'd') hasDate = true;
+        else if (c == 'h' || c == 's') hasTime = true;
+        else if (c == 'm') hasMonthOrMinute = true;
+    }
+    if (hasMonthOrMinute && !hasTime) hasDate = true; // 单独出现的 m 为月份
+    if (hasDate && hasTime) return DateTime;
+    if (hasDate) return DateOnly;
+    if (hasTime) return TimeOnly;
+    return NotDate;
+}
+
+// Excel 序列日期转文本；日期部分以 1899-12-30 (或 1904 日期系统的 1904-01-01) 为零点，时间按秒取整
+QString formatSerialDate(double serial, DateKind kind, bool date1904)
+{
+    double days = std::floor(serial);
+    qint64 seconds = qint64(std::llround((serial - days) * 86400.0));
+    if (seconds >= 86400) { days += 1; seconds -= 86400; }
+
+    QDate base = date1904 ? QDate(1904, 1, 1) : QDate(1899, 12, 30);
+    QDate date = base.addDays(qint64(days));
+    QTime time = QTime(0, 0).addSecs(int(seconds));
+
+    if (kind == DateOnly) return date.toString("yyyy-MM-dd");
+    if (kind == TimeOnly) return time.toString("hh:mm:ss");
+    return date.toString("yyyy-MM-dd") + " " + time.toString("hh:mm:ss");
+}
+
+// 单元格引用 (如 "AB12") 的列号，从 0 开始；无法解析时返回 -1
+int columnFromRef(QStringView ref)
+{
+    int col = 0;
+    int i = 0;
+    for (; i < ref.size(); ++i) {
+        QChar ch = ref[i];
+        if (ch >= 'A' && ch <= 'Z') col = col * 26 + (ch.unicode() - 'A' + 1);
+        else if (ch >= 'a' && ch <= 'z') col = col * 26 + (ch.unicode() - 'a' + 1);
+        else break;
+    }
+    return i == 0 ? -1 : col - 1;
+}
+
+// 关系目标路径转为 ZIP 条目名：以 '/' 开头为包内绝对路径，否则相对于 xl/
+QString resolveTarget(const QString& target)
+{
+    if (target.startsWith('/')) return target.mid(1);
+    return "xl/" + target;
+}
+
+// 包含命名空间前缀的属性 (如 r:id) 按本地名查找
+QString attributeByLocalName(const QXmlStreamAttributes& attrs, const QString& localName)
+{
+    for (const QXmlStreamAttribute& a : attrs) {
+        if (a.name() == localName) return a.value().toString();
+    }
+    return QString();
+}
+
+// 数值解析：与文本导入一致，容许首尾空白
+bool parseNumber(const QString& text, double& value)
+{
+    bool ok = false;
+    value = text.trimmed().toDouble(&ok);
+    return ok;
+}
+
+} // namespace
+
+struct XlsxReader::Workbook {
+    ZipArchive archive;
+    QStringList sharedStrings;
+    QVector<char> styleDateKinds;   // 按单元格样式 (cellXfs) 下标的日期类别
+    bool date1904 = false;
+    QByteArray sheetXml;            // 第一个工作表的 XML (预览时只含开头部分)
+};
+
+XlsxReader::XlsxReader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool XlsxReader::isXlsxFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QByteArray magic = file.read(4);
+    return magic == QByteArray("PK\x03\x04", 4);
+}
+
+bool XlsxReader::openWorkbook(const QString& filePath, Workbook& book, qint64 maxSheetBytes, QString* errorMessage)
+{
+    if (!book.archive.open(filePath, errorMessage)) return false;
+
+    // 第一个工作表：workbook.xml 中的第一个 <sheet>，经关系表解析出条目名
+    QString sheetRelId;
+    {
+        QXmlStreamReader xml(book.archive.read("xl/workbook.xml"));
+        while (!xml.atEnd()) {
+            if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+            if (xml.name() == QLatin1String("workbookPr")) {
+                QString v = xml.attributes().value("date1904").toString();
+                book.date1904 = (v == "1" || v == "true");
+            } else if (xml.name() == QLatin1String("sheet") && sheetRelId.isEmpty()) {
+                sheetRelId = attributeByLocalName(xml.attributes(), "id");
+            }
+        }
+    }
+
+    QString sheetEntry;
+    if (!sheetRelId.isEmpty()) {
+        QXmlStreamReader xml(book.archive.read("xl/_rels/workbook.xml.rels"));
+        while (!xml.atEnd()) {
+            if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+            if (xml.name() == QLatin1String("Relationship") && xml.attributes().value("Id") == sheetRelId) {
+                sheetEntry = resolveTarget(xml.attributes().value("Target").toString());
+                break;
+            }
+        }
+    }
+    if (sheetEntry.isEmpty() || !book.archive.contains(sheetEntry)) sheetEntry = "xl/worksheets/sheet1.xml";
+    if (!book.archive.contains(sheetEntry)) {
+        if (errorMessage) *errorMessage = "工作簿中没有找到工作表。";
+        return false;
+    }
+
+    // 共享字符串表：每个 <si> 为一个字符串，富文本取所有 <t> 的拼接，忽略拼音注释 <rPh>
+    {
+        QXmlStreamReader xml(book.archive.read("xl/sharedStrings.xml"));
+        QString current;
+        int phonetic = 0;
+        while (!xml.atEnd()) {
+            QXmlStreamReader::TokenType token = xml.readNext();
+            if (token == QXmlStreamReader::StartElement) {
+                if (xml.name() == QLatin1String("si")) current.clear();
+                else if (xml.name() == QLatin1String("rPh")) ++phonetic;
+                else if (xml.name() == QLatin1String("t") && phonetic == 0) current += xml.readElementText();
+            } else if (token == QXmlStreamReader::EndElement) {
+                if (xml.name() == QLatin1String("si")) book.sharedStrings.append(current);
+                else if (xml.name() == QLatin1String("rPh")) --phonetic;
+            }
+        }
+    }
+
+    // 样式表：记录自定义数字格式，再按 cellXfs 顺序得到每个样式的日期类别
+    {
+        QXmlStreamReader xml(book.archive.read("xl/styles.xml"));
+        QHash<int, DateKind> customFormats;
+        bool inCellXfs = false;
+        while (!xml.atEnd()) {
+            QXmlStreamReader::TokenType token = xml.readNext();
+            if (token == QXmlStreamReader::StartElement) {
+                if (xml.name() == QLatin1String("numFmt")) {
+                    int id = xml.attributes().value("numFmtId").toInt();
+                    customFormats.insert(id, customDateKind(xml.attributes().value("formatCode").toString()));
+                } else if (xml.name() == QLatin1String("cellXfs")) {
+                    inCellXfs = true;
+                } else if (inCellXfs && xml.name() == QLatin1String("xf")) {
+                    int id = xml.attributes().value("numFmtId").toInt();
+                    DateKind kind = customFormats.contains(id) ? customFormats.value(id) : builtinDateKind(id);
+                    book.styleDateKinds.append(kind);
+                }
+            } else if (token == QXmlStreamReader::EndElement && xml.name() == QLatin1String("cellXfs")) {
+                inCellXfs = false;
+            }
+        }
+    }
+
+    book.sheetXml = book.archive.read(sheetEntry, maxSheetBytes);
+    if (book.sheetXml.isEmpty()) {
+        if (errorMessage) *errorMessage = "工作表数据损坏或使用了不支持的压缩方式。";
+        return false;
+    }
+    return true;
+}
+
+void XlsxReader::parseSheet(const Workbook& book, const std::function<bool(int, const QVector<Cell>&, qint64)>& onRow)
+{
+    QXmlStreamReader xml(book.sheetXml);
+    QVector<Cell> cells;
+    int rowIndex = -1;
+    int nextRow = 0;
+    int nextColumn = 0;
+
+    while (!xml.atEnd()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            if (xml.name() == QLatin1String("row")) {
+                // 行号属性 r 从 1 开始；缺省时按顺序递增
+                int r = xml.attributes().value("r").toInt();
+                rowIndex = r > 0 ? r - 1 : nextRow;
+                nextColumn = 0;
+                cells.clear();
+            } else if (xml.name() == QLatin1String("c")) {
+                QXmlStreamAttributes attrs = xml.attributes();
+                int column = columnFromRef(attrs.value("r"));
+                if (column < 0) column = nextColumn;
+                nextColumn = column + 1;
+                QString type = attrs.value("t").toString();
+                int style = attrs.value("s").toInt();
+
+                QString value;
+                QString inlineText;
+                while (!xml.atEnd()) {
+                    QXmlStreamReader::TokenType t = xml.readNext();
+                    if (t == QXmlStreamReader::StartElement) {
+                        if (xml.name() == QLatin1String("v")) value = xml.readElementText();
+                        else if (xml.name() == QLatin1String("t")) inlineText += xml.readElementText();
+                    } else if (t == QXmlStreamReader::EndElement && xml.name() == QLatin1String("c")) {
+                        break;
+                    }
+                }
+
+                Cell cell;
+                cell.column = column;
+                cell.isNumeric = false;
+                cell.number = 0.0;
+                if (type == QLatin1String("s")) {
+                    cell.text = book.sharedStrings.value(value.toInt());
+                } else if (type == QLatin1String("inlineStr")) {
+                    cell.text = inlineText;
+                } else if (type == QLatin1String("b")) {
+                    cell.text = (value == "1") ? "TRUE" : "FALSE";
+                } else if (type == QLatin1String("str") || type == QLatin1String("e")) {
+                    cell.text = value;
+                } else if (!value.isEmpty()) {
+                    double v = 0.0;
+                    if (parseNumber(value, v)) {
+                        DateKind kind = style >= 0 && style < book.styleDateKinds.size()
+                                            ? DateKind(book.styleDateKinds[style]) : NotDate;
+                        if (kind != NotDate) {
+                            cell.text = formatSerialDate(v, kind, book.date1904);
+                        } else {
+                            cell.isNumeric = true;
+                            cell.number = v;
+                        }
+                    } else {
+                        cell.text = value;
+                    }
+                }
+
+                // 文本型数字与文本导入一样按数值处理，空单元格 (只有样式) 不计入
+                if (!cell.isNumeric) {
+                    if (cell.text.trimmed().isEmpty()) continue;
+                    if (parseNumber(cell.text, cell.number)) cell.isNumeric = true;
+                }
+                cells.append(cell);
+            }
+        } else if (token == QXmlStreamReader::EndElement && xml.name() == QLatin1String("row")) {
+            nextRow = rowIndex + 1;
+            if (!onRow(rowIndex, cells, xml.characterOffset())) return;
+        }
+    }
+}
+
+TextDataTable XlsxReader::read(const DataImportSettings& settings)
+{
+    TextDataTable table;
+    emit progressUpdated(0, "正在解压工作簿...");
+
+    Workbook book;
+    if (!openWorkbook(settings.filePath, book, -1, &table.errorMessage)) return table;
+
+    int startIdx = settings.startRow - 1;
+    int headerIdx = settings.headerRow - 1;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const qint64 totalBytes = qMax<qint64>(1, book.sheetXml.size());
+    int rowCount = 0;
+
+    parseSheet(book, [&](int rowIndex, const QVector<Cell>& cells, qint64 offset) {
+        if (cells.isEmpty()) return true;
+        if ((rowIndex & 4095) == 0) {
+            emit progressUpdated(10 + int(85.0 * double(offset) / double(totalBytes)), "正在解析工作表...");
+        }
+
+        bool isHeader = settings.useHeader && rowIndex == headerIdx;
+        if (isHeader) {
+            QStringList headers;
+            for (const Cell& cell : cells) {
+                while (headers.size() < cell.column) headers.append(QString());
+                headers.append(cell.isNumeric ? QString::number(cell.number, 'g', 15) : cell.text);
+            }
+            table.headers = headers;
+            table.headerProcessed = true;
+            return true;
+        }
+        if (rowIndex < startIdx) return true;
+
+        for (const Cell& cell : cells) {
+            if (cell.column >= table.columns.size()) {
+                int oldCols = table.columns.size();
+                table.columns.resize(cell.column + 1);
+                for (int c = oldCols; c <= cell.column; ++c) table.columns[c].values.assign(rowCount, nan);
+            }
+            TextDataColumn& col = table.columns[cell.column];
+            if ((col.isNumeric ? col.values.size() : col.texts.size()) > size_t(rowCount)) continue; // 重复的单元格引用
+            if (col.isNumeric && !cell.isNumeric) {
+                // 出现文本单元格，已有数值转为文本后整列按文本处理
+                col.texts.reserve(col.values.size() + 1);
+                for (double v : col.values) col.texts.push_back(std::isnan(v) ? QString() : QString::number(v, 'g', 15));
+                col.values = std::vector<double>();
+                col.isNumeric = false;
+            }
+            if (col.isNumeric) {
+                col.values.resize(rowCount, nan);
+                col.values.push_back(cell.number);
+            } else {
+                col.texts.resize(rowCount);
+                col.texts.push_back(cell.isNumeric ? QString::number(cell.number, 'g', 15) : cell.text);
+            }
+        }
+        ++rowCount;
+        return true;
+    });
+
+    // 补齐末尾缺失的单元格，表头列多于数据列时补空列
+    if (table.columns.size() < table.headers.size()) {
+        int oldCols = table.columns.size();
+        table.columns.resize(table.headers.size());
+        for (int c = oldCols; c < table.columns.size(); ++c) table.columns[c].values.reserve(rowCount);
+    }
+    for (TextDataColumn& col : table.columns) {
+        if (col.isNumeric) col.values.resize(rowCount, nan);
+        else col.texts.resize(rowCount);
+    }
+    table.rowCount = rowCount;
+
+    emit progressUpdated(100, "读取完成");
+    table.success = true;
+    return table;
+}
+
+QList<QStringList> XlsxReader::readPreview(const QString& filePath, int maxRows, int maxCols, QString* errorMessage)
+{
+    QList<QStringList> rows;
+
+    // 预览只解压工作表开头，单元格 XML 每行通常不超过数 KB
+    Workbook book;
+    qint64 limit = qMax<qint64>(1 << 20, qint64(maxRows) * maxCols * 256);
+    if (!openWorkbook(filePath, book, limit, errorMessage)) return rows;
+
+    parseSheet(book, [&](int rowIndex, const QVector<Cell>& cells, qint64) {
+        if (rowIndex >= maxRows) return false;
+        while (rows.size() < rowIndex) rows.append(QStringList());
+        QStringList fields;
+        for (const Cell& cell : cells) {
+            if (cell.column >= maxCols) break;
+            while (fields.size() < cell.column) fields.append(QString());
+            fields.append(cell.isNumeric ? QString::number(cell.number, 'g', 15) : cell.text);
+        }
+        rows.append(fields);
+        return true;
+    });
+    return rows;
+}
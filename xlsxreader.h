@@ -0,0 +1,63 @@
+/*
+ * 文件名: xlsxreader.h
+ * 文件作用: Excel 工作簿 (.xlsx) 内置读取器头文件
+ * 功能描述:
+ * 1. 直接解析 XLSX 的 ZIP 容器和工作表 XML，不再启动 Excel 进程做 COM 自动化。
+ * 2. 逐行 (SAX 方式) 扫描第一个工作表，数值单元格直接写入列式 double 缓冲区。
+ * 3. 结果与 TextDataReader 相同 (TextDataTable)，表头行、起始行语义与原 Excel 导入一致。
+ * 4. 预览只解压并解析工作表开头部分，读取前若干行即返回。
+ */
+
+#ifndef XLSXREADER_H
+#define XLSXREADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include "textdatareader.h" // TextDataTable 定义
+
+class XlsxReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XlsxReader(QObject *parent = nullptr);
+
+    // 判断文件是否为 XLSX (ZIP 容器)；旧版二进制 .xls 返回 false
+    static bool isXlsxFile(const QString& filePath);
+
+    /**
+     * @brief 按导入配置读取第一个工作表
+     * @param settings 导入配置 (使用表头行、起始行；编码和分隔符对 Excel 无意义)
+     * @return 列式数据表，失败时 success 为 false 并给出 errorMessage
+     */
+    TextDataTable read(const DataImportSettings& settings);
+
+    /**
+     * @brief 读取第一个工作表的前 maxRows 行、前 maxCols 列用于预览
+     * @return 按工作表行号排列的单元格文本，第 i 项对应第 i+1 行
+     */
+    QList<QStringList> readPreview(const QString& filePath, int maxRows, int maxCols, QString* errorMessage = nullptr);
+
+signals:
+    void progressUpdated(int progress, const QString& message);
+
+private:
+    // 单元格：数值单元格 isNumeric 为 true，其余 (文本、布尔、错误值、日期) 为文本
+    struct Cell {
+        int column;
+        bool isNumeric;
+        double number;
+        QString text;
+    };
+    // 已打开的工作簿：共享字符串表、日期样式和第一个工作表的 XML (定义见实现文件)
+    struct Workbook;
+
+    static bool openWorkbook(const QString& filePath, Workbook& book, qint64 maxSheetBytes, QString* errorMessage);
+    // 逐行解析工作表；onRow(行号, 单元格, 已解析字节数) 返回 false 时提前结束
+    static void parseSheet(const Workbook& book, const std::function<bool(int, const QVector<Cell>&, qint64)>& onRow);
+};
+
+#endif // XLSXREADER_H